@@ -73,4 +73,49 @@ ColumnLayout {
             onClicked: portRow.doSavePort(textTcpClientPort.text)
         }
     }
+    RowLayout {
+        spacing: 10
+        id: intervalRow
+        Label {
+            id: labelTcpClientInterval
+            text: qsTr(rootElement.templateId + " Update Interval (ms):")
+            Layout.fillWidth: true
+        }
+        function doSaveInterval(text) {
+            let interval = parseInt(text);
+            console.log("Saving interval for "+rootElement.templateId + " "+ text + " converted "+interval);
+            if (!isNaN(interval) && interval >= 100 && interval <= 60000)
+                settings.setValue("template_"+rootElement.templateId+"_interval", interval);
+        }
+        TextField {
+            id: textTcpClientInterval
+            text: settings.value("template_"+rootElement.templateId+"_interval",1000) + '';
+            horizontalAlignment: Text.AlignRight
+            Layout.fillHeight: false
+            Layout.alignment: Qt.AlignRight | Qt.AlignVCenter
+            inputMethodHints: Qt.ImhDigitsOnly
+            onAccepted: intervalRow.doSaveInterval(text)
+        }
+        Button {
+            id: buttonlabelTcpClientInterval
+            text: "OK"
+            Layout.alignment: Qt.AlignRight | Qt.AlignVCenter
+            onClicked: intervalRow.doSaveInterval(textTcpClientInterval.text)
+        }
+    }
+    RowLayout {
+        spacing: 10
+        id: formatRow
+        Label {
+            id: labelTcpClientFormat
+            text: qsTr(rootElement.templateId + " Binary Records (no script):")
+            Layout.fillWidth: true
+        }
+        Switch {
+            id: switchTcpClientFormat
+            checked: settings.value("template_"+rootElement.templateId+"_format","text") === "binary"
+            Layout.alignment: Qt.AlignRight | Qt.AlignVCenter
+            onToggled: settings.setValue("template_"+rootElement.templateId+"_format", checked ? "binary" : "text")
+        }
+    }
 }
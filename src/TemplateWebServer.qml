@@ -62,4 +62,34 @@ ColumnLayout {
             }
         }
     }
+    RowLayout {
+        spacing: 10
+        id: intervalRow
+        Label {
+            id: labelWebServerInterval
+            text: qsTr(rootElement.templateId + " Update Interval (ms):")
+            Layout.fillWidth: true
+        }
+        function doSaveInterval(text) {
+            let interval = parseInt(text);
+            console.log("Saving interval for "+rootElement.templateId + " "+ text + " converted "+interval);
+            if (!isNaN(interval) && interval >= 100 && interval <= 60000)
+                settings.setValue("template_"+rootElement.templateId+"_interval", interval);
+        }
+        TextField {
+            id: textWebServerInterval
+            text: settings.value("template_"+rootElement.templateId+"_interval",1000) + '';
+            horizontalAlignment: Text.AlignRight
+            Layout.fillHeight: false
+            Layout.alignment: Qt.AlignRight | Qt.AlignVCenter
+            inputMethodHints: Qt.ImhDigitsOnly
+            onAccepted: intervalRow.doSaveInterval(text)
+        }
+        Button {
+            id: buttonlabelWebServerInterval
+            text: "OK"
+            Layout.alignment: Qt.AlignRight | Qt.AlignVCenter
+            onClicked: intervalRow.doSaveInterval(textWebServerInterval.text)
+        }
+    }
 }
@@ -1,4 +1,5 @@
 #include "activiotreadmill.h"
+#include "logging.h"
 
 #include "activiotreadmill.h"
 #include "ios/lockscreen.h"
@@ -50,7 +51,7 @@ void activiotreadmill::writeCharacteristic(const QLowEnergyCharacteristic charac
 
     if (gattCommunicationChannelService->state() != QLowEnergyService::ServiceState::ServiceDiscovered ||
         m_control->state() == QLowEnergyController::UnconnectedState) {
-        emit debug(QStringLiteral("writeCharacteristic error because the connection is closed"));
+        LOG_DEVICE(QStringLiteral("writeCharacteristic error because the connection is closed"));
 
         return;
     }
@@ -58,14 +59,14 @@ void activiotreadmill::writeCharacteristic(const QLowEnergyCharacteristic charac
     gattCommunicationChannelService->writeCharacteristic(characteristc, QByteArray((const char *)data, data_len));
 
     if (!disable_log) {
-        emit debug(QStringLiteral(" >> ") + QByteArray((const char *)data, data_len).toHex(' ') +
+        LOG_PACKET(QStringLiteral(" >> ") + QByteArray((const char *)data, data_len).toHex(' ') +
                    QStringLiteral(" // ") + info);
     }
 
     loop.exec();
 
     if (timeout.isActive() == false) {
-        emit debug(QStringLiteral(" exit for timeout"));
+        LOG_DEVICE(QStringLiteral(" exit for timeout"));
     }
 }
 
@@ -141,7 +142,7 @@ void activiotreadmill::update() {
         {
             if (requestSpeed != -1) {
                 if (requestSpeed != currentSpeed().value() && requestSpeed >= 0 && requestSpeed <= 22) {
-                    emit debug(QStringLiteral("writing speed ") + QString::number(requestSpeed));
+                    LOG_DEVICE(QStringLiteral("writing speed ") + QString::number(requestSpeed));
                     forceSpeed(requestSpeed);
                 }
                 requestSpeed = -1;
@@ -149,13 +150,13 @@ void activiotreadmill::update() {
             if (requestInclination != -1) {
                 if (requestInclination != currentInclination().value() && requestInclination >= 0 &&
                     requestInclination <= 15) {
-                    emit debug(QStringLiteral("writing incline ") + QString::number(requestInclination));
+                    LOG_DEVICE(QStringLiteral("writing incline ") + QString::number(requestInclination));
                     forceIncline(requestInclination);
                 }
                 requestInclination = -1;
             }
             if (requestStart != -1) {
-                emit debug(QStringLiteral("starting..."));
+                LOG_DEVICE(QStringLiteral("starting..."));
                 if (lastSpeed == 0.0) {
 
                     lastSpeed = 0.5;
@@ -180,7 +181,7 @@ void activiotreadmill::update() {
                 emit tapeStarted();
             }
             if (requestStop != -1) {
-                emit debug(QStringLiteral("stopping... ") + paused);
+                LOG_DEVICE(QStringLiteral("stopping... ") + paused);
                 if (lastState == PAUSED) {
                     uint8_t pause[] = {0x05, 0x00, 0x00, 0x00, 0x00, 0x2a, 0x07};
 
@@ -197,18 +198,18 @@ void activiotreadmill::update() {
                 requestStop = -1;
             }
             /*if (requestFanSpeed != -1) {
-                emit debug(QStringLiteral("changing fan speed..."));
+                LOG_DEVICE(QStringLiteral("changing fan speed..."));
 
                 sendChangeFanSpeed(requestFanSpeed);
                 requestFanSpeed = -1;
             }
             if (requestIncreaseFan != -1) {
-                emit debug(QStringLiteral("increasing fan speed..."));
+                LOG_DEVICE(QStringLiteral("increasing fan speed..."));
 
                 sendChangeFanSpeed(FanSpeed + 1);
                 requestIncreaseFan = -1;
             } else if (requestDecreaseFan != -1) {
-                emit debug(QStringLiteral("decreasing fan speed..."));
+                LOG_DEVICE(QStringLiteral("decreasing fan speed..."));
 
                 sendChangeFanSpeed(FanSpeed - 1);
                 requestDecreaseFan = -1;
@@ -218,7 +219,7 @@ void activiotreadmill::update() {
 }
 
 void activiotreadmill::serviceDiscovered(const QBluetoothUuid &gatt) {
-    emit debug(QStringLiteral("serviceDiscovered ") + gatt.toString());
+    LOG_DEVICE(QStringLiteral("serviceDiscovered ") + gatt.toString());
 }
 
 void activiotreadmill::characteristicChanged(const QLowEnergyCharacteristic &characteristic,
@@ -230,7 +231,7 @@ void activiotreadmill::characteristicChanged(const QLowEnergyCharacteristic &cha
     Q_UNUSED(characteristic);
     QByteArray value = newValue;
 
-    emit debug(QStringLiteral(" << ") + QString::number(value.length()) + QStringLiteral(" ") + value.toHex(' '));
+    LOG_PACKET(QStringLiteral(" << ") + QString::number(value.length()) + QStringLiteral(" ") + value.toHex(' '));
     emit packetReceived();
 
     if (newValue.length() < 12)
@@ -286,12 +287,12 @@ void activiotreadmill::characteristicChanged(const QLowEnergyCharacteristic &cha
         lastTimeCharacteristicChanged = QDateTime::currentDateTime();
     }
 
-    emit debug(QStringLiteral("Current speed: ") + QString::number(speed));
-    emit debug(QStringLiteral("Current incline: ") + QString::number(incline));
-    emit debug(QStringLiteral("Current heart: ") + QString::number(Heart.value()));
+    LOG_DEVICE(QStringLiteral("Current speed: ") + QString::number(speed));
+    LOG_DEVICE(QStringLiteral("Current incline: ") + QString::number(incline));
+    LOG_DEVICE(QStringLiteral("Current heart: ") + QString::number(Heart.value()));
     // emit debug(QStringLiteral("Current KCal: ") + QString::number(kcal));
     // emit debug(QStringLiteral("Current Distance: ") + QString::number(distance));
-    emit debug(QStringLiteral("Current Distance Calculated: ") + QString::number(Distance.value()));
+    LOG_DEVICE(QStringLiteral("Current Distance Calculated: ") + QString::number(Distance.value()));
 
     if (m_control->error() != QLowEnergyController::NoError) {
         qDebug() << QStringLiteral("QLowEnergyController ERROR!!") << m_control->errorString();
@@ -308,9 +309,9 @@ void activiotreadmill::characteristicChanged(const QLowEnergyCharacteristic &cha
     }
     Inclination = incline;
 
-    emit debug(QStringLiteral("Current KCal: ") + QString::number(KCal.value()));
+    LOG_DEVICE(QStringLiteral("Current KCal: ") + QString::number(KCal.value()));
 
-    emit debug(QStringLiteral("Current Distance: ") + QString::number(Distance.value()));
+    LOG_DEVICE(QStringLiteral("Current Distance: ") + QString::number(Distance.value()));
 
     if (speed > 0) {
 
@@ -477,7 +478,7 @@ void activiotreadmill::stateChanged(QLowEnergyService::ServiceState state) {
     QBluetoothUuid _gattNotifyCharacteristicId(QStringLiteral("e54eaa56-371b-476c-99a3-74d267e3edae"));
 
     QMetaEnum metaEnum = QMetaEnum::fromType<QLowEnergyService::ServiceState>();
-    emit debug(QStringLiteral("BTLE stateChanged ") + QString::fromLocal8Bit(metaEnum.valueToKey(state)));
+    LOG_DEVICE(QStringLiteral("BTLE stateChanged ") + QString::fromLocal8Bit(metaEnum.valueToKey(state)));
     if (state == QLowEnergyService::ServiceDiscovered) {
 
         // qDebug() << gattCommunicationChannelService->characteristics();
@@ -514,7 +515,7 @@ void activiotreadmill::stateChanged(QLowEnergyService::ServiceState state) {
 }
 
 void activiotreadmill::descriptorWritten(const QLowEnergyDescriptor &descriptor, const QByteArray &newValue) {
-    emit debug(QStringLiteral("descriptorWritten ") + descriptor.name() + QStringLiteral(" ") + newValue.toHex(' '));
+    LOG_PACKET(QStringLiteral("descriptorWritten ") + descriptor.name() + QStringLiteral(" ") + newValue.toHex(' '));
 
     initRequest = true;
     emit connectedAndDiscovered();
@@ -523,17 +524,17 @@ void activiotreadmill::descriptorWritten(const QLowEnergyDescriptor &descriptor,
 void activiotreadmill::characteristicWritten(const QLowEnergyCharacteristic &characteristic,
                                              const QByteArray &newValue) {
     Q_UNUSED(characteristic);
-    emit debug(QStringLiteral("characteristicWritten ") + newValue.toHex(' '));
+    LOG_PACKET(QStringLiteral("characteristicWritten ") + newValue.toHex(' '));
 }
 
 void activiotreadmill::serviceScanDone(void) {
     QBluetoothUuid _gattCommunicationChannelServiceId(QStringLiteral("e54eaa50-371b-476c-99a3-74d267e3edae"));
-    emit debug(QStringLiteral("serviceScanDone"));
+    LOG_DEVICE(QStringLiteral("serviceScanDone"));
 
     auto services_list = m_control->services();
-    emit debug("Services found:");
+    LOG_DEVICE("Services found:");
     for (const QBluetoothUuid &s : qAsConst(services_list)) {
-        emit debug(s.toString());
+        LOG_DEVICE(s.toString());
     }
 
     gattCommunicationChannelService = m_control->createServiceObject(_gattCommunicationChannelServiceId);
@@ -542,21 +543,21 @@ void activiotreadmill::serviceScanDone(void) {
                 &activiotreadmill::stateChanged);
         gattCommunicationChannelService->discoverDetails();
     } else {
-        emit debug(QStringLiteral("error on find Service"));
+        LOG_DEVICE(QStringLiteral("error on find Service"));
     }
 }
 
 void activiotreadmill::errorService(QLowEnergyService::ServiceError err) {
 
     QMetaEnum metaEnum = QMetaEnum::fromType<QLowEnergyService::ServiceError>();
-    emit debug(QStringLiteral("activiotreadmill::errorService ") + QString::fromLocal8Bit(metaEnum.valueToKey(err)) +
+    LOG_DEVICE(QStringLiteral("activiotreadmill::errorService ") + QString::fromLocal8Bit(metaEnum.valueToKey(err)) +
                m_control->errorString());
 }
 
 void activiotreadmill::error(QLowEnergyController::Error err) {
 
     QMetaEnum metaEnum = QMetaEnum::fromType<QLowEnergyController::Error>();
-    emit debug(QStringLiteral("activiotreadmill::error ") + QString::fromLocal8Bit(metaEnum.valueToKey(err)) +
+    LOG_DEVICE(QStringLiteral("activiotreadmill::error ") + QString::fromLocal8Bit(metaEnum.valueToKey(err)) +
                m_control->errorString());
 }
 
@@ -577,18 +578,18 @@ void activiotreadmill::deviceDiscovered(const QBluetoothDeviceInfo &device) {
                 this, [this](QLowEnergyController::Error error) {
                     Q_UNUSED(error);
                     Q_UNUSED(this);
-                    emit debug(QStringLiteral("Cannot connect to remote device."));
+                    LOG_DEVICE(QStringLiteral("Cannot connect to remote device."));
                     searchStopped = false;
                     emit disconnected();
                 });
         connect(m_control, &QLowEnergyController::connected, this, [this]() {
             Q_UNUSED(this);
-            emit debug(QStringLiteral("Controller connected. Search services..."));
+            LOG_DEVICE(QStringLiteral("Controller connected. Search services..."));
             m_control->discoverServices();
         });
         connect(m_control, &QLowEnergyController::disconnected, this, [this]() {
             Q_UNUSED(this);
-            emit debug(QStringLiteral("LowEnergy controller disconnected"));
+            LOG_DEVICE(QStringLiteral("LowEnergy controller disconnected"));
             searchStopped = false;
             emit disconnected();
         });
@@ -1,5 +1,6 @@
 
 #include "bike.h"
+#include "controllatency.h"
 #include "qdebugfixup.h"
 #include <QSettings>
 
@@ -8,6 +9,7 @@ bike::bike() { elapsed.setType(metric::METRIC_ELAPSED); }
 void bike::changeResistance(int8_t resistance) {
     lastRawRequestedResistanceValue = resistance;
     if (autoResistanceEnable) {
+        controlLatency()->requested(controllatency::RESISTANCE, resistance);
         double v = (resistance * m_difficult) + gears();
         if (!ergModeSupported)
             requestResistance = v;
@@ -21,6 +23,7 @@ void bike::changeResistance(int8_t resistance) {
 void bike::changeInclination(double grade, double percentage) {
     qDebug() << QStringLiteral("bike::changeInclination") << autoResistanceEnable << grade << percentage;
     if (autoResistanceEnable) {
+        controlLatency()->requested(controllatency::INCLINATION, grade);
         requestInclination = grade;
     }
     emit inclinationChanged(grade, percentage);
@@ -39,6 +42,7 @@ void bike::changeRequestedPelotonResistance(int8_t resistance) { RequestedPeloto
 void bike::changeCadence(int16_t cadence) { RequestedCadence = cadence; }
 void bike::changePower(int32_t power) {
 
+    controlLatency()->requested(controllatency::POWER, power);
     RequestedPower = power;
     requestPower = power; // used by some bikes that have ERG mode builtin
     QSettings settings;
@@ -78,8 +82,17 @@ uint16_t bike::watts() { return 0; }
 metric bike::pelotonResistance() { return m_pelotonResistance; }
 int bike::pelotonToBikeResistance(int pelotonResistance) { return pelotonResistance; }
 uint8_t bike::resistanceFromPowerRequest(uint16_t power) { return power / 10; } // in order to have something
-void bike::cadenceSensor(uint8_t cadence) { Cadence.setValue(cadence); }
-void bike::powerSensor(uint16_t power) { m_watt.setValue(power); }
+void bike::cadenceSensor(uint8_t cadence) { fusion.push(sensorfusion::CADENCE, cadence); }
+void bike::powerSensor(uint16_t power) { fusion.push(sensorfusion::POWER, power); }
+void bike::changeSteeringAngle(double angle) { fusion.push(sensorfusion::STEERING, angle); }
+
+void bike::applySensorFusion() {
+    bluetoothdevice::applySensorFusion();
+    if (fusion.active(sensorfusion::STEERING)) {
+        // a dead steering sensor reads as 0, so the bike goes straight
+        m_steeringAngle = fusion.sample(sensorfusion::STEERING, fusion.alignedTime());
+    }
+}
 
 bluetoothdevice::BLUETOOTH_TYPE bike::deviceType() { return bluetoothdevice::BIKE; }
 
@@ -42,7 +42,7 @@ class bike : public bluetoothdevice {
     virtual void cadenceSensor(uint8_t cadence);
     virtual void powerSensor(uint16_t power);
     virtual void changeInclination(double grade, double percentage);
-    virtual void changeSteeringAngle(double angle) { m_steeringAngle = angle; }
+    virtual void changeSteeringAngle(double angle);
     virtual void resistanceFromFTMSAccessory(int8_t res) { Q_UNUSED(res); }
 
   Q_SIGNALS:
@@ -52,6 +52,8 @@ class bike : public bluetoothdevice {
     void steeringAngleChanged(double angle);
 
   protected:
+    void applySensorFusion() override;
+
     metric RequestedResistance;
     metric RequestedPelotonResistance;
     metric RequestedCadence;
@@ -0,0 +1,191 @@
+#include "bletransport.h"
+#include "qdebugfixup.h"
+#include <QMetaEnum>
+
+bletransport::bletransport(const QBluetoothDeviceInfo &device, QObject *parent) : bluetoothtransport(parent) {
+    m_control = QLowEnergyController::createCentral(device, this);
+    connect(m_control, &QLowEnergyController::discoveryFinished, this, &bletransport::serviceScanDone);
+    connect(m_control,
+            static_cast<void (QLowEnergyController::*)(QLowEnergyController::Error)>(&QLowEnergyController::error),
+            this, &bletransport::controllerError);
+    connect(m_control, &QLowEnergyController::stateChanged, this, &bluetoothtransport::stateChanged);
+    connect(m_control, &QLowEnergyController::connected, this, [this]() {
+        qDebug() << QStringLiteral("bletransport: controller connected. Search services...");
+        emit connected();
+        m_control->discoverServices();
+    });
+    connect(m_control, &QLowEnergyController::disconnected, this, [this]() {
+        qDebug() << QStringLiteral("bletransport: LowEnergy controller disconnected");
+        emit disconnected();
+    });
+}
+
+QLowEnergyController::ControllerState bletransport::state() const { return m_control->state(); }
+
+void bletransport::connectToDevice() {
+    if (m_control->state() == QLowEnergyController::UnconnectedState) {
+        m_control->connectToDevice();
+    }
+}
+
+void bletransport::disconnectFromDevice() { m_control->disconnectFromDevice(); }
+
+void bletransport::clearServices() {
+    // the service objects of a previous connection are invalid
+    for (QLowEnergyService *s : qAsConst(services)) {
+        s->deleteLater();
+    }
+    services.clear();
+    pendingSubscriptions.clear();
+    allDiscovered = false;
+}
+
+void bletransport::serviceScanDone() {
+    qDebug() << QStringLiteral("bletransport: serviceScanDone");
+    clearServices();
+
+    auto services_list = m_control->services();
+    for (const QBluetoothUuid &uuid : qAsConst(services_list)) {
+        if (!serviceFilter.isEmpty() && !serviceFilter.contains(uuid)) {
+            continue;
+        }
+        QLowEnergyService *s = m_control->createServiceObject(uuid, this);
+        if (!s) {
+            continue;
+        }
+        services.append(s);
+        connect(s, &QLowEnergyService::stateChanged, this, &bletransport::serviceStateChanged);
+        connect(s, &QLowEnergyService::characteristicChanged, this,
+                [this](const QLowEnergyCharacteristic &c, const QByteArray &value) {
+                    emit characteristicChanged(c.uuid(), value);
+                });
+        connect(s, &QLowEnergyService::characteristicWritten, this,
+                [this](const QLowEnergyCharacteristic &c, const QByteArray &value) {
+                    emit characteristicWritten(c.uuid(), value);
+                });
+        connect(s, &QLowEnergyService::descriptorWritten, this, &bletransport::descriptorWritten);
+        connect(s, static_cast<void (QLowEnergyService::*)(QLowEnergyService::ServiceError)>(&QLowEnergyService::error),
+                this, [s](QLowEnergyService::ServiceError err) {
+                    // only logged: error() is for the controller, the drivers disconnect on it
+                    QMetaEnum metaEnum = QMetaEnum::fromType<QLowEnergyService::ServiceError>();
+                    qDebug() << QStringLiteral("bletransport: service error") << s->serviceUuid()
+                             << QString::fromLocal8Bit(metaEnum.valueToKey(err));
+                });
+    }
+
+    if (services.isEmpty()) {
+        qDebug() << QStringLiteral("bletransport: no service found");
+        return;
+    }
+    for (QLowEnergyService *s : qAsConst(services)) {
+        s->discoverDetails();
+    }
+}
+
+void bletransport::serviceStateChanged(QLowEnergyService::ServiceState state) {
+    Q_UNUSED(state);
+    if (allDiscovered) {
+        return;
+    }
+    for (QLowEnergyService *s : qAsConst(services)) {
+        if (s->state() != QLowEnergyService::ServiceDiscovered && s->state() != QLowEnergyService::InvalidService) {
+            return;
+        }
+    }
+
+    allDiscovered = true;
+    qDebug() << QStringLiteral("bletransport: all services discovered!");
+    for (QLowEnergyService *s : qAsConst(services)) {
+        auto characteristics_list = s->characteristics();
+        for (const QLowEnergyCharacteristic &c : qAsConst(characteristics_list)) {
+            qDebug() << s->serviceUuid() << QStringLiteral("char uuid") << c.uuid() << QStringLiteral("handle")
+                     << c.handle() << c.properties();
+        }
+    }
+    emit discovered();
+}
+
+QLowEnergyService *bletransport::serviceOf(const QBluetoothUuid &characteristic) const {
+    for (QLowEnergyService *s : qAsConst(services)) {
+        if (s->state() == QLowEnergyService::ServiceDiscovered && s->characteristic(characteristic).isValid()) {
+            return s;
+        }
+    }
+    return nullptr;
+}
+
+QList<QBluetoothUuid> bletransport::characteristics() const {
+    QList<QBluetoothUuid> list;
+    for (QLowEnergyService *s : qAsConst(services)) {
+        if (s->state() != QLowEnergyService::ServiceDiscovered) {
+            continue;
+        }
+        auto characteristics_list = s->characteristics();
+        for (const QLowEnergyCharacteristic &c : qAsConst(characteristics_list)) {
+            list.append(c.uuid());
+        }
+    }
+    return list;
+}
+
+QLowEnergyCharacteristic::PropertyTypes bletransport::properties(const QBluetoothUuid &characteristic) const {
+    QLowEnergyService *s = serviceOf(characteristic);
+    if (!s) {
+        return QLowEnergyCharacteristic::Unknown;
+    }
+    return s->characteristic(characteristic).properties();
+}
+
+QBluetoothUuid bletransport::service(const QBluetoothUuid &characteristic) const {
+    QLowEnergyService *s = serviceOf(characteristic);
+    return s ? s->serviceUuid() : QBluetoothUuid();
+}
+
+bool bletransport::subscribe(const QBluetoothUuid &characteristic) {
+    QLowEnergyService *s = serviceOf(characteristic);
+    if (!s) {
+        qDebug() << QStringLiteral("bletransport: subscribe to an unknown characteristic") << characteristic;
+        return false;
+    }
+    QLowEnergyCharacteristic c = s->characteristic(characteristic);
+    QLowEnergyDescriptor d = c.descriptor(QBluetoothUuid::ClientCharacteristicConfiguration);
+    if (!d.isValid()) {
+        qDebug() << QStringLiteral("ClientCharacteristicConfiguration") << c.uuid() << QStringLiteral(" is not valid");
+        return false;
+    }
+
+    QByteArray descriptor;
+    if (c.properties() & QLowEnergyCharacteristic::Notify) {
+        descriptor.append((char)0x01);
+    } else {
+        descriptor.append((char)0x02);
+    }
+    descriptor.append((char)0x00);
+    pendingSubscriptions.insert(d.handle(), characteristic);
+    s->writeDescriptor(d, descriptor);
+    return true;
+}
+
+void bletransport::descriptorWritten(const QLowEnergyDescriptor &descriptor, const QByteArray &newValue) {
+    qDebug() << QStringLiteral("bletransport: descriptorWritten") << descriptor.name() << newValue.toHex(' ');
+    if (pendingSubscriptions.contains(descriptor.handle())) {
+        emit subscribed(pendingSubscriptions.take(descriptor.handle()));
+    }
+}
+
+void bletransport::writeCharacteristic(const QBluetoothUuid &characteristic, const QByteArray &value,
+                                       bool withResponse) {
+    QLowEnergyService *s = serviceOf(characteristic);
+    if (!s || m_control->state() == QLowEnergyController::UnconnectedState) {
+        qDebug() << QStringLiteral("bletransport: writeCharacteristic error because the connection is closed");
+        return;
+    }
+    s->writeCharacteristic(s->characteristic(characteristic), value,
+                           withResponse ? QLowEnergyService::WriteWithResponse
+                                        : QLowEnergyService::WriteWithoutResponse);
+}
+
+void bletransport::controllerError(QLowEnergyController::Error err) {
+    QMetaEnum metaEnum = QMetaEnum::fromType<QLowEnergyController::Error>();
+    setError(QString::fromLocal8Bit(metaEnum.valueToKey(err)) + QStringLiteral(" ") + m_control->errorString());
+}
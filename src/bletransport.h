@@ -0,0 +1,48 @@
+#ifndef BLETRANSPORT_H
+#define BLETRANSPORT_H
+
+#include <QHash>
+#include <QList>
+
+#include <QtBluetooth/qlowenergycontroller.h>
+#include <QtBluetooth/qlowenergydescriptor.h>
+#include <QtBluetooth/qlowenergyservice.h>
+
+#include "bluetoothtransport.h"
+
+// The Bluetooth Low Energy stack of Qt: one service object for each service of the filter (or all of them), the
+// characteristics are looked up by uuid among all the discovered services.
+class bletransport : public bluetoothtransport {
+    Q_OBJECT
+  public:
+    explicit bletransport(const QBluetoothDeviceInfo &device, QObject *parent = nullptr);
+    TRANSPORT_TYPE type() const override { return BLE; }
+
+    void connectToDevice() override;
+    void disconnectFromDevice() override;
+    QList<QBluetoothUuid> characteristics() const override;
+    QLowEnergyCharacteristic::PropertyTypes properties(const QBluetoothUuid &characteristic) const override;
+    QBluetoothUuid service(const QBluetoothUuid &characteristic) const override;
+    bool subscribe(const QBluetoothUuid &characteristic) override;
+    void writeCharacteristic(const QBluetoothUuid &characteristic, const QByteArray &value,
+                             bool withResponse = true) override;
+    QLowEnergyController::ControllerState state() const override;
+    QLowEnergyController *controller() const override { return m_control; }
+
+  private:
+    QLowEnergyService *serviceOf(const QBluetoothUuid &characteristic) const;
+    void clearServices();
+
+    QLowEnergyController *m_control = nullptr;
+    QList<QLowEnergyService *> services;
+    QHash<QLowEnergyHandle, QBluetoothUuid> pendingSubscriptions;
+    bool allDiscovered = false;
+
+  private slots:
+    void serviceScanDone();
+    void serviceStateChanged(QLowEnergyService::ServiceState state);
+    void descriptorWritten(const QLowEnergyDescriptor &descriptor, const QByteArray &newValue);
+    void controllerError(QLowEnergyController::Error err);
+};
+
+#endif // BLETRANSPORT_H
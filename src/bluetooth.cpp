@@ -1,4 +1,5 @@
 #include "bluetooth.h"
+#include "bluetoothtransport.h"
 #include "homeform.h"
 #include <QBluetoothLocalDevice>
 #include <QDateTime>
@@ -10,6 +11,9 @@
 #include "keepawakehelper.h"
 #include <QAndroidJniObject>
 #endif
+#ifdef TEST
+#include "simulatedbike.h"
+#endif
 
 bluetooth::bluetooth(bool logs, const QString &deviceName, bool noWriteResistance, bool noHeartService,
                      uint32_t pollDeviceTime, bool noConsole, bool testResistance, uint8_t bikeResistanceOffset,
@@ -40,14 +44,30 @@ bluetooth::bluetooth(bool logs, const QString &deviceName, bool noWriteResistanc
     settings.setValue(sKey + QStringLiteral("port"), 0);
     this->innerTemplateManager =
         TemplateInfoSenderBuilder::getInstance(innerId, QStringList({QStringLiteral(":/inner_templates/")}), this);
+    this->statePublisher = new statepublisher(this);
 
 #ifdef TEST
-    schwinnIC4Bike = (schwinnic4bike *)new bike();
-    userTemplateManager->start(schwinnIC4Bike);
-    innerTemplateManager->start(schwinnIC4Bike);
-    connectedAndDiscovered();
+    // headless simulation (test/test-bike): no scan, the simulated bike is the device
+    fakeBike = new simulatedbike(noWriteResistance, noHeartService);
+    connect(fakeBike, &bluetoothdevice::connectedAndDiscovered, this, &bluetooth::connectedAndDiscovered);
+    connect(fakeBike, &fakebike::inclinationChanged, this, &bluetooth::inclinationChanged);
+    userTemplateManager->start(fakeBike);
+    innerTemplateManager->start(fakeBike);
     return;
 #endif
+    if (bluetoothtransport::configuredType() != bluetoothtransport::BLE) {
+        // the main device is behind a bridge or a capture file, so it can't be found by the scan: the configured
+        // name selects its driver. The scan goes on for the heart belts, the accessories and the other devices
+        QBluetoothDeviceInfo info = bluetoothtransport::mainDevice();
+        qDebug() << QStringLiteral("transport") << bluetoothtransport::configuredType() << info.name();
+        QTimer::singleShot(0, this, [this, info]() {
+            // without a dongle there is no scan, but the drivers stop the agent when they start
+            if (!discoveryAgent) {
+                discoveryAgent = new QBluetoothDeviceDiscoveryAgent(this);
+            }
+            deviceDiscovered(info);
+        });
+    }
 #if !defined(WIN32) && !defined(Q_OS_IOS)
     if (QBluetoothLocalDevice::allDevices().isEmpty()) {
         debug(QStringLiteral("no bluetooth dongle found!"));
@@ -1362,6 +1382,9 @@ void bluetooth::connectedAndDiscovered() {
 
     static bool firstConnected = true;
     QSettings settings;
+
+    statePublisher->setDevice(device());
+
     QString heartRateBeltName =
         settings.value(QStringLiteral("heart_rate_belt_name"), QStringLiteral("Disabled")).toString();
     QString ftmsAccessoryName =
@@ -1628,6 +1651,7 @@ void bluetooth::restart() {
     devices.clear();
     userTemplateManager->stop();
     innerTemplateManager->stop();
+    statePublisher->setDevice(nullptr);
 
     if (device() && device()->VirtualDevice()) {
         if (device()->deviceType() == bluetoothdevice::TREADMILL) {
@@ -2085,7 +2109,7 @@ bluetoothdevice *bluetooth::device() {
 bool bluetooth::handleSignal(int signal) {
     if (signal == SIGNALS::SIG_INT) {
         qDebug() << QStringLiteral("SIGINT");
-        QFile::remove(QStringLiteral("status.xml"));
+        statePublisher->removeFiles();
         exit(EXIT_SUCCESS);
     }
     // Let the signal propagate as though we had not been there
@@ -2097,15 +2121,14 @@ void bluetooth::stateFileRead() {
         return;
     }
 
-    QFile *log;
+    QFile log(STATEPUBLISHER_XML_FILE);
     QDomDocument xmlBOM;
-    log = new QFile(QStringLiteral("status.xml"));
-    if (!log->open(QIODevice::ReadOnly | QIODevice::Text)) {
-        qDebug() << QStringLiteral("Open status.xml for writing failed");
+    if (!log.open(QIODevice::ReadOnly | QIODevice::Text)) {
+        qDebug() << QStringLiteral("Open status.xml for reading failed");
 
         return;
     }
-    xmlBOM.setContent(log);
+    xmlBOM.setContent(&log);
     QDomElement root = xmlBOM.documentElement();
 
     // Get root names and attributes
@@ -2131,57 +2154,20 @@ void bluetooth::stateFileRead() {
         machine = machine.nextSibling().toElement();
     }
 
-    log->close();
-}
-
-void bluetooth::stateFileUpdate() {
-    if (!device()) {
-        return;
-    }
-    if (device()->deviceType() != bluetoothdevice::TREADMILL) {
-        return;
-    }
-
-    QFile *log;
-    QDomDocument docStatus;
-    QDomElement docRoot;
-    QDomElement docTreadmill;
-    QDomElement docHeart;
-    log = new QFile(QStringLiteral("status.xml"));
-    if (!log->open(QIODevice::WriteOnly | QIODevice::Text)) {
-        qDebug() << QStringLiteral("Open status.xml for writing failed");
-
-        return;
-    }
-    docRoot = docStatus.createElement(QStringLiteral("Gym"));
-    docStatus.appendChild(docRoot);
-    docTreadmill = docStatus.createElement(QStringLiteral("Treadmill"));
-    docTreadmill.setAttribute(QStringLiteral("Speed"), QString::number(device()->currentSpeed().value(), 'f', 1));
-    docTreadmill.setAttribute(
-        QStringLiteral("Incline"),
-        QString::number(qobject_cast<treadmill *>(device())->currentInclination().value(), 'f', 1));
-    docRoot.appendChild(docTreadmill);
-    // docHeart = docStatus.createElement("Heart");
-    // docHeart.setAttribute("Rate", QString::number(currentHeart));
-    // docRoot.appendChild(docHeart);
-    docRoot.setAttribute(QStringLiteral("Updated"), QDateTime::currentDateTime().toString());
-    QTextStream stream(log);
-    stream << docStatus.toString();
-    log->flush();
-    log->close();
+    log.close();
 }
 
 void bluetooth::speedChanged(double speed) {
 
     Q_UNUSED(speed);
-    stateFileUpdate();
+    statePublisher->requestUpdate();
 }
 
 void bluetooth::inclinationChanged(double grade, double inclination) {
 
     Q_UNUSED(grade);
     Q_UNUSED(inclination);
-    stateFileUpdate();
+    statePublisher->requestUpdate();
 }
 
 bool bluetooth::fitmetria_fanfit_isconnected(QString name) {
@@ -2196,5 +2182,16 @@ bool bluetooth::fitmetria_fanfit_isconnected(QString name) {
 void bluetooth::deviceUpdated(const QBluetoothDeviceInfo &device, QBluetoothDeviceInfo::Fields updateFields) {
 
     debug("deviceUpdated " + device.name() + " " + updateFields);
+
+    // keeping the RSSI of the connected peripherals up to date for the connection watchdog telemetry
+    if (updateFields & QBluetoothDeviceInfo::Field::RSSI) {
+        const QList<bluetoothdevice *> connectedDevices = {this->device(), heartRateBelt, cadenceSensor, powerSensor,
+                                                           powerSensorRun};
+        for (bluetoothdevice *d : connectedDevices) {
+            if (d && SAME_BLUETOOTH_DEVICE(d->bluetoothDevice, device)) {
+                d->bluetoothDevice.setRssi(device.rssi());
+            }
+        }
+    }
 }
 #endif
@@ -72,6 +72,7 @@
 #include "sportsplusbike.h"
 #include "sportstechbike.h"
 #include "stagesbike.h"
+#include "statepublisher.h"
 
 #include "renphobike.h"
 #include "tacxneo2.h"
@@ -170,6 +171,7 @@ class bluetooth : public QObject, public SignalHandler {
     eliterizer *eliteRizer = nullptr;
     elitesterzosmart *eliteSterzoSmart = nullptr;
     fakebike *fakeBike = nullptr;
+    statepublisher *statePublisher = nullptr;
     QList<fitmetria_fanfit *> fitmetriaFanfit;
     QString filterDevice = QLatin1String("");
 
@@ -184,7 +186,6 @@ class bluetooth : public QObject, public SignalHandler {
     bool forceHeartBeltOffForTimeout = false;
 
     bool handleSignal(int signal) override;
-    void stateFileUpdate();
     void stateFileRead();
     bool heartRateBeltAvaiable();
     bool ftmsAccessoryAvaiable();
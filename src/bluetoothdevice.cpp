@@ -1,9 +1,27 @@
 #include "bluetoothdevice.h"
+#include "bluetoothtransport.h"
+#include "bluetoothwatchdog.h"
+#include "controllatency.h"
+#include "qdebugfixup.h"
 
 #include <QSettings>
 #include <QTime>
 
-bluetoothdevice::bluetoothdevice() {}
+bluetoothdevice::bluetoothdevice() {
+    QSettings settings;
+    fusion.configure(settings.value(QStringLiteral("sensor_fusion_staleness"), 5000).toInt(),
+                     settings.value(QStringLiteral("sensor_fusion_interpolate"), false).toBool());
+    m_controlLatency = new controllatency(this);
+    connect(this, &bluetoothdevice::writeCompleted, m_controlLatency, &controllatency::written);
+
+    // every peripheral gets its link supervised as soon as it's usable
+    connect(this, &bluetoothdevice::connectedAndDiscovered, this, [this]() {
+        if (!m_watchdog) {
+            m_watchdog = new bluetoothwatchdog(this, this);
+            connect(m_watchdog, &bluetoothwatchdog::writeCompleted, this, &bluetoothdevice::writeCompleted);
+        }
+    });
+}
 
 bluetoothdevice::BLUETOOTH_TYPE bluetoothdevice::deviceType() { return bluetoothdevice::UNKNOWN; }
 void bluetoothdevice::start() { requestStart = 1; }
@@ -110,9 +128,27 @@ bool bluetoothdevice::changeFanSpeed(uint8_t speed) {
 }
 bool bluetoothdevice::connected() { return false; }
 metric bluetoothdevice::elevationGain() { return elevationAcc; }
-void bluetoothdevice::heartRate(uint8_t heart) { Heart.setValue(heart); }
+void bluetoothdevice::heartRate(uint8_t heart) { fusion.push(sensorfusion::HEART, heart); }
+quint64 bluetoothdevice::writeRequested(const QByteArray &value) {
+    quint64 write = ++writes;
+    if (m_watchdog) {
+        m_watchdog->writeRequested(write, value);
+    }
+    if (requestWritePending) {
+        requestWritePending = false;
+        m_controlLatency->writing(write);
+        emit writeQueued(write);
+    }
+    return write;
+}
+void bluetoothdevice::requestQueued() {
+    m_controlLatency->queued();
+    requestWritePending = true;
+}
 void bluetoothdevice::disconnectBluetooth() {
-    if (m_control) {
+    if (transport) {
+        transport->disconnectFromDevice();
+    } else if (m_control) {
         m_control->disconnectFromDevice();
     }
 }
@@ -125,9 +161,32 @@ void bluetoothdevice::speedSensor(double speed) { Q_UNUSED(speed) }
 
 double bluetoothdevice::calculateMETS() { return ((0.048 * m_watt.value()) + 1.19); }
 
+void bluetoothdevice::applySensorFusion() {
+    static const sensorfusion::CHANNEL channels[] = {sensorfusion::HEART, sensorfusion::CADENCE, sensorfusion::POWER,
+                                                     sensorfusion::SPEED};
+    metric *metrics[] = {&Heart, &Cadence, &m_watt, &Speed};
+    int64_t t = fusion.alignedTime();
+
+    for (int i = 0; i < 4; i++) {
+        sensorfusion::CHANNEL c = channels[i];
+        if (!fusion.active(c)) {
+            continue;
+        }
+        bool stale = fusion.stale(c, t);
+        if (stale != fusionStale[c]) {
+            fusionStale[c] = stale;
+            qDebug() << QStringLiteral("sensor") << sensorfusion::channelName(c)
+                     << (stale ? QStringLiteral("is stale, zeroing it") : QStringLiteral("is alive again"));
+        }
+        metrics[i]->setValue(fusion.sample(c, t));
+    }
+}
+
 // keiser m3i has a separate management of this, so please check it
 void bluetoothdevice::update_metrics(bool watt_calc, const double watts) {
 
+    applySensorFusion();
+
     QDateTime current = QDateTime::currentDateTime();
     double deltaTime = (((double)_lastTimeUpdate.msecsTo(current)) / ((double)1000.0));
     QSettings settings;
@@ -186,6 +245,7 @@ void bluetoothdevice::clearStats() {
     Heart.clear(false);
     m_jouls.clear(true);
     elevationAcc = 0;
+    fusion.clear();
     m_watt.clear(false);
     WeightLoss.clear(false);
     WattKg.clear(false);
@@ -340,4 +400,11 @@ uint8_t bluetoothdevice::metrics_override_heartrate() {
 void bluetoothdevice::changeGeoPosition(QGeoCoordinate p) { coordinate = p; }
 QGeoCoordinate bluetoothdevice::currentCordinate() { return coordinate; }
 
-void bluetoothdevice::workoutEventStateChanged(bluetoothdevice::WORKOUT_EVENT_STATE state) { lastState = state; }
+void bluetoothdevice::workoutEventStateChanged(bluetoothdevice::WORKOUT_EVENT_STATE state) {
+    lastState = state;
+    if (state == bluetoothdevice::STARTED) {
+        m_controlLatency->reset();
+    } else if (state == bluetoothdevice::STOPPED) {
+        m_controlLatency->dump();
+    }
+}
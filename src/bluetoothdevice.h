@@ -2,6 +2,7 @@
 #define BLUETOOTHDEVICE_H
 
 #include "metric.h"
+#include "sensorfusion.h"
 #include <QBluetoothDeviceDiscoveryAgent>
 #include <QBluetoothDeviceInfo>
 #include <QDateTime>
@@ -25,6 +26,10 @@
 #define SAME_BLUETOOTH_DEVICE(d1, d2) (d1.address() == d2.address())
 #endif
 
+class bluetoothtransport;
+class bluetoothwatchdog;
+class controllatency;
+
 class bluetoothdevice : public QObject {
 
     Q_OBJECT
@@ -68,6 +73,10 @@ class bluetoothdevice : public QObject {
     double weightLoss() { return WeightLoss.value(); }
     metric wattKg() { return WattKg; }
     metric currentMETS() { return METS; }
+    QLowEnergyController *controller() const { return m_control; }
+    bluetoothwatchdog *watchdog() const { return m_watchdog; }
+    controllatency *controlLatency() const { return m_controlLatency; }
+    const sensorfusion &sensorFusion() const { return fusion; }
 
     enum BLUETOOTH_TYPE { UNKNOWN = 0, TREADMILL, BIKE, ROWING, ELLIPTICAL };
     enum WORKOUT_EVENT_STATE { STARTED = 0, PAUSED = 1, RESUMED = 2, STOPPED = 3 };
@@ -97,9 +106,17 @@ class bluetoothdevice : public QObject {
     void powerChanged(uint16_t power);
     void inclinationChanged(double grade, double percentage);
     void fanSpeedChanged(uint8_t speed);
+    // a driver is writing a request to the machine (requestQueued), and the machine acknowledged a write the driver
+    // reported (only with the watchdog): the write is the token writeRequested gave it
+    void writeQueued(quint64 write);
+    void writeCompleted(quint64 write);
 
   protected:
     QLowEnergyController *m_control = nullptr;
+    // set only by the drivers ported to the transport layer, m_control is its controller when the backend is BLE
+    bluetoothtransport *transport = nullptr;
+    bluetoothwatchdog *m_watchdog = nullptr;
+    controllatency *m_controlLatency = nullptr;
 
     metric elapsed;
     metric moving; // moving time
@@ -132,7 +149,19 @@ class bluetoothdevice : public QObject {
     QDateTime _lastTimeUpdate;
     bool _firstUpdate = true;
     void update_metrics(bool watt_calc, const double watts);
+    virtual void applySensorFusion();
+    sensorfusion fusion;
+    bool fusionStale[sensorfusion::CHANNELS] = {};
+    // the drivers call it right before a write, with its value: it returns the token of the write
+    quint64 writeRequested(const QByteArray &value);
+    // the drivers call it where their update loop takes a pending request (requestResistance, requestPower, ...) to
+    // write it: the next write carries the request
+    void requestQueued();
     double calculateMETS();
+
+  private:
+    quint64 writes = 0;
+    bool requestWritePending = false;
 };
 
 #endif // BLUETOOTHDEVICE_H
@@ -0,0 +1,94 @@
+#include "bluetoothtransport.h"
+#include "bletransport.h"
+#include "capturetransport.h"
+#include "gatewaytransport.h"
+#include "qdebugfixup.h"
+#include "replaytransport.h"
+#include <QSettings>
+
+bluetoothtransport::bluetoothtransport(QObject *parent) : QObject(parent) {}
+
+bluetoothtransport::TRANSPORT_TYPE bluetoothtransport::configuredType() {
+    QSettings settings;
+    QString transport = settings.value(QStringLiteral("transport"), QStringLiteral("BLE")).toString();
+    if (!transport.compare(QStringLiteral("RFCOMM"), Qt::CaseInsensitive)) {
+        return RFCOMM;
+    } else if (!transport.compare(QStringLiteral("TCP"), Qt::CaseInsensitive)) {
+        return TCP;
+    } else if (!transport.compare(QStringLiteral("Replay"), Qt::CaseInsensitive)) {
+        return REPLAY;
+    }
+    return BLE;
+}
+
+QBluetoothDeviceInfo bluetoothtransport::mainDevice() {
+    QSettings settings;
+    QBluetoothDeviceInfo info(QBluetoothAddress(settings.value(QStringLiteral("transport_address"), "").toString()),
+                              settings.value(QStringLiteral("transport_device_name"), "").toString(), 0);
+    info.setCoreConfigurations(QBluetoothDeviceInfo::LowEnergyCoreConfiguration);
+    return info;
+}
+
+bool bluetoothtransport::isMainDevice(const QBluetoothDeviceInfo &device) {
+    QBluetoothDeviceInfo main = mainDevice();
+    return device.name() == main.name() && (main.address().isNull() || device.address() == main.address());
+}
+
+bluetoothtransport *bluetoothtransport::create(const QBluetoothDeviceInfo &device, QObject *parent) {
+    QSettings settings;
+    TRANSPORT_TYPE type = configuredType() != BLE && isMainDevice(device) ? configuredType() : BLE;
+    bluetoothtransport *transport = createBackend(type, device, parent);
+    if (type != REPLAY && settings.value(QStringLiteral("transport_capture"), false).toBool()) {
+        return new capturetransport(transport, capturetransport::captureFileName(device.name()), device.name(),
+                                    parent);
+    }
+    return transport;
+}
+
+bluetoothtransport *bluetoothtransport::createBackend(TRANSPORT_TYPE type, const QBluetoothDeviceInfo &device,
+                                                      QObject *parent) {
+    QSettings settings;
+    switch (type) {
+    case RFCOMM:
+        qDebug() << QStringLiteral("transport: RFCOMM bridge") << device.address();
+        return new gatewaytransport(device.address(), parent);
+    case TCP: {
+        QString host = settings.value(QStringLiteral("transport_tcp_host"), QStringLiteral("192.168.4.1")).toString();
+        quint16 port = settings.value(QStringLiteral("transport_tcp_port"), 8888).toUInt();
+        qDebug() << QStringLiteral("transport: TCP bridge") << host << port;
+        return new gatewaytransport(host, port, parent);
+    }
+    case REPLAY: {
+        QString file = settings.value(QStringLiteral("transport_replay_file"), QString()).toString();
+        double speed = settings.value(QStringLiteral("transport_replay_speed"), 1.0).toDouble();
+        qDebug() << QStringLiteral("transport: replay of") << file << speed;
+        return new replaytransport(file, speed, parent);
+    }
+    default:
+        return new bletransport(device, parent);
+    }
+}
+
+bool bluetoothtransport::hasCharacteristic(const QBluetoothUuid &characteristic) const {
+    return characteristics().contains(characteristic);
+}
+
+void bluetoothtransport::setState(QLowEnergyController::ControllerState state) {
+    if (state == m_state) {
+        return;
+    }
+    QLowEnergyController::ControllerState old = m_state;
+    m_state = state;
+    emit stateChanged(state);
+    if (old == QLowEnergyController::ConnectingState && state == QLowEnergyController::ConnectedState) {
+        emit connected();
+    } else if (state == QLowEnergyController::UnconnectedState) {
+        emit disconnected();
+    }
+}
+
+void bluetoothtransport::setError(const QString &error) {
+    m_errorString = error;
+    qDebug() << QStringLiteral("transport error") << error;
+    emit this->error(error);
+}
@@ -0,0 +1,87 @@
+#ifndef BLUETOOTHTRANSPORT_H
+#define BLUETOOTHTRANSPORT_H
+
+#include <QBluetoothDeviceInfo>
+#include <QBluetoothUuid>
+#include <QByteArray>
+#include <QList>
+#include <QObject>
+#include <QString>
+
+#include <QtBluetooth/qlowenergycharacteristic.h>
+#include <QtBluetooth/qlowenergycontroller.h>
+
+// The link between a driver and its device, seen as a set of GATT characteristics: whatever carries the bytes (the
+// BLE stack, a BLE to WiFi/RFCOMM bridge or a capture file) the driver connects, subscribes, writes and receives the
+// notifications in the same way, so the parsing code doesn't change with the backend.
+// The states are the ones of QLowEnergyController, so the drivers can keep checking them as before.
+class bluetoothtransport : public QObject {
+    Q_OBJECT
+  public:
+    enum TRANSPORT_TYPE { BLE = 0, RFCOMM, TCP, REPLAY };
+
+    // builds the backend selected by the transport setting (BLE if not set) for the main device, BLE for all the
+    // others, recording its traffic when transport_capture is set
+    static bluetoothtransport *create(const QBluetoothDeviceInfo &device, QObject *parent);
+    static TRANSPORT_TYPE configuredType();
+    // the device behind the configured transport (transport_device_name and transport_address)
+    static QBluetoothDeviceInfo mainDevice();
+    static bool isMainDevice(const QBluetoothDeviceInfo &device);
+
+    explicit bluetoothtransport(QObject *parent = nullptr);
+    virtual TRANSPORT_TYPE type() const = 0;
+
+    // the services the driver is interested in, all of them if empty. It has to be set before connectToDevice()
+    void setServiceFilter(const QList<QBluetoothUuid> &services) { serviceFilter = services; }
+
+    // connects, discovers the services with their characteristics and then emits discovered()
+    virtual void connectToDevice() = 0;
+    virtual void disconnectFromDevice() = 0;
+
+    virtual QList<QBluetoothUuid> characteristics() const = 0;
+    virtual QLowEnergyCharacteristic::PropertyTypes properties(const QBluetoothUuid &characteristic) const = 0;
+    bool hasCharacteristic(const QBluetoothUuid &characteristic) const;
+    // the service of the characteristic, null if the backend doesn't know it (a capture or a bridge that doesn't
+    // send it)
+    virtual QBluetoothUuid service(const QBluetoothUuid &characteristic) const {
+        Q_UNUSED(characteristic);
+        return QBluetoothUuid();
+    }
+
+    // enables the notifications, or the indications if the characteristic can't notify; subscribed() when done. False
+    // if it can't be started (unknown characteristic, no client configuration descriptor): subscribed() won't come
+    virtual bool subscribe(const QBluetoothUuid &characteristic) = 0;
+    // characteristicWritten() when done
+    virtual void writeCharacteristic(const QBluetoothUuid &characteristic, const QByteArray &value,
+                                     bool withResponse = true) = 0;
+
+    virtual QLowEnergyController::ControllerState state() const { return m_state; }
+    // only the BLE backend has a controller: the watchdog and the rssi are based on it
+    virtual QLowEnergyController *controller() const { return nullptr; }
+    QString errorString() const { return m_errorString; }
+
+  signals:
+    void stateChanged(QLowEnergyController::ControllerState state);
+    void connected();
+    void disconnected();
+    void discovered();
+    void subscribed(const QBluetoothUuid &characteristic);
+    void characteristicChanged(const QBluetoothUuid &characteristic, const QByteArray &value);
+    void characteristicWritten(const QBluetoothUuid &characteristic, const QByteArray &value);
+    // the link failed (the controller, the socket or the capture file): the drivers handle it as a disconnection
+    void error(const QString &error);
+
+  protected:
+    static bluetoothtransport *createBackend(TRANSPORT_TYPE type, const QBluetoothDeviceInfo &device,
+                                             QObject *parent);
+    void setState(QLowEnergyController::ControllerState state);
+    void setError(const QString &error);
+
+    QList<QBluetoothUuid> serviceFilter;
+
+  private:
+    QLowEnergyController::ControllerState m_state = QLowEnergyController::UnconnectedState;
+    QString m_errorString;
+};
+
+#endif // BLUETOOTHTRANSPORT_H
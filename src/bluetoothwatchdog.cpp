@@ -0,0 +1,241 @@
+#include "bluetoothwatchdog.h"
+#include "bluetoothdevice.h"
+#include "controllatency.h"
+#include "qdebugfixup.h"
+#include <QRandomGenerator>
+#include <QSettings>
+#include <chrono>
+
+using namespace std::chrono_literals;
+
+// the stall detection is armed only when the peripheral is streaming, some accessories never notify
+static const uint32_t watchdogArmNotifications = 10;
+static const int watchdogBackoffMinMs = 1000;
+static const int watchdogBackoffMaxMs = 60000;
+static const qint64 watchdogWriteTimeoutMs = 5000;
+static const qint64 watchdogLogIntervalMs = 60000;
+
+bluetoothwatchdog::bluetoothwatchdog(bluetoothdevice *device, QObject *parent) : QObject(parent), device(device) {
+    clock.start();
+    connect(&tick, &QTimer::timeout, this, &bluetoothwatchdog::onTick);
+    connect(&recoveryTimer, &QTimer::timeout, this, &bluetoothwatchdog::onRecoveryTimeout);
+    recoveryTimer.setSingleShot(true);
+    attach(device->controller());
+    tick.start(1s);
+}
+
+void bluetoothwatchdog::attach(QLowEnergyController *control) {
+    if (m_control) {
+        disconnect(m_control, nullptr, this, nullptr);
+    }
+    qDeleteAll(observers);
+    observers.clear();
+    m_control = control;
+    if (!m_control) {
+        return;
+    }
+
+    connect(m_control, &QLowEnergyController::discoveryFinished, this, &bluetoothwatchdog::observeServices);
+    connect(m_control, &QLowEnergyController::stateChanged, this, &bluetoothwatchdog::controllerStateChanged);
+    if (m_control->state() == QLowEnergyController::DiscoveredState) {
+        observeServices();
+    }
+}
+
+void bluetoothwatchdog::observeServices() {
+    qDeleteAll(observers);
+    observers.clear();
+    if (!m_control) {
+        return;
+    }
+
+    auto services_list = m_control->services();
+    for (const QBluetoothUuid &s : qAsConst(services_list)) {
+        QLowEnergyService *service = m_control->createServiceObject(s, this);
+        if (!service) {
+            continue;
+        }
+        connect(service, &QLowEnergyService::characteristicChanged, this, &bluetoothwatchdog::characteristicChanged);
+        connect(service, &QLowEnergyService::characteristicWritten, this, &bluetoothwatchdog::characteristicWritten);
+        observers.append(service);
+    }
+}
+
+int16_t bluetoothwatchdog::rssi() const { return device->bluetoothDevice.rssi(); }
+
+qint64 bluetoothwatchdog::lastNotificationAge() const {
+    if (lastNotification < 0) {
+        return -1;
+    }
+    return clock.elapsed() - lastNotification;
+}
+
+void bluetoothwatchdog::writeRequested(quint64 write, const QByteArray &value) {
+    pendingWrites.enqueue({write, value, clock.elapsed()});
+    // writes without response never complete, so don't let the queue grow
+    while (!pendingWrites.isEmpty() && clock.elapsed() - pendingWrites.head().requested > watchdogWriteTimeoutMs) {
+        pendingWrites.dequeue();
+    }
+}
+
+void bluetoothwatchdog::characteristicChanged(const QLowEnergyCharacteristic &characteristic,
+                                              const QByteArray &newValue) {
+    Q_UNUSED(characteristic);
+    Q_UNUSED(newValue);
+
+    qint64 now = clock.elapsed();
+    if (lastNotification >= 0) {
+        double interval = now - lastNotification;
+        if (m_notificationInterval < 0) {
+            m_notificationInterval = interval;
+        } else {
+            m_notificationInterval = (m_notificationInterval * 0.9) + (interval * 0.1);
+        }
+        if (interval > m_notificationIntervalMax) {
+            m_notificationIntervalMax = interval;
+        }
+    }
+    lastNotification = now;
+    m_notifications++;
+    device->controlLatency()->notified();
+
+    if (m_recovering) {
+        m_recovering = false;
+        backoff = 0;
+        recoveryTimer.stop();
+        m_reconnections++;
+        qDebug() << QStringLiteral("bluetoothwatchdog: link recovered after") << (now - recoveryStarted)
+                 << QStringLiteral("ms") << device->bluetoothDevice.name();
+        emit reconnected();
+    }
+}
+
+void bluetoothwatchdog::characteristicWritten(const QLowEnergyCharacteristic &characteristic,
+                                              const QByteArray &newValue) {
+    Q_UNUSED(characteristic);
+
+    // the oldest write requested with this value: the writes the driver didn't report (init sequences, other
+    // services) complete too, and they must not be taken for the requested ones
+    int i = 0;
+    while (i < pendingWrites.count() && pendingWrites.at(i).value != newValue) {
+        i++;
+    }
+    if (i == pendingWrites.count()) {
+        return;
+    }
+    pendingwrite completed = pendingWrites.takeAt(i);
+    double rtt = clock.elapsed() - completed.requested;
+    if (m_writeLatency < 0) {
+        m_writeLatency = rtt;
+    } else {
+        m_writeLatency = (m_writeLatency * 0.9) + (rtt * 0.1);
+    }
+    emit writeCompleted(completed.write);
+}
+
+void bluetoothwatchdog::controllerStateChanged(QLowEnergyController::ControllerState state) {
+    stateChangedAt = clock.elapsed();
+    if (state == QLowEnergyController::DiscoveredState) {
+        discoveredAt = clock.elapsed();
+    } else if (state == QLowEnergyController::UnconnectedState) {
+        pendingWrites.clear();
+        // the notification interval of the previous link is not meaningful anymore
+        lastNotification = -1;
+    }
+}
+
+int bluetoothwatchdog::stallTimeout() const {
+    QSettings settings;
+    int timeout = settings.value(QStringLiteral("bluetooth_watchdog_timeout"), 10).toInt() * 1000;
+    if (timeout <= 0) {
+        return 0;
+    }
+    // slow peripherals (for example 1 notification every 2 seconds) need more room
+    return qMax(timeout, (int)(m_notificationInterval * 8));
+}
+
+void bluetoothwatchdog::onTick() {
+    if (device->controller() != m_control) {
+        attach(device->controller());
+    }
+    if (!m_control) {
+        return;
+    }
+
+    qint64 now = clock.elapsed();
+    if (now - lastLog >= watchdogLogIntervalMs && m_notifications) {
+        lastLog = now;
+        qDebug() << QStringLiteral("bluetoothwatchdog:") << device->bluetoothDevice.name()
+                 << QStringLiteral("notify interval") << m_notificationInterval << QStringLiteral("ms (max")
+                 << m_notificationIntervalMax << QStringLiteral("ms) write rtt") << m_writeLatency
+                 << QStringLiteral("ms rssi") << rssi() << QStringLiteral("stalls") << m_stalls
+                 << QStringLiteral("reconnections") << m_reconnections;
+        m_notificationIntervalMax = 0;
+    }
+
+    int timeout = stallTimeout();
+    if (m_recovering || timeout == 0 || m_notifications < watchdogArmNotifications) {
+        return;
+    }
+
+    qint64 age = lastNotificationAge();
+    bool stalled = false;
+    if (m_control->state() == QLowEnergyController::DiscoveredState) {
+        stalled = age > timeout;
+    } else if (m_control->state() == QLowEnergyController::ConnectingState ||
+               m_control->state() == QLowEnergyController::DiscoveringState) {
+        // the controller is stuck in the middle of a (re)connection
+        stalled = (now - stateChangedAt) > timeout;
+    }
+
+    if (stalled) {
+        m_stalls++;
+        qDebug() << QStringLiteral("bluetoothwatchdog: stall detected on") << device->bluetoothDevice.name()
+                 << QStringLiteral("no notifications for") << age << QStringLiteral("ms, controller state")
+                 << m_control->state();
+        emit stallDetected();
+        m_recovering = true;
+        recoveryStarted = now;
+        recover();
+    }
+}
+
+void bluetoothwatchdog::recover() {
+    if (!m_control) {
+        return;
+    }
+
+    if (m_control->state() == QLowEnergyController::UnconnectedState) {
+        qDebug() << QStringLiteral("bluetoothwatchdog: connecting to") << device->bluetoothDevice.name();
+        m_control->connectToDevice();
+    } else {
+        // the drivers reconnect by themselves as soon as the controller goes in the UnconnectedState
+        qDebug() << QStringLiteral("bluetoothwatchdog: forcing disconnection of") << device->bluetoothDevice.name();
+        m_control->disconnectFromDevice();
+    }
+    scheduleRecoveryCheck();
+}
+
+void bluetoothwatchdog::scheduleRecoveryCheck() {
+    int delay = qMin(watchdogBackoffMaxMs, watchdogBackoffMinMs << qMin(backoff, 6));
+    // +/- 25% of jitter, in order to not have all the peripherals retrying at the same time
+    delay += QRandomGenerator::global()->bounded(delay / 2 + 1) - delay / 4;
+    backoff++;
+    qDebug() << QStringLiteral("bluetoothwatchdog: next recovery check in") << delay << QStringLiteral("ms");
+    recoveryTimer.start(delay);
+}
+
+void bluetoothwatchdog::onRecoveryTimeout() {
+    if (!m_recovering) {
+        return;
+    }
+    if (m_control && m_control->state() == QLowEnergyController::DiscoveredState) {
+        // the driver needs some time to subscribe to the notifications again
+        qint64 grace = stallTimeout() - (clock.elapsed() - discoveredAt);
+        if (grace > 0) {
+            recoveryTimer.start(grace);
+            return;
+        }
+    }
+    recover();
+}
@@ -0,0 +1,98 @@
+#ifndef BLUETOOTHWATCHDOG_H
+#define BLUETOOTHWATCHDOG_H
+
+#include <QElapsedTimer>
+#include <QList>
+#include <QObject>
+#include <QPointer>
+#include <QQueue>
+#include <QTimer>
+
+#include <QtBluetooth/qlowenergycharacteristic.h>
+#include <QtBluetooth/qlowenergycontroller.h>
+#include <QtBluetooth/qlowenergyservice.h>
+
+class bluetoothdevice;
+
+// Supervises the link of a connected peripheral. It observes every notification and every write completion
+// through its own service objects (they share the private data of the ones created by the driver), so it works
+// with any driver without changes to the parsing code. When the notification stream stops for longer than the
+// configured timeout, the link is forced down and brought back up with a jittered exponential backoff: the
+// bluetoothdevice (and so the session metrics) is never destroyed.
+class bluetoothwatchdog : public QObject {
+    Q_OBJECT
+  public:
+    explicit bluetoothwatchdog(bluetoothdevice *device, QObject *parent = nullptr);
+
+    // average time between two notifications in ms (EWMA), -1 if unknown
+    double notificationInterval() const { return m_notificationInterval; }
+    // worst time between two notifications in ms since the last telemetry log
+    double notificationIntervalMax() const { return m_notificationIntervalMax; }
+    double notificationRate() const { return m_notificationInterval > 0 ? 1000.0 / m_notificationInterval : 0; }
+    // average write round trip (request -> characteristicWritten) in ms (EWMA), -1 if unknown
+    double writeLatency() const { return m_writeLatency; }
+    int16_t rssi() const;
+    uint32_t notifications() const { return m_notifications; }
+    uint32_t stalls() const { return m_stalls; }
+    uint32_t reconnections() const { return m_reconnections; }
+    // writes requested and not completed yet
+    int pendingWriteCount() const { return pendingWrites.count(); }
+    bool recovering() const { return m_recovering; }
+    // ms since the last notification, -1 if nothing has been received yet
+    qint64 lastNotificationAge() const;
+
+  public slots:
+    // bluetoothdevice::writeRequested calls it right before a QLowEnergyService::writeCharacteristic, with the token
+    // and the value of the write
+    void writeRequested(quint64 write, const QByteArray &value);
+
+  signals:
+    void stallDetected();
+    void reconnected();
+    // a write requested has completed, the writes nobody requested don't emit it
+    void writeCompleted(quint64 write);
+
+  private:
+    void attach(QLowEnergyController *control);
+    void observeServices();
+    void recover();
+    void scheduleRecoveryCheck();
+    int stallTimeout() const;
+
+    bluetoothdevice *device = nullptr;
+    QPointer<QLowEnergyController> m_control;
+    QList<QLowEnergyService *> observers;
+    QTimer tick;
+    QTimer recoveryTimer;
+    QElapsedTimer clock;
+
+    qint64 lastNotification = -1;
+    qint64 lastLog = 0;
+    qint64 recoveryStarted = 0;
+    qint64 discoveredAt = 0;
+    qint64 stateChangedAt = 0;
+    struct pendingwrite {
+        quint64 write;
+        QByteArray value;
+        qint64 requested;
+    };
+    QQueue<pendingwrite> pendingWrites;
+
+    double m_notificationInterval = -1;
+    double m_notificationIntervalMax = 0;
+    double m_writeLatency = -1;
+    uint32_t m_notifications = 0;
+    uint32_t m_stalls = 0;
+    uint32_t m_reconnections = 0;
+    bool m_recovering = false;
+    int backoff = 0;
+
+  private slots:
+    void onTick();
+    void onRecoveryTimeout();
+    void characteristicChanged(const QLowEnergyCharacteristic &characteristic, const QByteArray &newValue);
+    void characteristicWritten(const QLowEnergyCharacteristic &characteristic, const QByteArray &newValue);
+    void controllerStateChanged(QLowEnergyController::ControllerState state);
+};
+
+#endif // BLUETOOTHWATCHDOG_H
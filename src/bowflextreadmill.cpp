@@ -1,4 +1,5 @@
 #include "bowflextreadmill.h"
+#include "logging.h"
 #include "keepawakehelper.h"
 #include "virtualtreadmill.h"
 #include <QBluetoothLocalDevice>
@@ -55,7 +56,7 @@ void bowflextreadmill::writeCharacteristic(uint8_t *data, uint8_t data_len, cons
         gattWriteCharacteristic, QByteArray((const char *)data, data_len));
 
     if (!disable_log) {
-        emit debug(QStringLiteral(" >> ") + QByteArray((const char *)data, data_len).toHex(' ') +
+        LOG_PACKET(QStringLiteral(" >> ") + QByteArray((const char *)data, data_len).toHex(' ') +
                    QStringLiteral(" // ") + info);
     }
 
@@ -64,7 +65,7 @@ void bowflextreadmill::writeCharacteristic(uint8_t *data, uint8_t data_len, cons
         loop.exec();
 
         if (timeout.isActive() == false)
-            emit debug(QStringLiteral(" exit for timeout"));
+            LOG_DEVICE(QStringLiteral(" exit for timeout"));
     }
 }
 
@@ -100,7 +101,7 @@ void bowflextreadmill::update() {
         if (!firstInit && !virtualTreadMill) {
             bool virtual_device_enabled = settings.value(QStringLiteral("virtual_device_enabled"), true).toBool();
             if (virtual_device_enabled) {
-                emit debug(QStringLiteral("creating virtual treadmill interface..."));
+                LOG_DEVICE(QStringLiteral("creating virtual treadmill interface..."));
                 virtualTreadMill = new virtualtreadmill(this, noHeartService);
                 connect(virtualTreadMill, &virtualtreadmill::debug, this, &bowflextreadmill::debug);
                 firstInit = 1;
@@ -118,7 +119,7 @@ void bowflextreadmill::update() {
 
         if (requestSpeed != -1) {
             if (requestSpeed != currentSpeed().value() && requestSpeed >= 0 && requestSpeed <= 22) {
-                emit debug(QStringLiteral("writing speed ") + QString::number(requestSpeed));
+                LOG_DEVICE(QStringLiteral("writing speed ") + QString::number(requestSpeed));
                 // double inc = Inclination.value(); // NOTE: clang-analyzer-deadcode.DeadStores
                 if (requestInclination != -1) {
                     //                        inc = requestInclination;
@@ -131,7 +132,7 @@ void bowflextreadmill::update() {
         if (requestInclination != -1) {
             if (requestInclination != currentInclination().value() && requestInclination >= 0 &&
                 requestInclination <= 15) {
-                emit debug(QStringLiteral("writing incline ") + QString::number(requestInclination));
+                LOG_DEVICE(QStringLiteral("writing incline ") + QString::number(requestInclination));
                 // double speed = currentSpeed().value(); // NOTE: clang-analyzer-deadcode.DeadStores
                 if (requestSpeed != -1) {
                     // speed = requestSpeed;
@@ -143,7 +144,7 @@ void bowflextreadmill::update() {
         }
 
         if (requestStart != -1) {
-            emit debug(QStringLiteral("starting..."));
+            LOG_DEVICE(QStringLiteral("starting..."));
             if (lastSpeed == 0.0) {
                 lastSpeed = 0.5;
             }
@@ -151,7 +152,7 @@ void bowflextreadmill::update() {
             emit tapeStarted();
         }
         if (requestStop != -1) {
-            emit debug(QStringLiteral("stopping..."));
+            LOG_DEVICE(QStringLiteral("stopping..."));
             // writeCharacteristic(initDataF0C800B8, sizeof(initDataF0C800B8), "stop tape", false, true);
             requestStop = -1;
         }
@@ -159,7 +160,7 @@ void bowflextreadmill::update() {
 }
 
 void bowflextreadmill::serviceDiscovered(const QBluetoothUuid &gatt) {
-    emit debug(QStringLiteral("serviceDiscovered ") + gatt.toString());
+    LOG_DEVICE(QStringLiteral("serviceDiscovered ") + gatt.toString());
 }
 
 void bowflextreadmill::characteristicChanged(const QLowEnergyCharacteristic &characteristic,
@@ -171,7 +172,7 @@ void bowflextreadmill::characteristicChanged(const QLowEnergyCharacteristic &cha
     Q_UNUSED(characteristic);
     QByteArray value = newValue;
 
-    emit debug(QStringLiteral(" << ") + QString::number(value.length()) + QStringLiteral(" ") + value.toHex(' '));
+    LOG_PACKET(QStringLiteral(" << ") + QString::number(value.length()) + QStringLiteral(" ") + value.toHex(' '));
 
     emit packetReceived();
 
@@ -192,9 +193,9 @@ void bowflextreadmill::characteristicChanged(const QLowEnergyCharacteristic &cha
         /*if(heartRateBeltName.startsWith("Disabled"))
         Heart = value.at(18);*/
     }
-    emit debug(QStringLiteral("Current speed: ") + QString::number(speed));
-    emit debug(QStringLiteral("Current incline: ") + QString::number(incline));
-    emit debug(QStringLiteral("Current KCal: ") + QString::number(kcal));
+    LOG_DEVICE(QStringLiteral("Current speed: ") + QString::number(speed));
+    LOG_DEVICE(QStringLiteral("Current incline: ") + QString::number(incline));
+    LOG_DEVICE(QStringLiteral("Current KCal: ") + QString::number(kcal));
     // debug("Current Distance: " + QString::number(distance));
 
     if (Speed.value() != speed) {
@@ -228,7 +229,7 @@ void bowflextreadmill::characteristicChanged(const QLowEnergyCharacteristic &cha
                      (1000.0 / (lastTimeCharacteristicChanged.msecsTo(QDateTime::currentDateTime()))));
     }
 
-    emit debug(QStringLiteral("Current Distance Calculated: ") + QString::number(Distance.value()));
+    LOG_DEVICE(QStringLiteral("Current Distance Calculated: ") + QString::number(Distance.value()));
 
     if (m_control->error() != QLowEnergyController::NoError) {
         qDebug() << QStringLiteral("QLowEnergyController ERROR!!") << m_control->errorString();
@@ -273,7 +274,7 @@ void bowflextreadmill::btinit(bool startTape) {
 
 void bowflextreadmill::stateChanged(QLowEnergyService::ServiceState state) {
     QMetaEnum metaEnum = QMetaEnum::fromType<QLowEnergyService::ServiceState>();
-    emit debug(QStringLiteral("BTLE stateChanged ") + QString::fromLocal8Bit(metaEnum.valueToKey(state)));
+    LOG_DEVICE(QStringLiteral("BTLE stateChanged ") + QString::fromLocal8Bit(metaEnum.valueToKey(state)));
     if (state == QLowEnergyService::ServiceDiscovered) {
         QBluetoothUuid _gattWriteCharacteristicId(QStringLiteral("1717b3c0-9803-11e3-90e1-0002a5d5c51b"));
         QBluetoothUuid _gattNotify1CharacteristicId(QStringLiteral("35ddd0a09-8031-1e39-a8b0-002a5d5c51b"));
@@ -325,7 +326,7 @@ void bowflextreadmill::stateChanged(QLowEnergyService::ServiceState state) {
 }
 
 void bowflextreadmill::descriptorWritten(const QLowEnergyDescriptor &descriptor, const QByteArray &newValue) {
-    emit debug(QStringLiteral("descriptorWritten ") + descriptor.name() + " " + newValue.toHex(' '));
+    LOG_PACKET(QStringLiteral("descriptorWritten ") + descriptor.name() + " " + newValue.toHex(' '));
 
     initRequest = true;
     emit connectedAndDiscovered();
@@ -334,11 +335,11 @@ void bowflextreadmill::descriptorWritten(const QLowEnergyDescriptor &descriptor,
 void bowflextreadmill::characteristicWritten(const QLowEnergyCharacteristic &characteristic,
                                               const QByteArray &newValue) {
     Q_UNUSED(characteristic);
-    emit debug(QStringLiteral("characteristicWritten ") + newValue.toHex(' '));
+    LOG_PACKET(QStringLiteral("characteristicWritten ") + newValue.toHex(' '));
 }
 
 void bowflextreadmill::serviceScanDone(void) {
-    emit debug(QStringLiteral("serviceScanDone"));
+    LOG_DEVICE(QStringLiteral("serviceScanDone"));
 
     QBluetoothUuid _gattCommunicationChannelServiceId(QStringLiteral("edff9e80-cad7-11e5-ab63-0002a5d5c51b"));
     gattCommunicationChannelService = m_control->createServiceObject(_gattCommunicationChannelServiceId);
@@ -348,18 +349,18 @@ void bowflextreadmill::serviceScanDone(void) {
 
 void bowflextreadmill::errorService(QLowEnergyService::ServiceError err) {
     QMetaEnum metaEnum = QMetaEnum::fromType<QLowEnergyService::ServiceError>();
-    emit debug(QStringLiteral("bowflextreadmill::errorService ") + QString::fromLocal8Bit(metaEnum.valueToKey(err)) +
+    LOG_DEVICE(QStringLiteral("bowflextreadmill::errorService ") + QString::fromLocal8Bit(metaEnum.valueToKey(err)) +
                m_control->errorString());
 }
 
 void bowflextreadmill::error(QLowEnergyController::Error err) {
     QMetaEnum metaEnum = QMetaEnum::fromType<QLowEnergyController::Error>();
-    emit debug(QStringLiteral("bowflextreadmill::error ") + QString::fromLocal8Bit(metaEnum.valueToKey(err)) +
+    LOG_DEVICE(QStringLiteral("bowflextreadmill::error ") + QString::fromLocal8Bit(metaEnum.valueToKey(err)) +
                m_control->errorString());
 }
 
 void bowflextreadmill::deviceDiscovered(const QBluetoothDeviceInfo &device) {
-    emit debug(QStringLiteral("Found new device: ") + device.name() + QStringLiteral(" (") +
+    LOG_DEVICE(QStringLiteral("Found new device: ") + device.name() + QStringLiteral(" (") +
                device.address().toString() + ')');
     {
         bluetoothDevice = device;
@@ -376,17 +377,17 @@ void bowflextreadmill::deviceDiscovered(const QBluetoothDeviceInfo &device) {
                 this, [this](QLowEnergyController::Error error) {
                     Q_UNUSED(error);
                     Q_UNUSED(this);
-                    emit debug(QStringLiteral("Cannot connect to remote device."));
+                    LOG_DEVICE(QStringLiteral("Cannot connect to remote device."));
                     emit disconnected();
                 });
         connect(m_control, &QLowEnergyController::connected, this, [this]() {
             Q_UNUSED(this);
-            emit debug(QStringLiteral("Controller connected. Search services..."));
+            LOG_DEVICE(QStringLiteral("Controller connected. Search services..."));
             m_control->discoverServices();
         });
         connect(m_control, &QLowEnergyController::disconnected, this, [this]() {
             Q_UNUSED(this);
-            emit debug(QStringLiteral("LowEnergy controller disconnected"));
+            LOG_DEVICE(QStringLiteral("LowEnergy controller disconnected"));
             emit disconnected();
         });
 
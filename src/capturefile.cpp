@@ -0,0 +1,304 @@
+#include "capturefile.h"
+#include "qdebugfixup.h"
+#include <QHash>
+#include <QTextStream>
+#include <QtEndian>
+
+namespace {
+const char magic[] = "QZCAP";
+const int magicSize = 5;
+const uint8_t version = 1;
+
+QBluetoothUuid uuidFromRfc4122(const char *data) {
+    return QBluetoothUuid(QUuid::fromRfc4122(QByteArray::fromRawData(data, 16)));
+}
+} // namespace
+
+capturefile::capturefile(const QString &fileName) : file(fileName) {}
+
+bool capturefile::open(const QString &deviceName) {
+    if (!file.open(QIODevice::WriteOnly | QIODevice::Truncate)) {
+        qDebug() << QStringLiteral("capturefile: unable to open") << file.fileName();
+        return false;
+    }
+    QByteArray name = deviceName.toUtf8().left(0xFFFF);
+    QByteArray header(magic, magicSize);
+    header.append((char)version);
+    header.append((char)(name.length() & 0xFF));
+    header.append((char)(name.length() >> 8));
+    header.append(name);
+    file.write(header);
+    lastT = 0;
+    return true;
+}
+
+void capturefile::append(qint64 t, char type, const QBluetoothUuid &characteristic, const QByteArray &value) {
+    if (!file.isOpen()) {
+        return;
+    }
+    file.write(encode(t - lastT, type, characteristic, value));
+    lastT = t;
+}
+
+void capturefile::close() {
+    if (file.isOpen()) {
+        file.close();
+    }
+}
+
+QByteArray capturefile::encode(qint64 delta, char type, const QBluetoothUuid &characteristic,
+                               const QByteArray &value) {
+    QByteArray r;
+    r.reserve(1 + 4 + 1 + 16 + 2 + value.length());
+    r.append(type);
+    quint32 d = (quint32)qBound<qint64>(0, delta, 0xFFFFFFFF);
+    for (int i = 0; i < 4; i++) {
+        r.append((char)((d >> (8 * i)) & 0xFF));
+    }
+    bool ok = false;
+    quint16 shortUuid = characteristic.toUInt16(&ok);
+    if (ok) {
+        r.append((char)2);
+        r.append((char)(shortUuid & 0xFF));
+        r.append((char)(shortUuid >> 8));
+    } else {
+        r.append((char)16);
+        r.append(characteristic.toRfc4122());
+    }
+    int length = qMin(value.length(), 0xFFFF);
+    r.append((char)(length & 0xFF));
+    r.append((char)(length >> 8));
+    r.append(value.constData(), length);
+    return r;
+}
+
+bool capturefile::save(const QString &fileName, const QList<record> &records, const QString &deviceName) {
+    capturefile f(fileName);
+    if (!f.open(deviceName)) {
+        return false;
+    }
+    for (const record &r : records) {
+        f.append(r.t, r.type, r.characteristic, r.value);
+    }
+    f.close();
+    return true;
+}
+
+bool capturefile::load(const QString &fileName, QList<record> &records) {
+    QFile f(fileName);
+    if (!f.open(QIODevice::ReadOnly)) {
+        return false;
+    }
+    QByteArray head = f.peek(8);
+    if (head.startsWith(QByteArray(magic, magicSize))) {
+        return loadBinary(f, records);
+    } else if (head == QByteArray("btsnoop\0", 8)) {
+        f.close();
+        return importBtsnoop(fileName, records);
+    }
+    return loadText(f, records);
+}
+
+bool capturefile::loadBinary(QFile &f, QList<record> &records) {
+    QByteArray data = f.readAll();
+    const char *p = data.constData();
+    int length = data.length();
+    if (length < magicSize + 3 || (uint8_t)p[magicSize] != version) {
+        qDebug() << QStringLiteral("capturefile: unsupported version of") << f.fileName();
+        return false;
+    }
+    int index = magicSize + 1;
+    int nameLength = qFromLittleEndian<quint16>(p + index);
+    index += 2;
+    if (index + nameLength > length) {
+        return false;
+    }
+    qDebug() << QStringLiteral("capturefile: capture of") << QString::fromUtf8(p + index, nameLength);
+    index += nameLength;
+
+    qint64 t = 0;
+    while (index + 6 <= length) {
+        record r;
+        r.type = p[index];
+        t += qFromLittleEndian<quint32>(p + index + 1);
+        r.t = t;
+        int uuidSize = (uint8_t)p[index + 5];
+        index += 6;
+        if ((uuidSize != 2 && uuidSize != 16) || index + uuidSize + 2 > length) {
+            qDebug() << QStringLiteral("capturefile: truncated record at") << index;
+            return true;
+        }
+        r.characteristic = uuidSize == 2 ? QBluetoothUuid(qFromLittleEndian<quint16>(p + index))
+                                         : uuidFromRfc4122(p + index);
+        index += uuidSize;
+        int valueLength = qFromLittleEndian<quint16>(p + index);
+        index += 2;
+        if (index + valueLength > length) {
+            qDebug() << QStringLiteral("capturefile: truncated record at") << index;
+            return true;
+        }
+        r.value = QByteArray(p + index, valueLength);
+        index += valueLength;
+        records.append(r);
+    }
+    return true;
+}
+
+bool capturefile::loadText(QFile &f, QList<record> &records) {
+    QTextStream in(&f);
+    while (!in.atEnd()) {
+        QString line = in.readLine().trimmed();
+        if (line.isEmpty() || line.startsWith('#')) {
+            continue;
+        }
+        QStringList fields = line.split(' ', QString::SkipEmptyParts);
+        if (fields.length() < 3 || fields.at(1).length() != 1) {
+            qDebug() << QStringLiteral("capturefile: skipping") << line;
+            continue;
+        }
+        record r;
+        r.t = fields.at(0).toLongLong();
+        r.type = fields.at(1).at(0).toLatin1();
+        r.characteristic = QBluetoothUuid(fields.at(2));
+        r.value = QByteArray::fromHex(fields.mid(3).join(QString()).toLatin1());
+        records.append(r);
+    }
+    return true;
+}
+
+bool capturefile::importBtsnoop(const QString &fileName, QList<record> &records) {
+    enum { HCI_UNENCAPSULATED = 1001, HCI_UART = 1002 };
+    enum { ATT_CID = 0x0004 };
+    enum {
+        ATT_READ_BY_TYPE_RESPONSE = 0x09,
+        ATT_WRITE_REQUEST = 0x12,
+        ATT_NOTIFICATION = 0x1B,
+        ATT_INDICATION = 0x1D,
+        ATT_WRITE_COMMAND = 0x52
+    };
+
+    QFile f(fileName);
+    if (!f.open(QIODevice::ReadOnly)) {
+        return false;
+    }
+    QByteArray data = f.readAll();
+    const char *p = data.constData();
+    int length = data.length();
+    if (length < 16 || QByteArray::fromRawData(p, 8) != QByteArray("btsnoop\0", 8)) {
+        return false;
+    }
+    quint32 datalink = qFromBigEndian<quint32>(p + 12);
+    if (datalink != HCI_UNENCAPSULATED && datalink != HCI_UART) {
+        qDebug() << QStringLiteral("capturefile: unsupported btsnoop datalink") << datalink;
+        return false;
+    }
+
+    // value handle of the characteristics, for each connection
+    QHash<quint32, QBluetoothUuid> handles;
+    // L2CAP frames being reassembled, for each connection
+    QHash<quint16, QByteArray> partial;
+    qint64 first = -1;
+    int unknown = 0;
+
+    int index = 16;
+    while (index + 24 <= length) {
+        quint32 included = qFromBigEndian<quint32>(p + index + 4);
+        quint32 flags = qFromBigEndian<quint32>(p + index + 8);
+        qint64 timestamp = qFromBigEndian<qint64>(p + index + 16);
+        index += 24;
+        if (included > (quint32)(length - index)) {
+            break;
+        }
+        const char *packet = p + index;
+        int packetLength = included;
+        index += included;
+
+        if (datalink == HCI_UART) {
+            // H4 packet type: 0x02 is ACL data
+            if (packetLength < 1 || packet[0] != 0x02) {
+                continue;
+            }
+            packet++;
+            packetLength--;
+        } else if (flags & 0x02) {
+            // command or event
+            continue;
+        }
+        if (packetLength < 4) {
+            continue;
+        }
+
+        quint16 handleFlags = qFromLittleEndian<quint16>(packet);
+        quint16 connection = handleFlags & 0x0FFF;
+        int boundary = (handleFlags >> 12) & 0x03;
+        int aclLength = qMin<int>(qFromLittleEndian<quint16>(packet + 2), packetLength - 4);
+        QByteArray acl(packet + 4, aclLength);
+
+        QByteArray &l2cap = partial[connection];
+        if (boundary == 0x01) {
+            if (l2cap.isEmpty()) {
+                continue;
+            }
+            l2cap.append(acl);
+        } else {
+            l2cap = acl;
+        }
+        if (l2cap.length() < 4 || l2cap.length() < 4 + qFromLittleEndian<quint16>(l2cap.constData())) {
+            continue;
+        }
+        QByteArray frame = l2cap;
+        l2cap.clear();
+        if (qFromLittleEndian<quint16>(frame.constData() + 2) != ATT_CID) {
+            continue;
+        }
+
+        const char *pdu = frame.constData() + 4;
+        int pduLength = qFromLittleEndian<quint16>(frame.constData());
+        if (pduLength < 1) {
+            continue;
+        }
+        if (first < 0) {
+            first = timestamp;
+        }
+        qint64 t = (timestamp - first) / 1000;
+        uint8_t opcode = pdu[0];
+
+        if (opcode == ATT_READ_BY_TYPE_RESPONSE && pduLength >= 2) {
+            // characteristic declarations: handle | properties | value handle | uuid
+            int entry = (uint8_t)pdu[1];
+            if (entry != 7 && entry != 21) {
+                continue;
+            }
+            for (int i = 2; i + entry <= pduLength; i += entry) {
+                quint16 valueHandle = qFromLittleEndian<quint16>(pdu + i + 3);
+                QBluetoothUuid uuid;
+                if (entry == 7) {
+                    uuid = QBluetoothUuid(qFromLittleEndian<quint16>(pdu + i + 5));
+                } else {
+                    char rfc[16];
+                    for (int b = 0; b < 16; b++) {
+                        rfc[b] = pdu[i + 5 + 15 - b];
+                    }
+                    uuid = uuidFromRfc4122(rfc);
+                }
+                handles.insert(((quint32)connection << 16) | valueHandle, uuid);
+                records.append({t, 'C', uuid, QByteArray(1, pdu[i + 2])});
+            }
+        } else if ((opcode == ATT_NOTIFICATION || opcode == ATT_INDICATION || opcode == ATT_WRITE_REQUEST ||
+                    opcode == ATT_WRITE_COMMAND) &&
+                   pduLength >= 3) {
+            quint16 handle = qFromLittleEndian<quint16>(pdu + 1);
+            auto uuid = handles.constFind(((quint32)connection << 16) | handle);
+            if (uuid == handles.constEnd()) {
+                unknown++;
+                continue;
+            }
+            char type = (opcode == ATT_NOTIFICATION || opcode == ATT_INDICATION) ? 'N' : 'W';
+            records.append({t, type, uuid.value(), QByteArray(pdu + 3, pduLength - 3)});
+        }
+    }
+
+    qDebug() << QStringLiteral("capturefile: imported") << records.length() << QStringLiteral("records from")
+             << fileName << unknown << QStringLiteral("with an unknown handle");
+    return true;
+}
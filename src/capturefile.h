@@ -0,0 +1,56 @@
+#ifndef CAPTUREFILE_H
+#define CAPTUREFILE_H
+
+#include <QBluetoothUuid>
+#include <QByteArray>
+#include <QFile>
+#include <QList>
+#include <QString>
+
+// The traffic of a device recorded at the transport boundary.
+//
+// Binary format, all the integers little endian:
+//
+//   header: "QZCAP" | version (1 byte) | device name length (2 bytes) | device name (utf8)
+//   record: type (1 byte) | ms from the previous record (4 bytes) | uuid size (1 byte, 2 or 16) | uuid |
+//           length (2 bytes) | payload
+//
+// the 16 bits uuids are the ones of the Bluetooth base uuid, the others are in RFC 4122 order. The types are the
+// ones of the text captures of replaytransport: N notification, W write of the driver, C characteristic declaration
+// (payload: the properties), plus S state of the link (payload: the QLowEnergyController state).
+//
+// load() reads the binary captures, the text ones and the btsnoop HCI logs (i.e. the btsnoop_hci.log of Android)
+// into the same records.
+class capturefile {
+  public:
+    struct record {
+        qint64 t; // ms from the start
+        char type;
+        QBluetoothUuid characteristic;
+        QByteArray value;
+    };
+
+    static bool load(const QString &fileName, QList<record> &records);
+    static bool save(const QString &fileName, const QList<record> &records, const QString &deviceName = QString());
+
+    // the ATT notifications, indications and writes of a btsnoop log. The handles are resolved to uuids with the
+    // characteristic discovery found in the log: the log has to start before the connection to the device.
+    static bool importBtsnoop(const QString &fileName, QList<record> &records);
+
+    // streaming writer of the binary format
+    explicit capturefile(const QString &fileName);
+    bool open(const QString &deviceName);
+    void append(qint64 t, char type, const QBluetoothUuid &characteristic, const QByteArray &value);
+    void flush() { file.flush(); }
+    void close();
+
+  private:
+    static QByteArray encode(qint64 delta, char type, const QBluetoothUuid &characteristic, const QByteArray &value);
+    static bool loadBinary(QFile &f, QList<record> &records);
+    static bool loadText(QFile &f, QList<record> &records);
+
+    QFile file;
+    qint64 lastT = 0;
+};
+
+#endif // CAPTUREFILE_H
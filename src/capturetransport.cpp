@@ -0,0 +1,66 @@
+#include "capturetransport.h"
+#include "homeform.h"
+#include "qdebugfixup.h"
+#include <QDateTime>
+#include <QRegExp>
+
+capturetransport::capturetransport(bluetoothtransport *transport, const QString &fileName, const QString &deviceName,
+                                   QObject *parent)
+    : bluetoothtransport(parent), transport(transport), file(fileName) {
+    transport->setParent(this);
+    if (file.open(deviceName)) {
+        qDebug() << QStringLiteral("capturetransport: recording to") << fileName;
+    }
+    elapsed.start();
+
+    connect(transport, &bluetoothtransport::stateChanged, this, [this](QLowEnergyController::ControllerState state) {
+        record('S', QBluetoothUuid(), QByteArray(1, (char)state));
+        if (state == QLowEnergyController::DiscoveredState) {
+            for (const QBluetoothUuid &c : this->transport->characteristics()) {
+                record('C', c, QByteArray(1, (char)(int)this->transport->properties(c)));
+            }
+        }
+        emit stateChanged(state);
+    });
+    connect(transport, &bluetoothtransport::characteristicChanged, this,
+            [this](const QBluetoothUuid &characteristic, const QByteArray &value) {
+                record('N', characteristic, value);
+                emit characteristicChanged(characteristic, value);
+            });
+    connect(transport, &bluetoothtransport::connected, this, &bluetoothtransport::connected);
+    connect(transport, &bluetoothtransport::disconnected, this, &bluetoothtransport::disconnected);
+    connect(transport, &bluetoothtransport::discovered, this, &bluetoothtransport::discovered);
+    connect(transport, &bluetoothtransport::subscribed, this, &bluetoothtransport::subscribed);
+    connect(transport, &bluetoothtransport::characteristicWritten, this, &bluetoothtransport::characteristicWritten);
+    connect(transport, &bluetoothtransport::error, this, [this](const QString &error) { setError(error); });
+}
+
+capturetransport::~capturetransport() { file.close(); }
+
+QString capturetransport::captureFileName(const QString &deviceName) {
+    QString name = deviceName;
+    name.replace(QRegExp(QStringLiteral("[^A-Za-z0-9_-]")), QStringLiteral("_"));
+    return homeform::getWritableAppDir() + name + QStringLiteral("_") +
+           QDateTime::currentDateTime().toString(QStringLiteral("yyyyMMdd_hhmmss")) + QStringLiteral(".qzcap");
+}
+
+void capturetransport::connectToDevice() {
+    transport->setServiceFilter(serviceFilter);
+    transport->connectToDevice();
+}
+
+void capturetransport::writeCharacteristic(const QBluetoothUuid &characteristic, const QByteArray &value,
+                                           bool withResponse) {
+    record('W', characteristic, value);
+    transport->writeCharacteristic(characteristic, value, withResponse);
+}
+
+void capturetransport::record(char type, const QBluetoothUuid &characteristic, const QByteArray &value) {
+    qint64 t = elapsed.elapsed();
+    file.append(t, type, characteristic, value);
+    // what was captured before a crash is still there
+    if (t - lastFlush >= 1000) {
+        lastFlush = t;
+        file.flush();
+    }
+}
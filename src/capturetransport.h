@@ -0,0 +1,48 @@
+#ifndef CAPTURETRANSPORT_H
+#define CAPTURETRANSPORT_H
+
+#include <QElapsedTimer>
+
+#include "bluetoothtransport.h"
+#include "capturefile.h"
+
+// Records all the traffic of another transport in a binary capture (see capturefile), without changing it: the
+// notifications, the writes of the driver, the characteristics found and the states of the link. The capture can be
+// played back by replaytransport.
+class capturetransport : public bluetoothtransport {
+    Q_OBJECT
+  public:
+    // takes the ownership of the transport
+    capturetransport(bluetoothtransport *transport, const QString &fileName, const QString &deviceName,
+                     QObject *parent = nullptr);
+    ~capturetransport();
+    TRANSPORT_TYPE type() const override { return transport->type(); }
+
+    void connectToDevice() override;
+    void disconnectFromDevice() override { transport->disconnectFromDevice(); }
+    QList<QBluetoothUuid> characteristics() const override { return transport->characteristics(); }
+    QLowEnergyCharacteristic::PropertyTypes properties(const QBluetoothUuid &characteristic) const override {
+        return transport->properties(characteristic);
+    }
+    QBluetoothUuid service(const QBluetoothUuid &characteristic) const override {
+        return transport->service(characteristic);
+    }
+    bool subscribe(const QBluetoothUuid &characteristic) override { return transport->subscribe(characteristic); }
+    void writeCharacteristic(const QBluetoothUuid &characteristic, const QByteArray &value,
+                             bool withResponse = true) override;
+    QLowEnergyController::ControllerState state() const override { return transport->state(); }
+    QLowEnergyController *controller() const override { return transport->controller(); }
+
+    // the name of a new capture for the device, in the writable folder of the app
+    static QString captureFileName(const QString &deviceName);
+
+  private:
+    void record(char type, const QBluetoothUuid &characteristic, const QByteArray &value);
+
+    bluetoothtransport *transport;
+    capturefile file;
+    QElapsedTimer elapsed;
+    qint64 lastFlush = 0;
+};
+
+#endif // CAPTURETRANSPORT_H
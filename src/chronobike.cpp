@@ -1,4 +1,5 @@
 #include "chronobike.h"
+#include "logging.h"
 #include "ios/lockscreen.h"
 #include "keepawakehelper.h"
 #include "virtualbike.h"
@@ -45,6 +46,7 @@ wait_for_response)
         timeout.singleShot(300, &loop, SLOT(quit()));
     }
 
+    writeRequested(QByteArray((const char *)data, data_len));
     gattCommunicationChannelService->writeCharacteristic(gattWriteCharacteristic, QByteArray((const char*)data,
 data_len));
 
@@ -99,13 +101,13 @@ void chronobike::update() {
             }
 
             if (requestResistance != currentResistance().value()) {
-                emit debug(QStringLiteral("writing resistance ") + QString::number(requestResistance));
+                LOG_DEVICE(QStringLiteral("writing resistance ") + QString::number(requestResistance));
                 // forceResistance(requestResistance);
             }
             requestResistance = -1;
         }
         if (requestStart != -1) {
-            emit debug(QStringLiteral("starting..."));
+            LOG_DEVICE(QStringLiteral("starting..."));
 
             // btinit();
 
@@ -113,7 +115,7 @@ void chronobike::update() {
             emit bikeStarted();
         }
         if (requestStop != -1) {
-            emit debug(QStringLiteral("stopping..."));
+            LOG_DEVICE(QStringLiteral("stopping..."));
             // writeCharacteristic(initDataF0C800B8, sizeof(initDataF0C800B8), "stop tape");
             requestStop = -1;
         }
@@ -121,7 +123,7 @@ void chronobike::update() {
 }
 
 void chronobike::serviceDiscovered(const QBluetoothUuid &gatt) {
-    emit debug(QStringLiteral("serviceDiscovered ") + gatt.toString());
+    LOG_DEVICE(QStringLiteral("serviceDiscovered ") + gatt.toString());
 }
 
 void chronobike::characteristicChanged(const QLowEnergyCharacteristic &characteristic, const QByteArray &newValue) {
@@ -131,7 +133,7 @@ void chronobike::characteristicChanged(const QLowEnergyCharacteristic &character
     QString heartRateBeltName =
         settings.value(QStringLiteral("heart_rate_belt_name"), QStringLiteral("Disabled")).toString();
 
-    emit debug(QStringLiteral(" << ") + newValue.toHex(' '));
+    LOG_PACKET(QStringLiteral(" << ") + newValue.toHex(' '));
 
     lastPacket = newValue;
 
@@ -219,13 +221,13 @@ void chronobike::characteristicChanged(const QLowEnergyCharacteristic &character
 #endif
 #endif
 
-    emit debug(QStringLiteral("Current Resistance: ") + QString::number(Resistance.value()));
-    emit debug(QStringLiteral("Current Speed: ") + QString::number(Speed.value()));
-    emit debug(QStringLiteral("Current Calculate Distance: ") + QString::number(Distance.value()));
-    emit debug(QStringLiteral("Current Cadence: ") + QString::number(Cadence.value()));
-    emit debug(QStringLiteral("Current CrankRevs: ") + QString::number(CrankRevs));
-    emit debug(QStringLiteral("Last CrankEventTime: ") + QString::number(LastCrankEventTime));
-    emit debug(QStringLiteral("Current Watt: ") + QString::number(watts()));
+    LOG_DEVICE(QStringLiteral("Current Resistance: ") + QString::number(Resistance.value()));
+    LOG_DEVICE(QStringLiteral("Current Speed: ") + QString::number(Speed.value()));
+    LOG_DEVICE(QStringLiteral("Current Calculate Distance: ") + QString::number(Distance.value()));
+    LOG_DEVICE(QStringLiteral("Current Cadence: ") + QString::number(Cadence.value()));
+    LOG_DEVICE(QStringLiteral("Current CrankRevs: ") + QString::number(CrankRevs));
+    LOG_DEVICE(QStringLiteral("Last CrankEventTime: ") + QString::number(LastCrankEventTime));
+    LOG_DEVICE(QStringLiteral("Current Watt: ") + QString::number(watts()));
 
     t_timeout->start(3s);
 
@@ -238,7 +240,7 @@ void chronobike::stateChanged(QLowEnergyService::ServiceState state) {
     QBluetoothUuid _gattNotify1CharacteristicId(QStringLiteral("a026e01d-0a7d-4ab3-97fa-f1500f9feb8b"));
 
     QMetaEnum metaEnum = QMetaEnum::fromType<QLowEnergyService::ServiceState>();
-    emit debug(QStringLiteral("BTLE stateChanged ") + QString::fromLocal8Bit(metaEnum.valueToKey(state)));
+    LOG_DEVICE(QStringLiteral("BTLE stateChanged ") + QString::fromLocal8Bit(metaEnum.valueToKey(state)));
 
     if (state == QLowEnergyService::ServiceDiscovered) {
         // qDebug() << gattCommunicationChannelService->characteristics();
@@ -281,7 +283,7 @@ void chronobike::stateChanged(QLowEnergyService::ServiceState state) {
 #endif
 #endif
                 if (virtual_device_enabled) {
-                emit debug(QStringLiteral("creating virtual bike interface..."));
+                LOG_DEVICE(QStringLiteral("creating virtual bike interface..."));
                 virtualBike = new virtualbike(this, noWriteResistance, noHeartService);
                 connect(virtualBike, &virtualbike::changeInclination, this, &chronobike::changeInclination);
                 // connect(virtualBike,&virtualbike::debug ,this,&chronobike::debug);
@@ -301,16 +303,16 @@ void chronobike::stateChanged(QLowEnergyService::ServiceState state) {
 }
 
 void chronobike::descriptorWritten(const QLowEnergyDescriptor &descriptor, const QByteArray &newValue) {
-    emit debug(QStringLiteral("descriptorWritten ") + descriptor.name() + QStringLiteral(" ") + newValue.toHex(' '));
+    LOG_PACKET(QStringLiteral("descriptorWritten ") + descriptor.name() + QStringLiteral(" ") + newValue.toHex(' '));
 }
 
 void chronobike::characteristicWritten(const QLowEnergyCharacteristic &characteristic, const QByteArray &newValue) {
     Q_UNUSED(characteristic);
-    emit debug(QStringLiteral("characteristicWritten ") + newValue.toHex(' '));
+    LOG_PACKET(QStringLiteral("characteristicWritten ") + newValue.toHex(' '));
 }
 
 void chronobike::serviceScanDone(void) {
-    emit debug(QStringLiteral("serviceScanDone"));
+    LOG_DEVICE(QStringLiteral("serviceScanDone"));
     QBluetoothUuid _gattCommunicationChannelServiceId(QStringLiteral("a026ee07-0a7d-4ab3-97fa-f1500f9feb8b"));
 
     gattCommunicationChannelService = m_control->createServiceObject(_gattCommunicationChannelServiceId);
@@ -320,18 +322,18 @@ void chronobike::serviceScanDone(void) {
 
 void chronobike::errorService(QLowEnergyService::ServiceError err) {
     QMetaEnum metaEnum = QMetaEnum::fromType<QLowEnergyService::ServiceError>();
-    emit debug(QStringLiteral("chronobike::errorService") + QString::fromLocal8Bit(metaEnum.valueToKey(err)) +
+    LOG_DEVICE(QStringLiteral("chronobike::errorService") + QString::fromLocal8Bit(metaEnum.valueToKey(err)) +
                m_control->errorString());
 }
 
 void chronobike::error(QLowEnergyController::Error err) {
     QMetaEnum metaEnum = QMetaEnum::fromType<QLowEnergyController::Error>();
-    emit debug(QStringLiteral("chronobike::error") + QString::fromLocal8Bit(metaEnum.valueToKey(err)) +
+    LOG_DEVICE(QStringLiteral("chronobike::error") + QString::fromLocal8Bit(metaEnum.valueToKey(err)) +
                m_control->errorString());
 }
 
 void chronobike::deviceDiscovered(const QBluetoothDeviceInfo &device) {
-    emit debug(QStringLiteral("Found new device: ") + device.name() + QStringLiteral(" (") +
+    LOG_DEVICE(QStringLiteral("Found new device: ") + device.name() + QStringLiteral(" (") +
                device.address().toString() + ')');
     {
         bluetoothDevice = device;
@@ -349,17 +351,17 @@ void chronobike::deviceDiscovered(const QBluetoothDeviceInfo &device) {
                 this, [this](QLowEnergyController::Error error) {
                     Q_UNUSED(error);
                     Q_UNUSED(this);
-                    emit debug(QStringLiteral("Cannot connect to remote device."));
+                    LOG_DEVICE(QStringLiteral("Cannot connect to remote device."));
                     emit disconnected();
                 });
         connect(m_control, &QLowEnergyController::connected, this, [this]() {
             Q_UNUSED(this);
-            emit debug(QStringLiteral("Controller connected. Search services..."));
+            LOG_DEVICE(QStringLiteral("Controller connected. Search services..."));
             m_control->discoverServices();
         });
         connect(m_control, &QLowEnergyController::disconnected, this, [this]() {
             Q_UNUSED(this);
-            emit debug(QStringLiteral("LowEnergy controller disconnected"));
+            LOG_DEVICE(QStringLiteral("LowEnergy controller disconnected"));
             emit disconnected();
         });
 
@@ -1,4 +1,5 @@
 #include "concept2skierg.h"
+#include "logging.h"
 #include "ftmsbike.h"
 #include "ios/lockscreen.h"
 #include "virtualtreadmill.h"
@@ -45,7 +46,7 @@ void concept2skierg::writeCharacteristic(uint8_t *data, uint8_t data_len, const
     gattFTMSService->writeCharacteristic(gattWriteCharControlPointId, QByteArray((const char *)data, data_len));
 
     if (!disable_log) {
-        emit debug(QStringLiteral(" >> ") + QByteArray((const char *)data, data_len).toHex(' ') +
+        LOG_PACKET(QStringLiteral(" >> ") + QByteArray((const char *)data, data_len).toHex(' ') +
                    QStringLiteral(" // ") + info);
     }
 
@@ -98,14 +99,14 @@ void concept2skierg::update() {
             }
 
             if (requestResistance != currentResistance().value()) {
-                emit debug(QStringLiteral("writing resistance ") + QString::number(requestResistance));
+                LOG_DEVICE(QStringLiteral("writing resistance ") + QString::number(requestResistance));
 
                 forceResistance(requestResistance);
             }
             requestResistance = -1;
         }
         if (requestStart != -1) {
-            emit debug(QStringLiteral("starting..."));
+            LOG_DEVICE(QStringLiteral("starting..."));
 
             // btinit();
 
@@ -113,7 +114,7 @@ void concept2skierg::update() {
             emit bikeStarted();
         }
         if (requestStop != -1) {
-            emit debug(QStringLiteral("stopping..."));
+            LOG_DEVICE(QStringLiteral("stopping..."));
 
             // writeCharacteristic(initDataF0C800B8, sizeof(initDataF0C800B8), "stop tape");
             requestStop = -1;
@@ -122,7 +123,7 @@ void concept2skierg::update() {
 }
 
 void concept2skierg::serviceDiscovered(const QBluetoothUuid &gatt) {
-    emit debug(QStringLiteral("serviceDiscovered ") + gatt.toString());
+    LOG_DEVICE(QStringLiteral("serviceDiscovered ") + gatt.toString());
 }
 
 void concept2skierg::characteristicChanged(const QLowEnergyCharacteristic &characteristic, const QByteArray &newValue) {
@@ -146,7 +147,7 @@ void concept2skierg::characteristicChanged(const QLowEnergyCharacteristic &chara
                                 (uint32_t)((uint8_t)newValue.at(3)));
 
         Distance = distance_dm / 10000.0;
-        emit debug(QStringLiteral("Current Distance: ") + QString::number(Distance.value()));
+        LOG_DEVICE(QStringLiteral("Current Distance: ") + QString::number(Distance.value()));
 
         uint8_t workout_type = newValue.at(6);
         uint8_t interval_type = newValue.at(7);
@@ -168,7 +169,7 @@ void concept2skierg::characteristicChanged(const QLowEnergyCharacteristic &chara
         // 0.001 m/s
         uint16_t speed_ms = (((uint16_t)((uint16_t)newValue.at(4)) << 8) | (uint16_t)((uint8_t)newValue.at(3)));
         Speed = speed_ms * 0.0036;
-        emit debug(QStringLiteral("Current Speed: ") + QString::number(Speed.value()));
+        LOG_DEVICE(QStringLiteral("Current Speed: ") + QString::number(Speed.value()));
 
         uint8_t stroke_rate = newValue.at(5);
         Cadence = stroke_rate;
@@ -176,7 +177,7 @@ void concept2skierg::characteristicChanged(const QLowEnergyCharacteristic &chara
         StrokesCount += (Cadence.value()) *
                         ((double)lastRefreshCharacteristicChanged.msecsTo(QDateTime::currentDateTime())) / 600000;
 
-        emit debug(QStringLiteral("Strokes Count: ") + QString::number(StrokesCount.value()));
+        LOG_DEVICE(QStringLiteral("Strokes Count: ") + QString::number(StrokesCount.value()));
 
         uint8_t heart_rate = newValue.at(6);
 
@@ -188,7 +189,7 @@ void concept2skierg::characteristicChanged(const QLowEnergyCharacteristic &chara
         {
             if (heart_rate != 0xFF)
                 Heart = heart_rate;
-            emit debug(QStringLiteral("Current Heart: ") + QString::number(Heart.value()));
+            LOG_DEVICE(QStringLiteral("Current Heart: ") + QString::number(Heart.value()));
         }
 
         // 0.01 sec
@@ -207,7 +208,7 @@ void concept2skierg::characteristicChanged(const QLowEnergyCharacteristic &chara
         uint16_t average_power = (((uint16_t)((uint16_t)newValue.at(5)) << 8) | (uint16_t)((uint8_t)newValue.at(4)));
         uint16_t total_calories = (((uint16_t)((uint16_t)newValue.at(7)) << 8) | (uint16_t)((uint8_t)newValue.at(6)));
         KCal = total_calories;
-        emit debug(QStringLiteral("Current KCal: ") + QString::number(KCal.value()));
+        LOG_DEVICE(QStringLiteral("Current KCal: ") + QString::number(KCal.value()));
         // ...
     }
 
@@ -245,8 +246,8 @@ void concept2skierg::characteristicChanged(const QLowEnergyCharacteristic &chara
 #endif
 #endif
 
-    emit debug(QStringLiteral("Current CrankRevs: ") + QString::number(CrankRevs));
-    emit debug(QStringLiteral("Last CrankEventTime: ") + QString::number(LastCrankEventTime));
+    LOG_DEVICE(QStringLiteral("Current CrankRevs: ") + QString::number(CrankRevs));
+    LOG_DEVICE(QStringLiteral("Last CrankEventTime: ") + QString::number(LastCrankEventTime));
 
     if (m_control->error() != QLowEnergyController::NoError) {
         qDebug() << QStringLiteral("QLowEnergyController ERROR!!") << m_control->errorString();
@@ -256,7 +257,7 @@ void concept2skierg::characteristicChanged(const QLowEnergyCharacteristic &chara
 void concept2skierg::stateChanged(QLowEnergyService::ServiceState state) {
 
     QMetaEnum metaEnum = QMetaEnum::fromType<QLowEnergyService::ServiceState>();
-    emit debug(QStringLiteral("BTLE stateChanged ") + QString::fromLocal8Bit(metaEnum.valueToKey(state)));
+    LOG_DEVICE(QStringLiteral("BTLE stateChanged ") + QString::fromLocal8Bit(metaEnum.valueToKey(state)));
 
     for (QLowEnergyService *s : qAsConst(gattCommunicationChannelService)) {
         qDebug() << QStringLiteral("stateChanged") << s->serviceUuid() << s->state();
@@ -363,7 +364,7 @@ void concept2skierg::stateChanged(QLowEnergyService::ServiceState state) {
 #endif
 #endif
             if (virtual_device_enabled) {
-            emit debug(QStringLiteral("creating virtual bike interface..."));
+            LOG_DEVICE(QStringLiteral("creating virtual bike interface..."));
 
             virtualTreadmill = new virtualtreadmill(this, noHeartService);
             connect(virtualTreadmill, &virtualtreadmill::debug, this, &concept2skierg::debug);
@@ -376,7 +377,7 @@ void concept2skierg::stateChanged(QLowEnergyService::ServiceState state) {
 }
 
 void concept2skierg::descriptorWritten(const QLowEnergyDescriptor &descriptor, const QByteArray &newValue) {
-    emit debug(QStringLiteral("descriptorWritten ") + descriptor.name() + " " + newValue.toHex(' '));
+    LOG_PACKET(QStringLiteral("descriptorWritten ") + descriptor.name() + " " + newValue.toHex(' '));
 
     initRequest = true;
     emit connectedAndDiscovered();
@@ -389,7 +390,7 @@ void concept2skierg::descriptorRead(const QLowEnergyDescriptor &descriptor, cons
 void concept2skierg::characteristicWritten(const QLowEnergyCharacteristic &characteristic, const QByteArray &newValue) {
 
     Q_UNUSED(characteristic);
-    emit debug(QStringLiteral("characteristicWritten ") + newValue.toHex(' '));
+    LOG_PACKET(QStringLiteral("characteristicWritten ") + newValue.toHex(' '));
 }
 
 void concept2skierg::characteristicRead(const QLowEnergyCharacteristic &characteristic, const QByteArray &newValue) {
@@ -397,7 +398,7 @@ void concept2skierg::characteristicRead(const QLowEnergyCharacteristic &characte
 }
 
 void concept2skierg::serviceScanDone(void) {
-    emit debug(QStringLiteral("serviceScanDone"));
+    LOG_DEVICE(QStringLiteral("serviceScanDone"));
 
 #ifdef Q_OS_ANDROID
     QLowEnergyConnectionParameters c;
@@ -419,19 +420,19 @@ void concept2skierg::serviceScanDone(void) {
 void concept2skierg::errorService(QLowEnergyService::ServiceError err) {
 
     QMetaEnum metaEnum = QMetaEnum::fromType<QLowEnergyService::ServiceError>();
-    emit debug(QStringLiteral("concept2skierg::errorService") + QString::fromLocal8Bit(metaEnum.valueToKey(err)) +
+    LOG_DEVICE(QStringLiteral("concept2skierg::errorService") + QString::fromLocal8Bit(metaEnum.valueToKey(err)) +
                m_control->errorString());
 }
 
 void concept2skierg::error(QLowEnergyController::Error err) {
 
     QMetaEnum metaEnum = QMetaEnum::fromType<QLowEnergyController::Error>();
-    emit debug(QStringLiteral("concept2skierg::error") + QString::fromLocal8Bit(metaEnum.valueToKey(err)) +
+    LOG_DEVICE(QStringLiteral("concept2skierg::error") + QString::fromLocal8Bit(metaEnum.valueToKey(err)) +
                m_control->errorString());
 }
 
 void concept2skierg::deviceDiscovered(const QBluetoothDeviceInfo &device) {
-    emit debug(QStringLiteral("Found new device: ") + device.name() + QStringLiteral(" (") +
+    LOG_DEVICE(QStringLiteral("Found new device: ") + device.name() + QStringLiteral(" (") +
                device.address().toString() + ')');
     {
         bluetoothDevice = device;
@@ -449,17 +450,17 @@ void concept2skierg::deviceDiscovered(const QBluetoothDeviceInfo &device) {
                 this, [this](QLowEnergyController::Error error) {
                     Q_UNUSED(error);
                     Q_UNUSED(this);
-                    emit debug(QStringLiteral("Cannot connect to remote device."));
+                    LOG_DEVICE(QStringLiteral("Cannot connect to remote device."));
                     emit disconnected();
                 });
         connect(m_control, &QLowEnergyController::connected, this, [this]() {
             Q_UNUSED(this);
-            emit debug(QStringLiteral("Controller connected. Search services..."));
+            LOG_DEVICE(QStringLiteral("Controller connected. Search services..."));
             m_control->discoverServices();
         });
         connect(m_control, &QLowEnergyController::disconnected, this, [this]() {
             Q_UNUSED(this);
-            emit debug(QStringLiteral("LowEnergy controller disconnected"));
+            LOG_DEVICE(QStringLiteral("LowEnergy controller disconnected"));
             emit disconnected();
         });
 
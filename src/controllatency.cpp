@@ -0,0 +1,222 @@
+#include "controllatency.h"
+#include "bluetoothdevice.h"
+#include "qdebugfixup.h"
+#include <QJsonArray>
+#include <QTimer>
+#include <math.h>
+
+// a request not reflected in this time is dropped: the machine doesn't report it, or it can't reach it
+static const double controlLatencyTimeoutMs = 10000;
+
+const double controllatency::histogram::bounds[BUCKETS - 1] = {1,   2,    5,    10,   20,   50,   100,
+                                                               200, 500, 1000, 2000, 5000, 10000};
+
+void controllatency::histogram::add(double ms) {
+    if (!m_count || ms < m_min) {
+        m_min = ms;
+    }
+    if (!m_count || ms > m_max) {
+        m_max = ms;
+    }
+    m_count++;
+    m_sum += ms;
+    int i = 0;
+    while (i < BUCKETS - 1 && ms > bounds[i]) {
+        i++;
+    }
+    buckets[i]++;
+}
+
+double controllatency::histogram::percentile(double p) const {
+    if (!m_count) {
+        return -1;
+    }
+    quint32 rank = qMax<quint32>(1, (quint32)ceil(p * m_count));
+    quint32 seen = 0;
+    for (int i = 0; i < BUCKETS - 1; i++) {
+        seen += buckets[i];
+        if (seen >= rank) {
+            return qMin(bounds[i], m_max);
+        }
+    }
+    return m_max;
+}
+
+QJsonObject controllatency::histogram::toJson() const {
+    QJsonObject o;
+    o[QStringLiteral("count")] = (int)m_count;
+    o[QStringLiteral("avg")] = average();
+    o[QStringLiteral("min")] = min();
+    o[QStringLiteral("max")] = max();
+    o[QStringLiteral("p50")] = percentile(0.5);
+    o[QStringLiteral("p95")] = percentile(0.95);
+    QJsonArray le;
+    QJsonArray counts;
+    for (int i = 0; i < BUCKETS; i++) {
+        le.append(i < BUCKETS - 1 ? QJsonValue(bounds[i]) : QJsonValue(QStringLiteral("inf")));
+        counts.append((int)buckets[i]);
+    }
+    o[QStringLiteral("le")] = le;
+    o[QStringLiteral("buckets")] = counts;
+    return o;
+}
+
+controllatency::controllatency(bluetoothdevice *device) : QObject(device), device(device) { clock.start(); }
+
+const char *controllatency::intervalName(INTERVAL i) {
+    static const char *names[INTERVALS] = {"dispatch", "queue", "write", "actuation", "total"};
+    return names[i];
+}
+
+void controllatency::open(REQUEST request, double target, STAGE stage) {
+    if (current.open) {
+        m_superseded++;
+    }
+    current = trace();
+    current.open = true;
+    current.request = request;
+    current.target = target;
+    current.resistance = device->currentResistance().value();
+    for (int i = 0; i < STAGES; i++) {
+        current.t[i] = -1;
+    }
+    current.t[stage] = now();
+}
+
+bool controllatency::repeated(REQUEST request, double target) const {
+    // Zwift sends the same grade again and again, the machine has nothing new to do
+    return (current.open || lastValid) && current.request == request && current.target == target;
+}
+
+void controllatency::received(REQUEST request, double target) {
+    if (repeated(request, target)) {
+        return;
+    }
+    open(request, target, RECEIVED);
+}
+
+void controllatency::requested(REQUEST request, double target) {
+    if (current.open && current.t[REQUESTED] < 0 && current.request == request) {
+        // the virtual device forwarding what it received, maybe adjusted to the machine
+        current.target = target;
+        current.t[REQUESTED] = now();
+        return;
+    }
+    if (current.open && current.t[QUEUED] < 0 && current.request != RESISTANCE && request == RESISTANCE) {
+        // the translation of a power or of a grade request in a resistance level
+        return;
+    }
+    if (repeated(request, target)) {
+        return;
+    }
+    open(request, target, REQUESTED);
+}
+
+void controllatency::queued() {
+    if (current.open && current.t[QUEUED] < 0) {
+        current.t[QUEUED] = now();
+    }
+}
+
+void controllatency::writing(quint64 write) {
+    if (current.open && current.t[QUEUED] >= 0 && !current.write) {
+        current.write = write;
+    }
+}
+
+void controllatency::written(quint64 write) {
+    if (current.open && write && current.write == write && current.t[WRITTEN] < 0) {
+        current.t[WRITTEN] = now();
+    }
+}
+
+void controllatency::notified() {
+    if (!current.open || checkPending) {
+        return;
+    }
+    checkPending = true;
+    QTimer::singleShot(0, this, [this]() {
+        checkPending = false;
+        check();
+    });
+}
+
+bool controllatency::reflected() const {
+    double resistance = device->currentResistance().value();
+    if (resistance != current.resistance) {
+        return true;
+    }
+    switch (current.request) {
+    case POWER:
+        return qAbs(device->wattsMetric().value() - current.target) <= qMax(10.0, current.target * 0.1);
+    case RESISTANCE:
+        return qRound(resistance) == qRound(current.target);
+    case INCLINATION:
+        return qAbs(device->currentInclination().value() - current.target) < 0.1;
+    }
+    return false;
+}
+
+void controllatency::check() {
+    if (!current.open) {
+        return;
+    }
+    double t = now();
+    double first = current.t[RECEIVED] >= 0 ? current.t[RECEIVED] : current.t[REQUESTED];
+    if (t - first > controlLatencyTimeoutMs) {
+        m_timedOut++;
+        current.open = false;
+        lastValid = true;
+        return;
+    }
+    if (!reflected()) {
+        return;
+    }
+
+    current.t[REFLECTED] = t;
+    for (int i = RECEIVED; i < REFLECTED; i++) {
+        if (current.t[i] >= 0 && current.t[i + 1] >= 0) {
+            intervals[i].add(current.t[i + 1] - current.t[i]);
+        }
+    }
+    intervals[TOTAL].add(t - first);
+    qDebug() << QStringLiteral("controllatency: request") << current.request << current.target
+             << QStringLiteral("reflected in") << (t - first) << QStringLiteral("ms");
+    current.open = false;
+    lastValid = true;
+}
+
+QJsonObject controllatency::toJson() const {
+    QJsonObject o;
+    for (int i = 0; i < INTERVALS; i++) {
+        o[QString::fromLatin1(intervalName((INTERVAL)i))] = intervals[i].toJson();
+    }
+    o[QStringLiteral("superseded")] = (int)m_superseded;
+    o[QStringLiteral("timedOut")] = (int)m_timedOut;
+    return o;
+}
+
+void controllatency::dump() const {
+    if (!intervals[TOTAL].count() && !m_timedOut) {
+        return;
+    }
+    for (int i = 0; i < INTERVALS; i++) {
+        const histogram &h = intervals[i];
+        qDebug() << QStringLiteral("controllatency:") << intervalName((INTERVAL)i) << QStringLiteral("n") << h.count()
+                 << QStringLiteral("avg") << h.average() << QStringLiteral("p50") << h.percentile(0.5)
+                 << QStringLiteral("p95") << h.percentile(0.95) << QStringLiteral("max") << h.max()
+                 << QStringLiteral("ms");
+    }
+    qDebug() << QStringLiteral("controllatency: superseded") << m_superseded << QStringLiteral("timed out")
+             << m_timedOut;
+}
+
+void controllatency::reset() {
+    for (int i = 0; i < INTERVALS; i++) {
+        intervals[i] = histogram();
+    }
+    current = trace();
+    lastValid = false;
+    m_superseded = 0;
+    m_timedOut = 0;
+}
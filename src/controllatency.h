@@ -0,0 +1,101 @@
+#ifndef CONTROLLATENCY_H
+#define CONTROLLATENCY_H
+
+#include <QElapsedTimer>
+#include <QJsonObject>
+#include <QObject>
+
+class bluetoothdevice;
+
+// Latency of the control requests (ERG target power, SIM grade, resistance level), from the app writing the request
+// on the virtual device to the machine actuating it. A request goes through these stages, each with a monotonic
+// timestamp:
+//
+//   RECEIVED   the write on the FTMS control point of the virtual device (virtualbike)
+//   REQUESTED  bike::changePower, changeResistance or changeInclination
+//   QUEUED     the driver taking the request in its update loop to write it (bluetoothdevice::requestQueued)
+//   WRITTEN    the completion of the write carrying it, matched by its token (bluetoothwatchdog)
+//   REFLECTED  the first notification where the machine shows the new value
+//
+// and the time between two stages ends in a histogram. The requests of the train programs and of the templates
+// start at REQUESTED. Only one request is traced at a time: a different one supersedes it.
+class controllatency : public QObject {
+    Q_OBJECT
+  public:
+    enum STAGE { RECEIVED = 0, REQUESTED, QUEUED, WRITTEN, REFLECTED, STAGES };
+    enum REQUEST { POWER = 0, RESISTANCE, INCLINATION };
+    // DISPATCH is RECEIVED -> REQUESTED, ..., ACTUATION is WRITTEN -> REFLECTED, TOTAL is the first stage -> REFLECTED
+    enum INTERVAL { DISPATCH = 0, QUEUE, WRITE, ACTUATION, TOTAL, INTERVALS };
+
+    class histogram {
+      public:
+        static const int BUCKETS = 14;
+        // upper bounds of the buckets in ms, the last one is unbounded
+        static const double bounds[BUCKETS - 1];
+
+        void add(double ms);
+        quint32 count() const { return m_count; }
+        double average() const { return m_count ? m_sum / m_count : -1; }
+        double min() const { return m_count ? m_min : -1; }
+        double max() const { return m_count ? m_max : -1; }
+        // upper bound of the bucket of the percentile, max() for the last bucket
+        double percentile(double p) const;
+        QJsonObject toJson() const;
+
+      private:
+        quint32 m_count = 0;
+        double m_sum = 0;
+        double m_min = 0;
+        double m_max = 0;
+        quint32 buckets[BUCKETS] = {};
+    };
+
+    explicit controllatency(bluetoothdevice *device);
+
+    void received(REQUEST request, double target);
+    void requested(REQUEST request, double target);
+    void queued();
+    // the write carrying the queued request, and the completion of a write: the polls in between don't count
+    void writing(quint64 write);
+    void written(quint64 write);
+    // a notification of the device: the check waits for the driver to parse it
+    void notified();
+
+    const histogram &interval(INTERVAL i) const { return intervals[i]; }
+    quint32 superseded() const { return m_superseded; }
+    quint32 timedOut() const { return m_timedOut; }
+    static const char *intervalName(INTERVAL i);
+    QJsonObject toJson() const;
+    // the histograms to the log
+    void dump() const;
+    void reset();
+
+  private:
+    double now() const { return clock.nsecsElapsed() / 1000000.0; }
+    void open(REQUEST request, double target, STAGE stage);
+    bool repeated(REQUEST request, double target) const;
+    bool reflected() const;
+    void check();
+
+    bluetoothdevice *device;
+    QElapsedTimer clock;
+    bool checkPending = false;
+
+    struct trace {
+        bool open = false;
+        REQUEST request = POWER;
+        double target = 0;
+        // resistance of the machine when the request started, any change means it's actuating it
+        double resistance = 0;
+        quint64 write = 0; // token of the write carrying it, 0 until it's queued
+        double t[STAGES];
+    } current;
+    // current is closed but it's still the last request, to recognize the repetitions
+    bool lastValid = false;
+
+    histogram intervals[INTERVALS];
+    quint32 m_superseded = 0;
+    quint32 m_timedOut = 0;
+};
+
+#endif // CONTROLLATENCY_H
@@ -1,4 +1,5 @@
 #include "cscbike.h"
+#include "logging.h"
 #include "ios/lockscreen.h"
 #include "virtualbike.h"
 #include <QBluetoothLocalDevice>
@@ -96,7 +97,7 @@ void cscbike::update() {
             avgP = 50;
         }
         m_watt = avgP;
-        emit debug(QStringLiteral("Current Watt: ") + QString::number(m_watt.value()));
+        LOG_DEVICE(QStringLiteral("Current Watt: ") + QString::number(m_watt.value()));
     }
 
     if (m_control->state() == QLowEnergyController::UnconnectedState) {
@@ -112,6 +113,11 @@ void cscbike::update() {
                                                                            // gattWriteCharacteristic.isValid() &&
                                                                            // gattNotify1Characteristic.isValid() &&
                /*initDone*/) {
+        // the sensors stop notifying when the pedals stop, so the decay to 0 has to be driven from here
+        if ((crankDecoder.active() || wheelDecoder.active()) &&
+            lastRefreshCharacteristicChanged.msecsTo(QDateTime::currentDateTime()) > 1000) {
+            updateRates();
+        }
         update_metrics(true, watts());
 
         // updating the treadmill console every second
@@ -128,13 +134,13 @@ void cscbike::update() {
             }
 
             if (requestResistance != currentResistance().value()) {
-                emit debug(QStringLiteral("writing resistance ") + QString::number(requestResistance));
+                LOG_DEVICE(QStringLiteral("writing resistance ") + QString::number(requestResistance));
                 // forceResistance(requestResistance);
             }
             requestResistance = -1;
         }
         if (requestStart != -1) {
-            emit debug(QStringLiteral("starting..."));
+            LOG_DEVICE(QStringLiteral("starting..."));
 
             // btinit();
 
@@ -142,15 +148,44 @@ void cscbike::update() {
             emit bikeStarted();
         }
         if (requestStop != -1) {
-            emit debug(QStringLiteral("stopping..."));
+            LOG_DEVICE(QStringLiteral("stopping..."));
             // writeCharacteristic(initDataF0C800B8, sizeof(initDataF0C800B8), "stop tape");
             requestStop = -1;
         }
     }
 }
 
+void cscbike::updateRates() {
+    // the real events are forwarded to the virtual device
+    if (crankDecoder.active()) {
+        Cadence = crankDecoder.rpm();
+        CrankRevs = crankDecoder.revolutions();
+        LastCrankEventTime = crankDecoder.lastEventTime();
+    } else {
+        // speed only sensors have always been used as cadence sensors
+        Cadence = wheelDecoder.rpm();
+        CrankRevs = wheelDecoder.revolutions();
+        LastCrankEventTime = wheelDecoder.lastEventTime();
+    }
+    emit cadenceChanged(Cadence.value());
+    LOG_DEVICE(QStringLiteral("Current Cadence: ") + QString::number(Cadence.value()));
+
+    QSettings settings;
+    if (!settings.value(QStringLiteral("speed_power_based"), false).toBool()) {
+        if (wheelDecoder.active()) {
+            Speed = wheelDecoder.rpm() *
+                    settings.value(QStringLiteral("csc_wheel_circumference"), 2000.0).toDouble() * 60.0 / 1000000.0;
+        } else {
+            Speed = Cadence.value() * settings.value(QStringLiteral("cadence_sensor_speed_ratio"), 0.33).toDouble();
+        }
+    } else {
+        Speed = metric::calculateSpeedFromPower(m_watt.value());
+    }
+    LOG_DEVICE(QStringLiteral("Current Speed: ") + QString::number(Speed.value()));
+}
+
 void cscbike::serviceDiscovered(const QBluetoothUuid &gatt) {
-    emit debug(QStringLiteral("serviceDiscovered ") + gatt.toString());
+    LOG_DEVICE(QStringLiteral("serviceDiscovered ") + gatt.toString());
 }
 
 void cscbike::characteristicChanged(const QLowEnergyCharacteristic &characteristic, const QByteArray &newValue) {
@@ -160,7 +195,7 @@ void cscbike::characteristicChanged(const QLowEnergyCharacteristic &characterist
     // QString heartRateBeltName = //unused QString
     // settings.value(QStringLiteral("heart_rate_belt_name"), QStringLiteral("Disabled")).toString();
 
-    emit debug(QStringLiteral(" << ") + newValue.toHex(' '));
+    LOG_PACKET(QStringLiteral(" << ") + newValue.toHex(' '));
 
     if (characteristic.uuid() != QBluetoothUuid((quint16)0x2A5B)) {
         return;
@@ -168,54 +203,30 @@ void cscbike::characteristicChanged(const QLowEnergyCharacteristic &characterist
 
     lastPacket = newValue;
 
+    uint8_t flags = newValue.at(0);
     uint8_t index = 1;
-    if (newValue.at(0) == 0x02) {
-        CrankRevs = (((uint16_t)((uint8_t)newValue.at(index + 1)) << 8) | (uint16_t)((uint8_t)newValue.at(index)));
-    } else {
-        CrankRevs =
+    if ((flags & 0x01) && newValue.length() >= index + 6) { // Wheel Revolution Data Present
+        uint32_t wheelRevs =
             (((uint32_t)((uint8_t)newValue.at(index + 3)) << 24) | ((uint32_t)((uint8_t)newValue.at(index + 2)) << 16) |
              ((uint32_t)((uint8_t)newValue.at(index + 1)) << 8) | (uint32_t)((uint8_t)newValue.at(index)));
+        uint16_t wheelTime =
+            (((uint16_t)((uint8_t)newValue.at(index + 5)) << 8) | (uint16_t)((uint8_t)newValue.at(index + 4)));
+        wheelDecoder.push(wheelRevs, wheelTime);
+        index += 6;
     }
-    if (newValue.at(0) == 0x01) {
-        index += 4;
-    } else {
-        index += 2;
+    if ((flags & 0x02) && newValue.length() >= index + 4) { // Crank Revolution Data Present
+        uint16_t crankRevs =
+            (((uint16_t)((uint8_t)newValue.at(index + 1)) << 8) | (uint16_t)((uint8_t)newValue.at(index)));
+        uint16_t crankTime =
+            (((uint16_t)((uint8_t)newValue.at(index + 3)) << 8) | (uint16_t)((uint8_t)newValue.at(index + 2)));
+        crankDecoder.push(crankRevs, crankTime);
     }
-    LastCrankEventTime = (((uint16_t)((uint8_t)newValue.at(index + 1)) << 8) | (uint16_t)((uint8_t)newValue.at(index)));
 
-    int16_t deltaT = LastCrankEventTime - oldLastCrankEventTime;
-    if (deltaT < 0) {
-        if (newValue.at(0) == 0x01) {
-            deltaT = LastCrankEventTime + 1024 - oldLastCrankEventTime;
-        } else {
-            deltaT = LastCrankEventTime + 65535 - oldLastCrankEventTime;
-        }
-    }
-
-    if (CrankRevs != oldCrankRevs && deltaT) {
-        double cadence = ((CrankRevs - oldCrankRevs) / deltaT) * 1024 * 60;
-        if (cadence >= 0 && cadence < 256)
-            Cadence = cadence;
-        lastGoodCadence = QDateTime::currentDateTime();
-    } else if (lastGoodCadence.msecsTo(QDateTime::currentDateTime()) > 2000) {
-        Cadence = 0;
-    }
-    emit cadenceChanged(Cadence.value());
-    emit debug(QStringLiteral("Current Cadence: ") + QString::number(Cadence.value()));
-
-    oldLastCrankEventTime = LastCrankEventTime;
-    oldCrankRevs = CrankRevs;
-
-    if (!settings.value(QStringLiteral("speed_power_based"), false).toBool()) {
-        Speed = Cadence.value() * settings.value(QStringLiteral("cadence_sensor_speed_ratio"), 0.33).toDouble();
-    } else {
-        Speed = metric::calculateSpeedFromPower(m_watt.value());
-    }
-    emit debug(QStringLiteral("Current Speed: ") + QString::number(Speed.value()));
+    updateRates();
 
     Distance += ((Speed.value() / 3600000.0) *
                  ((double)lastRefreshCharacteristicChanged.msecsTo(QDateTime::currentDateTime())));
-    emit debug(QStringLiteral("Current Distance: ") + QString::number(Distance.value()));
+    LOG_DEVICE(QStringLiteral("Current Distance: ") + QString::number(Distance.value()));
 
     double ac = 0.01243107769;
     double bc = 1.145964912;
@@ -248,12 +259,7 @@ void cscbike::characteristicChanged(const QLowEnergyCharacteristic &characterist
              (60000.0 / ((double)lastRefreshCharacteristicChanged.msecsTo(
                             QDateTime::currentDateTime())))); //(( (0.048* Output in watts +1.19) * body weight in kg
                                                               //* 3.5) / 200 ) / 60
-    emit debug(QStringLiteral("Current KCal: ") + QString::number(KCal.value()));
-
-    if (Cadence.value() > 0) {
-        CrankRevs++;
-        LastCrankEventTime += (uint16_t)(1024.0 / (((double)(Cadence.value())) / 60.0));
-    }
+    LOG_DEVICE(QStringLiteral("Current KCal: ") + QString::number(KCal.value()));
 
     lastRefreshCharacteristicChanged = QDateTime::currentDateTime();
 
@@ -270,8 +276,8 @@ void cscbike::characteristicChanged(const QLowEnergyCharacteristic &characterist
 #endif
     }
 
-    emit debug(QStringLiteral("Current CrankRevs: ") + QString::number(CrankRevs));
-    emit debug(QStringLiteral("Last CrankEventTime: ") + QString::number(LastCrankEventTime));
+    LOG_DEVICE(QStringLiteral("Current CrankRevs: ") + QString::number(CrankRevs));
+    LOG_DEVICE(QStringLiteral("Last CrankEventTime: ") + QString::number(LastCrankEventTime));
 
     if (m_control->error() != QLowEnergyController::NoError) {
         qDebug() << QStringLiteral("QLowEnergyController ERROR!!") << m_control->errorString();
@@ -280,7 +286,7 @@ void cscbike::characteristicChanged(const QLowEnergyCharacteristic &characterist
 
 void cscbike::stateChanged(QLowEnergyService::ServiceState state) {
     QMetaEnum metaEnum = QMetaEnum::fromType<QLowEnergyService::ServiceState>();
-    emit debug(QStringLiteral("BTLE stateChanged ") + QString::fromLocal8Bit(metaEnum.valueToKey(state)));
+    LOG_DEVICE(QStringLiteral("BTLE stateChanged ") + QString::fromLocal8Bit(metaEnum.valueToKey(state)));
 
     for (QLowEnergyService *s : qAsConst(gattCommunicationChannelService)) {
         qDebug() << QStringLiteral("stateChanged") << s->serviceUuid() << s->state();
@@ -373,7 +379,7 @@ void cscbike::stateChanged(QLowEnergyService::ServiceState state) {
 #endif
 #endif
             if (virtual_device_enabled) {
-            emit debug(QStringLiteral("creating virtual bike interface..."));
+            LOG_DEVICE(QStringLiteral("creating virtual bike interface..."));
             virtualBike = new virtualbike(this, noWriteResistance, noHeartService);
             connect(virtualBike, &virtualbike::changeInclination, this, &cscbike::changeInclination);
             // connect(virtualBike,&virtualbike::debug ,this,&cscbike::debug);
@@ -384,7 +390,7 @@ void cscbike::stateChanged(QLowEnergyService::ServiceState state) {
 }
 
 void cscbike::descriptorWritten(const QLowEnergyDescriptor &descriptor, const QByteArray &newValue) {
-    emit debug(QStringLiteral("descriptorWritten ") + descriptor.name() + QStringLiteral(" ") + newValue.toHex(' '));
+    LOG_PACKET(QStringLiteral("descriptorWritten ") + descriptor.name() + QStringLiteral(" ") + newValue.toHex(' '));
 
     initRequest = true;
     emit connectedAndDiscovered();
@@ -396,7 +402,7 @@ void cscbike::descriptorRead(const QLowEnergyDescriptor &descriptor, const QByte
 
 void cscbike::characteristicWritten(const QLowEnergyCharacteristic &characteristic, const QByteArray &newValue) {
     Q_UNUSED(characteristic);
-    emit debug(QStringLiteral("characteristicWritten ") + newValue.toHex(' '));
+    LOG_PACKET(QStringLiteral("characteristicWritten ") + newValue.toHex(' '));
 }
 
 void cscbike::characteristicRead(const QLowEnergyCharacteristic &characteristic, const QByteArray &newValue) {
@@ -404,7 +410,7 @@ void cscbike::characteristicRead(const QLowEnergyCharacteristic &characteristic,
 }
 
 void cscbike::serviceScanDone(void) {
-    emit debug(QStringLiteral("serviceScanDone"));
+    LOG_DEVICE(QStringLiteral("serviceScanDone"));
 
 #ifdef Q_OS_ANDROID
     QLowEnergyConnectionParameters c;
@@ -424,18 +430,18 @@ void cscbike::serviceScanDone(void) {
 
 void cscbike::errorService(QLowEnergyService::ServiceError err) {
     QMetaEnum metaEnum = QMetaEnum::fromType<QLowEnergyService::ServiceError>();
-    emit debug(QStringLiteral("cscbike::errorService") + QString::fromLocal8Bit(metaEnum.valueToKey(err)) +
+    LOG_DEVICE(QStringLiteral("cscbike::errorService") + QString::fromLocal8Bit(metaEnum.valueToKey(err)) +
                m_control->errorString());
 }
 
 void cscbike::error(QLowEnergyController::Error err) {
     QMetaEnum metaEnum = QMetaEnum::fromType<QLowEnergyController::Error>();
-    emit debug(QStringLiteral("cscbike::error") + QString::fromLocal8Bit(metaEnum.valueToKey(err)) +
+    LOG_DEVICE(QStringLiteral("cscbike::error") + QString::fromLocal8Bit(metaEnum.valueToKey(err)) +
                m_control->errorString());
 }
 
 void cscbike::deviceDiscovered(const QBluetoothDeviceInfo &device) {
-    emit debug(QStringLiteral("Found new device: ") + device.name() + QStringLiteral(" (") +
+    LOG_DEVICE(QStringLiteral("Found new device: ") + device.name() + QStringLiteral(" (") +
                device.address().toString() + ')');
     {
         bluetoothDevice = device;
@@ -453,17 +459,17 @@ void cscbike::deviceDiscovered(const QBluetoothDeviceInfo &device) {
                 this, [this](QLowEnergyController::Error error) {
                     Q_UNUSED(error);
                     Q_UNUSED(this);
-                    emit debug(QStringLiteral("Cannot connect to remote device."));
+                    LOG_DEVICE(QStringLiteral("Cannot connect to remote device."));
                     emit disconnected();
                 });
         connect(m_control, &QLowEnergyController::connected, this, [this]() {
             Q_UNUSED(this);
-            emit debug(QStringLiteral("Controller connected. Search services..."));
+            LOG_DEVICE(QStringLiteral("Controller connected. Search services..."));
             m_control->discoverServices();
         });
         connect(m_control, &QLowEnergyController::disconnected, this, [this]() {
             Q_UNUSED(this);
-            emit debug(QStringLiteral("LowEnergy controller disconnected"));
+            LOG_DEVICE(QStringLiteral("LowEnergy controller disconnected"));
             emit disconnected();
         });
 
@@ -27,6 +27,7 @@
 #include <QString>
 
 #include "bike.h"
+#include "cscdecoder.h"
 #include "virtualbike.h"
 
 #ifdef Q_OS_IOS
@@ -46,6 +47,7 @@ class cscbike : public bike {
     //    void writeCharacteristic(uint8_t *data, uint8_t data_len, QString info, bool disable_log = false, //Unused
     //                             bool wait_for_response = false);
     void startDiscover();
+    void updateRates();
     uint16_t watts();
 
     QTimer *refresh;
@@ -57,7 +59,6 @@ class cscbike : public bike {
     uint8_t sec1Update = 0;
     QByteArray lastPacket;
     QDateTime lastRefreshCharacteristicChanged = QDateTime::currentDateTime();
-    QDateTime lastGoodCadence = QDateTime::currentDateTime();
     uint8_t firstStateChanged = 0;
 
     bool initDone = false;
@@ -67,8 +68,8 @@ class cscbike : public bike {
     bool noHeartService = false;
     bool noVirtualDevice = false;
 
-    uint16_t oldLastCrankEventTime = 0;
-    uint16_t oldCrankRevs = 0;
+    cscdecoder crankDecoder = cscdecoder(16, 1024);
+    cscdecoder wheelDecoder = cscdecoder(32, 1024);
 
 #ifdef Q_OS_IOS
     lockscreen *h = 0;
@@ -0,0 +1,138 @@
+#include "cscdecoder.h"
+#include <chrono>
+
+cscdecoder::cscdecoder(int revsBits, uint16_t resolution) : resolution(resolution) {
+    revsMask = revsBits >= 32 ? 0xFFFFFFFF : ((1u << revsBits) - 1);
+    configure(3000, 4000);
+}
+
+void cscdecoder::configure(int windowMs, int staleMs) {
+    windowTicks = (int64_t)windowMs * resolution / 1000;
+    this->staleMs = staleMs;
+}
+
+int64_t cscdecoder::now() {
+    return std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now().time_since_epoch())
+        .count();
+}
+
+uint16_t cscdecoder::eventPeriod(double rpm, uint16_t resolution) {
+    if (rpm <= 0) {
+        return 0;
+    }
+    return (uint16_t)(resolution * 60.0 / rpm);
+}
+
+void cscdecoder::reset() {
+    started = false;
+    count = 0;
+    head = 0;
+    totalRevs = 0;
+    totalTicks = 0;
+}
+
+const cscdecoder::event &cscdecoder::at(int i) const { return events[(head - 1 - i + historySize) % historySize]; }
+
+void cscdecoder::append(int64_t ticks, uint64_t revs) {
+    events[head] = {ticks, revs};
+    head = (head + 1) % historySize;
+    if (count < historySize) {
+        count++;
+    }
+    // the two newest events are always kept, so a slow cadence still has a rate
+    while (count > 2 && ticks - at(count - 1).ticks > windowTicks) {
+        count--;
+    }
+}
+
+void cscdecoder::resync(uint32_t revs, uint16_t eventTime, int64_t now) {
+    // restart the timeline from this event: the deltas against the previous one can't be trusted
+    count = 0;
+    head = 0;
+    lastRevs = revs;
+    lastTime = eventTime;
+    lastEventAt = now;
+    append(totalTicks, totalRevs);
+}
+
+bool cscdecoder::push(uint32_t revs, uint16_t eventTime) { return push(revs, eventTime, now()); }
+
+bool cscdecoder::push(uint32_t revs, uint16_t eventTime, int64_t now) {
+    revs &= revsMask;
+    int64_t gap = now - lastNotification;
+    lastNotification = now;
+
+    if (!started) {
+        started = true;
+        resync(revs, eventTime, now);
+        return false;
+    }
+
+    // unsigned arithmetic handles the rollover of both counters
+    uint32_t deltaRevs = (revs - lastRevs) & revsMask;
+    uint16_t deltaTime = (uint16_t)(eventTime - lastTime);
+
+    if (!deltaRevs && !deltaTime) {
+        // same event notified again
+        return false;
+    }
+    // after a silence longer than the event time span the number of rollovers is unknown
+    if (gap >= (int64_t)65536 * 1000 / resolution || !deltaTime) {
+        resync(revs, eventTime, now);
+        return false;
+    }
+
+    totalTicks += deltaTime;
+    lastTime = eventTime;
+    if (!deltaRevs) {
+        // some sensors move the event time without a new revolution
+        return false;
+    }
+
+    totalRevs += deltaRevs;
+    lastRevs = revs;
+    lastEventAt = now;
+    append(totalTicks, totalRevs);
+    return true;
+}
+
+double cscdecoder::rpm() const { return rpm(now()); }
+
+double cscdecoder::rpm(int64_t now) const {
+    if (count < 2) {
+        return 0;
+    }
+    int64_t since = now - lastEventAt;
+    if (since > staleMs) {
+        return 0;
+    }
+
+    // least squares slope of the revolutions over the event time, relative to the newest event for precision
+    const event &newest = at(0);
+    double sx = 0, sy = 0, sxx = 0, sxy = 0;
+    for (int i = 0; i < count; i++) {
+        double x = (double)(at(i).ticks - newest.ticks);
+        double y = (double)at(i).revs - (double)newest.revs;
+        sx += x;
+        sy += y;
+        sxx += x * x;
+        sxy += x * y;
+    }
+    double den = count * sxx - sx * sx;
+    if (den <= 0) {
+        return 0;
+    }
+    double rate = ((count * sxy - sx * sy) / den) * resolution * 60.0;
+    if (rate < 0) {
+        return 0;
+    }
+
+    // if the pedals were still turning at this rate, a new event would have arrived by now
+    if (since > notificationSlack) {
+        double bound = 60000.0 / (double)(since - notificationSlack);
+        if (rate > bound) {
+            rate = bound;
+        }
+    }
+    return rate;
+}
@@ -0,0 +1,68 @@
+#ifndef CSCDECODER_H
+#define CSCDECODER_H
+
+#include <array>
+#include <stdint.h>
+
+// Turns the cumulative revolutions / last event time pairs of the Cycling Speed and Cadence and Cycling Power
+// measurements into revolutions per minute. Both counters roll over (the event time every 64 seconds at 1/1024 s), so
+// they are unwrapped into a continuous timeline and the rate is the least squares slope of the events inside a short
+// window instead of the ratio of the last two, which is very noisy at low cadence. When the events stop, the rate
+// decays to the highest value compatible with the time elapsed since the last event and then drops to 0.
+class cscdecoder {
+  public:
+    // revsBits: width of the revolutions counter (16 for the crank data, 32 for the wheel data)
+    // resolution: event time ticks per second (1024, or 2048 for the wheel data of the cycling power measurement)
+    explicit cscdecoder(int revsBits = 16, uint16_t resolution = 1024);
+    void configure(int windowMs, int staleMs);
+
+    // returns true if the notification carried at least a new event
+    bool push(uint32_t revs, uint16_t eventTime);
+    bool push(uint32_t revs, uint16_t eventTime, int64_t now);
+
+    // true after the first notification
+    bool active() const { return started; }
+    double rpm() const;
+    double rpm(int64_t now) const;
+    // unwrapped revolutions and event time of the last event, to forward the real events to the virtual devices
+    double revolutions() const { return (double)totalRevs; }
+    uint16_t lastEventTime() const { return lastTime; }
+    void reset();
+
+    // event time increment of one revolution at the given rate, for the devices that synthesize the events
+    static uint16_t eventPeriod(double rpm, uint16_t resolution = 1024);
+    static int64_t now();
+
+  private:
+    static const int historySize = 16;
+    // sensors notify at 1Hz, so a new event can show up to a notification interval later than expected
+    static const int64_t notificationSlack = 1000;
+
+    struct event {
+        int64_t ticks;
+        uint64_t revs;
+    };
+
+    void resync(uint32_t revs, uint16_t eventTime, int64_t now);
+    void append(int64_t ticks, uint64_t revs);
+    const event &at(int i) const; // 0 is the newest one
+
+    uint32_t revsMask;
+    uint16_t resolution;
+    int64_t windowTicks;
+    int64_t staleMs = 4000;
+
+    bool started = false;
+    uint32_t lastRevs = 0;
+    uint16_t lastTime = 0;
+    int64_t lastNotification = 0;
+    int64_t lastEventAt = 0;
+    uint64_t totalRevs = 0;
+    int64_t totalTicks = 0;
+
+    std::array<event, historySize> events;
+    int head = 0;
+    int count = 0;
+};
+
+#endif // CSCDECODER_H
@@ -0,0 +1,200 @@
+#include "dirconserver.h"
+#include "qdebugfixup.h"
+#include <QtEndian>
+
+dirconserver::dirconserver(const QList<QLowEnergyServiceData> &services, quint16 port, QObject *parent)
+    : QObject(parent) {
+    for (const QLowEnergyServiceData &s : services) {
+        this->services.append(s.uuid());
+        for (const QLowEnergyCharacteristicData &c : s.characteristics()) {
+            characteristic &data = characteristics[c.uuid()];
+            data.service = s.uuid();
+            data.properties = c.properties();
+            data.value = c.value();
+            order.append(c.uuid());
+        }
+    }
+
+    connect(&server, &QTcpServer::newConnection, this, &dirconserver::newConnection);
+    if (server.listen(QHostAddress::Any, port)) {
+        qDebug() << QStringLiteral("dirconserver: listening on port") << port << QStringLiteral("services")
+                 << this->services.count() << QStringLiteral("characteristics") << order.count();
+    } else {
+        qDebug() << QStringLiteral("dirconserver: can't listen on port") << port << server.errorString();
+    }
+}
+
+QByteArray dirconserver::message(quint8 id, quint8 sequence, quint8 response, const QByteArray &payload) {
+    QByteArray m;
+    m.reserve(headerSize + payload.length());
+    m.append((char)0x01);
+    m.append((char)id);
+    m.append((char)sequence);
+    m.append((char)response);
+    m.append((char)((payload.length() >> 8) & 0xFF));
+    m.append((char)(payload.length() & 0xFF));
+    m.append(payload);
+    return m;
+}
+
+quint8 dirconserver::properties(QLowEnergyCharacteristic::PropertyTypes properties) {
+    quint8 p = 0;
+    if (properties & QLowEnergyCharacteristic::Read) {
+        p |= READ;
+    }
+    if (properties & (QLowEnergyCharacteristic::Write | QLowEnergyCharacteristic::WriteNoResponse)) {
+        p |= WRITE;
+    }
+    if (properties & (QLowEnergyCharacteristic::Notify | QLowEnergyCharacteristic::Indicate)) {
+        p |= NOTIFY;
+    }
+    return p;
+}
+
+void dirconserver::newConnection() {
+    while (server.hasPendingConnections()) {
+        QTcpSocket *socket = server.nextPendingConnection();
+        socket->setSocketOption(QAbstractSocket::LowDelayOption, 1);
+        m_clients.insert(socket, client());
+        qDebug() << QStringLiteral("dirconserver: client connected") << socket->peerAddress().toString()
+                 << QStringLiteral("clients") << m_clients.count();
+        connect(socket, &QIODevice::readyRead, this, [this, socket]() { readSocket(socket); });
+        connect(socket, &QAbstractSocket::disconnected, this, [this, socket]() {
+            m_clients.remove(socket);
+            socket->deleteLater();
+            qDebug() << QStringLiteral("dirconserver: client disconnected, clients") << m_clients.count();
+            emit clientsChanged(m_clients.count());
+        });
+        emit clientsChanged(m_clients.count());
+    }
+}
+
+void dirconserver::readSocket(QTcpSocket *socket) {
+    auto c = m_clients.find(socket);
+    if (c == m_clients.end()) {
+        return;
+    }
+    c->buffer.append(socket->readAll());
+
+    // the messages are handled once out of the buffer, handleMessage can write and lose the client
+    QList<QByteArray> messages;
+    while (c->buffer.length() >= headerSize) {
+        int length = qFromBigEndian<quint16>(c->buffer.constData() + 4);
+        if (c->buffer.length() < headerSize + length) {
+            break;
+        }
+        messages.append(c->buffer.left(headerSize + length));
+        c->buffer.remove(0, headerSize + length);
+    }
+    for (const QByteArray &m : qAsConst(messages)) {
+        if (m.at(0) != 0x01) {
+            qDebug() << QStringLiteral("dirconserver: unknown version") << m.toHex(' ');
+        }
+        handleMessage(socket, (quint8)m.at(1), (quint8)m.at(2), m.mid(headerSize));
+    }
+}
+
+void dirconserver::handleMessage(QTcpSocket *socket, quint8 id, quint8 sequence, const QByteArray &payload) {
+    qDebug() << QStringLiteral("dirconserver: <<") << id << sequence << payload.toHex(' ');
+
+    QByteArray reply;
+    quint8 response = SUCCESS;
+    QBluetoothUuid uuid;
+    auto c = characteristics.end();
+    if (id >= DISCOVER_CHARACTERISTICS && id <= ENABLE_NOTIFICATIONS) {
+        if (payload.length() < 16) {
+            socket->write(message(id, sequence, UNEXPECTED_ERROR, QByteArray()));
+            return;
+        }
+        uuid = QBluetoothUuid(QUuid::fromRfc4122(payload.left(16)));
+        c = characteristics.find(uuid);
+        reply = payload.left(16);
+        if (id != DISCOVER_CHARACTERISTICS && c == characteristics.end()) {
+            socket->write(message(id, sequence, CHARACTERISTIC_NOT_FOUND, reply));
+            return;
+        }
+    }
+
+    switch (id) {
+    case DISCOVER_SERVICES:
+        for (const QBluetoothUuid &s : qAsConst(services)) {
+            reply.append(s.toRfc4122());
+        }
+        break;
+    case DISCOVER_CHARACTERISTICS:
+        if (!services.contains(uuid)) {
+            response = SERVICE_NOT_FOUND;
+            break;
+        }
+        for (const QBluetoothUuid &u : qAsConst(order)) {
+            const characteristic &data = characteristics[u];
+            if (data.service == uuid) {
+                reply.append(u.toRfc4122());
+                reply.append((char)properties(data.properties));
+            }
+        }
+        break;
+    case READ_CHARACTERISTIC:
+        if (!(c->properties & QLowEnergyCharacteristic::Read)) {
+            response = OPERATION_NOT_SUPPORTED;
+            break;
+        }
+        reply.append(c->value);
+        break;
+    case WRITE_CHARACTERISTIC:
+        if (!(properties(c->properties) & WRITE)) {
+            response = OPERATION_NOT_SUPPORTED;
+            break;
+        }
+        reply.append(payload.mid(16));
+        break;
+    case ENABLE_NOTIFICATIONS: {
+        if (!(properties(c->properties) & NOTIFY)) {
+            response = OPERATION_NOT_SUPPORTED;
+            break;
+        }
+        auto cl = m_clients.find(socket);
+        if (cl != m_clients.end()) {
+            if (payload.length() > 16 && payload.at(16)) {
+                cl->notifications.insert(uuid);
+            } else {
+                cl->notifications.remove(uuid);
+            }
+        }
+        break;
+    }
+    default:
+        response = UNKNOWN_MESSAGE;
+        reply.clear();
+        break;
+    }
+
+    socket->write(message(id, sequence, response, reply));
+    // after the reply: the indication of a control point comes after the write response as with BLE
+    if (id == WRITE_CHARACTERISTIC && response == SUCCESS) {
+        emit characteristicWritten(uuid, payload.mid(16));
+    }
+}
+
+void dirconserver::notify(const QBluetoothUuid &characteristic, const QByteArray &value) {
+    auto c = characteristics.find(characteristic);
+    if (c == characteristics.end()) {
+        return;
+    }
+    c->value = value;
+
+    QByteArray m;
+    for (auto cl = m_clients.constBegin(); cl != m_clients.constEnd(); ++cl) {
+        if (!cl->notifications.contains(characteristic)) {
+            continue;
+        }
+        if (cl.key()->bytesToWrite() > maxPendingBytes) {
+            qDebug() << QStringLiteral("dirconserver: client too slow, notification dropped");
+            continue;
+        }
+        if (m.isEmpty()) {
+            m = message(NOTIFICATION, 0, SUCCESS, characteristic.toRfc4122() + value);
+        }
+        cl.key()->write(m);
+    }
+}
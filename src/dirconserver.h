@@ -0,0 +1,91 @@
+#ifndef DIRCONSERVER_H
+#define DIRCONSERVER_H
+
+#include <QBluetoothUuid>
+#include <QHash>
+#include <QList>
+#include <QSet>
+#include <QTcpServer>
+#include <QTcpSocket>
+#include <QtBluetooth/qlowenergycharacteristic.h>
+#include <QtBluetooth/qlowenergyservicedata.h>
+
+// The GATT services of a virtual device served over TCP with the Direct Connect protocol (DIRCON) of the trainers on
+// the network. Unlike the BLE peripheral it doesn't need an adapter able to advertise, it takes any number of clients
+// and there's no connection interval to wait for. The port is static and nothing is announced with mDNS: the clients
+// are configured with the address of the machine running the app.
+//
+// Every message has a 6 bytes header followed by the payload, the length is big endian:
+//
+//   version 1 (1) | message id (1) | sequence number (1) | response code (1) | length (2) | payload (length bytes)
+//
+// the uuids are 16 bytes, RFC 4122 order. The client sends 0x01 discover services, 0x02 discover characteristics
+// (payload: the service), 0x03 read, 0x04 write (payload: the characteristic and the value) and 0x05 enable
+// notifications (payload: the characteristic and 1 byte, enabled or not); the server replies with the same message id
+// and sequence number, and sends the notifications and the indications of the characteristics enabled with 0x06.
+class dirconserver : public QObject {
+    Q_OBJECT
+  public:
+    enum MESSAGE {
+        DISCOVER_SERVICES = 0x01,
+        DISCOVER_CHARACTERISTICS = 0x02,
+        READ_CHARACTERISTIC = 0x03,
+        WRITE_CHARACTERISTIC = 0x04,
+        ENABLE_NOTIFICATIONS = 0x05,
+        NOTIFICATION = 0x06
+    };
+    enum RESPONSE {
+        SUCCESS = 0x00,
+        UNKNOWN_MESSAGE = 0x01,
+        UNEXPECTED_ERROR = 0x02,
+        SERVICE_NOT_FOUND = 0x03,
+        CHARACTERISTIC_NOT_FOUND = 0x04,
+        OPERATION_NOT_SUPPORTED = 0x05
+    };
+    // properties of the characteristics in the discovery, the indications are notifications
+    enum PROPERTY { READ = 0x01, WRITE = 0x02, NOTIFY = 0x04 };
+    static const int headerSize = 6;
+    static const quint16 defaultPort = 36866;
+    // a client that doesn't read its socket loses the notifications over this, not the replies
+    static const qint64 maxPendingBytes = 64 * 1024;
+
+    dirconserver(const QList<QLowEnergyServiceData> &services, quint16 port, QObject *parent = nullptr);
+    bool listening() const { return server.isListening(); }
+    int clients() const { return m_clients.count(); }
+    // to the clients that enabled the notifications of the characteristic, it's also the value of the next reads
+    void notify(const QBluetoothUuid &characteristic, const QByteArray &value);
+
+    static QByteArray message(quint8 id, quint8 sequence, quint8 response, const QByteArray &payload);
+
+  signals:
+    // a client wrote the characteristic, as QLowEnergyService::characteristicChanged does for the BLE peripheral
+    void characteristicWritten(const QBluetoothUuid &characteristic, const QByteArray &value);
+    void clientsChanged(int clients);
+
+  private:
+    struct characteristic {
+        QBluetoothUuid service;
+        QLowEnergyCharacteristic::PropertyTypes properties;
+        QByteArray value;
+    };
+    struct client {
+        QByteArray buffer;
+        QSet<QBluetoothUuid> notifications;
+    };
+
+    void readSocket(QTcpSocket *socket);
+    void handleMessage(QTcpSocket *socket, quint8 id, quint8 sequence, const QByteArray &payload);
+    static quint8 properties(QLowEnergyCharacteristic::PropertyTypes properties);
+
+    QTcpServer server;
+    QList<QBluetoothUuid> services;
+    // the characteristics in the order of the service data, the discovery keeps it
+    QList<QBluetoothUuid> order;
+    QHash<QBluetoothUuid, characteristic> characteristics;
+    QHash<QTcpSocket *, client> m_clients;
+
+  private slots:
+    void newConnection();
+};
+
+#endif // DIRCONSERVER_H
@@ -12,6 +12,9 @@
 
 using namespace std::chrono_literals;
 
+const QList<fragmentassembler::message> domyosbike::fragmentMessages = {
+    {QByteArray("\xf0\xbc", 2), 26}, {QByteArray("\xf0\xdb", 2), 27}, {QByteArray("\xf0\xdd", 2), 27}};
+
 domyosbike::domyosbike(bool noWriteResistance, bool noHeartService, bool testResistance, uint8_t bikeResistanceOffset,
                        double bikeResistanceGain) {
     m_watt.setType(metric::METRIC_WATT);
@@ -55,6 +58,7 @@ void domyosbike::writeCharacteristic(uint8_t *data, uint8_t data_len, const QStr
         return;
     }
 
+    writeRequested(QByteArray((const char *)data, data_len));
     gattCommunicationChannelService->writeCharacteristic(gattWriteCharacteristic,
                                                          QByteArray((const char *)data, data_len));
 
@@ -89,9 +93,7 @@ void domyosbike::updateDisplay(uint16_t elapsed) {
         display2[3] = ((((uint16_t)(odometer() * 10))) >> 8) & 0xFF;
         display2[4] = (((uint16_t)(odometer() * 10))) & 0xFF;
 
-        for (uint8_t i = 0; i < sizeof(display2) - 1; i++) {
-            display2[26] += display2[i]; // the last byte is a sort of a checksum
-        }
+        sum8checksum<>::seal(display2, sizeof(display2));
 
         writeCharacteristic(display2, 20, QStringLiteral("updateDisplay2"), false, false);
         writeCharacteristic(&display2[20], sizeof(display2) - 20, QStringLiteral("updateDisplay2"), false, true);
@@ -135,9 +137,7 @@ void domyosbike::updateDisplay(uint16_t elapsed) {
     display[19] = ((((uint16_t)calories().value()) * multiplier) >> 8) & 0xFF;
     display[20] = (((uint16_t)calories().value()) * multiplier) & 0xFF;
 
-    for (uint8_t i = 0; i < sizeof(display) - 1; i++) {
-        display[26] += display[i]; // the last byte is a sort of a checksum
-    }
+    sum8checksum<>::seal(display, sizeof(display));
 
     writeCharacteristic(display, 20, QStringLiteral("updateDisplay elapsed=") + QString::number(elapsed), false, false);
     writeCharacteristic(&display[20], sizeof(display) - 20,
@@ -150,9 +150,7 @@ void domyosbike::forceResistance(int8_t requestResistance) {
 
     write[10] = requestResistance;
 
-    for (uint8_t i = 0; i < sizeof(write) - 1; i++) {
-        write[22] += write[i]; // the last byte is a sort of a checksum
-    }
+    sum8checksum<>::seal(write, sizeof(write));
 
     writeCharacteristic(write, 20, QStringLiteral("forceResistance ") + QString::number(requestResistance));
     writeCharacteristic(&write[20], sizeof(write) - 20,
@@ -216,16 +214,16 @@ void domyosbike::update() {
         // updating the treadmill console every second
         if (sec1Update++ == (1000 / refresh->interval())) {
             sec1Update = 0;
-            if (incompletePackets == false) {
+            if (!fragments.pending()) {
                 updateDisplay(elapsed.value());
             }
         } else {
-            if (incompletePackets == false) {
+            if (!fragments.pending()) {
                 writeCharacteristic(noOpData, sizeof(noOpData), QStringLiteral("noOp"), true, true);
             }
         }
 
-        if (incompletePackets == false) {
+        if (!fragments.pending()) {
             if (testResistance) {
                 if ((((int)elapsed.value()) % 5) == 0) {
                     uint8_t new_res = currentResistance().value() + 1;
@@ -245,6 +243,7 @@ void domyosbike::update() {
 
                 if (requestResistance != currentResistance().value()) {
                     qDebug() << QStringLiteral("writing resistance ") + QString::number(requestResistance);
+                    requestQueued();
                     forceResistance(requestResistance);
                 }
                 requestResistance = -1;
@@ -295,38 +294,16 @@ void domyosbike::characteristicChanged(const QLowEnergyCharacteristic &character
         emit packetReceived();
     }
 
-    QByteArray startBytes;
-    startBytes.append(0xf0);
-    startBytes.append(0xbc);
-
-    QByteArray startBytes2;
-    startBytes2.append(0xf0);
-    startBytes2.append(0xdb);
-
-    QByteArray startBytes3;
-    startBytes3.append(0xf0);
-    startBytes3.append(0xdd);
-
-    // on some treadmills, the 26bytes has splitted in 2 packets
-    if ((lastPacket.length() == 20 && lastPacket.startsWith(startBytes) && value.length() == 6) ||
-        (lastPacket.length() == 20 && lastPacket.startsWith(startBytes2) && value.length() == 7) ||
-        (lastPacket.length() == 20 && lastPacket.startsWith(startBytes3) && value.length() == 7)) {
-        incompletePackets = false;
+    if (!fragments.feed(newValue, value)) {
+        // semaphore for any writing packets (for example, update display)
+        qDebug() << QStringLiteral("waiting for other bytes...");
+        return;
+    }
+    if (value.length() != newValue.length()) {
         qDebug() << QStringLiteral("...final bytes received");
-        lastPacket.append(value);
-        value = lastPacket;
     }
 
-    lastPacket = value;
-
     if (value.length() != 26) {
-        // semaphore for any writing packets (for example, update display)
-        if (value.length() == 20 &&
-            (value.startsWith(startBytes) || value.startsWith(startBytes2) || value.startsWith(startBytes3))) {
-            qDebug() << QStringLiteral("waiting for other bytes...");
-            incompletePackets = true;
-        }
-
         qDebug() << QStringLiteral("packet ignored");
         return;
     }
@@ -420,7 +397,7 @@ void domyosbike::characteristicChanged(const QLowEnergyCharacteristic &character
     qDebug() << QStringLiteral("Last CrankEventTime: ") + QString::number(LastCrankEventTime);
     qDebug() << QStringLiteral("Current Watt: ") + QString::number(watts());
 
-    if (m_control->error() != QLowEnergyController::NoError) {
+    if (m_control && m_control->error() != QLowEnergyController::NoError) {
         qDebug() << "QLowEnergyController ERROR!!" << m_control->errorString();
     }
 
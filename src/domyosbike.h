@@ -27,6 +27,7 @@
 #include <QString>
 
 #include "bike.h"
+#include "framing.h"
 #include "virtualbike.h"
 
 #ifdef Q_OS_IOS
@@ -47,6 +48,9 @@ class domyosbike : public bike {
     void *VirtualBike();
     void *VirtualDevice();
 
+    // the 26/27 bytes status messages are split in a 20 bytes notification and the rest on some models
+    static const QList<fragmentassembler::message> fragmentMessages;
+
   private:
     double GetSpeedFromPacket(const QByteArray &packet);
     double GetInclinationFromPacket(QByteArray packet);
@@ -72,7 +76,7 @@ class domyosbike : public bike {
     QLowEnergyCharacteristic gattWriteCharacteristic;
     QLowEnergyCharacteristic gattNotifyCharacteristic;
 
-    volatile bool incompletePackets = false;
+    fragmentassembler fragments = fragmentassembler(20, fragmentMessages);
     bool initDone = false;
     bool initRequest = false;
     bool noWriteResistance = false;
@@ -82,7 +86,6 @@ class domyosbike : public bike {
     double bikeResistanceGain = 1.0;
     bool searchStopped = false;
     uint8_t sec1Update = 0;
-    QByteArray lastPacket;
     QDateTime lastRefreshCharacteristicChanged = QDateTime::currentDateTime();
 
     enum _BIKE_TYPE {
@@ -1,4 +1,5 @@
 #include "domyoselliptical.h"
+#include "logging.h"
 
 #include "keepawakehelper.h"
 #include "virtualtreadmill.h"
@@ -53,14 +54,14 @@ void domyoselliptical::writeCharacteristic(uint8_t *data, uint8_t data_len, cons
                                                          QByteArray((const char *)data, data_len));
 
     if (!disable_log) {
-        emit debug(QStringLiteral(" >> ") + QByteArray((const char *)data, data_len).toHex(' ') +
+        LOG_PACKET(QStringLiteral(" >> ") + QByteArray((const char *)data, data_len).toHex(' ') +
                    QStringLiteral(" // ") + info);
     }
 
     loop.exec();
 
     if (timeout.isActive() == false) {
-        emit debug(QStringLiteral(" exit for timeout"));
+        LOG_DEVICE(QStringLiteral(" exit for timeout"));
     }
 }
 
@@ -209,7 +210,7 @@ void domyoselliptical::update() {
             }
 
             if (requestResistance != currentResistance().value()) {
-                emit debug(QStringLiteral("writing resistance ") + QString::number(requestResistance));
+                LOG_DEVICE(QStringLiteral("writing resistance ") + QString::number(requestResistance));
 
                 forceResistance(requestResistance);
             }
@@ -222,14 +223,14 @@ void domyoselliptical::update() {
             }
 
             if (requestInclination != currentInclination().value()) {
-                emit debug(QStringLiteral("writing inclination ") + QString::number(requestInclination));
+                LOG_DEVICE(QStringLiteral("writing inclination ") + QString::number(requestInclination));
 
                 forceInclination(requestInclination);
             }
             requestInclination = -1;
         }
         if (requestStart != -1) {
-            emit debug(QStringLiteral("starting..."));
+            LOG_DEVICE(QStringLiteral("starting..."));
 
             // if(bike_type == CHANG_YOW)
             btinit_changyow(true);
@@ -240,7 +241,7 @@ void domyoselliptical::update() {
             emit bikeStarted();
         }
         if (requestStop != -1) {
-            emit debug(QStringLiteral("stopping..."));
+            LOG_DEVICE(QStringLiteral("stopping..."));
             writeCharacteristic(initDataF0C800B8, sizeof(initDataF0C800B8), QStringLiteral("stop tape"));
 
             requestStop = -1;
@@ -255,7 +256,7 @@ void domyoselliptical::changeInclinationRequested(double grade, double percentag
 }
 
 void domyoselliptical::serviceDiscovered(const QBluetoothUuid &gatt) {
-    emit debug(QStringLiteral("serviceDiscovered ") + gatt.toString());
+    LOG_DEVICE(QStringLiteral("serviceDiscovered ") + gatt.toString());
 }
 
 void domyoselliptical::characteristicChanged(const QLowEnergyCharacteristic &characteristic,
@@ -266,7 +267,7 @@ void domyoselliptical::characteristicChanged(const QLowEnergyCharacteristic &cha
     QString heartRateBeltName =
         settings.value(QStringLiteral("heart_rate_belt_name"), QStringLiteral("Disabled")).toString();
 
-    emit debug(QStringLiteral(" << ") + newValue.toHex(' '));
+    LOG_PACKET(QStringLiteral(" << ") + newValue.toHex(' '));
 
     lastPacket = newValue;
     if (newValue.length() != 26) {
@@ -274,11 +275,11 @@ void domyoselliptical::characteristicChanged(const QLowEnergyCharacteristic &cha
     }
 
     if (newValue.at(22) == 0x06) {
-        emit debug(QStringLiteral("inclination up button pressed!"));
+        LOG_DEVICE(QStringLiteral("inclination up button pressed!"));
 
         // requestStart = 1;
     } else if (newValue.at(22) == 0x07) {
-        emit debug(QStringLiteral("inclination down button pressed!")); // i guess it should be the inclination down
+        LOG_DEVICE(QStringLiteral("inclination down button pressed!")); // i guess it should be the inclination down
 
         // requestStop = 1;
     }
@@ -300,12 +301,12 @@ void domyoselliptical::characteristicChanged(const QLowEnergyCharacteristic &cha
     Resistance = newValue.at(14);
     Inclination = newValue.at(21);
     if (Resistance.value() < 1) {
-        emit debug(QStringLiteral("invalid resistance value ") + QString::number(Resistance.value()) +
+        LOG_DEVICE(QStringLiteral("invalid resistance value ") + QString::number(Resistance.value()) +
                    QStringLiteral(" putting to default"));
         Resistance = 1;
     }
     if (Inclination.value() < 0 || Inclination.value() > 15) {
-        emit debug(QStringLiteral("invalid inclination value ") + QString::number(Inclination.value()) +
+        LOG_DEVICE(QStringLiteral("invalid inclination value ") + QString::number(Inclination.value()) +
                    QStringLiteral(" putting to default"));
         Inclination.setValue(0);
     }
@@ -324,16 +325,16 @@ void domyoselliptical::characteristicChanged(const QLowEnergyCharacteristic &cha
     CrankRevs++;
     LastCrankEventTime += (uint16_t)(1024.0 / (((double)(Cadence.value())) / 60.0));
 
-    emit debug(QStringLiteral("Current speed: ") + QString::number(speed));
-    emit debug(QStringLiteral("Current cadence: ") + QString::number(Cadence.value()));
-    emit debug(QStringLiteral("Current resistance: ") + QString::number(Resistance.value()));
-    emit debug(QStringLiteral("Current inclination: ") + QString::number(Inclination.value()));
-    emit debug(QStringLiteral("Current heart: ") + QString::number(Heart.value()));
-    emit debug(QStringLiteral("Current KCal: ") + QString::number(kcal));
-    emit debug(QStringLiteral("Current Distance: ") + QString::number(distance));
-    emit debug(QStringLiteral("Current CrankRevs: ") + QString::number(CrankRevs));
-    emit debug(QStringLiteral("Last CrankEventTime: ") + QString::number(LastCrankEventTime));
-    emit debug(QStringLiteral("Current Watt: ") + QString::number(watts()));
+    LOG_DEVICE(QStringLiteral("Current speed: ") + QString::number(speed));
+    LOG_DEVICE(QStringLiteral("Current cadence: ") + QString::number(Cadence.value()));
+    LOG_DEVICE(QStringLiteral("Current resistance: ") + QString::number(Resistance.value()));
+    LOG_DEVICE(QStringLiteral("Current inclination: ") + QString::number(Inclination.value()));
+    LOG_DEVICE(QStringLiteral("Current heart: ") + QString::number(Heart.value()));
+    LOG_DEVICE(QStringLiteral("Current KCal: ") + QString::number(kcal));
+    LOG_DEVICE(QStringLiteral("Current Distance: ") + QString::number(distance));
+    LOG_DEVICE(QStringLiteral("Current CrankRevs: ") + QString::number(CrankRevs));
+    LOG_DEVICE(QStringLiteral("Last CrankEventTime: ") + QString::number(LastCrankEventTime));
+    LOG_DEVICE(QStringLiteral("Current Watt: ") + QString::number(watts()));
 
     if (m_control->error() != QLowEnergyController::NoError) {
         qDebug() << QStringLiteral("QLowEnergyController ERROR!!") << m_control->errorString();
@@ -442,7 +443,7 @@ void domyoselliptical::stateChanged(QLowEnergyService::ServiceState state) {
     QBluetoothUuid _gattNotifyCharacteristicId(QStringLiteral("49535343-1e4d-4bd9-ba61-23c647249616"));
 
     QMetaEnum metaEnum = QMetaEnum::fromType<QLowEnergyService::ServiceState>();
-    emit debug(QStringLiteral("BTLE stateChanged ") + QString::fromLocal8Bit(metaEnum.valueToKey(state)));
+    LOG_DEVICE(QStringLiteral("BTLE stateChanged ") + QString::fromLocal8Bit(metaEnum.valueToKey(state)));
 
     if (state == QLowEnergyService::ServiceDiscovered) {
 
@@ -475,7 +476,7 @@ void domyoselliptical::stateChanged(QLowEnergyService::ServiceState state) {
 void domyoselliptical::searchingStop() { searchStopped = true; }
 
 void domyoselliptical::descriptorWritten(const QLowEnergyDescriptor &descriptor, const QByteArray &newValue) {
-    emit debug(QStringLiteral("descriptorWritten ") + descriptor.name() + QStringLiteral(" ") + newValue.toHex(' '));
+    LOG_PACKET(QStringLiteral("descriptorWritten ") + descriptor.name() + QStringLiteral(" ") + newValue.toHex(' '));
 
     initRequest = true;
     emit connectedAndDiscovered();
@@ -484,11 +485,11 @@ void domyoselliptical::descriptorWritten(const QLowEnergyDescriptor &descriptor,
 void domyoselliptical::characteristicWritten(const QLowEnergyCharacteristic &characteristic,
                                              const QByteArray &newValue) {
     Q_UNUSED(characteristic);
-    emit debug(QStringLiteral("characteristicWritten ") + newValue.toHex(' '));
+    LOG_PACKET(QStringLiteral("characteristicWritten ") + newValue.toHex(' '));
 }
 
 void domyoselliptical::serviceScanDone(void) {
-    emit debug(QStringLiteral("serviceScanDone"));
+    LOG_DEVICE(QStringLiteral("serviceScanDone"));
 
     QBluetoothUuid _gattCommunicationChannelServiceId(QStringLiteral("49535343-fe7d-4ae5-8fa9-9fafd205e455"));
 
@@ -500,30 +501,30 @@ void domyoselliptical::serviceScanDone(void) {
 void domyoselliptical::errorService(QLowEnergyService::ServiceError err) {
 
     QMetaEnum metaEnum = QMetaEnum::fromType<QLowEnergyService::ServiceError>();
-    emit debug(QStringLiteral("domyoselliptical::errorService") + QString::fromLocal8Bit(metaEnum.valueToKey(err)) +
+    LOG_DEVICE(QStringLiteral("domyoselliptical::errorService") + QString::fromLocal8Bit(metaEnum.valueToKey(err)) +
                m_control->errorString());
 }
 
 void domyoselliptical::error(QLowEnergyController::Error err) {
 
     QMetaEnum metaEnum = QMetaEnum::fromType<QLowEnergyController::Error>();
-    emit debug(QStringLiteral("domyoselliptical::error") + QString::fromLocal8Bit(metaEnum.valueToKey(err)) +
+    LOG_DEVICE(QStringLiteral("domyoselliptical::error") + QString::fromLocal8Bit(metaEnum.valueToKey(err)) +
                m_control->errorString());
 }
 
 void domyoselliptical::deviceDiscovered(const QBluetoothDeviceInfo &device) {
-    emit debug(QStringLiteral("Found new device: ") + device.name() + QStringLiteral(" (") +
+    LOG_DEVICE(QStringLiteral("Found new device: ") + device.name() + QStringLiteral(" (") +
                device.address().toString() + ')');
     if (device.name().startsWith(QStringLiteral("Domyos-EL")) &&
         !device.name().startsWith(QStringLiteral("DomyosBridge"))) {
         bluetoothDevice = device;
 
         if (device.address().toString().startsWith(QStringLiteral("57"))) {
-            emit debug(QStringLiteral("domyos telink bike found"));
+            LOG_DEVICE(QStringLiteral("domyos telink bike found"));
 
             bike_type = TELINK;
         } else {
-            emit debug(QStringLiteral("domyos changyow bike found"));
+            LOG_DEVICE(QStringLiteral("domyos changyow bike found"));
 
             bike_type = CHANG_YOW;
         }
@@ -541,18 +542,18 @@ void domyoselliptical::deviceDiscovered(const QBluetoothDeviceInfo &device) {
                 this, [this](QLowEnergyController::Error error) {
                     Q_UNUSED(error);
                     Q_UNUSED(this);
-                    emit debug(QStringLiteral("Cannot connect to remote device."));
+                    LOG_DEVICE(QStringLiteral("Cannot connect to remote device."));
                     searchStopped = false;
                     emit disconnected();
                 });
         connect(m_control, &QLowEnergyController::connected, this, [this]() {
             Q_UNUSED(this);
-            emit debug(QStringLiteral("Controller connected. Search services..."));
+            LOG_DEVICE(QStringLiteral("Controller connected. Search services..."));
             m_control->discoverServices();
         });
         connect(m_control, &QLowEnergyController::disconnected, this, [this]() {
             Q_UNUSED(this);
-            emit debug(QStringLiteral("LowEnergy controller disconnected"));
+            LOG_DEVICE(QStringLiteral("LowEnergy controller disconnected"));
             searchStopped = false;
             emit disconnected();
         });
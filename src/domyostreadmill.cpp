@@ -1,4 +1,5 @@
 #include "domyostreadmill.h"
+#include "logging.h"
 #include "ios/lockscreen.h"
 #include "keepawakehelper.h"
 #include "virtualtreadmill.h"
@@ -11,6 +12,9 @@
 
 using namespace std::chrono_literals;
 
+const QList<fragmentassembler::message> domyostreadmill::fragmentMessages = {{QByteArray("\xf0\xbc", 2), 26},
+                                                                            {QByteArray("\xf0\xdb", 2), 27}};
+
 // set speed and incline to 0
 uint8_t initData1[] = {0xf0, 0xc8, 0x01, 0xb9};
 uint8_t initData2[] = {0xf0, 0xc9, 0xb9};
@@ -77,29 +81,28 @@ void domyostreadmill::writeCharacteristic(uint8_t *data, uint8_t data_len, const
         connect(this, &domyostreadmill::packetReceived, &loop, &QEventLoop::quit);
         timeout.singleShot(300ms, &loop, &QEventLoop::quit);
     } else {
-        connect(gattCommunicationChannelService, &QLowEnergyService::characteristicWritten, &loop, &QEventLoop::quit);
+        connect(transport, &bluetoothtransport::characteristicWritten, &loop, &QEventLoop::quit);
         timeout.singleShot(300ms, &loop, &QEventLoop::quit);
     }
 
-    if (gattCommunicationChannelService->state() != QLowEnergyService::ServiceState::ServiceDiscovered ||
-        m_control->state() == QLowEnergyController::UnconnectedState) {
-        emit debug(QStringLiteral("writeCharacteristic error because the connection is closed"));
+    if (transport->state() != QLowEnergyController::DiscoveredState || gattWriteCharacteristic.isNull()) {
+        LOG_DEVICE(QStringLiteral("writeCharacteristic error because the connection is closed"));
 
         return;
     }
 
-    gattCommunicationChannelService->writeCharacteristic(gattWriteCharacteristic,
-                                                         QByteArray((const char *)data, data_len));
+    writeRequested(QByteArray((const char *)data, data_len));
+    transport->writeCharacteristic(gattWriteCharacteristic, QByteArray((const char *)data, data_len));
 
     if (!disable_log) {
-        emit debug(QStringLiteral(" >> ") + QByteArray((const char *)data, data_len).toHex(' ') +
+        LOG_PACKET(QStringLiteral(" >> ") + QByteArray((const char *)data, data_len).toHex(' ') +
                    QStringLiteral(" // ") + info);
     }
 
     loop.exec();
 
     if (timeout.isActive() == false) {
-        emit debug(QStringLiteral(" exit for timeout"));
+        LOG_DEVICE(QStringLiteral(" exit for timeout"));
     }
 }
 
@@ -165,10 +168,7 @@ void domyostreadmill::updateDisplay(uint16_t elapsed) {
         display[24] = (uint8_t)(odometer() * 10) & 0xFF;
     }
 
-    for (uint8_t i = 0; i < sizeof(display) - 1; i++) {
-
-        display[26] += display[i]; // the last byte is a sort of a checksum
-    }
+    sum8checksum<>::seal(display, sizeof(display));
 
     writeCharacteristic(display, 20, QStringLiteral("updateDisplay elapsed=") + QString::number(elapsed), false, false);
     writeCharacteristic(&display[20], sizeof(display) - 20,
@@ -185,11 +185,7 @@ void domyostreadmill::forceSpeedOrIncline(double requestSpeed, double requestInc
     writeIncline[13] = ((uint16_t)(requestIncline * 10) >> 8) & 0xFF;
     writeIncline[14] = ((uint16_t)(requestIncline * 10) & 0xFF);
 
-    for (uint8_t i = 0; i < sizeof(writeIncline) - 1; i++) {
-
-        // qDebug() << QString::number(writeIncline[i], 16);
-        writeIncline[22] += writeIncline[i]; // the last byte is a sort of a checksum
-    }
+    sum8checksum<>::seal(writeIncline, sizeof(writeIncline));
 
     // qDebug() << "writeIncline crc" << QString::number(writeIncline[26], 16);
 
@@ -213,10 +209,7 @@ bool domyostreadmill::sendChangeFanSpeed(uint8_t speed) {
 
     fanSpeed[2] = speed;
 
-    for (uint8_t i = 0; i < sizeof(fanSpeed) - 1; i++) {
-
-        fanSpeed[3] += fanSpeed[i]; // the last byte is a sort of a checksum
-    }
+    sum8checksum<>::seal(fanSpeed, sizeof(fanSpeed));
 
     writeCharacteristic(fanSpeed, 4, QStringLiteral("changeFanSpeed speed=") + QString::number(speed), false, true);
 
@@ -237,7 +230,7 @@ void domyostreadmill::changeInclinationRequested(double grade, double percentage
 }
 
 void domyostreadmill::update() {
-    if (m_control->state() == QLowEnergyController::UnconnectedState) {
+    if (transport->state() == QLowEnergyController::UnconnectedState) {
         emit disconnected();
         return;
     }
@@ -247,8 +240,8 @@ void domyostreadmill::update() {
         initRequest = false;
         btinit((lastSpeed > 0 ? true : false));
     } else if (/*bluetoothDevice.isValid() &&*/
-               m_control->state() == QLowEnergyController::DiscoveredState && gattCommunicationChannelService &&
-               gattWriteCharacteristic.isValid() && gattNotifyCharacteristic.isValid() && initDone) {
+               transport->state() == QLowEnergyController::DiscoveredState && !gattWriteCharacteristic.isNull() &&
+               !gattNotifyCharacteristic.isNull() && initDone) {
 
         QSettings settings;
         // ******************************************* virtual treadmill init *************************************
@@ -279,23 +272,23 @@ void domyostreadmill::update() {
 
         // updating the treadmill console every second
         if (sec1Update++ >= (1000 / refresh->interval())) {
-            if (incompletePackets == false && noConsole == false) {
+            if (!fragments.pending() && noConsole == false) {
 
                 sec1Update = 0;
                 updateDisplay(elapsed.value());
             }
         } else {
-            if (incompletePackets == false) {
+            if (!fragments.pending()) {
                 writeCharacteristic(noOpData, sizeof(noOpData), QStringLiteral("noOp"), false, true);
             }
         }
 
         // byte 3 - 4 = elapsed time
         // byte 17    = inclination
-        if (incompletePackets == false) {
+        if (!fragments.pending()) {
             if (requestSpeed != -1) {
                 if (requestSpeed != currentSpeed().value() && requestSpeed >= 0 && requestSpeed <= 22) {
-                    emit debug(QStringLiteral("writing speed ") + QString::number(requestSpeed));
+                    LOG_DEVICE(QStringLiteral("writing speed ") + QString::number(requestSpeed));
 
                     double inc = Inclination.value();
                     if (requestInclination != -1) {
@@ -305,6 +298,7 @@ void domyostreadmill::update() {
                         inc = requestInclination;
                         requestInclination = -1;
                     }
+                    requestQueued();
                     forceSpeedOrIncline(requestSpeed, inc);
                 }
                 requestSpeed = -1;
@@ -314,7 +308,7 @@ void domyostreadmill::update() {
                 requestInclination = qRound(requestInclination * 2.0) / 2.0;
                 if (requestInclination != currentInclination().value() && requestInclination >= 0 &&
                     requestInclination <= 15) {
-                    emit debug(QStringLiteral("writing incline ") + QString::number(requestInclination));
+                    LOG_DEVICE(QStringLiteral("writing incline ") + QString::number(requestInclination));
 
                     double speed = currentSpeed().value();
                     if (requestSpeed != -1) {
@@ -322,12 +316,13 @@ void domyostreadmill::update() {
                         speed = requestSpeed;
                         requestSpeed = -1;
                     }
+                    requestQueued();
                     forceSpeedOrIncline(speed, requestInclination);
                 }
                 requestInclination = -1;
             }
             if (requestStart != -1) {
-                emit debug(QStringLiteral("starting..."));
+                LOG_DEVICE(QStringLiteral("starting..."));
                 if (lastSpeed == 0.0) {
 
                     lastSpeed = 0.5;
@@ -337,24 +332,24 @@ void domyostreadmill::update() {
                 emit tapeStarted();
             }
             if (requestStop != -1) {
-                emit debug(QStringLiteral("stopping..."));
+                LOG_DEVICE(QStringLiteral("stopping..."));
                 writeCharacteristic(initDataF0C800B8, sizeof(initDataF0C800B8), QStringLiteral("stop tape"), false,
                                     true);
                 requestStop = -1;
             }
             if (requestFanSpeed != -1) {
-                emit debug(QStringLiteral("changing fan speed..."));
+                LOG_DEVICE(QStringLiteral("changing fan speed..."));
 
                 sendChangeFanSpeed(requestFanSpeed);
                 requestFanSpeed = -1;
             }
             if (requestIncreaseFan != -1) {
-                emit debug(QStringLiteral("increasing fan speed..."));
+                LOG_DEVICE(QStringLiteral("increasing fan speed..."));
 
                 sendChangeFanSpeed(FanSpeed + 1);
                 requestIncreaseFan = -1;
             } else if (requestDecreaseFan != -1) {
-                emit debug(QStringLiteral("decreasing fan speed..."));
+                LOG_DEVICE(QStringLiteral("decreasing fan speed..."));
 
                 sendChangeFanSpeed(FanSpeed - 1);
                 requestDecreaseFan = -1;
@@ -363,13 +358,8 @@ void domyostreadmill::update() {
     }
 }
 
-void domyostreadmill::serviceDiscovered(const QBluetoothUuid &gatt) {
-    emit debug(QStringLiteral("serviceDiscovered ") + gatt.toString());
-}
-
-void domyostreadmill::characteristicChanged(const QLowEnergyCharacteristic &characteristic,
-                                            const QByteArray &newValue) {
-    // qDebug() << "characteristicChanged" << characteristic.uuid() << newValue << newValue.length();
+void domyostreadmill::characteristicChanged(const QBluetoothUuid &characteristic, const QByteArray &newValue) {
+    // qDebug() << "characteristicChanged" << characteristic << newValue << newValue.length();
     QSettings settings;
     QString heartRateBeltName =
         settings.value(QStringLiteral("heart_rate_belt_name"), QStringLiteral("Disabled")).toString();
@@ -377,7 +367,7 @@ void domyostreadmill::characteristicChanged(const QLowEnergyCharacteristic &char
     Q_UNUSED(characteristic);
     QByteArray value = newValue;
 
-    emit debug(QStringLiteral(" << ") + QString::number(value.length()) + QStringLiteral(" ") + value.toHex(' '));
+    LOG_PACKET(QStringLiteral(" << ") + QString::number(value.length()) + QStringLiteral(" ") + value.toHex(' '));
 
     // for the init packets, the lenght is always less than 20
     // for the display and status packets, the lenght is always grater then 20 and there are 2 cases:
@@ -387,128 +377,109 @@ void domyostreadmill::characteristicChanged(const QLowEnergyCharacteristic &char
     //         and the second one with the remained byte
     // so this simply condition will match all the cases, excluding the 20byte packet of the T900.
     if (newValue.length() != 20) {
-        emit debug(QStringLiteral("packetReceived!"));
+        LOG_DEVICE(QStringLiteral("packetReceived!"));
 
         emit packetReceived();
     }
 
-    QByteArray startBytes;
-    startBytes.append(0xf0);
-    startBytes.append(0xbc);
-
-    QByteArray startBytes2;
-    startBytes2.append(0xf0);
-    startBytes2.append(0xdb);
-
-    // on some treadmills, the 26bytes has splitted in 2 packets
-    if ((lastPacket.length() == 20 && lastPacket.startsWith(startBytes) && value.length() == 6) ||
-        (lastPacket.length() == 20 && lastPacket.startsWith(startBytes2) && value.length() == 7)) {
-
-        incompletePackets = false;
-        emit debug(QStringLiteral("...final bytes received"));
-        lastPacket.append(value);
-        value = lastPacket;
+    if (!fragments.feed(newValue, value)) {
+        // semaphore for any writing packets (for example, update display)
+        LOG_DEVICE(QStringLiteral("waiting for other bytes..."));
+        return;
+    }
+    if (value.length() != newValue.length()) {
+        LOG_DEVICE(QStringLiteral("...final bytes received"));
     }
-
-    lastPacket = value;
 
     if (value.length() != 26) {
-
-        // semaphore for any writing packets (for example, update display)
-        if (value.length() == 20 && (value.startsWith(startBytes) || value.startsWith(startBytes2))) {
-            emit debug(QStringLiteral("waiting for other bytes..."));
-
-            incompletePackets = true;
-        }
-
-        emit debug(QStringLiteral("packet ignored"));
+        LOG_DEVICE(QStringLiteral("packet ignored"));
         return;
     }
 
     if (value.at(22) == 0x06) {
-        emit debug(QStringLiteral("start button pressed!"));
+        LOG_DEVICE(QStringLiteral("start button pressed!"));
 
         requestStart = 1;
     } else if (value.at(22) == 0x07) {
-        emit debug(QStringLiteral("stop button pressed!"));
+        LOG_DEVICE(QStringLiteral("stop button pressed!"));
 
         requestStop = 1;
     } else if (value.at(22) == 0x0b) {
-        emit debug(QStringLiteral("increase speed fan pressed!"));
+        LOG_DEVICE(QStringLiteral("increase speed fan pressed!"));
 
         requestIncreaseFan = 1;
     } else if (value.at(22) == 0x0a) {
-        emit debug(QStringLiteral("decrease speed fan pressed!"));
+        LOG_DEVICE(QStringLiteral("decrease speed fan pressed!"));
 
         requestDecreaseFan = 1;
     } else if (value.at(22) == 0x08) {
-        emit debug(QStringLiteral("increase speed button on console pressed!"));
+        LOG_DEVICE(QStringLiteral("increase speed button on console pressed!"));
         if (domyos_treadmill_buttons) {
 
             changeSpeed(currentSpeed().value() + 0.2);
         }
     } else if (value.at(22) == 0x09) {
-        emit debug(QStringLiteral("decrease speed button on console pressed!"));
+        LOG_DEVICE(QStringLiteral("decrease speed button on console pressed!"));
         if (domyos_treadmill_buttons) {
 
             changeSpeed(currentSpeed().value() - 0.2);
         }
     } else if (value.at(22) == 0x0c) {
-        emit debug(QStringLiteral("increase inclination button on console pressed!"));
+        LOG_DEVICE(QStringLiteral("increase inclination button on console pressed!"));
         if (domyos_treadmill_buttons) {
 
             changeInclination(currentInclination().value() + 0.5, currentInclination().value() + 0.5);
         }
     } else if (value.at(22) == 0x0d) {
-        emit debug(QStringLiteral("decrease inclination button on console pressed!"));
+        LOG_DEVICE(QStringLiteral("decrease inclination button on console pressed!"));
         if (domyos_treadmill_buttons) {
 
             changeInclination(currentInclination().value() - 0.5, currentInclination().value() - 0.5);
         }
     } else if (value.at(22) == 0x11) {
-        emit debug(QStringLiteral("22km/h speed button pressed!"));
+        LOG_DEVICE(QStringLiteral("22km/h speed button pressed!"));
         if (domyos_treadmill_buttons) {
 
             changeSpeed(22.0);
         }
     } else if (value.at(22) == 0x10) {
-        emit debug(QStringLiteral("16km/h speed button pressed!"));
+        LOG_DEVICE(QStringLiteral("16km/h speed button pressed!"));
         if (domyos_treadmill_buttons) {
 
             changeSpeed(16.0);
         }
     } else if (value.at(22) == 0x0f) {
-        emit debug(QStringLiteral("10km/h speed button pressed!"));
+        LOG_DEVICE(QStringLiteral("10km/h speed button pressed!"));
         if (domyos_treadmill_buttons) {
 
             changeSpeed(10.0);
         }
     } else if (value.at(22) == 0x0e) {
-        emit debug(QStringLiteral("5km/h speed button pressed!"));
+        LOG_DEVICE(QStringLiteral("5km/h speed button pressed!"));
         if (domyos_treadmill_buttons) {
 
             changeSpeed(5.0);
         }
     } else if (value.at(22) == 0x15) {
-        emit debug(QStringLiteral("15% inclination button on console pressed!"));
+        LOG_DEVICE(QStringLiteral("15% inclination button on console pressed!"));
         if (domyos_treadmill_buttons) {
 
             changeInclination(15.0, 15.0);
         }
     } else if (value.at(22) == 0x14) {
-        emit debug(QStringLiteral("10% inclination button on console pressed!"));
+        LOG_DEVICE(QStringLiteral("10% inclination button on console pressed!"));
         if (domyos_treadmill_buttons) {
 
             changeInclination(10.0, 10.0);
         }
     } else if (value.at(22) == 0x13) {
-        emit debug(QStringLiteral("5% inclination button on console pressed!"));
+        LOG_DEVICE(QStringLiteral("5% inclination button on console pressed!"));
         if (domyos_treadmill_buttons) {
 
             changeInclination(5.0, 5.0);
         }
     } else if (value.at(22) == 0x12) {
-        emit debug(QStringLiteral("0% inclination button on console pressed!"));
+        LOG_DEVICE(QStringLiteral("0% inclination button on console pressed!"));
         if (domyos_treadmill_buttons) {
 
             changeInclination(0.0, 0.0);
@@ -565,17 +536,13 @@ void domyostreadmill::characteristicChanged(const QLowEnergyCharacteristic &char
         lastTimeCharacteristicChanged = QDateTime::currentDateTime();
     }
 
-    emit debug(QStringLiteral("Current speed: ") + QString::number(speed));
-    emit debug(QStringLiteral("Current incline: ") + QString::number(incline));
-    emit debug(QStringLiteral("Current heart: ") + QString::number(Heart.value()));
-    emit debug(QStringLiteral("Current KCal: ") + QString::number(KCal.value()));
-    emit debug(QStringLiteral("Current KCal from the machine: ") + QString::number(kcal));
-    emit debug(QStringLiteral("Current Distance: ") + QString::number(distance));
-    emit debug(QStringLiteral("Current Distance Calculated: ") + QString::number(Distance.value()));
-
-    if (m_control->error() != QLowEnergyController::NoError) {
-        qDebug() << QStringLiteral("QLowEnergyController ERROR!!") << m_control->errorString();
-    }
+    LOG_DEVICE(QStringLiteral("Current speed: ") + QString::number(speed));
+    LOG_DEVICE(QStringLiteral("Current incline: ") + QString::number(incline));
+    LOG_DEVICE(QStringLiteral("Current heart: ") + QString::number(Heart.value()));
+    LOG_DEVICE(QStringLiteral("Current KCal: ") + QString::number(KCal.value()));
+    LOG_DEVICE(QStringLiteral("Current KCal from the machine: ") + QString::number(kcal));
+    LOG_DEVICE(QStringLiteral("Current Distance: ") + QString::number(distance));
+    LOG_DEVICE(QStringLiteral("Current Distance Calculated: ") + QString::number(Distance.value()));
 
     if (Speed.value() != speed) {
 
@@ -660,128 +627,86 @@ void domyostreadmill::btinit(bool startTape) {
     initDone = true;
 }
 
-void domyostreadmill::stateChanged(QLowEnergyService::ServiceState state) {
-
-    QMetaEnum metaEnum = QMetaEnum::fromType<QLowEnergyService::ServiceState>();
-    emit debug(QStringLiteral("BTLE stateChanged ") + QString::fromLocal8Bit(metaEnum.valueToKey(state)));
-    if (state == QLowEnergyService::ServiceDiscovered) {
-
-        // qDebug() << gattCommunicationChannelService->characteristics();
-
-        gattWriteCharacteristic = gattCommunicationChannelService->characteristic(_gattWriteCharacteristicId);
-        gattNotifyCharacteristic = gattCommunicationChannelService->characteristic(_gattNotifyCharacteristicId);
-        Q_ASSERT(gattWriteCharacteristic.isValid());
-        Q_ASSERT(gattNotifyCharacteristic.isValid());
-
-        // establish hook into notifications
-        connect(gattCommunicationChannelService, &QLowEnergyService::characteristicChanged, this,
-                &domyostreadmill::characteristicChanged);
-        connect(gattCommunicationChannelService, &QLowEnergyService::characteristicWritten, this,
-                &domyostreadmill::characteristicWritten);
-        connect(gattCommunicationChannelService,
-                static_cast<void (QLowEnergyService::*)(QLowEnergyService::ServiceError)>(&QLowEnergyService::error),
-                this, &domyostreadmill::errorService);
-        connect(gattCommunicationChannelService, &QLowEnergyService::descriptorWritten, this,
-                &domyostreadmill::descriptorWritten);
-
-        QByteArray descriptor;
-        descriptor.append((char)0x01);
-        descriptor.append((char)0x00);
-        gattCommunicationChannelService->writeDescriptor(
-            gattNotifyCharacteristic.descriptor(QBluetoothUuid::ClientCharacteristicConfiguration), descriptor);
-    }
-}
-
-void domyostreadmill::descriptorWritten(const QLowEnergyDescriptor &descriptor, const QByteArray &newValue) {
-    emit debug(QStringLiteral("descriptorWritten ") + descriptor.name() + QStringLiteral(" ") + newValue.toHex(' '));
+void domyostreadmill::subscribed(const QBluetoothUuid &characteristic) {
+    LOG_DEVICE(QStringLiteral("subscribed ") + characteristic.toString());
 
     initRequest = true;
     emit connectedAndDiscovered();
 }
 
-void domyostreadmill::characteristicWritten(const QLowEnergyCharacteristic &characteristic,
-                                            const QByteArray &newValue) {
+void domyostreadmill::characteristicWritten(const QBluetoothUuid &characteristic, const QByteArray &newValue) {
     Q_UNUSED(characteristic);
-    emit debug(QStringLiteral("characteristicWritten ") + newValue.toHex(' '));
+    LOG_PACKET(QStringLiteral("characteristicWritten ") + newValue.toHex(' '));
 }
 
 void domyostreadmill::serviceScanDone(void) {
-    emit debug(QStringLiteral("serviceScanDone"));
+    LOG_DEVICE(QStringLiteral("serviceScanDone"));
 
-    gattCommunicationChannelService = m_control->createServiceObject(_gattCommunicationChannelServiceId);
-    connect(gattCommunicationChannelService, &QLowEnergyService::stateChanged, this, &domyostreadmill::stateChanged);
-    gattCommunicationChannelService->discoverDetails();
-}
-
-void domyostreadmill::errorService(QLowEnergyService::ServiceError err) {
-
-    QMetaEnum metaEnum = QMetaEnum::fromType<QLowEnergyService::ServiceError>();
-    emit debug(QStringLiteral("domyostreadmill::errorService ") + QString::fromLocal8Bit(metaEnum.valueToKey(err)) +
-               m_control->errorString());
+    if (!transport->hasCharacteristic(_gattWriteCharacteristicId) ||
+        !transport->hasCharacteristic(_gattNotifyCharacteristicId)) {
+        LOG_DEVICE(QStringLiteral("domyostreadmill: characteristics not found"));
+        return;
+    }
+    gattWriteCharacteristic = _gattWriteCharacteristicId;
+    gattNotifyCharacteristic = _gattNotifyCharacteristicId;
+    transport->subscribe(gattNotifyCharacteristic);
 }
 
-void domyostreadmill::error(QLowEnergyController::Error err) {
-
-    QMetaEnum metaEnum = QMetaEnum::fromType<QLowEnergyController::Error>();
-    emit debug(QStringLiteral("domyostreadmill::error ") + QString::fromLocal8Bit(metaEnum.valueToKey(err)) +
-               m_control->errorString());
+void domyostreadmill::error(const QString &err) {
+    LOG_DEVICE(QStringLiteral("domyostreadmill::error ") + err);
+    if (transport->state() == QLowEnergyController::UnconnectedState) {
+        LOG_DEVICE(QStringLiteral("Cannot connect to remote device."));
+        searchStopped = false;
+        emit disconnected();
+    }
 }
 
 void domyostreadmill::deviceDiscovered(const QBluetoothDeviceInfo &device) {
     {
 
         bluetoothDevice = device;
-        m_control = QLowEnergyController::createCentral(bluetoothDevice, this);
-        connect(m_control, &QLowEnergyController::serviceDiscovered, this, &domyostreadmill::serviceDiscovered);
-        connect(m_control, &QLowEnergyController::discoveryFinished, this, &domyostreadmill::serviceScanDone);
-        connect(m_control,
-                static_cast<void (QLowEnergyController::*)(QLowEnergyController::Error)>(&QLowEnergyController::error),
-                this, &domyostreadmill::error);
-        connect(m_control, &QLowEnergyController::stateChanged, this, &domyostreadmill::controllerStateChanged);
-
-        connect(m_control,
-                static_cast<void (QLowEnergyController::*)(QLowEnergyController::Error)>(&QLowEnergyController::error),
-                this, [this](QLowEnergyController::Error error) {
-                    Q_UNUSED(error);
-                    Q_UNUSED(this);
-                    emit debug(QStringLiteral("Cannot connect to remote device."));
-                    searchStopped = false;
-                    emit disconnected();
-                });
-        connect(m_control, &QLowEnergyController::connected, this, [this]() {
+        transport = bluetoothtransport::create(bluetoothDevice, this);
+        m_control = transport->controller();
+        transport->setServiceFilter({_gattCommunicationChannelServiceId});
+        connect(transport, &bluetoothtransport::discovered, this, &domyostreadmill::serviceScanDone);
+        connect(transport, &bluetoothtransport::characteristicChanged, this, &domyostreadmill::characteristicChanged);
+        connect(transport, &bluetoothtransport::characteristicWritten, this, &domyostreadmill::characteristicWritten);
+        connect(transport, &bluetoothtransport::subscribed, this, &domyostreadmill::subscribed);
+        connect(transport, &bluetoothtransport::error, this, &domyostreadmill::error);
+        connect(transport, &bluetoothtransport::stateChanged, this, &domyostreadmill::controllerStateChanged);
+        connect(transport, &bluetoothtransport::connected, this, [this]() {
             Q_UNUSED(this);
-            emit debug(QStringLiteral("Controller connected. Search services..."));
-            m_control->discoverServices();
+            LOG_DEVICE(QStringLiteral("Controller connected. Search services..."));
         });
-        connect(m_control, &QLowEnergyController::disconnected, this, [this]() {
+        connect(transport, &bluetoothtransport::disconnected, this, [this]() {
             Q_UNUSED(this);
-            emit debug(QStringLiteral("LowEnergy controller disconnected"));
+            LOG_DEVICE(QStringLiteral("LowEnergy controller disconnected"));
             searchStopped = false;
             emit disconnected();
         });
 
         // Connect
-        m_control->connectToDevice();
+        transport->connectToDevice();
         return;
     }
 }
 
 void domyostreadmill::controllerStateChanged(QLowEnergyController::ControllerState state) {
     qDebug() << QStringLiteral("controllerStateChanged") << state;
-    if (state == QLowEnergyController::UnconnectedState && m_control) {
+    if (state == QLowEnergyController::UnconnectedState && transport) {
         qDebug() << QStringLiteral("trying to connect back again...");
 
         initDone = false;
-        m_control->connectToDevice();
+        transport->connectToDevice();
     }
 }
 
 bool domyostreadmill::connected() {
-    if (!m_control) {
+    if (!transport) {
 
         return false;
     }
-    return m_control->state() == QLowEnergyController::DiscoveredState;
+    return transport->state() == QLowEnergyController::DiscoveredState;
 }
 
 void *domyostreadmill::VirtualTreadMill() { return virtualTreadMill; }
@@ -27,6 +27,8 @@
 #include <QDateTime>
 #include <QObject>
 
+#include "bluetoothtransport.h"
+#include "framing.h"
 #include "treadmill.h"
 #include "virtualbike.h"
 #include "virtualtreadmill.h"
@@ -47,6 +49,9 @@ class domyostreadmill : public treadmill {
     void *VirtualTreadMill();
     void *VirtualDevice();
 
+    // the 26/27 bytes status messages are split in a 20 bytes notification and the rest on some models
+    static const QList<fragmentassembler::message> fragmentMessages;
+
   private:
     bool sendChangeFanSpeed(uint8_t speed);
     double GetSpeedFromPacket(const QByteArray &packet);
@@ -59,14 +64,13 @@ class domyostreadmill : public treadmill {
     void writeCharacteristic(uint8_t *data, uint8_t data_len, const QString &info, bool disable_log = false,
                              bool wait_for_response = false);
     void startDiscover();
-    volatile bool incompletePackets = false;
+    fragmentassembler fragments = fragmentassembler(20, fragmentMessages);
     bool noConsole = false;
     bool noHeartService = false;
     uint32_t pollDeviceTime = 200;
     bool searchStopped = false;
     uint8_t sec1Update = 0;
     uint8_t firstInit = 0;
-    QByteArray lastPacket;
     QDateTime lastTimeCharacteristicChanged;
     bool firstCharacteristicChanged = true;
 
@@ -74,9 +78,8 @@ class domyostreadmill : public treadmill {
     virtualtreadmill *virtualTreadMill = nullptr;
     virtualbike *virtualBike = 0;
 
-    QLowEnergyService *gattCommunicationChannelService = nullptr;
-    QLowEnergyCharacteristic gattWriteCharacteristic;
-    QLowEnergyCharacteristic gattNotifyCharacteristic;
+    QBluetoothUuid gattWriteCharacteristic;
+    QBluetoothUuid gattNotifyCharacteristic;
 
     bool initDone = false;
     bool initRequest = false;
@@ -97,18 +100,15 @@ class domyostreadmill : public treadmill {
 
   private slots:
 
-    void characteristicChanged(const QLowEnergyCharacteristic &characteristic, const QByteArray &newValue);
-    void characteristicWritten(const QLowEnergyCharacteristic &characteristic, const QByteArray &newValue);
-    void descriptorWritten(const QLowEnergyDescriptor &descriptor, const QByteArray &newValue);
-    void stateChanged(QLowEnergyService::ServiceState state);
+    void characteristicChanged(const QBluetoothUuid &characteristic, const QByteArray &newValue);
+    void characteristicWritten(const QBluetoothUuid &characteristic, const QByteArray &newValue);
+    void subscribed(const QBluetoothUuid &characteristic);
     void controllerStateChanged(QLowEnergyController::ControllerState state);
     void changeInclinationRequested(double grade, double percentage);
 
-    void serviceDiscovered(const QBluetoothUuid &gatt);
     void serviceScanDone(void);
     void update();
-    void error(QLowEnergyController::Error err);
-    void errorService(QLowEnergyService::ServiceError);
+    void error(const QString &err);
 };
 
 #endif // DOMYOSTREADMILL_H
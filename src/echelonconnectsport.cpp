@@ -41,26 +41,25 @@ void echelonconnectsport::writeCharacteristic(uint8_t *data, uint8_t data_len, c
     // if there are some crash here, maybe it's better to use 2 separate event for the characteristicChanged.
     // one for the resistance changed event (spontaneous), and one for the other ones.
     if (wait_for_response) {
-        connect(gattCommunicationChannelService, &QLowEnergyService::characteristicChanged, &loop, &QEventLoop::quit);
+        connect(transport, &bluetoothtransport::characteristicChanged, &loop, &QEventLoop::quit);
         timeout.singleShot(300ms, &loop, &QEventLoop::quit);
     } else {
-        connect(gattCommunicationChannelService, &QLowEnergyService::characteristicWritten, &loop, &QEventLoop::quit);
+        connect(transport, &bluetoothtransport::characteristicWritten, &loop, &QEventLoop::quit);
         timeout.singleShot(300ms, &loop, &QEventLoop::quit);
     }
 
-    if (gattCommunicationChannelService->state() != QLowEnergyService::ServiceState::ServiceDiscovered ||
-        m_control->state() == QLowEnergyController::UnconnectedState) {
+    if (transport->state() != QLowEnergyController::DiscoveredState) {
         qDebug() << QStringLiteral("writeCharacteristic error because the connection is closed");
         return;
     }
 
-    if (!gattWriteCharacteristic.isValid()) {
+    if (gattWriteCharacteristic.isNull()) {
         qDebug() << QStringLiteral("gattWriteCharacteristic is invalid");
         return;
     }
 
-    gattCommunicationChannelService->writeCharacteristic(gattWriteCharacteristic,
-                                                         QByteArray((const char *)data, data_len));
+    writeRequested(QByteArray((const char *)data, data_len));
+    transport->writeCharacteristic(gattWriteCharacteristic, QByteArray((const char *)data, data_len));
 
     if (!disable_log) {
         qDebug() << QStringLiteral(" >> ") + QByteArray((const char *)data, data_len).toHex(' ') +
@@ -99,7 +98,7 @@ void echelonconnectsport::sendPoll() {
 }
 
 void echelonconnectsport::update() {
-    if (m_control->state() == QLowEnergyController::UnconnectedState) {
+    if (transport->state() == QLowEnergyController::UnconnectedState) {
         emit disconnected();
         return;
     }
@@ -107,9 +106,9 @@ void echelonconnectsport::update() {
     if (initRequest) {
         initRequest = false;
         btinit();
-    } else if (bluetoothDevice.isValid() && m_control->state() == QLowEnergyController::DiscoveredState &&
-               gattCommunicationChannelService && gattWriteCharacteristic.isValid() &&
-               gattNotify1Characteristic.isValid() && gattNotify2Characteristic.isValid() && initDone) {
+    } else if (bluetoothDevice.isValid() && transport->state() == QLowEnergyController::DiscoveredState &&
+               !gattWriteCharacteristic.isNull() && !gattNotify1Characteristic.isNull() &&
+               !gattNotify2Characteristic.isNull() && initDone) {
         update_metrics(true, watts());
 
         // sending poll every 2 seconds
@@ -127,6 +126,7 @@ void echelonconnectsport::update() {
 
             if (requestResistance != currentResistance().value()) {
                 qDebug() << QStringLiteral("writing resistance ") + QString::number(requestResistance);
+                requestQueued();
                 forceResistance(requestResistance);
             }
             requestResistance = -1;
@@ -147,10 +147,6 @@ void echelonconnectsport::update() {
     }
 }
 
-void echelonconnectsport::serviceDiscovered(const QBluetoothUuid &gatt) {
-    qDebug() << QStringLiteral("serviceDiscovered ") + gatt.toString();
-}
-
 int echelonconnectsport::pelotonToBikeResistance(int pelotonResistance) {
     for (int i = 1; i < max_resistance; i++) {
         if (bikeResistanceToPeloton(i) <= pelotonResistance && bikeResistanceToPeloton(i + 1) >= pelotonResistance) {
@@ -188,9 +184,8 @@ double echelonconnectsport::bikeResistanceToPeloton(double resistance) {
     return p;
 }
 
-void echelonconnectsport::characteristicChanged(const QLowEnergyCharacteristic &characteristic,
-                                                const QByteArray &newValue) {
-    // qDebug() << "characteristicChanged" << characteristic.uuid() << newValue << newValue.length();
+void echelonconnectsport::characteristicChanged(const QBluetoothUuid &characteristic, const QByteArray &newValue) {
+    // qDebug() << "characteristicChanged" << characteristic << newValue << newValue.length();
     Q_UNUSED(characteristic);
     QSettings settings;
     QString heartRateBeltName =
@@ -290,10 +285,6 @@ void echelonconnectsport::characteristicChanged(const QLowEnergyCharacteristic &
     qDebug() << QStringLiteral("Current CrankRevs: ") + QString::number(CrankRevs);
     qDebug() << QStringLiteral("Last CrankEventTime: ") + QString::number(LastCrankEventTime);
     qDebug() << QStringLiteral("Current Watt: ") + QString::number(watts());
-
-    if (m_control->error() != QLowEnergyController::NoError) {
-        qDebug() << QStringLiteral("QLowEnergyController ERROR!!") << m_control->errorString();
-    }
 }
 
 QTime echelonconnectsport::GetElapsedFromPacket(const QByteArray &packet) {
@@ -338,111 +329,77 @@ void echelonconnectsport::btinit() {
     }
 }
 
-void echelonconnectsport::stateChanged(QLowEnergyService::ServiceState state) {
+void echelonconnectsport::serviceScanDone(void) {
     QBluetoothUuid _gattWriteCharacteristicId(QStringLiteral("0bf669f2-45f2-11e7-9598-0800200c9a66"));
     QBluetoothUuid _gattNotify1CharacteristicId(QStringLiteral("0bf669f3-45f2-11e7-9598-0800200c9a66"));
     QBluetoothUuid _gattNotify2CharacteristicId(QStringLiteral("0bf669f4-45f2-11e7-9598-0800200c9a66"));
 
-    QMetaEnum metaEnum = QMetaEnum::fromType<QLowEnergyService::ServiceState>();
-    qDebug() << QStringLiteral("BTLE stateChanged ") + QString::fromLocal8Bit(metaEnum.valueToKey(state));
-
-    if (state == QLowEnergyService::ServiceDiscovered) {
-        // qDebug() << gattCommunicationChannelService->characteristics();
+    qDebug() << QStringLiteral("serviceScanDone");
 
-        gattWriteCharacteristic = gattCommunicationChannelService->characteristic(_gattWriteCharacteristicId);
-        gattNotify1Characteristic = gattCommunicationChannelService->characteristic(_gattNotify1CharacteristicId);
-        gattNotify2Characteristic = gattCommunicationChannelService->characteristic(_gattNotify2CharacteristicId);
-        Q_ASSERT(gattWriteCharacteristic.isValid());
-        Q_ASSERT(gattNotify1Characteristic.isValid());
-        Q_ASSERT(gattNotify2Characteristic.isValid());
+    if (!transport->hasCharacteristic(_gattWriteCharacteristicId) ||
+        !transport->hasCharacteristic(_gattNotify1CharacteristicId) ||
+        !transport->hasCharacteristic(_gattNotify2CharacteristicId)) {
+        qDebug() << QStringLiteral("echelonconnectsport: characteristics not found");
+        return;
+    }
+    gattWriteCharacteristic = _gattWriteCharacteristicId;
+    gattNotify1Characteristic = _gattNotify1CharacteristicId;
+    gattNotify2Characteristic = _gattNotify2CharacteristicId;
 
-        // establish hook into notifications
-        connect(gattCommunicationChannelService, &QLowEnergyService::characteristicChanged, this,
-                &echelonconnectsport::characteristicChanged);
-        connect(gattCommunicationChannelService, &QLowEnergyService::characteristicWritten, this,
-                &echelonconnectsport::characteristicWritten);
-        connect(gattCommunicationChannelService,
-                static_cast<void (QLowEnergyService::*)(QLowEnergyService::ServiceError)>(&QLowEnergyService::error),
-                this, &echelonconnectsport::errorService);
-        connect(gattCommunicationChannelService, &QLowEnergyService::descriptorWritten, this,
-                &echelonconnectsport::descriptorWritten);
-
-        // ******************************************* virtual bike init *************************************
-        if (!firstStateChanged && !virtualBike
+    // ******************************************* virtual bike init *************************************
+    if (!firstStateChanged && !virtualBike
 #ifdef Q_OS_IOS
 #ifndef IO_UNDER_QT
-            && !h
+        && !h
 #endif
 #endif
-        ) {
-            QSettings settings;
-            bool virtual_device_enabled = settings.value(QStringLiteral("virtual_device_enabled"), true).toBool();
+    ) {
+        QSettings settings;
+        bool virtual_device_enabled = settings.value(QStringLiteral("virtual_device_enabled"), true).toBool();
 #ifdef Q_OS_IOS
 #ifndef IO_UNDER_QT
-            bool cadence = settings.value("bike_cadence_sensor", false).toBool();
-            bool ios_peloton_workaround = settings.value("ios_peloton_workaround", true).toBool();
-            if (ios_peloton_workaround && cadence) {
-                qDebug() << "ios_peloton_workaround activated!";
-                h = new lockscreen();
-                h->virtualbike_ios();
-            } else
+        bool cadence = settings.value("bike_cadence_sensor", false).toBool();
+        bool ios_peloton_workaround = settings.value("ios_peloton_workaround", true).toBool();
+        if (ios_peloton_workaround && cadence) {
+            qDebug() << "ios_peloton_workaround activated!";
+            h = new lockscreen();
+            h->virtualbike_ios();
+        } else
 #endif
 #endif
-                if (virtual_device_enabled) {
-                qDebug() << QStringLiteral("creating virtual bike interface...");
-                virtualBike =
-                    new virtualbike(this, noWriteResistance, noHeartService, bikeResistanceOffset, bikeResistanceGain);
-                // connect(virtualBike,&virtualbike::debug ,this,&echelonconnectsport::debug);
-                connect(virtualBike, &virtualbike::changeInclination, this, &echelonconnectsport::changeInclination);
-            }
+            if (virtual_device_enabled) {
+            qDebug() << QStringLiteral("creating virtual bike interface...");
+            virtualBike =
+                new virtualbike(this, noWriteResistance, noHeartService, bikeResistanceOffset, bikeResistanceGain);
+            // connect(virtualBike,&virtualbike::debug ,this,&echelonconnectsport::debug);
+            connect(virtualBike, &virtualbike::changeInclination, this, &echelonconnectsport::changeInclination);
         }
-        firstStateChanged = 1;
-        // ********************************************************************************************************
-
-        QByteArray descriptor;
-        descriptor.append((char)0x01);
-        descriptor.append((char)0x00);
-        gattCommunicationChannelService->writeDescriptor(
-            gattNotify1Characteristic.descriptor(QBluetoothUuid::ClientCharacteristicConfiguration), descriptor);
-        gattCommunicationChannelService->writeDescriptor(
-            gattNotify2Characteristic.descriptor(QBluetoothUuid::ClientCharacteristicConfiguration), descriptor);
     }
+    firstStateChanged = 1;
+    // ********************************************************************************************************
+
+    transport->subscribe(gattNotify1Characteristic);
+    transport->subscribe(gattNotify2Characteristic);
 }
 
-void echelonconnectsport::descriptorWritten(const QLowEnergyDescriptor &descriptor, const QByteArray &newValue) {
-    qDebug() << QStringLiteral("descriptorWritten ") + descriptor.name() + QStringLiteral(" ") + newValue.toHex(' ');
+void echelonconnectsport::subscribed(const QBluetoothUuid &characteristic) {
+    qDebug() << QStringLiteral("subscribed ") + characteristic.toString();
 
     initRequest = true;
     emit connectedAndDiscovered();
 }
 
-void echelonconnectsport::characteristicWritten(const QLowEnergyCharacteristic &characteristic,
-                                                const QByteArray &newValue) {
+void echelonconnectsport::characteristicWritten(const QBluetoothUuid &characteristic, const QByteArray &newValue) {
     Q_UNUSED(characteristic);
     qDebug() << QStringLiteral("characteristicWritten ") + newValue.toHex(' ');
 }
 
-void echelonconnectsport::serviceScanDone(void) {
-    qDebug() << QStringLiteral("serviceScanDone");
-
-    QBluetoothUuid _gattCommunicationChannelServiceId(QStringLiteral("0bf669f1-45f2-11e7-9598-0800200c9a66"));
-
-    gattCommunicationChannelService = m_control->createServiceObject(_gattCommunicationChannelServiceId);
-    connect(gattCommunicationChannelService, &QLowEnergyService::stateChanged, this,
-            &echelonconnectsport::stateChanged);
-    gattCommunicationChannelService->discoverDetails();
-}
-
-void echelonconnectsport::errorService(QLowEnergyService::ServiceError err) {
-    QMetaEnum metaEnum = QMetaEnum::fromType<QLowEnergyService::ServiceError>();
-    qDebug() << QStringLiteral("echelonconnectsport::errorService") + QString::fromLocal8Bit(metaEnum.valueToKey(err)) +
-                    m_control->errorString();
-}
-
-void echelonconnectsport::error(QLowEnergyController::Error err) {
-    QMetaEnum metaEnum = QMetaEnum::fromType<QLowEnergyController::Error>();
-    qDebug() << QStringLiteral("echelonconnectsport::error") + QString::fromLocal8Bit(metaEnum.valueToKey(err)) +
-                    m_control->errorString();
+void echelonconnectsport::error(const QString &err) {
+    qDebug() << QStringLiteral("echelonconnectsport::error ") + err;
+    if (transport->state() == QLowEnergyController::UnconnectedState) {
+        qDebug() << QStringLiteral("Cannot connect to remote device.");
+        emit disconnected();
+    }
 }
 
 void echelonconnectsport::deviceDiscovered(const QBluetoothDeviceInfo &device) {
@@ -451,44 +408,38 @@ void echelonconnectsport::deviceDiscovered(const QBluetoothDeviceInfo &device) {
     if (device.name().startsWith(QStringLiteral("ECH"))) {
         bluetoothDevice = device;
 
-        m_control = QLowEnergyController::createCentral(bluetoothDevice, this);
-        connect(m_control, &QLowEnergyController::serviceDiscovered, this, &echelonconnectsport::serviceDiscovered);
-        connect(m_control, &QLowEnergyController::discoveryFinished, this, &echelonconnectsport::serviceScanDone);
-        connect(m_control,
-                static_cast<void (QLowEnergyController::*)(QLowEnergyController::Error)>(&QLowEnergyController::error),
-                this, &echelonconnectsport::error);
-        connect(m_control, &QLowEnergyController::stateChanged, this, &echelonconnectsport::controllerStateChanged);
-
-        connect(m_control,
-                static_cast<void (QLowEnergyController::*)(QLowEnergyController::Error)>(&QLowEnergyController::error),
-                this, [this](QLowEnergyController::Error error) {
-                    Q_UNUSED(error);
-                    Q_UNUSED(this);
-                    qDebug() << QStringLiteral("Cannot connect to remote device.");
-                    emit disconnected();
-                });
-        connect(m_control, &QLowEnergyController::connected, this, [this]() {
+        transport = bluetoothtransport::create(bluetoothDevice, this);
+        m_control = transport->controller();
+        transport->setServiceFilter({QBluetoothUuid(QStringLiteral("0bf669f1-45f2-11e7-9598-0800200c9a66"))});
+        connect(transport, &bluetoothtransport::discovered, this, &echelonconnectsport::serviceScanDone);
+        connect(transport, &bluetoothtransport::characteristicChanged, this,
+                &echelonconnectsport::characteristicChanged);
+        connect(transport, &bluetoothtransport::characteristicWritten, this,
+                &echelonconnectsport::characteristicWritten);
+        connect(transport, &bluetoothtransport::subscribed, this, &echelonconnectsport::subscribed);
+        connect(transport, &bluetoothtransport::error, this, &echelonconnectsport::error);
+        connect(transport, &bluetoothtransport::stateChanged, this, &echelonconnectsport::controllerStateChanged);
+        connect(transport, &bluetoothtransport::connected, this, [this]() {
             Q_UNUSED(this);
             qDebug() << QStringLiteral("Controller connected. Search services...");
-            m_control->discoverServices();
         });
-        connect(m_control, &QLowEnergyController::disconnected, this, [this]() {
+        connect(transport, &bluetoothtransport::disconnected, this, [this]() {
             Q_UNUSED(this);
             qDebug() << QStringLiteral("LowEnergy controller disconnected");
             emit disconnected();
         });
 
         // Connect
-        m_control->connectToDevice();
+        transport->connectToDevice();
         return;
     }
 }
 
 bool echelonconnectsport::connected() {
-    if (!m_control) {
+    if (!transport) {
         return false;
     }
-    return m_control->state() == QLowEnergyController::DiscoveredState;
+    return transport->state() == QLowEnergyController::DiscoveredState;
 }
 
 void *echelonconnectsport::VirtualBike() { return virtualBike; }
@@ -606,10 +557,10 @@ uint16_t echelonconnectsport::wattsFromResistance(double resistance) {
 
 void echelonconnectsport::controllerStateChanged(QLowEnergyController::ControllerState state) {
     qDebug() << QStringLiteral("controllerStateChanged") << state;
-    if (state == QLowEnergyController::UnconnectedState && m_control) {
+    if (state == QLowEnergyController::UnconnectedState && transport) {
         lastResistanceBeforeDisconnection = Resistance.value();
         qDebug() << QStringLiteral("trying to connect back again...");
         initDone = false;
-        m_control->connectToDevice();
+        transport->connectToDevice();
     }
 }
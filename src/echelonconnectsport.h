@@ -27,6 +27,7 @@
 #include <QString>
 
 #include "bike.h"
+#include "bluetoothtransport.h"
 #include "virtualbike.h"
 
 #ifdef Q_OS_IOS
@@ -63,10 +64,9 @@ class echelonconnectsport : public bike {
     QTimer *refresh;
     virtualbike *virtualBike = nullptr;
 
-    QLowEnergyService *gattCommunicationChannelService = nullptr;
-    QLowEnergyCharacteristic gattWriteCharacteristic;
-    QLowEnergyCharacteristic gattNotify1Characteristic;
-    QLowEnergyCharacteristic gattNotify2Characteristic;
+    QBluetoothUuid gattWriteCharacteristic;
+    QBluetoothUuid gattNotify1Characteristic;
+    QBluetoothUuid gattNotify2Characteristic;
 
     uint8_t bikeResistanceOffset = 4;
     double bikeResistanceGain = 1.0;
@@ -95,17 +95,14 @@ class echelonconnectsport : public bike {
 
   private slots:
 
-    void characteristicChanged(const QLowEnergyCharacteristic &characteristic, const QByteArray &newValue);
-    void characteristicWritten(const QLowEnergyCharacteristic &characteristic, const QByteArray &newValue);
-    void descriptorWritten(const QLowEnergyDescriptor &descriptor, const QByteArray &newValue);
-    void stateChanged(QLowEnergyService::ServiceState state);
+    void characteristicChanged(const QBluetoothUuid &characteristic, const QByteArray &newValue);
+    void characteristicWritten(const QBluetoothUuid &characteristic, const QByteArray &newValue);
+    void subscribed(const QBluetoothUuid &characteristic);
     void controllerStateChanged(QLowEnergyController::ControllerState state);
 
-    void serviceDiscovered(const QBluetoothUuid &gatt);
     void serviceScanDone(void);
     void update();
-    void error(QLowEnergyController::Error err);
-    void errorService(QLowEnergyService::ServiceError);
+    void error(const QString &err);
 };
 
 #endif // ECHELONCONNECTSPORT_H
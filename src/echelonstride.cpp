@@ -1,4 +1,5 @@
 #include "echelonstride.h"
+#include "logging.h"
 #include "ios/lockscreen.h"
 #include "keepawakehelper.h"
 #include "virtualtreadmill.h"
@@ -47,7 +48,7 @@ void echelonstride::writeCharacteristic(uint8_t *data, uint8_t data_len, const Q
 
     if (gattCommunicationChannelService->state() != QLowEnergyService::ServiceState::ServiceDiscovered ||
         m_control->state() == QLowEnergyController::UnconnectedState) {
-        emit debug(QStringLiteral("writeCharacteristic error because the connection is closed"));
+        LOG_DEVICE(QStringLiteral("writeCharacteristic error because the connection is closed"));
         return;
     }
 
@@ -55,14 +56,14 @@ void echelonstride::writeCharacteristic(uint8_t *data, uint8_t data_len, const Q
                                                          QByteArray((const char *)data, data_len));
 
     if (!disable_log) {
-        emit debug(QStringLiteral(" >> ") + QByteArray((const char *)data, data_len).toHex(' ') +
+        LOG_PACKET(QStringLiteral(" >> ") + QByteArray((const char *)data, data_len).toHex(' ') +
                    QStringLiteral(" // ") + info);
     }
 
     loop.exec();
 
     if (timeout.isActive() == false) {
-        emit debug(QStringLiteral(" exit for timeout"));
+        LOG_DEVICE(QStringLiteral(" exit for timeout"));
     }
 }
 
@@ -162,7 +163,7 @@ void echelonstride::update() {
 
         if (requestSpeed != -1) {
             if (requestSpeed != currentSpeed().value() && requestSpeed >= 0 && requestSpeed <= 22) {
-                emit debug(QStringLiteral("writing speed ") + QString::number(requestSpeed));
+                LOG_DEVICE(QStringLiteral("writing speed ") + QString::number(requestSpeed));
                 forceSpeed(requestSpeed);
             }
             requestSpeed = -1;
@@ -170,13 +171,13 @@ void echelonstride::update() {
         if (requestInclination != -1) {
             if (requestInclination != currentInclination().value() && requestInclination >= 0 &&
                 requestInclination <= 15) {
-                emit debug(QStringLiteral("writing incline ") + QString::number(requestInclination));
+                LOG_DEVICE(QStringLiteral("writing incline ") + QString::number(requestInclination));
                 forceIncline(requestInclination);
             }
             requestInclination = -1;
         }
         if (requestStart != -1) {
-            emit debug(QStringLiteral("starting..."));
+            LOG_DEVICE(QStringLiteral("starting..."));
             if (lastSpeed == 0.0) {
                 lastSpeed = 0.5;
             }
@@ -187,23 +188,23 @@ void echelonstride::update() {
             emit tapeStarted();
         }
         if (requestStop != -1) {
-            emit debug(QStringLiteral("stopping..."));
+            LOG_DEVICE(QStringLiteral("stopping..."));
             uint8_t initData3[] = {0xf0, 0xb0, 0x01, 0x00, 0xa1};
             writeCharacteristic(initData3, sizeof(initData3), QStringLiteral("stop"), false, true);
             requestStop = -1;
             lastStop = QDateTime::currentMSecsSinceEpoch();
         }
         if (requestFanSpeed != -1) {
-            emit debug(QStringLiteral("changing fan speed..."));
+            LOG_DEVICE(QStringLiteral("changing fan speed..."));
             // sendChangeFanSpeed(requestFanSpeed);
             requestFanSpeed = -1;
         }
         if (requestIncreaseFan != -1) {
-            emit debug(QStringLiteral("increasing fan speed..."));
+            LOG_DEVICE(QStringLiteral("increasing fan speed..."));
             // sendChangeFanSpeed(FanSpeed + 1);
             requestIncreaseFan = -1;
         } else if (requestDecreaseFan != -1) {
-            emit debug(QStringLiteral("decreasing fan speed..."));
+            LOG_DEVICE(QStringLiteral("decreasing fan speed..."));
             // sendChangeFanSpeed(FanSpeed - 1);
             requestDecreaseFan = -1;
         }
@@ -211,7 +212,7 @@ void echelonstride::update() {
 }
 
 void echelonstride::serviceDiscovered(const QBluetoothUuid &gatt) {
-    emit debug(QStringLiteral("serviceDiscovered ") + gatt.toString());
+    LOG_DEVICE(QStringLiteral("serviceDiscovered ") + gatt.toString());
 }
 
 double echelonstride::minStepInclination() { return 1.0; }
@@ -376,7 +377,7 @@ void echelonstride::stateChanged(QLowEnergyService::ServiceState state) {
 }
 
 void echelonstride::descriptorWritten(const QLowEnergyDescriptor &descriptor, const QByteArray &newValue) {
-    emit debug(QStringLiteral("descriptorWritten ") + descriptor.name() + " " + newValue.toHex(' '));
+    LOG_PACKET(QStringLiteral("descriptorWritten ") + descriptor.name() + " " + newValue.toHex(' '));
 
     initRequest = true;
     emit connectedAndDiscovered();
@@ -384,7 +385,7 @@ void echelonstride::descriptorWritten(const QLowEnergyDescriptor &descriptor, co
 
 void echelonstride::characteristicWritten(const QLowEnergyCharacteristic &characteristic, const QByteArray &newValue) {
     Q_UNUSED(characteristic);
-    emit debug(QStringLiteral("characteristicWritten ") + newValue.toHex(' '));
+    LOG_PACKET(QStringLiteral("characteristicWritten ") + newValue.toHex(' '));
 }
 
 void echelonstride::serviceScanDone(void) {
@@ -399,13 +400,13 @@ void echelonstride::serviceScanDone(void) {
 
 void echelonstride::errorService(QLowEnergyService::ServiceError err) {
     QMetaEnum metaEnum = QMetaEnum::fromType<QLowEnergyService::ServiceError>();
-    emit debug(QStringLiteral("echelonstride::errorService ") + QString::fromLocal8Bit(metaEnum.valueToKey(err)) +
+    LOG_DEVICE(QStringLiteral("echelonstride::errorService ") + QString::fromLocal8Bit(metaEnum.valueToKey(err)) +
                m_control->errorString());
 }
 
 void echelonstride::error(QLowEnergyController::Error err) {
     QMetaEnum metaEnum = QMetaEnum::fromType<QLowEnergyController::Error>();
-    emit debug(QStringLiteral("echelonstride::error ") + QString::fromLocal8Bit(metaEnum.valueToKey(err)) +
+    LOG_DEVICE(QStringLiteral("echelonstride::error ") + QString::fromLocal8Bit(metaEnum.valueToKey(err)) +
                m_control->errorString());
 }
 
@@ -423,17 +424,17 @@ void echelonstride::deviceDiscovered(const QBluetoothDeviceInfo &device) {
                 this, [this](QLowEnergyController::Error error) {
                     Q_UNUSED(error);
                     Q_UNUSED(this);
-                    emit debug(QStringLiteral("Cannot connect to remote device."));
+                    LOG_DEVICE(QStringLiteral("Cannot connect to remote device."));
                     emit disconnected();
                 });
         connect(m_control, &QLowEnergyController::connected, this, [this]() {
             Q_UNUSED(this);
-            emit debug(QStringLiteral("Controller connected. Search services..."));
+            LOG_DEVICE(QStringLiteral("Controller connected. Search services..."));
             m_control->discoverServices();
         });
         connect(m_control, &QLowEnergyController::disconnected, this, [this]() {
             Q_UNUSED(this);
-            emit debug(QStringLiteral("LowEnergy controller disconnected"));
+            LOG_DEVICE(QStringLiteral("LowEnergy controller disconnected"));
             emit disconnected();
         });
 
@@ -1,4 +1,5 @@
 #include "eliterizer.h"
+#include "logging.h"
 #include "ios/lockscreen.h"
 #include "virtualbike.h"
 #include <QBluetoothLocalDevice>
@@ -57,7 +58,7 @@ void eliterizer::writeCharacteristic(uint8_t *data, uint8_t data_len, const QStr
                                                          QByteArray((const char *)data, data_len));
 
     if (!disable_log) {
-        emit debug(QStringLiteral(" >> ") + QByteArray((const char *)data, data_len).toHex(' ') +
+        LOG_PACKET(QStringLiteral(" >> ") + QByteArray((const char *)data, data_len).toHex(' ') +
                    QStringLiteral(" // ") + info);
     }
 
@@ -91,12 +92,12 @@ void eliterizer::update() {
 }
 
 void eliterizer::serviceDiscovered(const QBluetoothUuid &gatt) {
-    emit debug(QStringLiteral("serviceDiscovered ") + gatt.toString());
+    LOG_DEVICE(QStringLiteral("serviceDiscovered ") + gatt.toString());
 }
 
 void eliterizer::characteristicChanged(const QLowEnergyCharacteristic &characteristic, const QByteArray &newValue) {
 
-    emit debug(QStringLiteral(" << ") + characteristic.uuid().toString() +  QStringLiteral(" ") +newValue.toHex(' '));
+    LOG_PACKET(QStringLiteral(" << ") + characteristic.uuid().toString() +  QStringLiteral(" ") +newValue.toHex(' '));
 
     lastPacket = newValue;
 
@@ -127,7 +128,7 @@ void eliterizer::characteristicChanged(const QLowEnergyCharacteristic &character
     } else {
         if (newValue.length() >= 4) {
             const float *ptrFloat = reinterpret_cast<const float *>(newValue.constData());
-            emit debug(QStringLiteral("Steering Angle: ") + QString::number(*ptrFloat) + "°");
+            LOG_DEVICE(QStringLiteral("Steering Angle: ") + QString::number(*ptrFloat) + "°");
             m_steeringAngle = *ptrFloat;
             emit steeringAngleChanged(m_steeringAngle.value());
         }
@@ -141,7 +142,7 @@ void eliterizer::stateChanged(QLowEnergyService::ServiceState state) {
     QBluetoothUuid _gattNotify2CharacteristicId(QStringLiteral("347b0030-7635-408b-8918-8ff3949ce592"));
 
     QMetaEnum metaEnum = QMetaEnum::fromType<QLowEnergyService::ServiceState>();
-    emit debug(QStringLiteral("BTLE stateChanged ") + QString::fromLocal8Bit(metaEnum.valueToKey(state)));
+    LOG_DEVICE(QStringLiteral("BTLE stateChanged ") + QString::fromLocal8Bit(metaEnum.valueToKey(state)));
 
     if (state == QLowEnergyService::ServiceDiscovered) {
         // qDebug() << gattCommunicationChannelService->characteristics();
@@ -187,7 +188,7 @@ void eliterizer::stateChanged(QLowEnergyService::ServiceState state) {
 }
 
 void eliterizer::descriptorWritten(const QLowEnergyDescriptor &descriptor, const QByteArray &newValue) {
-    emit debug(QStringLiteral("descriptorWritten ") + descriptor.name() + QStringLiteral(" ") + newValue.toHex(' '));
+    LOG_PACKET(QStringLiteral("descriptorWritten ") + descriptor.name() + QStringLiteral(" ") + newValue.toHex(' '));
 
     initRequest = true;
     emit connectedAndDiscovered();
@@ -200,7 +201,7 @@ void eliterizer::descriptorRead(const QLowEnergyDescriptor &descriptor, const QB
 void eliterizer::characteristicWritten(const QLowEnergyCharacteristic &characteristic, const QByteArray &newValue) {
 
     Q_UNUSED(characteristic);
-    emit debug(QStringLiteral("characteristicWritten ") + newValue.toHex(' '));
+    LOG_PACKET(QStringLiteral("characteristicWritten ") + newValue.toHex(' '));
 }
 
 void eliterizer::characteristicRead(const QLowEnergyCharacteristic &characteristic, const QByteArray &newValue) {
@@ -208,7 +209,7 @@ void eliterizer::characteristicRead(const QLowEnergyCharacteristic &characterist
 }
 
 void eliterizer::serviceScanDone(void) {
-    emit debug(QStringLiteral("serviceScanDone"));
+    LOG_DEVICE(QStringLiteral("serviceScanDone"));
 
     QBluetoothUuid _gattCommunicationChannelServiceId(QStringLiteral("347b0001-7635-408b-8918-8ff3949ce592"));
 
@@ -221,19 +222,19 @@ void eliterizer::serviceScanDone(void) {
 void eliterizer::errorService(QLowEnergyService::ServiceError err) {
 
     QMetaEnum metaEnum = QMetaEnum::fromType<QLowEnergyService::ServiceError>();
-    emit debug(QStringLiteral("eliterizer::errorService") + QString::fromLocal8Bit(metaEnum.valueToKey(err)) +
+    LOG_DEVICE(QStringLiteral("eliterizer::errorService") + QString::fromLocal8Bit(metaEnum.valueToKey(err)) +
                m_control->errorString());
 }
 
 void eliterizer::error(QLowEnergyController::Error err) {
 
     QMetaEnum metaEnum = QMetaEnum::fromType<QLowEnergyController::Error>();
-    emit debug(QStringLiteral("eliterizer::error") + QString::fromLocal8Bit(metaEnum.valueToKey(err)) +
+    LOG_DEVICE(QStringLiteral("eliterizer::error") + QString::fromLocal8Bit(metaEnum.valueToKey(err)) +
                m_control->errorString());
 }
 
 void eliterizer::deviceDiscovered(const QBluetoothDeviceInfo &device) {
-    emit debug(QStringLiteral("Found new device: ") + device.name() + QStringLiteral(" (") +
+    LOG_DEVICE(QStringLiteral("Found new device: ") + device.name() + QStringLiteral(" (") +
                device.address().toString() + ')');
     {
         bluetoothDevice = device;
@@ -251,17 +252,17 @@ void eliterizer::deviceDiscovered(const QBluetoothDeviceInfo &device) {
                 this, [this](QLowEnergyController::Error error) {
                     Q_UNUSED(error);
                     Q_UNUSED(this);
-                    emit debug(QStringLiteral("Cannot connect to remote device."));
+                    LOG_DEVICE(QStringLiteral("Cannot connect to remote device."));
                     emit disconnected();
                 });
         connect(m_control, &QLowEnergyController::connected, this, [this]() {
             Q_UNUSED(this);
-            emit debug(QStringLiteral("Controller connected. Search services..."));
+            LOG_DEVICE(QStringLiteral("Controller connected. Search services..."));
             m_control->discoverServices();
         });
         connect(m_control, &QLowEnergyController::disconnected, this, [this]() {
             Q_UNUSED(this);
-            emit debug(QStringLiteral("LowEnergy controller disconnected"));
+            LOG_DEVICE(QStringLiteral("LowEnergy controller disconnected"));
             emit disconnected();
         });
 
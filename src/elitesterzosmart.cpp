@@ -1,4 +1,5 @@
 #include "elitesterzosmart.h"
+#include "logging.h"
 #include "ios/lockscreen.h"
 #include "virtualbike.h"
 #include <QBluetoothLocalDevice>
@@ -46,7 +47,7 @@ void elitesterzosmart::writeCharacteristic(uint8_t *data, uint8_t data_len, cons
                                                          QByteArray((const char *)data, data_len));
 
     if (!disable_log) {
-        emit debug(QStringLiteral(" >> ") + QByteArray((const char *)data, data_len).toHex(' ') +
+        LOG_PACKET(QStringLiteral(" >> ") + QByteArray((const char *)data, data_len).toHex(' ') +
                    QStringLiteral(" // ") + info);
     }
 
@@ -80,7 +81,7 @@ void elitesterzosmart::update() {
 }
 
 void elitesterzosmart::serviceDiscovered(const QBluetoothUuid &gatt) {
-    emit debug(QStringLiteral("serviceDiscovered ") + gatt.toString());
+    LOG_DEVICE(QStringLiteral("serviceDiscovered ") + gatt.toString());
 }
 
 void elitesterzosmart::characteristicChanged(const QLowEnergyCharacteristic &characteristic,
@@ -88,13 +89,13 @@ void elitesterzosmart::characteristicChanged(const QLowEnergyCharacteristic &cha
 
     Q_UNUSED(characteristic);
 
-    emit debug(QStringLiteral(" << ") + newValue.toHex(' '));
+    LOG_PACKET(QStringLiteral(" << ") + newValue.toHex(' '));
 
     lastPacket = newValue;
 
     if (newValue.length() >= 4) {
         const float *ptrFloat = reinterpret_cast<const float *>(newValue.constData());
-        emit debug(QStringLiteral("Steering Angle: ") + QString::number(*ptrFloat) + "°");
+        LOG_DEVICE(QStringLiteral("Steering Angle: ") + QString::number(*ptrFloat) + "°");
         m_steeringAngle = *ptrFloat;
         emit steeringAngleChanged(m_steeringAngle.value());
     }
@@ -105,7 +106,7 @@ void elitesterzosmart::stateChanged(QLowEnergyService::ServiceState state) {
     QBluetoothUuid _gattNotify1CharacteristicId(QStringLiteral("347b0030-7635-408b-8918-8ff3949ce592"));
 
     QMetaEnum metaEnum = QMetaEnum::fromType<QLowEnergyService::ServiceState>();
-    emit debug(QStringLiteral("BTLE stateChanged ") + QString::fromLocal8Bit(metaEnum.valueToKey(state)));
+    LOG_DEVICE(QStringLiteral("BTLE stateChanged ") + QString::fromLocal8Bit(metaEnum.valueToKey(state)));
 
     if (state == QLowEnergyService::ServiceDiscovered) {
         // qDebug() << gattCommunicationChannelService->characteristics();
@@ -147,7 +148,7 @@ void elitesterzosmart::stateChanged(QLowEnergyService::ServiceState state) {
 }
 
 void elitesterzosmart::descriptorWritten(const QLowEnergyDescriptor &descriptor, const QByteArray &newValue) {
-    emit debug(QStringLiteral("descriptorWritten ") + descriptor.name() + QStringLiteral(" ") + newValue.toHex(' '));
+    LOG_PACKET(QStringLiteral("descriptorWritten ") + descriptor.name() + QStringLiteral(" ") + newValue.toHex(' '));
 
     initRequest = true;
     emit connectedAndDiscovered();
@@ -161,7 +162,7 @@ void elitesterzosmart::characteristicWritten(const QLowEnergyCharacteristic &cha
                                              const QByteArray &newValue) {
 
     Q_UNUSED(characteristic);
-    emit debug(QStringLiteral("characteristicWritten ") + newValue.toHex(' '));
+    LOG_PACKET(QStringLiteral("characteristicWritten ") + newValue.toHex(' '));
 }
 
 void elitesterzosmart::characteristicRead(const QLowEnergyCharacteristic &characteristic, const QByteArray &newValue) {
@@ -169,7 +170,7 @@ void elitesterzosmart::characteristicRead(const QLowEnergyCharacteristic &charac
 }
 
 void elitesterzosmart::serviceScanDone(void) {
-    emit debug(QStringLiteral("serviceScanDone"));
+    LOG_DEVICE(QStringLiteral("serviceScanDone"));
 
     QBluetoothUuid _gattCommunicationChannelServiceId(QStringLiteral("347b0001-7635-408b-8918-8ff3949ce592"));
 
@@ -182,19 +183,19 @@ void elitesterzosmart::serviceScanDone(void) {
 void elitesterzosmart::errorService(QLowEnergyService::ServiceError err) {
 
     QMetaEnum metaEnum = QMetaEnum::fromType<QLowEnergyService::ServiceError>();
-    emit debug(QStringLiteral("elitesterzosmart::errorService") + QString::fromLocal8Bit(metaEnum.valueToKey(err)) +
+    LOG_DEVICE(QStringLiteral("elitesterzosmart::errorService") + QString::fromLocal8Bit(metaEnum.valueToKey(err)) +
                m_control->errorString());
 }
 
 void elitesterzosmart::error(QLowEnergyController::Error err) {
 
     QMetaEnum metaEnum = QMetaEnum::fromType<QLowEnergyController::Error>();
-    emit debug(QStringLiteral("elitesterzosmart::error") + QString::fromLocal8Bit(metaEnum.valueToKey(err)) +
+    LOG_DEVICE(QStringLiteral("elitesterzosmart::error") + QString::fromLocal8Bit(metaEnum.valueToKey(err)) +
                m_control->errorString());
 }
 
 void elitesterzosmart::deviceDiscovered(const QBluetoothDeviceInfo &device) {
-    emit debug(QStringLiteral("Found new device: ") + device.name() + QStringLiteral(" (") +
+    LOG_DEVICE(QStringLiteral("Found new device: ") + device.name() + QStringLiteral(" (") +
                device.address().toString() + ')');
     {
         bluetoothDevice = device;
@@ -212,17 +213,17 @@ void elitesterzosmart::deviceDiscovered(const QBluetoothDeviceInfo &device) {
                 this, [this](QLowEnergyController::Error error) {
                     Q_UNUSED(error);
                     Q_UNUSED(this);
-                    emit debug(QStringLiteral("Cannot connect to remote device."));
+                    LOG_DEVICE(QStringLiteral("Cannot connect to remote device."));
                     emit disconnected();
                 });
         connect(m_control, &QLowEnergyController::connected, this, [this]() {
             Q_UNUSED(this);
-            emit debug(QStringLiteral("Controller connected. Search services..."));
+            LOG_DEVICE(QStringLiteral("Controller connected. Search services..."));
             m_control->discoverServices();
         });
         connect(m_control, &QLowEnergyController::disconnected, this, [this]() {
             Q_UNUSED(this);
-            emit debug(QStringLiteral("LowEnergy controller disconnected"));
+            LOG_DEVICE(QStringLiteral("LowEnergy controller disconnected"));
             emit disconnected();
         });
 
@@ -1,4 +1,5 @@
 #include "eslinkertreadmill.h"
+#include "logging.h"
 #include "keepawakehelper.h"
 #include "virtualtreadmill.h"
 #include <QBluetoothLocalDevice>
@@ -46,7 +47,7 @@ void eslinkertreadmill::writeCharacteristic(uint8_t *data, uint8_t data_len, con
         gattWriteCharacteristic, QByteArray((const char *)data, data_len), QLowEnergyService::WriteWithoutResponse);
 
     if (!disable_log) {
-        emit debug(QStringLiteral(" >> ") + QByteArray((const char *)data, data_len).toHex(' ') +
+        LOG_PACKET(QStringLiteral(" >> ") + QByteArray((const char *)data, data_len).toHex(' ') +
                    QStringLiteral(" // ") + info);
     }
 
@@ -55,7 +56,7 @@ void eslinkertreadmill::writeCharacteristic(uint8_t *data, uint8_t data_len, con
         loop.exec();
 
         if (timeout.isActive() == false)
-            emit debug(QStringLiteral(" exit for timeout"));
+            LOG_DEVICE(QStringLiteral(" exit for timeout"));
     }
 }
 
@@ -113,7 +114,7 @@ void eslinkertreadmill::update() {
         if (!firstInit && !virtualTreadMill) {
             bool virtual_device_enabled = settings.value(QStringLiteral("virtual_device_enabled"), true).toBool();
             if (virtual_device_enabled) {
-                emit debug(QStringLiteral("creating virtual treadmill interface..."));
+                LOG_DEVICE(QStringLiteral("creating virtual treadmill interface..."));
                 virtualTreadMill = new virtualtreadmill(this, noHeartService);
                 connect(virtualTreadMill, &virtualtreadmill::debug, this, &eslinkertreadmill::debug);
                 firstInit = 1;
@@ -132,7 +133,7 @@ void eslinkertreadmill::update() {
         if (treadmill_type == TYPE::RHYTHM_FUN) {
             if (requestSpeed != -1) {
                 if (requestSpeed != currentSpeed().value() && requestSpeed >= 0 && requestSpeed <= 22) {
-                    emit debug(QStringLiteral("writing speed ") + QString::number(requestSpeed));
+                    LOG_DEVICE(QStringLiteral("writing speed ") + QString::number(requestSpeed));
                     // double inc = Inclination.value(); // NOTE: clang-analyzer-deadcode.DeadStores
                     if (requestInclination != -1) {
                         //                        inc = requestInclination;
@@ -145,7 +146,7 @@ void eslinkertreadmill::update() {
             if (requestInclination != -1) {
                 if (requestInclination != currentInclination().value() && requestInclination >= 0 &&
                     requestInclination <= 15) {
-                    emit debug(QStringLiteral("writing incline ") + QString::number(requestInclination));
+                    LOG_DEVICE(QStringLiteral("writing incline ") + QString::number(requestInclination));
                     // double speed = currentSpeed().value(); // NOTE: clang-analyzer-deadcode.DeadStores
                     if (requestSpeed != -1) {
                         // speed = requestSpeed;
@@ -196,7 +197,7 @@ void eslinkertreadmill::update() {
         }
 
         if (requestStart != -1) {
-            emit debug(QStringLiteral("starting..."));
+            LOG_DEVICE(QStringLiteral("starting..."));
             if (lastSpeed == 0.0) {
                 lastSpeed = 0.5;
             }
@@ -208,7 +209,7 @@ void eslinkertreadmill::update() {
         }
         if (requestStop != -1) {
             requestSpeed = 0;
-            emit debug(QStringLiteral("stopping..."));
+            LOG_DEVICE(QStringLiteral("stopping..."));
             // writeCharacteristic(initDataF0C800B8, sizeof(initDataF0C800B8), "stop tape", false, true);
             requestStop = -1;
         }
@@ -216,7 +217,7 @@ void eslinkertreadmill::update() {
 }
 
 void eslinkertreadmill::serviceDiscovered(const QBluetoothUuid &gatt) {
-    emit debug(QStringLiteral("serviceDiscovered ") + gatt.toString());
+    LOG_DEVICE(QStringLiteral("serviceDiscovered ") + gatt.toString());
 }
 
 void eslinkertreadmill::characteristicChanged(const QLowEnergyCharacteristic &characteristic,
@@ -228,7 +229,7 @@ void eslinkertreadmill::characteristicChanged(const QLowEnergyCharacteristic &ch
     Q_UNUSED(characteristic);
     QByteArray value = newValue;
 
-    emit debug(QStringLiteral(" << ") + QString::number(value.length()) + QStringLiteral(" ") + value.toHex(' '));
+    LOG_PACKET(QStringLiteral(" << ") + QString::number(value.length()) + QStringLiteral(" ") + value.toHex(' '));
 
     emit packetReceived();
 
@@ -305,7 +306,7 @@ void eslinkertreadmill::characteristicChanged(const QLowEnergyCharacteristic &ch
                 if (heartRateBeltName.startsWith("Disabled"))
                     Heart = heart;
             }
-            emit debug(QStringLiteral("Current heart: ") + QString::number(Heart.value()));
+            LOG_DEVICE(QStringLiteral("Current heart: ") + QString::number(Heart.value()));
         }
     }
 
@@ -327,9 +328,9 @@ void eslinkertreadmill::characteristicChanged(const QLowEnergyCharacteristic &ch
             /*if(heartRateBeltName.startsWith("Disabled"))
             Heart = value.at(18);*/
         }
-        emit debug(QStringLiteral("Current speed: ") + QString::number(speed));
-        emit debug(QStringLiteral("Current incline: ") + QString::number(incline));
-        emit debug(QStringLiteral("Current KCal: ") + QString::number(kcal));
+        LOG_DEVICE(QStringLiteral("Current speed: ") + QString::number(speed));
+        LOG_DEVICE(QStringLiteral("Current incline: ") + QString::number(incline));
+        LOG_DEVICE(QStringLiteral("Current KCal: ") + QString::number(kcal));
         // debug("Current Distance: " + QString::number(distance));
 
         if (Speed.value() != speed) {
@@ -364,7 +365,7 @@ void eslinkertreadmill::characteristicChanged(const QLowEnergyCharacteristic &ch
                      (1000.0 / (lastTimeCharacteristicChanged.msecsTo(QDateTime::currentDateTime()))));
     }
 
-    emit debug(QStringLiteral("Current Distance Calculated: ") + QString::number(Distance.value()));
+    LOG_DEVICE(QStringLiteral("Current Distance Calculated: ") + QString::number(Distance.value()));
 
     if (m_control->error() != QLowEnergyController::NoError) {
         qDebug() << QStringLiteral("QLowEnergyController ERROR!!") << m_control->errorString();
@@ -442,7 +443,7 @@ void eslinkertreadmill::btinit(bool startTape) {
 
 void eslinkertreadmill::stateChanged(QLowEnergyService::ServiceState state) {
     QMetaEnum metaEnum = QMetaEnum::fromType<QLowEnergyService::ServiceState>();
-    emit debug(QStringLiteral("BTLE stateChanged ") + QString::fromLocal8Bit(metaEnum.valueToKey(state)));
+    LOG_DEVICE(QStringLiteral("BTLE stateChanged ") + QString::fromLocal8Bit(metaEnum.valueToKey(state)));
     if (state == QLowEnergyService::ServiceDiscovered) {
         QBluetoothUuid _gattWriteCharacteristicId((quint16)0xfff2);
         QBluetoothUuid _gattNotifyCharacteristicId((quint16)0xfff1);
@@ -474,7 +475,7 @@ void eslinkertreadmill::stateChanged(QLowEnergyService::ServiceState state) {
 }
 
 void eslinkertreadmill::descriptorWritten(const QLowEnergyDescriptor &descriptor, const QByteArray &newValue) {
-    emit debug(QStringLiteral("descriptorWritten ") + descriptor.name() + " " + newValue.toHex(' '));
+    LOG_PACKET(QStringLiteral("descriptorWritten ") + descriptor.name() + " " + newValue.toHex(' '));
 
     initRequest = true;
     emit connectedAndDiscovered();
@@ -483,11 +484,11 @@ void eslinkertreadmill::descriptorWritten(const QLowEnergyDescriptor &descriptor
 void eslinkertreadmill::characteristicWritten(const QLowEnergyCharacteristic &characteristic,
                                               const QByteArray &newValue) {
     Q_UNUSED(characteristic);
-    emit debug(QStringLiteral("characteristicWritten ") + newValue.toHex(' '));
+    LOG_PACKET(QStringLiteral("characteristicWritten ") + newValue.toHex(' '));
 }
 
 void eslinkertreadmill::serviceScanDone(void) {
-    emit debug(QStringLiteral("serviceScanDone"));
+    LOG_DEVICE(QStringLiteral("serviceScanDone"));
 
     QBluetoothUuid _gattCommunicationChannelServiceId((quint16)0xfff0);
     gattCommunicationChannelService = m_control->createServiceObject(_gattCommunicationChannelServiceId);
@@ -497,18 +498,18 @@ void eslinkertreadmill::serviceScanDone(void) {
 
 void eslinkertreadmill::errorService(QLowEnergyService::ServiceError err) {
     QMetaEnum metaEnum = QMetaEnum::fromType<QLowEnergyService::ServiceError>();
-    emit debug(QStringLiteral("eslinkertreadmill::errorService ") + QString::fromLocal8Bit(metaEnum.valueToKey(err)) +
+    LOG_DEVICE(QStringLiteral("eslinkertreadmill::errorService ") + QString::fromLocal8Bit(metaEnum.valueToKey(err)) +
                m_control->errorString());
 }
 
 void eslinkertreadmill::error(QLowEnergyController::Error err) {
     QMetaEnum metaEnum = QMetaEnum::fromType<QLowEnergyController::Error>();
-    emit debug(QStringLiteral("eslinkertreadmill::error ") + QString::fromLocal8Bit(metaEnum.valueToKey(err)) +
+    LOG_DEVICE(QStringLiteral("eslinkertreadmill::error ") + QString::fromLocal8Bit(metaEnum.valueToKey(err)) +
                m_control->errorString());
 }
 
 void eslinkertreadmill::deviceDiscovered(const QBluetoothDeviceInfo &device) {
-    emit debug(QStringLiteral("Found new device: ") + device.name() + QStringLiteral(" (") +
+    LOG_DEVICE(QStringLiteral("Found new device: ") + device.name() + QStringLiteral(" (") +
                device.address().toString() + ')');
     {
         bluetoothDevice = device;
@@ -525,17 +526,17 @@ void eslinkertreadmill::deviceDiscovered(const QBluetoothDeviceInfo &device) {
                 this, [this](QLowEnergyController::Error error) {
                     Q_UNUSED(error);
                     Q_UNUSED(this);
-                    emit debug(QStringLiteral("Cannot connect to remote device."));
+                    LOG_DEVICE(QStringLiteral("Cannot connect to remote device."));
                     emit disconnected();
                 });
         connect(m_control, &QLowEnergyController::connected, this, [this]() {
             Q_UNUSED(this);
-            emit debug(QStringLiteral("Controller connected. Search services..."));
+            LOG_DEVICE(QStringLiteral("Controller connected. Search services..."));
             m_control->discoverServices();
         });
         connect(m_control, &QLowEnergyController::disconnected, this, [this]() {
             Q_UNUSED(this);
-            emit debug(QStringLiteral("LowEnergy controller disconnected"));
+            LOG_DEVICE(QStringLiteral("LowEnergy controller disconnected"));
             emit disconnected();
         });
 
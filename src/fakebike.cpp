@@ -1,4 +1,5 @@
 #include "fakebike.h"
+#include "logging.h"
 #include "ios/lockscreen.h"
 #include "virtualbike.h"
 #include <QBluetoothLocalDevice>
@@ -33,6 +34,9 @@ void fakebike::update() {
     QString heartRateBeltName =
         settings.value(QStringLiteral("heart_rate_belt_name"), QStringLiteral("Disabled")).toString();
 
+    // there's no update_metrics here: the samples of the accessories are applied directly
+    applySensorFusion();
+
 
     // ******************************************* virtual bike init *************************************
     if (!firstStateChanged && !virtualBike && !noVirtualDevice
@@ -56,7 +60,7 @@ void fakebike::update() {
 #endif
 #endif
         if (virtual_device_enabled) {
-            emit debug(QStringLiteral("creating virtual bike interface..."));
+            LOG_DEVICE(QStringLiteral("creating virtual bike interface..."));
             virtualBike = new virtualbike(this, noWriteResistance, noHeartService);
             connect(virtualBike, &virtualbike::changeInclination, this,
                     &fakebike::changeInclinationRequested);
@@ -59,6 +59,7 @@ void fitplusbike::writeCharacteristic(uint8_t *data, uint8_t data_len, const QSt
         return;
     }
 
+    writeRequested(QByteArray((const char *)data, data_len));
     gattCommunicationChannelService->writeCharacteristic(gattWriteCharacteristic,
                                                          QByteArray((const char *)data, data_len));
 
@@ -147,6 +148,7 @@ void fitplusbike::update() {
 
             if (requestResistance != currentResistance().value()) {
                 qDebug() << QStringLiteral("writing resistance ") + QString::number(requestResistance);
+                requestQueued();
                 forceResistance(requestResistance);
             }
             requestResistance = -1;
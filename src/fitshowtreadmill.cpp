@@ -1,4 +1,6 @@
 #include "fitshowtreadmill.h"
+#include "logging.h"
+#include "framing.h"
 #include "ios/lockscreen.h"
 #include "keepawakehelper.h"
 #include "virtualtreadmill.h"
@@ -60,7 +62,7 @@ void fitshowtreadmill::writeCharacteristic(const uint8_t *data, uint8_t data_len
     QTimer timeout;
     QByteArray qba((const char *)data, data_len);
     if (!info.isEmpty()) {
-        emit debug(QStringLiteral(" >>") + qba.toHex(' ') + QStringLiteral(" // ") + info);
+        LOG_PACKET(QStringLiteral(" >>") + qba.toHex(' ') + QStringLiteral(" // ") + info);
     }
 
     connect(gattCommunicationChannelService, &QLowEnergyService::characteristicWritten, &loop, &QEventLoop::quit);
@@ -70,26 +72,14 @@ void fitshowtreadmill::writeCharacteristic(const uint8_t *data, uint8_t data_len
     loop.exec();
 
     if (timeout.isActive() == false) {
-        emit debug(QStringLiteral(" exit for timeout"));
+        LOG_DEVICE(QStringLiteral(" exit for timeout"));
     }
 }
 
-bool fitshowtreadmill::checkIncomingPacket(const uint8_t *data, uint8_t data_len) const {
-    if (data_len >= 4 && data[0] == FITSHOW_PKT_HEADER && data[data_len - 1] == FITSHOW_PKT_FOOTER) {
-        int n4 = 0;
-        int n5 = 1;
-        int n6 = data_len - 2;
-
-        while (true) {
-            if (n5 >= n6) {
-                break;
-            }
-            n4 ^= data[n5];
-            ++n5;
-        }
-        return n4 == data[n6];
-    } else
-        return false;
+bool fitshowtreadmill::checkIncomingPacket(const uint8_t *data, uint8_t data_len) {
+    // header | payload | xor of the payload | footer
+    return data_len >= 4 && data[0] == FITSHOW_PKT_HEADER && data[data_len - 1] == FITSHOW_PKT_FOOTER &&
+           xor8checksum<1>::verify(data, data_len - 1);
 }
 
 bool fitshowtreadmill::writePayload(const uint8_t *array, uint8_t size, const QString &info) {
@@ -98,12 +88,8 @@ bool fitshowtreadmill::writePayload(const uint8_t *array, uint8_t size, const QS
     }
     uint8_t array2[BLE_SERIALOUTPUT_MAXSIZE];
     array2[0] = FITSHOW_PKT_HEADER;
-    uint8_t n = 0, i = 0;
-    while (i < size) {
-        array2[i + 1] = array[i];
-        n ^= array[i++];
-    }
-    array2[size + 1] = n;
+    memcpy(array2 + 1, array, size);
+    xor8checksum<1>::seal(array2, size + 2);
     array2[size + 2] = FITSHOW_PKT_FOOTER;
     writeCharacteristic(array2, size + 3, info);
     return true;
@@ -148,7 +134,7 @@ void fitshowtreadmill::update() {
         if (!firstInit && searchStopped && !virtualTreadMill) {
             bool virtual_device_enabled = settings.value(QStringLiteral("virtual_device_enabled"), true).toBool();
             if (virtual_device_enabled) {
-                emit debug(QStringLiteral("creating virtual treadmill interface..."));
+                LOG_DEVICE(QStringLiteral("creating virtual treadmill interface..."));
                 virtualTreadMill = new virtualtreadmill(this, noHeartService);
                 connect(virtualTreadMill, &virtualtreadmill::debug, this, &fitshowtreadmill::debug);
 
@@ -157,13 +143,13 @@ void fitshowtreadmill::update() {
         }
         // ********************************************************************************************************
 
-        emit debug(QStringLiteral("fitshow Treadmill RSSI ") + QString::number(bluetoothDevice.rssi()));
+        LOG_DEVICE(QStringLiteral("fitshow Treadmill RSSI ") + QString::number(bluetoothDevice.rssi()));
 
         update_metrics(true, watts(settings.value(QStringLiteral("weight"), 75.0).toFloat()));
 
         if (requestSpeed != -1) {
             if (requestSpeed != currentSpeed().value()) {
-                emit debug(QStringLiteral("writing speed ") + QString::number(requestSpeed));
+                LOG_DEVICE(QStringLiteral("writing speed ") + QString::number(requestSpeed));
                 double inc = currentInclination().value();
                 if (requestInclination != -1) {
                     int diffInc = (int)(requestInclination - inc);
@@ -186,7 +172,7 @@ void fitshowtreadmill::update() {
         if (requestInclination != -1) {
             double inc = currentInclination().value();
             if (requestInclination != inc) {
-                emit debug(QStringLiteral("writing incline ") + QString::number(requestInclination));
+                LOG_DEVICE(QStringLiteral("writing incline ") + QString::number(requestInclination));
                 int diffInc = (int)(requestInclination - inc);
                 if (!diffInc) {
                     if (requestInclination > inc) {
@@ -207,7 +193,7 @@ void fitshowtreadmill::update() {
             requestInclination = -1;
         }
         if (requestStart != -1) {
-            emit debug(QStringLiteral("starting..."));
+            LOG_DEVICE(QStringLiteral("starting..."));
             if (lastSpeed == 0.0) {
                 lastSpeed = 0.5;
             }
@@ -217,13 +203,13 @@ void fitshowtreadmill::update() {
         }
         if (requestStop != -1) {
             uint8_t stopTape[] = {FITSHOW_SYS_CONTROL, FITSHOW_CONTROL_STOP}; // to verify
-            emit debug(QStringLiteral("stopping..."));
+            LOG_DEVICE(QStringLiteral("stopping..."));
             scheduleWrite(stopTape, sizeof(stopTape), QStringLiteral("stop tape"));
             requestStop = -1;
         }
 
         if (retrySend >= 6) { // 3 retries
-            emit debug(QStringLiteral("WARNING: answer not received for command "
+            LOG_DEVICE(QStringLiteral("WARNING: answer not received for command "
                                       "%1 / %2 (%3)")
                            .arg(((uint8_t)bufferWrite.at(1)), 2, 16, QChar('0'))
                            .arg(((uint8_t)bufferWrite.at(2)), 2, 16, QChar('0'))
@@ -255,7 +241,7 @@ void fitshowtreadmill::removeFromBuffer() {
 
 void fitshowtreadmill::serviceDiscovered(const QBluetoothUuid &gatt) {
     uint32_t servRepr = gatt.toUInt32();
-    emit debug(QStringLiteral("serviceDiscovered ") + gatt.toString() + QStringLiteral(" ") +
+    LOG_DEVICE(QStringLiteral("serviceDiscovered ") + gatt.toString() + QStringLiteral(" ") +
                QString::number(servRepr));
     if (servRepr == 0xfff0 || (servRepr == 0xffe0 && serviceId.isNull())) {
         serviceId = gatt; // NOTE: clazy-rule-of-tow
@@ -276,16 +262,16 @@ void fitshowtreadmill::characteristicChanged(const QLowEnergyCharacteristic &cha
     Q_UNUSED(characteristic);
     QByteArray value = newValue;
 
-    emit debug(QStringLiteral(" << ") + QString::number(value.length()) + QStringLiteral(" ") + value.toHex(' '));
+    LOG_PACKET(QStringLiteral(" << ") + QString::number(value.length()) + QStringLiteral(" ") + value.toHex(' '));
 
-    emit debug(QStringLiteral("packetReceived!"));
+    LOG_DEVICE(QStringLiteral("packetReceived!"));
     emit packetReceived();
 
     lastPacket = value;
     const uint8_t *full_array = (uint8_t *)value.constData();
     uint8_t full_len = value.length();
     if (!checkIncomingPacket(full_array, full_len)) {
-        emit debug(QStringLiteral("Invalid packet"));
+        LOG_DEVICE(QStringLiteral("Invalid packet"));
         return;
     }
     const uint8_t *array = full_array + 1;
@@ -302,7 +288,7 @@ void fitshowtreadmill::characteristicChanged(const QLowEnergyCharacteristic &cha
             if (full_len > 6) {
                 MAX_SPEED = full_array[3];
                 MIN_SPEED = full_array[4];
-                emit debug(QStringLiteral("Speed between ") + QString::number(MIN_SPEED) + QStringLiteral(" and ") +
+                LOG_DEVICE(QStringLiteral("Speed between ") + QString::number(MIN_SPEED) + QStringLiteral(" and ") +
                            QString::number(MAX_SPEED));
                 if (full_len > 7) {
                     UNIT = full_array[5];
@@ -311,14 +297,14 @@ void fitshowtreadmill::characteristicChanged(const QLowEnergyCharacteristic &cha
         } else if (par == FITSHOW_INFO_INCLINE) {
             if (full_len < 7) {
                 MAX_INCLINE = 0;
-                emit debug(QStringLiteral("Incline not supported"));
+                LOG_DEVICE(QStringLiteral("Incline not supported"));
             } else {
                 MAX_INCLINE = full_array[3];
                 MIN_INCLINE = full_array[4];
                 if (full_len > 7 && (full_array[5] & 0x2) != 0x0) {
                     IS_PAUSE = true;
                 }
-                emit debug(QStringLiteral("Incline between ") + QString::number(MIN_INCLINE) + QStringLiteral(" and ") +
+                LOG_DEVICE(QStringLiteral("Incline between ") + QString::number(MIN_INCLINE) + QStringLiteral(" and ") +
                            QString::number(MAX_INCLINE));
             }
         } else if (par == FITSHOW_INFO_MODEL) {
@@ -327,26 +313,26 @@ void fitshowtreadmill::characteristicChanged(const QLowEnergyCharacteristic &cha
                 DEVICE_ID_NAME = QStringLiteral("%1-%2")
                                      .arg(full_array[3], 2, 16, QLatin1Char('0'))
                                      .arg(second, 4, 16, QLatin1Char('0'));
-                emit debug(QStringLiteral("DEVICE ") + DEVICE_ID_NAME);
+                LOG_DEVICE(QStringLiteral("DEVICE ") + DEVICE_ID_NAME);
             }
         } else if (par == FITSHOW_INFO_TOTAL) {
             if (full_len > 8) {
                 TOTAL = (full_array[6] << 24 | full_array[5] << 16 | full_array[4] << 8 | full_array[3]);
-                emit debug(QStringLiteral("TOTAL ") + QString::number(TOTAL));
+                LOG_DEVICE(QStringLiteral("TOTAL ") + QString::number(TOTAL));
             } else {
                 TOTAL = -1;
             }
         } else if (par == FITSHOW_INFO_DATE) {
             if (full_len > 7) {
                 FACTORY_DATE = QDate(full_array[3] + 2000, full_array[4], full_array[5]);
-                emit debug(QStringLiteral("DATE ") + FACTORY_DATE.toString());
+                LOG_DEVICE(QStringLiteral("DATE ") + FACTORY_DATE.toString());
             } else {
                 FACTORY_DATE = QDate();
             }
         }
     } else if (cmd == FITSHOW_SYS_CONTROL) {
         SYS_CONTROL_CMD = par;
-        emit debug(QStringLiteral("SYS_CONTROL received ok: par ") + QString::number(par));
+        LOG_DEVICE(QStringLiteral("SYS_CONTROL received ok: par ") + QString::number(par));
         if (par == FITSHOW_CONTROL_TARGET_OR_RUN) {
             QString dbg;
             if (full_len > 5) {
@@ -355,16 +341,16 @@ void fitshowtreadmill::characteristicChanged(const QLowEnergyCharacteristic &cha
                     dbg += QStringLiteral("; actual incline: ") + QString::number(full_array[4]);
                 }
             }
-            emit debug(dbg);
+            LOG_DEVICE(dbg);
         }
     }
     if (cmd == FITSHOW_SYS_STATUS) {
         CURRENT_STATUS = par;
-        emit debug(QStringLiteral("STATUS ") + QString::number(par));
+        LOG_DEVICE(QStringLiteral("STATUS ") + QString::number(par));
         if (par == FITSHOW_STATUS_START) {
             if (len > 2) {
                 COUNTDOWN_VALUE = array[2];
-                emit debug(QStringLiteral("CONTDOWN ") + QString::number(COUNTDOWN_VALUE));
+                LOG_DEVICE(QStringLiteral("CONTDOWN ") + QString::number(COUNTDOWN_VALUE));
             }
         } else if (par == FITSHOW_STATUS_RUNNING || par == FITSHOW_STATUS_STOP || par == FITSHOW_STATUS_PAUSED ||
                    par == FITSHOW_STATUS_END) {
@@ -398,14 +384,14 @@ void fitshowtreadmill::characteristicChanged(const QLowEnergyCharacteristic &cha
                          (1000.0 / (lastTimeCharacteristicChanged.msecsTo(QDateTime::currentDateTime()))));
                 }
 
-                emit debug(QStringLiteral("Current elapsed from treadmill: ") + QString::number(seconds_elapsed));
-                emit debug(QStringLiteral("Current speed: ") + QString::number(speed));
-                emit debug(QStringLiteral("Current incline: ") + QString::number(incline));
-                emit debug(QStringLiteral("Current heart: ") + QString::number(heart));
-                emit debug(QStringLiteral("Current Distance: ") + QString::number(distance));
-                emit debug(QStringLiteral("Current Distance Calculated: ") + QString::number(DistanceCalculated));
-                emit debug(QStringLiteral("Current KCal: ") + QString::number(kcal));
-                emit debug(QStringLiteral("Current step countl: ") + QString::number(step_count));
+                LOG_DEVICE(QStringLiteral("Current elapsed from treadmill: ") + QString::number(seconds_elapsed));
+                LOG_DEVICE(QStringLiteral("Current speed: ") + QString::number(speed));
+                LOG_DEVICE(QStringLiteral("Current incline: ") + QString::number(incline));
+                LOG_DEVICE(QStringLiteral("Current heart: ") + QString::number(heart));
+                LOG_DEVICE(QStringLiteral("Current Distance: ") + QString::number(distance));
+                LOG_DEVICE(QStringLiteral("Current Distance Calculated: ") + QString::number(DistanceCalculated));
+                LOG_DEVICE(QStringLiteral("Current KCal: ") + QString::number(kcal));
+                LOG_DEVICE(QStringLiteral("Current step countl: ") + QString::number(step_count));
 
                 if (m_control->error() != QLowEnergyController::NoError) {
                     qDebug() << QStringLiteral("QLowEnergyController ERROR!!") << m_control->errorString();
@@ -505,14 +491,14 @@ void fitshowtreadmill::characteristicChanged(const QLowEnergyCharacteristic &cha
                 } else {
                     INDOORRUN_MODE = 0;
                 }
-                emit debug(QStringLiteral("USER_ID = %1").arg(USER_ID));
-                emit debug(QStringLiteral("SPORT_ID = %1").arg(SPORT_ID));
-                emit debug(QStringLiteral("RUN_WAY = %1").arg(RUN_WAY));
-                emit debug(QStringLiteral("INDOORRUN_MODE = %1").arg(INDOORRUN_MODE));
-                emit debug(QStringLiteral("INDOORRUN_TIME_DATA = %1").arg(INDOORRUN_TIME_DATA));
-                emit debug(QStringLiteral("INDOORRUN_PARAM_NUM = %1").arg(INDOORRUN_PARAM_NUM));
-                emit debug(QStringLiteral("INDOORRUN_CALORIE_DATA = %1").arg(INDOORRUN_CALORIE_DATA));
-                emit debug(QStringLiteral("INDOORRUN_DISTANCE_DATA = %1").arg(INDOORRUN_DISTANCE_DATA));
+                LOG_DEVICE(QStringLiteral("USER_ID = %1").arg(USER_ID));
+                LOG_DEVICE(QStringLiteral("SPORT_ID = %1").arg(SPORT_ID));
+                LOG_DEVICE(QStringLiteral("RUN_WAY = %1").arg(RUN_WAY));
+                LOG_DEVICE(QStringLiteral("INDOORRUN_MODE = %1").arg(INDOORRUN_MODE));
+                LOG_DEVICE(QStringLiteral("INDOORRUN_TIME_DATA = %1").arg(INDOORRUN_TIME_DATA));
+                LOG_DEVICE(QStringLiteral("INDOORRUN_PARAM_NUM = %1").arg(INDOORRUN_PARAM_NUM));
+                LOG_DEVICE(QStringLiteral("INDOORRUN_CALORIE_DATA = %1").arg(INDOORRUN_CALORIE_DATA));
+                LOG_DEVICE(QStringLiteral("INDOORRUN_DISTANCE_DATA = %1").arg(INDOORRUN_DISTANCE_DATA));
             }
         } else if (par == FITSHOW_DATA_SPORT) {
             if (len > 9) {
@@ -521,10 +507,10 @@ void fitshowtreadmill::characteristicChanged(const QLowEnergyCharacteristic &cha
                 double distance = array[4] | array[5] << 8;
                 uint16_t step_count = array[8] | array[9] << 8;
 
-                emit debug(QStringLiteral("Current elapsed from treadmill: ") + QString::number(seconds_elapsed));
-                emit debug(QStringLiteral("Current step countl: ") + QString::number(step_count));
-                emit debug(QStringLiteral("Current KCal: ") + QString::number(kcal));
-                emit debug(QStringLiteral("Current Distance: ") + QString::number(distance));
+                LOG_DEVICE(QStringLiteral("Current elapsed from treadmill: ") + QString::number(seconds_elapsed));
+                LOG_DEVICE(QStringLiteral("Current step countl: ") + QString::number(step_count));
+                LOG_DEVICE(QStringLiteral("Current KCal: ") + QString::number(kcal));
+                LOG_DEVICE(QStringLiteral("Current Distance: ") + QString::number(distance));
                 KCal = kcal;
                 elapsed = seconds_elapsed;
                 Distance = distance;
@@ -591,7 +577,7 @@ void fitshowtreadmill::btinit(bool startTape) {
 
 void fitshowtreadmill::stateChanged(QLowEnergyService::ServiceState state) {
     QMetaEnum metaEnum = QMetaEnum::fromType<QLowEnergyService::ServiceState>();
-    emit debug(QStringLiteral("BTLE stateChanged ") + QString::fromLocal8Bit(metaEnum.valueToKey(state)));
+    LOG_DEVICE(QStringLiteral("BTLE stateChanged ") + QString::fromLocal8Bit(metaEnum.valueToKey(state)));
     if (state == QLowEnergyService::ServiceDiscovered) {
         uint32_t id32;
         auto characteristics_list = gattCommunicationChannelService->characteristics();
@@ -638,7 +624,7 @@ void fitshowtreadmill::stateChanged(QLowEnergyService::ServiceState state) {
 }
 
 void fitshowtreadmill::descriptorWritten(const QLowEnergyDescriptor &descriptor, const QByteArray &newValue) {
-    emit debug(QStringLiteral("descriptorWritten ") + descriptor.name() + QStringLiteral(" ") + newValue.toHex(' '));
+    LOG_PACKET(QStringLiteral("descriptorWritten ") + descriptor.name() + QStringLiteral(" ") + newValue.toHex(' '));
 
     initRequest = true;
     emit connectedAndDiscovered();
@@ -647,11 +633,11 @@ void fitshowtreadmill::descriptorWritten(const QLowEnergyDescriptor &descriptor,
 void fitshowtreadmill::characteristicWritten(const QLowEnergyCharacteristic &characteristic,
                                              const QByteArray &newValue) {
     Q_UNUSED(characteristic);
-    emit debug(QStringLiteral("characteristicWritten ") + newValue.toHex(' '));
+    LOG_PACKET(QStringLiteral("characteristicWritten ") + newValue.toHex(' '));
 }
 
 void fitshowtreadmill::serviceScanDone(void) {
-    emit debug(QStringLiteral("serviceScanDone"));
+    LOG_DEVICE(QStringLiteral("serviceScanDone"));
 
     gattCommunicationChannelService = m_control->createServiceObject(serviceId);
     connect(gattCommunicationChannelService, &QLowEnergyService::stateChanged, this, &fitshowtreadmill::stateChanged);
@@ -665,18 +651,18 @@ void fitshowtreadmill::serviceScanDone(void) {
 
 void fitshowtreadmill::errorService(QLowEnergyService::ServiceError err) {
     QMetaEnum metaEnum = QMetaEnum::fromType<QLowEnergyService::ServiceError>();
-    emit debug(QStringLiteral("fitshowtreadmill::errorService ") + QString::fromLocal8Bit(metaEnum.valueToKey(err)) +
+    LOG_DEVICE(QStringLiteral("fitshowtreadmill::errorService ") + QString::fromLocal8Bit(metaEnum.valueToKey(err)) +
                m_control->errorString());
 }
 
 void fitshowtreadmill::error(QLowEnergyController::Error err) {
     QMetaEnum metaEnum = QMetaEnum::fromType<QLowEnergyController::Error>();
-    emit debug(QStringLiteral("fitshowtreadmill::error ") + QString::fromLocal8Bit(metaEnum.valueToKey(err)) +
+    LOG_DEVICE(QStringLiteral("fitshowtreadmill::error ") + QString::fromLocal8Bit(metaEnum.valueToKey(err)) +
                m_control->errorString());
 }
 
 void fitshowtreadmill::deviceDiscovered(const QBluetoothDeviceInfo &device) {
-    emit debug(QStringLiteral("Found new device: ") + device.name() + QStringLiteral(" (") +
+    LOG_DEVICE(QStringLiteral("Found new device: ") + device.name() + QStringLiteral(" (") +
                device.address().toString() + ')');
     if (device.name().startsWith(QStringLiteral("FS-")) ||
         (device.name().startsWith(QStringLiteral("SW")) && device.name().length() == 14)) {
@@ -694,18 +680,18 @@ void fitshowtreadmill::deviceDiscovered(const QBluetoothDeviceInfo &device) {
                 this, [this](QLowEnergyController::Error error) {
                     Q_UNUSED(error);
                     Q_UNUSED(this);
-                    emit debug(QStringLiteral("Cannot connect to remote device."));
+                    LOG_DEVICE(QStringLiteral("Cannot connect to remote device."));
                     searchStopped = false;
                     emit disconnected();
                 });
         connect(m_control, &QLowEnergyController::connected, this, [this]() {
             Q_UNUSED(this);
-            emit debug(QStringLiteral("Controller connected. Search services..."));
+            LOG_DEVICE(QStringLiteral("Controller connected. Search services..."));
             m_control->discoverServices();
         });
         connect(m_control, &QLowEnergyController::disconnected, this, [this]() {
             Q_UNUSED(this);
-            emit debug(QStringLiteral("LowEnergy controller disconnected"));
+            LOG_DEVICE(QStringLiteral("LowEnergy controller disconnected"));
             searchStopped = false;
             emit disconnected();
         });
@@ -86,8 +86,9 @@ class fitshowtreadmill : public treadmill {
     void *VirtualTreadMill();
     void *VirtualDevice();
 
+    static bool checkIncomingPacket(const uint8_t *data, uint8_t data_len);
+
   private:
-    bool checkIncomingPacket(const uint8_t *data, uint8_t data_len) const;
     void forceSpeedOrIncline(double requestSpeed, double requestIncline);
     void btinit(bool startTape);
     void writeCharacteristic(const uint8_t *data, uint8_t data_len, const QString &info = QString());
@@ -1,4 +1,5 @@
 #include "flywheelbike.h"
+#include "logging.h"
 #include "ios/lockscreen.h"
 #include "keepawakehelper.h"
 #include "virtualbike.h"
@@ -12,6 +13,8 @@
 
 using namespace std::chrono_literals;
 
+const lengthframespec flywheelbike::frameSpec = {0xff, 1, 3, 1, true, -1};
+
 flywheelbike::flywheelbike(bool noWriteResistance, bool noHeartService) {
     m_watt.setType(metric::METRIC_WATT);
     Speed.setType(metric::METRIC_SPEED);
@@ -35,11 +38,12 @@ void flywheelbike::writeCharacteristic(uint8_t *data, uint8_t data_len, const QS
         timeout.singleShot(300ms, &loop, &QEventLoop::quit);
     }
 
+    writeRequested(QByteArray((const char *)data, data_len));
     gattCommunicationChannelService->writeCharacteristic(gattWriteCharacteristic,
                                                          QByteArray((const char *)data, data_len));
 
     if (!disable_log) {
-        emit debug(QStringLiteral(" >> ") + QByteArray((const char *)data, data_len).toHex(' ') +
+        LOG_PACKET(QStringLiteral(" >> ") + QByteArray((const char *)data, data_len).toHex(' ') +
                    QStringLiteral(" // ") + info);
     }
 
@@ -82,13 +86,13 @@ void flywheelbike::update() {
             }
 
             if (requestResistance != currentResistance().value()) {
-                emit debug(QStringLiteral("writing resistance ") + QString::number(requestResistance));
+                LOG_DEVICE(QStringLiteral("writing resistance ") + QString::number(requestResistance));
                 // forceResistance(requestResistance);
             }
             requestResistance = -1;
         }
         if (requestStart != -1) {
-            emit debug(QStringLiteral("starting..."));
+            LOG_DEVICE(QStringLiteral("starting..."));
 
             // btinit();
 
@@ -96,7 +100,7 @@ void flywheelbike::update() {
             emit bikeStarted();
         }
         if (requestStop != -1) {
-            emit debug(QStringLiteral("stopping..."));
+            LOG_DEVICE(QStringLiteral("stopping..."));
             // writeCharacteristic(initDataF0C800B8, sizeof(initDataF0C800B8), "stop tape");
             requestStop = -1;
         }
@@ -104,7 +108,7 @@ void flywheelbike::update() {
 }
 
 void flywheelbike::serviceDiscovered(const QBluetoothUuid &gatt) {
-    emit debug(QStringLiteral("serviceDiscovered ") + gatt.toString());
+    LOG_DEVICE(QStringLiteral("serviceDiscovered ") + gatt.toString());
 }
 
 void flywheelbike::flushDataframe(BikeDataframe *dataFrame) {
@@ -116,66 +120,19 @@ void flywheelbike::flushDataframe(BikeDataframe *dataFrame) {
 }
 
 void flywheelbike::decodeReceivedData(QByteArray buffer) {
-    for (int i = 0; i < buffer.length(); ++i) {
-        int8_t b = buffer[i];
-
-        qDebug() << QStringLiteral("rxState") << rxState << b;
-        switch (rxState) {
-        case WFSYNC_1:
-            if (b == -1) {
-                flushDataframe(&bikeData);
-                errorState = MSG_NO_ERROR;
-                rxState = WFLENGTH;
-            } else {
-                errorState = MSG_NO_ERROR;
-                rxState = WFSYNC_1;
-            }
-            break;
-        case WFLENGTH:
-            if (b == 0) {
-                errorState = MSG_WFSIZE;
-                rxState = WFSYNC_1;
-            } else {
-                dataPacketIndex = 0;
-                dataPacketLength = b;
-                bikeData.len = b - 2;
-                rxState = WFID;
-            }
-            break;
-        case WFID:
-            if (b >= 0) {
-                bikeData.message_id = b;
-                if (dataPacketLength != 0) {
-                    rxState = DATA;
-                } else {
-                    rxState = CHECKSUM;
-                }
-            } else {
-                errorState = MSG_UNKNOWN_ID;
-                rxState = WFSYNC_1;
-            }
-            break;
-        case DATA:
-            if (dataPacketLength == 0) {
-                rxState = CHECKSUM;
-            }
-
-            bikeData.buffer[dataPacketIndex] = b;
-            dataPacketIndex++;
-            dataPacketLength--;
-            break;
-        case CHECKSUM:
-            /* TODO: Implement checksum */
-            rxState = EOF_1;
-            break;
-        case EOF_1:
-            /* End of frame byte is 0x55 */
-            if (b == 0x55) {
-                errorState = MSG_COMPLETE;
-                rxState = WFSYNC_1;
-            }
-            break;
+    errorState = MSG_NO_ERROR;
+    for (const QByteArray &frame : frames.feed(buffer)) {
+        // the ids are 7 bits
+        if ((uint8_t)frame.at(2) & 0x80) {
+            qDebug() << QStringLiteral("unknown message id") << frame.toHex(' ');
+            continue;
         }
+        QByteArray payload = frames.payload(frame);
+        flushDataframe(&bikeData);
+        bikeData.message_id = frame.at(2);
+        bikeData.len = (uint8_t)frame.at(1) - 2;
+        memcpy(bikeData.buffer, payload.constData(), qMin(payload.length(), (int)sizeof(bikeData.buffer)));
+        errorState = MSG_COMPLETE;
     }
 }
 
@@ -226,14 +183,14 @@ void flywheelbike::updateStats() {
 #endif
 #endif
 
-    emit debug(QStringLiteral("Current Resistance: ") + QString::number(Resistance.value()));
-    emit debug(QStringLiteral("Current Speed: ") + QString::number(Speed.value()));
-    emit debug(QStringLiteral("Current Calculate Distance: ") + QString::number(Distance.value()));
-    emit debug("Current Cadence: " + QString::number(Cadence.value()));
+    LOG_DEVICE(QStringLiteral("Current Resistance: ") + QString::number(Resistance.value()));
+    LOG_DEVICE(QStringLiteral("Current Speed: ") + QString::number(Speed.value()));
+    LOG_DEVICE(QStringLiteral("Current Calculate Distance: ") + QString::number(Distance.value()));
+    LOG_DEVICE("Current Cadence: " + QString::number(Cadence.value()));
     // debug("Current Distance: " + QString::number(distance));
-    emit debug(QStringLiteral("Current CrankRevs: ") + QString::number(CrankRevs));
-    emit debug(QStringLiteral("Last CrankEventTime: ") + QString::number(LastCrankEventTime));
-    emit debug(QStringLiteral("Current Watt: ") + QString::number(watts()));
+    LOG_DEVICE(QStringLiteral("Current CrankRevs: ") + QString::number(CrankRevs));
+    LOG_DEVICE(QStringLiteral("Last CrankEventTime: ") + QString::number(LastCrankEventTime));
+    LOG_DEVICE(QStringLiteral("Current Watt: ") + QString::number(watts()));
 
     if (m_control->error() != QLowEnergyController::NoError) {
         qDebug() << QStringLiteral("QLowEnergyController ERROR!!") << m_control->errorString();
@@ -248,7 +205,7 @@ void flywheelbike::characteristicChanged(const QLowEnergyCharacteristic &charact
     //    QString heartRateBeltName = settings.value(QStringLiteral("heart_rate_belt_name"), QStringLiteral("Disabled"))
     //                                    .toString(); // NOTE: clazy-unused-non-trivial-variable
 
-    emit debug(QStringLiteral(" << ") + newValue.toHex(' '));
+    LOG_PACKET(QStringLiteral(" << ") + newValue.toHex(' '));
 
     lastPacket = newValue;
 
@@ -336,7 +293,7 @@ void flywheelbike::stateChanged(QLowEnergyService::ServiceState state) {
     QBluetoothUuid _gattNotify1CharacteristicId(QStringLiteral("6E400003-B5A3-F393-E0A9-E50E24DCCA9E"));
 
     QMetaEnum metaEnum = QMetaEnum::fromType<QLowEnergyService::ServiceState>();
-    emit debug(QStringLiteral("BTLE stateChanged ") + QString::fromLocal8Bit(metaEnum.valueToKey(state)));
+    LOG_DEVICE(QStringLiteral("BTLE stateChanged ") + QString::fromLocal8Bit(metaEnum.valueToKey(state)));
 
     if (state == QLowEnergyService::ServiceDiscovered) {
         // qDebug() << gattCommunicationChannelService->characteristics();
@@ -379,7 +336,7 @@ void flywheelbike::stateChanged(QLowEnergyService::ServiceState state) {
 #endif
 #endif
                 if (virtual_device_enabled) {
-                emit debug(QStringLiteral("creating virtual bike interface..."));
+                LOG_DEVICE(QStringLiteral("creating virtual bike interface..."));
                 virtualBike = new virtualbike(this, noWriteResistance, noHeartService);
                 // connect(virtualBike,&virtualbike::debug ,this,&flywheelbike::debug);
                 connect(virtualBike, &virtualbike::changeInclination, this, &flywheelbike::changeInclination);
@@ -397,7 +354,7 @@ void flywheelbike::stateChanged(QLowEnergyService::ServiceState state) {
 }
 
 void flywheelbike::descriptorWritten(const QLowEnergyDescriptor &descriptor, const QByteArray &newValue) {
-    emit debug(QStringLiteral("descriptorWritten ") + descriptor.name() + QStringLiteral(" ") + newValue.toHex(' '));
+    LOG_PACKET(QStringLiteral("descriptorWritten ") + descriptor.name() + QStringLiteral(" ") + newValue.toHex(' '));
 
     initRequest = true;
     emit connectedAndDiscovered();
@@ -405,11 +362,11 @@ void flywheelbike::descriptorWritten(const QLowEnergyDescriptor &descriptor, con
 
 void flywheelbike::characteristicWritten(const QLowEnergyCharacteristic &characteristic, const QByteArray &newValue) {
     Q_UNUSED(characteristic);
-    emit debug(QStringLiteral("characteristicWritten ") + newValue.toHex(' '));
+    LOG_PACKET(QStringLiteral("characteristicWritten ") + newValue.toHex(' '));
 }
 
 void flywheelbike::serviceScanDone(void) {
-    emit debug(QStringLiteral("serviceScanDone"));
+    LOG_DEVICE(QStringLiteral("serviceScanDone"));
 
     QBluetoothUuid _gattCommunicationChannelServiceId(QStringLiteral("6E400001-B5A3-F393-E0A9-E50E24DCCA9E"));
 
@@ -420,18 +377,18 @@ void flywheelbike::serviceScanDone(void) {
 
 void flywheelbike::errorService(QLowEnergyService::ServiceError err) {
     QMetaEnum metaEnum = QMetaEnum::fromType<QLowEnergyService::ServiceError>();
-    emit debug(QStringLiteral("flywheelbike::errorService") + QString::fromLocal8Bit(metaEnum.valueToKey(err)) +
+    LOG_DEVICE(QStringLiteral("flywheelbike::errorService") + QString::fromLocal8Bit(metaEnum.valueToKey(err)) +
                m_control->errorString());
 }
 
 void flywheelbike::error(QLowEnergyController::Error err) {
     QMetaEnum metaEnum = QMetaEnum::fromType<QLowEnergyController::Error>();
-    emit debug(QStringLiteral("flywheelbike::error") + QString::fromLocal8Bit(metaEnum.valueToKey(err)) +
+    LOG_DEVICE(QStringLiteral("flywheelbike::error") + QString::fromLocal8Bit(metaEnum.valueToKey(err)) +
                m_control->errorString());
 }
 
 void flywheelbike::deviceDiscovered(const QBluetoothDeviceInfo &device) {
-    emit debug(QStringLiteral("Found new device: ") + device.name() + QStringLiteral(" (") +
+    LOG_DEVICE(QStringLiteral("Found new device: ") + device.name() + QStringLiteral(" (") +
                device.address().toString() + ')');
     // if (device.name().startsWith(QStringLiteral("Flywheel")))
     {
@@ -450,17 +407,17 @@ void flywheelbike::deviceDiscovered(const QBluetoothDeviceInfo &device) {
                 this, [this](QLowEnergyController::Error error) {
                     Q_UNUSED(error);
                     Q_UNUSED(this);
-                    emit debug(QStringLiteral("Cannot connect to remote device."));
+                    LOG_DEVICE(QStringLiteral("Cannot connect to remote device."));
                     emit disconnected();
                 });
         connect(m_control, &QLowEnergyController::connected, this, [this]() {
             Q_UNUSED(this);
-            emit debug(QStringLiteral("Controller connected. Search services..."));
+            LOG_DEVICE(QStringLiteral("Controller connected. Search services..."));
             m_control->discoverServices();
         });
         connect(m_control, &QLowEnergyController::disconnected, this, [this]() {
             Q_UNUSED(this);
-            emit debug(QStringLiteral("LowEnergy controller disconnected"));
+            LOG_DEVICE(QStringLiteral("LowEnergy controller disconnected"));
             emit disconnected();
         });
 
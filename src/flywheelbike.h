@@ -27,6 +27,7 @@
 #include <QString>
 
 #include "bike.h"
+#include "framing.h"
 #include "virtualbike.h"
 
 #ifdef Q_OS_IOS
@@ -42,9 +43,11 @@ class flywheelbike : public bike {
     void *VirtualBike();
     void *VirtualDevice();
 
-  private:
-    typedef enum DecoderRXState { WFSYNC_1 = 0, WFLENGTH, WFID, DATA, CHECKSUM, EOF_1 } DecoderRXState;
+    // 0xFF | length | message id | data | checksum (not verified, the algorithm is unknown) ... 0x55
+    // the data is one byte longer than the length byte
+    static const lengthframespec frameSpec;
 
+  private:
     typedef enum DecoderErrorState {
         MSG_NO_ERROR = 0,
         MSG_DATA_OK,
@@ -123,10 +126,8 @@ class flywheelbike : public bike {
         LAST_VALUE
     } ICGMessageType;
 
-    int dataPacketLength;
-    int dataPacketIndex;
+    lengthframer<nochecksum> frames = lengthframer<nochecksum>(frameSpec);
     DecoderErrorState errorState = MSG_NO_ERROR;
-    DecoderRXState rxState = WFSYNC_1;
     BikeDataframe bikeData;
 
     void flushDataframe(BikeDataframe *dataFrame);
@@ -0,0 +1,53 @@
+#include "framing.h"
+
+QList<QByteArray> framing::chunks(const QByteArray &message, int size) {
+    QList<QByteArray> list;
+    if (size <= 0) {
+        list.append(message);
+        return list;
+    }
+    list.reserve((message.length() + size - 1) / size);
+    for (int i = 0; i < message.length(); i += size) {
+        list.append(message.mid(i, size));
+    }
+    return list;
+}
+
+bool fragmentassembler::feed(const QByteArray &value, QByteArray &out) {
+    if (!partial.isEmpty()) {
+        bool complete = since.elapsed() < timeout && partial.length() + value.length() == expected;
+        QByteArray first = partial;
+        partial.clear();
+        if (complete) {
+            out = first + value;
+            return true;
+        }
+    }
+
+    if (value.length() == mtu) {
+        for (const message &m : qAsConst(messages)) {
+            if (m.length > mtu && value.startsWith(m.start)) {
+                partial = value;
+                expected = m.length;
+                since.start();
+                return false;
+            }
+        }
+    }
+
+    out = value;
+    return true;
+}
+
+QList<QByteArray> terminatorframer::feed(const QByteArray &value) {
+    QList<QByteArray> frames;
+    for (char c : value) {
+        if (c == terminator) {
+            frames.append(buffer);
+            buffer.clear();
+        } else if (buffer.length() < maxLength) {
+            buffer.append(c);
+        }
+    }
+    return frames;
+}
@@ -0,0 +1,178 @@
+#ifndef FRAMING_H
+#define FRAMING_H
+
+#include <QByteArray>
+#include <QElapsedTimer>
+#include <QList>
+#include <stdint.h>
+
+// Building blocks for the proprietary protocols: the devices split their messages across several notifications
+// (because of the 20 bytes of the default ATT MTU) or stream them with a start byte, a length and a terminator,
+// and most of them close every message with a one byte checksum.
+
+// Checksum policies: the checksum is the last byte of the frame. seal() writes it, verify() checks it.
+struct nochecksum {
+    static void seal(uint8_t *frame, int length) {
+        Q_UNUSED(frame);
+        Q_UNUSED(length);
+    }
+    static bool verify(const uint8_t *frame, int length) {
+        Q_UNUSED(frame);
+        Q_UNUSED(length);
+        return true;
+    }
+};
+
+// sum of the bytes from First to the checksum excluded, plus Offset, modulo 256
+template <int First = 0, uint8_t Offset = 0> struct sum8checksum {
+    static uint8_t compute(const uint8_t *frame, int length) {
+        uint8_t sum = Offset;
+        for (int i = First; i < length - 1; i++) {
+            sum += frame[i];
+        }
+        return sum;
+    }
+    static void seal(uint8_t *frame, int length) {
+        if (length > First) {
+            frame[length - 1] = compute(frame, length);
+        }
+    }
+    static bool verify(const uint8_t *frame, int length) {
+        return length > First && frame[length - 1] == compute(frame, length);
+    }
+};
+
+// xor of the bytes from First to the checksum excluded
+template <int First = 0> struct xor8checksum {
+    static uint8_t compute(const uint8_t *frame, int length) {
+        uint8_t x = 0;
+        for (int i = First; i < length - 1; i++) {
+            x ^= frame[i];
+        }
+        return x;
+    }
+    static void seal(uint8_t *frame, int length) {
+        if (length > First) {
+            frame[length - 1] = compute(frame, length);
+        }
+    }
+    static bool verify(const uint8_t *frame, int length) {
+        return length > First && frame[length - 1] == compute(frame, length);
+    }
+};
+
+namespace framing {
+// splits a message in the pieces written one after the other to the characteristic
+QList<QByteArray> chunks(const QByteArray &message, int size);
+} // namespace framing
+
+// Messages of a known length sent in fragments of `mtu` bytes: a fragment beginning with one of the start sequences
+// is held until the rest of the message arrives. Anything else passes through untouched.
+class fragmentassembler {
+  public:
+    struct message {
+        QByteArray start;
+        int length;
+    };
+
+    fragmentassembler(int mtu, const QList<message> &messages, int timeout = 1000)
+        : mtu(mtu), messages(messages), timeout(timeout) {}
+
+    // returns false when the notification was held as the beginning of a message, otherwise `out` is the notification
+    // itself or the reassembled message
+    bool feed(const QByteArray &value, QByteArray &out);
+    // a message is half received: the drivers don't write in the meantime
+    bool pending() const { return !partial.isEmpty() && since.elapsed() < timeout; }
+    void reset() { partial.clear(); }
+
+  private:
+    int mtu;
+    QList<message> messages;
+    int timeout;
+    QByteArray partial;
+    int expected = 0;
+    QElapsedTimer since;
+};
+
+// Messages ending with a terminator byte, sent in as many notifications as they need.
+class terminatorframer {
+  public:
+    explicit terminatorframer(char terminator, int maxLength = 4096) : terminator(terminator), maxLength(maxLength) {}
+
+    // the messages completed by `value`, without the terminator
+    QList<QByteArray> feed(const QByteArray &value);
+    bool pending() const { return !buffer.isEmpty(); }
+    void reset() { buffer.clear(); }
+
+  private:
+    char terminator;
+    int maxLength;
+    QByteArray buffer;
+};
+
+// A stream of frames shaped as
+//   sync | ... length ... | payload | checksum | terminator
+// the payload is `length + lengthAdjust` bytes, the header is everything before it. Garbage and frames failing the
+// checksum or missing the terminator are skipped by looking for the next sync byte.
+struct lengthframespec {
+    uint8_t sync;
+    int lengthOffset; // position of the length byte in the header
+    int headerSize;
+    int lengthAdjust;
+    bool hasChecksum;
+    int terminator; // -1 when there is none
+};
+
+template <class Checksum = nochecksum> class lengthframer {
+  public:
+    explicit lengthframer(const lengthframespec &spec) : spec(spec) {}
+
+    QList<QByteArray> feed(const QByteArray &value) {
+        QList<QByteArray> frames;
+        buffer.append(value);
+
+        int offset = 0;
+        while (offset < buffer.length()) {
+            const uint8_t *b = (const uint8_t *)buffer.constData() + offset;
+            int available = buffer.length() - offset;
+            if (b[0] != spec.sync) {
+                offset++;
+                continue;
+            }
+            if (available < spec.headerSize) {
+                break;
+            }
+            int payload = b[spec.lengthOffset] + spec.lengthAdjust;
+            if (b[spec.lengthOffset] == 0 || payload < 0) {
+                offset++;
+                continue;
+            }
+            int size = spec.headerSize + payload + (spec.hasChecksum ? 1 : 0) + (spec.terminator >= 0 ? 1 : 0);
+            if (available < size) {
+                break;
+            }
+            int checked = size - (spec.terminator >= 0 ? 1 : 0);
+            if ((spec.terminator >= 0 && b[size - 1] != (uint8_t)spec.terminator) ||
+                (spec.hasChecksum && !Checksum::verify(b, checked))) {
+                offset++;
+                continue;
+            }
+            frames.append(buffer.mid(offset, size));
+            offset += size;
+        }
+        buffer.remove(0, offset);
+        return frames;
+    }
+
+    // the payload of a frame returned by feed()
+    QByteArray payload(const QByteArray &frame) const {
+        return frame.mid(spec.headerSize, (uint8_t)frame.at(spec.lengthOffset) + spec.lengthAdjust);
+    }
+    void reset() { buffer.clear(); }
+
+  private:
+    lengthframespec spec;
+    QByteArray buffer;
+};
+
+#endif // FRAMING_H
@@ -1,4 +1,6 @@
 #include "ftmsbike.h"
+#include "logging.h"
+#include "ftmsparser.h"
 #include "ios/lockscreen.h"
 #include "virtualbike.h"
 #include <QBluetoothLocalDevice>
@@ -35,17 +37,18 @@ void ftmsbike::writeCharacteristic(uint8_t *data, uint8_t data_len, const QStrin
     QEventLoop loop;
     QTimer timeout;
     if (wait_for_response) {
-        connect(gattFTMSService, &QLowEnergyService::characteristicChanged, &loop, &QEventLoop::quit);
+        connect(transport, &bluetoothtransport::characteristicChanged, &loop, &QEventLoop::quit);
         timeout.singleShot(300ms, &loop, &QEventLoop::quit);
     } else {
-        connect(gattFTMSService, &QLowEnergyService::characteristicWritten, &loop, &QEventLoop::quit);
+        connect(transport, &bluetoothtransport::characteristicWritten, &loop, &QEventLoop::quit);
         timeout.singleShot(300ms, &loop, &QEventLoop::quit);
     }
 
-    gattFTMSService->writeCharacteristic(gattWriteCharControlPointId, QByteArray((const char *)data, data_len));
+    writeRequested(QByteArray((const char *)data, data_len));
+    transport->writeCharacteristic(gattWriteCharControlPointId, QByteArray((const char *)data, data_len));
 
     if (!disable_log) {
-        emit debug(QStringLiteral(" >> ") + QByteArray((const char *)data, data_len).toHex(' ') +
+        LOG_PACKET(QStringLiteral(" >> ") + QByteArray((const char *)data, data_len).toHex(' ') +
                    QStringLiteral(" // ") + info);
     }
 
@@ -67,7 +70,7 @@ void ftmsbike::forceResistance(int8_t requestResistance) {
 }
 
 void ftmsbike::update() {
-    if (m_control->state() == QLowEnergyController::UnconnectedState) {
+    if (transport->state() == QLowEnergyController::UnconnectedState) {
         emit disconnected();
         return;
     }
@@ -75,7 +78,7 @@ void ftmsbike::update() {
     if (initRequest) {
         initRequest = false;
     } else if (bluetoothDevice.isValid() &&
-               m_control->state() == QLowEnergyController::DiscoveredState //&&
+               transport->state() == QLowEnergyController::DiscoveredState //&&
                                                                            // gattCommunicationChannelService &&
                                                                            // gattWriteCharacteristic.isValid() &&
                                                                            // gattNotify1Characteristic.isValid() &&
@@ -97,13 +100,14 @@ void ftmsbike::update() {
             }
 
             if (requestResistance != currentResistance().value()) {
-                emit debug(QStringLiteral("writing resistance ") + QString::number(requestResistance));
+                LOG_DEVICE(QStringLiteral("writing resistance ") + QString::number(requestResistance));
+                requestQueued();
                 forceResistance(requestResistance);
             }
             requestResistance = -1;
         }
         if (requestStart != -1) {
-            emit debug(QStringLiteral("starting..."));
+            LOG_DEVICE(QStringLiteral("starting..."));
 
             // btinit();
 
@@ -111,149 +115,75 @@ void ftmsbike::update() {
             emit bikeStarted();
         }
         if (requestStop != -1) {
-            emit debug(QStringLiteral("stopping..."));
+            LOG_DEVICE(QStringLiteral("stopping..."));
             // writeCharacteristic(initDataF0C800B8, sizeof(initDataF0C800B8), "stop tape");
             requestStop = -1;
         }
     }
 }
 
-void ftmsbike::serviceDiscovered(const QBluetoothUuid &gatt) {
-    emit debug(QStringLiteral("serviceDiscovered ") + gatt.toString());
-}
-
-void ftmsbike::characteristicChanged(const QLowEnergyCharacteristic &characteristic, const QByteArray &newValue) {
-    // qDebug() << "characteristicChanged" << characteristic.uuid() << newValue << newValue.length();
-    Q_UNUSED(characteristic);
+void ftmsbike::characteristicChanged(const QBluetoothUuid &characteristic, const QByteArray &newValue) {
+    // qDebug() << "characteristicChanged" << characteristic << newValue << newValue.length();
     QSettings settings;
     QString heartRateBeltName =
         settings.value(QStringLiteral("heart_rate_belt_name"), QStringLiteral("Disabled")).toString();
     bool disable_hr_frommachinery = settings.value(QStringLiteral("heart_ignore_builtin"), false).toBool();
 
-    emit debug(QStringLiteral(" << ") + newValue.toHex(' '));
+    LOG_PACKET(QStringLiteral(" << ") + newValue.toHex(' '));
 
-    if (characteristic.uuid() != QBluetoothUuid((quint16)0x2AD2)) {
+    ftmsparser::data d;
+    if (characteristic != QBluetoothUuid((quint16)ftmsparser::INDOOR_BIKE_DATA)) {
         return;
     }
+    if (!ftmsparser::parse(ftmsparser::INDOOR_BIKE_DATA, newValue.constData(), newValue.length(), d)) {
+        LOG_DEVICE(QStringLiteral("truncated indoor bike data"));
+    }
 
     lastPacket = newValue;
 
-    union flags {
-        struct {
-            uint16_t moreData : 1;
-            uint16_t avgSpeed : 1;
-            uint16_t instantCadence : 1;
-            uint16_t avgCadence : 1;
-            uint16_t totDistance : 1;
-            uint16_t resistanceLvl : 1;
-            uint16_t instantPower : 1;
-            uint16_t avgPower : 1;
-            uint16_t expEnergy : 1;
-            uint16_t heartRate : 1;
-            uint16_t metabolic : 1;
-            uint16_t elapsedTime : 1;
-            uint16_t remainingTime : 1;
-            uint16_t spare : 3;
-        };
-
-        uint16_t word_flags;
-    };
-
-    flags Flags;
-    int index = 0;
-    Flags.word_flags = (newValue.at(1) << 8) | newValue.at(0);
-    index += 2;
-
-    if (!Flags.moreData) {
+    if (d.has(ftmsparser::INSTANT_SPEED)) {
         if (!settings.value(QStringLiteral("speed_power_based"), false).toBool()) {
-            Speed = ((double)(((uint16_t)((uint8_t)newValue.at(index + 1)) << 8) |
-                              (uint16_t)((uint8_t)newValue.at(index)))) /
-                    100.0;
+            Speed = d[ftmsparser::INSTANT_SPEED];
         } else {
             Speed = metric::calculateSpeedFromPower(m_watt.value());
         }
-        index += 2;
-        emit debug(QStringLiteral("Current Speed: ") + QString::number(Speed.value()));
-    }
-
-    if (Flags.avgSpeed) {
-        double avgSpeed;
-        avgSpeed =
-            ((double)(((uint16_t)((uint8_t)newValue.at(index + 1)) << 8) | (uint16_t)((uint8_t)newValue.at(index)))) /
-            100.0;
-        index += 2;
-        emit debug(QStringLiteral("Current Average Speed: ") + QString::number(avgSpeed));
+        LOG_DEVICE(QStringLiteral("Current Speed: ") + QString::number(Speed.value()));
     }
 
-    if (Flags.instantCadence) {
+    if (d.has(ftmsparser::INSTANT_CADENCE)) {
         if (settings.value(QStringLiteral("cadence_sensor_name"), QStringLiteral("Disabled"))
                 .toString()
                 .startsWith(QStringLiteral("Disabled"))) {
-            Cadence = ((double)(((uint16_t)((uint8_t)newValue.at(index + 1)) << 8) |
-                                (uint16_t)((uint8_t)newValue.at(index)))) /
-                      2.0;
+            Cadence = d[ftmsparser::INSTANT_CADENCE];
         }
-        index += 2;
-        emit debug(QStringLiteral("Current Cadence: ") + QString::number(Cadence.value()));
+        LOG_DEVICE(QStringLiteral("Current Cadence: ") + QString::number(Cadence.value()));
     }
 
-    if (Flags.avgCadence) {
-        double avgCadence;
-        avgCadence =
-            ((double)(((uint16_t)((uint8_t)newValue.at(index + 1)) << 8) | (uint16_t)((uint8_t)newValue.at(index)))) /
-            2.0;
-        index += 2;
-        emit debug(QStringLiteral("Current Average Cadence: ") + QString::number(avgCadence));
-    }
-
-    if (Flags.totDistance) {
-        Distance = ((double)((((uint32_t)((uint8_t)newValue.at(index + 2)) << 16) |
-                              (uint32_t)((uint8_t)newValue.at(index + 1)) << 8) |
-                             (uint32_t)((uint8_t)newValue.at(index)))) /
-                   1000.0;
-        index += 3;
+    if (d.has(ftmsparser::TOTAL_DISTANCE)) {
+        Distance = d[ftmsparser::TOTAL_DISTANCE] / 1000.0;
     } else {
         Distance += ((Speed.value() / 3600000.0) *
                      ((double)lastRefreshCharacteristicChanged.msecsTo(QDateTime::currentDateTime())));
     }
 
-    emit debug(QStringLiteral("Current Distance: ") + QString::number(Distance.value()));
+    LOG_DEVICE(QStringLiteral("Current Distance: ") + QString::number(Distance.value()));
 
-    if (Flags.resistanceLvl) {
-        Resistance =
-            ((double)(((uint16_t)((uint8_t)newValue.at(index + 1)) << 8) | (uint16_t)((uint8_t)newValue.at(index))));
+    if (d.has(ftmsparser::RESISTANCE)) {
+        Resistance = d[ftmsparser::RESISTANCE];
         emit resistanceRead(Resistance.value());
-        index += 2;
-        emit debug(QStringLiteral("Current Resistance: ") + QString::number(Resistance.value()));
+        LOG_DEVICE(QStringLiteral("Current Resistance: ") + QString::number(Resistance.value()));
     }
 
-    if (Flags.instantPower) {
+    if (d.has(ftmsparser::INSTANT_POWER)) {
         if (settings.value(QStringLiteral("power_sensor_name"), QStringLiteral("Disabled"))
                 .toString()
                 .startsWith(QStringLiteral("Disabled")))
-            m_watt = ((double)(((uint16_t)((uint8_t)newValue.at(index + 1)) << 8) |
-                               (uint16_t)((uint8_t)newValue.at(index))));
-        index += 2;
-        emit debug(QStringLiteral("Current Watt: ") + QString::number(m_watt.value()));
+            m_watt = d[ftmsparser::INSTANT_POWER];
+        LOG_DEVICE(QStringLiteral("Current Watt: ") + QString::number(m_watt.value()));
     }
 
-    if (Flags.avgPower) {
-        double avgPower;
-        avgPower =
-            ((double)(((uint16_t)((uint8_t)newValue.at(index + 1)) << 8) | (uint16_t)((uint8_t)newValue.at(index))));
-        index += 2;
-        emit debug(QStringLiteral("Current Average Watt: ") + QString::number(avgPower));
-    }
-
-    if (Flags.expEnergy && newValue.length() > index + 1) {
-        KCal = ((double)(((uint16_t)((uint8_t)newValue.at(index + 1)) << 8) | (uint16_t)((uint8_t)newValue.at(index))));
-        index += 2;
-
-        // energy per hour
-        index += 2;
-
-        // energy per minute
-        index += 1;
+    if (d.has(ftmsparser::TOTAL_ENERGY)) {
+        KCal = d[ftmsparser::TOTAL_ENERGY];
     } else {
         if (watts())
             KCal +=
@@ -265,35 +195,22 @@ void ftmsbike::characteristicChanged(const QLowEnergyCharacteristic &characteris
                                                                   // kg * 3.5) / 200 ) / 60
     }
 
-    emit debug(QStringLiteral("Current KCal: ") + QString::number(KCal.value()));
+    LOG_DEVICE(QStringLiteral("Current KCal: ") + QString::number(KCal.value()));
 
+    bool heartRate = false;
 #ifdef Q_OS_ANDROID
     if (settings.value("ant_heart", false).toBool())
         Heart = (uint8_t)KeepAwakeHelper::heart();
     else
 #endif
     {
-        if (Flags.heartRate && !disable_hr_frommachinery && newValue.length() > index) {
-            Heart = ((double)((newValue.at(index))));
-            // index += 1; // NOTE: clang-analyzer-deadcode.DeadStores
-            emit debug(QStringLiteral("Current Heart: ") + QString::number(Heart.value()));
-        } else {
-            Flags.heartRate = false;
+        if (d.has(ftmsparser::HEART_RATE) && !disable_hr_frommachinery) {
+            Heart = d[ftmsparser::HEART_RATE];
+            heartRate = true;
+            LOG_DEVICE(QStringLiteral("Current Heart: ") + QString::number(Heart.value()));
         }
     }
 
-    if (Flags.metabolic) {
-        // todo
-    }
-
-    if (Flags.elapsedTime) {
-        // todo
-    }
-
-    if (Flags.remainingTime) {
-        // todo
-    }
-
     if (Cadence.value() > 0) {
         CrankRevs++;
         LastCrankEventTime += (uint16_t)(1024.0 / (((double)(Cadence.value())) / 60.0));
@@ -302,7 +219,7 @@ void ftmsbike::characteristicChanged(const QLowEnergyCharacteristic &characteris
     lastRefreshCharacteristicChanged = QDateTime::currentDateTime();
 
     if (heartRateBeltName.startsWith(QStringLiteral("Disabled")) &&
-        (!Flags.heartRate || Heart.value() == 0 || disable_hr_frommachinery)) {
+        (!heartRate || Heart.value() == 0 || disable_hr_frommachinery)) {
 #ifdef Q_OS_IOS
 #ifndef IO_UNDER_QT
         lockscreen h;
@@ -326,91 +243,36 @@ void ftmsbike::characteristicChanged(const QLowEnergyCharacteristic &characteris
 #endif
 #endif
 
-    emit debug(QStringLiteral("Current CrankRevs: ") + QString::number(CrankRevs));
-    emit debug(QStringLiteral("Last CrankEventTime: ") + QString::number(LastCrankEventTime));
-
-    if (m_control->error() != QLowEnergyController::NoError) {
-        qDebug() << QStringLiteral("QLowEnergyController ERROR!!") << m_control->errorString();
-    }
+    LOG_DEVICE(QStringLiteral("Current CrankRevs: ") + QString::number(CrankRevs));
+    LOG_DEVICE(QStringLiteral("Last CrankEventTime: ") + QString::number(LastCrankEventTime));
 }
 
-void ftmsbike::stateChanged(QLowEnergyService::ServiceState state) {
-    QMetaEnum metaEnum = QMetaEnum::fromType<QLowEnergyService::ServiceState>();
-    emit debug(QStringLiteral("BTLE stateChanged ") + QString::fromLocal8Bit(metaEnum.valueToKey(state)));
+void ftmsbike::serviceScanDone(void) {
+    LOG_DEVICE(QStringLiteral("serviceScanDone"));
+
+#ifdef Q_OS_ANDROID
+    if (m_control) {
+        QLowEnergyConnectionParameters c;
+        c.setIntervalRange(24, 40);
+        c.setLatency(0);
+        c.setSupervisionTimeout(420);
+        m_control->requestConnectionUpdate(c);
+    }
+#endif
 
-    for (QLowEnergyService *s : qAsConst(gattCommunicationChannelService)) {
-        qDebug() << QStringLiteral("stateChanged") << s->serviceUuid() << s->state();
-        if (s->state() != QLowEnergyService::ServiceDiscovered && s->state() != QLowEnergyService::InvalidService) {
-            qDebug() << QStringLiteral("not all services discovered");
-            return;
+    initRequest = false;
+    auto characteristics_list = transport->characteristics();
+    for (const QBluetoothUuid &c : qAsConst(characteristics_list)) {
+        QLowEnergyCharacteristic::PropertyTypes properties = transport->properties(c);
+        if (properties & (QLowEnergyCharacteristic::Notify | QLowEnergyCharacteristic::Indicate)) {
+            transport->subscribe(c);
+            qDebug() << c << QStringLiteral("subscribing");
         }
-    }
 
-    qDebug() << QStringLiteral("all services discovered!");
-
-    for (QLowEnergyService *s : qAsConst(gattCommunicationChannelService)) {
-        if (s->state() == QLowEnergyService::ServiceDiscovered) {
-            // establish hook into notifications
-            connect(s, &QLowEnergyService::characteristicChanged, this, &ftmsbike::characteristicChanged);
-            connect(s, &QLowEnergyService::characteristicWritten, this, &ftmsbike::characteristicWritten);
-            connect(s, &QLowEnergyService::characteristicRead, this, &ftmsbike::characteristicRead);
-            connect(
-                s, static_cast<void (QLowEnergyService::*)(QLowEnergyService::ServiceError)>(&QLowEnergyService::error),
-                this, &ftmsbike::errorService);
-            connect(s, &QLowEnergyService::descriptorWritten, this, &ftmsbike::descriptorWritten);
-            connect(s, &QLowEnergyService::descriptorRead, this, &ftmsbike::descriptorRead);
-
-            qDebug() << s->serviceUuid() << QStringLiteral("connected!");
-
-            auto characteristics_list = s->characteristics();
-            for (const QLowEnergyCharacteristic &c : qAsConst(characteristics_list)) {
-                qDebug() << QStringLiteral("char uuid") << c.uuid() << QStringLiteral("handle") << c.handle();
-                auto descriptors_list = c.descriptors();
-                for (const QLowEnergyDescriptor &d : qAsConst(descriptors_list)) {
-                    qDebug() << QStringLiteral("descriptor uuid") << d.uuid() << QStringLiteral("handle") << d.handle();
-                }
-
-                if ((c.properties() & QLowEnergyCharacteristic::Notify) == QLowEnergyCharacteristic::Notify) {
-                    QByteArray descriptor;
-                    descriptor.append((char)0x01);
-                    descriptor.append((char)0x00);
-                    if (c.descriptor(QBluetoothUuid::ClientCharacteristicConfiguration).isValid()) {
-                        s->writeDescriptor(c.descriptor(QBluetoothUuid::ClientCharacteristicConfiguration), descriptor);
-                    } else {
-                        qDebug() << QStringLiteral("ClientCharacteristicConfiguration") << c.uuid()
-                                 << c.descriptor(QBluetoothUuid::ClientCharacteristicConfiguration).uuid()
-                                 << c.descriptor(QBluetoothUuid::ClientCharacteristicConfiguration).handle()
-                                 << QStringLiteral(" is not valid");
-                    }
-
-                    qDebug() << s->serviceUuid() << c.uuid() << QStringLiteral("notification subscribed!");
-                } else if ((c.properties() & QLowEnergyCharacteristic::Indicate) ==
-                           QLowEnergyCharacteristic::Indicate) {
-                    QByteArray descriptor;
-                    descriptor.append((char)0x02);
-                    descriptor.append((char)0x00);
-                    if (c.descriptor(QBluetoothUuid::ClientCharacteristicConfiguration).isValid()) {
-                        s->writeDescriptor(c.descriptor(QBluetoothUuid::ClientCharacteristicConfiguration), descriptor);
-                    } else {
-                        qDebug() << QStringLiteral("ClientCharacteristicConfiguration") << c.uuid()
-                                 << c.descriptor(QBluetoothUuid::ClientCharacteristicConfiguration).uuid()
-                                 << c.descriptor(QBluetoothUuid::ClientCharacteristicConfiguration).handle()
-                                 << QStringLiteral(" is not valid");
-                    }
-
-                    qDebug() << s->serviceUuid() << c.uuid() << QStringLiteral("indication subscribed!");
-                } else if ((c.properties() & QLowEnergyCharacteristic::Read) == QLowEnergyCharacteristic::Read) {
-                    // s->readCharacteristic(c);
-                    // qDebug() << s->serviceUuid() << c.uuid() << "reading!";
-                }
-
-                QBluetoothUuid _gattWriteCharControlPointId((quint16)0x2AD9);
-                if (c.properties() & QLowEnergyCharacteristic::Write && c.uuid() == _gattWriteCharControlPointId) {
-                    qDebug() << QStringLiteral("FTMS service and Control Point found");
-                    gattWriteCharControlPointId = c;
-                    gattFTMSService = s;
-                }
-            }
+        QBluetoothUuid _gattWriteCharControlPointId((quint16)0x2AD9);
+        if (properties & QLowEnergyCharacteristic::Write && c == _gattWriteCharControlPointId) {
+            qDebug() << QStringLiteral("FTMS service and Control Point found");
+            gattWriteCharControlPointId = c;
         }
     }
 
@@ -436,7 +298,7 @@ void ftmsbike::stateChanged(QLowEnergyService::ServiceState state) {
 #endif
 #endif
             if (virtual_device_enabled) {
-            emit debug(QStringLiteral("creating virtual bike interface..."));
+            LOG_DEVICE(QStringLiteral("creating virtual bike interface..."));
             virtualBike =
                 new virtualbike(this, noWriteResistance, noHeartService, bikeResistanceOffset, bikeResistanceGain);
             // connect(virtualBike,&virtualbike::debug ,this,&ftmsbike::debug);
@@ -450,110 +312,69 @@ void ftmsbike::stateChanged(QLowEnergyService::ServiceState state) {
 
 void ftmsbike::ftmsCharacteristicChanged(const QLowEnergyCharacteristic &characteristic, const QByteArray &newValue) {
     QByteArray b = newValue;
-    if (gattWriteCharControlPointId.isValid()) {
+    if (!gattWriteCharControlPointId.isNull()) {
         qDebug() << "routing FTMS packet to the bike from virtualbike" << characteristic.uuid() << newValue.toHex(' ');
 
-        gattFTMSService->writeCharacteristic(gattWriteCharControlPointId, b);
+        // the control point packet of the app is the request itself
+        requestQueued();
+        writeRequested(b);
+        transport->writeCharacteristic(gattWriteCharControlPointId, b);
     }
 }
 
-void ftmsbike::descriptorWritten(const QLowEnergyDescriptor &descriptor, const QByteArray &newValue) {
-    emit debug(QStringLiteral("descriptorWritten ") + descriptor.name() + QStringLiteral(" ") + newValue.toHex(' '));
+void ftmsbike::subscribed(const QBluetoothUuid &characteristic) {
+    LOG_DEVICE(QStringLiteral("subscribed ") + characteristic.toString());
 
     initRequest = true;
     emit connectedAndDiscovered();
 }
 
-void ftmsbike::descriptorRead(const QLowEnergyDescriptor &descriptor, const QByteArray &newValue) {
-    qDebug() << QStringLiteral("descriptorRead ") << descriptor.name() << descriptor.uuid() << newValue.toHex(' ');
-}
-
-void ftmsbike::characteristicWritten(const QLowEnergyCharacteristic &characteristic, const QByteArray &newValue) {
+void ftmsbike::characteristicWritten(const QBluetoothUuid &characteristic, const QByteArray &newValue) {
     Q_UNUSED(characteristic);
-    emit debug(QStringLiteral("characteristicWritten ") + newValue.toHex(' '));
-}
-
-void ftmsbike::characteristicRead(const QLowEnergyCharacteristic &characteristic, const QByteArray &newValue) {
-    qDebug() << QStringLiteral("characteristicRead ") << characteristic.uuid() << newValue.toHex(' ');
-}
-
-void ftmsbike::serviceScanDone(void) {
-    emit debug(QStringLiteral("serviceScanDone"));
-
-#ifdef Q_OS_ANDROID
-    QLowEnergyConnectionParameters c;
-    c.setIntervalRange(24, 40);
-    c.setLatency(0);
-    c.setSupervisionTimeout(420);
-    m_control->requestConnectionUpdate(c);
-#endif
-
-    initRequest = false;
-    auto services_list = m_control->services();
-    for (const QBluetoothUuid &s : qAsConst(services_list)) {
-        gattCommunicationChannelService.append(m_control->createServiceObject(s));
-        connect(gattCommunicationChannelService.constLast(), &QLowEnergyService::stateChanged, this,
-                &ftmsbike::stateChanged);
-        gattCommunicationChannelService.constLast()->discoverDetails();
-    }
-}
-
-void ftmsbike::errorService(QLowEnergyService::ServiceError err) {
-    QMetaEnum metaEnum = QMetaEnum::fromType<QLowEnergyService::ServiceError>();
-    emit debug(QStringLiteral("ftmsbike::errorService") + QString::fromLocal8Bit(metaEnum.valueToKey(err)) +
-               m_control->errorString());
+    LOG_PACKET(QStringLiteral("characteristicWritten ") + newValue.toHex(' '));
 }
 
-void ftmsbike::error(QLowEnergyController::Error err) {
-    QMetaEnum metaEnum = QMetaEnum::fromType<QLowEnergyController::Error>();
-    emit debug(QStringLiteral("ftmsbike::error") + QString::fromLocal8Bit(metaEnum.valueToKey(err)) +
-               m_control->errorString());
+void ftmsbike::error(const QString &err) {
+    LOG_DEVICE(QStringLiteral("ftmsbike::error ") + err);
+    LOG_DEVICE(QStringLiteral("Cannot connect to remote device."));
+    emit disconnected();
 }
 
 void ftmsbike::deviceDiscovered(const QBluetoothDeviceInfo &device) {
-    emit debug(QStringLiteral("Found new device: ") + device.name() + QStringLiteral(" (") +
+    LOG_DEVICE(QStringLiteral("Found new device: ") + device.name() + QStringLiteral(" (") +
                device.address().toString() + ')');
     {
         bluetoothDevice = device;
 
-        m_control = QLowEnergyController::createCentral(bluetoothDevice, this);
-        connect(m_control, &QLowEnergyController::serviceDiscovered, this, &ftmsbike::serviceDiscovered);
-        connect(m_control, &QLowEnergyController::discoveryFinished, this, &ftmsbike::serviceScanDone);
-        connect(m_control,
-                static_cast<void (QLowEnergyController::*)(QLowEnergyController::Error)>(&QLowEnergyController::error),
-                this, &ftmsbike::error);
-        connect(m_control, &QLowEnergyController::stateChanged, this, &ftmsbike::controllerStateChanged);
-
-        connect(m_control,
-                static_cast<void (QLowEnergyController::*)(QLowEnergyController::Error)>(&QLowEnergyController::error),
-                this, [this](QLowEnergyController::Error error) {
-                    Q_UNUSED(error);
-                    Q_UNUSED(this);
-                    emit debug(QStringLiteral("Cannot connect to remote device."));
-                    emit disconnected();
-                });
-        connect(m_control, &QLowEnergyController::connected, this, [this]() {
+        transport = bluetoothtransport::create(bluetoothDevice, this);
+        m_control = transport->controller();
+        connect(transport, &bluetoothtransport::discovered, this, &ftmsbike::serviceScanDone);
+        connect(transport, &bluetoothtransport::characteristicChanged, this, &ftmsbike::characteristicChanged);
+        connect(transport, &bluetoothtransport::characteristicWritten, this, &ftmsbike::characteristicWritten);
+        connect(transport, &bluetoothtransport::subscribed, this, &ftmsbike::subscribed);
+        connect(transport, &bluetoothtransport::error, this, &ftmsbike::error);
+        connect(transport, &bluetoothtransport::stateChanged, this, &ftmsbike::controllerStateChanged);
+        connect(transport, &bluetoothtransport::connected, this, [this]() {
             Q_UNUSED(this);
-            emit debug(QStringLiteral("Controller connected. Search services..."));
-            m_control->discoverServices();
+            LOG_DEVICE(QStringLiteral("Controller connected. Search services..."));
         });
-        connect(m_control, &QLowEnergyController::disconnected, this, [this]() {
+        connect(transport, &bluetoothtransport::disconnected, this, [this]() {
             Q_UNUSED(this);
-            emit debug(QStringLiteral("LowEnergy controller disconnected"));
+            LOG_DEVICE(QStringLiteral("LowEnergy controller disconnected"));
             emit disconnected();
         });
 
         // Connect
-        m_control->connectToDevice();
+        transport->connectToDevice();
         return;
     }
 }
 
 bool ftmsbike::connected() {
-    if (!m_control) {
+    if (!transport) {
         return false;
     }
-    return m_control->state() == QLowEnergyController::DiscoveredState;
+    return transport->state() == QLowEnergyController::DiscoveredState;
 }
 
 void *ftmsbike::VirtualBike() { return virtualBike; }
@@ -570,9 +391,9 @@ uint16_t ftmsbike::watts() {
 
 void ftmsbike::controllerStateChanged(QLowEnergyController::ControllerState state) {
     qDebug() << QStringLiteral("controllerStateChanged") << state;
-    if (state == QLowEnergyController::UnconnectedState && m_control) {
+    if (state == QLowEnergyController::UnconnectedState && transport) {
         qDebug() << QStringLiteral("trying to connect back again...");
         initDone = false;
-        m_control->connectToDevice();
+        transport->connectToDevice();
     }
 }
@@ -27,6 +27,7 @@
 #include <QString>
 
 #include "bike.h"
+#include "bluetoothtransport.h"
 #include "virtualbike.h"
 
 #ifdef Q_OS_IOS
@@ -85,9 +86,7 @@ class ftmsbike : public bike {
     QTimer *refresh;
     virtualbike *virtualBike = nullptr;
 
-    QList<QLowEnergyService *> gattCommunicationChannelService;
-    QLowEnergyCharacteristic gattWriteCharControlPointId;
-    QLowEnergyService *gattFTMSService;
+    QBluetoothUuid gattWriteCharControlPointId;
 
     uint8_t sec1Update = 0;
     QByteArray lastPacket;
@@ -115,19 +114,14 @@ class ftmsbike : public bike {
 
   private slots:
 
-    void characteristicChanged(const QLowEnergyCharacteristic &characteristic, const QByteArray &newValue);
-    void characteristicWritten(const QLowEnergyCharacteristic &characteristic, const QByteArray &newValue);
-    void descriptorWritten(const QLowEnergyDescriptor &descriptor, const QByteArray &newValue);
-    void characteristicRead(const QLowEnergyCharacteristic &characteristic, const QByteArray &newValue);
-    void descriptorRead(const QLowEnergyDescriptor &descriptor, const QByteArray &newValue);
-    void stateChanged(QLowEnergyService::ServiceState state);
+    void characteristicChanged(const QBluetoothUuid &characteristic, const QByteArray &newValue);
+    void characteristicWritten(const QBluetoothUuid &characteristic, const QByteArray &newValue);
+    void subscribed(const QBluetoothUuid &characteristic);
     void controllerStateChanged(QLowEnergyController::ControllerState state);
 
-    void serviceDiscovered(const QBluetoothUuid &gatt);
     void serviceScanDone(void);
     void update();
-    void error(QLowEnergyController::Error err);
-    void errorService(QLowEnergyService::ServiceError);
+    void error(const QString &err);
     void ftmsCharacteristicChanged(const QLowEnergyCharacteristic &characteristic, const QByteArray &newValue);
 };
 
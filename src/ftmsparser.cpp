@@ -0,0 +1,233 @@
+#include "ftmsparser.h"
+
+namespace {
+
+struct ftmsfield {
+    uint8_t flag;          // bit of the flags enabling the field
+    bool presentWhenClear; // bit 0 is "more data": the first fields are there when it's 0
+    ftmsparser::FIELD field;
+    uint8_t size; // bytes, little endian
+    bool isSigned;
+    double resolution;
+};
+
+struct ftmslayout {
+    uint16_t characteristic;
+    uint8_t flagsSize;
+    const ftmsfield *fields;
+    int count;
+};
+
+template <int N> constexpr int countOf(const ftmsfield (&)[N]) { return N; }
+
+constexpr ftmsfield treadmillData[] = {
+    {0, true, ftmsparser::INSTANT_SPEED, 2, false, 0.01},
+    {1, false, ftmsparser::AVERAGE_SPEED, 2, false, 0.01},
+    {2, false, ftmsparser::TOTAL_DISTANCE, 3, false, 1},
+    {3, false, ftmsparser::INCLINATION, 2, true, 0.1},
+    {3, false, ftmsparser::RAMP_ANGLE, 2, true, 0.1},
+    {4, false, ftmsparser::POSITIVE_ELEVATION, 2, false, 0.1},
+    {4, false, ftmsparser::NEGATIVE_ELEVATION, 2, false, 0.1},
+    {5, false, ftmsparser::INSTANT_PACE, 1, false, 0.1},
+    {6, false, ftmsparser::AVERAGE_PACE, 1, false, 0.1},
+    {7, false, ftmsparser::TOTAL_ENERGY, 2, false, 1},
+    {7, false, ftmsparser::ENERGY_PER_HOUR, 2, false, 1},
+    {7, false, ftmsparser::ENERGY_PER_MINUTE, 1, false, 1},
+    {8, false, ftmsparser::HEART_RATE, 1, false, 1},
+    {9, false, ftmsparser::METABOLIC_EQUIVALENT, 1, false, 0.1},
+    {10, false, ftmsparser::ELAPSED_TIME, 2, false, 1},
+    {11, false, ftmsparser::REMAINING_TIME, 2, false, 1},
+    {12, false, ftmsparser::FORCE_ON_BELT, 2, true, 1},
+    {12, false, ftmsparser::INSTANT_POWER, 2, true, 1},
+};
+
+constexpr ftmsfield crossTrainerData[] = {
+    {0, true, ftmsparser::INSTANT_SPEED, 2, false, 0.01},
+    {1, false, ftmsparser::AVERAGE_SPEED, 2, false, 0.01},
+    {2, false, ftmsparser::TOTAL_DISTANCE, 3, false, 1},
+    {3, false, ftmsparser::STEP_PER_MINUTE, 2, false, 1},
+    {3, false, ftmsparser::AVERAGE_STEP_RATE, 2, false, 1},
+    {4, false, ftmsparser::STRIDE_COUNT, 2, false, 0.1},
+    {5, false, ftmsparser::POSITIVE_ELEVATION, 2, false, 1},
+    {5, false, ftmsparser::NEGATIVE_ELEVATION, 2, false, 1},
+    {6, false, ftmsparser::INCLINATION, 2, true, 0.1},
+    {6, false, ftmsparser::RAMP_ANGLE, 2, true, 0.1},
+    {7, false, ftmsparser::RESISTANCE, 2, true, 0.1},
+    {8, false, ftmsparser::INSTANT_POWER, 2, true, 1},
+    {9, false, ftmsparser::AVERAGE_POWER, 2, true, 1},
+    {10, false, ftmsparser::TOTAL_ENERGY, 2, false, 1},
+    {10, false, ftmsparser::ENERGY_PER_HOUR, 2, false, 1},
+    {10, false, ftmsparser::ENERGY_PER_MINUTE, 1, false, 1},
+    {11, false, ftmsparser::HEART_RATE, 1, false, 1},
+    {12, false, ftmsparser::METABOLIC_EQUIVALENT, 1, false, 0.1},
+    {13, false, ftmsparser::ELAPSED_TIME, 2, false, 1},
+    {14, false, ftmsparser::REMAINING_TIME, 2, false, 1},
+    // bit 15 is the movement direction, it has no field
+};
+
+constexpr ftmsfield stepClimberData[] = {
+    {0, true, ftmsparser::FLOORS, 2, false, 1},
+    {0, true, ftmsparser::STEP_COUNT, 2, false, 1},
+    {1, false, ftmsparser::STEP_PER_MINUTE, 2, false, 1},
+    {2, false, ftmsparser::AVERAGE_STEP_RATE, 2, false, 1},
+    {3, false, ftmsparser::POSITIVE_ELEVATION, 2, false, 1},
+    {4, false, ftmsparser::TOTAL_ENERGY, 2, false, 1},
+    {4, false, ftmsparser::ENERGY_PER_HOUR, 2, false, 1},
+    {4, false, ftmsparser::ENERGY_PER_MINUTE, 1, false, 1},
+    {5, false, ftmsparser::HEART_RATE, 1, false, 1},
+    {6, false, ftmsparser::METABOLIC_EQUIVALENT, 1, false, 0.1},
+    {7, false, ftmsparser::ELAPSED_TIME, 2, false, 1},
+    {8, false, ftmsparser::REMAINING_TIME, 2, false, 1},
+};
+
+constexpr ftmsfield stairClimberData[] = {
+    {0, true, ftmsparser::FLOORS, 2, false, 1},
+    {1, false, ftmsparser::STEP_PER_MINUTE, 2, false, 1},
+    {2, false, ftmsparser::AVERAGE_STEP_RATE, 2, false, 1},
+    {3, false, ftmsparser::POSITIVE_ELEVATION, 2, false, 1},
+    {4, false, ftmsparser::STRIDE_COUNT, 2, false, 1},
+    {5, false, ftmsparser::TOTAL_ENERGY, 2, false, 1},
+    {5, false, ftmsparser::ENERGY_PER_HOUR, 2, false, 1},
+    {5, false, ftmsparser::ENERGY_PER_MINUTE, 1, false, 1},
+    {6, false, ftmsparser::HEART_RATE, 1, false, 1},
+    {7, false, ftmsparser::METABOLIC_EQUIVALENT, 1, false, 0.1},
+    {8, false, ftmsparser::ELAPSED_TIME, 2, false, 1},
+    {9, false, ftmsparser::REMAINING_TIME, 2, false, 1},
+};
+
+constexpr ftmsfield rowerData[] = {
+    {0, true, ftmsparser::STROKE_RATE, 1, false, 0.5},
+    {0, true, ftmsparser::STROKE_COUNT, 2, false, 1},
+    {1, false, ftmsparser::AVERAGE_STROKE_RATE, 1, false, 0.5},
+    {2, false, ftmsparser::TOTAL_DISTANCE, 3, false, 1},
+    {3, false, ftmsparser::INSTANT_PACE, 2, false, 1},
+    {4, false, ftmsparser::AVERAGE_PACE, 2, false, 1},
+    {5, false, ftmsparser::INSTANT_POWER, 2, true, 1},
+    {6, false, ftmsparser::AVERAGE_POWER, 2, true, 1},
+    {7, false, ftmsparser::RESISTANCE, 2, true, 1},
+    {8, false, ftmsparser::TOTAL_ENERGY, 2, false, 1},
+    {8, false, ftmsparser::ENERGY_PER_HOUR, 2, false, 1},
+    {8, false, ftmsparser::ENERGY_PER_MINUTE, 1, false, 1},
+    {9, false, ftmsparser::HEART_RATE, 1, false, 1},
+    {10, false, ftmsparser::METABOLIC_EQUIVALENT, 1, false, 0.1},
+    {11, false, ftmsparser::ELAPSED_TIME, 2, false, 1},
+    {12, false, ftmsparser::REMAINING_TIME, 2, false, 1},
+};
+
+constexpr ftmsfield indoorBikeData[] = {
+    {0, true, ftmsparser::INSTANT_SPEED, 2, false, 0.01},
+    {1, false, ftmsparser::AVERAGE_SPEED, 2, false, 0.01},
+    {2, false, ftmsparser::INSTANT_CADENCE, 2, false, 0.5},
+    {3, false, ftmsparser::AVERAGE_CADENCE, 2, false, 0.5},
+    {4, false, ftmsparser::TOTAL_DISTANCE, 3, false, 1},
+    {5, false, ftmsparser::RESISTANCE, 2, true, 1},
+    {6, false, ftmsparser::INSTANT_POWER, 2, true, 1},
+    {7, false, ftmsparser::AVERAGE_POWER, 2, true, 1},
+    {8, false, ftmsparser::TOTAL_ENERGY, 2, false, 1},
+    {8, false, ftmsparser::ENERGY_PER_HOUR, 2, false, 1},
+    {8, false, ftmsparser::ENERGY_PER_MINUTE, 1, false, 1},
+    {9, false, ftmsparser::HEART_RATE, 1, false, 1},
+    {10, false, ftmsparser::METABOLIC_EQUIVALENT, 1, false, 0.1},
+    {11, false, ftmsparser::ELAPSED_TIME, 2, false, 1},
+    {12, false, ftmsparser::REMAINING_TIME, 2, false, 1},
+};
+
+constexpr ftmslayout layouts[] = {
+    {ftmsparser::TREADMILL_DATA, 2, treadmillData, countOf(treadmillData)},
+    {ftmsparser::CROSS_TRAINER_DATA, 3, crossTrainerData, countOf(crossTrainerData)},
+    {ftmsparser::STEP_CLIMBER_DATA, 2, stepClimberData, countOf(stepClimberData)},
+    {ftmsparser::STAIR_CLIMBER_DATA, 2, stairClimberData, countOf(stairClimberData)},
+    {ftmsparser::ROWER_DATA, 2, rowerData, countOf(rowerData)},
+    {ftmsparser::INDOOR_BIKE_DATA, 2, indoorBikeData, countOf(indoorBikeData)},
+};
+
+static_assert(ftmsparser::FIELDS <= 32, "the present mask is 32 bits wide");
+
+const ftmslayout *layoutOf(uint16_t characteristic) {
+    for (const ftmslayout &l : layouts) {
+        if (l.characteristic == characteristic) {
+            return &l;
+        }
+    }
+    return nullptr;
+}
+
+} // namespace
+
+bool ftmsparser::supported(uint16_t characteristic) { return layoutOf(characteristic) != nullptr; }
+
+bool ftmsparser::parse(uint16_t characteristic, const uint8_t *buffer, int length, data &out) {
+    out = data();
+    const ftmslayout *l = layoutOf(characteristic);
+    if (!l) {
+        return false;
+    }
+    if (!buffer || length < l->flagsSize) {
+        out.truncated = true;
+        return false;
+    }
+
+    for (int i = 0; i < l->flagsSize; i++) {
+        out.flags |= (uint32_t)buffer[i] << (8 * i);
+    }
+
+    int index = l->flagsSize;
+    for (int i = 0; i < l->count; i++) {
+        const ftmsfield &f = l->fields[i];
+        bool set = (out.flags >> f.flag) & 1;
+        if (set == f.presentWhenClear) {
+            continue;
+        }
+        if (index + f.size > length) {
+            out.truncated = true;
+            return false;
+        }
+
+        uint32_t raw = 0;
+        for (int b = 0; b < f.size; b++) {
+            raw |= (uint32_t)buffer[index + b] << (8 * b);
+        }
+        int64_t v = raw;
+        if (f.isSigned && (raw & (1u << (8 * f.size - 1)))) {
+            v -= (int64_t)1 << (8 * f.size);
+        }
+        out.value[f.field] = (double)v * f.resolution;
+        out.present |= 1u << f.field;
+        index += f.size;
+    }
+    return true;
+}
+
+const char *ftmsparser::fieldName(FIELD f) {
+    static const char *names[FIELDS] = {"Speed",
+                                        "Average Speed",
+                                        "Cadence",
+                                        "Average Cadence",
+                                        "Distance",
+                                        "Resistance",
+                                        "Watt",
+                                        "Average Watt",
+                                        "KCal",
+                                        "KCal/h",
+                                        "KCal/min",
+                                        "Heart",
+                                        "METs",
+                                        "Elapsed Time",
+                                        "Remaining Time",
+                                        "Inclination",
+                                        "Ramp Angle",
+                                        "Positive Elevation",
+                                        "Negative Elevation",
+                                        "Pace",
+                                        "Average Pace",
+                                        "Force on Belt",
+                                        "Step Per Minute",
+                                        "Average Step Rate",
+                                        "Stride Count",
+                                        "Floors",
+                                        "Step Count",
+                                        "Stroke Rate",
+                                        "Stroke Count",
+                                        "Average Stroke Rate"};
+    return (f >= 0 && f < FIELDS) ? names[f] : "";
+}
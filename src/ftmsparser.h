@@ -0,0 +1,75 @@
+#ifndef FTMSPARSER_H
+#define FTMSPARSER_H
+
+#include <stdint.h>
+
+// Decodes the data characteristics of the Fitness Machine Service (0x2ACD-0x2AD2). Each of them is a flags field
+// followed by the fields the flags enable, always in the same order, so the layouts are described by constant tables
+// and a single walk decodes all the machines. Every field is bounds checked against the length of the notification:
+// a truncated packet gives back the fields read before the end. Nothing is allocated, the result is a plain struct.
+class ftmsparser {
+  public:
+    enum CHARACTERISTIC {
+        TREADMILL_DATA = 0x2ACD,
+        CROSS_TRAINER_DATA = 0x2ACE,
+        STEP_CLIMBER_DATA = 0x2ACF,
+        STAIR_CLIMBER_DATA = 0x2AD0,
+        ROWER_DATA = 0x2AD1,
+        INDOOR_BIKE_DATA = 0x2AD2
+    };
+
+    // values are in the units of the specification, already scaled by their resolution
+    enum FIELD {
+        INSTANT_SPEED = 0,    // km/h
+        AVERAGE_SPEED,        // km/h
+        INSTANT_CADENCE,      // rpm
+        AVERAGE_CADENCE,      // rpm
+        TOTAL_DISTANCE,       // m
+        RESISTANCE,           // unitless
+        INSTANT_POWER,        // W
+        AVERAGE_POWER,        // W
+        TOTAL_ENERGY,         // kcal
+        ENERGY_PER_HOUR,      // kcal
+        ENERGY_PER_MINUTE,    // kcal
+        HEART_RATE,           // bpm
+        METABOLIC_EQUIVALENT, // MET
+        ELAPSED_TIME,         // s
+        REMAINING_TIME,       // s
+        INCLINATION,          // %
+        RAMP_ANGLE,           // degrees
+        POSITIVE_ELEVATION,   // m
+        NEGATIVE_ELEVATION,   // m
+        INSTANT_PACE,         // km/min for the treadmills, s/500m for the rowers
+        AVERAGE_PACE,         // km/min for the treadmills, s/500m for the rowers
+        FORCE_ON_BELT,        // N
+        STEP_PER_MINUTE,      // steps/min
+        AVERAGE_STEP_RATE,    // steps/min
+        STRIDE_COUNT,         // unitless
+        FLOORS,               // unitless
+        STEP_COUNT,           // unitless
+        STROKE_RATE,          // strokes/min
+        STROKE_COUNT,         // unitless
+        AVERAGE_STROKE_RATE,  // strokes/min
+        FIELDS
+    };
+
+    struct data {
+        uint32_t flags = 0;
+        uint32_t present = 0;
+        bool truncated = false;
+        double value[FIELDS] = {};
+
+        bool has(FIELD f) const { return present & (1u << f); }
+        double operator[](FIELD f) const { return value[f]; }
+    };
+
+    // returns false if the characteristic is not a FTMS data one or the packet is shorter than its flags say
+    static bool parse(uint16_t characteristic, const uint8_t *buffer, int length, data &out);
+    static bool parse(uint16_t characteristic, const char *buffer, int length, data &out) {
+        return parse(characteristic, (const uint8_t *)buffer, length, out);
+    }
+    static bool supported(uint16_t characteristic);
+    static const char *fieldName(FIELD f);
+};
+
+#endif // FTMSPARSER_H
@@ -1,4 +1,6 @@
 #include "ftmsrower.h"
+#include "logging.h"
+#include "ftmsparser.h"
 #include "ftmsbike.h"
 #include "ios/lockscreen.h"
 #include "virtualbike.h"
@@ -45,7 +47,7 @@ void ftmsrower::writeCharacteristic(uint8_t *data, uint8_t data_len, const QStri
     gattFTMSService->writeCharacteristic(gattWriteCharControlPointId, QByteArray((const char *)data, data_len));
 
     if (!disable_log) {
-        emit debug(QStringLiteral(" >> ") + QByteArray((const char *)data, data_len).toHex(' ') +
+        LOG_PACKET(QStringLiteral(" >> ") + QByteArray((const char *)data, data_len).toHex(' ') +
                    QStringLiteral(" // ") + info);
     }
 
@@ -98,14 +100,14 @@ void ftmsrower::update() {
             }
 
             if (requestResistance != currentResistance().value()) {
-                emit debug(QStringLiteral("writing resistance ") + QString::number(requestResistance));
+                LOG_DEVICE(QStringLiteral("writing resistance ") + QString::number(requestResistance));
 
                 forceResistance(requestResistance);
             }
             requestResistance = -1;
         }
         if (requestStart != -1) {
-            emit debug(QStringLiteral("starting..."));
+            LOG_DEVICE(QStringLiteral("starting..."));
 
             // btinit();
 
@@ -113,7 +115,7 @@ void ftmsrower::update() {
             emit bikeStarted();
         }
         if (requestStop != -1) {
-            emit debug(QStringLiteral("stopping..."));
+            LOG_DEVICE(QStringLiteral("stopping..."));
 
             // writeCharacteristic(initDataF0C800B8, sizeof(initDataF0C800B8), "stop tape");
             requestStop = -1;
@@ -122,7 +124,7 @@ void ftmsrower::update() {
 }
 
 void ftmsrower::serviceDiscovered(const QBluetoothUuid &gatt) {
-    emit debug(QStringLiteral("serviceDiscovered ") + gatt.toString());
+    LOG_DEVICE(QStringLiteral("serviceDiscovered ") + gatt.toString());
 }
 
 void ftmsrower::characteristicChanged(const QLowEnergyCharacteristic &characteristic, const QByteArray &newValue) {
@@ -135,134 +137,61 @@ void ftmsrower::characteristicChanged(const QLowEnergyCharacteristic &characteri
 
     qDebug() << QStringLiteral(" << ") << characteristic.uuid() << " " << newValue.toHex(' ');
 
-    if (characteristic.uuid() != QBluetoothUuid((quint16)0x2AD1)) {
+    ftmsparser::data d;
+    if (characteristic.uuid() != QBluetoothUuid((quint16)ftmsparser::ROWER_DATA)) {
         return;
     }
+    if (!ftmsparser::parse(ftmsparser::ROWER_DATA, newValue.constData(), newValue.length(), d)) {
+        LOG_DEVICE(QStringLiteral("truncated rower data"));
+    }
 
     lastPacket = newValue;
 
-    union flags {
-        struct {
-
-            uint16_t moreData : 1;
-            uint16_t avgStroke : 1;
-            uint16_t totDistance : 1;
-            uint16_t instantPace : 1;
-            uint16_t avgPace : 1;
-            uint16_t instantPower : 1;
-            uint16_t avgPower : 1;
-            uint16_t resistanceLvl : 1;
-            uint16_t expEnergy : 1;
-            uint16_t heartRate : 1;
-            uint16_t metabolic : 1;
-            uint16_t elapsedTime : 1;
-            uint16_t remainingTime : 1;
-            uint16_t spare : 3;
-        };
-
-        uint16_t word_flags;
-    };
-
-    flags Flags;
-    int index = 0;
-    Flags.word_flags = (newValue.at(1) << 8) | newValue.at(0);
-    index += 2;
-
-    if (!Flags.moreData) {
-
-        Cadence = ((uint8_t)newValue.at(index)) / 2;
-        StrokesCount =
-            (((uint16_t)((uint8_t)newValue.at(index + 2)) << 8) | (uint16_t)((uint8_t)newValue.at(index + 1)));
-
-        index += 3;
+    if (d.has(ftmsparser::STROKE_RATE)) {
+        Cadence = d[ftmsparser::STROKE_RATE];
+        StrokesCount = d[ftmsparser::STROKE_COUNT];
 
         /*
          * the concept 2 sends the pace in 2 frames, so this condition will create a bugus speed
-        if (!Flags.instantPace) {
+        if (!d.has(ftmsparser::INSTANT_PACE)) {
             // eredited by echelon rower, probably we need to change this
             Speed = (0.37497622 * ((double)Cadence.value())) / 2.0;
-            emit debug(QStringLiteral("Current Speed: ") + QString::number(Speed.value()));
+            LOG_DEVICE(QStringLiteral("Current Speed: ") + QString::number(Speed.value()));
         }*/
-        emit debug(QStringLiteral("Strokes Count: ") + QString::number(StrokesCount.value()));
-    }
-
-    if (Flags.avgStroke) {
-
-        double avgStroke;
-        avgStroke = ((double)(uint16_t)((uint8_t)newValue.at(index))) / 2.0;
-        index += 1;
-        emit debug(QStringLiteral("Current Average Stroke: ") + QString::number(avgStroke));
+        LOG_DEVICE(QStringLiteral("Strokes Count: ") + QString::number(StrokesCount.value()));
     }
 
-    if (Flags.totDistance) {
-        Distance = ((double)((((uint32_t)((uint8_t)newValue.at(index + 2)) << 16) |
-                              (uint32_t)((uint8_t)newValue.at(index + 1)) << 8) |
-                             (uint32_t)((uint8_t)newValue.at(index)))) /
-                   1000.0;
-        index += 3;
+    if (d.has(ftmsparser::TOTAL_DISTANCE)) {
+        Distance = d[ftmsparser::TOTAL_DISTANCE] / 1000.0;
     } else {
         Distance += ((Speed.value() / 3600000.0) *
                      ((double)lastRefreshCharacteristicChanged.msecsTo(QDateTime::currentDateTime())));
     }
 
-    emit debug(QStringLiteral("Current Distance: ") + QString::number(Distance.value()));
-
-    if (Flags.instantPace) {
+    LOG_DEVICE(QStringLiteral("Current Distance: ") + QString::number(Distance.value()));
 
-        double instantPace;
-        instantPace =
-            ((double)(((uint16_t)((uint8_t)newValue.at(index + 1)) << 8) | (uint16_t)((uint8_t)newValue.at(index))));
-        index += 2;
-        emit debug(QStringLiteral("Current Pace: ") + QString::number(instantPace));
+    if (d.has(ftmsparser::INSTANT_PACE)) {
+        double instantPace = d[ftmsparser::INSTANT_PACE];
+        LOG_DEVICE(QStringLiteral("Current Pace: ") + QString::number(instantPace));
 
         Speed = (60.0 / instantPace) *
                 30.0; // translating pace (min/500m) to km/h in order to match the pace function in the rower.cpp
-        emit debug(QStringLiteral("Current Speed: ") + QString::number(Speed.value()));
-    }
-
-    if (Flags.avgPace) {
-
-        double avgPace;
-        avgPace =
-            ((double)(((uint16_t)((uint8_t)newValue.at(index + 1)) << 8) | (uint16_t)((uint8_t)newValue.at(index))));
-        index += 2;
-        emit debug(QStringLiteral("Current Average Pace: ") + QString::number(avgPace));
-    }
-
-    if (Flags.instantPower) {
-        m_watt =
-            ((double)(((uint16_t)((uint8_t)newValue.at(index + 1)) << 8) | (uint16_t)((uint8_t)newValue.at(index))));
-        index += 2;
-        emit debug(QStringLiteral("Current Watt: ") + QString::number(m_watt.value()));
+        LOG_DEVICE(QStringLiteral("Current Speed: ") + QString::number(Speed.value()));
     }
 
-    if (Flags.avgPower) {
-
-        double avgPower;
-        avgPower =
-            ((double)(((uint16_t)((uint8_t)newValue.at(index + 1)) << 8) | (uint16_t)((uint8_t)newValue.at(index))));
-        index += 2;
-        emit debug(QStringLiteral("Current Average Watt: ") + QString::number(avgPower));
+    if (d.has(ftmsparser::INSTANT_POWER)) {
+        m_watt = d[ftmsparser::INSTANT_POWER];
+        LOG_DEVICE(QStringLiteral("Current Watt: ") + QString::number(m_watt.value()));
     }
 
-    if (Flags.resistanceLvl) {
-        Resistance =
-            ((double)(((uint16_t)((uint8_t)newValue.at(index + 1)) << 8) | (uint16_t)((uint8_t)newValue.at(index))));
+    if (d.has(ftmsparser::RESISTANCE)) {
+        Resistance = d[ftmsparser::RESISTANCE];
         emit resistanceRead(Resistance.value());
-        index += 2;
-        emit debug(QStringLiteral("Current Resistance: ") + QString::number(Resistance.value()));
+        LOG_DEVICE(QStringLiteral("Current Resistance: ") + QString::number(Resistance.value()));
     }
 
-    if (Flags.expEnergy) {
-
-        KCal = ((double)(((uint16_t)((uint8_t)newValue.at(index + 1)) << 8) | (uint16_t)((uint8_t)newValue.at(index))));
-        index += 2;
-
-        // energy per hour
-        index += 2;
-
-        // energy per minute
-        index += 1;
+    if (d.has(ftmsparser::TOTAL_ENERGY)) {
+        KCal = d[ftmsparser::TOTAL_ENERGY];
     } else {
         if (watts())
             KCal +=
@@ -274,7 +203,7 @@ void ftmsrower::characteristicChanged(const QLowEnergyCharacteristic &characteri
                                                                   // kg * 3.5) / 200 ) / 60
     }
 
-    emit debug(QStringLiteral("Current KCal: ") + QString::number(KCal.value()));
+    LOG_DEVICE(QStringLiteral("Current KCal: ") + QString::number(KCal.value()));
 
 #ifdef Q_OS_ANDROID
     if (settings.value("ant_heart", false).toBool())
@@ -282,31 +211,12 @@ void ftmsrower::characteristicChanged(const QLowEnergyCharacteristic &characteri
     else
 #endif
     {
-        if (Flags.heartRate) {
-            if (index < newValue.length()) {
-                Heart = ((double)((newValue.at(index))));
-                // index += 1; //NOTE: clang-analyzer-deadcode.DeadStores
-                emit debug(QStringLiteral("Current Heart: ") + QString::number(Heart.value()));
-            } else
-                emit debug(QStringLiteral("Error on parsing heart"));
+        if (d.has(ftmsparser::HEART_RATE)) {
+            Heart = d[ftmsparser::HEART_RATE];
+            LOG_DEVICE(QStringLiteral("Current Heart: ") + QString::number(Heart.value()));
         }
     }
 
-    if (Flags.metabolic) {
-
-        // todo
-    }
-
-    if (Flags.elapsedTime) {
-
-        // todo
-    }
-
-    if (Flags.remainingTime) {
-
-        // todo
-    }
-
     if (Cadence.value() > 0) {
 
         CrankRevs++;
@@ -341,8 +251,8 @@ void ftmsrower::characteristicChanged(const QLowEnergyCharacteristic &characteri
 #endif
 #endif
 
-    emit debug(QStringLiteral("Current CrankRevs: ") + QString::number(CrankRevs));
-    emit debug(QStringLiteral("Last CrankEventTime: ") + QString::number(LastCrankEventTime));
+    LOG_DEVICE(QStringLiteral("Current CrankRevs: ") + QString::number(CrankRevs));
+    LOG_DEVICE(QStringLiteral("Last CrankEventTime: ") + QString::number(LastCrankEventTime));
 
     if (m_control->error() != QLowEnergyController::NoError) {
         qDebug() << QStringLiteral("QLowEnergyController ERROR!!") << m_control->errorString();
@@ -352,7 +262,7 @@ void ftmsrower::characteristicChanged(const QLowEnergyCharacteristic &characteri
 void ftmsrower::stateChanged(QLowEnergyService::ServiceState state) {
 
     QMetaEnum metaEnum = QMetaEnum::fromType<QLowEnergyService::ServiceState>();
-    emit debug(QStringLiteral("BTLE stateChanged ") + QString::fromLocal8Bit(metaEnum.valueToKey(state)));
+    LOG_DEVICE(QStringLiteral("BTLE stateChanged ") + QString::fromLocal8Bit(metaEnum.valueToKey(state)));
 
     for (QLowEnergyService *s : qAsConst(gattCommunicationChannelService)) {
         qDebug() << QStringLiteral("stateChanged") << s->serviceUuid() << s->state();
@@ -459,7 +369,7 @@ void ftmsrower::stateChanged(QLowEnergyService::ServiceState state) {
 #endif
 #endif
             if (virtual_device_enabled) {
-            emit debug(QStringLiteral("creating virtual bike interface..."));
+            LOG_DEVICE(QStringLiteral("creating virtual bike interface..."));
 
             virtualBike = new virtualbike(this, noWriteResistance, noHeartService);
             // connect(virtualBike,&virtualbike::debug ,this,&ftmsrower::debug);
@@ -470,7 +380,7 @@ void ftmsrower::stateChanged(QLowEnergyService::ServiceState state) {
 }
 
 void ftmsrower::descriptorWritten(const QLowEnergyDescriptor &descriptor, const QByteArray &newValue) {
-    emit debug(QStringLiteral("descriptorWritten ") + descriptor.name() + " " + newValue.toHex(' '));
+    LOG_PACKET(QStringLiteral("descriptorWritten ") + descriptor.name() + " " + newValue.toHex(' '));
 
     initRequest = true;
     emit connectedAndDiscovered();
@@ -483,7 +393,7 @@ void ftmsrower::descriptorRead(const QLowEnergyDescriptor &descriptor, const QBy
 void ftmsrower::characteristicWritten(const QLowEnergyCharacteristic &characteristic, const QByteArray &newValue) {
 
     Q_UNUSED(characteristic);
-    emit debug(QStringLiteral("characteristicWritten ") + newValue.toHex(' '));
+    LOG_PACKET(QStringLiteral("characteristicWritten ") + newValue.toHex(' '));
 }
 
 void ftmsrower::characteristicRead(const QLowEnergyCharacteristic &characteristic, const QByteArray &newValue) {
@@ -491,7 +401,7 @@ void ftmsrower::characteristicRead(const QLowEnergyCharacteristic &characteristi
 }
 
 void ftmsrower::serviceScanDone(void) {
-    emit debug(QStringLiteral("serviceScanDone"));
+    LOG_DEVICE(QStringLiteral("serviceScanDone"));
 
 #ifdef Q_OS_ANDROID
     QLowEnergyConnectionParameters c;
@@ -513,19 +423,19 @@ void ftmsrower::serviceScanDone(void) {
 void ftmsrower::errorService(QLowEnergyService::ServiceError err) {
 
     QMetaEnum metaEnum = QMetaEnum::fromType<QLowEnergyService::ServiceError>();
-    emit debug(QStringLiteral("ftmsrower::errorService") + QString::fromLocal8Bit(metaEnum.valueToKey(err)) +
+    LOG_DEVICE(QStringLiteral("ftmsrower::errorService") + QString::fromLocal8Bit(metaEnum.valueToKey(err)) +
                m_control->errorString());
 }
 
 void ftmsrower::error(QLowEnergyController::Error err) {
 
     QMetaEnum metaEnum = QMetaEnum::fromType<QLowEnergyController::Error>();
-    emit debug(QStringLiteral("ftmsrower::error") + QString::fromLocal8Bit(metaEnum.valueToKey(err)) +
+    LOG_DEVICE(QStringLiteral("ftmsrower::error") + QString::fromLocal8Bit(metaEnum.valueToKey(err)) +
                m_control->errorString());
 }
 
 void ftmsrower::deviceDiscovered(const QBluetoothDeviceInfo &device) {
-    emit debug(QStringLiteral("Found new device: ") + device.name() + QStringLiteral(" (") +
+    LOG_DEVICE(QStringLiteral("Found new device: ") + device.name() + QStringLiteral(" (") +
                device.address().toString() + ')');
     {
         bluetoothDevice = device;
@@ -543,17 +453,17 @@ void ftmsrower::deviceDiscovered(const QBluetoothDeviceInfo &device) {
                 this, [this](QLowEnergyController::Error error) {
                     Q_UNUSED(error);
                     Q_UNUSED(this);
-                    emit debug(QStringLiteral("Cannot connect to remote device."));
+                    LOG_DEVICE(QStringLiteral("Cannot connect to remote device."));
                     emit disconnected();
                 });
         connect(m_control, &QLowEnergyController::connected, this, [this]() {
             Q_UNUSED(this);
-            emit debug(QStringLiteral("Controller connected. Search services..."));
+            LOG_DEVICE(QStringLiteral("Controller connected. Search services..."));
             m_control->discoverServices();
         });
         connect(m_control, &QLowEnergyController::disconnected, this, [this]() {
             Q_UNUSED(this);
-            emit debug(QStringLiteral("LowEnergy controller disconnected"));
+            LOG_DEVICE(QStringLiteral("LowEnergy controller disconnected"));
             emit disconnected();
         });
 
@@ -0,0 +1,166 @@
+#include "gatewaytransport.h"
+#include "qdebugfixup.h"
+#include <QtEndian>
+
+gatewaytransport::gatewaytransport(const QString &host, quint16 port, QObject *parent)
+    : bluetoothtransport(parent), host(host), port(port) {
+    retry.setSingleShot(true);
+    connect(&retry, &QTimer::timeout, this, &gatewaytransport::connectToDevice);
+    tcp = new QTcpSocket(this);
+    tcp->setSocketOption(QAbstractSocket::LowDelayOption, 1);
+    socket = tcp;
+    connect(tcp, &QAbstractSocket::connected, this, &gatewaytransport::socketConnected);
+    connect(tcp, &QAbstractSocket::disconnected, this, &gatewaytransport::socketDisconnected);
+    connect(tcp, QOverload<QAbstractSocket::SocketError>::of(&QAbstractSocket::error), this,
+            [this](QAbstractSocket::SocketError err) {
+                Q_UNUSED(err);
+                setError(tcp->errorString());
+                if (tcp->state() == QAbstractSocket::UnconnectedState) {
+                    socketDisconnected();
+                }
+            });
+    connect(tcp, &QIODevice::readyRead, this, &gatewaytransport::readSocket);
+}
+
+gatewaytransport::gatewaytransport(const QBluetoothAddress &address, QObject *parent)
+    : bluetoothtransport(parent), address(address) {
+    retry.setSingleShot(true);
+    connect(&retry, &QTimer::timeout, this, &gatewaytransport::connectToDevice);
+    rfcomm = new QBluetoothSocket(QBluetoothServiceInfo::RfcommProtocol, this);
+    rfcomm->setPreferredSecurityFlags(QBluetooth::NoSecurity);
+    socket = rfcomm;
+    connect(rfcomm, &QBluetoothSocket::connected, this, &gatewaytransport::socketConnected);
+    connect(rfcomm, &QBluetoothSocket::disconnected, this, &gatewaytransport::socketDisconnected);
+    connect(rfcomm, QOverload<QBluetoothSocket::SocketError>::of(&QBluetoothSocket::error), this,
+            [this](QBluetoothSocket::SocketError err) {
+                Q_UNUSED(err);
+                setError(rfcomm->errorString());
+                if (rfcomm->state() == QBluetoothSocket::UnconnectedState) {
+                    socketDisconnected();
+                }
+            });
+    connect(rfcomm, &QIODevice::readyRead, this, &gatewaytransport::readSocket);
+}
+
+void gatewaytransport::connectToDevice() {
+    if (state() != QLowEnergyController::UnconnectedState || retry.isActive()) {
+        return;
+    }
+    // the drivers reconnect as soon as the link drops: a bridge refusing the connection would spin
+    if (lastAttempt.isValid() && lastAttempt.elapsed() < 1000) {
+        retry.start(1000);
+        return;
+    }
+    lastAttempt.start();
+    buffer.clear();
+    m_characteristics.clear();
+    m_services.clear();
+    setState(QLowEnergyController::ConnectingState);
+    if (tcp) {
+        tcp->connectToHost(host, port);
+    } else {
+        rfcomm->connectToService(address, QBluetoothUuid(QBluetoothUuid::SerialPort));
+    }
+}
+
+void gatewaytransport::disconnectFromDevice() {
+    if (tcp) {
+        tcp->disconnectFromHost();
+    } else {
+        rfcomm->disconnectFromService();
+    }
+}
+
+void gatewaytransport::socketConnected() {
+    qDebug() << QStringLiteral("gatewaytransport: connected, discovering...");
+    setState(QLowEnergyController::ConnectedState);
+    setState(QLowEnergyController::DiscoveringState);
+
+    QByteArray filter;
+    for (const QBluetoothUuid &s : qAsConst(serviceFilter)) {
+        filter.append(s.toRfc4122());
+    }
+    send('D', QBluetoothUuid(), filter);
+}
+
+void gatewaytransport::socketDisconnected() {
+    qDebug() << QStringLiteral("gatewaytransport: disconnected");
+    setState(QLowEnergyController::UnconnectedState);
+}
+
+QByteArray gatewaytransport::frame(char type, const QBluetoothUuid &characteristic, const QByteArray &payload) {
+    QByteArray f;
+    f.reserve(headerSize + payload.length());
+    f.append(type);
+    f.append(characteristic.toRfc4122());
+    f.append((char)(payload.length() & 0xFF));
+    f.append((char)((payload.length() >> 8) & 0xFF));
+    f.append(payload);
+    return f;
+}
+
+bool gatewaytransport::send(char type, const QBluetoothUuid &characteristic, const QByteArray &payload) {
+    if (state() == QLowEnergyController::UnconnectedState) {
+        qDebug() << QStringLiteral("gatewaytransport: write error because the connection is closed");
+        return false;
+    }
+    return socket->write(frame(type, characteristic, payload)) >= 0;
+}
+
+void gatewaytransport::readSocket() {
+    buffer.append(socket->readAll());
+
+    int offset = 0;
+    while (buffer.length() - offset >= headerSize) {
+        const char *h = buffer.constData() + offset;
+        int length = qFromLittleEndian<quint16>(h + 17);
+        if (buffer.length() - offset < headerSize + length) {
+            break;
+        }
+        QBluetoothUuid characteristic(QUuid::fromRfc4122(QByteArray::fromRawData(h + 1, 16)));
+        handleFrame(h[0], characteristic, buffer.mid(offset + headerSize, length));
+        offset += headerSize + length;
+    }
+    buffer.remove(0, offset);
+}
+
+void gatewaytransport::handleFrame(char type, const QBluetoothUuid &characteristic, const QByteArray &payload) {
+    switch (type) {
+    case 'N':
+        emit characteristicChanged(characteristic, payload);
+        break;
+    case 'K':
+        emit characteristicWritten(characteristic, payload);
+        break;
+    case 'A':
+        emit subscribed(characteristic);
+        break;
+    case 'C':
+        m_characteristics.insert(characteristic, QLowEnergyCharacteristic::PropertyTypes(
+                                                     QFlag(payload.isEmpty() ? 0 : (int)(uint8_t)payload.at(0))));
+        if (payload.length() >= 17) {
+            m_services.insert(characteristic, QBluetoothUuid(QUuid::fromRfc4122(payload.mid(1, 16))));
+        }
+        qDebug() << QStringLiteral("gatewaytransport: char uuid") << characteristic
+                 << m_characteristics.value(characteristic);
+        break;
+    case 'E':
+        setState(QLowEnergyController::DiscoveredState);
+        emit discovered();
+        break;
+    default:
+        qDebug() << QStringLiteral("gatewaytransport: unknown frame") << type << payload.toHex(' ');
+        break;
+    }
+}
+
+QLowEnergyCharacteristic::PropertyTypes gatewaytransport::properties(const QBluetoothUuid &characteristic) const {
+    return m_characteristics.value(characteristic, QLowEnergyCharacteristic::Unknown);
+}
+
+bool gatewaytransport::subscribe(const QBluetoothUuid &characteristic) { return send('S', characteristic); }
+
+void gatewaytransport::writeCharacteristic(const QBluetoothUuid &characteristic, const QByteArray &value,
+                                           bool withResponse) {
+    send(withResponse ? 'W' : 'w', characteristic, value);
+}
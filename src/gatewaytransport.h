@@ -0,0 +1,66 @@
+#ifndef GATEWAYTRANSPORT_H
+#define GATEWAYTRANSPORT_H
+
+#include <QBluetoothAddress>
+#include <QBluetoothSocket>
+#include <QElapsedTimer>
+#include <QHash>
+#include <QTcpSocket>
+#include <QTimer>
+
+#include "bluetoothtransport.h"
+
+// A BLE bridge (i.e. an ESP32 connected to the device) reached through TCP or an RFCOMM serial port. The GATT
+// operations are carried by frames, all the integers are little endian:
+//
+//   type (1 byte) | characteristic uuid (16 bytes, RFC 4122 order) | length (2 bytes) | payload (length bytes)
+//
+// host -> bridge: 'D' discover (payload: the uuids of the service filter, 16 bytes each), 'S' subscribe,
+//                 'W' write with response, 'w' write without response
+// bridge -> host: 'C' characteristic found (payload: the GATT properties byte, optionally followed by the uuid of
+//                 its service), 'E' end of the discovery,
+//                 'A' subscription done, 'K' write done (payload: the value written), 'N' notification/indication
+class gatewaytransport : public bluetoothtransport {
+    Q_OBJECT
+  public:
+    gatewaytransport(const QString &host, quint16 port, QObject *parent = nullptr);
+    explicit gatewaytransport(const QBluetoothAddress &address, QObject *parent = nullptr);
+    TRANSPORT_TYPE type() const override { return tcp ? TCP : RFCOMM; }
+
+    void connectToDevice() override;
+    void disconnectFromDevice() override;
+    QList<QBluetoothUuid> characteristics() const override { return m_characteristics.keys(); }
+    QLowEnergyCharacteristic::PropertyTypes properties(const QBluetoothUuid &characteristic) const override;
+    QBluetoothUuid service(const QBluetoothUuid &characteristic) const override {
+        return m_services.value(characteristic);
+    }
+    bool subscribe(const QBluetoothUuid &characteristic) override;
+    void writeCharacteristic(const QBluetoothUuid &characteristic, const QByteArray &value,
+                             bool withResponse = true) override;
+
+    static QByteArray frame(char type, const QBluetoothUuid &characteristic, const QByteArray &payload);
+    static const int headerSize = 19;
+
+  private:
+    bool send(char type, const QBluetoothUuid &characteristic, const QByteArray &payload = QByteArray());
+    void handleFrame(char type, const QBluetoothUuid &characteristic, const QByteArray &payload);
+
+    QTcpSocket *tcp = nullptr;
+    QBluetoothSocket *rfcomm = nullptr;
+    QIODevice *socket = nullptr;
+    QString host;
+    quint16 port = 0;
+    QBluetoothAddress address;
+    QByteArray buffer;
+    QElapsedTimer lastAttempt;
+    QTimer retry;
+    QHash<QBluetoothUuid, QLowEnergyCharacteristic::PropertyTypes> m_characteristics;
+    QHash<QBluetoothUuid, QBluetoothUuid> m_services;
+
+  private slots:
+    void socketConnected();
+    void socketDisconnected();
+    void readSocket();
+};
+
+#endif // GATEWAYTRANSPORT_H
@@ -0,0 +1,54 @@
+#include "gzip.h"
+#include <QtEndian>
+#include <array>
+
+quint32 gzip::crc32(const QByteArray &data, quint32 crc) {
+    static const std::array<quint32, 256> table = []() {
+        std::array<quint32, 256> t;
+        for (quint32 i = 0; i < 256; i++) {
+            quint32 c = i;
+            for (int k = 0; k < 8; k++) {
+                c = c & 1 ? 0xEDB88320 ^ (c >> 1) : c >> 1;
+            }
+            t[i] = c;
+        }
+        return t;
+    }();
+    crc ^= 0xFFFFFFFF;
+    for (char b : data) {
+        crc = table[(crc ^ (quint8)b) & 0xFF] ^ (crc >> 8);
+    }
+    return crc ^ 0xFFFFFFFF;
+}
+
+QByteArray gzip::compress(const QByteArray &data, int level) {
+    // qCompress: 4 bytes of length, 2 of zlib header, the deflate stream, 4 of adler32
+    QByteArray z = qCompress(data, level);
+    if (z.size() < 10) {
+        return QByteArray();
+    }
+    static const char header[10] = {0x1F, (char)0x8B, 0x08, 0, 0, 0, 0, 0, 0x00, (char)0xFF};
+    char trailer[8];
+    qToLittleEndian<quint32>(crc32(data), trailer);
+    qToLittleEndian<quint32>((quint32)data.size(), trailer + 4);
+    QByteArray out;
+    out.reserve(z.size() + 8);
+    out.append(header, sizeof(header));
+    out.append(z.constData() + 6, z.size() - 10);
+    out.append(trailer, sizeof(trailer));
+    return out;
+}
+
+bool gzip::compress(QIODevice &in, QIODevice &out, qint64 chunkSize, int level) {
+    while (!in.atEnd()) {
+        QByteArray chunk = in.read(chunkSize);
+        if (chunk.isEmpty()) {
+            return false;
+        }
+        QByteArray member = compress(chunk, level);
+        if (member.isEmpty() || out.write(member) != member.size()) {
+            return false;
+        }
+    }
+    return true;
+}
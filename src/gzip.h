@@ -0,0 +1,20 @@
+#ifndef GZIP_H
+#define GZIP_H
+
+#include <QByteArray>
+#include <QIODevice>
+
+// gzip (RFC 1952) on top of qCompress: its deflate stream is kept, its length prefix and its zlib header and trailer
+// are replaced by the ones of gzip, so the output opens with any gunzip and the browsers that don't take the zlib
+// format as "deflate" get it too.
+namespace gzip {
+// continues the crc of the previous data when crc is its result
+quint32 crc32(const QByteArray &data, quint32 crc = 0);
+// a gzip member with all the data, empty when the compression fails
+QByteArray compress(const QByteArray &data, int level = -1);
+// compresses in into out a chunk at a time, as a sequence of gzip members (gunzip joins them), so the memory doesn't
+// grow with the size of the input
+bool compress(QIODevice &in, QIODevice &out, qint64 chunkSize = 1 << 20, int level = -1);
+} // namespace gzip
+
+#endif // GZIP_H
@@ -1,4 +1,5 @@
 #include "heartratebelt.h"
+#include "logging.h"
 #include <QBluetoothLocalDevice>
 #include <QDateTime>
 #include <QEventLoop>
@@ -12,7 +13,7 @@ heartratebelt::heartratebelt() {}
 void heartratebelt::update() {}
 
 void heartratebelt::serviceDiscovered(const QBluetoothUuid &gatt) {
-    emit debug(QStringLiteral("serviceDiscovered ") + gatt.toString());
+    LOG_DEVICE(QStringLiteral("serviceDiscovered ") + gatt.toString());
 }
 
 void heartratebelt::disconnectBluetooth() {
@@ -28,24 +29,24 @@ void heartratebelt::characteristicChanged(const QLowEnergyCharacteristic &charac
     Q_UNUSED(characteristic);
     emit packetReceived();
 
-    emit debug(QStringLiteral(" << ") + newValue.toHex(' '));
+    LOG_PACKET(QStringLiteral(" << ") + newValue.toHex(' '));
 
     if (newValue.length() > 1) {
         Heart = (uint8_t)newValue[1];
         emit heartRate((uint8_t)Heart.value());
     }
 
-    emit debug(QStringLiteral("Current heart: ") + QString::number(Heart.value()));
+    LOG_DEVICE(QStringLiteral("Current heart: ") + QString::number(Heart.value()));
 }
 
 void heartratebelt::stateChanged(QLowEnergyService::ServiceState state) {
     QMetaEnum metaEnum = QMetaEnum::fromType<QLowEnergyService::ServiceState>();
-    emit debug(QStringLiteral("BTLE stateChanged ") + QString::fromLocal8Bit(metaEnum.valueToKey(state)));
+    LOG_DEVICE(QStringLiteral("BTLE stateChanged ") + QString::fromLocal8Bit(metaEnum.valueToKey(state)));
 
     if (state == QLowEnergyService::ServiceDiscovered) {
         auto characteristics_list = gattCommunicationChannelService->characteristics();
         for (const QLowEnergyCharacteristic &c : qAsConst(characteristics_list)) {
-            emit debug(QStringLiteral("characteristic ") + c.uuid().toString());
+            LOG_DEVICE(QStringLiteral("characteristic ") + c.uuid().toString());
         }
 
         gattNotifyCharacteristic =
@@ -72,16 +73,17 @@ void heartratebelt::stateChanged(QLowEnergyService::ServiceState state) {
 }
 
 void heartratebelt::descriptorWritten(const QLowEnergyDescriptor &descriptor, const QByteArray &newValue) {
-    emit debug(QStringLiteral("descriptorWritten ") + descriptor.name() + " " + newValue.toHex(' '));
+    LOG_PACKET(QStringLiteral("descriptorWritten ") + descriptor.name() + " " + newValue.toHex(' '));
+    emit connectedAndDiscovered();
 }
 
 void heartratebelt::characteristicWritten(const QLowEnergyCharacteristic &characteristic, const QByteArray &newValue) {
     Q_UNUSED(characteristic);
-    emit debug(QStringLiteral("characteristicWritten ") + newValue.toHex(' '));
+    LOG_PACKET(QStringLiteral("characteristicWritten ") + newValue.toHex(' '));
 }
 
 void heartratebelt::serviceScanDone(void) {
-    emit debug(QStringLiteral("serviceScanDone"));
+    LOG_DEVICE(QStringLiteral("serviceScanDone"));
 
     auto services_list = m_control->services();
     for (const QBluetoothUuid &s : qAsConst(services_list)) {
@@ -99,13 +101,13 @@ void heartratebelt::serviceScanDone(void) {
 
 void heartratebelt::errorService(QLowEnergyService::ServiceError err) {
     QMetaEnum metaEnum = QMetaEnum::fromType<QLowEnergyService::ServiceError>();
-    emit debug(QStringLiteral("heartratebelt::errorService") + QString::fromLocal8Bit(metaEnum.valueToKey(err)) +
+    LOG_DEVICE(QStringLiteral("heartratebelt::errorService") + QString::fromLocal8Bit(metaEnum.valueToKey(err)) +
                m_control->errorString());
 }
 
 void heartratebelt::error(QLowEnergyController::Error err) {
     QMetaEnum metaEnum = QMetaEnum::fromType<QLowEnergyController::Error>();
-    emit debug(QStringLiteral("heartratebelt::error") + QString::fromLocal8Bit(metaEnum.valueToKey(err)) +
+    LOG_DEVICE(QStringLiteral("heartratebelt::error") + QString::fromLocal8Bit(metaEnum.valueToKey(err)) +
                m_control->errorString());
 }
 
@@ -113,7 +115,7 @@ void heartratebelt::deviceDiscovered(const QBluetoothDeviceInfo &device) {
     QSettings settings;
     // QString heartRateBeltName = settings.value(QStringLiteral("heart_rate_belt_name"),
     // QStringLiteral("Disabled")).toString();//NOTE: clazy-unsed-non-trivial-variable
-    emit debug(QStringLiteral("Found new device: ") + device.name() + QStringLiteral(" (") +
+    LOG_DEVICE(QStringLiteral("Found new device: ") + device.name() + QStringLiteral(" (") +
                device.address().toString() + ')');
     // if(device.name().startsWith(heartRateBeltName))
     {
@@ -131,17 +133,17 @@ void heartratebelt::deviceDiscovered(const QBluetoothDeviceInfo &device) {
                 this, [this](QLowEnergyController::Error error) {
                     Q_UNUSED(error);
                     Q_UNUSED(this);
-                    emit debug(QStringLiteral("Cannot connect to remote device."));
+                    LOG_DEVICE(QStringLiteral("Cannot connect to remote device."));
                     emit disconnected();
                 });
         connect(m_control, &QLowEnergyController::connected, this, [this]() {
             Q_UNUSED(this);
-            emit debug(QStringLiteral("Controller connected. Search services..."));
+            LOG_DEVICE(QStringLiteral("Controller connected. Search services..."));
             m_control->discoverServices();
         });
         connect(m_control, &QLowEnergyController::disconnected, this, [this]() {
             Q_UNUSED(this);
-            emit debug(QStringLiteral("LowEnergy controller disconnected"));
+            LOG_DEVICE(QStringLiteral("LowEnergy controller disconnected"));
             emit disconnected();
         });
 
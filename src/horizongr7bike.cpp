@@ -1,4 +1,6 @@
 #include "horizongr7bike.h"
+#include "logging.h"
+#include "ftmsparser.h"
 #include "ftmsbike.h"
 #include "ios/lockscreen.h"
 #include "virtualbike.h"
@@ -43,10 +45,11 @@ void horizongr7bike::writeCharacteristic(uint8_t *data, uint8_t data_len, const
         timeout.singleShot(300ms, &loop, &QEventLoop::quit);
     }
 
+    writeRequested(QByteArray((const char *)data, data_len));
     gattFTMSService->writeCharacteristic(gattWriteCharControlPointId, QByteArray((const char *)data, data_len));
 
     if (!disable_log) {
-        emit debug(QStringLiteral(" >> ") + QByteArray((const char *)data, data_len).toHex(' ') +
+        LOG_PACKET(QStringLiteral(" >> ") + QByteArray((const char *)data, data_len).toHex(' ') +
                    QStringLiteral(" // ") + info);
     }
 
@@ -98,13 +101,14 @@ void horizongr7bike::update() {
             }
 
             if (requestResistance != currentResistance().value()) {
-                emit debug(QStringLiteral("writing resistance ") + QString::number(requestResistance));
+                LOG_DEVICE(QStringLiteral("writing resistance ") + QString::number(requestResistance));
+                requestQueued();
                 forceResistance(requestResistance);
             }
             requestResistance = -1;
         }
         if (requestStart != -1) {
-            emit debug(QStringLiteral("starting..."));
+            LOG_DEVICE(QStringLiteral("starting..."));
 
             // btinit();
 
@@ -112,7 +116,7 @@ void horizongr7bike::update() {
             emit bikeStarted();
         }
         if (requestStop != -1) {
-            emit debug(QStringLiteral("stopping..."));
+            LOG_DEVICE(QStringLiteral("stopping..."));
             // writeCharacteristic(initDataF0C800B8, sizeof(initDataF0C800B8), "stop tape");
             requestStop = -1;
         }
@@ -120,7 +124,7 @@ void horizongr7bike::update() {
 }
 
 void horizongr7bike::serviceDiscovered(const QBluetoothUuid &gatt) {
-    emit debug(QStringLiteral("serviceDiscovered ") + gatt.toString());
+    LOG_DEVICE(QStringLiteral("serviceDiscovered ") + gatt.toString());
 }
 
 void horizongr7bike::characteristicChanged(const QLowEnergyCharacteristic &characteristic, const QByteArray &newValue) {
@@ -132,141 +136,63 @@ void horizongr7bike::characteristicChanged(const QLowEnergyCharacteristic &chara
     bool disable_hr_frommachinery = settings.value(QStringLiteral("heart_ignore_builtin"), false).toBool();
     static bool firstPacket = false;
 
-    emit debug(QStringLiteral(" << ") + newValue.toHex(' '));
+    LOG_PACKET(QStringLiteral(" << ") + newValue.toHex(' '));
 
-    if (characteristic.uuid() != QBluetoothUuid((quint16)0x2AD2)) {
+    ftmsparser::data d;
+    if (characteristic.uuid() != QBluetoothUuid((quint16)ftmsparser::INDOOR_BIKE_DATA)) {
         return;
     }
+    if (!ftmsparser::parse(ftmsparser::INDOOR_BIKE_DATA, newValue.constData(), newValue.length(), d)) {
+        LOG_DEVICE(QStringLiteral("truncated indoor bike data"));
+    }
 
     lastPacket = newValue;
 
-    union flags {
-        struct {
-            uint16_t moreData : 1;
-            uint16_t avgSpeed : 1;
-            uint16_t instantCadence : 1;
-            uint16_t avgCadence : 1;
-            uint16_t totDistance : 1;
-            uint16_t resistanceLvl : 1;
-            uint16_t instantPower : 1;
-            uint16_t avgPower : 1;
-            uint16_t expEnergy : 1;
-            uint16_t heartRate : 1;
-            uint16_t metabolic : 1;
-            uint16_t elapsedTime : 1;
-            uint16_t remainingTime : 1;
-            uint16_t spare : 3;
-        };
-
-        uint16_t word_flags;
-    };
-
-    flags Flags;
-    int index = 0;
-    Flags.word_flags = (newValue.at(1) << 8) | newValue.at(0);
-    index += 2;
-
-    if (!Flags.moreData) {
+    if (d.has(ftmsparser::INSTANT_SPEED)) {
         if (!settings.value(QStringLiteral("speed_power_based"), false).toBool()) {
-            Speed = ((double)(((uint16_t)((uint8_t)newValue.at(index + 1)) << 8) |
-                              (uint16_t)((uint8_t)newValue.at(index)))) /
-                    100.0;
+            Speed = d[ftmsparser::INSTANT_SPEED];
         } else {
             Speed = metric::calculateSpeedFromPower(m_watt.value());
         }
-        index += 2;
-        emit debug(QStringLiteral("Current Speed: ") + QString::number(Speed.value()));
-    }
-
-    if (Flags.avgSpeed) {
-        double avgSpeed;
-        avgSpeed =
-            ((double)(((uint16_t)((uint8_t)newValue.at(index + 1)) << 8) | (uint16_t)((uint8_t)newValue.at(index)))) /
-            100.0;
-        index += 2;
-        emit debug(QStringLiteral("Current Average Speed: ") + QString::number(avgSpeed));
+        LOG_DEVICE(QStringLiteral("Current Speed: ") + QString::number(Speed.value()));
     }
 
-    if (Flags.instantCadence) {
+    if (d.has(ftmsparser::INSTANT_CADENCE)) {
         if (settings.value(QStringLiteral("cadence_sensor_name"), QStringLiteral("Disabled"))
                 .toString()
                 .startsWith(QStringLiteral("Disabled"))) {
 
             // this bike sent a cadence 1/10 of the real one
-            Cadence = (((double)(((uint16_t)((uint8_t)newValue.at(index + 1)) << 8) |
-                                 (uint16_t)((uint8_t)newValue.at(index)))) /
-                       2.0) *
+            Cadence = d[ftmsparser::INSTANT_CADENCE] *
                       settings.value(QStringLiteral("horizon_gr7_cadence_multiplier"), 1.0).toDouble();
         }
-        index += 2;
-        emit debug(QStringLiteral("Current Cadence: ") + QString::number(Cadence.value()));
-    }
-
-    if (Flags.avgCadence) {
-        double avgCadence;
-        avgCadence =
-            (((double)(((uint16_t)((uint8_t)newValue.at(index + 1)) << 8) | (uint16_t)((uint8_t)newValue.at(index)))) /
-             2.0) *
-            settings.value(QStringLiteral("horizon_gr7_cadence_multiplier"), 1.0).toDouble();
-        index += 2;
-        emit debug(QStringLiteral("Current Average Cadence: ") + QString::number(avgCadence));
+        LOG_DEVICE(QStringLiteral("Current Cadence: ") + QString::number(Cadence.value()));
     }
 
-    if (Flags.totDistance) {
-        // this bike sent the distance but it doesn't send the avg cadence, so the parsing is wrong.
-        // Let's calculate the distance by software
-        /*Distance = ((double)((((uint32_t)((uint8_t)newValue.at(index + 2)) << 16) |
-                              (uint32_t)((uint8_t)newValue.at(index + 1)) << 8) |
-                             (uint32_t)((uint8_t)newValue.at(index)))) /
-                   1000.0;*/
-        if(firstPacket)
-            Distance += ((Speed.value() / 3600000.0) *
+    // this bike sent the distance but it doesn't send the avg cadence, so the parsing is wrong.
+    // Let's calculate the distance by software
+    if (firstPacket)
+        Distance += ((Speed.value() / 3600000.0) *
                      ((double)lastRefreshCharacteristicChanged.msecsTo(QDateTime::currentDateTime())));
 
-        index += 3;
-    } else {
-        if(firstPacket)
-            Distance += ((Speed.value() / 3600000.0) *
-                     ((double)lastRefreshCharacteristicChanged.msecsTo(QDateTime::currentDateTime())));
-    }
+    LOG_DEVICE(QStringLiteral("Current Distance: ") + QString::number(Distance.value()));
 
-    emit debug(QStringLiteral("Current Distance: ") + QString::number(Distance.value()));
-
-    if (Flags.resistanceLvl) {
-        Resistance =
-            ((double)(((uint16_t)((uint8_t)newValue.at(index + 1)) << 8) | (uint16_t)((uint8_t)newValue.at(index))));
+    if (d.has(ftmsparser::RESISTANCE)) {
+        Resistance = d[ftmsparser::RESISTANCE];
         emit resistanceRead(Resistance.value());
-        index += 2;
-        emit debug(QStringLiteral("Current Resistance: ") + QString::number(Resistance.value()));
+        LOG_DEVICE(QStringLiteral("Current Resistance: ") + QString::number(Resistance.value()));
     }
 
-    if (Flags.instantPower) {
+    if (d.has(ftmsparser::INSTANT_POWER)) {
         if (settings.value(QStringLiteral("power_sensor_name"), QStringLiteral("Disabled"))
                 .toString()
                 .startsWith(QStringLiteral("Disabled")))
-            m_watt = ((double)(((uint16_t)((uint8_t)newValue.at(index + 1)) << 8) |
-                               (uint16_t)((uint8_t)newValue.at(index))));
-        index += 2;
-        emit debug(QStringLiteral("Current Watt: ") + QString::number(m_watt.value()));
-    }
-
-    if (Flags.avgPower) {
-        double avgPower;
-        avgPower =
-            ((double)(((uint16_t)((uint8_t)newValue.at(index + 1)) << 8) | (uint16_t)((uint8_t)newValue.at(index))));
-        index += 2;
-        emit debug(QStringLiteral("Current Average Watt: ") + QString::number(avgPower));
+            m_watt = d[ftmsparser::INSTANT_POWER];
+        LOG_DEVICE(QStringLiteral("Current Watt: ") + QString::number(m_watt.value()));
     }
 
-    if (Flags.expEnergy && newValue.length() > index + 1) {
-        KCal = ((double)(((uint16_t)((uint8_t)newValue.at(index + 1)) << 8) | (uint16_t)((uint8_t)newValue.at(index))));
-        index += 2;
-
-        // energy per hour
-        index += 2;
-
-        // energy per minute
-        index += 1;
+    if (d.has(ftmsparser::TOTAL_ENERGY)) {
+        KCal = d[ftmsparser::TOTAL_ENERGY];
     } else {
         if (watts())
             KCal +=
@@ -278,35 +204,22 @@ void horizongr7bike::characteristicChanged(const QLowEnergyCharacteristic &chara
                                                                   // kg * 3.5) / 200 ) / 60
     }
 
-    emit debug(QStringLiteral("Current KCal: ") + QString::number(KCal.value()));
+    LOG_DEVICE(QStringLiteral("Current KCal: ") + QString::number(KCal.value()));
 
+    bool heartRate = false;
 #ifdef Q_OS_ANDROID
     if (settings.value("ant_heart", false).toBool())
         Heart = (uint8_t)KeepAwakeHelper::heart();
     else
 #endif
     {
-        if (Flags.heartRate && !disable_hr_frommachinery && newValue.length() > index) {
-            Heart = ((double)((newValue.at(index))));
-            // index += 1; // NOTE: clang-analyzer-deadcode.DeadStores
-            emit debug(QStringLiteral("Current Heart: ") + QString::number(Heart.value()));
-        } else {
-            Flags.heartRate = false;
+        if (d.has(ftmsparser::HEART_RATE) && !disable_hr_frommachinery) {
+            Heart = d[ftmsparser::HEART_RATE];
+            heartRate = true;
+            LOG_DEVICE(QStringLiteral("Current Heart: ") + QString::number(Heart.value()));
         }
     }
 
-    if (Flags.metabolic) {
-        // todo
-    }
-
-    if (Flags.elapsedTime) {
-        // todo
-    }
-
-    if (Flags.remainingTime) {
-        // todo
-    }
-
     if (Cadence.value() > 0) {
         CrankRevs++;
         LastCrankEventTime += (uint16_t)(1024.0 / (((double)(Cadence.value())) / 60.0));
@@ -315,7 +228,7 @@ void horizongr7bike::characteristicChanged(const QLowEnergyCharacteristic &chara
     lastRefreshCharacteristicChanged = QDateTime::currentDateTime();
 
     if (heartRateBeltName.startsWith(QStringLiteral("Disabled")) &&
-        (!Flags.heartRate || Heart.value() == 0 || disable_hr_frommachinery)) {
+        (!heartRate || Heart.value() == 0 || disable_hr_frommachinery)) {
 #ifdef Q_OS_IOS
 #ifndef IO_UNDER_QT
         lockscreen h;
@@ -339,8 +252,8 @@ void horizongr7bike::characteristicChanged(const QLowEnergyCharacteristic &chara
 #endif
 #endif
 
-    emit debug(QStringLiteral("Current CrankRevs: ") + QString::number(CrankRevs));
-    emit debug(QStringLiteral("Last CrankEventTime: ") + QString::number(LastCrankEventTime));
+    LOG_DEVICE(QStringLiteral("Current CrankRevs: ") + QString::number(CrankRevs));
+    LOG_DEVICE(QStringLiteral("Last CrankEventTime: ") + QString::number(LastCrankEventTime));
 
     if (m_control->error() != QLowEnergyController::NoError) {
         qDebug() << QStringLiteral("QLowEnergyController ERROR!!") << m_control->errorString();
@@ -351,7 +264,7 @@ void horizongr7bike::characteristicChanged(const QLowEnergyCharacteristic &chara
 
 void horizongr7bike::stateChanged(QLowEnergyService::ServiceState state) {
     QMetaEnum metaEnum = QMetaEnum::fromType<QLowEnergyService::ServiceState>();
-    emit debug(QStringLiteral("BTLE stateChanged ") + QString::fromLocal8Bit(metaEnum.valueToKey(state)));
+    LOG_DEVICE(QStringLiteral("BTLE stateChanged ") + QString::fromLocal8Bit(metaEnum.valueToKey(state)));
 
     for (QLowEnergyService *s : qAsConst(gattCommunicationChannelService)) {
         qDebug() << QStringLiteral("stateChanged") << s->serviceUuid() << s->state();
@@ -451,7 +364,7 @@ void horizongr7bike::stateChanged(QLowEnergyService::ServiceState state) {
 #endif
 #endif
             if (virtual_device_enabled) {
-            emit debug(QStringLiteral("creating virtual bike interface..."));
+            LOG_DEVICE(QStringLiteral("creating virtual bike interface..."));
             virtualBike =
                 new virtualbike(this, noWriteResistance, noHeartService, bikeResistanceOffset, bikeResistanceGain);
             // connect(virtualBike,&virtualbike::debug ,this,&horizongr7bike::debug);
@@ -475,7 +388,7 @@ void horizongr7bike::ftmsCharacteristicChanged(const QLowEnergyCharacteristic &c
 }
 
 void horizongr7bike::descriptorWritten(const QLowEnergyDescriptor &descriptor, const QByteArray &newValue) {
-    emit debug(QStringLiteral("descriptorWritten ") + descriptor.name() + QStringLiteral(" ") + newValue.toHex(' '));
+    LOG_PACKET(QStringLiteral("descriptorWritten ") + descriptor.name() + QStringLiteral(" ") + newValue.toHex(' '));
 
     initRequest = true;
     emit connectedAndDiscovered();
@@ -487,7 +400,7 @@ void horizongr7bike::descriptorRead(const QLowEnergyDescriptor &descriptor, cons
 
 void horizongr7bike::characteristicWritten(const QLowEnergyCharacteristic &characteristic, const QByteArray &newValue) {
     Q_UNUSED(characteristic);
-    emit debug(QStringLiteral("characteristicWritten ") + newValue.toHex(' '));
+    LOG_PACKET(QStringLiteral("characteristicWritten ") + newValue.toHex(' '));
 }
 
 void horizongr7bike::characteristicRead(const QLowEnergyCharacteristic &characteristic, const QByteArray &newValue) {
@@ -495,7 +408,7 @@ void horizongr7bike::characteristicRead(const QLowEnergyCharacteristic &characte
 }
 
 void horizongr7bike::serviceScanDone(void) {
-    emit debug(QStringLiteral("serviceScanDone"));
+    LOG_DEVICE(QStringLiteral("serviceScanDone"));
 
 #ifdef Q_OS_ANDROID
     QLowEnergyConnectionParameters c;
@@ -517,18 +430,18 @@ void horizongr7bike::serviceScanDone(void) {
 
 void horizongr7bike::errorService(QLowEnergyService::ServiceError err) {
     QMetaEnum metaEnum = QMetaEnum::fromType<QLowEnergyService::ServiceError>();
-    emit debug(QStringLiteral("horizongr7bike::errorService") + QString::fromLocal8Bit(metaEnum.valueToKey(err)) +
+    LOG_DEVICE(QStringLiteral("horizongr7bike::errorService") + QString::fromLocal8Bit(metaEnum.valueToKey(err)) +
                m_control->errorString());
 }
 
 void horizongr7bike::error(QLowEnergyController::Error err) {
     QMetaEnum metaEnum = QMetaEnum::fromType<QLowEnergyController::Error>();
-    emit debug(QStringLiteral("horizongr7bike::error") + QString::fromLocal8Bit(metaEnum.valueToKey(err)) +
+    LOG_DEVICE(QStringLiteral("horizongr7bike::error") + QString::fromLocal8Bit(metaEnum.valueToKey(err)) +
                m_control->errorString());
 }
 
 void horizongr7bike::deviceDiscovered(const QBluetoothDeviceInfo &device) {
-    emit debug(QStringLiteral("Found new device: ") + device.name() + QStringLiteral(" (") +
+    LOG_DEVICE(QStringLiteral("Found new device: ") + device.name() + QStringLiteral(" (") +
                device.address().toString() + ')');
     {
         bluetoothDevice = device;
@@ -546,17 +459,17 @@ void horizongr7bike::deviceDiscovered(const QBluetoothDeviceInfo &device) {
                 this, [this](QLowEnergyController::Error error) {
                     Q_UNUSED(error);
                     Q_UNUSED(this);
-                    emit debug(QStringLiteral("Cannot connect to remote device."));
+                    LOG_DEVICE(QStringLiteral("Cannot connect to remote device."));
                     emit disconnected();
                 });
         connect(m_control, &QLowEnergyController::connected, this, [this]() {
             Q_UNUSED(this);
-            emit debug(QStringLiteral("Controller connected. Search services..."));
+            LOG_DEVICE(QStringLiteral("Controller connected. Search services..."));
             m_control->discoverServices();
         });
         connect(m_control, &QLowEnergyController::disconnected, this, [this]() {
             Q_UNUSED(this);
-            emit debug(QStringLiteral("LowEnergy controller disconnected"));
+            LOG_DEVICE(QStringLiteral("LowEnergy controller disconnected"));
             emit disconnected();
         });
 
@@ -1,4 +1,6 @@
 #include "horizontreadmill.h"
+#include "logging.h"
+#include "ftmsparser.h"
 
 #include "ftmsbike.h"
 #include "ios/lockscreen.h"
@@ -38,13 +40,12 @@ horizontreadmill::horizontreadmill(bool noWriteResistance, bool noHeartService)
     refresh->start(200ms);
 }
 
-void horizontreadmill::writeCharacteristic(QLowEnergyService *service, QLowEnergyCharacteristic characteristic,
-                                           uint8_t *data, uint8_t data_len, QString info, bool disable_log,
-                                           bool wait_for_response) {
+void horizontreadmill::writeCharacteristic(const QBluetoothUuid &characteristic, uint8_t *data, uint8_t data_len,
+                                           QString info, bool disable_log, bool wait_for_response) {
     QEventLoop loop;
     QTimer timeout;
 
-    if (!service) {
+    if (characteristic.isNull()) {
         qDebug() << "no gattCustomService available";
         return;
     }
@@ -53,11 +54,12 @@ void horizontreadmill::writeCharacteristic(QLowEnergyService *service, QLowEnerg
         connect(this, &horizontreadmill::packetReceived, &loop, &QEventLoop::quit);
         timeout.singleShot(3000, &loop, SLOT(quit()));
     } else {
-        connect(service, SIGNAL(characteristicWritten(QLowEnergyCharacteristic, QByteArray)), &loop, SLOT(quit()));
+        connect(transport, &bluetoothtransport::characteristicWritten, &loop, &QEventLoop::quit);
         timeout.singleShot(3000, &loop, SLOT(quit()));
     }
 
-    service->writeCharacteristic(characteristic, QByteArray((const char *)data, data_len));
+    writeRequested(QByteArray((const char *)data, data_len));
+    transport->writeCharacteristic(characteristic, QByteArray((const char *)data, data_len));
 
     if (!disable_log)
         qDebug() << " >> " << QByteArray((const char *)data, data_len).toHex(' ') << " // " << info;
@@ -148,569 +150,569 @@ void horizontreadmill::btinit() {
                            0x00, 0x00, 0x08, 0x07, 0x00, 0x00, 0x00, 0x00, 0x00, 0x05};
     uint8_t initData6[] = {0x00, 0x00, 0x00, 0x01, 0x00, 0x00, 0x01};
 
-    if (gattCustomService) {
-        writeCharacteristic(gattCustomService, gattWriteCharCustomService, initData01, sizeof(initData01),
+    if (!gattWriteCharCustomService.isNull()) {
+        writeCharacteristic(gattWriteCharCustomService, initData01, sizeof(initData01),
                             QStringLiteral("init"), false, true);
         waitForAPacket();
 
-        writeCharacteristic(gattCustomService, gattWriteCharCustomService, initData7, sizeof(initData7),
+        writeCharacteristic(gattWriteCharCustomService, initData7, sizeof(initData7),
                             QStringLiteral("init"), false, false);
-        writeCharacteristic(gattCustomService, gattWriteCharCustomService, initData8, sizeof(initData8),
+        writeCharacteristic(gattWriteCharCustomService, initData8, sizeof(initData8),
                             QStringLiteral("init"), false, false);
-        writeCharacteristic(gattCustomService, gattWriteCharCustomService, initData8, sizeof(initData8),
+        writeCharacteristic(gattWriteCharCustomService, initData8, sizeof(initData8),
                             QStringLiteral("init"), false, false);
-        writeCharacteristic(gattCustomService, gattWriteCharCustomService, initData9, sizeof(initData9),
+        writeCharacteristic(gattWriteCharCustomService, initData9, sizeof(initData9),
                             QStringLiteral("init"), false, false);
-        writeCharacteristic(gattCustomService, gattWriteCharCustomService, initData10, sizeof(initData10),
+        writeCharacteristic(gattWriteCharCustomService, initData10, sizeof(initData10),
                             QStringLiteral("init"), false, false);
-        writeCharacteristic(gattCustomService, gattWriteCharCustomService, initData11, sizeof(initData11),
+        writeCharacteristic(gattWriteCharCustomService, initData11, sizeof(initData11),
                             QStringLiteral("init"), false, false);
-        writeCharacteristic(gattCustomService, gattWriteCharCustomService, initData11, sizeof(initData11),
+        writeCharacteristic(gattWriteCharCustomService, initData11, sizeof(initData11),
                             QStringLiteral("init"), false, false);
-        writeCharacteristic(gattCustomService, gattWriteCharCustomService, initData11, sizeof(initData11),
+        writeCharacteristic(gattWriteCharCustomService, initData11, sizeof(initData11),
                             QStringLiteral("init"), false, false);
-        writeCharacteristic(gattCustomService, gattWriteCharCustomService, initData11, sizeof(initData11),
+        writeCharacteristic(gattWriteCharCustomService, initData11, sizeof(initData11),
                             QStringLiteral("init"), false, false);
-        writeCharacteristic(gattCustomService, gattWriteCharCustomService, initData11, sizeof(initData11),
+        writeCharacteristic(gattWriteCharCustomService, initData11, sizeof(initData11),
                             QStringLiteral("init"), false, false);
-        writeCharacteristic(gattCustomService, gattWriteCharCustomService, initData11, sizeof(initData11),
+        writeCharacteristic(gattWriteCharCustomService, initData11, sizeof(initData11),
                             QStringLiteral("init"), false, false);
-        writeCharacteristic(gattCustomService, gattWriteCharCustomService, initData11, sizeof(initData11),
+        writeCharacteristic(gattWriteCharCustomService, initData11, sizeof(initData11),
                             QStringLiteral("init"), false, false);
-        writeCharacteristic(gattCustomService, gattWriteCharCustomService, initData11, sizeof(initData11),
+        writeCharacteristic(gattWriteCharCustomService, initData11, sizeof(initData11),
                             QStringLiteral("init"), false, false);
-        writeCharacteristic(gattCustomService, gattWriteCharCustomService, initData11, sizeof(initData11),
+        writeCharacteristic(gattWriteCharCustomService, initData11, sizeof(initData11),
                             QStringLiteral("init"), false, false);
-        writeCharacteristic(gattCustomService, gattWriteCharCustomService, initData11, sizeof(initData11),
+        writeCharacteristic(gattWriteCharCustomService, initData11, sizeof(initData11),
                             QStringLiteral("init"), false, false);
-        writeCharacteristic(gattCustomService, gattWriteCharCustomService, initData11, sizeof(initData11),
+        writeCharacteristic(gattWriteCharCustomService, initData11, sizeof(initData11),
                             QStringLiteral("init"), false, false);
-        writeCharacteristic(gattCustomService, gattWriteCharCustomService, initData11, sizeof(initData11),
+        writeCharacteristic(gattWriteCharCustomService, initData11, sizeof(initData11),
                             QStringLiteral("init"), false, false);
-        writeCharacteristic(gattCustomService, gattWriteCharCustomService, initData11, sizeof(initData11),
+        writeCharacteristic(gattWriteCharCustomService, initData11, sizeof(initData11),
                             QStringLiteral("init"), false, false);
-        writeCharacteristic(gattCustomService, gattWriteCharCustomService, initData11, sizeof(initData11),
+        writeCharacteristic(gattWriteCharCustomService, initData11, sizeof(initData11),
                             QStringLiteral("init"), false, false);
-        writeCharacteristic(gattCustomService, gattWriteCharCustomService, initData11, sizeof(initData11),
+        writeCharacteristic(gattWriteCharCustomService, initData11, sizeof(initData11),
                             QStringLiteral("init"), false, false);
-        writeCharacteristic(gattCustomService, gattWriteCharCustomService, initData11, sizeof(initData11),
+        writeCharacteristic(gattWriteCharCustomService, initData11, sizeof(initData11),
                             QStringLiteral("init"), false, false);
-        writeCharacteristic(gattCustomService, gattWriteCharCustomService, initData11, sizeof(initData11),
+        writeCharacteristic(gattWriteCharCustomService, initData11, sizeof(initData11),
                             QStringLiteral("init"), false, false);
-        writeCharacteristic(gattCustomService, gattWriteCharCustomService, initData12, sizeof(initData12),
+        writeCharacteristic(gattWriteCharCustomService, initData12, sizeof(initData12),
                             QStringLiteral("init"), false, false);
-        writeCharacteristic(gattCustomService, gattWriteCharCustomService, initData8, sizeof(initData8),
+        writeCharacteristic(gattWriteCharCustomService, initData8, sizeof(initData8),
                             QStringLiteral("init"), false, false);
-        writeCharacteristic(gattCustomService, gattWriteCharCustomService, initData8, sizeof(initData8),
+        writeCharacteristic(gattWriteCharCustomService, initData8, sizeof(initData8),
                             QStringLiteral("init"), false, false);
-        writeCharacteristic(gattCustomService, gattWriteCharCustomService, initData8, sizeof(initData8),
+        writeCharacteristic(gattWriteCharCustomService, initData8, sizeof(initData8),
                             QStringLiteral("init"), false, false);
-        writeCharacteristic(gattCustomService, gattWriteCharCustomService, initData8, sizeof(initData8),
+        writeCharacteristic(gattWriteCharCustomService, initData8, sizeof(initData8),
                             QStringLiteral("init"), false, false);
-        writeCharacteristic(gattCustomService, gattWriteCharCustomService, initData8, sizeof(initData8),
+        writeCharacteristic(gattWriteCharCustomService, initData8, sizeof(initData8),
                             QStringLiteral("init"), false, false);
-        writeCharacteristic(gattCustomService, gattWriteCharCustomService, initData8, sizeof(initData8),
+        writeCharacteristic(gattWriteCharCustomService, initData8, sizeof(initData8),
                             QStringLiteral("init"), false, false);
-        writeCharacteristic(gattCustomService, gattWriteCharCustomService, initData8, sizeof(initData8),
+        writeCharacteristic(gattWriteCharCustomService, initData8, sizeof(initData8),
                             QStringLiteral("init"), false, false);
-        writeCharacteristic(gattCustomService, gattWriteCharCustomService, initData8, sizeof(initData8),
+        writeCharacteristic(gattWriteCharCustomService, initData8, sizeof(initData8),
                             QStringLiteral("init"), false, false);
-        writeCharacteristic(gattCustomService, gattWriteCharCustomService, initData8, sizeof(initData8),
+        writeCharacteristic(gattWriteCharCustomService, initData8, sizeof(initData8),
                             QStringLiteral("init"), false, false);
-        writeCharacteristic(gattCustomService, gattWriteCharCustomService, initData8, sizeof(initData8),
+        writeCharacteristic(gattWriteCharCustomService, initData8, sizeof(initData8),
                             QStringLiteral("init"), false, false);
-        writeCharacteristic(gattCustomService, gattWriteCharCustomService, initData8, sizeof(initData8),
+        writeCharacteristic(gattWriteCharCustomService, initData8, sizeof(initData8),
                             QStringLiteral("init"), false, false);
-        writeCharacteristic(gattCustomService, gattWriteCharCustomService, initData8, sizeof(initData8),
+        writeCharacteristic(gattWriteCharCustomService, initData8, sizeof(initData8),
                             QStringLiteral("init"), false, false);
-        writeCharacteristic(gattCustomService, gattWriteCharCustomService, initData8, sizeof(initData8),
+        writeCharacteristic(gattWriteCharCustomService, initData8, sizeof(initData8),
                             QStringLiteral("init"), false, false);
-        writeCharacteristic(gattCustomService, gattWriteCharCustomService, initData13, sizeof(initData13),
+        writeCharacteristic(gattWriteCharCustomService, initData13, sizeof(initData13),
                             QStringLiteral("init"), false, false);
-        writeCharacteristic(gattCustomService, gattWriteCharCustomService, initData14, sizeof(initData14),
+        writeCharacteristic(gattWriteCharCustomService, initData14, sizeof(initData14),
                             QStringLiteral("init"), false, true);
 
-        writeCharacteristic(gattCustomService, gattWriteCharCustomService, initData7_1, sizeof(initData7_1),
+        writeCharacteristic(gattWriteCharCustomService, initData7_1, sizeof(initData7_1),
                             QStringLiteral("init"), false, false);
-        writeCharacteristic(gattCustomService, gattWriteCharCustomService, initData8, sizeof(initData8),
+        writeCharacteristic(gattWriteCharCustomService, initData8, sizeof(initData8),
                             QStringLiteral("init"), false, false);
-        writeCharacteristic(gattCustomService, gattWriteCharCustomService, initData8, sizeof(initData8),
+        writeCharacteristic(gattWriteCharCustomService, initData8, sizeof(initData8),
                             QStringLiteral("init"), false, false);
-        writeCharacteristic(gattCustomService, gattWriteCharCustomService, initData9_1, sizeof(initData9_1),
+        writeCharacteristic(gattWriteCharCustomService, initData9_1, sizeof(initData9_1),
                             QStringLiteral("init"), false, false);
-        writeCharacteristic(gattCustomService, gattWriteCharCustomService, initData10_1, sizeof(initData10_1),
+        writeCharacteristic(gattWriteCharCustomService, initData10_1, sizeof(initData10_1),
                             QStringLiteral("init"), false, false);
-        writeCharacteristic(gattCustomService, gattWriteCharCustomService, initData11, sizeof(initData11),
+        writeCharacteristic(gattWriteCharCustomService, initData11, sizeof(initData11),
                             QStringLiteral("init"), false, false);
-        writeCharacteristic(gattCustomService, gattWriteCharCustomService, initData11, sizeof(initData11),
+        writeCharacteristic(gattWriteCharCustomService, initData11, sizeof(initData11),
                             QStringLiteral("init"), false, false);
-        writeCharacteristic(gattCustomService, gattWriteCharCustomService, initData11, sizeof(initData11),
+        writeCharacteristic(gattWriteCharCustomService, initData11, sizeof(initData11),
                             QStringLiteral("init"), false, false);
-        writeCharacteristic(gattCustomService, gattWriteCharCustomService, initData11, sizeof(initData11),
+        writeCharacteristic(gattWriteCharCustomService, initData11, sizeof(initData11),
                             QStringLiteral("init"), false, false);
-        writeCharacteristic(gattCustomService, gattWriteCharCustomService, initData11, sizeof(initData11),
+        writeCharacteristic(gattWriteCharCustomService, initData11, sizeof(initData11),
                             QStringLiteral("init"), false, false);
-        writeCharacteristic(gattCustomService, gattWriteCharCustomService, initData11, sizeof(initData11),
+        writeCharacteristic(gattWriteCharCustomService, initData11, sizeof(initData11),
                             QStringLiteral("init"), false, false);
-        writeCharacteristic(gattCustomService, gattWriteCharCustomService, initData11, sizeof(initData11),
+        writeCharacteristic(gattWriteCharCustomService, initData11, sizeof(initData11),
                             QStringLiteral("init"), false, false);
-        writeCharacteristic(gattCustomService, gattWriteCharCustomService, initData11, sizeof(initData11),
+        writeCharacteristic(gattWriteCharCustomService, initData11, sizeof(initData11),
                             QStringLiteral("init"), false, false);
-        writeCharacteristic(gattCustomService, gattWriteCharCustomService, initData11, sizeof(initData11),
+        writeCharacteristic(gattWriteCharCustomService, initData11, sizeof(initData11),
                             QStringLiteral("init"), false, false);
-        writeCharacteristic(gattCustomService, gattWriteCharCustomService, initData11, sizeof(initData11),
+        writeCharacteristic(gattWriteCharCustomService, initData11, sizeof(initData11),
                             QStringLiteral("init"), false, false);
-        writeCharacteristic(gattCustomService, gattWriteCharCustomService, initData11, sizeof(initData11),
+        writeCharacteristic(gattWriteCharCustomService, initData11, sizeof(initData11),
                             QStringLiteral("init"), false, false);
-        writeCharacteristic(gattCustomService, gattWriteCharCustomService, initData11, sizeof(initData11),
+        writeCharacteristic(gattWriteCharCustomService, initData11, sizeof(initData11),
                             QStringLiteral("init"), false, false);
-        writeCharacteristic(gattCustomService, gattWriteCharCustomService, initData11, sizeof(initData11),
+        writeCharacteristic(gattWriteCharCustomService, initData11, sizeof(initData11),
                             QStringLiteral("init"), false, false);
-        writeCharacteristic(gattCustomService, gattWriteCharCustomService, initData11, sizeof(initData11),
+        writeCharacteristic(gattWriteCharCustomService, initData11, sizeof(initData11),
                             QStringLiteral("init"), false, false);
-        writeCharacteristic(gattCustomService, gattWriteCharCustomService, initData11, sizeof(initData11),
+        writeCharacteristic(gattWriteCharCustomService, initData11, sizeof(initData11),
                             QStringLiteral("init"), false, false);
-        writeCharacteristic(gattCustomService, gattWriteCharCustomService, initData11, sizeof(initData11),
+        writeCharacteristic(gattWriteCharCustomService, initData11, sizeof(initData11),
                             QStringLiteral("init"), false, false);
-        writeCharacteristic(gattCustomService, gattWriteCharCustomService, initData11, sizeof(initData11),
+        writeCharacteristic(gattWriteCharCustomService, initData11, sizeof(initData11),
                             QStringLiteral("init"), false, false);
-        writeCharacteristic(gattCustomService, gattWriteCharCustomService, initData12, sizeof(initData12),
+        writeCharacteristic(gattWriteCharCustomService, initData12, sizeof(initData12),
                             QStringLiteral("init"), false, false);
-        writeCharacteristic(gattCustomService, gattWriteCharCustomService, initData8, sizeof(initData8),
+        writeCharacteristic(gattWriteCharCustomService, initData8, sizeof(initData8),
                             QStringLiteral("init"), false, false);
-        writeCharacteristic(gattCustomService, gattWriteCharCustomService, initData8, sizeof(initData8),
+        writeCharacteristic(gattWriteCharCustomService, initData8, sizeof(initData8),
                             QStringLiteral("init"), false, false);
-        writeCharacteristic(gattCustomService, gattWriteCharCustomService, initData8, sizeof(initData8),
+        writeCharacteristic(gattWriteCharCustomService, initData8, sizeof(initData8),
                             QStringLiteral("init"), false, false);
-        writeCharacteristic(gattCustomService, gattWriteCharCustomService, initData8, sizeof(initData8),
+        writeCharacteristic(gattWriteCharCustomService, initData8, sizeof(initData8),
                             QStringLiteral("init"), false, false);
-        writeCharacteristic(gattCustomService, gattWriteCharCustomService, initData8, sizeof(initData8),
+        writeCharacteristic(gattWriteCharCustomService, initData8, sizeof(initData8),
                             QStringLiteral("init"), false, false);
-        writeCharacteristic(gattCustomService, gattWriteCharCustomService, initData8, sizeof(initData8),
+        writeCharacteristic(gattWriteCharCustomService, initData8, sizeof(initData8),
                             QStringLiteral("init"), false, false);
-        writeCharacteristic(gattCustomService, gattWriteCharCustomService, initData8, sizeof(initData8),
+        writeCharacteristic(gattWriteCharCustomService, initData8, sizeof(initData8),
                             QStringLiteral("init"), false, false);
-        writeCharacteristic(gattCustomService, gattWriteCharCustomService, initData8, sizeof(initData8),
+        writeCharacteristic(gattWriteCharCustomService, initData8, sizeof(initData8),
                             QStringLiteral("init"), false, false);
-        writeCharacteristic(gattCustomService, gattWriteCharCustomService, initData8, sizeof(initData8),
+        writeCharacteristic(gattWriteCharCustomService, initData8, sizeof(initData8),
                             QStringLiteral("init"), false, false);
-        writeCharacteristic(gattCustomService, gattWriteCharCustomService, initData8, sizeof(initData8),
+        writeCharacteristic(gattWriteCharCustomService, initData8, sizeof(initData8),
                             QStringLiteral("init"), false, false);
-        writeCharacteristic(gattCustomService, gattWriteCharCustomService, initData8, sizeof(initData8),
+        writeCharacteristic(gattWriteCharCustomService, initData8, sizeof(initData8),
                             QStringLiteral("init"), false, false);
-        writeCharacteristic(gattCustomService, gattWriteCharCustomService, initData8, sizeof(initData8),
+        writeCharacteristic(gattWriteCharCustomService, initData8, sizeof(initData8),
                             QStringLiteral("init"), false, false);
-        writeCharacteristic(gattCustomService, gattWriteCharCustomService, initData8, sizeof(initData8),
+        writeCharacteristic(gattWriteCharCustomService, initData8, sizeof(initData8),
                             QStringLiteral("init"), false, false);
-        writeCharacteristic(gattCustomService, gattWriteCharCustomService, initData13, sizeof(initData13),
+        writeCharacteristic(gattWriteCharCustomService, initData13, sizeof(initData13),
                             QStringLiteral("init"), false, false);
-        writeCharacteristic(gattCustomService, gattWriteCharCustomService, initData14, sizeof(initData14),
+        writeCharacteristic(gattWriteCharCustomService, initData14, sizeof(initData14),
                             QStringLiteral("init"), false, true);
 
-        writeCharacteristic(gattCustomService, gattWriteCharCustomService, initData7_2, sizeof(initData7_2),
+        writeCharacteristic(gattWriteCharCustomService, initData7_2, sizeof(initData7_2),
                             QStringLiteral("init"), false, false);
-        writeCharacteristic(gattCustomService, gattWriteCharCustomService, initData8, sizeof(initData8),
+        writeCharacteristic(gattWriteCharCustomService, initData8, sizeof(initData8),
                             QStringLiteral("init"), false, false);
-        writeCharacteristic(gattCustomService, gattWriteCharCustomService, initData8, sizeof(initData8),
+        writeCharacteristic(gattWriteCharCustomService, initData8, sizeof(initData8),
                             QStringLiteral("init"), false, false);
-        writeCharacteristic(gattCustomService, gattWriteCharCustomService, initData9_2, sizeof(initData9_2),
+        writeCharacteristic(gattWriteCharCustomService, initData9_2, sizeof(initData9_2),
                             QStringLiteral("init"), false, false);
-        writeCharacteristic(gattCustomService, gattWriteCharCustomService, initData10_2, sizeof(initData10_2),
+        writeCharacteristic(gattWriteCharCustomService, initData10_2, sizeof(initData10_2),
                             QStringLiteral("init"), false, false);
-        writeCharacteristic(gattCustomService, gattWriteCharCustomService, initData11, sizeof(initData11),
+        writeCharacteristic(gattWriteCharCustomService, initData11, sizeof(initData11),
                             QStringLiteral("init"), false, false);
-        writeCharacteristic(gattCustomService, gattWriteCharCustomService, initData11, sizeof(initData11),
+        writeCharacteristic(gattWriteCharCustomService, initData11, sizeof(initData11),
                             QStringLiteral("init"), false, false);
-        writeCharacteristic(gattCustomService, gattWriteCharCustomService, initData11, sizeof(initData11),
+        writeCharacteristic(gattWriteCharCustomService, initData11, sizeof(initData11),
                             QStringLiteral("init"), false, false);
-        writeCharacteristic(gattCustomService, gattWriteCharCustomService, initData11, sizeof(initData11),
+        writeCharacteristic(gattWriteCharCustomService, initData11, sizeof(initData11),
                             QStringLiteral("init"), false, false);
-        writeCharacteristic(gattCustomService, gattWriteCharCustomService, initData11, sizeof(initData11),
+        writeCharacteristic(gattWriteCharCustomService, initData11, sizeof(initData11),
                             QStringLiteral("init"), false, false);
-        writeCharacteristic(gattCustomService, gattWriteCharCustomService, initData11, sizeof(initData11),
+        writeCharacteristic(gattWriteCharCustomService, initData11, sizeof(initData11),
                             QStringLiteral("init"), false, false);
-        writeCharacteristic(gattCustomService, gattWriteCharCustomService, initData11, sizeof(initData11),
+        writeCharacteristic(gattWriteCharCustomService, initData11, sizeof(initData11),
                             QStringLiteral("init"), false, false);
-        writeCharacteristic(gattCustomService, gattWriteCharCustomService, initData11, sizeof(initData11),
+        writeCharacteristic(gattWriteCharCustomService, initData11, sizeof(initData11),
                             QStringLiteral("init"), false, false);
-        writeCharacteristic(gattCustomService, gattWriteCharCustomService, initData11, sizeof(initData11),
+        writeCharacteristic(gattWriteCharCustomService, initData11, sizeof(initData11),
                             QStringLiteral("init"), false, false);
-        writeCharacteristic(gattCustomService, gattWriteCharCustomService, initData11, sizeof(initData11),
+        writeCharacteristic(gattWriteCharCustomService, initData11, sizeof(initData11),
                             QStringLiteral("init"), false, false);
-        writeCharacteristic(gattCustomService, gattWriteCharCustomService, initData11, sizeof(initData11),
+        writeCharacteristic(gattWriteCharCustomService, initData11, sizeof(initData11),
                             QStringLiteral("init"), false, false);
-        writeCharacteristic(gattCustomService, gattWriteCharCustomService, initData11, sizeof(initData11),
+        writeCharacteristic(gattWriteCharCustomService, initData11, sizeof(initData11),
                             QStringLiteral("init"), false, false);
-        writeCharacteristic(gattCustomService, gattWriteCharCustomService, initData11, sizeof(initData11),
+        writeCharacteristic(gattWriteCharCustomService, initData11, sizeof(initData11),
                             QStringLiteral("init"), false, false);
-        writeCharacteristic(gattCustomService, gattWriteCharCustomService, initData11, sizeof(initData11),
+        writeCharacteristic(gattWriteCharCustomService, initData11, sizeof(initData11),
                             QStringLiteral("init"), false, false);
-        writeCharacteristic(gattCustomService, gattWriteCharCustomService, initData11, sizeof(initData11),
+        writeCharacteristic(gattWriteCharCustomService, initData11, sizeof(initData11),
                             QStringLiteral("init"), false, false);
-        writeCharacteristic(gattCustomService, gattWriteCharCustomService, initData11, sizeof(initData11),
+        writeCharacteristic(gattWriteCharCustomService, initData11, sizeof(initData11),
                             QStringLiteral("init"), false, false);
-        writeCharacteristic(gattCustomService, gattWriteCharCustomService, initData11, sizeof(initData11),
+        writeCharacteristic(gattWriteCharCustomService, initData11, sizeof(initData11),
                             QStringLiteral("init"), false, false);
-        writeCharacteristic(gattCustomService, gattWriteCharCustomService, initData12, sizeof(initData12),
+        writeCharacteristic(gattWriteCharCustomService, initData12, sizeof(initData12),
                             QStringLiteral("init"), false, false);
-        writeCharacteristic(gattCustomService, gattWriteCharCustomService, initData8, sizeof(initData8),
+        writeCharacteristic(gattWriteCharCustomService, initData8, sizeof(initData8),
                             QStringLiteral("init"), false, false);
-        writeCharacteristic(gattCustomService, gattWriteCharCustomService, initData8, sizeof(initData8),
+        writeCharacteristic(gattWriteCharCustomService, initData8, sizeof(initData8),
                             QStringLiteral("init"), false, false);
-        writeCharacteristic(gattCustomService, gattWriteCharCustomService, initData8, sizeof(initData8),
+        writeCharacteristic(gattWriteCharCustomService, initData8, sizeof(initData8),
                             QStringLiteral("init"), false, false);
-        writeCharacteristic(gattCustomService, gattWriteCharCustomService, initData8, sizeof(initData8),
+        writeCharacteristic(gattWriteCharCustomService, initData8, sizeof(initData8),
                             QStringLiteral("init"), false, false);
-        writeCharacteristic(gattCustomService, gattWriteCharCustomService, initData8, sizeof(initData8),
+        writeCharacteristic(gattWriteCharCustomService, initData8, sizeof(initData8),
                             QStringLiteral("init"), false, false);
-        writeCharacteristic(gattCustomService, gattWriteCharCustomService, initData8, sizeof(initData8),
+        writeCharacteristic(gattWriteCharCustomService, initData8, sizeof(initData8),
                             QStringLiteral("init"), false, false);
-        writeCharacteristic(gattCustomService, gattWriteCharCustomService, initData8, sizeof(initData8),
+        writeCharacteristic(gattWriteCharCustomService, initData8, sizeof(initData8),
                             QStringLiteral("init"), false, false);
-        writeCharacteristic(gattCustomService, gattWriteCharCustomService, initData8, sizeof(initData8),
+        writeCharacteristic(gattWriteCharCustomService, initData8, sizeof(initData8),
                             QStringLiteral("init"), false, false);
-        writeCharacteristic(gattCustomService, gattWriteCharCustomService, initData8, sizeof(initData8),
+        writeCharacteristic(gattWriteCharCustomService, initData8, sizeof(initData8),
                             QStringLiteral("init"), false, false);
-        writeCharacteristic(gattCustomService, gattWriteCharCustomService, initData8, sizeof(initData8),
+        writeCharacteristic(gattWriteCharCustomService, initData8, sizeof(initData8),
                             QStringLiteral("init"), false, false);
-        writeCharacteristic(gattCustomService, gattWriteCharCustomService, initData8, sizeof(initData8),
+        writeCharacteristic(gattWriteCharCustomService, initData8, sizeof(initData8),
                             QStringLiteral("init"), false, false);
-        writeCharacteristic(gattCustomService, gattWriteCharCustomService, initData8, sizeof(initData8),
+        writeCharacteristic(gattWriteCharCustomService, initData8, sizeof(initData8),
                             QStringLiteral("init"), false, false);
-        writeCharacteristic(gattCustomService, gattWriteCharCustomService, initData8, sizeof(initData8),
+        writeCharacteristic(gattWriteCharCustomService, initData8, sizeof(initData8),
                             QStringLiteral("init"), false, false);
-        writeCharacteristic(gattCustomService, gattWriteCharCustomService, initData13, sizeof(initData13),
+        writeCharacteristic(gattWriteCharCustomService, initData13, sizeof(initData13),
                             QStringLiteral("init"), false, false);
-        writeCharacteristic(gattCustomService, gattWriteCharCustomService, initData14, sizeof(initData14),
+        writeCharacteristic(gattWriteCharCustomService, initData14, sizeof(initData14),
                             QStringLiteral("init"), false, true);
 
-        writeCharacteristic(gattCustomService, gattWriteCharCustomService, initData7_3, sizeof(initData7_3),
+        writeCharacteristic(gattWriteCharCustomService, initData7_3, sizeof(initData7_3),
                             QStringLiteral("init"), false, false);
-        writeCharacteristic(gattCustomService, gattWriteCharCustomService, initData8, sizeof(initData8),
+        writeCharacteristic(gattWriteCharCustomService, initData8, sizeof(initData8),
                             QStringLiteral("init"), false, false);
-        writeCharacteristic(gattCustomService, gattWriteCharCustomService, initData8, sizeof(initData8),
+        writeCharacteristic(gattWriteCharCustomService, initData8, sizeof(initData8),
                             QStringLiteral("init"), false, false);
-        writeCharacteristic(gattCustomService, gattWriteCharCustomService, initData9_3, sizeof(initData9_3),
+        writeCharacteristic(gattWriteCharCustomService, initData9_3, sizeof(initData9_3),
                             QStringLiteral("init"), false, false);
-        writeCharacteristic(gattCustomService, gattWriteCharCustomService, initData10_3, sizeof(initData10_3),
+        writeCharacteristic(gattWriteCharCustomService, initData10_3, sizeof(initData10_3),
                             QStringLiteral("init"), false, false);
-        writeCharacteristic(gattCustomService, gattWriteCharCustomService, initData11, sizeof(initData11),
+        writeCharacteristic(gattWriteCharCustomService, initData11, sizeof(initData11),
                             QStringLiteral("init"), false, false);
-        writeCharacteristic(gattCustomService, gattWriteCharCustomService, initData11, sizeof(initData11),
+        writeCharacteristic(gattWriteCharCustomService, initData11, sizeof(initData11),
                             QStringLiteral("init"), false, false);
-        writeCharacteristic(gattCustomService, gattWriteCharCustomService, initData11, sizeof(initData11),
+        writeCharacteristic(gattWriteCharCustomService, initData11, sizeof(initData11),
                             QStringLiteral("init"), false, false);
-        writeCharacteristic(gattCustomService, gattWriteCharCustomService, initData11, sizeof(initData11),
+        writeCharacteristic(gattWriteCharCustomService, initData11, sizeof(initData11),
                             QStringLiteral("init"), false, false);
-        writeCharacteristic(gattCustomService, gattWriteCharCustomService, initData11, sizeof(initData11),
+        writeCharacteristic(gattWriteCharCustomService, initData11, sizeof(initData11),
                             QStringLiteral("init"), false, false);
-        writeCharacteristic(gattCustomService, gattWriteCharCustomService, initData11, sizeof(initData11),
+        writeCharacteristic(gattWriteCharCustomService, initData11, sizeof(initData11),
                             QStringLiteral("init"), false, false);
-        writeCharacteristic(gattCustomService, gattWriteCharCustomService, initData11, sizeof(initData11),
+        writeCharacteristic(gattWriteCharCustomService, initData11, sizeof(initData11),
                             QStringLiteral("init"), false, false);
-        writeCharacteristic(gattCustomService, gattWriteCharCustomService, initData11, sizeof(initData11),
+        writeCharacteristic(gattWriteCharCustomService, initData11, sizeof(initData11),
                             QStringLiteral("init"), false, false);
-        writeCharacteristic(gattCustomService, gattWriteCharCustomService, initData11, sizeof(initData11),
+        writeCharacteristic(gattWriteCharCustomService, initData11, sizeof(initData11),
                             QStringLiteral("init"), false, false);
-        writeCharacteristic(gattCustomService, gattWriteCharCustomService, initData11, sizeof(initData11),
+        writeCharacteristic(gattWriteCharCustomService, initData11, sizeof(initData11),
                             QStringLiteral("init"), false, false);
-        writeCharacteristic(gattCustomService, gattWriteCharCustomService, initData11, sizeof(initData11),
+        writeCharacteristic(gattWriteCharCustomService, initData11, sizeof(initData11),
                             QStringLiteral("init"), false, false);
-        writeCharacteristic(gattCustomService, gattWriteCharCustomService, initData11, sizeof(initData11),
+        writeCharacteristic(gattWriteCharCustomService, initData11, sizeof(initData11),
                             QStringLiteral("init"), false, false);
-        writeCharacteristic(gattCustomService, gattWriteCharCustomService, initData11, sizeof(initData11),
+        writeCharacteristic(gattWriteCharCustomService, initData11, sizeof(initData11),
                             QStringLiteral("init"), false, false);
-        writeCharacteristic(gattCustomService, gattWriteCharCustomService, initData11, sizeof(initData11),
+        writeCharacteristic(gattWriteCharCustomService, initData11, sizeof(initData11),
                             QStringLiteral("init"), false, false);
-        writeCharacteristic(gattCustomService, gattWriteCharCustomService, initData11, sizeof(initData11),
+        writeCharacteristic(gattWriteCharCustomService, initData11, sizeof(initData11),
                             QStringLiteral("init"), false, false);
-        writeCharacteristic(gattCustomService, gattWriteCharCustomService, initData11, sizeof(initData11),
+        writeCharacteristic(gattWriteCharCustomService, initData11, sizeof(initData11),
                             QStringLiteral("init"), false, false);
-        writeCharacteristic(gattCustomService, gattWriteCharCustomService, initData11, sizeof(initData11),
+        writeCharacteristic(gattWriteCharCustomService, initData11, sizeof(initData11),
                             QStringLiteral("init"), false, false);
-        writeCharacteristic(gattCustomService, gattWriteCharCustomService, initData12, sizeof(initData12),
+        writeCharacteristic(gattWriteCharCustomService, initData12, sizeof(initData12),
                             QStringLiteral("init"), false, false);
-        writeCharacteristic(gattCustomService, gattWriteCharCustomService, initData8, sizeof(initData8),
+        writeCharacteristic(gattWriteCharCustomService, initData8, sizeof(initData8),
                             QStringLiteral("init"), false, false);
-        writeCharacteristic(gattCustomService, gattWriteCharCustomService, initData8, sizeof(initData8),
+        writeCharacteristic(gattWriteCharCustomService, initData8, sizeof(initData8),
                             QStringLiteral("init"), false, false);
-        writeCharacteristic(gattCustomService, gattWriteCharCustomService, initData8, sizeof(initData8),
+        writeCharacteristic(gattWriteCharCustomService, initData8, sizeof(initData8),
                             QStringLiteral("init"), false, false);
-        writeCharacteristic(gattCustomService, gattWriteCharCustomService, initData8, sizeof(initData8),
+        writeCharacteristic(gattWriteCharCustomService, initData8, sizeof(initData8),
                             QStringLiteral("init"), false, false);
-        writeCharacteristic(gattCustomService, gattWriteCharCustomService, initData8, sizeof(initData8),
+        writeCharacteristic(gattWriteCharCustomService, initData8, sizeof(initData8),
                             QStringLiteral("init"), false, false);
-        writeCharacteristic(gattCustomService, gattWriteCharCustomService, initData8, sizeof(initData8),
+        writeCharacteristic(gattWriteCharCustomService, initData8, sizeof(initData8),
                             QStringLiteral("init"), false, false);
-        writeCharacteristic(gattCustomService, gattWriteCharCustomService, initData8, sizeof(initData8),
+        writeCharacteristic(gattWriteCharCustomService, initData8, sizeof(initData8),
                             QStringLiteral("init"), false, false);
-        writeCharacteristic(gattCustomService, gattWriteCharCustomService, initData8, sizeof(initData8),
+        writeCharacteristic(gattWriteCharCustomService, initData8, sizeof(initData8),
                             QStringLiteral("init"), false, false);
-        writeCharacteristic(gattCustomService, gattWriteCharCustomService, initData8, sizeof(initData8),
+        writeCharacteristic(gattWriteCharCustomService, initData8, sizeof(initData8),
                             QStringLiteral("init"), false, false);
-        writeCharacteristic(gattCustomService, gattWriteCharCustomService, initData8, sizeof(initData8),
+        writeCharacteristic(gattWriteCharCustomService, initData8, sizeof(initData8),
                             QStringLiteral("init"), false, false);
-        writeCharacteristic(gattCustomService, gattWriteCharCustomService, initData8, sizeof(initData8),
+        writeCharacteristic(gattWriteCharCustomService, initData8, sizeof(initData8),
                             QStringLiteral("init"), false, false);
-        writeCharacteristic(gattCustomService, gattWriteCharCustomService, initData8, sizeof(initData8),
+        writeCharacteristic(gattWriteCharCustomService, initData8, sizeof(initData8),
                             QStringLiteral("init"), false, false);
-        writeCharacteristic(gattCustomService, gattWriteCharCustomService, initData8, sizeof(initData8),
+        writeCharacteristic(gattWriteCharCustomService, initData8, sizeof(initData8),
                             QStringLiteral("init"), false, false);
-        writeCharacteristic(gattCustomService, gattWriteCharCustomService, initData13, sizeof(initData13),
+        writeCharacteristic(gattWriteCharCustomService, initData13, sizeof(initData13),
                             QStringLiteral("init"), false, false);
-        writeCharacteristic(gattCustomService, gattWriteCharCustomService, initData14, sizeof(initData14),
+        writeCharacteristic(gattWriteCharCustomService, initData14, sizeof(initData14),
                             QStringLiteral("init"), false, true);
 
-        writeCharacteristic(gattCustomService, gattWriteCharCustomService, initData7_4, sizeof(initData7_4),
+        writeCharacteristic(gattWriteCharCustomService, initData7_4, sizeof(initData7_4),
                             QStringLiteral("init"), false, false);
-        writeCharacteristic(gattCustomService, gattWriteCharCustomService, initData8, sizeof(initData8),
+        writeCharacteristic(gattWriteCharCustomService, initData8, sizeof(initData8),
                             QStringLiteral("init"), false, false);
-        writeCharacteristic(gattCustomService, gattWriteCharCustomService, initData8, sizeof(initData8),
+        writeCharacteristic(gattWriteCharCustomService, initData8, sizeof(initData8),
                             QStringLiteral("init"), false, false);
-        writeCharacteristic(gattCustomService, gattWriteCharCustomService, initData9_4, sizeof(initData9_4),
+        writeCharacteristic(gattWriteCharCustomService, initData9_4, sizeof(initData9_4),
                             QStringLiteral("init"), false, false);
-        writeCharacteristic(gattCustomService, gattWriteCharCustomService, initData10_4, sizeof(initData10_4),
+        writeCharacteristic(gattWriteCharCustomService, initData10_4, sizeof(initData10_4),
                             QStringLiteral("init"), false, false);
-        writeCharacteristic(gattCustomService, gattWriteCharCustomService, initData11, sizeof(initData11),
+        writeCharacteristic(gattWriteCharCustomService, initData11, sizeof(initData11),
                             QStringLiteral("init"), false, false);
-        writeCharacteristic(gattCustomService, gattWriteCharCustomService, initData11, sizeof(initData11),
+        writeCharacteristic(gattWriteCharCustomService, initData11, sizeof(initData11),
                             QStringLiteral("init"), false, false);
-        writeCharacteristic(gattCustomService, gattWriteCharCustomService, initData11, sizeof(initData11),
+        writeCharacteristic(gattWriteCharCustomService, initData11, sizeof(initData11),
                             QStringLiteral("init"), false, false);
-        writeCharacteristic(gattCustomService, gattWriteCharCustomService, initData11, sizeof(initData11),
+        writeCharacteristic(gattWriteCharCustomService, initData11, sizeof(initData11),
                             QStringLiteral("init"), false, false);
-        writeCharacteristic(gattCustomService, gattWriteCharCustomService, initData11, sizeof(initData11),
+        writeCharacteristic(gattWriteCharCustomService, initData11, sizeof(initData11),
                             QStringLiteral("init"), false, false);
-        writeCharacteristic(gattCustomService, gattWriteCharCustomService, initData11, sizeof(initData11),
+        writeCharacteristic(gattWriteCharCustomService, initData11, sizeof(initData11),
                             QStringLiteral("init"), false, false);
-        writeCharacteristic(gattCustomService, gattWriteCharCustomService, initData11, sizeof(initData11),
+        writeCharacteristic(gattWriteCharCustomService, initData11, sizeof(initData11),
                             QStringLiteral("init"), false, false);
-        writeCharacteristic(gattCustomService, gattWriteCharCustomService, initData11, sizeof(initData11),
+        writeCharacteristic(gattWriteCharCustomService, initData11, sizeof(initData11),
                             QStringLiteral("init"), false, false);
-        writeCharacteristic(gattCustomService, gattWriteCharCustomService, initData11, sizeof(initData11),
+        writeCharacteristic(gattWriteCharCustomService, initData11, sizeof(initData11),
                             QStringLiteral("init"), false, false);
-        writeCharacteristic(gattCustomService, gattWriteCharCustomService, initData11, sizeof(initData11),
+        writeCharacteristic(gattWriteCharCustomService, initData11, sizeof(initData11),
                             QStringLiteral("init"), false, false);
-        writeCharacteristic(gattCustomService, gattWriteCharCustomService, initData11, sizeof(initData11),
+        writeCharacteristic(gattWriteCharCustomService, initData11, sizeof(initData11),
                             QStringLiteral("init"), false, false);
-        writeCharacteristic(gattCustomService, gattWriteCharCustomService, initData11, sizeof(initData11),
+        writeCharacteristic(gattWriteCharCustomService, initData11, sizeof(initData11),
                             QStringLiteral("init"), false, false);
-        writeCharacteristic(gattCustomService, gattWriteCharCustomService, initData11, sizeof(initData11),
+        writeCharacteristic(gattWriteCharCustomService, initData11, sizeof(initData11),
                             QStringLiteral("init"), false, false);
-        writeCharacteristic(gattCustomService, gattWriteCharCustomService, initData11, sizeof(initData11),
+        writeCharacteristic(gattWriteCharCustomService, initData11, sizeof(initData11),
                             QStringLiteral("init"), false, false);
-        writeCharacteristic(gattCustomService, gattWriteCharCustomService, initData11, sizeof(initData11),
+        writeCharacteristic(gattWriteCharCustomService, initData11, sizeof(initData11),
                             QStringLiteral("init"), false, false);
-        writeCharacteristic(gattCustomService, gattWriteCharCustomService, initData11, sizeof(initData11),
+        writeCharacteristic(gattWriteCharCustomService, initData11, sizeof(initData11),
                             QStringLiteral("init"), false, false);
-        writeCharacteristic(gattCustomService, gattWriteCharCustomService, initData11, sizeof(initData11),
+        writeCharacteristic(gattWriteCharCustomService, initData11, sizeof(initData11),
                             QStringLiteral("init"), false, false);
-        writeCharacteristic(gattCustomService, gattWriteCharCustomService, initData12, sizeof(initData12),
+        writeCharacteristic(gattWriteCharCustomService, initData12, sizeof(initData12),
                             QStringLiteral("init"), false, false);
-        writeCharacteristic(gattCustomService, gattWriteCharCustomService, initData8, sizeof(initData8),
+        writeCharacteristic(gattWriteCharCustomService, initData8, sizeof(initData8),
                             QStringLiteral("init"), false, false);
-        writeCharacteristic(gattCustomService, gattWriteCharCustomService, initData8, sizeof(initData8),
+        writeCharacteristic(gattWriteCharCustomService, initData8, sizeof(initData8),
                             QStringLiteral("init"), false, false);
-        writeCharacteristic(gattCustomService, gattWriteCharCustomService, initData8, sizeof(initData8),
+        writeCharacteristic(gattWriteCharCustomService, initData8, sizeof(initData8),
                             QStringLiteral("init"), false, false);
-        writeCharacteristic(gattCustomService, gattWriteCharCustomService, initData8, sizeof(initData8),
+        writeCharacteristic(gattWriteCharCustomService, initData8, sizeof(initData8),
                             QStringLiteral("init"), false, false);
-        writeCharacteristic(gattCustomService, gattWriteCharCustomService, initData8, sizeof(initData8),
+        writeCharacteristic(gattWriteCharCustomService, initData8, sizeof(initData8),
                             QStringLiteral("init"), false, false);
-        writeCharacteristic(gattCustomService, gattWriteCharCustomService, initData8, sizeof(initData8),
+        writeCharacteristic(gattWriteCharCustomService, initData8, sizeof(initData8),
                             QStringLiteral("init"), false, false);
-        writeCharacteristic(gattCustomService, gattWriteCharCustomService, initData8, sizeof(initData8),
+        writeCharacteristic(gattWriteCharCustomService, initData8, sizeof(initData8),
                             QStringLiteral("init"), false, false);
-        writeCharacteristic(gattCustomService, gattWriteCharCustomService, initData8, sizeof(initData8),
+        writeCharacteristic(gattWriteCharCustomService, initData8, sizeof(initData8),
                             QStringLiteral("init"), false, false);
-        writeCharacteristic(gattCustomService, gattWriteCharCustomService, initData8, sizeof(initData8),
+        writeCharacteristic(gattWriteCharCustomService, initData8, sizeof(initData8),
                             QStringLiteral("init"), false, false);
-        writeCharacteristic(gattCustomService, gattWriteCharCustomService, initData8, sizeof(initData8),
+        writeCharacteristic(gattWriteCharCustomService, initData8, sizeof(initData8),
                             QStringLiteral("init"), false, false);
-        writeCharacteristic(gattCustomService, gattWriteCharCustomService, initData8, sizeof(initData8),
+        writeCharacteristic(gattWriteCharCustomService, initData8, sizeof(initData8),
                             QStringLiteral("init"), false, false);
-        writeCharacteristic(gattCustomService, gattWriteCharCustomService, initData8, sizeof(initData8),
+        writeCharacteristic(gattWriteCharCustomService, initData8, sizeof(initData8),
                             QStringLiteral("init"), false, false);
-        writeCharacteristic(gattCustomService, gattWriteCharCustomService, initData8, sizeof(initData8),
+        writeCharacteristic(gattWriteCharCustomService, initData8, sizeof(initData8),
                             QStringLiteral("init"), false, false);
-        writeCharacteristic(gattCustomService, gattWriteCharCustomService, initData13, sizeof(initData13),
+        writeCharacteristic(gattWriteCharCustomService, initData13, sizeof(initData13),
                             QStringLiteral("init"), false, false);
-        writeCharacteristic(gattCustomService, gattWriteCharCustomService, initData14, sizeof(initData14),
+        writeCharacteristic(gattWriteCharCustomService, initData14, sizeof(initData14),
                             QStringLiteral("init"), false, true);
 
-        writeCharacteristic(gattCustomService, gattWriteCharCustomService, initData7_5, sizeof(initData7_5),
+        writeCharacteristic(gattWriteCharCustomService, initData7_5, sizeof(initData7_5),
                             QStringLiteral("init"), false, false);
-        writeCharacteristic(gattCustomService, gattWriteCharCustomService, initData8, sizeof(initData8),
+        writeCharacteristic(gattWriteCharCustomService, initData8, sizeof(initData8),
                             QStringLiteral("init"), false, false);
-        writeCharacteristic(gattCustomService, gattWriteCharCustomService, initData8, sizeof(initData8),
+        writeCharacteristic(gattWriteCharCustomService, initData8, sizeof(initData8),
                             QStringLiteral("init"), false, false);
-        writeCharacteristic(gattCustomService, gattWriteCharCustomService, initData9_5, sizeof(initData9_5),
+        writeCharacteristic(gattWriteCharCustomService, initData9_5, sizeof(initData9_5),
                             QStringLiteral("init"), false, false);
-        writeCharacteristic(gattCustomService, gattWriteCharCustomService, initData10_5, sizeof(initData10_5),
+        writeCharacteristic(gattWriteCharCustomService, initData10_5, sizeof(initData10_5),
                             QStringLiteral("init"), false, false);
-        writeCharacteristic(gattCustomService, gattWriteCharCustomService, initData11, sizeof(initData11),
+        writeCharacteristic(gattWriteCharCustomService, initData11, sizeof(initData11),
                             QStringLiteral("init"), false, false);
-        writeCharacteristic(gattCustomService, gattWriteCharCustomService, initData11, sizeof(initData11),
+        writeCharacteristic(gattWriteCharCustomService, initData11, sizeof(initData11),
                             QStringLiteral("init"), false, false);
-        writeCharacteristic(gattCustomService, gattWriteCharCustomService, initData11, sizeof(initData11),
+        writeCharacteristic(gattWriteCharCustomService, initData11, sizeof(initData11),
                             QStringLiteral("init"), false, false);
-        writeCharacteristic(gattCustomService, gattWriteCharCustomService, initData11, sizeof(initData11),
+        writeCharacteristic(gattWriteCharCustomService, initData11, sizeof(initData11),
                             QStringLiteral("init"), false, false);
-        writeCharacteristic(gattCustomService, gattWriteCharCustomService, initData11, sizeof(initData11),
+        writeCharacteristic(gattWriteCharCustomService, initData11, sizeof(initData11),
                             QStringLiteral("init"), false, false);
-        writeCharacteristic(gattCustomService, gattWriteCharCustomService, initData11, sizeof(initData11),
+        writeCharacteristic(gattWriteCharCustomService, initData11, sizeof(initData11),
                             QStringLiteral("init"), false, false);
-        writeCharacteristic(gattCustomService, gattWriteCharCustomService, initData11, sizeof(initData11),
+        writeCharacteristic(gattWriteCharCustomService, initData11, sizeof(initData11),
                             QStringLiteral("init"), false, false);
-        writeCharacteristic(gattCustomService, gattWriteCharCustomService, initData11, sizeof(initData11),
+        writeCharacteristic(gattWriteCharCustomService, initData11, sizeof(initData11),
                             QStringLiteral("init"), false, false);
-        writeCharacteristic(gattCustomService, gattWriteCharCustomService, initData11, sizeof(initData11),
+        writeCharacteristic(gattWriteCharCustomService, initData11, sizeof(initData11),
                             QStringLiteral("init"), false, false);
-        writeCharacteristic(gattCustomService, gattWriteCharCustomService, initData11, sizeof(initData11),
+        writeCharacteristic(gattWriteCharCustomService, initData11, sizeof(initData11),
                             QStringLiteral("init"), false, false);
-        writeCharacteristic(gattCustomService, gattWriteCharCustomService, initData11, sizeof(initData11),
+        writeCharacteristic(gattWriteCharCustomService, initData11, sizeof(initData11),
                             QStringLiteral("init"), false, false);
-        writeCharacteristic(gattCustomService, gattWriteCharCustomService, initData11, sizeof(initData11),
+        writeCharacteristic(gattWriteCharCustomService, initData11, sizeof(initData11),
                             QStringLiteral("init"), false, false);
-        writeCharacteristic(gattCustomService, gattWriteCharCustomService, initData11, sizeof(initData11),
+        writeCharacteristic(gattWriteCharCustomService, initData11, sizeof(initData11),
                             QStringLiteral("init"), false, false);
-        writeCharacteristic(gattCustomService, gattWriteCharCustomService, initData11, sizeof(initData11),
+        writeCharacteristic(gattWriteCharCustomService, initData11, sizeof(initData11),
                             QStringLiteral("init"), false, false);
-        writeCharacteristic(gattCustomService, gattWriteCharCustomService, initData11, sizeof(initData11),
+        writeCharacteristic(gattWriteCharCustomService, initData11, sizeof(initData11),
                             QStringLiteral("init"), false, false);
-        writeCharacteristic(gattCustomService, gattWriteCharCustomService, initData11, sizeof(initData11),
+        writeCharacteristic(gattWriteCharCustomService, initData11, sizeof(initData11),
                             QStringLiteral("init"), false, false);
-        writeCharacteristic(gattCustomService, gattWriteCharCustomService, initData11, sizeof(initData11),
+        writeCharacteristic(gattWriteCharCustomService, initData11, sizeof(initData11),
                             QStringLiteral("init"), false, false);
-        writeCharacteristic(gattCustomService, gattWriteCharCustomService, initData12, sizeof(initData12),
+        writeCharacteristic(gattWriteCharCustomService, initData12, sizeof(initData12),
                             QStringLiteral("init"), false, false);
-        writeCharacteristic(gattCustomService, gattWriteCharCustomService, initData8, sizeof(initData8),
+        writeCharacteristic(gattWriteCharCustomService, initData8, sizeof(initData8),
                             QStringLiteral("init"), false, false);
-        writeCharacteristic(gattCustomService, gattWriteCharCustomService, initData8, sizeof(initData8),
+        writeCharacteristic(gattWriteCharCustomService, initData8, sizeof(initData8),
                             QStringLiteral("init"), false, false);
-        writeCharacteristic(gattCustomService, gattWriteCharCustomService, initData8, sizeof(initData8),
+        writeCharacteristic(gattWriteCharCustomService, initData8, sizeof(initData8),
                             QStringLiteral("init"), false, false);
-        writeCharacteristic(gattCustomService, gattWriteCharCustomService, initData8, sizeof(initData8),
+        writeCharacteristic(gattWriteCharCustomService, initData8, sizeof(initData8),
                             QStringLiteral("init"), false, false);
-        writeCharacteristic(gattCustomService, gattWriteCharCustomService, initData8, sizeof(initData8),
+        writeCharacteristic(gattWriteCharCustomService, initData8, sizeof(initData8),
                             QStringLiteral("init"), false, false);
-        writeCharacteristic(gattCustomService, gattWriteCharCustomService, initData8, sizeof(initData8),
+        writeCharacteristic(gattWriteCharCustomService, initData8, sizeof(initData8),
                             QStringLiteral("init"), false, false);
-        writeCharacteristic(gattCustomService, gattWriteCharCustomService, initData8, sizeof(initData8),
+        writeCharacteristic(gattWriteCharCustomService, initData8, sizeof(initData8),
                             QStringLiteral("init"), false, false);
-        writeCharacteristic(gattCustomService, gattWriteCharCustomService, initData8, sizeof(initData8),
+        writeCharacteristic(gattWriteCharCustomService, initData8, sizeof(initData8),
                             QStringLiteral("init"), false, false);
-        writeCharacteristic(gattCustomService, gattWriteCharCustomService, initData8, sizeof(initData8),
+        writeCharacteristic(gattWriteCharCustomService, initData8, sizeof(initData8),
                             QStringLiteral("init"), false, false);
-        writeCharacteristic(gattCustomService, gattWriteCharCustomService, initData8, sizeof(initData8),
+        writeCharacteristic(gattWriteCharCustomService, initData8, sizeof(initData8),
                             QStringLiteral("init"), false, false);
-        writeCharacteristic(gattCustomService, gattWriteCharCustomService, initData8, sizeof(initData8),
+        writeCharacteristic(gattWriteCharCustomService, initData8, sizeof(initData8),
                             QStringLiteral("init"), false, false);
-        writeCharacteristic(gattCustomService, gattWriteCharCustomService, initData8, sizeof(initData8),
+        writeCharacteristic(gattWriteCharCustomService, initData8, sizeof(initData8),
                             QStringLiteral("init"), false, false);
-        writeCharacteristic(gattCustomService, gattWriteCharCustomService, initData8, sizeof(initData8),
+        writeCharacteristic(gattWriteCharCustomService, initData8, sizeof(initData8),
                             QStringLiteral("init"), false, false);
-        writeCharacteristic(gattCustomService, gattWriteCharCustomService, initData13, sizeof(initData13),
+        writeCharacteristic(gattWriteCharCustomService, initData13, sizeof(initData13),
                             QStringLiteral("init"), false, false);
-        writeCharacteristic(gattCustomService, gattWriteCharCustomService, initData14, sizeof(initData14),
+        writeCharacteristic(gattWriteCharCustomService, initData14, sizeof(initData14),
                             QStringLiteral("init"), false, true);
 
-        writeCharacteristic(gattCustomService, gattWriteCharCustomService, initData7_6, sizeof(initData7_6),
+        writeCharacteristic(gattWriteCharCustomService, initData7_6, sizeof(initData7_6),
                             QStringLiteral("init"), false, false);
-        writeCharacteristic(gattCustomService, gattWriteCharCustomService, initData8, sizeof(initData8),
+        writeCharacteristic(gattWriteCharCustomService, initData8, sizeof(initData8),
                             QStringLiteral("init"), false, false);
-        writeCharacteristic(gattCustomService, gattWriteCharCustomService, initData8, sizeof(initData8),
+        writeCharacteristic(gattWriteCharCustomService, initData8, sizeof(initData8),
                             QStringLiteral("init"), false, false);
-        writeCharacteristic(gattCustomService, gattWriteCharCustomService, initData9_6, sizeof(initData9_6),
+        writeCharacteristic(gattWriteCharCustomService, initData9_6, sizeof(initData9_6),
                             QStringLiteral("init"), false, false);
-        writeCharacteristic(gattCustomService, gattWriteCharCustomService, initData10_6, sizeof(initData10_6),
+        writeCharacteristic(gattWriteCharCustomService, initData10_6, sizeof(initData10_6),
                             QStringLiteral("init"), false, false);
-        writeCharacteristic(gattCustomService, gattWriteCharCustomService, initData11, sizeof(initData11),
+        writeCharacteristic(gattWriteCharCustomService, initData11, sizeof(initData11),
                             QStringLiteral("init"), false, false);
-        writeCharacteristic(gattCustomService, gattWriteCharCustomService, initData11, sizeof(initData11),
+        writeCharacteristic(gattWriteCharCustomService, initData11, sizeof(initData11),
                             QStringLiteral("init"), false, false);
-        writeCharacteristic(gattCustomService, gattWriteCharCustomService, initData11, sizeof(initData11),
+        writeCharacteristic(gattWriteCharCustomService, initData11, sizeof(initData11),
                             QStringLiteral("init"), false, false);
-        writeCharacteristic(gattCustomService, gattWriteCharCustomService, initData11, sizeof(initData11),
+        writeCharacteristic(gattWriteCharCustomService, initData11, sizeof(initData11),
                             QStringLiteral("init"), false, false);
-        writeCharacteristic(gattCustomService, gattWriteCharCustomService, initData11, sizeof(initData11),
+        writeCharacteristic(gattWriteCharCustomService, initData11, sizeof(initData11),
                             QStringLiteral("init"), false, false);
-        writeCharacteristic(gattCustomService, gattWriteCharCustomService, initData11, sizeof(initData11),
+        writeCharacteristic(gattWriteCharCustomService, initData11, sizeof(initData11),
                             QStringLiteral("init"), false, false);
-        writeCharacteristic(gattCustomService, gattWriteCharCustomService, initData11, sizeof(initData11),
+        writeCharacteristic(gattWriteCharCustomService, initData11, sizeof(initData11),
                             QStringLiteral("init"), false, false);
-        writeCharacteristic(gattCustomService, gattWriteCharCustomService, initData11, sizeof(initData11),
+        writeCharacteristic(gattWriteCharCustomService, initData11, sizeof(initData11),
                             QStringLiteral("init"), false, false);
-        writeCharacteristic(gattCustomService, gattWriteCharCustomService, initData11, sizeof(initData11),
+        writeCharacteristic(gattWriteCharCustomService, initData11, sizeof(initData11),
                             QStringLiteral("init"), false, false);
-        writeCharacteristic(gattCustomService, gattWriteCharCustomService, initData11, sizeof(initData11),
+        writeCharacteristic(gattWriteCharCustomService, initData11, sizeof(initData11),
                             QStringLiteral("init"), false, false);
-        writeCharacteristic(gattCustomService, gattWriteCharCustomService, initData11, sizeof(initData11),
+        writeCharacteristic(gattWriteCharCustomService, initData11, sizeof(initData11),
                             QStringLiteral("init"), false, false);
-        writeCharacteristic(gattCustomService, gattWriteCharCustomService, initData11, sizeof(initData11),
+        writeCharacteristic(gattWriteCharCustomService, initData11, sizeof(initData11),
                             QStringLiteral("init"), false, false);
-        writeCharacteristic(gattCustomService, gattWriteCharCustomService, initData11, sizeof(initData11),
+        writeCharacteristic(gattWriteCharCustomService, initData11, sizeof(initData11),
                             QStringLiteral("init"), false, false);
-        writeCharacteristic(gattCustomService, gattWriteCharCustomService, initData11, sizeof(initData11),
+        writeCharacteristic(gattWriteCharCustomService, initData11, sizeof(initData11),
                             QStringLiteral("init"), false, false);
-        writeCharacteristic(gattCustomService, gattWriteCharCustomService, initData11, sizeof(initData11),
+        writeCharacteristic(gattWriteCharCustomService, initData11, sizeof(initData11),
                             QStringLiteral("init"), false, false);
-        writeCharacteristic(gattCustomService, gattWriteCharCustomService, initData11, sizeof(initData11),
+        writeCharacteristic(gattWriteCharCustomService, initData11, sizeof(initData11),
                             QStringLiteral("init"), false, false);
-        writeCharacteristic(gattCustomService, gattWriteCharCustomService, initData11, sizeof(initData11),
+        writeCharacteristic(gattWriteCharCustomService, initData11, sizeof(initData11),
                             QStringLiteral("init"), false, false);
-        writeCharacteristic(gattCustomService, gattWriteCharCustomService, initData12, sizeof(initData12),
+        writeCharacteristic(gattWriteCharCustomService, initData12, sizeof(initData12),
                             QStringLiteral("init"), false, false);
-        writeCharacteristic(gattCustomService, gattWriteCharCustomService, initData8, sizeof(initData8),
+        writeCharacteristic(gattWriteCharCustomService, initData8, sizeof(initData8),
                             QStringLiteral("init"), false, false);
-        writeCharacteristic(gattCustomService, gattWriteCharCustomService, initData8, sizeof(initData8),
+        writeCharacteristic(gattWriteCharCustomService, initData8, sizeof(initData8),
                             QStringLiteral("init"), false, false);
-        writeCharacteristic(gattCustomService, gattWriteCharCustomService, initData8, sizeof(initData8),
+        writeCharacteristic(gattWriteCharCustomService, initData8, sizeof(initData8),
                             QStringLiteral("init"), false, false);
-        writeCharacteristic(gattCustomService, gattWriteCharCustomService, initData8, sizeof(initData8),
+        writeCharacteristic(gattWriteCharCustomService, initData8, sizeof(initData8),
                             QStringLiteral("init"), false, false);
-        writeCharacteristic(gattCustomService, gattWriteCharCustomService, initData8, sizeof(initData8),
+        writeCharacteristic(gattWriteCharCustomService, initData8, sizeof(initData8),
                             QStringLiteral("init"), false, false);
-        writeCharacteristic(gattCustomService, gattWriteCharCustomService, initData8, sizeof(initData8),
+        writeCharacteristic(gattWriteCharCustomService, initData8, sizeof(initData8),
                             QStringLiteral("init"), false, false);
-        writeCharacteristic(gattCustomService, gattWriteCharCustomService, initData8, sizeof(initData8),
+        writeCharacteristic(gattWriteCharCustomService, initData8, sizeof(initData8),
                             QStringLiteral("init"), false, false);
-        writeCharacteristic(gattCustomService, gattWriteCharCustomService, initData8, sizeof(initData8),
+        writeCharacteristic(gattWriteCharCustomService, initData8, sizeof(initData8),
                             QStringLiteral("init"), false, false);
-        writeCharacteristic(gattCustomService, gattWriteCharCustomService, initData8, sizeof(initData8),
+        writeCharacteristic(gattWriteCharCustomService, initData8, sizeof(initData8),
                             QStringLiteral("init"), false, false);
-        writeCharacteristic(gattCustomService, gattWriteCharCustomService, initData8, sizeof(initData8),
+        writeCharacteristic(gattWriteCharCustomService, initData8, sizeof(initData8),
                             QStringLiteral("init"), false, false);
-        writeCharacteristic(gattCustomService, gattWriteCharCustomService, initData8, sizeof(initData8),
+        writeCharacteristic(gattWriteCharCustomService, initData8, sizeof(initData8),
                             QStringLiteral("init"), false, false);
-        writeCharacteristic(gattCustomService, gattWriteCharCustomService, initData8, sizeof(initData8),
+        writeCharacteristic(gattWriteCharCustomService, initData8, sizeof(initData8),
                             QStringLiteral("init"), false, false);
-        writeCharacteristic(gattCustomService, gattWriteCharCustomService, initData8, sizeof(initData8),
+        writeCharacteristic(gattWriteCharCustomService, initData8, sizeof(initData8),
                             QStringLiteral("init"), false, false);
-        writeCharacteristic(gattCustomService, gattWriteCharCustomService, initData13, sizeof(initData13),
+        writeCharacteristic(gattWriteCharCustomService, initData13, sizeof(initData13),
                             QStringLiteral("init"), false, false);
-        writeCharacteristic(gattCustomService, gattWriteCharCustomService, initData14, sizeof(initData14),
+        writeCharacteristic(gattWriteCharCustomService, initData14, sizeof(initData14),
                             QStringLiteral("init"), false, true);
 
-        writeCharacteristic(gattCustomService, gattWriteCharCustomService, initData02, sizeof(initData02),
+        writeCharacteristic(gattWriteCharCustomService, initData02, sizeof(initData02),
                             QStringLiteral("init"), false, true);
-        writeCharacteristic(gattCustomService, gattWriteCharCustomService, initData03, sizeof(initData03),
+        writeCharacteristic(gattWriteCharCustomService, initData03, sizeof(initData03),
                             QStringLiteral("init"), false, true);
-        writeCharacteristic(gattCustomService, gattWriteCharCustomService, initData04, sizeof(initData04),
+        writeCharacteristic(gattWriteCharCustomService, initData04, sizeof(initData04),
                             QStringLiteral("init"), false, true);
-        writeCharacteristic(gattCustomService, gattWriteCharCustomService, initData05, sizeof(initData05),
+        writeCharacteristic(gattWriteCharCustomService, initData05, sizeof(initData05),
                             QStringLiteral("init"), false, true);
-        writeCharacteristic(gattCustomService, gattWriteCharCustomService, initData06, sizeof(initData06),
+        writeCharacteristic(gattWriteCharCustomService, initData06, sizeof(initData06),
                             QStringLiteral("init"), false, true);
-        writeCharacteristic(gattCustomService, gattWriteCharCustomService, initData2, sizeof(initData2),
+        writeCharacteristic(gattWriteCharCustomService, initData2, sizeof(initData2),
                             QStringLiteral("init"), false, true);
-        writeCharacteristic(gattCustomService, gattWriteCharCustomService, initData3, sizeof(initData3),
+        writeCharacteristic(gattWriteCharCustomService, initData3, sizeof(initData3),
                             QStringLiteral("init"), false, true);
-        writeCharacteristic(gattCustomService, gattWriteCharCustomService, initData4, sizeof(initData4),
+        writeCharacteristic(gattWriteCharCustomService, initData4, sizeof(initData4),
                             QStringLiteral("init"), false, true);
-        writeCharacteristic(gattCustomService, gattWriteCharCustomService, initData5, sizeof(initData5),
+        writeCharacteristic(gattWriteCharCustomService, initData5, sizeof(initData5),
                             QStringLiteral("init"), false, false);
-        writeCharacteristic(gattCustomService, gattWriteCharCustomService, initData6, sizeof(initData6),
+        writeCharacteristic(gattWriteCharCustomService, initData6, sizeof(initData6),
                             QStringLiteral("init"), false, true);
 
         messageID = 0x11;
@@ -720,7 +722,7 @@ void horizontreadmill::btinit() {
 }
 
 void horizontreadmill::update() {
-    if (m_control->state() == QLowEnergyController::UnconnectedState) {
+    if (transport->state() == QLowEnergyController::UnconnectedState) {
 
         emit disconnected();
         return;
@@ -731,7 +733,7 @@ void horizontreadmill::update() {
         initRequest = false;
     } else if (bluetoothDevice.isValid() //&&
 
-               // m_control->state() == QLowEnergyController::DiscoveredState //&&
+               // transport->state() == QLowEnergyController::DiscoveredState //&&
                // gattCommunicationChannelService &&
                // gattWriteCharacteristic.isValid() &&
                // gattNotify1Characteristic.isValid() &&
@@ -749,7 +751,8 @@ void horizontreadmill::update() {
 
         if (requestSpeed != -1) {
             if (requestSpeed != currentSpeed().value() && requestSpeed >= 0 && requestSpeed <= 22) {
-                emit debug(QStringLiteral("writing speed ") + QString::number(requestSpeed));
+                LOG_DEVICE(QStringLiteral("writing speed ") + QString::number(requestSpeed));
+                requestQueued();
                 forceSpeed(requestSpeed);
             }
             requestSpeed = -1;
@@ -757,13 +760,14 @@ void horizontreadmill::update() {
         if (requestInclination != -1) {
             if (requestInclination != currentInclination().value() && requestInclination >= 0 &&
                 requestInclination <= 15) {
-                emit debug(QStringLiteral("writing incline ") + QString::number(requestInclination));
+                LOG_DEVICE(QStringLiteral("writing incline ") + QString::number(requestInclination));
+                requestQueued();
                 forceIncline(requestInclination);
             }
             requestInclination = -1;
         }
         if (requestStart != -1) {
-            emit debug(QStringLiteral("starting..."));
+            LOG_DEVICE(QStringLiteral("starting..."));
             if (lastSpeed == 0.0) {
 
                 lastSpeed = 0.5;
@@ -772,17 +776,17 @@ void horizontreadmill::update() {
             emit tapeStarted();
         }
         if (requestStop != -1) {
-            emit debug(QStringLiteral("stopping..."));
+            LOG_DEVICE(QStringLiteral("stopping..."));
 
             requestStop = -1;
         }
         if (requestIncreaseFan != -1) {
-            emit debug(QStringLiteral("increasing fan speed..."));
+            LOG_DEVICE(QStringLiteral("increasing fan speed..."));
 
             // sendChangeFanSpeed(FanSpeed + 1);
             requestIncreaseFan = -1;
         } else if (requestDecreaseFan != -1) {
-            emit debug(QStringLiteral("decreasing fan speed..."));
+            LOG_DEVICE(QStringLiteral("decreasing fan speed..."));
 
             // sendChangeFanSpeed(FanSpeed - 1);
             requestDecreaseFan = -1;
@@ -792,7 +796,7 @@ void horizontreadmill::update() {
 
 // example frame: 55aa320003050400532c00150000
 void horizontreadmill::forceSpeed(double requestSpeed) {
-    if (gattCustomService) {
+    if (!gattWriteCharCustomService.isNull()) {
         messageID++;
         uint8_t datas[4];
         datas[0] = 0;
@@ -810,29 +814,27 @@ void horizontreadmill::forceSpeed(double requestSpeed) {
         write[12] = datas[2];
         write[13] = datas[3];
 
-        writeCharacteristic(gattCustomService, gattWriteCharCustomService, write, sizeof(write),
+        writeCharacteristic(gattWriteCharCustomService, write, sizeof(write),
                             QStringLiteral("forceSpeed"), false, true);
-    } else if (gattFTMSService) {
+    } else if (!gattWriteCharControlPointId.isNull()) {
         // for the Tecnogym Myrun
         uint8_t write[] = {FTMS_REQUEST_CONTROL};
-        writeCharacteristic(gattFTMSService, gattWriteCharControlPointId, write, sizeof(write), "requestControl", false,
-                            true);
+        writeCharacteristic(gattWriteCharControlPointId, write, sizeof(write), "requestControl", false, true);
         write[0] = {FTMS_START_RESUME};
-        writeCharacteristic(gattFTMSService, gattWriteCharControlPointId, write, sizeof(write), "start simulation",
-                            false, true);
+        writeCharacteristic(gattWriteCharControlPointId, write, sizeof(write), "start simulation", false, true);
 
         uint8_t writeS[] = {FTMS_SET_TARGET_SPEED, 0x00, 0x00};
         writeS[1] = ((uint16_t)requestSpeed * 100) & 0xFF;
         writeS[2] = ((uint16_t)requestSpeed * 100) >> 8;
 
-        writeCharacteristic(gattFTMSService, gattWriteCharControlPointId, writeS, sizeof(writeS),
+        writeCharacteristic(gattWriteCharControlPointId, writeS, sizeof(writeS),
                             QStringLiteral("forceSpeed"), false, true);
     }
 }
 
 // example frame: 55aa3800030603005d0b0a0000
 void horizontreadmill::forceIncline(double requestIncline) {
-    if (gattCustomService) {
+    if (!gattWriteCharCustomService.isNull()) {
         messageID++;
         uint8_t datas[3];
         datas[0] = (uint8_t)(requestIncline * 10) & 0xff;
@@ -848,44 +850,37 @@ void horizontreadmill::forceIncline(double requestIncline) {
         write[11] = datas[1];
         write[12] = datas[2];
 
-        writeCharacteristic(gattCustomService, gattWriteCharCustomService, write, sizeof(write),
+        writeCharacteristic(gattWriteCharCustomService, write, sizeof(write),
                             QStringLiteral("forceIncline"), false, true);
-    } else if (gattFTMSService) {
+    } else if (!gattWriteCharControlPointId.isNull()) {
         // for the Tecnogym Myrun
         uint8_t write[] = {FTMS_REQUEST_CONTROL};
-        writeCharacteristic(gattFTMSService, gattWriteCharControlPointId, write, sizeof(write), "requestControl", false,
-                            true);
+        writeCharacteristic(gattWriteCharControlPointId, write, sizeof(write), "requestControl", false, true);
         write[0] = {FTMS_START_RESUME};
-        writeCharacteristic(gattFTMSService, gattWriteCharControlPointId, write, sizeof(write), "start simulation",
-                            false, true);
+        writeCharacteristic(gattWriteCharControlPointId, write, sizeof(write), "start simulation", false, true);
 
         uint8_t writeS[] = {FTMS_SET_TARGET_INCLINATION, 0x00, 0x00};
         writeS[1] = ((int16_t)requestIncline * 10) & 0xFF;
         writeS[2] = ((int16_t)requestIncline * 10) >> 8;
 
-        writeCharacteristic(gattFTMSService, gattWriteCharControlPointId, writeS, sizeof(writeS),
+        writeCharacteristic(gattWriteCharControlPointId, writeS, sizeof(writeS),
                             QStringLiteral("forceIncline"), false, true);
     }
 }
 
-void horizontreadmill::serviceDiscovered(const QBluetoothUuid &gatt) {
-    emit debug(QStringLiteral("serviceDiscovered ") + gatt.toString());
-}
-
-void horizontreadmill::characteristicChanged(const QLowEnergyCharacteristic &characteristic,
-                                             const QByteArray &newValue) {
+void horizontreadmill::characteristicChanged(const QBluetoothUuid &characteristic, const QByteArray &newValue) {
     double heart = 0; // NOTE : Should be initialized with a value to shut clang-analyzer's
                       // UndefinedBinaryOperatorResult
-    // qDebug() << "characteristicChanged" << characteristic.uuid() << newValue << newValue.length();
+    // qDebug() << "characteristicChanged" << characteristic << newValue << newValue.length();
     Q_UNUSED(characteristic);
     QSettings settings;
     QString heartRateBeltName =
         settings.value(QStringLiteral("heart_rate_belt_name"), QStringLiteral("Disabled")).toString();
 
-    emit debug(QStringLiteral(" << ") + characteristic.uuid().toString() + " " + QString::number(newValue.length()) +
+    LOG_PACKET(QStringLiteral(" << ") + characteristic.toString() + " " + QString::number(newValue.length()) +
                " " + newValue.toHex(' '));
 
-    if (characteristic.uuid() == QBluetoothUuid((quint16)0xFFF4)) {
+    if (characteristic == QBluetoothUuid((quint16)0xFFF4)) {
         if (newValue.at(0) == 0x55) {
             customRecv = (((uint16_t)((uint8_t)newValue.at(7)) << 8) | (uint16_t)((uint8_t)newValue.at(6))) + 10;
             qDebug() << "new custom packet received. Len expected: " << customRecv;
@@ -899,15 +894,15 @@ void horizontreadmill::characteristicChanged(const QLowEnergyCharacteristic &cha
         }
     }
 
-    if (characteristic.uuid() == QBluetoothUuid((quint16)0xFFF4) && newValue.length() > 70 && newValue.at(0) == 0x55 &&
+    if (characteristic == QBluetoothUuid((quint16)0xFFF4) && newValue.length() > 70 && newValue.at(0) == 0x55 &&
         newValue.at(5) == 0x12) {
         Speed =
             (((double)(((uint16_t)((uint8_t)newValue.at(62)) << 8) | (uint16_t)((uint8_t)newValue.at(61)))) / 1000.0) *
             1.60934; // miles/h
-        emit debug(QStringLiteral("Current Speed: ") + QString::number(Speed.value()));
+        LOG_DEVICE(QStringLiteral("Current Speed: ") + QString::number(Speed.value()));
 
         Inclination = (double)((uint8_t)newValue.at(63)) / 10.0;
-        emit debug(QStringLiteral("Current Inclination: ") + QString::number(Inclination.value()));
+        LOG_DEVICE(QStringLiteral("Current Inclination: ") + QString::number(Inclination.value()));
 
         if (watts(settings.value(QStringLiteral("weight"), 75.0).toFloat()))
             KCal +=
@@ -918,15 +913,15 @@ void horizontreadmill::characteristicChanged(const QLowEnergyCharacteristic &cha
                                 QDateTime::currentDateTime())))); //(( (0.048* Output in watts +1.19) * body weight in
                                                                   // kg * 3.5) / 200 ) / 60
 
-        emit debug(QStringLiteral("Current KCal: ") + QString::number(KCal.value()));
+        LOG_DEVICE(QStringLiteral("Current KCal: ") + QString::number(KCal.value()));
 
         Distance += ((Speed.value() / 3600000.0) *
                      ((double)lastRefreshCharacteristicChanged.msecsTo(QDateTime::currentDateTime())));
-        emit debug(QStringLiteral("Current Distance: ") + QString::number(Distance.value()));
-    } else if (characteristic.uuid() == QBluetoothUuid((quint16)0xFFF4) && newValue.length() == 29 &&
+        LOG_DEVICE(QStringLiteral("Current Distance: ") + QString::number(Distance.value()));
+    } else if (characteristic == QBluetoothUuid((quint16)0xFFF4) && newValue.length() == 29 &&
                newValue.at(0) == 0x55) {
         Speed = ((double)(((uint16_t)((uint8_t)newValue.at(15)) << 8) | (uint16_t)((uint8_t)newValue.at(14)))) / 10.0;
-        emit debug(QStringLiteral("Current Speed: ") + QString::number(Speed.value()));
+        LOG_DEVICE(QStringLiteral("Current Speed: ") + QString::number(Speed.value()));
 
         // Inclination = (double)((uint8_t)newValue.at(3)) / 10.0;
         // emit debug(QStringLiteral("Current Inclination: ") + QString::number(Inclination.value()));
@@ -939,104 +934,39 @@ void horizontreadmill::characteristicChanged(const QLowEnergyCharacteristic &cha
                                 QDateTime::currentDateTime())))); //(( (0.048* Output in watts +1.19) * body weight in
         // kg * 3.5) / 200 ) / 60
 
-        emit debug(QStringLiteral("Current KCal: ") + QString::number(KCal.value()));
+        LOG_DEVICE(QStringLiteral("Current KCal: ") + QString::number(KCal.value()));
 
         Distance += ((Speed.value() / 3600000.0) *
                      ((double)lastRefreshCharacteristicChanged.msecsTo(QDateTime::currentDateTime())));
-        emit debug(QStringLiteral("Current Distance: ") + QString::number(Distance.value()));
-    } else if (characteristic.uuid() == QBluetoothUuid((quint16)0x2ACD)) {
+        LOG_DEVICE(QStringLiteral("Current Distance: ") + QString::number(Distance.value()));
+    } else if (characteristic == QBluetoothUuid((quint16)ftmsparser::TREADMILL_DATA)) {
         lastPacket = newValue;
 
         // default flags for this treadmill is 84 04
-
-        union flags {
-            struct {
-
-                uint16_t moreData : 1;
-                uint16_t avgSpeed : 1;
-                uint16_t totalDistance : 1;
-                uint16_t inclination : 1;
-                uint16_t elevation : 1;
-                uint16_t instantPace : 1;
-                uint16_t averagePace : 1;
-                uint16_t expEnergy : 1;
-                uint16_t heartRate : 1;
-                uint16_t metabolic : 1;
-                uint16_t elapsedTime : 1;
-                uint16_t remainingTime : 1;
-                uint16_t forceBelt : 1;
-                uint16_t spare : 3;
-            };
-
-            uint16_t word_flags;
-        };
-
-        flags Flags;
-        int index = 0;
-        Flags.word_flags = (newValue.at(1) << 8) | newValue.at(0);
-        index += 2;
-
-        if (!Flags.moreData) {
-            Speed = ((double)(((uint16_t)((uint8_t)newValue.at(index + 1)) << 8) |
-                              (uint16_t)((uint8_t)newValue.at(index)))) /
-                    100.0;
-            index += 2;
-            emit debug(QStringLiteral("Current Speed: ") + QString::number(Speed.value()));
-        }
-
-        if (Flags.avgSpeed) {
-            double avgSpeed;
-            avgSpeed = ((double)(((uint16_t)((uint8_t)newValue.at(index + 1)) << 8) |
-                                 (uint16_t)((uint8_t)newValue.at(index)))) /
-                       100.0;
-            index += 2;
-            emit debug(QStringLiteral("Current Average Speed: ") + QString::number(avgSpeed));
+        ftmsparser::data d;
+        if (!ftmsparser::parse(ftmsparser::TREADMILL_DATA, newValue.constData(), newValue.length(), d)) {
+            LOG_DEVICE(QStringLiteral("truncated treadmill data"));
         }
 
-        if (Flags.totalDistance) {
-            // ignoring the distance, because it's a total life odometer
-            // Distance = ((double)((((uint32_t)((uint8_t)newValue.at(index + 2)) << 16) |
-            // (uint32_t)((uint8_t)newValue.at(index + 1)) << 8) | (uint32_t)((uint8_t)newValue.at(index)))) / 1000.0;
-            index += 3;
-        }
-        // else
-        {
-            Distance += ((Speed.value() / 3600000.0) *
-                         ((double)lastRefreshCharacteristicChanged.msecsTo(QDateTime::currentDateTime())));
+        if (d.has(ftmsparser::INSTANT_SPEED)) {
+            Speed = d[ftmsparser::INSTANT_SPEED];
+            LOG_DEVICE(QStringLiteral("Current Speed: ") + QString::number(Speed.value()));
         }
 
-        emit debug(QStringLiteral("Current Distance: ") + QString::number(Distance.value()));
-
-        if (Flags.inclination) {
-            Inclination = ((double)(((uint16_t)((uint8_t)newValue.at(index + 1)) << 8) |
-                                    (uint16_t)((uint8_t)newValue.at(index)))) /
-                          10.0;
-            index += 4; // the ramo value is useless
-            emit debug(QStringLiteral("Current Inclination: ") + QString::number(Inclination.value()));
-        }
-
-        if (Flags.elevation) {
-            index += 4; // TODO
-        }
+        // ignoring the total distance, because it's a total life odometer
+        Distance += ((Speed.value() / 3600000.0) *
+                     ((double)lastRefreshCharacteristicChanged.msecsTo(QDateTime::currentDateTime())));
 
-        if (Flags.instantPace) {
-            index += 1; // TODO
-        }
+        LOG_DEVICE(QStringLiteral("Current Distance: ") + QString::number(Distance.value()));
 
-        if (Flags.averagePace) {
-            index += 1; // TODO
+        if (d.has(ftmsparser::INCLINATION)) {
+            // the ramp value is useless
+            Inclination = d[ftmsparser::INCLINATION];
+            LOG_DEVICE(QStringLiteral("Current Inclination: ") + QString::number(Inclination.value()));
         }
 
-        if (Flags.expEnergy) {
-            KCal = ((double)(((uint16_t)((uint8_t)newValue.at(index + 1)) << 8) |
-                             (uint16_t)((uint8_t)newValue.at(index))));
-            index += 2;
-
-            // energy per hour
-            index += 2;
-
-            // energy per minute
-            index += 1;
+        if (d.has(ftmsparser::TOTAL_ENERGY)) {
+            KCal = d[ftmsparser::TOTAL_ENERGY];
         } else {
             if (watts(settings.value(QStringLiteral("weight"), 75.0).toFloat()))
                 KCal += ((((0.048 * ((double)watts(settings.value(QStringLiteral("weight"), 75.0).toFloat())) + 1.19) *
@@ -1048,7 +978,7 @@ void horizontreadmill::characteristicChanged(const QLowEnergyCharacteristic &cha
                                                                 // kg * 3.5) / 200 ) / 60
         }
 
-        emit debug(QStringLiteral("Current KCal: ") + QString::number(KCal.value()));
+        LOG_DEVICE(QStringLiteral("Current KCal: ") + QString::number(KCal.value()));
 
 #ifdef Q_OS_ANDROID
         if (settings.value("ant_heart", false).toBool())
@@ -1056,33 +986,11 @@ void horizontreadmill::characteristicChanged(const QLowEnergyCharacteristic &cha
         else
 #endif
         {
-            if (Flags.heartRate) {
-                if (index < newValue.length()) {
-
-                    heart = ((double)((newValue.at(index))));
-                    emit debug(QStringLiteral("Current Heart: ") + QString::number(heart));
-                } else {
-                    emit debug(QStringLiteral("Error on parsing heart!"));
-                }
-                // index += 1; //NOTE: clang-analyzer-deadcode.DeadStores
+            if (d.has(ftmsparser::HEART_RATE)) {
+                heart = d[ftmsparser::HEART_RATE];
+                LOG_DEVICE(QStringLiteral("Current Heart: ") + QString::number(heart));
             }
         }
-
-        if (Flags.metabolic) {
-            // todo
-        }
-
-        if (Flags.elapsedTime) {
-            // todo
-        }
-
-        if (Flags.remainingTime) {
-            // todo
-        }
-
-        if (Flags.forceBelt) {
-            // todo
-        }
     }
 
     if (heartRateBeltName.startsWith(QStringLiteral("Disabled"))) {
@@ -1105,93 +1013,72 @@ void horizontreadmill::characteristicChanged(const QLowEnergyCharacteristic &cha
     }
 
     lastRefreshCharacteristicChanged = QDateTime::currentDateTime();
+}
 
-    if (m_control->error() != QLowEnergyController::NoError) {
-        qDebug() << QStringLiteral("QLowEnergyController ERROR!!") << m_control->errorString();
-    }
+// used only when the transport doesn't know the services: the custom protocol notifies on 0xFFF4, the standard one
+// on the FTMS characteristics
+static bool horizontFTMSCharacteristic(const QBluetoothUuid &c) {
+    bool ok = false;
+    quint16 id = c.toUInt16(&ok);
+    return ok && id >= 0x2ACC && id <= 0x2ADA;
 }
 
-void horizontreadmill::stateChanged(QLowEnergyService::ServiceState state) {
-    QMetaEnum metaEnum = QMetaEnum::fromType<QLowEnergyService::ServiceState>();
+void horizontreadmill::serviceScanDone(void) {
     QBluetoothUuid _gattWriteCharCustomService((quint16)0xFFF3);
+    QBluetoothUuid _gattNotifyCharCustomService((quint16)0xFFF4);
     QBluetoothUuid _gattWriteCharControlPointId((quint16)0x2AD9);
-    emit debug(QStringLiteral("BTLE stateChanged ") + QString::fromLocal8Bit(metaEnum.valueToKey(state)));
+    LOG_DEVICE(QStringLiteral("serviceScanDone"));
 
-    for (QLowEnergyService *s : qAsConst(gattCommunicationChannelService)) {
-        qDebug() << QStringLiteral("stateChanged") << s->serviceUuid() << s->state();
-        if (s->state() != QLowEnergyService::ServiceDiscovered && s->state() != QLowEnergyService::InvalidService) {
-            qDebug() << QStringLiteral("not all services discovered");
-            return;
-        }
-    }
+    initRequest = false;
+    firstStateChanged = 0;
+    notificationSubscribed = 0;
+    gattWriteCharControlPointId = QBluetoothUuid();
+    gattWriteCharCustomService = QBluetoothUuid();
 
-    qDebug() << QStringLiteral("all services discovered!");
+    auto characteristics_list = transport->characteristics();
+    for (const QBluetoothUuid &c : qAsConst(characteristics_list)) {
+        qDebug() << QStringLiteral("char uuid") << c << transport->properties(c);
 
-    notificationSubscribed = 0;
+        if (transport->properties(c) & QLowEnergyCharacteristic::Write && c == _gattWriteCharControlPointId) {
+            qDebug() << QStringLiteral("FTMS service and Control Point found");
+            gattWriteCharControlPointId = c;
+        }
 
-    for (QLowEnergyService *s : qAsConst(gattCommunicationChannelService)) {
-        if (s->state() == QLowEnergyService::ServiceDiscovered) {
-            // establish hook into notifications
-            connect(s, &QLowEnergyService::characteristicChanged, this, &horizontreadmill::characteristicChanged);
-            connect(s, &QLowEnergyService::characteristicWritten, this, &horizontreadmill::characteristicWritten);
-            connect(s, &QLowEnergyService::characteristicRead, this, &horizontreadmill::characteristicRead);
-            connect(
-                s, static_cast<void (QLowEnergyService::*)(QLowEnergyService::ServiceError)>(&QLowEnergyService::error),
-                this, &horizontreadmill::errorService);
-            connect(s, &QLowEnergyService::descriptorWritten, this, &horizontreadmill::descriptorWritten);
-            connect(s, &QLowEnergyService::descriptorRead, this, &horizontreadmill::descriptorRead);
-
-            qDebug() << s->serviceUuid() << QStringLiteral("connected!");
-
-            auto characteristics_list = s->characteristics();
-            for (const QLowEnergyCharacteristic &c : qAsConst(characteristics_list)) {
-                qDebug() << QStringLiteral("char uuid") << c.uuid() << QStringLiteral("handle") << c.handle();
-
-                if (c.properties() & QLowEnergyCharacteristic::Write && c.uuid() == _gattWriteCharControlPointId) {
-                    qDebug() << QStringLiteral("FTMS service and Control Point found");
-                    gattWriteCharControlPointId = c;
-                    gattFTMSService = s;
-                }
-
-                if (c.properties() & QLowEnergyCharacteristic::Write && c.uuid() == _gattWriteCharCustomService) {
-                    qDebug() << QStringLiteral("Custom service and Control Point found");
-                    gattWriteCharCustomService = c;
-                    gattCustomService = s;
-                }
-            }
+        if (transport->properties(c) & QLowEnergyCharacteristic::Write && c == _gattWriteCharCustomService) {
+            qDebug() << QStringLiteral("Custom service and Control Point found");
+            gattWriteCharCustomService = c;
         }
     }
 
-    for (QLowEnergyService *s : qAsConst(gattCommunicationChannelService)) {
-        if (s->state() == QLowEnergyService::ServiceDiscovered) {
-            auto characteristics_list = s->characteristics();
-            for (const QLowEnergyCharacteristic &c : qAsConst(characteristics_list)) {
-                auto descriptors_list = c.descriptors();
-                for (const QLowEnergyDescriptor &d : qAsConst(descriptors_list)) {
-                    qDebug() << QStringLiteral("descriptor uuid") << d.uuid() << QStringLiteral("handle") << d.handle();
-                }
-
-                if ((c.properties() & QLowEnergyCharacteristic::Notify) == QLowEnergyCharacteristic::Notify &&
-                    ((gattFTMSService && s->serviceUuid() == gattFTMSService->serviceUuid() && !gattCustomService) ||
-                     (gattCustomService && s->serviceUuid() == gattCustomService->serviceUuid()))) {
-                    QByteArray descriptor;
-                    descriptor.append((char)0x01);
-                    descriptor.append((char)0x00);
-                    if (c.descriptor(QBluetoothUuid::ClientCharacteristicConfiguration).isValid()) {
-                        s->writeDescriptor(c.descriptor(QBluetoothUuid::ClientCharacteristicConfiguration), descriptor);
-                        notificationSubscribed++;
-                    } else {
-                        qDebug() << QStringLiteral("ClientCharacteristicConfiguration") << c.uuid()
-                                 << c.descriptor(QBluetoothUuid::ClientCharacteristicConfiguration).uuid()
-                                 << c.descriptor(QBluetoothUuid::ClientCharacteristicConfiguration).handle()
-                                 << QStringLiteral(" is not valid");
-                    }
-
-                    qDebug() << s->serviceUuid() << c.uuid() << QStringLiteral("notification subscribed!");
-                }
+    // all the notifications of the custom service if there is one, otherwise of the FTMS service
+    QBluetoothUuid gattFTMSService;
+    QBluetoothUuid gattCustomService;
+    if (!gattWriteCharControlPointId.isNull()) {
+        gattFTMSService = transport->service(gattWriteCharControlPointId);
+    }
+    if (!gattWriteCharCustomService.isNull()) {
+        gattCustomService = transport->service(gattWriteCharCustomService);
+    }
+
+    for (const QBluetoothUuid &c : qAsConst(characteristics_list)) {
+        QBluetoothUuid s = transport->service(c);
+        bool ftms = s.isNull() ? horizontFTMSCharacteristic(c) : s == gattFTMSService;
+        bool custom = s.isNull() ? c == _gattNotifyCharCustomService : s == gattCustomService;
+        if ((transport->properties(c) & QLowEnergyCharacteristic::Notify) == QLowEnergyCharacteristic::Notify &&
+            ((!gattWriteCharControlPointId.isNull() && gattWriteCharCustomService.isNull() && ftms) ||
+             (!gattWriteCharCustomService.isNull() && custom))) {
+            // only the subscriptions started are waited for, subscribed() never comes for the others
+            if (transport->subscribe(c)) {
+                notificationSubscribed++;
+                qDebug() << c << QStringLiteral("notification subscribed!");
             }
         }
     }
+    if (!notificationSubscribed) {
+        qDebug() << QStringLiteral("no notification to subscribe");
+        initRequest = true;
+        emit connectedAndDiscovered();
+    }
 
     // ******************************************* virtual treadmill init *************************************
     if (!firstStateChanged && !virtualTreadmill && !virtualBike
@@ -1230,8 +1117,8 @@ void horizontreadmill::changeInclinationRequested(double grade, double percentag
     changeInclination(grade, percentage);
 }
 
-void horizontreadmill::descriptorWritten(const QLowEnergyDescriptor &descriptor, const QByteArray &newValue) {
-    emit debug(QStringLiteral("descriptorWritten ") + descriptor.name() + QStringLiteral(" ") + newValue.toHex(' '));
+void horizontreadmill::subscribed(const QBluetoothUuid &characteristic) {
+    LOG_DEVICE(QStringLiteral("subscribed ") + characteristic.toString());
 
     if (notificationSubscribed)
         notificationSubscribed--;
@@ -1242,46 +1129,15 @@ void horizontreadmill::descriptorWritten(const QLowEnergyDescriptor &descriptor,
     }
 }
 
-void horizontreadmill::descriptorRead(const QLowEnergyDescriptor &descriptor, const QByteArray &newValue) {
-    qDebug() << QStringLiteral("descriptorRead ") << descriptor.name() << descriptor.uuid() << newValue.toHex(' ');
-}
-
-void horizontreadmill::characteristicWritten(const QLowEnergyCharacteristic &characteristic,
-                                             const QByteArray &newValue) {
+void horizontreadmill::characteristicWritten(const QBluetoothUuid &characteristic, const QByteArray &newValue) {
     Q_UNUSED(characteristic);
-    emit debug(QStringLiteral("characteristicWritten ") + newValue.toHex(' '));
-}
-
-void horizontreadmill::characteristicRead(const QLowEnergyCharacteristic &characteristic, const QByteArray &newValue) {
-    qDebug() << QStringLiteral("characteristicRead ") << characteristic.uuid() << newValue.toHex(' ');
-}
-
-void horizontreadmill::serviceScanDone(void) {
-    emit debug(QStringLiteral("serviceScanDone"));
-
-    initRequest = false;
-    firstStateChanged = 0;
-    auto services_list = m_control->services();
-    for (const QBluetoothUuid &s : qAsConst(services_list)) {
-        gattCommunicationChannelService.append(m_control->createServiceObject(s));
-        connect(gattCommunicationChannelService.constLast(), &QLowEnergyService::stateChanged, this,
-                &horizontreadmill::stateChanged);
-        gattCommunicationChannelService.constLast()->discoverDetails();
-    }
+    LOG_PACKET(QStringLiteral("characteristicWritten ") + newValue.toHex(' '));
 }
 
-void horizontreadmill::errorService(QLowEnergyService::ServiceError err) {
-
-    QMetaEnum metaEnum = QMetaEnum::fromType<QLowEnergyService::ServiceError>();
-    emit debug(QStringLiteral("horizontreadmill::errorService") + QString::fromLocal8Bit(metaEnum.valueToKey(err)) +
-               m_control->errorString());
-}
-
-void horizontreadmill::error(QLowEnergyController::Error err) {
-
-    QMetaEnum metaEnum = QMetaEnum::fromType<QLowEnergyController::Error>();
-    emit debug(QStringLiteral("horizontreadmill::error") + QString::fromLocal8Bit(metaEnum.valueToKey(err)) +
-               m_control->errorString());
+void horizontreadmill::error(const QString &err) {
+    LOG_DEVICE(QStringLiteral("horizontreadmill::error ") + err);
+    LOG_DEVICE(QStringLiteral("Cannot connect to remote device."));
+    emit disconnected();
 }
 
 void horizontreadmill::deviceDiscovered(const QBluetoothDeviceInfo &device) {
@@ -1290,50 +1146,41 @@ void horizontreadmill::deviceDiscovered(const QBluetoothDeviceInfo &device) {
     // horizon treadmill and F80 treadmill, so if we want to add inclination support we have to separate the 2
     // devices
     // ***************************************************************************************************************
-    emit debug(QStringLiteral("Found new device: ") + device.name() + QStringLiteral(" (") +
+    LOG_DEVICE(QStringLiteral("Found new device: ") + device.name() + QStringLiteral(" (") +
                device.address().toString() + ')');
     {
         bluetoothDevice = device;
 
-        m_control = QLowEnergyController::createCentral(bluetoothDevice, this);
-        connect(m_control, &QLowEnergyController::serviceDiscovered, this, &horizontreadmill::serviceDiscovered);
-        connect(m_control, &QLowEnergyController::discoveryFinished, this, &horizontreadmill::serviceScanDone);
-        connect(m_control,
-                static_cast<void (QLowEnergyController::*)(QLowEnergyController::Error)>(&QLowEnergyController::error),
-                this, &horizontreadmill::error);
-        connect(m_control, &QLowEnergyController::stateChanged, this, &horizontreadmill::controllerStateChanged);
-
-        connect(m_control,
-                static_cast<void (QLowEnergyController::*)(QLowEnergyController::Error)>(&QLowEnergyController::error),
-                this, [this](QLowEnergyController::Error error) {
-                    Q_UNUSED(error);
-                    Q_UNUSED(this);
-                    emit debug(QStringLiteral("Cannot connect to remote device."));
-                    emit disconnected();
-                });
-        connect(m_control, &QLowEnergyController::connected, this, [this]() {
+        transport = bluetoothtransport::create(bluetoothDevice, this);
+        m_control = transport->controller();
+        connect(transport, &bluetoothtransport::discovered, this, &horizontreadmill::serviceScanDone);
+        connect(transport, &bluetoothtransport::characteristicChanged, this, &horizontreadmill::characteristicChanged);
+        connect(transport, &bluetoothtransport::characteristicWritten, this, &horizontreadmill::characteristicWritten);
+        connect(transport, &bluetoothtransport::subscribed, this, &horizontreadmill::subscribed);
+        connect(transport, &bluetoothtransport::error, this, &horizontreadmill::error);
+        connect(transport, &bluetoothtransport::stateChanged, this, &horizontreadmill::controllerStateChanged);
+        connect(transport, &bluetoothtransport::connected, this, [this]() {
             Q_UNUSED(this);
-            emit debug(QStringLiteral("Controller connected. Search services..."));
-            m_control->discoverServices();
+            LOG_DEVICE(QStringLiteral("Controller connected. Search services..."));
         });
-        connect(m_control, &QLowEnergyController::disconnected, this, [this]() {
+        connect(transport, &bluetoothtransport::disconnected, this, [this]() {
             Q_UNUSED(this);
-            emit debug(QStringLiteral("LowEnergy controller disconnected"));
+            LOG_DEVICE(QStringLiteral("LowEnergy controller disconnected"));
             emit disconnected();
         });
 
         // Connect
-        m_control->connectToDevice();
+        transport->connectToDevice();
         return;
     }
 }
 
 bool horizontreadmill::connected() {
-    if (!m_control) {
+    if (!transport) {
 
         return false;
     }
-    return m_control->state() == QLowEnergyController::DiscoveredState;
+    return transport->state() == QLowEnergyController::DiscoveredState;
 }
 
 void *horizontreadmill::VirtualTreadmill() { return virtualTreadmill; }
@@ -1342,11 +1189,11 @@ void *horizontreadmill::VirtualDevice() { return VirtualTreadmill(); }
 
 void horizontreadmill::controllerStateChanged(QLowEnergyController::ControllerState state) {
     qDebug() << QStringLiteral("controllerStateChanged") << state;
-    if (state == QLowEnergyController::UnconnectedState && m_control) {
+    if (state == QLowEnergyController::UnconnectedState && transport) {
         qDebug() << QStringLiteral("trying to connect back again...");
 
         initDone = false;
-        m_control->connectToDevice();
+        transport->connectToDevice();
     }
 }
 
@@ -28,6 +28,7 @@
 #include <QObject>
 #include <QString>
 
+#include "bluetoothtransport.h"
 #include "treadmill.h"
 #include "virtualbike.h"
 #include "virtualtreadmill.h"
@@ -48,8 +49,8 @@ class horizontreadmill : public treadmill {
     void *VirtualDevice();
 
   private:
-    void writeCharacteristic(QLowEnergyService *service, QLowEnergyCharacteristic characteristic, uint8_t *data,
-                             uint8_t data_len, QString info, bool disable_log = false, bool wait_for_response = false);
+    void writeCharacteristic(const QBluetoothUuid &characteristic, uint8_t *data, uint8_t data_len, QString info,
+                             bool disable_log = false, bool wait_for_response = false);
     void waitForAPacket();
     void startDiscover();
     void btinit();
@@ -58,11 +59,8 @@ class horizontreadmill : public treadmill {
     virtualtreadmill *virtualTreadmill = nullptr;
     virtualbike *virtualBike = nullptr;
 
-    QList<QLowEnergyService *> gattCommunicationChannelService;
-    QLowEnergyCharacteristic gattWriteCharControlPointId;
-    QLowEnergyService *gattFTMSService = nullptr;
-    QLowEnergyCharacteristic gattWriteCharCustomService;
-    QLowEnergyService *gattCustomService = nullptr;
+    QBluetoothUuid gattWriteCharControlPointId;
+    QBluetoothUuid gattWriteCharCustomService;
     volatile int notificationSubscribed = 0;
 
     uint8_t sec1Update = 0;
@@ -96,19 +94,14 @@ class horizontreadmill : public treadmill {
 
   private slots:
 
-    void characteristicChanged(const QLowEnergyCharacteristic &characteristic, const QByteArray &newValue);
-    void characteristicWritten(const QLowEnergyCharacteristic &characteristic, const QByteArray &newValue);
-    void descriptorWritten(const QLowEnergyDescriptor &descriptor, const QByteArray &newValue);
-    void characteristicRead(const QLowEnergyCharacteristic &characteristic, const QByteArray &newValue);
-    void descriptorRead(const QLowEnergyDescriptor &descriptor, const QByteArray &newValue);
-    void stateChanged(QLowEnergyService::ServiceState state);
+    void characteristicChanged(const QBluetoothUuid &characteristic, const QByteArray &newValue);
+    void characteristicWritten(const QBluetoothUuid &characteristic, const QByteArray &newValue);
+    void subscribed(const QBluetoothUuid &characteristic);
     void controllerStateChanged(QLowEnergyController::ControllerState state);
 
-    void serviceDiscovered(const QBluetoothUuid &gatt);
     void serviceScanDone(void);
     void update();
-    void error(QLowEnergyController::Error err);
-    void errorService(QLowEnergyService::ServiceError);
+    void error(const QString &err);
 
     void changeInclinationRequested(double grade, double percentage);
 };
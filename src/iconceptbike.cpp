@@ -1,4 +1,5 @@
 #include "iconceptbike.h"
+#include "logging.h"
 #include <QBluetoothLocalDevice>
 #include <QDateTime>
 #include <QMetaEnum>
@@ -18,7 +19,7 @@ iconceptbike::iconceptbike() {
 }
 
 void iconceptbike::deviceDiscovered(const QBluetoothDeviceInfo &device) {
-    emit debug(QStringLiteral("Found new device: ") + device.name() + QStringLiteral(" (") +
+    LOG_DEVICE(QStringLiteral("Found new device: ") + device.name() + QStringLiteral(" (") +
                device.address().toString() + ')');
     if (device.name().toUpper().startsWith(QStringLiteral("BH DUALKIT"))) {
         bluetoothDevice = device;
@@ -45,12 +46,12 @@ void iconceptbike::serviceDiscovered(const QBluetoothServiceInfo &service) {
 
     qDebug() << QStringLiteral("iconceptbike::serviceDiscovered") << service;
     if (service.device().address() == bluetoothDevice.address()) {
-        emit debug(QStringLiteral("Found new service: ") + service.serviceName() + '(' +
+        LOG_DEVICE(QStringLiteral("Found new service: ") + service.serviceName() + '(' +
                    service.serviceUuid().toString() + ')');
 
         if (service.serviceName().startsWith(QStringLiteral("SerialPort")) ||
             service.serviceName().startsWith(QStringLiteral("Serial Port"))) {
-            emit debug(QStringLiteral("Serial port service found"));
+            LOG_DEVICE(QStringLiteral("Serial port service found"));
             discoveryAgent->stop();
 
             serialPortService = service;
@@ -66,9 +67,9 @@ void iconceptbike::serviceDiscovered(const QBluetoothServiceInfo &service) {
             socket->setPreferredSecurityFlags(QBluetooth::NoSecurity);
 #endif
 
-            emit debug(QStringLiteral("Create socket"));
+            LOG_DEVICE(QStringLiteral("Create socket"));
             socket->connectToService(serialPortService);
-            emit debug(QStringLiteral("ConnectToService done"));
+            LOG_DEVICE(QStringLiteral("ConnectToService done"));
         }
     }
 }
@@ -82,7 +83,7 @@ void iconceptbike::update() {
             QSettings settings;
             bool virtual_device_enabled = settings.value(QStringLiteral("virtual_device_enabled"), true).toBool();
             if (virtual_device_enabled) {
-                emit debug(QStringLiteral("creating virtual treadmill interface..."));
+                LOG_DEVICE(QStringLiteral("creating virtual treadmill interface..."));
                 virtualBike = new virtualbike(this, true);
                 connect(virtualBike, &virtualbike::changeInclination, this, &iconceptbike::changeInclination);
             }
@@ -103,14 +104,14 @@ void iconceptbike::update() {
 
         const char poll[] = {0x55, 0x17, 0x01, 0x01};
         socket->write(poll, sizeof(poll));
-        emit debug(QStringLiteral("write poll"));
+        LOG_DEVICE(QStringLiteral("write poll"));
 
         update_metrics(true, watts());
     }
 }
 
 void iconceptbike::rfCommConnected() {
-    emit debug(QStringLiteral("connected ") + socket->peerName());
+    LOG_DEVICE(QStringLiteral("connected ") + socket->peerName());
 
     const uint8_t init1[] = {0x55, 0x0c, 0x01, 0xff, 0x55, 0xbb, 0x01, 0xff, 0x55, 0x24, 0x01, 0xff, 0x55, 0x25, 0x01,
                              0xff, 0x55, 0x26, 0x01, 0xff, 0x55, 0x27, 0x01, 0xff, 0x55, 0x02, 0x01, 0xff, 0x55, 0x03,
@@ -174,11 +175,11 @@ void iconceptbike::readSocket() {
             Cadence = (uint8_t)line.at(13);
             // Heart = GetHeartRateFromPacket(line);
 
-            emit debug(QStringLiteral("Current speed: ") + QString::number(Speed.value()));
-            emit debug(QStringLiteral("Current cadence: ") + QString::number(Cadence.value()));
+            LOG_DEVICE(QStringLiteral("Current speed: ") + QString::number(Speed.value()));
+            LOG_DEVICE(QStringLiteral("Current cadence: ") + QString::number(Cadence.value()));
             // emit debug(QStringLiteral("Current heart: ") + QString::number(Heart.value()));
-            emit debug(QStringLiteral("Current KCal: ") + QString::number(KCal.value()));
-            emit debug(QStringLiteral("Current Distance: ") + QString::number(Distance.value()));
+            LOG_DEVICE(QStringLiteral("Current KCal: ") + QString::number(KCal.value()));
+            LOG_DEVICE(QStringLiteral("Current Distance: ") + QString::number(Distance.value()));
         }
     }
 }
@@ -204,5 +205,5 @@ uint16_t iconceptbike::GetElapsedTimeFromPacket(const QByteArray &packet) {
 }
 
 void iconceptbike::onSocketErrorOccurred(QBluetoothSocket::SocketError error) {
-    emit debug(QStringLiteral("onSocketErrorOccurred ") + QString::number(error));
+    LOG_DEVICE(QStringLiteral("onSocketErrorOccurred ") + QString::number(error));
 }
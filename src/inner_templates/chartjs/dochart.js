@@ -1004,15 +1004,42 @@ function dochart_init() {
     el.enqueue().then(onSettingsOK).catch(function(err) {
             console.error('Error is ' + err);
     })
-    el = new MainWSQueueElement({
-        msg: 'getsessionarray'
+    load_session(0, -1, []);
+}
+
+// the session a chunk at a time, as column arrays: a long session doesn't come in a single huge message
+function load_session(from, session, samples) {
+    let el = new MainWSQueueElement({
+        msg: 'getsession',
+        content: {
+            from: from,
+            count: 1800
+        }
     }, function(msg) {
-        if (msg.msg === 'R_getsessionarray') {
+        if (msg.msg === 'R_getsession') {
             return msg.content;
         }
         return null;
     }, 15000, 3);
-    el.enqueue().then(process_arr).catch(function(err) {
+    el.enqueue().then(function(content) {
+        if (session >= 0 && content.session !== session) {
+            // a new session started meanwhile
+            load_session(0, -1, []);
+            return;
+        }
+        for (let i = 0; i < content.next - content.from; i++) {
+            let sample = {};
+            for (let k = 0; k < content.keys.length; k++) {
+                if (content.columns[k][i] !== null)
+                    sample[content.keys[k]] = content.columns[k][i];
+            }
+            samples.push(sample);
+        }
+        if (content.next < content.total)
+            load_session(content.next, content.session, samples);
+        else
+            process_arr(samples);
+    }).catch(function(err) {
         console.error('Error is ' + err);
     });
 }
@@ -1,4 +1,5 @@
 #include "kingsmithr1protreadmill.h"
+#include "logging.h"
 #include "ios/lockscreen.h"
 #include "keepawakehelper.h"
 #include "virtualtreadmill.h"
@@ -47,7 +48,7 @@ void kingsmithr1protreadmill::writeCharacteristic(uint8_t *data, uint8_t data_le
 
     if (gattCommunicationChannelService->state() != QLowEnergyService::ServiceState::ServiceDiscovered ||
         m_control->state() == QLowEnergyController::UnconnectedState) {
-        emit debug(QStringLiteral("writeCharacteristic error because the connection is closed"));
+        LOG_DEVICE(QStringLiteral("writeCharacteristic error because the connection is closed"));
 
         return;
     }
@@ -60,14 +61,14 @@ void kingsmithr1protreadmill::writeCharacteristic(uint8_t *data, uint8_t data_le
             gattWriteCharacteristic, QByteArray((const char *)data, data_len), QLowEnergyService::WriteWithoutResponse);
 
     if (!disable_log) {
-        emit debug(QStringLiteral(" >> ") + QByteArray((const char *)data, data_len).toHex(' ') +
+        LOG_PACKET(QStringLiteral(" >> ") + QByteArray((const char *)data, data_len).toHex(' ') +
                    QStringLiteral(" // ") + info + " " + gattWriteCharacteristic.properties());
     }
 
     loop.exec();
 
     if (timeout.isActive() == false) {
-        emit debug(QStringLiteral(" exit for timeout"));
+        LOG_DEVICE(QStringLiteral(" exit for timeout"));
     }
 }
 
@@ -143,7 +144,7 @@ void kingsmithr1protreadmill::update() {
         // byte 17    = inclination
         if (requestSpeed != -1) {
             if (requestSpeed != currentSpeed().value() && requestSpeed >= 0 && requestSpeed <= 22) {
-                emit debug(QStringLiteral("writing speed ") + QString::number(requestSpeed));
+                LOG_DEVICE(QStringLiteral("writing speed ") + QString::number(requestSpeed));
 
                 double inc = Inclination.value();
                 if (requestInclination != -1) {
@@ -162,7 +163,7 @@ void kingsmithr1protreadmill::update() {
             requestInclination = qRound(requestInclination * 2.0) / 2.0;
             if (requestInclination != currentInclination().value() && requestInclination >= 0 &&
                 requestInclination <= 15) {
-                emit debug(QStringLiteral("writing incline ") + QString::number(requestInclination));
+                LOG_DEVICE(QStringLiteral("writing incline ") + QString::number(requestInclination));
 
                 double speed = currentSpeed().value();
                 if (requestSpeed != -1) {
@@ -180,7 +181,7 @@ void kingsmithr1protreadmill::update() {
             requestUnlock = false;
         }
         if (requestStart != -1) {
-            emit debug(QStringLiteral("starting..."));
+            LOG_DEVICE(QStringLiteral("starting..."));
             if (lastSpeed == 0.0) {
 
                 lastSpeed = 0.5;
@@ -192,7 +193,7 @@ void kingsmithr1protreadmill::update() {
             lastStart = QDateTime::currentMSecsSinceEpoch();
         }
         if (requestStop != -1) {
-            emit debug(QStringLiteral("stopping..."));
+            LOG_DEVICE(QStringLiteral("stopping..."));
 
             if (Speed.value() != 0)
                 writeCharacteristic(start_pause, sizeof(start_pause), QStringLiteral("pause"), false, true);
@@ -202,18 +203,18 @@ void kingsmithr1protreadmill::update() {
             requestStop = -1;
         }
         if (requestFanSpeed != -1) {
-            emit debug(QStringLiteral("changing fan speed..."));
+            LOG_DEVICE(QStringLiteral("changing fan speed..."));
 
             //sendChangeFanSpeed(requestFanSpeed);
             requestFanSpeed = -1;
         }
         if (requestIncreaseFan != -1) {
-            emit debug(QStringLiteral("increasing fan speed..."));
+            LOG_DEVICE(QStringLiteral("increasing fan speed..."));
 
             //sendChangeFanSpeed(FanSpeed + 1);
             requestIncreaseFan = -1;
         } else if (requestDecreaseFan != -1) {
-            emit debug(QStringLiteral("decreasing fan speed..."));
+            LOG_DEVICE(QStringLiteral("decreasing fan speed..."));
 
             //sendChangeFanSpeed(FanSpeed - 1);
             requestDecreaseFan = -1;
@@ -222,7 +223,7 @@ void kingsmithr1protreadmill::update() {
 }
 
 void kingsmithr1protreadmill::serviceDiscovered(const QBluetoothUuid &gatt) {
-    emit debug(QStringLiteral("serviceDiscovered ") + gatt.toString());
+    LOG_DEVICE(QStringLiteral("serviceDiscovered ") + gatt.toString());
 }
 
 void kingsmithr1protreadmill::characteristicChanged(const QLowEnergyCharacteristic &characteristic,
@@ -234,18 +235,18 @@ void kingsmithr1protreadmill::characteristicChanged(const QLowEnergyCharacterist
     Q_UNUSED(characteristic);
     QByteArray value = newValue;
 
-    emit debug(QStringLiteral(" << ") + QString::number(value.length()) + QStringLiteral(" ") + value.toHex(' '));
+    LOG_PACKET(QStringLiteral(" << ") + QString::number(value.length()) + QStringLiteral(" ") + value.toHex(' '));
     emit packetReceived();
 
     lastPacket = value;
 
     if (newValue.length() != 20) {
-        emit debug(QStringLiteral("packet ignored"));
+        LOG_DEVICE(QStringLiteral("packet ignored"));
         return;
     }
 
     if (newValue.at(2) == 0x05) {
-        emit debug(QStringLiteral("lock byte found, asking to unlock the treadmill"));
+        LOG_DEVICE(QStringLiteral("lock byte found, asking to unlock the treadmill"));
         requestUnlock = true;
     }
 
@@ -258,26 +259,26 @@ void kingsmithr1protreadmill::characteristicChanged(const QLowEnergyCharacterist
         double t = GetTargetSpeedFromPacket(value);
         if (t == lastTargetSpeed) {
             targetSpeed = speed;
-            emit debug(QStringLiteral("ignoring target speed"));
+            LOG_DEVICE(QStringLiteral("ignoring target speed"));
         } else {
             // if the user changes the speed from the remote, the treadmill doesn't update the target speed
             // https://github.com/cagnulein/qdomyos-zwift/issues/470#issuecomment-965525224
             if (speed == t) {
                 targetSpeedMatchesSpeed = true;
                 lastTargetSpeedMatchesSpeed = speed;
-                emit debug(QStringLiteral("target speed matches the current speed"));
+                LOG_DEVICE(QStringLiteral("target speed matches the current speed"));
             }
             if (targetSpeedMatchesSpeed && t != lastTargetSpeedMatchesSpeed) {
                 targetSpeedMatchesSpeed = false;
                 lastTargetSpeedMatchesSpeed = -1;
-                emit debug(QStringLiteral("target speed changes"));
+                LOG_DEVICE(QStringLiteral("target speed changes"));
             }
 
             if (targetSpeedMatchesSpeed == false) {
                 targetSpeed = t;
-                emit debug(QStringLiteral("using target speed from TM"));
+                LOG_DEVICE(QStringLiteral("using target speed from TM"));
             } else {
-                emit debug(QStringLiteral("using current speed as target speed"));
+                LOG_DEVICE(QStringLiteral("using current speed as target speed"));
                 targetSpeed = speed;
             }
 
@@ -333,13 +334,13 @@ void kingsmithr1protreadmill::characteristicChanged(const QLowEnergyCharacterist
         lastTimeCharacteristicChanged = QDateTime::currentDateTime();
     }
 
-    emit debug(QStringLiteral("Current speed: ") + QString::number(speed));
-    emit debug(QStringLiteral("Current target speed: ") + QString::number(targetSpeed));
+    LOG_DEVICE(QStringLiteral("Current speed: ") + QString::number(speed));
+    LOG_DEVICE(QStringLiteral("Current target speed: ") + QString::number(targetSpeed));
     // emit debug(QStringLiteral("Current incline: ") + QString::number(incline));
-    emit debug(QStringLiteral("Current heart: ") + QString::number(Heart.value()));
-    emit debug(QStringLiteral("Current KCal: ") + QString::number(KCal.value()));
+    LOG_DEVICE(QStringLiteral("Current heart: ") + QString::number(Heart.value()));
+    LOG_DEVICE(QStringLiteral("Current KCal: ") + QString::number(KCal.value()));
     // emit debug(QStringLiteral("Current Distance: ") + QString::number(distance));
-    emit debug(QStringLiteral("Current Distance Calculated: ") + QString::number(Distance.value()));
+    LOG_DEVICE(QStringLiteral("Current Distance Calculated: ") + QString::number(Distance.value()));
 
     if (m_control->error() != QLowEnergyController::NoError) {
         qDebug() << QStringLiteral("QLowEnergyController ERROR!!") << m_control->errorString();
@@ -399,7 +400,7 @@ void kingsmithr1protreadmill::stateChanged(QLowEnergyService::ServiceState state
     QBluetoothUuid _gattWriteCharacteristicId((quint16)0xFE02);
     QBluetoothUuid _gattNotifyCharacteristicId((quint16)0xFE01);
     QMetaEnum metaEnum = QMetaEnum::fromType<QLowEnergyService::ServiceState>();
-    emit debug(QStringLiteral("BTLE stateChanged ") + QString::fromLocal8Bit(metaEnum.valueToKey(state)));
+    LOG_DEVICE(QStringLiteral("BTLE stateChanged ") + QString::fromLocal8Bit(metaEnum.valueToKey(state)));
     if (state == QLowEnergyService::ServiceDiscovered) {
 
         // qDebug() << gattCommunicationChannelService->characteristics();
@@ -429,7 +430,7 @@ void kingsmithr1protreadmill::stateChanged(QLowEnergyService::ServiceState state
 }
 
 void kingsmithr1protreadmill::descriptorWritten(const QLowEnergyDescriptor &descriptor, const QByteArray &newValue) {
-    emit debug(QStringLiteral("descriptorWritten ") + descriptor.name() + QStringLiteral(" ") + newValue.toHex(' '));
+    LOG_PACKET(QStringLiteral("descriptorWritten ") + descriptor.name() + QStringLiteral(" ") + newValue.toHex(' '));
 
     initRequest = true;
     emit connectedAndDiscovered();
@@ -438,12 +439,12 @@ void kingsmithr1protreadmill::descriptorWritten(const QLowEnergyDescriptor &desc
 void kingsmithr1protreadmill::characteristicWritten(const QLowEnergyCharacteristic &characteristic,
                                                     const QByteArray &newValue) {
     Q_UNUSED(characteristic);
-    emit debug(QStringLiteral("characteristicWritten ") + newValue.toHex(' '));
+    LOG_PACKET(QStringLiteral("characteristicWritten ") + newValue.toHex(' '));
 }
 
 void kingsmithr1protreadmill::serviceScanDone(void) {
     QBluetoothUuid _gattCommunicationChannelServiceId((quint16)0xFE00);
-    emit debug(QStringLiteral("serviceScanDone"));
+    LOG_DEVICE(QStringLiteral("serviceScanDone"));
 
     gattCommunicationChannelService = m_control->createServiceObject(_gattCommunicationChannelServiceId);
     connect(gattCommunicationChannelService, &QLowEnergyService::stateChanged, this,
@@ -454,14 +455,14 @@ void kingsmithr1protreadmill::serviceScanDone(void) {
 void kingsmithr1protreadmill::errorService(QLowEnergyService::ServiceError err) {
 
     QMetaEnum metaEnum = QMetaEnum::fromType<QLowEnergyService::ServiceError>();
-    emit debug(QStringLiteral("kingsmithr1protreadmill::errorService ") +
+    LOG_DEVICE(QStringLiteral("kingsmithr1protreadmill::errorService ") +
                QString::fromLocal8Bit(metaEnum.valueToKey(err)) + m_control->errorString());
 }
 
 void kingsmithr1protreadmill::error(QLowEnergyController::Error err) {
 
     QMetaEnum metaEnum = QMetaEnum::fromType<QLowEnergyController::Error>();
-    emit debug(QStringLiteral("kingsmithr1protreadmill::error ") + QString::fromLocal8Bit(metaEnum.valueToKey(err)) +
+    LOG_DEVICE(QStringLiteral("kingsmithr1protreadmill::error ") + QString::fromLocal8Bit(metaEnum.valueToKey(err)) +
                m_control->errorString());
 }
 
@@ -490,18 +491,18 @@ void kingsmithr1protreadmill::deviceDiscovered(const QBluetoothDeviceInfo &devic
                 this, [this](QLowEnergyController::Error error) {
                     Q_UNUSED(error);
                     Q_UNUSED(this);
-                    emit debug(QStringLiteral("Cannot connect to remote device."));
+                    LOG_DEVICE(QStringLiteral("Cannot connect to remote device."));
                     searchStopped = false;
                     emit disconnected();
                 });
         connect(m_control, &QLowEnergyController::connected, this, [this]() {
             Q_UNUSED(this);
-            emit debug(QStringLiteral("Controller connected. Search services..."));
+            LOG_DEVICE(QStringLiteral("Controller connected. Search services..."));
             m_control->discoverServices();
         });
         connect(m_control, &QLowEnergyController::disconnected, this, [this]() {
             Q_UNUSED(this);
-            emit debug(QStringLiteral("LowEnergy controller disconnected"));
+            LOG_DEVICE(QStringLiteral("LowEnergy controller disconnected"));
             searchStopped = false;
             emit disconnected();
         });
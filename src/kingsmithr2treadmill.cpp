@@ -1,4 +1,5 @@
 #include "kingsmithr2treadmill.h"
+#include "logging.h"
 #include "ios/lockscreen.h"
 #include "keepawakehelper.h"
 #include "virtualtreadmill.h"
@@ -11,6 +12,32 @@
 
 using namespace std::chrono_literals;
 
+const QByteArray kingsmithr2treadmill::PLAINTEXT_TABLE =
+    QByteArrayLiteral("ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/=");
+const QByteArray kingsmithr2treadmill::ENCRYPT_TABLE =
+    QByteArrayLiteral("SaCw4FGHIJqLhN+P9RVTU/WcY6ObDdefgEijklmnopQrsBuvMxXz1yA2t5078KZ3=");
+
+QByteArray kingsmithr2treadmill::encrypt(const QByteArray &plain) {
+    QByteArray input = plain.toBase64();
+    QByteArray encrypted;
+    for (int i = 0; i < input.length(); i++) {
+        int idx = PLAINTEXT_TABLE.indexOf(input.at(i));
+        encrypted.append(ENCRYPT_TABLE[idx]);
+    }
+    return encrypted;
+}
+
+QByteArray kingsmithr2treadmill::decrypt(const QByteArray &message) {
+    QByteArray decrypted;
+    for (int i = 0; i < message.length(); i++) {
+        int idx = ENCRYPT_TABLE.indexOf(message.at(i));
+        if (idx >= 0) {
+            decrypted.append(PLAINTEXT_TABLE[idx]);
+        }
+    }
+    return QByteArray::fromBase64(decrypted);
+}
+
 kingsmithr2treadmill::kingsmithr2treadmill(uint32_t pollDeviceTime, bool noConsole, bool noHeartService,
                                            double forceInitSpeed, double forceInitInclination) {
     m_watt.setType(metric::METRIC_WATT);
@@ -47,36 +74,31 @@ void kingsmithr2treadmill::writeCharacteristic(const QString &data, const QStrin
 
     if (gattCommunicationChannelService->state() != QLowEnergyService::ServiceState::ServiceDiscovered ||
         m_control->state() == QLowEnergyController::UnconnectedState) {
-        emit debug(QStringLiteral("writeCharacteristic error because the connection is closed"));
+        LOG_DEVICE(QStringLiteral("writeCharacteristic error because the connection is closed"));
 
         return;
     }
 
-    QByteArray input = data.toUtf8().toBase64();
-    QByteArray encrypted;
-    for (int i = 0; i < input.length(); i++) {
-        int idx = PLAINTEXT_TABLE.indexOf(input.at(i));
-        encrypted.append(ENCRYPT_TABLE[idx]);
-    }
+    QByteArray encrypted = encrypt(data.toUtf8());
     if (!disable_log) {
-        emit debug(QStringLiteral(" >> plain: ") + data + QStringLiteral(" // ") + info);
-        emit debug(QStringLiteral(" >> base64: ") + QString(input) + QStringLiteral(" // ") + info);
-        emit debug(QStringLiteral(" >> encrypted: ") + QString(encrypted) + QStringLiteral(" // ") + info);
+        LOG_DEVICE(QStringLiteral(" >> plain: ") + data + QStringLiteral(" // ") + info);
+        LOG_DEVICE(QStringLiteral(" >> base64: ") + QString(data.toUtf8().toBase64()) + QStringLiteral(" // ") + info);
+        LOG_DEVICE(QStringLiteral(" >> encrypted: ") + QString(encrypted) + QStringLiteral(" // ") + info);
     }
-    encrypted.append('\x0d');
-    for (int i = 0; i < encrypted.length(); i += 16) {
-        gattCommunicationChannelService->writeCharacteristic(gattWriteCharacteristic, encrypted.mid(i, 16),
+    encrypted.append(terminator);
+    for (const QByteArray &chunk : framing::chunks(encrypted, 16)) {
+        gattCommunicationChannelService->writeCharacteristic(gattWriteCharacteristic, chunk,
                                                              QLowEnergyService::WriteWithoutResponse);
     }
 
     if (!disable_log) {
-        emit debug(QStringLiteral(" >> ") + encrypted.toHex(' ') + QStringLiteral(" // ") + info);
+        LOG_PACKET(QStringLiteral(" >> ") + encrypted.toHex(' ') + QStringLiteral(" // ") + info);
     }
 
     loop.exec();
 
     if (timeout.isActive() == false) {
-        emit debug(QStringLiteral(" exit for timeout"));
+        LOG_DEVICE(QStringLiteral(" exit for timeout"));
     }
 }
 
@@ -147,7 +169,7 @@ void kingsmithr2treadmill::update() {
         // byte 17    = inclination
         if (requestSpeed != -1) {
             if (requestSpeed != currentSpeed().value() && requestSpeed >= 0 && requestSpeed <= 22) {
-                emit debug(QStringLiteral("writing speed ") + QString::number(requestSpeed));
+                LOG_DEVICE(QStringLiteral("writing speed ") + QString::number(requestSpeed));
 
                 double inc = Inclination.value();
                 if (requestInclination != -1) {
@@ -166,7 +188,7 @@ void kingsmithr2treadmill::update() {
             requestInclination = qRound(requestInclination * 2.0) / 2.0;
             if (requestInclination != currentInclination().value() && requestInclination >= 0 &&
                 requestInclination <= 15) {
-                emit debug(QStringLiteral("writing incline ") + QString::number(requestInclination));
+                LOG_DEVICE(QStringLiteral("writing incline ") + QString::number(requestInclination));
 
                 double speed = currentSpeed().value();
                 if (requestSpeed != -1) {
@@ -179,7 +201,7 @@ void kingsmithr2treadmill::update() {
             requestInclination = -1;
         }
         if (requestStart != -1) {
-            emit debug(QStringLiteral("starting..."));
+            LOG_DEVICE(QStringLiteral("starting..."));
             if (lastSpeed == 0.0) {
 
                 lastSpeed = 0.5;
@@ -189,22 +211,22 @@ void kingsmithr2treadmill::update() {
             emit tapeStarted();
         }
         if (requestStop != -1) {
-            emit debug(QStringLiteral("stopping..."));
+            LOG_DEVICE(QStringLiteral("stopping..."));
             requestStop = -1;
         }
         if (requestFanSpeed != -1) {
-            emit debug(QStringLiteral("changing fan speed..."));
+            LOG_DEVICE(QStringLiteral("changing fan speed..."));
 
             //sendChangeFanSpeed(requestFanSpeed);
             requestFanSpeed = -1;
         }
         if (requestIncreaseFan != -1) {
-            emit debug(QStringLiteral("increasing fan speed..."));
+            LOG_DEVICE(QStringLiteral("increasing fan speed..."));
 
             //sendChangeFanSpeed(FanSpeed + 1);
             requestIncreaseFan = -1;
         } else if (requestDecreaseFan != -1) {
-            emit debug(QStringLiteral("decreasing fan speed..."));
+            LOG_DEVICE(QStringLiteral("decreasing fan speed..."));
 
             //sendChangeFanSpeed(FanSpeed - 1);
             requestDecreaseFan = -1;
@@ -213,7 +235,7 @@ void kingsmithr2treadmill::update() {
 }
 
 void kingsmithr2treadmill::serviceDiscovered(const QBluetoothUuid &gatt) {
-    emit debug(QStringLiteral("serviceDiscovered ") + gatt.toString());
+    LOG_DEVICE(QStringLiteral("serviceDiscovered ") + gatt.toString());
 }
 
 void kingsmithr2treadmill::characteristicChanged(const QLowEnergyCharacteristic &characteristic,
@@ -225,29 +247,20 @@ void kingsmithr2treadmill::characteristicChanged(const QLowEnergyCharacteristic
     Q_UNUSED(characteristic);
     QByteArray value = newValue;
 
-    emit debug(QStringLiteral(" << ") + QString::number(value.length()) + QStringLiteral(" ") + value.toHex(' '));
+    LOG_PACKET(QStringLiteral(" << ") + QString::number(value.length()) + QStringLiteral(" ") + value.toHex(' '));
 
-    buffer.append(value);
-    if (value.back() != '\x0d') {
-        emit debug(QStringLiteral("packet not finished"));
+    QList<QByteArray> messages = frames.feed(value);
+    if (messages.isEmpty()) {
+        LOG_DEVICE(QStringLiteral("packet not finished"));
         return;
     }
-    QByteArray decrypted;
-    for (int i = 0; i < buffer.length(); i++) {
-        char ch = buffer.at(i);
-        if (ch == '\x0d') {
-            continue;
-        }
-        int idx = ENCRYPT_TABLE.indexOf(ch);
-        decrypted.append(PLAINTEXT_TABLE[idx]);
-    }
-    buffer.clear();
-    lastValue = QByteArray::fromBase64(decrypted);
+    // the props are absolute values, the last message has the most recent ones
+    lastValue = decrypt(messages.last());
 
     emit packetReceived();
 
     QString data = QString(lastValue);
-    emit debug(QStringLiteral(" << decrypted: ") + QString(data));
+    LOG_DEVICE(QStringLiteral(" << decrypted: ") + QString(data));
 
     if (!data.startsWith("props")) {
         // TODO
@@ -262,7 +275,7 @@ void kingsmithr2treadmill::characteristicChanged(const QLowEnergyCharacteristic
             continue;
         }
         QString value = _props.at(i + 1);
-        emit debug(key + ": " + value);
+        LOG_DEVICE(key + ": " + value);
         props[key] = value.toDouble();
     }
 
@@ -316,12 +329,12 @@ void kingsmithr2treadmill::characteristicChanged(const QLowEnergyCharacteristic
         lastTimeCharacteristicChanged = QDateTime::currentDateTime();
     }
 
-    emit debug(QStringLiteral("Current speed: ") + QString::number(speed));
+    LOG_DEVICE(QStringLiteral("Current speed: ") + QString::number(speed));
     // emit debug(QStringLiteral("Current incline: ") + QString::number(incline));
-    emit debug(QStringLiteral("Current heart: ") + QString::number(Heart.value()));
-    emit debug(QStringLiteral("Current KCal: ") + QString::number(KCal.value()));
+    LOG_DEVICE(QStringLiteral("Current heart: ") + QString::number(Heart.value()));
+    LOG_DEVICE(QStringLiteral("Current KCal: ") + QString::number(KCal.value()));
     // emit debug(QStringLiteral("Current Distance: ") + QString::number(distance));
-    emit debug(QStringLiteral("Current Distance Calculated: ") + QString::number(Distance.value()));
+    LOG_DEVICE(QStringLiteral("Current Distance Calculated: ") + QString::number(Distance.value()));
 
     if (m_control->error() != QLowEnergyController::NoError) {
         qDebug() << QStringLiteral("QLowEnergyController ERROR!!") << m_control->errorString();
@@ -343,7 +356,7 @@ void kingsmithr2treadmill::characteristicChanged(const QLowEnergyCharacteristic
 }
 
 void kingsmithr2treadmill::btinit(bool startTape) {
-    emit debug(QStringLiteral("btinit"));
+    LOG_DEVICE(QStringLiteral("btinit"));
 
     writeCharacteristic(QStringLiteral(""), QStringLiteral("init"), false, true);
     // format error
@@ -375,7 +388,7 @@ void kingsmithr2treadmill::stateChanged(QLowEnergyService::ServiceState state) {
     QBluetoothUuid _gattWriteCharacteristicId((quint16)0xFED7);
     QBluetoothUuid _gattNotifyCharacteristicId((quint16)0xFED8);
     QMetaEnum metaEnum = QMetaEnum::fromType<QLowEnergyService::ServiceState>();
-    emit debug(QStringLiteral("BTLE stateChanged ") + QString::fromLocal8Bit(metaEnum.valueToKey(state)));
+    LOG_DEVICE(QStringLiteral("BTLE stateChanged ") + QString::fromLocal8Bit(metaEnum.valueToKey(state)));
     if (state == QLowEnergyService::DiscoveringServices) {
     }
     if (state == QLowEnergyService::ServiceDiscovered) {
@@ -407,7 +420,7 @@ void kingsmithr2treadmill::stateChanged(QLowEnergyService::ServiceState state) {
 }
 
 void kingsmithr2treadmill::descriptorWritten(const QLowEnergyDescriptor &descriptor, const QByteArray &newValue) {
-    emit debug(QStringLiteral("descriptorWritten ") + descriptor.name() + QStringLiteral(" ") + newValue.toHex(' '));
+    LOG_PACKET(QStringLiteral("descriptorWritten ") + descriptor.name() + QStringLiteral(" ") + newValue.toHex(' '));
 
     initRequest = true;
     emit connectedAndDiscovered();
@@ -416,12 +429,12 @@ void kingsmithr2treadmill::descriptorWritten(const QLowEnergyDescriptor &descrip
 void kingsmithr2treadmill::characteristicWritten(const QLowEnergyCharacteristic &characteristic,
                                                  const QByteArray &newValue) {
     Q_UNUSED(characteristic);
-    emit debug(QStringLiteral("characteristicWritten ") + newValue.toHex(' '));
+    LOG_PACKET(QStringLiteral("characteristicWritten ") + newValue.toHex(' '));
 }
 
 void kingsmithr2treadmill::serviceScanDone(void) {
     QBluetoothUuid _gattCommunicationChannelServiceId((quint16)0x1234);
-    emit debug(QStringLiteral("serviceScanDone"));
+    LOG_DEVICE(QStringLiteral("serviceScanDone"));
 
     gattCommunicationChannelService = m_control->createServiceObject(_gattCommunicationChannelServiceId);
     connect(gattCommunicationChannelService, &QLowEnergyService::stateChanged, this,
@@ -432,14 +445,14 @@ void kingsmithr2treadmill::serviceScanDone(void) {
 void kingsmithr2treadmill::errorService(QLowEnergyService::ServiceError err) {
 
     QMetaEnum metaEnum = QMetaEnum::fromType<QLowEnergyService::ServiceError>();
-    emit debug(QStringLiteral("kingsmithr2treadmill::errorService ") +
+    LOG_DEVICE(QStringLiteral("kingsmithr2treadmill::errorService ") +
                QString::fromLocal8Bit(metaEnum.valueToKey(err)) + m_control->errorString());
 }
 
 void kingsmithr2treadmill::error(QLowEnergyController::Error err) {
 
     QMetaEnum metaEnum = QMetaEnum::fromType<QLowEnergyController::Error>();
-    emit debug(QStringLiteral("kingsmithr2treadmill::error ") + QString::fromLocal8Bit(metaEnum.valueToKey(err)) +
+    LOG_DEVICE(QStringLiteral("kingsmithr2treadmill::error ") + QString::fromLocal8Bit(metaEnum.valueToKey(err)) +
                m_control->errorString());
 }
 
@@ -460,18 +473,18 @@ void kingsmithr2treadmill::deviceDiscovered(const QBluetoothDeviceInfo &device)
                 this, [this](QLowEnergyController::Error error) {
                     Q_UNUSED(error);
                     Q_UNUSED(this);
-                    emit debug(QStringLiteral("Cannot connect to remote device."));
+                    LOG_DEVICE(QStringLiteral("Cannot connect to remote device."));
                     searchStopped = false;
                     emit disconnected();
                 });
         connect(m_control, &QLowEnergyController::connected, this, [this]() {
             Q_UNUSED(this);
-            emit debug(QStringLiteral("Controller connected. Search services..."));
+            LOG_DEVICE(QStringLiteral("Controller connected. Search services..."));
             m_control->discoverServices();
         });
         connect(m_control, &QLowEnergyController::disconnected, this, [this]() {
             Q_UNUSED(this);
-            emit debug(QStringLiteral("LowEnergy controller disconnected"));
+            LOG_DEVICE(QStringLiteral("LowEnergy controller disconnected"));
             searchStopped = false;
             emit disconnected();
         });
@@ -28,6 +28,7 @@
 #include <QMap>
 #include <QObject>
 
+#include "framing.h"
 #include "treadmill.h"
 #include "virtualbike.h"
 #include "virtualtreadmill.h"
@@ -47,11 +48,14 @@ class kingsmithr2treadmill : public treadmill {
     void *VirtualTreadMill();
     void *VirtualDevice();
 
+    // the messages are base64 with a substitution cipher, terminated by a CR
+    static const char terminator = '\x0d';
+    static QByteArray encrypt(const QByteArray &plain);
+    static QByteArray decrypt(const QByteArray &message);
+
   private:
-    const QByteArray PLAINTEXT_TABLE =
-        QStringLiteral("ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/=").toUtf8();
-    const QByteArray ENCRYPT_TABLE =
-        QStringLiteral("SaCw4FGHIJqLhN+P9RVTU/WcY6ObDdefgEijklmnopQrsBuvMxXz1yA2t5078KZ3=").toUtf8();
+    static const QByteArray PLAINTEXT_TABLE;
+    static const QByteArray ENCRYPT_TABLE;
 
     double GetInclinationFromPacket(const QByteArray &packet);
     double GetKcalFromPacket(const QByteArray &packet);
@@ -69,7 +73,7 @@ class kingsmithr2treadmill : public treadmill {
     uint8_t sec1Update = 0;
     uint8_t firstInit = 0;
     QMap<QString, double> props;
-    QByteArray buffer;
+    terminatorframer frames = terminatorframer(terminator);
     QByteArray lastValue;
     QDateTime lastTimeCharacteristicChanged;
     bool firstCharacteristicChanged = true;
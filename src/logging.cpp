@@ -0,0 +1,36 @@
+#include "logging.h"
+#include <atomic>
+
+Q_LOGGING_CATEGORY(logdevice, "qz.device")
+Q_LOGGING_CATEGORY(logpacket, "qz.packet")
+
+namespace {
+
+std::atomic<bool> enabled{true};
+bool installed = false;
+QLoggingCategory::CategoryFilter previousFilter = nullptr;
+
+// chained to the default filter, so it survives the QLoggingCategory::setFilterRules() calls of the app
+void categoryFilter(QLoggingCategory *category) {
+    if (previousFilter) {
+        previousFilter(category);
+    }
+    if (!enabled && qstrncmp(category->categoryName(), "qz.", 3) == 0) {
+        category->setEnabled(QtDebugMsg, false);
+        category->setEnabled(QtInfoMsg, false);
+    }
+}
+
+} // namespace
+
+void logging::setEnabled(bool on) {
+    enabled = on;
+    // installing the filter runs it again on all the categories
+    QLoggingCategory::CategoryFilter old = QLoggingCategory::installFilter(categoryFilter);
+    if (!installed) {
+        previousFilter = old;
+        installed = true;
+    }
+}
+
+bool logging::isEnabled() { return enabled; }
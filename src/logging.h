@@ -0,0 +1,37 @@
+#ifndef LOGGING_H
+#define LOGGING_H
+
+#include <QLoggingCategory>
+
+#include "qdebugfixup.h"
+
+// Logging categories of the devices. The check on the category comes before the message is built, so a trace costs a
+// branch when the logging is off: the QString concatenations and the toHex() of the packets aren't evaluated at all.
+//
+//   qz.device   decoded values and state of the drivers
+//   qz.packet   raw packets sent and received
+//
+// At runtime they follow the -no-log switch and the log_debug setting, and the usual QT_LOGGING_RULES rules
+// (i.e. "qz.packet.debug=false" to keep the decoded values only). Building with QZ_NO_TRACES (qmake
+// CONFIG+=qz_no_traces) strips them from the binary, while the plain qDebug() of the log stay. It's opt-in: the
+// release builds keep them, the logs the users send are made of them.
+Q_DECLARE_LOGGING_CATEGORY(logdevice)
+Q_DECLARE_LOGGING_CATEGORY(logpacket)
+
+#ifdef QZ_NO_TRACES
+// still compiled, never evaluated
+#define LOG_DEVICE(text) while (false) QMessageLogger().noDebug() << (text)
+#define LOG_PACKET(text) while (false) QMessageLogger().noDebug() << (text)
+#else
+// same length of "emit debug(": the continuation lines of the calls keep their alignment
+#define LOG_DEVICE(text) qCDebug(logdevice).noquote() << (text)
+#define LOG_PACKET(text) qCDebug(logpacket).noquote() << (text)
+#endif
+
+namespace logging {
+// turns on or off all the qz.* categories, whatever the filter rules say
+void setEnabled(bool enabled);
+bool isEnabled();
+} // namespace logging
+
+#endif // LOGGING_H
@@ -0,0 +1,152 @@
+#include "logwriter.h"
+#include "gzip.h"
+#include <chrono>
+#include <stdio.h>
+
+using namespace std::chrono_literals;
+
+std::atomic<quint64> logwriter::s_dropped{0};
+
+logwriter::logwriter(const QString &fileName, qint64 rotateSize, int rotatedFiles, bool compress, bool echo,
+                     int capacity)
+    : fileName(fileName), rotateSize(rotateSize), rotatedFiles(qMax(1, rotatedFiles)), compress(compress), echo(echo),
+      file(fileName) {
+    size_t size = 64;
+    while (size < (size_t)capacity) {
+        size <<= 1;
+    }
+    mask = size - 1;
+    slots.reset(new slot[size]);
+    for (size_t i = 0; i < size; i++) {
+        slots[i].sequence.store(i, std::memory_order_relaxed);
+    }
+    thread = std::thread(&logwriter::run, this);
+}
+
+logwriter::~logwriter() {
+    running = false;
+    wake.notify_one();
+    if (thread.joinable()) {
+        thread.join();
+    }
+    flush();
+}
+
+bool logwriter::push(QByteArray line) {
+    size_t pos = head.load(std::memory_order_relaxed);
+    slot *s;
+    while (true) {
+        s = &slots[pos & mask];
+        size_t sequence = s->sequence.load(std::memory_order_acquire);
+        intptr_t dif = (intptr_t)sequence - (intptr_t)pos;
+        if (dif == 0) {
+            if (head.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                break;
+            }
+        } else if (dif < 0) {
+            // full: the writer is behind, the line is lost
+            m_dropped++;
+            s_dropped++;
+            return false;
+        } else {
+            pos = head.load(std::memory_order_relaxed);
+        }
+    }
+    s->data = std::move(line);
+    s->sequence.store(pos + 1, std::memory_order_release);
+
+    // the writer wakes up by itself every 100ms, it's called earlier only when a batch is ready
+    if ((pos & 63) == 63) {
+        wake.notify_one();
+    }
+    return true;
+}
+
+bool logwriter::pop(QByteArray &line) {
+    slot &s = slots[tail & mask];
+    if (s.sequence.load(std::memory_order_acquire) != tail + 1) {
+        return false;
+    }
+    line = std::move(s.data);
+    s.data = QByteArray();
+    s.sequence.store(tail + mask + 1, std::memory_order_release);
+    tail++;
+    return true;
+}
+
+void logwriter::run() {
+    while (running) {
+        {
+            std::unique_lock<std::mutex> lock(wakeMutex);
+            wake.wait_for(lock, 100ms);
+        }
+        drain();
+    }
+}
+
+void logwriter::flush() { drain(); }
+
+void logwriter::drain() {
+    std::lock_guard<std::mutex> lock(drainMutex);
+    QByteArray batch;
+    QByteArray line;
+    while (pop(line)) {
+        batch.append(line);
+    }
+    quint64 lost = m_dropped;
+    if (lost != reported) {
+        batch.append(QByteArray("logwriter: ") + QByteArray::number(lost - reported) +
+                     QByteArray(" messages dropped, the log is writing too slowly\n"));
+        reported = lost;
+    }
+    if (batch.isEmpty()) {
+        return;
+    }
+
+    if (!file.isOpen() && !file.open(QIODevice::WriteOnly | QIODevice::Append)) {
+        fprintf(stderr, "logwriter: unable to open %s\n", qPrintable(fileName));
+    }
+    if (file.isOpen()) {
+        file.write(batch);
+        file.flush();
+    }
+    if (echo) {
+        fwrite(batch.constData(), 1, batch.length(), stderr);
+    }
+
+    if (rotateSize > 0 && file.isOpen() && file.size() >= rotateSize) {
+        rotate();
+    }
+}
+
+void logwriter::rotate() {
+    file.close();
+    QString suffix = compress ? QStringLiteral(".gz") : QString();
+    QFile::remove(fileName + QStringLiteral(".") + QString::number(rotatedFiles) + suffix);
+    for (int i = rotatedFiles - 1; i >= 1; i--) {
+        QFile::rename(fileName + QStringLiteral(".") + QString::number(i) + suffix,
+                      fileName + QStringLiteral(".") + QString::number(i + 1) + suffix);
+    }
+
+    QString rotated = fileName + QStringLiteral(".1");
+    // left there by a compression that failed
+    QFile::remove(rotated);
+    QFile::rename(fileName, rotated);
+    if (compress) {
+        QFile in(rotated);
+        QFile out(rotated + suffix);
+        // a chunk at a time: the rotated file can be as big as rotateSize
+        if (in.open(QIODevice::ReadOnly) && out.open(QIODevice::WriteOnly)) {
+            bool ok = gzip::compress(in, out);
+            in.close();
+            out.close();
+            if (ok) {
+                QFile::remove(rotated);
+            } else {
+                // the plain file is kept until the next rotation
+                QFile::remove(rotated + suffix);
+            }
+        }
+    }
+    file.open(QIODevice::WriteOnly | QIODevice::Append);
+}
@@ -0,0 +1,72 @@
+#ifndef LOGWRITER_H
+#define LOGWRITER_H
+
+#include <QByteArray>
+#include <QFile>
+#include <QString>
+
+#include <atomic>
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <thread>
+
+// Asynchronous sink of the log file. The message handler only formats the line and pushes it in a bounded lock free
+// ring (many producers, one consumer), a writer thread drains it in batches to the file and, optionally, to stderr.
+// When the ring is full the new lines are dropped and counted, the writer reports how many were lost: a burst of
+// traces can't stall the bluetooth event loop or grow the memory without limits.
+//
+// With rotateSize > 0 the file is rotated when it grows over it: name.1 is the most recent, up to rotatedFiles are
+// kept, and they are compressed (gzip, .gz suffix) when compress is set.
+class logwriter {
+  public:
+    explicit logwriter(const QString &fileName, qint64 rotateSize = 0, int rotatedFiles = 3, bool compress = false,
+                       bool echo = true, int capacity = 8192);
+    ~logwriter();
+
+    // never blocks, false when the line was dropped
+    bool push(QByteArray line);
+    // writes everything pushed so far, from the calling thread (i.e. before an abort)
+    void flush();
+    quint64 dropped() const { return m_dropped; }
+    // lines dropped by all the writers of the process, for the metrics of the web server
+    static quint64 totalDropped() { return s_dropped; }
+
+  private:
+#ifdef TEST
+    // holds drainMutex to fill the ring
+    friend class unittests;
+#endif
+    struct slot {
+        std::atomic<size_t> sequence;
+        QByteArray data;
+    };
+
+    bool pop(QByteArray &line);
+    void run();
+    void drain();
+    void rotate();
+
+    QString fileName;
+    qint64 rotateSize;
+    int rotatedFiles;
+    bool compress;
+    bool echo;
+
+    std::unique_ptr<slot[]> slots;
+    size_t mask;
+    std::atomic<size_t> head{0};
+    size_t tail = 0;
+    std::atomic<quint64> m_dropped{0};
+    static std::atomic<quint64> s_dropped;
+    quint64 reported = 0;
+
+    QFile file;
+    std::mutex drainMutex;
+    std::mutex wakeMutex;
+    std::condition_variable wake;
+    std::atomic<bool> running{true};
+    std::thread thread;
+};
+
+#endif // LOGWRITER_H
@@ -1,4 +1,5 @@
 #include "m3ibike.h"
+#include "logging.h"
 #include "ios/lockscreen.h"
 #include "keepawakehelper.h"
 #include "virtualbike.h"
@@ -272,7 +273,7 @@ m3ibike::m3ibike(bool noWriteResistance, bool noHeartService) {
     connect(detectDisc, &QTimer::timeout, this, [this]() {
         Q_UNUSED(this);
         emit disconnected();
-        emit debug(QStringLiteral("M3i detected disconnection"));
+        LOG_DEVICE(QStringLiteral("M3i detected disconnection"));
         initDone = false;
         detectDisc->stop();
         elapsedTimer->stop();
@@ -353,7 +354,7 @@ void m3ibike::disconnectBluetooth() {
         discoveryAgent->stop();
     }
     emit disconnected();
-    emit debug(QStringLiteral("M3i detected disconnection"));
+    LOG_DEVICE(QStringLiteral("M3i detected disconnection"));
     initDone = false;
 }
 
@@ -515,12 +516,12 @@ void m3ibike::initScan() {
 
 #if (QT_VERSION >= QT_VERSION_CHECK(5, 12, 0))
 void m3ibike::deviceUpdatedPriv(const QBluetoothDeviceInfo &device, QBluetoothDeviceInfo::Fields updateFields) {
-    emit debug(QStringLiteral("deviceUpdated ") + device.name() + " " + updateFields);
+    LOG_DEVICE(QStringLiteral("deviceUpdated ") + device.name() + " " + updateFields);
 }
 
 void m3ibike::deviceDiscoveredPriv(const QBluetoothDeviceInfo &device) {
     if (SAME_BLUETOOTH_DEVICE(device, bluetoothDevice)) {
-        emit debug(QStringLiteral("NEW ADV ") + bluetoothDevice.name());
+        LOG_DEVICE(QStringLiteral("NEW ADV ") + bluetoothDevice.name());
         QHash<quint16, QByteArray> datas = device.manufacturerData();
         QHashIterator<quint16, QByteArray> i(datas);
         while (i.hasNext()) {
@@ -610,7 +611,7 @@ void m3ibike::processAdvertising(const QByteArray &data) {
     if (disconnecting) {
         return;
     }
-    emit debug(QStringLiteral(" << ") + data.toHex(' '));
+    LOG_PACKET(QStringLiteral(" << ") + data.toHex(' '));
     if (parse_data(data, &k3)) {
         QSettings settings;
         detectDisc->start(M3i_DISCONNECT_THRESHOLD);
@@ -632,7 +633,7 @@ void m3ibike::processAdvertising(const QByteArray &data) {
                 } else
 #endif
                     if (virtual_device_enabled) {
-                    emit debug(QStringLiteral("creating virtual bike interface..."));
+                    LOG_DEVICE(QStringLiteral("creating virtual bike interface..."));
                     virtualBike = new virtualbike(this, noWriteResistance, noHeartService);
                     // connect(virtualBike, &virtualbike::debug, this, &m3ibike::debug);
                     connect(virtualBike, &virtualbike::changeInclination, this, &m3ibike::changeInclination);
@@ -649,7 +650,7 @@ void m3ibike::processAdvertising(const QByteArray &data) {
             }
             emit connectedAndDiscovered();
             emit bikeStarted();
-            emit debug(QStringLiteral("M3i (re)connected"));
+            LOG_DEVICE(QStringLiteral("M3i (re)connected"));
         }
         int oldtime = k3.time;
         bool not_in_pause = k3s.inner_step(&k3);
@@ -666,6 +667,7 @@ void m3ibike::processAdvertising(const QByteArray &data) {
         }
         emit resistanceRead(Resistance.value());
 
+        applySensorFusion();
         if (settings.value(QStringLiteral("cadence_sensor_name"), QStringLiteral("Disabled"))
                 .toString()
                 .startsWith(QStringLiteral("Disabled"))) {
@@ -744,16 +746,16 @@ void m3ibike::processAdvertising(const QByteArray &data) {
         }
 #endif
 
-        emit debug(QStringLiteral("Current Elapsed: ") + QString::number(elapsed.value()));
-        emit debug(QStringLiteral("Current Resistance: ") + QString::number(Resistance.value()));
-        emit debug(QStringLiteral("Current Speed: ") + QString::number(Speed.value()));
-        emit debug(QStringLiteral("Current Calculate Distance: ") + QString::number(k3.distanceR));
-        emit debug(QStringLiteral("Current Cadence: ") + QString::number(Cadence.value()));
-        emit debug(QStringLiteral("Current Distance: ") + QString::number(Distance.value()));
-        emit debug(QStringLiteral("Current CrankRevs: ") + QString::number(CrankRevs));
-        emit debug(QStringLiteral("Last CrankEventTime: ") + QString::number(LastCrankEventTime));
-        emit debug(QStringLiteral("Current Watt: ") + QString::number(watts()));
-        emit debug(QStringLiteral("Current Heart: ") + QString::number(Heart.value()));
+        LOG_DEVICE(QStringLiteral("Current Elapsed: ") + QString::number(elapsed.value()));
+        LOG_DEVICE(QStringLiteral("Current Resistance: ") + QString::number(Resistance.value()));
+        LOG_DEVICE(QStringLiteral("Current Speed: ") + QString::number(Speed.value()));
+        LOG_DEVICE(QStringLiteral("Current Calculate Distance: ") + QString::number(k3.distanceR));
+        LOG_DEVICE(QStringLiteral("Current Cadence: ") + QString::number(Cadence.value()));
+        LOG_DEVICE(QStringLiteral("Current Distance: ") + QString::number(Distance.value()));
+        LOG_DEVICE(QStringLiteral("Current CrankRevs: ") + QString::number(CrankRevs));
+        LOG_DEVICE(QStringLiteral("Last CrankEventTime: ") + QString::number(LastCrankEventTime));
+        LOG_DEVICE(QStringLiteral("Current Watt: ") + QString::number(watts()));
+        LOG_DEVICE(QStringLiteral("Current Heart: ") + QString::number(Heart.value()));
     }
 }
 
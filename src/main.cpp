@@ -12,6 +12,8 @@
 #include "bluetooth.h"
 #include "domyostreadmill.h"
 #include "homeform.h"
+#include "logging.h"
+#include "logwriter.h"
 #include "mainwindow.h"
 #include "qfit.h"
 #include "virtualtreadmill.h"
@@ -77,6 +79,8 @@ QString logfilename = QStringLiteral("debug-") +
                           .replace(QStringLiteral("."), QStringLiteral("_")) +
                       QStringLiteral(".log");
 static const QtMessageHandler QT_DEFAULT_MESSAGE_HANDLER = qInstallMessageHandler(0);
+// the log file, owned by the loghandler of main()
+static logwriter *logWriter = nullptr;
 
 QCoreApplication *createApplication(int &argc, char *argv[]) {
 
@@ -213,8 +217,7 @@ QCoreApplication *createApplication(int &argc, char *argv[]) {
 
 void myMessageOutput(QtMsgType type, const QMessageLogContext &context, const QString &msg) {
 
-    QSettings settings;
-    static bool logdebug = settings.value(QStringLiteral("log_debug"), false).toBool();
+    static bool logdebug = QSettings().value(QStringLiteral("log_debug"), false).toBool();
 #if defined(Q_OS_LINUX) // Linux OS does not read settings file for now
     if((logs == false && !forceQml) || (logdebug == false && forceQml))
 #else
@@ -225,8 +228,16 @@ void myMessageOutput(QtMsgType type, const QMessageLogContext &context, const QS
     // QByteArray localMsg = msg.toLocal8Bit(); // NOTE: clazy-unused-non-trivial-variable
     const char *file = context.file ? context.file : "";
     const char *function = context.function ? context.function : "";
-    QString txt = QDateTime::currentDateTime().toString() + QStringLiteral(" ") +
-                  QString::number(QDateTime::currentMSecsSinceEpoch()) + QStringLiteral(" ");
+
+    // the date changes once per second, it's formatted again only then
+    static thread_local qint64 lastSecond = -1;
+    static thread_local QString date;
+    qint64 now = QDateTime::currentMSecsSinceEpoch();
+    if (now / 1000 != lastSecond) {
+        lastSecond = now / 1000;
+        date = QDateTime::fromMSecsSinceEpoch(now).toString();
+    }
+    QString txt = date + QStringLiteral(" ") + QString::number(now) + QStringLiteral(" ");
     switch (type) {
     case QtInfoMsg:
         txt += QStringLiteral("Info: %1 %2 %3\n").arg(file, function, msg); // NOTE: clazy-qstring-arg
@@ -242,26 +253,50 @@ void myMessageOutput(QtMsgType type, const QMessageLogContext &context, const QS
         break;
     case QtFatalMsg:
         txt += QStringLiteral("Fatal: %1 %2 %3\n").arg(file, function, msg); // NOTE: clazy-qstring-arg
-        abort();
+        break;
     }
 
-    if (logs == true || logdebug == true) {
-
-        QString path = homeform::getWritableAppDir();
+    if ((logs == true || logdebug == true) && logWriter) {
 
         // Linux log files are generated on binary location
+        // the file and stderr are written by a thread of the writer, the caller doesn't wait for the disk
+        logWriter->push(txt.toLocal8Bit());
+        if (type == QtFatalMsg) {
+            logWriter->flush();
+        }
+    }
 
-        QFile outFile(path + logfilename);
-        outFile.open(QIODevice::WriteOnly | QIODevice::Append);
-        QTextStream ts(&outFile);
-        ts << txt;
-
-        fprintf(stderr, "%s", txt.toLocal8Bit().constData());
+    if (type == QtFatalMsg) {
+        abort();
     }
 
     (*QT_DEFAULT_MESSAGE_HANDLER)(type, context, msg);
 }
 
+// Installs myMessageOutput for the scope of main() with the writer of the log file, when the log is enabled. The
+// handler is removed before the writer is flushed and destroyed: the messages of the shutdown go to the default
+// handler instead of a writer that isn't there anymore.
+class loghandler {
+  public:
+    explicit loghandler(bool enabled) {
+        if (enabled) {
+            writer.reset(
+                new logwriter(homeform::getWritableAppDir() + logfilename,
+                              QSettings().value(QStringLiteral("log_rotate_size"), 100).toLongLong() * 1024 * 1024, 3,
+                              QSettings().value(QStringLiteral("log_compress_rotated"), true).toBool()));
+            logWriter = writer.get();
+        }
+        qInstallMessageHandler(myMessageOutput);
+    }
+    ~loghandler() {
+        qInstallMessageHandler(nullptr);
+        logWriter = nullptr;
+    }
+
+  private:
+    std::unique_ptr<logwriter> writer;
+};
+
 int main(int argc, char *argv[]) {
 
 #ifdef Q_OS_ANDROID
@@ -330,7 +365,15 @@ int main(int argc, char *argv[]) {
     }
 #endif
 
-    qInstallMessageHandler(myMessageOutput);
+    // the same conditions of myMessageOutput and bluetooth::debug, checked before the device traces are built
+    bool logdebug = settings.value(QStringLiteral("log_debug"), false).toBool();
+#if defined(Q_OS_LINUX)
+    loghandler handler((logs || forceQml) && (logdebug || !forceQml));
+    logging::setEnabled(logs && (logdebug || !forceQml));
+#else
+    loghandler handler(logdebug);
+    logging::setEnabled(logs && logdebug);
+#endif
     qDebug() << QStringLiteral("version ") << app->applicationVersion();
     foreach (QString s, settings.allKeys()) {
         if (!s.contains(QStringLiteral("password"))) {
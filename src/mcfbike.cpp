@@ -58,6 +58,7 @@ void mcfbike::writeCharacteristic(uint8_t *data, uint8_t data_len, const QString
         return;
     }
 
+    writeRequested(QByteArray((const char *)data, data_len));
     gattCommunicationChannelService->writeCharacteristic(gattWriteCharacteristic,
                                                          QByteArray((const char *)data, data_len));
 
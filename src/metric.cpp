@@ -2,11 +2,6 @@
 #include "qdebugfixup.h"
 #include <QSettings>
 
-#ifdef TEST
-static uint32_t random_value_uint32 = 0;
-static uint8_t random_value_uint8 = 0;
-#endif
-
 metric::metric() {}
 
 void metric::setType(_metric_type t) { m_type = t; }
@@ -96,21 +91,9 @@ void metric::clear(bool accumulator) {
     m_min = 999999999;
     m_last5.clear();
     clearLap(accumulator);
-#ifdef TEST
-    random_value_uint8 = 0;
-    random_value_uint32 = 0;
-#endif
 }
 
 double metric::value() {
-#ifdef TEST
-    if (m_type != METRIC_ELAPSED) {
-        return (double)(rand() % 256);
-    } else {
-        return (double)(random_value_uint32++);
-    }
-
-#endif
     return m_value - m_offset;
 }
 
@@ -1,4 +1,5 @@
 #include "nautilustreadmill.h"
+#include "logging.h"
 #include "keepawakehelper.h"
 #include "virtualtreadmill.h"
 #include <QBluetoothLocalDevice>
@@ -53,7 +54,7 @@ void nautilustreadmill::writeCharacteristic(uint8_t *data, uint8_t data_len, con
         gattWriteCharacteristic, QByteArray((const char *)data, data_len));
 
     if (!disable_log) {
-        emit debug(QStringLiteral(" >> ") + QByteArray((const char *)data, data_len).toHex(' ') +
+        LOG_PACKET(QStringLiteral(" >> ") + QByteArray((const char *)data, data_len).toHex(' ') +
                    QStringLiteral(" // ") + info);
     }
 
@@ -62,7 +63,7 @@ void nautilustreadmill::writeCharacteristic(uint8_t *data, uint8_t data_len, con
         loop.exec();
 
         if (timeout.isActive() == false)
-            emit debug(QStringLiteral(" exit for timeout"));
+            LOG_DEVICE(QStringLiteral(" exit for timeout"));
     }
 }
 
@@ -98,7 +99,7 @@ void nautilustreadmill::update() {
         if (!firstInit && !virtualTreadMill) {
             bool virtual_device_enabled = settings.value(QStringLiteral("virtual_device_enabled"), true).toBool();
             if (virtual_device_enabled) {
-                emit debug(QStringLiteral("creating virtual treadmill interface..."));
+                LOG_DEVICE(QStringLiteral("creating virtual treadmill interface..."));
                 virtualTreadMill = new virtualtreadmill(this, noHeartService);
                 connect(virtualTreadMill, &virtualtreadmill::debug, this, &nautilustreadmill::debug);
                 firstInit = 1;
@@ -116,7 +117,7 @@ void nautilustreadmill::update() {
 
         if (requestSpeed != -1) {
             if (requestSpeed != currentSpeed().value() && requestSpeed >= 0 && requestSpeed <= 22) {
-                emit debug(QStringLiteral("writing speed ") + QString::number(requestSpeed));
+                LOG_DEVICE(QStringLiteral("writing speed ") + QString::number(requestSpeed));
                 // double inc = Inclination.value(); // NOTE: clang-analyzer-deadcode.DeadStores
                 if (requestInclination != -1) {
                     //                        inc = requestInclination;
@@ -129,7 +130,7 @@ void nautilustreadmill::update() {
         if (requestInclination != -1) {
             if (requestInclination != currentInclination().value() && requestInclination >= 0 &&
                 requestInclination <= 15) {
-                emit debug(QStringLiteral("writing incline ") + QString::number(requestInclination));
+                LOG_DEVICE(QStringLiteral("writing incline ") + QString::number(requestInclination));
                 // double speed = currentSpeed().value(); // NOTE: clang-analyzer-deadcode.DeadStores
                 if (requestSpeed != -1) {
                     // speed = requestSpeed;
@@ -141,7 +142,7 @@ void nautilustreadmill::update() {
         }
 
         if (requestStart != -1) {
-            emit debug(QStringLiteral("starting..."));
+            LOG_DEVICE(QStringLiteral("starting..."));
             if (lastSpeed == 0.0) {
                 lastSpeed = 0.5;
             }
@@ -149,7 +150,7 @@ void nautilustreadmill::update() {
             emit tapeStarted();
         }
         if (requestStop != -1) {
-            emit debug(QStringLiteral("stopping..."));
+            LOG_DEVICE(QStringLiteral("stopping..."));
             // writeCharacteristic(initDataF0C800B8, sizeof(initDataF0C800B8), "stop tape", false, true);
             requestStop = -1;
         }
@@ -157,7 +158,7 @@ void nautilustreadmill::update() {
 }
 
 void nautilustreadmill::serviceDiscovered(const QBluetoothUuid &gatt) {
-    emit debug(QStringLiteral("serviceDiscovered ") + gatt.toString());
+    LOG_DEVICE(QStringLiteral("serviceDiscovered ") + gatt.toString());
 }
 
 void nautilustreadmill::characteristicChanged(const QLowEnergyCharacteristic &characteristic,
@@ -169,7 +170,7 @@ void nautilustreadmill::characteristicChanged(const QLowEnergyCharacteristic &ch
     Q_UNUSED(characteristic);
     QByteArray value = newValue;
 
-    emit debug(QStringLiteral(" << ") + QString::number(value.length()) + QStringLiteral(" ") + value.toHex(' '));
+    LOG_PACKET(QStringLiteral(" << ") + QString::number(value.length()) + QStringLiteral(" ") + value.toHex(' '));
 
     emit packetReceived();
 
@@ -186,7 +187,7 @@ void nautilustreadmill::characteristicChanged(const QLowEnergyCharacteristic &ch
             /*if(heartRateBeltName.startsWith("Disabled"))
             Heart = value.at(18);*/
         }
-        emit debug(QStringLiteral("Current speed: ") + QString::number(speed));
+        LOG_DEVICE(QStringLiteral("Current speed: ") + QString::number(speed));
         // debug("Current Distance: " + QString::number(distance));
 
         if (Speed.value() != speed) {
@@ -197,7 +198,7 @@ void nautilustreadmill::characteristicChanged(const QLowEnergyCharacteristic &ch
             emit inclinationChanged(0.0, incline);
         }
         Inclination = incline;
-        emit debug(QStringLiteral("Current incline: ") + QString::number(incline));
+        LOG_DEVICE(QStringLiteral("Current incline: ") + QString::number(incline));
 
         //KCal = kcal;
         // Distance = distance;
@@ -216,8 +217,8 @@ void nautilustreadmill::characteristicChanged(const QLowEnergyCharacteristic &ch
                          (1000.0 / (lastTimeCharacteristicChanged.msecsTo(QDateTime::currentDateTime()))));
         }
 
-        emit debug(QStringLiteral("Current KCal Calculated: ") + QString::number(KCal.value()));
-        emit debug(QStringLiteral("Current Distance Calculated: ") + QString::number(Distance.value()));
+        LOG_DEVICE(QStringLiteral("Current KCal Calculated: ") + QString::number(KCal.value()));
+        LOG_DEVICE(QStringLiteral("Current Distance Calculated: ") + QString::number(Distance.value()));
 
         if (m_control->error() != QLowEnergyController::NoError) {
             qDebug() << QStringLiteral("QLowEnergyController ERROR!!") << m_control->errorString();
@@ -258,7 +259,7 @@ void nautilustreadmill::btinit(bool startTape) {
 
 void nautilustreadmill::stateChanged(QLowEnergyService::ServiceState state) {
     QMetaEnum metaEnum = QMetaEnum::fromType<QLowEnergyService::ServiceState>();
-    emit debug(QStringLiteral("BTLE stateChanged ") + QString::fromLocal8Bit(metaEnum.valueToKey(state)));
+    LOG_DEVICE(QStringLiteral("BTLE stateChanged ") + QString::fromLocal8Bit(metaEnum.valueToKey(state)));
     if (state == QLowEnergyService::ServiceDiscovered) {
         QBluetoothUuid _gattWriteCharacteristicId(QStringLiteral("1717b3c0-9803-11e3-90e1-0002a5d5c51b"));
         QBluetoothUuid _gattNotify1CharacteristicId(QStringLiteral("a46a4a80-9803-11e3-8f3c-0002a5d5c51b"));
@@ -302,7 +303,7 @@ void nautilustreadmill::stateChanged(QLowEnergyService::ServiceState state) {
 }
 
 void nautilustreadmill::descriptorWritten(const QLowEnergyDescriptor &descriptor, const QByteArray &newValue) {
-    emit debug(QStringLiteral("descriptorWritten ") + descriptor.name() + " " + newValue.toHex(' '));
+    LOG_PACKET(QStringLiteral("descriptorWritten ") + descriptor.name() + " " + newValue.toHex(' '));
 
     initRequest = true;
     emit connectedAndDiscovered();
@@ -311,11 +312,11 @@ void nautilustreadmill::descriptorWritten(const QLowEnergyDescriptor &descriptor
 void nautilustreadmill::characteristicWritten(const QLowEnergyCharacteristic &characteristic,
                                               const QByteArray &newValue) {
     Q_UNUSED(characteristic);
-    emit debug(QStringLiteral("characteristicWritten ") + newValue.toHex(' '));
+    LOG_PACKET(QStringLiteral("characteristicWritten ") + newValue.toHex(' '));
 }
 
 void nautilustreadmill::serviceScanDone(void) {
-    emit debug(QStringLiteral("serviceScanDone"));
+    LOG_DEVICE(QStringLiteral("serviceScanDone"));
 
     QBluetoothUuid _gattCommunicationChannelServiceId(QStringLiteral("89e14b5e-a841-48ad-b580-935f4545fffc"));
     gattCommunicationChannelService = m_control->createServiceObject(_gattCommunicationChannelServiceId);
@@ -325,18 +326,18 @@ void nautilustreadmill::serviceScanDone(void) {
 
 void nautilustreadmill::errorService(QLowEnergyService::ServiceError err) {
     QMetaEnum metaEnum = QMetaEnum::fromType<QLowEnergyService::ServiceError>();
-    emit debug(QStringLiteral("nautilustreadmill::errorService ") + QString::fromLocal8Bit(metaEnum.valueToKey(err)) +
+    LOG_DEVICE(QStringLiteral("nautilustreadmill::errorService ") + QString::fromLocal8Bit(metaEnum.valueToKey(err)) +
                m_control->errorString());
 }
 
 void nautilustreadmill::error(QLowEnergyController::Error err) {
     QMetaEnum metaEnum = QMetaEnum::fromType<QLowEnergyController::Error>();
-    emit debug(QStringLiteral("nautilustreadmill::error ") + QString::fromLocal8Bit(metaEnum.valueToKey(err)) +
+    LOG_DEVICE(QStringLiteral("nautilustreadmill::error ") + QString::fromLocal8Bit(metaEnum.valueToKey(err)) +
                m_control->errorString());
 }
 
 void nautilustreadmill::deviceDiscovered(const QBluetoothDeviceInfo &device) {
-    emit debug(QStringLiteral("Found new device: ") + device.name() + QStringLiteral(" (") +
+    LOG_DEVICE(QStringLiteral("Found new device: ") + device.name() + QStringLiteral(" (") +
                device.address().toString() + ')');
     {
         bluetoothDevice = device;
@@ -353,17 +354,17 @@ void nautilustreadmill::deviceDiscovered(const QBluetoothDeviceInfo &device) {
                 this, [this](QLowEnergyController::Error error) {
                     Q_UNUSED(error);
                     Q_UNUSED(this);
-                    emit debug(QStringLiteral("Cannot connect to remote device."));
+                    LOG_DEVICE(QStringLiteral("Cannot connect to remote device."));
                     emit disconnected();
                 });
         connect(m_control, &QLowEnergyController::connected, this, [this]() {
             Q_UNUSED(this);
-            emit debug(QStringLiteral("Controller connected. Search services..."));
+            LOG_DEVICE(QStringLiteral("Controller connected. Search services..."));
             m_control->discoverServices();
         });
         connect(m_control, &QLowEnergyController::disconnected, this, [this]() {
             Q_UNUSED(this);
-            emit debug(QStringLiteral("LowEnergy controller disconnected"));
+            LOG_DEVICE(QStringLiteral("LowEnergy controller disconnected"));
             emit disconnected();
         });
 
@@ -1,4 +1,5 @@
 #include "npecablebike.h"
+#include "logging.h"
 #include "ios/lockscreen.h"
 #include "virtualbike.h"
 #include <QBluetoothLocalDevice>
@@ -45,6 +46,7 @@ wait_for_response)
         timeout.singleShot(300, &loop, SLOT(quit()));
     }
 
+    writeRequested(QByteArray((const char *)data, data_len));
     gattCommunicationChannelService->writeCharacteristic(gattWriteCharacteristic, QByteArray((const char*)data,
 data_len));
 
@@ -84,13 +86,13 @@ void npecablebike::update() {
             }
 
             if (requestResistance != currentResistance().value()) {
-                emit debug(QStringLiteral("writing resistance ") + QString::number(requestResistance));
+                LOG_DEVICE(QStringLiteral("writing resistance ") + QString::number(requestResistance));
                 // forceResistance(requestResistance);
             }
             requestResistance = -1;
         }
         if (requestStart != -1) {
-            emit debug(QStringLiteral("starting..."));
+            LOG_DEVICE(QStringLiteral("starting..."));
 
             // btinit();
 
@@ -98,7 +100,7 @@ void npecablebike::update() {
             emit bikeStarted();
         }
         if (requestStop != -1) {
-            emit debug(QStringLiteral("stopping..."));
+            LOG_DEVICE(QStringLiteral("stopping..."));
             // writeCharacteristic(initDataF0C800B8, sizeof(initDataF0C800B8), "stop tape");
             requestStop = -1;
         }
@@ -106,7 +108,7 @@ void npecablebike::update() {
 }
 
 void npecablebike::serviceDiscovered(const QBluetoothUuid &gatt) {
-    emit debug(QStringLiteral("serviceDiscovered ") + gatt.toString());
+    LOG_DEVICE(QStringLiteral("serviceDiscovered ") + gatt.toString());
 }
 
 void npecablebike::characteristicChanged(const QLowEnergyCharacteristic &characteristic, const QByteArray &newValue) {
@@ -117,7 +119,7 @@ void npecablebike::characteristicChanged(const QLowEnergyCharacteristic &charact
         settings.value(QStringLiteral("heart_rate_belt_name"), QStringLiteral("Disabled")).toString();
 
     qDebug() << QStringLiteral(" << char ") << characteristic.uuid();
-    emit debug(QStringLiteral(" << ") + newValue.toHex(' '));
+    LOG_PACKET(QStringLiteral(" << ") + newValue.toHex(' '));
 
     if (characteristic.uuid() == QBluetoothUuid((quint16)0x2A5B)) {
         lastPacket = newValue;
@@ -125,15 +127,15 @@ void npecablebike::characteristicChanged(const QLowEnergyCharacteristic &charact
         uint8_t index = 1;
 
         if (newValue.at(0) == 0x02 && newValue.length() < 4) {
-            emit debug(QStringLiteral("Crank revolution data present with wrong bytes ") +
+            LOG_DEVICE(QStringLiteral("Crank revolution data present with wrong bytes ") +
                        QString::number(newValue.length()));
             return;
         } else if (newValue.at(0) == 0x01 && newValue.length() < 6) {
-            emit debug(QStringLiteral("Wheel revolution data present with wrong bytes ") +
+            LOG_DEVICE(QStringLiteral("Wheel revolution data present with wrong bytes ") +
                        QString::number(newValue.length()));
             return;
         } else if (newValue.at(0) == 0x00) {
-            emit debug(QStringLiteral("Cadence sensor notification without datas ") +
+            LOG_DEVICE(QStringLiteral("Cadence sensor notification without datas ") +
                        QString::number(newValue.length()));
             return;
         }
@@ -172,7 +174,7 @@ void npecablebike::characteristicChanged(const QLowEnergyCharacteristic &charact
             }
         }
 
-        emit debug(QStringLiteral("Current Cadence: ") + QString::number(Cadence.value()));
+        LOG_DEVICE(QStringLiteral("Current Cadence: ") + QString::number(Cadence.value()));
 
         oldLastCrankEventTime = LastCrankEventTime;
         oldCrankRevs = CrankRevs;
@@ -182,11 +184,11 @@ void npecablebike::characteristicChanged(const QLowEnergyCharacteristic &charact
         } else {
             Speed = metric::calculateSpeedFromPower(m_watt.value());
         }
-        emit debug(QStringLiteral("Current Speed: ") + QString::number(Speed.value()));
+        LOG_DEVICE(QStringLiteral("Current Speed: ") + QString::number(Speed.value()));
 
         Distance += ((Speed.value() / 3600000.0) *
                      ((double)lastRefreshCharacteristicChanged.msecsTo(QDateTime::currentDateTime())));
-        emit debug(QStringLiteral("Current Distance: ") + QString::number(Distance.value()));
+        LOG_DEVICE(QStringLiteral("Current Distance: ") + QString::number(Distance.value()));
 
         // Resistance = ((double)(((uint16_t)((uint8_t)newValue.at(index + 1)) << 8) |
         // (uint16_t)((uint8_t)newValue.at(index)))); debug("Current Resistance: " +
@@ -201,19 +203,19 @@ void npecablebike::characteristicChanged(const QLowEnergyCharacteristic &charact
                  (60000.0 / ((double)lastRefreshCharacteristicChanged.msecsTo(
                                 QDateTime::currentDateTime())))); //(( (0.048* Output in watts +1.19) * body weight in
                                                                   // kg * 3.5) / 200 ) / 60
-        emit debug(QStringLiteral("Current KCal: ") + QString::number(KCal.value()));
+        LOG_DEVICE(QStringLiteral("Current KCal: ") + QString::number(KCal.value()));
     } else if (characteristic.uuid() == QBluetoothUuid::HeartRateMeasurement) {
         if (newValue.length() > 1) {
             Heart = newValue[1];
         }
 
-        emit debug(QStringLiteral("Current heart: ") + QString::number(Heart.value()));
+        LOG_DEVICE(QStringLiteral("Current heart: ") + QString::number(Heart.value()));
     } else if (characteristic.uuid() == QBluetoothUuid::CyclingPowerMeasurement) {
         if (newValue.length() > 3) {
             m_watt = (((uint16_t)((uint8_t)newValue.at(3)) << 8) | (uint16_t)((uint8_t)newValue.at(2)));
         }
 
-        emit debug(QStringLiteral("Current watt: ") + QString::number(m_watt.value()));
+        LOG_DEVICE(QStringLiteral("Current watt: ") + QString::number(m_watt.value()));
     }
 
 #ifdef Q_OS_ANDROID
@@ -253,8 +255,8 @@ void npecablebike::characteristicChanged(const QLowEnergyCharacteristic &charact
 #endif
 #endif
 
-    emit debug(QStringLiteral("Current CrankRevs: ") + QString::number(CrankRevs));
-    emit debug(QStringLiteral("Last CrankEventTime: ") + QString::number(LastCrankEventTime));
+    LOG_DEVICE(QStringLiteral("Current CrankRevs: ") + QString::number(CrankRevs));
+    LOG_DEVICE(QStringLiteral("Last CrankEventTime: ") + QString::number(LastCrankEventTime));
 
     if (m_control->error() != QLowEnergyController::NoError) {
         qDebug() << QStringLiteral("QLowEnergyController ERROR!!") << m_control->errorString();
@@ -263,7 +265,7 @@ void npecablebike::characteristicChanged(const QLowEnergyCharacteristic &charact
 
 void npecablebike::stateChanged(QLowEnergyService::ServiceState state) {
     QMetaEnum metaEnum = QMetaEnum::fromType<QLowEnergyService::ServiceState>();
-    emit debug(QStringLiteral("BTLE stateChanged ") + QString::fromLocal8Bit(metaEnum.valueToKey(state)));
+    LOG_DEVICE(QStringLiteral("BTLE stateChanged ") + QString::fromLocal8Bit(metaEnum.valueToKey(state)));
 
     for (QLowEnergyService *s : qAsConst(gattCommunicationChannelService)) {
         qDebug() << QStringLiteral("stateChanged") << s->serviceUuid() << s->state();
@@ -357,7 +359,7 @@ void npecablebike::stateChanged(QLowEnergyService::ServiceState state) {
 #endif
 #endif
             if (virtual_device_enabled) {
-            emit debug(QStringLiteral("creating virtual bike interface..."));
+            LOG_DEVICE(QStringLiteral("creating virtual bike interface..."));
             virtualBike = new virtualbike(this, noWriteResistance, noHeartService);
             // connect(virtualBike,&virtualbike::debug ,this,&npecablebike::debug);
             connect(virtualBike, &virtualbike::changeInclination, this, &npecablebike::changeInclination);
@@ -368,7 +370,7 @@ void npecablebike::stateChanged(QLowEnergyService::ServiceState state) {
 }
 
 void npecablebike::descriptorWritten(const QLowEnergyDescriptor &descriptor, const QByteArray &newValue) {
-    emit debug(QStringLiteral("descriptorWritten ") + descriptor.name() + " " + newValue.toHex(' '));
+    LOG_PACKET(QStringLiteral("descriptorWritten ") + descriptor.name() + " " + newValue.toHex(' '));
 
     initRequest = true;
     emit connectedAndDiscovered();
@@ -380,7 +382,7 @@ void npecablebike::descriptorRead(const QLowEnergyDescriptor &descriptor, const
 
 void npecablebike::characteristicWritten(const QLowEnergyCharacteristic &characteristic, const QByteArray &newValue) {
     Q_UNUSED(characteristic);
-    emit debug(QStringLiteral("characteristicWritten ") + newValue.toHex(' '));
+    LOG_PACKET(QStringLiteral("characteristicWritten ") + newValue.toHex(' '));
 }
 
 void npecablebike::characteristicRead(const QLowEnergyCharacteristic &characteristic, const QByteArray &newValue) {
@@ -388,7 +390,7 @@ void npecablebike::characteristicRead(const QLowEnergyCharacteristic &characteri
 }
 
 void npecablebike::serviceScanDone(void) {
-    emit debug(QStringLiteral("serviceScanDone"));
+    LOG_DEVICE(QStringLiteral("serviceScanDone"));
 
 #ifdef Q_OS_ANDROID
     QLowEnergyConnectionParameters c;
@@ -410,18 +412,18 @@ void npecablebike::serviceScanDone(void) {
 
 void npecablebike::errorService(QLowEnergyService::ServiceError err) {
     QMetaEnum metaEnum = QMetaEnum::fromType<QLowEnergyService::ServiceError>();
-    emit debug(QStringLiteral("npecablebike::errorService") + QString::fromLocal8Bit(metaEnum.valueToKey(err)) +
+    LOG_DEVICE(QStringLiteral("npecablebike::errorService") + QString::fromLocal8Bit(metaEnum.valueToKey(err)) +
                m_control->errorString());
 }
 
 void npecablebike::error(QLowEnergyController::Error err) {
     QMetaEnum metaEnum = QMetaEnum::fromType<QLowEnergyController::Error>();
-    emit debug(QStringLiteral("npecablebike::error") + QString::fromLocal8Bit(metaEnum.valueToKey(err)) +
+    LOG_DEVICE(QStringLiteral("npecablebike::error") + QString::fromLocal8Bit(metaEnum.valueToKey(err)) +
                m_control->errorString());
 }
 
 void npecablebike::deviceDiscovered(const QBluetoothDeviceInfo &device) {
-    emit debug(QStringLiteral("Found new device: ") + device.name() + QStringLiteral(" (") +
+    LOG_DEVICE(QStringLiteral("Found new device: ") + device.name() + QStringLiteral(" (") +
                device.address().toString() + ')');
     {
         bluetoothDevice = device;
@@ -439,17 +441,17 @@ void npecablebike::deviceDiscovered(const QBluetoothDeviceInfo &device) {
                 this, [this](QLowEnergyController::Error error) {
                     Q_UNUSED(error);
                     Q_UNUSED(this);
-                    emit debug(QStringLiteral("Cannot connect to remote device."));
+                    LOG_DEVICE(QStringLiteral("Cannot connect to remote device."));
                     emit disconnected();
                 });
         connect(m_control, &QLowEnergyController::connected, this, [this]() {
             Q_UNUSED(this);
-            emit debug(QStringLiteral("Controller connected. Search services..."));
+            LOG_DEVICE(QStringLiteral("Controller connected. Search services..."));
             m_control->discoverServices();
         });
         connect(m_control, &QLowEnergyController::disconnected, this, [this]() {
             Q_UNUSED(this);
-            emit debug(QStringLiteral("LowEnergy controller disconnected"));
+            LOG_DEVICE(QStringLiteral("LowEnergy controller disconnected"));
             emit disconnected();
         });
 
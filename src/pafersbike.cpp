@@ -59,6 +59,7 @@ void pafersbike::writeCharacteristic(uint8_t *data, uint8_t data_len, const QStr
         return;
     }
 
+    writeRequested(QByteArray((const char *)data, data_len));
     gattCommunicationChannelService->writeCharacteristic(gattWriteCharacteristic,
                                                          QByteArray((const char *)data, data_len));
 
@@ -113,6 +114,7 @@ void pafersbike::update() {
 
             if (requestResistance != currentResistance().value()) {
                 qDebug() << QStringLiteral("writing resistance ") + QString::number(requestResistance);
+                requestQueued();
                 forceResistance(requestResistance);
             }
             requestResistance = -1;
@@ -1,4 +1,5 @@
 #include "proformbike.h"
+#include "logging.h"
 #include "ios/lockscreen.h"
 #include "keepawakehelper.h"
 #include "virtualbike.h"
@@ -39,11 +40,12 @@ void proformbike::writeCharacteristic(uint8_t *data, uint8_t data_len, const QSt
         timeout.singleShot(300ms, &loop, &QEventLoop::quit);
     }
 
+    writeRequested(QByteArray((const char *)data, data_len));
     gattCommunicationChannelService->writeCharacteristic(gattWriteCharacteristic,
                                                          QByteArray((const char *)data, data_len));
 
     if (!disable_log) {
-        emit debug(QStringLiteral(" >> ") + QByteArray((const char *)data, data_len).toHex(' ') +
+        LOG_PACKET(QStringLiteral(" >> ") + QByteArray((const char *)data, data_len).toHex(' ') +
                    QStringLiteral(" // ") + info);
     }
 
@@ -274,7 +276,8 @@ void proformbike::innerWriteResistance() {
         }
 
         if (requestResistance != currentResistance().value()) {
-            emit debug(QStringLiteral("writing resistance ") + QString::number(requestResistance));
+            LOG_DEVICE(QStringLiteral("writing resistance ") + QString::number(requestResistance));
+            requestQueued();
             forceResistance(requestResistance);
         }
         requestResistance = -1;
@@ -385,8 +388,9 @@ void proformbike::update() {
                 // only 0.5 steps ara avaiable
                 double inc = qRound(requestInclination * 2.0) / 2.0;
                 if (inc != currentInclination().value()) {
-                    emit debug(QStringLiteral("writing inclination ") + QString::number(requestInclination) +
+                    LOG_DEVICE(QStringLiteral("writing inclination ") + QString::number(requestInclination) +
                                " rounded " + QString::number(inc));
+                    requestQueued();
                     forceIncline(inc);
                 }
                 requestInclination = -1;
@@ -409,7 +413,7 @@ void proformbike::update() {
         }
 
         if (requestStart != -1) {
-            emit debug(QStringLiteral("starting..."));
+            LOG_DEVICE(QStringLiteral("starting..."));
 
             // btinit();
 
@@ -417,7 +421,7 @@ void proformbike::update() {
             emit bikeStarted();
         }
         if (requestStop != -1) {
-            emit debug(QStringLiteral("stopping..."));
+            LOG_DEVICE(QStringLiteral("stopping..."));
             // writeCharacteristic(initDataF0C800B8, sizeof(initDataF0C800B8), "stop tape");
             requestStop = -1;
         }
@@ -477,7 +481,7 @@ int proformbike::pelotonToBikeResistance(int pelotonResistance) {
 }
 
 void proformbike::serviceDiscovered(const QBluetoothUuid &gatt) {
-    emit debug(QStringLiteral("serviceDiscovered ") + gatt.toString());
+    LOG_DEVICE(QStringLiteral("serviceDiscovered ") + gatt.toString());
 }
 
 void proformbike::characteristicChanged(const QLowEnergyCharacteristic &characteristic, const QByteArray &newValue) {
@@ -489,7 +493,7 @@ void proformbike::characteristicChanged(const QLowEnergyCharacteristic &characte
     bool proform_studio = settings.value(QStringLiteral("proform_studio"), false).toBool();
     bool proform_tdf_jonseed_watt = settings.value(QStringLiteral("proform_tdf_jonseed_watt"), false).toBool();
 
-    emit debug(QStringLiteral(" << ") + newValue.toHex(' '));
+    LOG_PACKET(QStringLiteral(" << ") + newValue.toHex(' '));
 
     lastPacket = newValue;
 
@@ -516,9 +520,9 @@ void proformbike::characteristicChanged(const QLowEnergyCharacteristic &characte
 
             if ((uint16_t)(qAbs(incline) * 10) % 5 == 0) {
                 Inclination = incline;
-                emit debug(QStringLiteral("Current Inclination: ") + QString::number(incline));
+                LOG_DEVICE(QStringLiteral("Current Inclination: ") + QString::number(incline));
             } else {
-                emit debug(QStringLiteral("Filtering bad inclination"));
+                LOG_DEVICE(QStringLiteral("Filtering bad inclination"));
             }
         } else {
 
@@ -691,14 +695,14 @@ void proformbike::characteristicChanged(const QLowEnergyCharacteristic &characte
 #endif
 #endif
 
-    emit debug(QStringLiteral("Current Resistance: ") + QString::number(Resistance.value()));
-    emit debug(QStringLiteral("Current Speed: ") + QString::number(Speed.value()));
-    emit debug(QStringLiteral("Current Calculate Distance: ") + QString::number(Distance.value()));
-    emit debug(QStringLiteral("Current Cadence: ") + QString::number(Cadence.value()));
+    LOG_DEVICE(QStringLiteral("Current Resistance: ") + QString::number(Resistance.value()));
+    LOG_DEVICE(QStringLiteral("Current Speed: ") + QString::number(Speed.value()));
+    LOG_DEVICE(QStringLiteral("Current Calculate Distance: ") + QString::number(Distance.value()));
+    LOG_DEVICE(QStringLiteral("Current Cadence: ") + QString::number(Cadence.value()));
     // debug("Current Distance: " + QString::number(distance));
-    emit debug(QStringLiteral("Current CrankRevs: ") + QString::number(CrankRevs));
-    emit debug(QStringLiteral("Last CrankEventTime: ") + QString::number(LastCrankEventTime));
-    emit debug(QStringLiteral("Current Watt: ") + QString::number(watts()));
+    LOG_DEVICE(QStringLiteral("Current CrankRevs: ") + QString::number(CrankRevs));
+    LOG_DEVICE(QStringLiteral("Last CrankEventTime: ") + QString::number(LastCrankEventTime));
+    LOG_DEVICE(QStringLiteral("Current Watt: ") + QString::number(watts()));
 
     if (m_control->error() != QLowEnergyController::NoError) {
         qDebug() << QStringLiteral("QLowEnergyController ERROR!!") << m_control->errorString();
@@ -857,7 +861,7 @@ void proformbike::stateChanged(QLowEnergyService::ServiceState state) {
     QBluetoothUuid _gattNotify1CharacteristicId(QStringLiteral("00001535-1412-efde-1523-785feabcd123"));
 
     QMetaEnum metaEnum = QMetaEnum::fromType<QLowEnergyService::ServiceState>();
-    emit debug(QStringLiteral("BTLE stateChanged ") + QString::fromLocal8Bit(metaEnum.valueToKey(state)));
+    LOG_DEVICE(QStringLiteral("BTLE stateChanged ") + QString::fromLocal8Bit(metaEnum.valueToKey(state)));
 
     if (state == QLowEnergyService::ServiceDiscovered) {
         // qDebug() << gattCommunicationChannelService->characteristics();
@@ -900,7 +904,7 @@ void proformbike::stateChanged(QLowEnergyService::ServiceState state) {
 #endif
 #endif
                 if (virtual_device_enabled) {
-                emit debug(QStringLiteral("creating virtual bike interface..."));
+                LOG_DEVICE(QStringLiteral("creating virtual bike interface..."));
                 virtualBike =
                     new virtualbike(this, noWriteResistance, noHeartService, bikeResistanceOffset, bikeResistanceGain);
                 // connect(virtualBike,&virtualbike::debug ,this,&proformbike::debug);
@@ -919,7 +923,7 @@ void proformbike::stateChanged(QLowEnergyService::ServiceState state) {
 }
 
 void proformbike::descriptorWritten(const QLowEnergyDescriptor &descriptor, const QByteArray &newValue) {
-    emit debug(QStringLiteral("descriptorWritten ") + descriptor.name() + " " + newValue.toHex(' '));
+    LOG_PACKET(QStringLiteral("descriptorWritten ") + descriptor.name() + " " + newValue.toHex(' '));
 
     initRequest = true;
     emit connectedAndDiscovered();
@@ -927,11 +931,11 @@ void proformbike::descriptorWritten(const QLowEnergyDescriptor &descriptor, cons
 
 void proformbike::characteristicWritten(const QLowEnergyCharacteristic &characteristic, const QByteArray &newValue) {
     Q_UNUSED(characteristic);
-    emit debug(QStringLiteral("characteristicWritten ") + newValue.toHex(' '));
+    LOG_PACKET(QStringLiteral("characteristicWritten ") + newValue.toHex(' '));
 }
 
 void proformbike::serviceScanDone(void) {
-    emit debug(QStringLiteral("serviceScanDone"));
+    LOG_DEVICE(QStringLiteral("serviceScanDone"));
 
     QBluetoothUuid _gattCommunicationChannelServiceId(QStringLiteral("00001533-1412-efde-1523-785feabcd123"));
 
@@ -942,18 +946,18 @@ void proformbike::serviceScanDone(void) {
 
 void proformbike::errorService(QLowEnergyService::ServiceError err) {
     QMetaEnum metaEnum = QMetaEnum::fromType<QLowEnergyService::ServiceError>();
-    emit debug(QStringLiteral("proformbike::errorService") + QString::fromLocal8Bit(metaEnum.valueToKey(err)) +
+    LOG_DEVICE(QStringLiteral("proformbike::errorService") + QString::fromLocal8Bit(metaEnum.valueToKey(err)) +
                m_control->errorString());
 }
 
 void proformbike::error(QLowEnergyController::Error err) {
     QMetaEnum metaEnum = QMetaEnum::fromType<QLowEnergyController::Error>();
-    emit debug(QStringLiteral("proformbike::error") + QString::fromLocal8Bit(metaEnum.valueToKey(err)) +
+    LOG_DEVICE(QStringLiteral("proformbike::error") + QString::fromLocal8Bit(metaEnum.valueToKey(err)) +
                m_control->errorString());
 }
 
 void proformbike::deviceDiscovered(const QBluetoothDeviceInfo &device) {
-    emit debug(QStringLiteral("Found new device: ") + device.name() + " (" + device.address().toString() + ')');
+    LOG_DEVICE(QStringLiteral("Found new device: ") + device.name() + " (" + device.address().toString() + ')');
     // if (device.name().startsWith(QStringLiteral("I_EB")))
     {
         bluetoothDevice = device;
@@ -971,17 +975,17 @@ void proformbike::deviceDiscovered(const QBluetoothDeviceInfo &device) {
                 this, [this](QLowEnergyController::Error error) {
                     Q_UNUSED(error);
                     Q_UNUSED(this);
-                    emit debug(QStringLiteral("Cannot connect to remote device."));
+                    LOG_DEVICE(QStringLiteral("Cannot connect to remote device."));
                     emit disconnected();
                 });
         connect(m_control, &QLowEnergyController::connected, this, [this]() {
             Q_UNUSED(this);
-            emit debug(QStringLiteral("Controller connected. Search services..."));
+            LOG_DEVICE(QStringLiteral("Controller connected. Search services..."));
             m_control->discoverServices();
         });
         connect(m_control, &QLowEnergyController::disconnected, this, [this]() {
             Q_UNUSED(this);
-            emit debug(QStringLiteral("LowEnergy controller disconnected"));
+            LOG_DEVICE(QStringLiteral("LowEnergy controller disconnected"));
             emit disconnected();
         });
 
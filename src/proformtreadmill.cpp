@@ -1,4 +1,5 @@
 #include "proformtreadmill.h"
+#include "logging.h"
 #include "ios/lockscreen.h"
 #include "keepawakehelper.h"
 #include "virtualtreadmill.h"
@@ -40,7 +41,7 @@ void proformtreadmill::writeCharacteristic(uint8_t *data, uint8_t data_len, cons
                                                          QByteArray((const char *)data, data_len));
 
     if (!disable_log) {
-        emit debug(QStringLiteral(" >> ") + QByteArray((const char *)data, data_len).toHex(' ') +
+        LOG_PACKET(QStringLiteral(" >> ") + QByteArray((const char *)data, data_len).toHex(' ') +
                    QStringLiteral(" // ") + info);
     }
 
@@ -118,14 +119,14 @@ void proformtreadmill::update() {
                 if (requestInclination != -1) {
                     if (requestInclination != currentInclination().value() && requestInclination >= 0 &&
                         requestInclination <= 15) {
-                        emit debug(QStringLiteral("writing incline ") + QString::number(requestInclination));
+                        LOG_DEVICE(QStringLiteral("writing incline ") + QString::number(requestInclination));
                         forceIncline(requestInclination);
                     }
                     requestInclination = -1;
                 }
                 if (requestSpeed != -1) {
                     if (requestSpeed != currentSpeed().value() && requestSpeed >= 0 && requestSpeed <= 22) {
-                        emit debug(QStringLiteral("writing speed ") + QString::number(requestSpeed));
+                        LOG_DEVICE(QStringLiteral("writing speed ") + QString::number(requestSpeed));
                         forceSpeed(requestSpeed);
                     }
                     requestSpeed = -1;
@@ -165,14 +166,14 @@ void proformtreadmill::update() {
                 if (requestInclination != -1) {
                     if (requestInclination != currentInclination().value() && requestInclination >= 0 &&
                         requestInclination <= 15) {
-                        emit debug(QStringLiteral("writing incline ") + QString::number(requestInclination));
+                        LOG_DEVICE(QStringLiteral("writing incline ") + QString::number(requestInclination));
                         forceIncline(requestInclination);
                     }
                     requestInclination = -1;
                 }
                 if (requestSpeed != -1) {
                     if (requestSpeed != currentSpeed().value() && requestSpeed >= 0 && requestSpeed <= 22) {
-                        emit debug(QStringLiteral("writing speed ") + QString::number(requestSpeed));
+                        LOG_DEVICE(QStringLiteral("writing speed ") + QString::number(requestSpeed));
                         forceSpeed(requestSpeed);
                     }
                     requestSpeed = -1;
@@ -239,7 +240,7 @@ void proformtreadmill::update() {
         }
 
         if (requestStart != -1) {
-            emit debug(QStringLiteral("starting..."));
+            LOG_DEVICE(QStringLiteral("starting..."));
 
             // btinit();
 
@@ -247,7 +248,7 @@ void proformtreadmill::update() {
             emit tapeStarted();
         }
         if (requestStop != -1) {
-            emit debug(QStringLiteral("stopping..."));
+            LOG_DEVICE(QStringLiteral("stopping..."));
             // writeCharacteristic(initDataF0C800B8, sizeof(initDataF0C800B8), "stop tape");
             requestStop = -1;
         }
@@ -261,7 +262,7 @@ void proformtreadmill::changeInclinationRequested(double grade, double percentag
 }
 
 void proformtreadmill::serviceDiscovered(const QBluetoothUuid &gatt) {
-    emit debug(QStringLiteral("serviceDiscovered ") + gatt.toString());
+    LOG_DEVICE(QStringLiteral("serviceDiscovered ") + gatt.toString());
 }
 
 void proformtreadmill::characteristicChanged(const QLowEnergyCharacteristic &characteristic,
@@ -274,7 +275,7 @@ void proformtreadmill::characteristicChanged(const QLowEnergyCharacteristic &cha
     bool nordictrack10 = settings.value("nordictrack_10_treadmill", false).toBool();
     double weight = settings.value(QStringLiteral("weight"), 75.0).toFloat();
 
-    emit debug(QStringLiteral(" << ") + newValue.toHex(' '));
+    LOG_PACKET(QStringLiteral(" << ") + newValue.toHex(' '));
 
     lastPacket = newValue;
 
@@ -328,11 +329,11 @@ void proformtreadmill::characteristicChanged(const QLowEnergyCharacteristic &cha
             }
         }
 
-        emit debug(QStringLiteral("Current Inclination: ") + QString::number(Inclination.value()));
-        emit debug(QStringLiteral("Current Speed: ") + QString::number(Speed.value()));
-        emit debug(QStringLiteral("Current Calculate Distance: ") + QString::number(Distance.value()));
+        LOG_DEVICE(QStringLiteral("Current Inclination: ") + QString::number(Inclination.value()));
+        LOG_DEVICE(QStringLiteral("Current Speed: ") + QString::number(Speed.value()));
+        LOG_DEVICE(QStringLiteral("Current Calculate Distance: ") + QString::number(Distance.value()));
         // debug("Current Distance: " + QString::number(distance));
-        emit debug(QStringLiteral("Current Watt: ") + QString::number(watts(weight)));
+        LOG_DEVICE(QStringLiteral("Current Watt: ") + QString::number(watts(weight)));
 
         if (m_control->error() != QLowEnergyController::NoError) {
             qDebug() << QStringLiteral("QLowEnergyController ERROR!!") << m_control->errorString();
@@ -564,7 +565,7 @@ void proformtreadmill::stateChanged(QLowEnergyService::ServiceState state) {
     QBluetoothUuid _gattNotify1CharacteristicId(QStringLiteral("00001535-1412-efde-1523-785feabcd123"));
 
     QMetaEnum metaEnum = QMetaEnum::fromType<QLowEnergyService::ServiceState>();
-    emit debug(QStringLiteral("BTLE stateChanged ") + QString::fromLocal8Bit(metaEnum.valueToKey(state)));
+    LOG_DEVICE(QStringLiteral("BTLE stateChanged ") + QString::fromLocal8Bit(metaEnum.valueToKey(state)));
 
     if (state == QLowEnergyService::ServiceDiscovered) {
         // qDebug() << gattCommunicationChannelService->characteristics();
@@ -617,7 +618,7 @@ void proformtreadmill::stateChanged(QLowEnergyService::ServiceState state) {
 }
 
 void proformtreadmill::descriptorWritten(const QLowEnergyDescriptor &descriptor, const QByteArray &newValue) {
-    emit debug(QStringLiteral("descriptorWritten ") + descriptor.name() + QStringLiteral(" ") + newValue.toHex(' '));
+    LOG_PACKET(QStringLiteral("descriptorWritten ") + descriptor.name() + QStringLiteral(" ") + newValue.toHex(' '));
 
     initRequest = true;
     emit connectedAndDiscovered();
@@ -626,11 +627,11 @@ void proformtreadmill::descriptorWritten(const QLowEnergyDescriptor &descriptor,
 void proformtreadmill::characteristicWritten(const QLowEnergyCharacteristic &characteristic,
                                              const QByteArray &newValue) {
     Q_UNUSED(characteristic);
-    emit debug(QStringLiteral("characteristicWritten ") + newValue.toHex(' '));
+    LOG_PACKET(QStringLiteral("characteristicWritten ") + newValue.toHex(' '));
 }
 
 void proformtreadmill::serviceScanDone(void) {
-    emit debug(QStringLiteral("serviceScanDone"));
+    LOG_DEVICE(QStringLiteral("serviceScanDone"));
 
     QBluetoothUuid _gattCommunicationChannelServiceId(QStringLiteral("00001533-1412-efde-1523-785feabcd123"));
 
@@ -641,18 +642,18 @@ void proformtreadmill::serviceScanDone(void) {
 
 void proformtreadmill::errorService(QLowEnergyService::ServiceError err) {
     QMetaEnum metaEnum = QMetaEnum::fromType<QLowEnergyService::ServiceError>();
-    emit debug(QStringLiteral("proformtreadmill::errorService") + QString::fromLocal8Bit(metaEnum.valueToKey(err)) +
+    LOG_DEVICE(QStringLiteral("proformtreadmill::errorService") + QString::fromLocal8Bit(metaEnum.valueToKey(err)) +
                m_control->errorString());
 }
 
 void proformtreadmill::error(QLowEnergyController::Error err) {
     QMetaEnum metaEnum = QMetaEnum::fromType<QLowEnergyController::Error>();
-    emit debug(QStringLiteral("proformtreadmill::error") + QString::fromLocal8Bit(metaEnum.valueToKey(err)) +
+    LOG_DEVICE(QStringLiteral("proformtreadmill::error") + QString::fromLocal8Bit(metaEnum.valueToKey(err)) +
                m_control->errorString());
 }
 
 void proformtreadmill::deviceDiscovered(const QBluetoothDeviceInfo &device) {
-    emit debug(QStringLiteral("Found new device: ") + device.name() + " (" + device.address().toString() + ')');
+    LOG_DEVICE(QStringLiteral("Found new device: ") + device.name() + " (" + device.address().toString() + ')');
     if (device.name().startsWith(QStringLiteral("I_TL"))) {
         bluetoothDevice = device;
 
@@ -669,17 +670,17 @@ void proformtreadmill::deviceDiscovered(const QBluetoothDeviceInfo &device) {
                 this, [this](QLowEnergyController::Error error) {
                     Q_UNUSED(error);
                     Q_UNUSED(this);
-                    emit debug(QStringLiteral("Cannot connect to remote device."));
+                    LOG_DEVICE(QStringLiteral("Cannot connect to remote device."));
                     emit disconnected();
                 });
         connect(m_control, &QLowEnergyController::connected, this, [this]() {
             Q_UNUSED(this);
-            emit debug(QStringLiteral("Controller connected. Search services..."));
+            LOG_DEVICE(QStringLiteral("Controller connected. Search services..."));
             m_control->discoverServices();
         });
         connect(m_control, &QLowEnergyController::disconnected, this, [this]() {
             Q_UNUSED(this);
-            emit debug(QStringLiteral("LowEnergy controller disconnected"));
+            LOG_DEVICE(QStringLiteral("LowEnergy controller disconnected"));
             emit disconnected();
         });
 
@@ -36,6 +36,9 @@ macx: CONFIG += static
 # deprecated API in order to know how to port your code away from it.
 DEFINES += QT_DEPRECATED_WARNINGS IO_UNDER_QT SMTP_BUILD
 
+# qmake CONFIG+=qz_no_traces strips the traces of the drivers (LOG_DEVICE/LOG_PACKET, see logging.h)
+qz_no_traces: DEFINES += QZ_NO_TRACES
+
 
 # You can also make your code fail to compile if it uses deprecated APIs.
 # In order to do so, uncomment the following line.
@@ -49,10 +52,18 @@ SOURCES += \
    bike.cpp \
 	     bluetooth.cpp \
 		bluetoothdevice.cpp \
+    bluetoothtransport.cpp \
+    bletransport.cpp \
+    bluetoothwatchdog.cpp \
     bowflextreadmill.cpp \
+    capturefile.cpp \
+    capturetransport.cpp \
    chronobike.cpp \
     concept2skierg.cpp \
+    controllatency.cpp \
    cscbike.cpp \
+   cscdecoder.cpp \
+    dirconserver.cpp \
 	 domyoselliptical.cpp \
    domyosrower.cpp \
 	     domyostreadmill.cpp \
@@ -92,8 +103,12 @@ SOURCES += \
 	fit-sdk/fit_protocol_validator.cpp \
 	fit-sdk/fit_unicode.cpp \
 	flywheelbike.cpp \
+    framing.cpp \
 	ftmsbike.cpp \
+    ftmsparser.cpp \
     ftmsrower.cpp \
+    gatewaytransport.cpp \
+    gzip.cpp \
 	     gpx.cpp \
 		heartratebelt.cpp \
    homefitnessbuddy.cpp \
@@ -105,6 +120,8 @@ SOURCES += \
 	keepawakehelper.cpp \
    kingsmithr1protreadmill.cpp \
    kingsmithr2treadmill.cpp \
+    logging.cpp \
+    logwriter.cpp \
 	     main.cpp \
    mcfbike.cpp \
 		metric.cpp \
@@ -118,15 +135,19 @@ SOURCES += \
 	proformtreadmill.cpp \
 	qfit.cpp \
    renphobike.cpp \
+    replaytransport.cpp \
    rower.cpp \
 	schwinnic4bike.cpp \
    screencapture.cpp \
+	sensorfusion.cpp \
 	sessionline.cpp \
+    settingsmirror.cpp \
    shuaa5treadmill.cpp \
 	signalhandler.cpp \
     skandikawiribike.cpp \
    smartrowrower.cpp \
    smartspin2k.cpp \
+   statepublisher.cpp \
     smtpclient/src/emailaddress.cpp \
     smtpclient/src/mimeattachment.cpp \
     smtpclient/src/mimecontentformatter.cpp \
@@ -181,10 +202,18 @@ HEADERS += \
    bike.h \
 	bluetooth.h \
 	bluetoothdevice.h \
+    bluetoothtransport.h \
+    bletransport.h \
+    bluetoothwatchdog.h \
     bowflextreadmill.h \
+    capturefile.h \
+    capturetransport.h \
    chronobike.h \
     concept2skierg.h \
+    controllatency.h \
    cscbike.h \
+   cscdecoder.h \
+    dirconserver.h \
 	 domyoselliptical.h \
    domyosrower.h \
 	domyostreadmill.h \
@@ -198,12 +227,17 @@ HEADERS += \
     fakebike.h \
     fitmetria_fanfit.h \
    fitplusbike.h \
+    ftmsparser.h \
     ftmsrower.h \
+    gatewaytransport.h \
+    gzip.h \
    homefitnessbuddy.h \
     horizongr7bike.h \
    iconceptbike.h \
    kingsmithr1protreadmill.h \
    kingsmithr2treadmill.h \
+    logging.h \
+    logwriter.h \
    m3ibike.h \
         fitshowtreadmill.h \
 	fit-sdk/FitDecode.h \
@@ -424,6 +458,7 @@ HEADERS += \
 	fit-sdk/fit_zones_target_mesg.hpp \
 	fit-sdk/fit_zones_target_mesg_listener.hpp \
 	flywheelbike.h \
+    framing.h \
 	ftmsbike.h \
 	 heartratebelt.h \
 	homeform.h \
@@ -447,15 +482,19 @@ HEADERS += \
     qdebugfixup.h \
 	qfit.h \
    renphobike.h \
+    replaytransport.h \
    rower.h \
 	schwinnic4bike.h \
    screencapture.h \
+	sensorfusion.h \
 	sessionline.h \
+    settingsmirror.h \
    shuaa5treadmill.h \
 	signalhandler.h \
     skandikawiribike.h \
    smartrowrower.h \
    smartspin2k.h \
+   statepublisher.h \
     smtpclient/src/SmtpMime \
     smtpclient/src/emailaddress.h \
     smtpclient/src/mimeattachment.h \
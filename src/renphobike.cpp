@@ -1,4 +1,5 @@
 #include "renphobike.h"
+#include "ftmsparser.h"
 #include "ios/lockscreen.h"
 #include "virtualbike.h"
 #include <QBluetoothLocalDevice>
@@ -41,6 +42,7 @@ void renphobike::writeCharacteristic(uint8_t *data, uint8_t data_len, QString in
         timeout.singleShot(300, &loop, SLOT(quit()));
     }
 
+    writeRequested(QByteArray((const char *)data, data_len));
     gattFTMSService->writeCharacteristic(gattWriteCharControlPointId, QByteArray((const char *)data, data_len));
 
     if (!disable_log)
@@ -88,8 +90,10 @@ void renphobike::update() {
             debug("writing power request " + QString::number(requestPower));
             // if zwift is connected, QZ routes the ftms packets directly to the bike.
             // if peloton is connected, the power request is handled by QZ
-            if (virtualBike && !virtualBike->ftmsDeviceConnected() && requestPower != 0)
+            if (virtualBike && !virtualBike->ftmsDeviceConnected() && requestPower != 0) {
+                requestQueued();
                 forcePower(requestPower);
+            }
             requestPower = -1;
             requestResistance = -1;
         }
@@ -101,6 +105,7 @@ void renphobike::update() {
 
             if (requestResistance != currentResistance().value()) {
                 debug("writing resistance " + QString::number(requestResistance));
+                requestQueued();
                 forceResistance(requestResistance);
             }
             requestResistance = -1;
@@ -131,81 +136,30 @@ void renphobike::characteristicChanged(const QLowEnergyCharacteristic &character
 
     debug(" << " + newValue.toHex(' '));
 
-    if (characteristic.uuid() != QBluetoothUuid((quint16)0x2AD2))
+    ftmsparser::data d;
+    if (characteristic.uuid() != QBluetoothUuid((quint16)ftmsparser::INDOOR_BIKE_DATA))
         return;
+    if (!ftmsparser::parse(ftmsparser::INDOOR_BIKE_DATA, newValue.constData(), newValue.length(), d))
+        debug("truncated indoor bike data");
 
     lastPacket = newValue;
 
-    union flags {
-        struct {
-            uint16_t moreData : 1;
-            uint16_t avgSpeed : 1;
-            uint16_t instantCadence : 1;
-            uint16_t avgCadence : 1;
-            uint16_t totDistance : 1;
-            uint16_t resistanceLvl : 1;
-            uint16_t instantPower : 1;
-            uint16_t avgPower : 1;
-            uint16_t expEnergy : 1;
-            uint16_t heartRate : 1;
-            uint16_t metabolic : 1;
-            uint16_t elapsedTime : 1;
-            uint16_t remainingTime : 1;
-            uint16_t spare : 3;
-        };
-
-        uint16_t word_flags;
-    };
-
-    flags Flags;
-    int index = 0;
-    Flags.word_flags = (newValue.at(1) << 8) | newValue.at(0);
-    index += 2;
-
-    if (!Flags.moreData) {
+    if (d.has(ftmsparser::INSTANT_SPEED)) {
         if (!settings.value("speed_power_based", false).toBool())
-            Speed = ((double)(((uint16_t)((uint8_t)newValue.at(index + 1)) << 8) |
-                              (uint16_t)((uint8_t)newValue.at(index)))) /
-                    100.0;
+            Speed = d[ftmsparser::INSTANT_SPEED];
         else
             Speed = metric::calculateSpeedFromPower(m_watt.value());
-        index += 2;
         debug("Current Speed: " + QString::number(Speed.value()));
     }
 
-    if (Flags.avgSpeed) {
-        double avgSpeed;
-        avgSpeed =
-            ((double)(((uint16_t)((uint8_t)newValue.at(index + 1)) << 8) | (uint16_t)((uint8_t)newValue.at(index)))) /
-            100.0;
-        index += 2;
-        debug("Current Average Speed: " + QString::number(avgSpeed));
-    }
-
-    if (Flags.instantCadence) {
+    if (d.has(ftmsparser::INSTANT_CADENCE)) {
         if (settings.value("cadence_sensor_name", "Disabled").toString().startsWith("Disabled"))
-            Cadence = ((double)(((uint16_t)((uint8_t)newValue.at(index + 1)) << 8) |
-                                (uint16_t)((uint8_t)newValue.at(index)))) /
-                      2.0;
-        index += 2;
+            Cadence = d[ftmsparser::INSTANT_CADENCE];
         debug("Current Cadence: " + QString::number(Cadence.value()));
     }
 
-    if (Flags.avgCadence) {
-        double avgCadence;
-        avgCadence =
-            ((double)(((uint16_t)((uint8_t)newValue.at(index + 1)) << 8) | (uint16_t)((uint8_t)newValue.at(index)))) /
-            2.0;
-        index += 2;
-        debug("Current Average Cadence: " + QString::number(avgCadence));
-    }
-
-    if (Flags.totDistance) {
-        Distance = ((double)((((uint32_t)((uint8_t)newValue.at(index + 2)) << 16) |
-                              (uint32_t)((uint8_t)newValue.at(index + 1)) << 8) |
-                             (uint32_t)((uint8_t)newValue.at(index)))) /
-                   1000.0;
-        index += 3;
+    if (d.has(ftmsparser::TOTAL_DISTANCE)) {
+        Distance = d[ftmsparser::TOTAL_DISTANCE] / 1000.0;
     } else {
         Distance += ((Speed.value() / 3600000.0) *
                      ((double)lastRefreshCharacteristicChanged.msecsTo(QDateTime::currentDateTime())));
@@ -213,43 +167,23 @@ void renphobike::characteristicChanged(const QLowEnergyCharacteristic &character
 
     debug("Current Distance: " + QString::number(Distance.value()));
 
-    if (Flags.resistanceLvl) {
-        Resistance =
-            ((double)(((uint16_t)((uint8_t)newValue.at(index + 1)) << 8) | (uint16_t)((uint8_t)newValue.at(index)))) /
-            2;
+    if (d.has(ftmsparser::RESISTANCE)) {
+        Resistance = d[ftmsparser::RESISTANCE] / 2;
         emit resistanceRead(Resistance.value());
         m_pelotonResistance = bikeResistanceToPeloton(Resistance.value());
-        index += 2;
         debug("Current Resistance: " + QString::number(Resistance.value()));
     }
 
-    if (Flags.instantPower) {
+    if (d.has(ftmsparser::INSTANT_POWER)) {
         if (settings.value(QStringLiteral("power_sensor_name"), QStringLiteral("Disabled"))
                 .toString()
                 .startsWith(QStringLiteral("Disabled")))
-            m_watt = ((double)(((uint16_t)((uint8_t)newValue.at(index + 1)) << 8) |
-                               (uint16_t)((uint8_t)newValue.at(index))));
-        index += 2;
+            m_watt = d[ftmsparser::INSTANT_POWER];
         debug("Current Watt: " + QString::number(m_watt.value()));
     }
 
-    if (Flags.avgPower) {
-        double avgPower;
-        avgPower =
-            ((double)(((uint16_t)((uint8_t)newValue.at(index + 1)) << 8) | (uint16_t)((uint8_t)newValue.at(index))));
-        index += 2;
-        debug("Current Average Watt: " + QString::number(avgPower));
-    }
-
-    if (Flags.expEnergy) {
-        KCal = ((double)(((uint16_t)((uint8_t)newValue.at(index + 1)) << 8) | (uint16_t)((uint8_t)newValue.at(index))));
-        index += 2;
-
-        // energy per hour
-        index += 2;
-
-        // energy per minute
-        index += 1;
+    if (d.has(ftmsparser::TOTAL_ENERGY)) {
+        KCal = d[ftmsparser::TOTAL_ENERGY];
     } else {
         if (watts())
             KCal +=
@@ -267,25 +201,12 @@ void renphobike::characteristicChanged(const QLowEnergyCharacteristic &character
     else
 #endif
     {
-        if (Flags.heartRate) {
-            Heart = ((double)((newValue.at(index))));
-            index += 1;
+        if (d.has(ftmsparser::HEART_RATE)) {
+            Heart = d[ftmsparser::HEART_RATE];
             debug("Current Heart: " + QString::number(Heart.value()));
         }
     }
 
-    if (Flags.metabolic) {
-        // todo
-    }
-
-    if (Flags.elapsedTime) {
-        // todo
-    }
-
-    if (Flags.remainingTime) {
-        // todo
-    }
-
     if (Cadence.value() > 0) {
         CrankRevs++;
         LastCrankEventTime += (uint16_t)(1024.0 / (((double)(Cadence.value())) / 60.0));
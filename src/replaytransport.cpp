@@ -0,0 +1,127 @@
+#include "replaytransport.h"
+#include "qdebugfixup.h"
+
+replaytransport::replaytransport(const QString &fileName, double speed, QObject *parent)
+    : bluetoothtransport(parent), fileName(fileName), speed(speed >= 0 ? speed : 1.0) {
+    timer.setSingleShot(true);
+    connect(&timer, &QTimer::timeout, this, &replaytransport::playNext);
+}
+
+void replaytransport::connectToDevice() {
+    if (state() != QLowEnergyController::UnconnectedState) {
+        return;
+    }
+    setState(QLowEnergyController::ConnectingState);
+
+    records.clear();
+    m_characteristics.clear();
+    // after a disconnection of the capture the driver reconnects and the session goes on from there
+    next = resumeAt;
+    nextWrite = resumeAt;
+    lastT = resumeT;
+    playing = false;
+    notified = false;
+    if (!load(fileName, records)) {
+        setError(QStringLiteral("unable to open ") + fileName);
+        setState(QLowEnergyController::UnconnectedState);
+        return;
+    }
+
+    for (const record &r : qAsConst(records)) {
+        if (r.type == 'C') {
+            m_characteristics.insert(r.characteristic, QLowEnergyCharacteristic::PropertyTypes(
+                                                           QFlag(r.value.isEmpty() ? 0 : (int)(uint8_t)r.value.at(0))));
+        } else if (r.type == 'N' && !m_characteristics.contains(r.characteristic)) {
+            m_characteristics.insert(r.characteristic, QLowEnergyCharacteristic::Notify);
+        } else if (r.type == 'W' && !m_characteristics.contains(r.characteristic)) {
+            m_characteristics.insert(r.characteristic,
+                                     QLowEnergyCharacteristic::Write | QLowEnergyCharacteristic::WriteNoResponse);
+        }
+    }
+    qDebug() << QStringLiteral("replaytransport:") << records.length() << QStringLiteral("records from") << fileName;
+
+    // asynchronous as a real connection, so the driver sees the same sequence of signals
+    QTimer::singleShot(0, this, [this]() {
+        setState(QLowEnergyController::ConnectedState);
+        setState(QLowEnergyController::DiscoveringState);
+        setState(QLowEnergyController::DiscoveredState);
+        emit discovered();
+    });
+}
+
+void replaytransport::disconnectFromDevice() {
+    timer.stop();
+    playing = false;
+    setState(QLowEnergyController::UnconnectedState);
+}
+
+QLowEnergyCharacteristic::PropertyTypes replaytransport::properties(const QBluetoothUuid &characteristic) const {
+    return m_characteristics.value(characteristic, QLowEnergyCharacteristic::Unknown);
+}
+
+bool replaytransport::subscribe(const QBluetoothUuid &characteristic) {
+    QTimer::singleShot(0, this, [this, characteristic]() {
+        emit subscribed(characteristic);
+        if (!playing) {
+            playing = true;
+            scheduleNext();
+        }
+    });
+    return true;
+}
+
+void replaytransport::scheduleNext() {
+    while (next < records.length() && records.at(next).type != 'N' && records.at(next).type != 'S') {
+        next++;
+    }
+    if (next >= records.length()) {
+        qDebug() << QStringLiteral("replaytransport: end of the capture");
+        return;
+    }
+    qint64 delay = qMax<qint64>(0, records.at(next).t - lastT);
+    timer.start(speed > 0 ? (int)(delay / speed) : 0);
+}
+
+void replaytransport::playNext() {
+    if (!playing || next >= records.length()) {
+        return;
+    }
+    const record r = records.at(next++);
+    lastT = r.t;
+    if (r.type == 'S') {
+        // the connection sequence is played by connectToDevice(), only a drop in the middle of the session matters
+        if (notified && (r.value.isEmpty() || r.value.at(0) == QLowEnergyController::UnconnectedState)) {
+            qDebug() << QStringLiteral("replaytransport: disconnection in the capture");
+            resumeAt = next;
+            resumeT = r.t;
+            disconnectFromDevice();
+            return;
+        }
+    } else {
+        notified = true;
+        emit characteristicChanged(r.characteristic, r.value);
+    }
+    scheduleNext();
+}
+
+void replaytransport::writeCharacteristic(const QBluetoothUuid &characteristic, const QByteArray &value,
+                                          bool withResponse) {
+    Q_UNUSED(withResponse);
+    if (state() == QLowEnergyController::UnconnectedState) {
+        qDebug() << QStringLiteral("replaytransport: writeCharacteristic error because the connection is closed");
+        return;
+    }
+
+    while (nextWrite < records.length() && records.at(nextWrite).type != 'W') {
+        nextWrite++;
+    }
+    if (nextWrite < records.length()) {
+        const record &expected = records.at(nextWrite++);
+        if (expected.characteristic != characteristic || expected.value != value) {
+            qDebug() << QStringLiteral("replaytransport: write differs from the capture") << value.toHex(' ')
+                     << QStringLiteral("expected") << expected.value.toHex(' ');
+        }
+    }
+
+    QTimer::singleShot(0, this, [this, characteristic, value]() { emit characteristicWritten(characteristic, value); });
+}
@@ -0,0 +1,60 @@
+#ifndef REPLAYTRANSPORT_H
+#define REPLAYTRANSPORT_H
+
+#include <QHash>
+#include <QList>
+#include <QTimer>
+
+#include "bluetoothtransport.h"
+#include "capturefile.h"
+
+// Plays back a captured session: a binary capture of capturetransport, a btsnoop HCI log or a text capture with one
+// record per line:
+//
+//   <ms from the start> N <characteristic uuid> <hex bytes>    notification received from the device
+//   <ms from the start> W <characteristic uuid> <hex bytes>    write sent by the driver
+//   <ms from the start> C <characteristic uuid> <properties>   characteristic declaration (optional)
+//
+// Empty lines and lines starting with # are skipped. The notifications are emitted in the file order with their
+// original spacing (divided by the speed, 0 plays them as fast as possible), starting from the first subscription,
+// so the same file gives always the same sequence to the driver. The states recorded in a binary capture are
+// replayed too: a disconnection in the capture disconnects the driver, and the playback goes on from there when the
+// driver connects again. The writes of the driver are compared with the captured ones and the differences are logged.
+class replaytransport : public bluetoothtransport {
+    Q_OBJECT
+  public:
+    replaytransport(const QString &fileName, double speed = 1.0, QObject *parent = nullptr);
+    TRANSPORT_TYPE type() const override { return REPLAY; }
+
+    void connectToDevice() override;
+    void disconnectFromDevice() override;
+    QList<QBluetoothUuid> characteristics() const override { return m_characteristics.keys(); }
+    QLowEnergyCharacteristic::PropertyTypes properties(const QBluetoothUuid &characteristic) const override;
+    bool subscribe(const QBluetoothUuid &characteristic) override;
+    void writeCharacteristic(const QBluetoothUuid &characteristic, const QByteArray &value,
+                             bool withResponse = true) override;
+
+    typedef capturefile::record record;
+    static bool load(const QString &fileName, QList<record> &records) { return capturefile::load(fileName, records); }
+
+  private:
+    void scheduleNext();
+
+    QString fileName;
+    double speed = 1.0;
+    QList<record> records;
+    QHash<QBluetoothUuid, QLowEnergyCharacteristic::PropertyTypes> m_characteristics;
+    int next = 0;
+    int nextWrite = 0;
+    qint64 lastT = 0;
+    bool playing = false;
+    bool notified = false;
+    int resumeAt = 0;
+    qint64 resumeT = 0;
+    QTimer timer;
+
+  private slots:
+    void playNext();
+};
+
+#endif // REPLAYTRANSPORT_H
@@ -31,8 +31,8 @@ uint16_t rower::watts() { return 0; }
 metric rower::pelotonResistance() { return m_pelotonResistance; }
 int rower::pelotonToBikeResistance(int pelotonResistance) { return pelotonResistance; }
 uint8_t rower::resistanceFromPowerRequest(uint16_t power) { return power / 10; } // in order to have something
-void rower::cadenceSensor(uint8_t cadence) { Cadence.setValue(cadence); }
-void rower::powerSensor(uint16_t power) { m_watt.setValue(power); }
+void rower::cadenceSensor(uint8_t cadence) { fusion.push(sensorfusion::CADENCE, cadence); }
+void rower::powerSensor(uint16_t power) { fusion.push(sensorfusion::POWER, power); }
 
 bluetoothdevice::BLUETOOTH_TYPE rower::deviceType() { return bluetoothdevice::ROWING; }
 
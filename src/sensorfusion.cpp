@@ -0,0 +1,94 @@
+#include "sensorfusion.h"
+#include <chrono>
+
+sensorfusion::sensorfusion() {}
+
+void sensorfusion::configure(int64_t stalenessMs, bool interpolate) {
+    this->stalenessMs = stalenessMs;
+    this->interpolate = interpolate;
+}
+
+int64_t sensorfusion::now() {
+    return std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now().time_since_epoch())
+        .count();
+}
+
+const char *sensorfusion::channelName(CHANNEL c) {
+    switch (c) {
+    case HEART:
+        return "heart";
+    case CADENCE:
+        return "cadence";
+    case POWER:
+        return "power";
+    case SPEED:
+        return "speed";
+    case STEERING:
+        return "steering";
+    default:
+        return "unknown";
+    }
+}
+
+const sensorfusion::point &sensorfusion::history::at(int i) const {
+    return points[(head - 1 - i + historySize) % historySize];
+}
+
+void sensorfusion::push(CHANNEL c, double value) { push(c, value, now()); }
+
+void sensorfusion::push(CHANNEL c, double value, int64_t timestamp) {
+    history &h = channels[c];
+    h.points[h.head] = {timestamp, value};
+    h.head = (h.head + 1) % historySize;
+    if (h.count < historySize) {
+        h.count++;
+    }
+}
+
+bool sensorfusion::stale(CHANNEL c, int64_t t) const {
+    const history &h = channels[c];
+    if (!h.count) {
+        return true;
+    }
+    return (t - h.at(0).t) > stalenessMs;
+}
+
+int64_t sensorfusion::alignedTime() const { return interpolate ? now() - interpolationDelay : now(); }
+
+double sensorfusion::sample(CHANNEL c, int64_t t) const {
+    const history &h = channels[c];
+    if (!h.count) {
+        return 0;
+    }
+
+    // looking for the newest sample not after t
+    int i = 0;
+    while (i < h.count && h.at(i).t > t) {
+        i++;
+    }
+    if (i == h.count) {
+        // t is older than the whole history
+        return h.at(h.count - 1).v;
+    }
+
+    const point &before = h.at(i);
+    if (t - before.t > stalenessMs) {
+        return 0;
+    }
+    if (i == 0 || !interpolate) {
+        return before.v;
+    }
+
+    const point &after = h.at(i - 1);
+    if (after.t == before.t) {
+        return after.v;
+    }
+    return before.v + (after.v - before.v) * ((double)(t - before.t) / (double)(after.t - before.t));
+}
+
+void sensorfusion::clear() {
+    for (history &h : channels) {
+        h.head = 0;
+        h.count = 0;
+    }
+}
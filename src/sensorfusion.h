@@ -0,0 +1,55 @@
+#ifndef SENSORFUSION_H
+#define SENSORFUSION_H
+
+#include <array>
+#include <stdint.h>
+
+// Keeps a short, timestamped history of the values pushed by the auxiliary sensors (heart rate belts, cadence and
+// power sensors, footpods, steering) and gives back the value of each sensor at a common instant, so samples coming
+// from sensors notifying at different phases can be aligned. A sensor that hasn't sent anything for longer than the
+// staleness limit reads as 0.
+class sensorfusion {
+  public:
+    enum CHANNEL { HEART = 0, CADENCE, POWER, SPEED, STEERING, CHANNELS };
+
+    sensorfusion();
+    void configure(int64_t stalenessMs, bool interpolate);
+
+    // timestamps the value at the reception
+    void push(CHANNEL c, double value);
+    void push(CHANNEL c, double value, int64_t timestamp);
+
+    // true if the channel has ever received a value
+    bool active(CHANNEL c) const { return channels[c].count > 0; }
+    bool stale(CHANNEL c, int64_t t) const;
+    // value of the channel at the time t (ms, same clock of now())
+    double sample(CHANNEL c, int64_t t) const;
+    // the instant used to align all the channels: when interpolating it has to stay behind the newest samples
+    int64_t alignedTime() const;
+    void clear();
+
+    static int64_t now();
+    static const char *channelName(CHANNEL c);
+
+  private:
+    static const int historySize = 16;
+    // with interpolation enabled the samples are aligned one second in the past, so that 1Hz sensors are bracketed
+    static const int64_t interpolationDelay = 1000;
+
+    struct point {
+        int64_t t;
+        double v;
+    };
+    struct history {
+        std::array<point, historySize> points;
+        int head = 0; // next slot to write
+        int count = 0;
+        const point &at(int i) const; // 0 is the newest one
+    };
+
+    std::array<history, CHANNELS> channels;
+    int64_t stalenessMs = 5000;
+    bool interpolate = false;
+};
+
+#endif // SENSORFUSION_H
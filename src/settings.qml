@@ -270,6 +270,7 @@ import Qt.labs.settings 1.0
             property bool virtualbike_forceresistance: true
             property bool bluetooth_relaxed: false
             property bool bluetooth_30m_hangs: false
+            property int bluetooth_watchdog_timeout: 10
             property bool battery_service: false
             property bool service_changed: false
             property bool virtual_device_enabled: true
@@ -283,6 +284,29 @@ import Qt.labs.settings 1.0
             property bool virtual_device_force_bike: false
             property bool volume_change_gears: false
             property bool applewatch_fakedevice: false
+            property int status_file_rate: 1000
+            property bool status_file_xml: true
+            property bool status_file_json: false
+            property bool status_shared_memory: false
+            property int sensor_fusion_staleness: 5000
+            property bool sensor_fusion_interpolate: false
+            property real csc_wheel_circumference: 2000
+            property string transport: "BLE"
+            property string transport_tcp_host: "192.168.4.1"
+            property int transport_tcp_port: 8888
+            property string transport_replay_file: ""
+            property real transport_replay_speed: 1.0
+            property string transport_address: ""
+            property string transport_device_name: ""
+            property int log_rotate_size: 100
+            property bool log_compress_rotated: true
+            property bool transport_capture: false
+            property bool virtual_device_dircon: false
+            property int virtual_device_dircon_port: 36866
+            property real virtual_device_rate_bike_data: 1.0
+            property real virtual_device_rate_power: 1.0
+            property real virtual_device_rate_csc: 1.0
+            property real virtual_device_rate_heart: 1.0
         }
 
         ColumnLayout {
@@ -4780,6 +4804,31 @@ import Qt.labs.settings 1.0
                         onClicked: settings.bluetooth_30m_hangs = checked
                     }
 
+                    RowLayout {
+                        spacing: 10
+                        Label {
+                            id: labelBluetoothWatchdogTimeout
+                            text: qsTr("Bluetooth stall timeout (s, 0 disabled):")
+                            Layout.fillWidth: true
+                        }
+                        TextField {
+                            id: bluetoothWatchdogTimeoutTextField
+                            text: settings.bluetooth_watchdog_timeout
+                            horizontalAlignment: Text.AlignRight
+                            Layout.fillHeight: false
+                            Layout.alignment: Qt.AlignRight | Qt.AlignVCenter
+                            inputMethodHints: Qt.ImhDigitsOnly
+                            onAccepted: settings.bluetooth_watchdog_timeout = text
+                            onActiveFocusChanged: if(this.focus) this.cursorPosition = this.text.length
+                        }
+                        Button {
+                            id: okBluetoothWatchdogTimeoutButton
+                            text: "OK"
+                            Layout.alignment: Qt.AlignRight | Qt.AlignVCenter
+                            onClicked: settings.bluetooth_watchdog_timeout = bluetoothWatchdogTimeoutTextField.text
+                        }
+                    }
+
                     SwitchDelegate {
                         id: batteryServiceDelegate
                         text: qsTr("Simulate Battery Service")
@@ -4885,6 +4934,146 @@ import Qt.labs.settings 1.0
                         onClicked: settings.virtual_device_rower = checked
                     }
 
+                    SwitchDelegate {
+                        id: virtualDeviceDirconDelegate
+                        text: qsTr("Virtual Bike on the Network (DIRCON)")
+                        spacing: 0
+                        bottomPadding: 0
+                        topPadding: 0
+                        rightPadding: 0
+                        leftPadding: 0
+                        clip: false
+                        checked: settings.virtual_device_dircon
+                        Layout.alignment: Qt.AlignLeft | Qt.AlignTop
+                        Layout.fillWidth: true
+                        onClicked: settings.virtual_device_dircon = checked
+                    }
+
+                    RowLayout {
+                        spacing: 10
+                        Label {
+                            id: labelVirtualDeviceDirconPort
+                            text: qsTr("DIRCON TCP port:")
+                            Layout.fillWidth: true
+                        }
+                        TextField {
+                            id: virtualDeviceDirconPortTextField
+                            text: settings.virtual_device_dircon_port
+                            horizontalAlignment: Text.AlignRight
+                            Layout.fillHeight: false
+                            Layout.alignment: Qt.AlignRight | Qt.AlignVCenter
+                            inputMethodHints: Qt.ImhDigitsOnly
+                            onAccepted: settings.virtual_device_dircon_port = text
+                            onActiveFocusChanged: if(this.focus) this.cursorPosition = this.text.length
+                        }
+                        Button {
+                            id: okVirtualDeviceDirconPortButton
+                            text: "OK"
+                            Layout.alignment: Qt.AlignRight | Qt.AlignVCenter
+                            onClicked: settings.virtual_device_dircon_port = virtualDeviceDirconPortTextField.text
+                        }
+                    }
+
+                    RowLayout {
+                        spacing: 10
+                        Label {
+                            id: labelVirtualDeviceRateBikeData
+                            text: qsTr("Virtual FTMS bike data rate (Hz, 1-10):")
+                            Layout.fillWidth: true
+                        }
+                        TextField {
+                            id: virtualDeviceRateBikeDataTextField
+                            text: settings.virtual_device_rate_bike_data
+                            horizontalAlignment: Text.AlignRight
+                            Layout.fillHeight: false
+                            Layout.alignment: Qt.AlignRight | Qt.AlignVCenter
+                            inputMethodHints: Qt.ImhFormattedNumbersOnly
+                            onAccepted: settings.virtual_device_rate_bike_data = text
+                            onActiveFocusChanged: if(this.focus) this.cursorPosition = this.text.length
+                        }
+                        Button {
+                            id: okVirtualDeviceRateBikeDataButton
+                            text: "OK"
+                            Layout.alignment: Qt.AlignRight | Qt.AlignVCenter
+                            onClicked: settings.virtual_device_rate_bike_data = virtualDeviceRateBikeDataTextField.text
+                        }
+                    }
+
+                    RowLayout {
+                        spacing: 10
+                        Label {
+                            id: labelVirtualDeviceRatePower
+                            text: qsTr("Virtual power sensor rate (Hz, 1-10):")
+                            Layout.fillWidth: true
+                        }
+                        TextField {
+                            id: virtualDeviceRatePowerTextField
+                            text: settings.virtual_device_rate_power
+                            horizontalAlignment: Text.AlignRight
+                            Layout.fillHeight: false
+                            Layout.alignment: Qt.AlignRight | Qt.AlignVCenter
+                            inputMethodHints: Qt.ImhFormattedNumbersOnly
+                            onAccepted: settings.virtual_device_rate_power = text
+                            onActiveFocusChanged: if(this.focus) this.cursorPosition = this.text.length
+                        }
+                        Button {
+                            id: okVirtualDeviceRatePowerButton
+                            text: "OK"
+                            Layout.alignment: Qt.AlignRight | Qt.AlignVCenter
+                            onClicked: settings.virtual_device_rate_power = virtualDeviceRatePowerTextField.text
+                        }
+                    }
+
+                    RowLayout {
+                        spacing: 10
+                        Label {
+                            id: labelVirtualDeviceRateCsc
+                            text: qsTr("Virtual cadence sensor rate (Hz, 1-10):")
+                            Layout.fillWidth: true
+                        }
+                        TextField {
+                            id: virtualDeviceRateCscTextField
+                            text: settings.virtual_device_rate_csc
+                            horizontalAlignment: Text.AlignRight
+                            Layout.fillHeight: false
+                            Layout.alignment: Qt.AlignRight | Qt.AlignVCenter
+                            inputMethodHints: Qt.ImhFormattedNumbersOnly
+                            onAccepted: settings.virtual_device_rate_csc = text
+                            onActiveFocusChanged: if(this.focus) this.cursorPosition = this.text.length
+                        }
+                        Button {
+                            id: okVirtualDeviceRateCscButton
+                            text: "OK"
+                            Layout.alignment: Qt.AlignRight | Qt.AlignVCenter
+                            onClicked: settings.virtual_device_rate_csc = virtualDeviceRateCscTextField.text
+                        }
+                    }
+
+                    RowLayout {
+                        spacing: 10
+                        Label {
+                            id: labelVirtualDeviceRateHeart
+                            text: qsTr("Virtual heart rate rate (Hz, 1-10):")
+                            Layout.fillWidth: true
+                        }
+                        TextField {
+                            id: virtualDeviceRateHeartTextField
+                            text: settings.virtual_device_rate_heart
+                            horizontalAlignment: Text.AlignRight
+                            Layout.fillHeight: false
+                            Layout.alignment: Qt.AlignRight | Qt.AlignVCenter
+                            inputMethodHints: Qt.ImhFormattedNumbersOnly
+                            onAccepted: settings.virtual_device_rate_heart = text
+                            onActiveFocusChanged: if(this.focus) this.cursorPosition = this.text.length
+                        }
+                        Button {
+                            id: okVirtualDeviceRateHeartButton
+                            text: "OK"
+                            Layout.alignment: Qt.AlignRight | Qt.AlignVCenter
+                            onClicked: settings.virtual_device_rate_heart = virtualDeviceRateHeartTextField.text
+                        }
+                    }
+
                     SwitchDelegate {
                         id: virtualBikeForceResistanceDelegate
                         text: qsTr("Zwift Force Resistance")
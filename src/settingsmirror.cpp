@@ -0,0 +1,102 @@
+#include "settingsmirror.h"
+#include <QRandomGenerator>
+#include <QSet>
+
+settingsmirror::settingsmirror(QObject *parent) : QObject(parent) {
+    m_epoch = QString::number(QRandomGenerator::global()->generate64(), 16);
+    syncTimer.setSingleShot(true);
+    syncTimer.setInterval(syncDelay);
+    connect(&syncTimer, &QTimer::timeout, this, [this]() { settings.sync(); });
+    refresh(true);
+}
+
+settingsmirror::~settingsmirror() {
+    if (syncTimer.isActive()) {
+        settings.sync();
+    }
+}
+
+void settingsmirror::refresh(bool force) {
+    if (!force && refreshed.isValid() && refreshed.elapsed() < refreshInterval) {
+        return;
+    }
+    refreshed.start();
+    quint64 next = m_version + 1;
+    bool changed = false;
+    QSet<QString> present;
+    const QStringList keys = settings.allKeys();
+    for (const QString &key : keys) {
+        present.insert(key);
+        QVariant v = settings.value(key);
+        auto e = m_entries.find(key);
+        if (e == m_entries.end() || e->removed || e->value != v) {
+            entry &n = m_entries[key];
+            n.value = v;
+            n.json = QJsonValue::fromVariant(v);
+            n.version = next;
+            n.removed = false;
+            changed = true;
+        }
+    }
+    for (auto e = m_entries.begin(); e != m_entries.end(); ++e) {
+        if (!e->removed && !present.contains(e.key())) {
+            e->value = QVariant();
+            e->json = QJsonValue(QJsonValue::Null);
+            e->version = next;
+            e->removed = true;
+            changed = true;
+        }
+    }
+    if (changed) {
+        m_version = next;
+    }
+}
+
+bool settingsmirror::contains(const QString &key) const {
+    auto e = m_entries.constFind(key);
+    return e != m_entries.constEnd() && !e->removed;
+}
+
+QVariant settingsmirror::value(const QString &key) const {
+    auto e = m_entries.constFind(key);
+    return e != m_entries.constEnd() ? e->value : QVariant();
+}
+
+const QJsonObject &settingsmirror::toJson() {
+    if (jsonVersion != m_version) {
+        json = QJsonObject();
+        for (auto e = m_entries.constBegin(); e != m_entries.constEnd(); ++e) {
+            if (!e->removed) {
+                json.insert(e.key(), e->json);
+            }
+        }
+        jsonVersion = m_version;
+    }
+    return json;
+}
+
+QJsonObject settingsmirror::changes(quint64 since) const {
+    QJsonObject out;
+    for (auto e = m_entries.constBegin(); e != m_entries.constEnd(); ++e) {
+        if (e->version > since) {
+            out.insert(e.key(), e->json);
+        }
+    }
+    return out;
+}
+
+void settingsmirror::set(const QVariantHash &values) {
+    if (values.isEmpty()) {
+        return;
+    }
+    m_version++;
+    for (auto v = values.constBegin(); v != values.constEnd(); ++v) {
+        settings.setValue(v.key(), v.value());
+        entry &n = m_entries[v.key()];
+        n.value = v.value();
+        n.json = QJsonValue::fromVariant(v.value());
+        n.version = m_version;
+        n.removed = false;
+    }
+    syncTimer.start();
+}
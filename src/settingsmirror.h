@@ -0,0 +1,55 @@
+#ifndef SETTINGSMIRROR_H
+#define SETTINGSMIRROR_H
+
+#include <QElapsedTimer>
+#include <QHash>
+#include <QJsonObject>
+#include <QObject>
+#include <QSettings>
+#include <QTimer>
+#include <QVariant>
+
+// The settings in memory, each with its value as JSON and the version it last changed in. The version grows at every
+// batch of changes, so a client knows what changed since the last time it asked. The versions restart with the
+// process: the epoch, random at every start, tells a client that the version it has is from another run. The rest of
+// the app writes QSettings directly: refresh reads them all again at most every refreshInterval ms. set writes a batch
+// to QSettings, and the file is written once syncDelay ms after the last batch.
+class settingsmirror : public QObject {
+    Q_OBJECT
+  public:
+    struct entry {
+        QVariant value;
+        QJsonValue json;
+        quint64 version = 0;
+        // removed from QSettings, kept to tell the clients
+        bool removed = false;
+    };
+    static const int refreshInterval = 1000;
+    static const int syncDelay = 500;
+
+    explicit settingsmirror(QObject *parent = nullptr);
+    virtual ~settingsmirror();
+    void refresh(bool force = false);
+    quint64 version() const { return m_version; }
+    const QString &epoch() const { return m_epoch; }
+    const QHash<QString, entry> &entries() const { return m_entries; }
+    bool contains(const QString &key) const;
+    QVariant value(const QString &key) const;
+    // all the settings, cached until the next change
+    const QJsonObject &toJson();
+    // the settings changed after the version, the removed ones are null
+    QJsonObject changes(quint64 since) const;
+    void set(const QVariantHash &values);
+
+  private:
+    QSettings settings;
+    QHash<QString, entry> m_entries;
+    quint64 m_version = 0;
+    QString m_epoch;
+    QElapsedTimer refreshed;
+    QTimer syncTimer;
+    QJsonObject json;
+    quint64 jsonVersion = 0;
+};
+
+#endif // SETTINGSMIRROR_H
@@ -1,4 +1,6 @@
 #include "shuaa5treadmill.h"
+#include "logging.h"
+#include "ftmsparser.h"
 #include "ftmsbike.h"
 #include "ios/lockscreen.h"
 #include "virtualtreadmill.h"
@@ -99,7 +101,7 @@ void shuaa5treadmill::update() {
 
         if (requestSpeed != -1) {
             if (requestSpeed != currentSpeed().value() && requestSpeed >= 0 && requestSpeed <= 22) {
-                emit debug(QStringLiteral("writing speed ") + QString::number(requestSpeed));
+                LOG_DEVICE(QStringLiteral("writing speed ") + QString::number(requestSpeed));
                 forceSpeed(requestSpeed);
             }
             requestSpeed = -1;
@@ -107,13 +109,13 @@ void shuaa5treadmill::update() {
         if (requestInclination != -1) {
             if (requestInclination != currentInclination().value() && requestInclination >= 0 &&
                 requestInclination <= 15) {
-                emit debug(QStringLiteral("writing incline ") + QString::number(requestInclination));
+                LOG_DEVICE(QStringLiteral("writing incline ") + QString::number(requestInclination));
                 forceIncline(requestInclination);
             }
             requestInclination = -1;
         }
         if (requestStart != -1) {
-            emit debug(QStringLiteral("starting..."));
+            LOG_DEVICE(QStringLiteral("starting..."));
             if (lastSpeed == 0.0) {
 
                 lastSpeed = 0.5;
@@ -123,17 +125,17 @@ void shuaa5treadmill::update() {
             emit tapeStarted();
         }
         if (requestStop != -1) {
-            emit debug(QStringLiteral("stopping..."));
+            LOG_DEVICE(QStringLiteral("stopping..."));
 
             requestStop = -1;
         }
         if (requestIncreaseFan != -1) {
-            emit debug(QStringLiteral("increasing fan speed..."));
+            LOG_DEVICE(QStringLiteral("increasing fan speed..."));
 
             // sendChangeFanSpeed(FanSpeed + 1);
             requestIncreaseFan = -1;
         } else if (requestDecreaseFan != -1) {
-            emit debug(QStringLiteral("decreasing fan speed..."));
+            LOG_DEVICE(QStringLiteral("decreasing fan speed..."));
 
             // sendChangeFanSpeed(FanSpeed - 1);
             requestDecreaseFan = -1;
@@ -160,7 +162,7 @@ void shuaa5treadmill::forceIncline(double requestIncline) {
 double shuaa5treadmill::minStepInclination() { return 1.0; }
 
 void shuaa5treadmill::serviceDiscovered(const QBluetoothUuid &gatt) {
-    emit debug(QStringLiteral("serviceDiscovered ") + gatt.toString());
+    LOG_DEVICE(QStringLiteral("serviceDiscovered ") + gatt.toString());
 }
 
 void shuaa5treadmill::characteristicChanged(const QLowEnergyCharacteristic &characteristic,
@@ -173,109 +175,44 @@ void shuaa5treadmill::characteristicChanged(const QLowEnergyCharacteristic &char
     QString heartRateBeltName =
         settings.value(QStringLiteral("heart_rate_belt_name"), QStringLiteral("Disabled")).toString();
 
-    emit debug(QStringLiteral(" << ") + characteristic.uuid().toString() + " " + QString::number(newValue.length()) +
+    LOG_PACKET(QStringLiteral(" << ") + characteristic.uuid().toString() + " " + QString::number(newValue.length()) +
                " " + newValue.toHex(' '));
 
     emit packetReceived();
 
-    if (characteristic.uuid() == QBluetoothUuid((quint16)0x2ACD)) {
+    if (characteristic.uuid() == QBluetoothUuid((quint16)ftmsparser::TREADMILL_DATA)) {
         lastPacket = newValue;
 
         // default flags for this treadmill is 84 04
+        ftmsparser::data d;
+        if (!ftmsparser::parse(ftmsparser::TREADMILL_DATA, newValue.constData(), newValue.length(), d)) {
+            LOG_DEVICE(QStringLiteral("truncated treadmill data"));
+        }
 
-        union flags {
-            struct {
-
-                uint16_t moreData : 1;
-                uint16_t avgSpeed : 1;
-                uint16_t totalDistance : 1;
-                uint16_t inclination : 1;
-                uint16_t elevation : 1;
-                uint16_t instantPace : 1;
-                uint16_t averagePace : 1;
-                uint16_t expEnergy : 1;
-                uint16_t heartRate : 1;
-                uint16_t metabolic : 1;
-                uint16_t elapsedTime : 1;
-                uint16_t remainingTime : 1;
-                uint16_t forceBelt : 1;
-                uint16_t spare : 3;
-            };
-
-            uint16_t word_flags;
-        };
-
-        flags Flags;
-        int index = 0;
-        Flags.word_flags = (newValue.at(1) << 8) | newValue.at(0);
-        index += 2;
-
-        if (!Flags.moreData) {
-            double speed = ((double)(((uint16_t)((uint8_t)newValue.at(index + 1)) << 8) |
-                                     (uint16_t)((uint8_t)newValue.at(index)))) /
-                           100.0;
+        if (d.has(ftmsparser::INSTANT_SPEED)) {
+            double speed = d[ftmsparser::INSTANT_SPEED];
             if (Speed.value() != speed) {
 
                 emit speedChanged(speed);
             }
             Speed = speed;
-            index += 2;
-            emit debug(QStringLiteral("Current Speed: ") + QString::number(Speed.value()));
-        }
-
-        if (Flags.avgSpeed) {
-            double avgSpeed;
-            avgSpeed = ((double)(((uint16_t)((uint8_t)newValue.at(index + 1)) << 8) |
-                                 (uint16_t)((uint8_t)newValue.at(index)))) /
-                       100.0;
-            index += 2;
-            emit debug(QStringLiteral("Current Average Speed: ") + QString::number(avgSpeed));
-        }
-
-        if (Flags.totalDistance) {
-            // ignoring the distance, because it's a total life odometer
-            // Distance = ((double)((((uint32_t)((uint8_t)newValue.at(index + 2)) << 16) |
-            // (uint32_t)((uint8_t)newValue.at(index + 1)) << 8) | (uint32_t)((uint8_t)newValue.at(index)))) / 1000.0;
-            index += 3;
-        }
-        // else
-        {
-            Distance += ((Speed.value() / 3600000.0) *
-                         ((double)lastRefreshCharacteristicChanged.msecsTo(QDateTime::currentDateTime())));
-        }
-
-        emit debug(QStringLiteral("Current Distance: ") + QString::number(Distance.value()));
-
-        if (Flags.inclination) {
-            Inclination = ((double)(((uint16_t)((uint8_t)newValue.at(index + 1)) << 8) |
-                                    (uint16_t)((uint8_t)newValue.at(index)))) /
-                          10.0;
-            index += 4; // the ramo value is useless
-            emit debug(QStringLiteral("Current Inclination: ") + QString::number(Inclination.value()));
+            LOG_DEVICE(QStringLiteral("Current Speed: ") + QString::number(Speed.value()));
         }
 
-        if (Flags.elevation) {
-            index += 4; // TODO
-        }
+        // ignoring the total distance, because it's a total life odometer
+        Distance += ((Speed.value() / 3600000.0) *
+                     ((double)lastRefreshCharacteristicChanged.msecsTo(QDateTime::currentDateTime())));
 
-        if (Flags.instantPace) {
-            index += 1; // TODO
-        }
+        LOG_DEVICE(QStringLiteral("Current Distance: ") + QString::number(Distance.value()));
 
-        if (Flags.averagePace) {
-            index += 1; // TODO
+        if (d.has(ftmsparser::INCLINATION)) {
+            // the ramp value is useless
+            Inclination = d[ftmsparser::INCLINATION];
+            LOG_DEVICE(QStringLiteral("Current Inclination: ") + QString::number(Inclination.value()));
         }
 
-        if (Flags.expEnergy) {
-            KCal = ((double)(((uint16_t)((uint8_t)newValue.at(index + 1)) << 8) |
-                             (uint16_t)((uint8_t)newValue.at(index))));
-            index += 2;
-
-            // energy per hour
-            index += 2;
-
-            // energy per minute
-            index += 1;
+        if (d.has(ftmsparser::TOTAL_ENERGY)) {
+            KCal = d[ftmsparser::TOTAL_ENERGY];
         } else {
             if (watts(settings.value(QStringLiteral("weight"), 75.0).toFloat()))
                 KCal += ((((0.048 * ((double)watts(settings.value(QStringLiteral("weight"), 75.0).toFloat())) + 1.19) *
@@ -287,7 +224,7 @@ void shuaa5treadmill::characteristicChanged(const QLowEnergyCharacteristic &char
                                                                 // kg * 3.5) / 200 ) / 60
         }
 
-        emit debug(QStringLiteral("Current KCal: ") + QString::number(KCal.value()));
+        LOG_DEVICE(QStringLiteral("Current KCal: ") + QString::number(KCal.value()));
 
 #ifdef Q_OS_ANDROID
         if (settings.value("ant_heart", false).toBool())
@@ -295,33 +232,11 @@ void shuaa5treadmill::characteristicChanged(const QLowEnergyCharacteristic &char
         else
 #endif
         {
-            if (Flags.heartRate) {
-                if (index < newValue.length()) {
-
-                    heart = ((double)((newValue.at(index))));
-                    emit debug(QStringLiteral("Current Heart: ") + QString::number(heart));
-                } else {
-                    emit debug(QStringLiteral("Error on parsing heart!"));
-                }
-                // index += 1; //NOTE: clang-analyzer-deadcode.DeadStores
+            if (d.has(ftmsparser::HEART_RATE)) {
+                heart = d[ftmsparser::HEART_RATE];
+                LOG_DEVICE(QStringLiteral("Current Heart: ") + QString::number(heart));
             }
         }
-
-        if (Flags.metabolic) {
-            // todo
-        }
-
-        if (Flags.elapsedTime) {
-            // todo
-        }
-
-        if (Flags.remainingTime) {
-            // todo
-        }
-
-        if (Flags.forceBelt) {
-            // todo
-        }
     }
 
     if (heartRateBeltName.startsWith(QStringLiteral("Disabled"))) {
@@ -352,7 +267,7 @@ void shuaa5treadmill::characteristicChanged(const QLowEnergyCharacteristic &char
 
 void shuaa5treadmill::stateChanged(QLowEnergyService::ServiceState state) {
     QMetaEnum metaEnum = QMetaEnum::fromType<QLowEnergyService::ServiceState>();
-    emit debug(QStringLiteral("BTLE stateChanged ") + QString::fromLocal8Bit(metaEnum.valueToKey(state)));
+    LOG_DEVICE(QStringLiteral("BTLE stateChanged ") + QString::fromLocal8Bit(metaEnum.valueToKey(state)));
 
     for (QLowEnergyService *s : qAsConst(gattCommunicationChannelService)) {
         qDebug() << QStringLiteral("stateChanged") << s->serviceUuid() << s->state();
@@ -442,7 +357,7 @@ void shuaa5treadmill::stateChanged(QLowEnergyService::ServiceState state) {
         QSettings settings;
         bool virtual_device_enabled = settings.value(QStringLiteral("virtual_device_enabled"), true).toBool();
         if (virtual_device_enabled) {
-            emit debug(QStringLiteral("creating virtual treadmill interface..."));
+            LOG_DEVICE(QStringLiteral("creating virtual treadmill interface..."));
 
             virtualTreadmill = new virtualtreadmill(this, noHeartService);
             connect(virtualTreadmill, &virtualtreadmill::debug, this, &shuaa5treadmill::debug);
@@ -461,7 +376,7 @@ void shuaa5treadmill::changeInclinationRequested(double grade, double percentage
 }
 
 void shuaa5treadmill::descriptorWritten(const QLowEnergyDescriptor &descriptor, const QByteArray &newValue) {
-    emit debug(QStringLiteral("descriptorWritten ") + descriptor.name() + QStringLiteral(" ") + newValue.toHex(' '));
+    LOG_PACKET(QStringLiteral("descriptorWritten ") + descriptor.name() + QStringLiteral(" ") + newValue.toHex(' '));
 
     initRequest = true;
     emit connectedAndDiscovered();
@@ -474,7 +389,7 @@ void shuaa5treadmill::descriptorRead(const QLowEnergyDescriptor &descriptor, con
 void shuaa5treadmill::characteristicWritten(const QLowEnergyCharacteristic &characteristic,
                                             const QByteArray &newValue) {
     Q_UNUSED(characteristic);
-    emit debug(QStringLiteral("characteristicWritten ") + newValue.toHex(' '));
+    LOG_PACKET(QStringLiteral("characteristicWritten ") + newValue.toHex(' '));
 }
 
 void shuaa5treadmill::characteristicRead(const QLowEnergyCharacteristic &characteristic, const QByteArray &newValue) {
@@ -482,7 +397,7 @@ void shuaa5treadmill::characteristicRead(const QLowEnergyCharacteristic &charact
 }
 
 void shuaa5treadmill::serviceScanDone(void) {
-    emit debug(QStringLiteral("serviceScanDone"));
+    LOG_DEVICE(QStringLiteral("serviceScanDone"));
 
     initRequest = false;
     firstStateChanged = 0;
@@ -498,20 +413,20 @@ void shuaa5treadmill::serviceScanDone(void) {
 void shuaa5treadmill::errorService(QLowEnergyService::ServiceError err) {
 
     QMetaEnum metaEnum = QMetaEnum::fromType<QLowEnergyService::ServiceError>();
-    emit debug(QStringLiteral("shuaa5treadmill::errorService") + QString::fromLocal8Bit(metaEnum.valueToKey(err)) +
+    LOG_DEVICE(QStringLiteral("shuaa5treadmill::errorService") + QString::fromLocal8Bit(metaEnum.valueToKey(err)) +
                m_control->errorString());
 }
 
 void shuaa5treadmill::error(QLowEnergyController::Error err) {
 
     QMetaEnum metaEnum = QMetaEnum::fromType<QLowEnergyController::Error>();
-    emit debug(QStringLiteral("shuaa5treadmill::error") + QString::fromLocal8Bit(metaEnum.valueToKey(err)) +
+    LOG_DEVICE(QStringLiteral("shuaa5treadmill::error") + QString::fromLocal8Bit(metaEnum.valueToKey(err)) +
                m_control->errorString());
 }
 
 void shuaa5treadmill::deviceDiscovered(const QBluetoothDeviceInfo &device) {
 
-    emit debug(QStringLiteral("Found new device: ") + device.name() + QStringLiteral(" (") +
+    LOG_DEVICE(QStringLiteral("Found new device: ") + device.name() + QStringLiteral(" (") +
                device.address().toString() + ')');
     {
         bluetoothDevice = device;
@@ -529,17 +444,17 @@ void shuaa5treadmill::deviceDiscovered(const QBluetoothDeviceInfo &device) {
                 this, [this](QLowEnergyController::Error error) {
                     Q_UNUSED(error);
                     Q_UNUSED(this);
-                    emit debug(QStringLiteral("Cannot connect to remote device."));
+                    LOG_DEVICE(QStringLiteral("Cannot connect to remote device."));
                     emit disconnected();
                 });
         connect(m_control, &QLowEnergyController::connected, this, [this]() {
             Q_UNUSED(this);
-            emit debug(QStringLiteral("Controller connected. Search services..."));
+            LOG_DEVICE(QStringLiteral("Controller connected. Search services..."));
             m_control->discoverServices();
         });
         connect(m_control, &QLowEnergyController::disconnected, this, [this]() {
             Q_UNUSED(this);
-            emit debug(QStringLiteral("LowEnergy controller disconnected"));
+            LOG_DEVICE(QStringLiteral("LowEnergy controller disconnected"));
             emit disconnected();
         });
 
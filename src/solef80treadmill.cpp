@@ -1,4 +1,6 @@
 #include "solef80treadmill.h"
+#include "logging.h"
+#include "ftmsparser.h"
 
 #include "ios/lockscreen.h"
 #include "virtualtreadmill.h"
@@ -189,7 +191,7 @@ void solef80treadmill::update() {
 
         if (requestSpeed != -1) {
             if (requestSpeed != currentSpeed().value() && requestSpeed >= 0 && requestSpeed <= 22) {
-                emit debug(QStringLiteral("writing speed ") + QString::number(requestSpeed));
+                LOG_DEVICE(QStringLiteral("writing speed ") + QString::number(requestSpeed));
                 forceSpeed(requestSpeed);
             }
             // i have to do the reset on when the speed is equal to the current
@@ -198,14 +200,14 @@ void solef80treadmill::update() {
         if (requestInclination != -1) {
             if (requestInclination != currentInclination().value() && requestInclination >= 0 &&
                 requestInclination <= 15) {
-                emit debug(QStringLiteral("writing incline ") + QString::number(requestInclination));
+                LOG_DEVICE(QStringLiteral("writing incline ") + QString::number(requestInclination));
                 forceIncline(requestInclination);
             }
             // i have to do the reset on when the inclination is equal to the current
             // requestInclination = -1;
         }
         if (requestStart != -1) {
-            emit debug(QStringLiteral("starting..."));
+            LOG_DEVICE(QStringLiteral("starting..."));
             if (lastSpeed == 0.0) {
 
                 lastSpeed = 0.5;
@@ -224,7 +226,7 @@ void solef80treadmill::update() {
             emit tapeStarted();
         }
         if (requestStop != -1) {
-            emit debug(QStringLiteral("stopping..."));
+            LOG_DEVICE(QStringLiteral("stopping..."));
 
             uint8_t stop[] = {0x5b, 0x02, 0x03, 0x06, 0x5d};
             uint8_t stop1[] = {0x5b, 0x02, 0x03, 0x07, 0x5d};
@@ -243,12 +245,12 @@ void solef80treadmill::update() {
             requestStop = -1;
         }
         if (requestIncreaseFan != -1) {
-            emit debug(QStringLiteral("increasing fan speed..."));
+            LOG_DEVICE(QStringLiteral("increasing fan speed..."));
 
             // sendChangeFanSpeed(FanSpeed + 1);
             requestIncreaseFan = -1;
         } else if (requestDecreaseFan != -1) {
-            emit debug(QStringLiteral("decreasing fan speed..."));
+            LOG_DEVICE(QStringLiteral("decreasing fan speed..."));
 
             // sendChangeFanSpeed(FanSpeed - 1);
             requestDecreaseFan = -1;
@@ -320,7 +322,7 @@ void solef80treadmill::forceIncline(double requestIncline) {
 }
 
 void solef80treadmill::serviceDiscovered(const QBluetoothUuid &gatt) {
-    emit debug(QStringLiteral("serviceDiscovered ") + gatt.toString());
+    LOG_DEVICE(QStringLiteral("serviceDiscovered ") + gatt.toString());
 }
 
 void solef80treadmill::characteristicChanged(const QLowEnergyCharacteristic &characteristic,
@@ -333,7 +335,7 @@ void solef80treadmill::characteristicChanged(const QLowEnergyCharacteristic &cha
     QString heartRateBeltName =
         settings.value(QStringLiteral("heart_rate_belt_name"), QStringLiteral("Disabled")).toString();
 
-    emit debug(QStringLiteral(" << ") + characteristic.uuid().toString() + " " + QString::number(newValue.length()) +
+    LOG_PACKET(QStringLiteral(" << ") + characteristic.uuid().toString() + " " + QString::number(newValue.length()) +
                " " + newValue.toHex(' '));
 
     if (characteristic.uuid() == _gattNotifyCharId) {
@@ -358,10 +360,10 @@ void solef80treadmill::characteristicChanged(const QLowEnergyCharacteristic &cha
         QDateTime now = QDateTime::currentDateTime();
 
         Speed = ((double)((uint8_t)newValue.at(10)) / 10.0) * miles;
-        emit debug(QStringLiteral("Current Speed: ") + QString::number(Speed.value()));
+        LOG_DEVICE(QStringLiteral("Current Speed: ") + QString::number(Speed.value()));
 
         Inclination = (double)((uint8_t)newValue.at(11));
-        emit debug(QStringLiteral("Current Inclination: ") + QString::number(Inclination.value()));
+        LOG_DEVICE(QStringLiteral("Current Inclination: ") + QString::number(Inclination.value()));
 
         Distance += ((Speed.value() / 3600000.0) * ((double)lastRefreshCharacteristicChanged.msecsTo(now)));
 
@@ -372,7 +374,7 @@ void solef80treadmill::characteristicChanged(const QLowEnergyCharacteristic &cha
                      (60000.0 / ((double)lastRefreshCharacteristicChanged.msecsTo(
                                     now)))); //(( (0.048* Output in watts +1.19) * body weight in
                                              // kg * 3.5) / 200 ) / 60
-        emit debug(QStringLiteral("Current Distance: ") + QString::number(Distance.value()));
+        LOG_DEVICE(QStringLiteral("Current Distance: ") + QString::number(Distance.value()));
 
         lastRefreshCharacteristicChanged = now;
 
@@ -382,99 +384,34 @@ void solef80treadmill::characteristicChanged(const QLowEnergyCharacteristic &cha
         qDebug() << "stop/pause event detected from the treadmill";
         initRequest = true;
 
-    } else if (characteristic.uuid() == QBluetoothUuid((quint16)0x2ACD)) {
+    } else if (characteristic.uuid() == QBluetoothUuid((quint16)ftmsparser::TREADMILL_DATA)) {
         lastPacket = newValue;
 
         // default flags for this treadmill is 84 04
-
-        union flags {
-            struct {
-
-                uint16_t moreData : 1;
-                uint16_t avgSpeed : 1;
-                uint16_t totalDistance : 1;
-                uint16_t inclination : 1;
-                uint16_t elevation : 1;
-                uint16_t instantPace : 1;
-                uint16_t averagePace : 1;
-                uint16_t expEnergy : 1;
-                uint16_t heartRate : 1;
-                uint16_t metabolic : 1;
-                uint16_t elapsedTime : 1;
-                uint16_t remainingTime : 1;
-                uint16_t forceBelt : 1;
-                uint16_t spare : 3;
-            };
-
-            uint16_t word_flags;
-        };
-
-        flags Flags;
-        int index = 0;
-        Flags.word_flags = (newValue.at(1) << 8) | newValue.at(0);
-        index += 2;
-
-        if (!Flags.moreData) {
-            Speed = ((double)(((uint16_t)((uint8_t)newValue.at(index + 1)) << 8) |
-                              (uint16_t)((uint8_t)newValue.at(index)))) /
-                    100.0;
-            index += 2;
-            emit debug(QStringLiteral("Current Speed: ") + QString::number(Speed.value()));
-        }
-
-        if (Flags.avgSpeed) {
-            double avgSpeed;
-            avgSpeed = ((double)(((uint16_t)((uint8_t)newValue.at(index + 1)) << 8) |
-                                 (uint16_t)((uint8_t)newValue.at(index)))) /
-                       100.0;
-            index += 2;
-            emit debug(QStringLiteral("Current Average Speed: ") + QString::number(avgSpeed));
+        ftmsparser::data d;
+        if (!ftmsparser::parse(ftmsparser::TREADMILL_DATA, newValue.constData(), newValue.length(), d)) {
+            LOG_DEVICE(QStringLiteral("truncated treadmill data"));
         }
 
-        if (Flags.totalDistance) {
-            // ignoring the distance, because it's a total life odometer
-            // Distance = ((double)((((uint32_t)((uint8_t)newValue.at(index + 2)) << 16) |
-            // (uint32_t)((uint8_t)newValue.at(index + 1)) << 8) | (uint32_t)((uint8_t)newValue.at(index)))) / 1000.0;
-            index += 3;
-        }
-        // else
-        {
-            Distance += ((Speed.value() / 3600000.0) *
-                         ((double)lastRefreshCharacteristicChanged.msecsTo(QDateTime::currentDateTime())));
+        if (d.has(ftmsparser::INSTANT_SPEED)) {
+            Speed = d[ftmsparser::INSTANT_SPEED];
+            LOG_DEVICE(QStringLiteral("Current Speed: ") + QString::number(Speed.value()));
         }
 
-        emit debug(QStringLiteral("Current Distance: ") + QString::number(Distance.value()));
+        // ignoring the total distance, because it's a total life odometer
+        Distance += ((Speed.value() / 3600000.0) *
+                     ((double)lastRefreshCharacteristicChanged.msecsTo(QDateTime::currentDateTime())));
 
-        if (Flags.inclination) {
-            Inclination = ((double)(((uint16_t)((uint8_t)newValue.at(index + 1)) << 8) |
-                                    (uint16_t)((uint8_t)newValue.at(index)))) /
-                          10.0;
-            index += 4; // the ramo value is useless
-            emit debug(QStringLiteral("Current Inclination: ") + QString::number(Inclination.value()));
-        }
+        LOG_DEVICE(QStringLiteral("Current Distance: ") + QString::number(Distance.value()));
 
-        if (Flags.elevation) {
-            index += 4; // TODO
+        if (d.has(ftmsparser::INCLINATION)) {
+            // the ramp value is useless
+            Inclination = d[ftmsparser::INCLINATION];
+            LOG_DEVICE(QStringLiteral("Current Inclination: ") + QString::number(Inclination.value()));
         }
 
-        if (Flags.instantPace) {
-            index += 1; // TODO
-        }
-
-        if (Flags.averagePace) {
-            index += 1; // TODO
-        }
-
-        if (Flags.expEnergy) {
-            KCal = ((double)(((uint16_t)((uint8_t)newValue.at(index + 1)) << 8) |
-                             (uint16_t)((uint8_t)newValue.at(index))));
-            index += 2;
-
-            // energy per hour
-            index += 2;
-
-            // energy per minute
-            index += 1;
+        if (d.has(ftmsparser::TOTAL_ENERGY)) {
+            KCal = d[ftmsparser::TOTAL_ENERGY];
         } else {
             if (watts(settings.value(QStringLiteral("weight"), 75.0).toFloat()))
                 KCal += ((((0.048 * ((double)watts(settings.value(QStringLiteral("weight"), 75.0).toFloat())) + 1.19) *
@@ -486,7 +423,7 @@ void solef80treadmill::characteristicChanged(const QLowEnergyCharacteristic &cha
                                                                 // kg * 3.5) / 200 ) / 60
         }
 
-        emit debug(QStringLiteral("Current KCal: ") + QString::number(KCal.value()));
+        LOG_DEVICE(QStringLiteral("Current KCal: ") + QString::number(KCal.value()));
 
 #ifdef Q_OS_ANDROID
         if (settings.value("ant_heart", false).toBool())
@@ -494,34 +431,12 @@ void solef80treadmill::characteristicChanged(const QLowEnergyCharacteristic &cha
         else
 #endif
         {
-            if (Flags.heartRate) {
-                if (index < newValue.length()) {
-
-                    heart = ((double)((newValue.at(index))));
-                    emit debug(QStringLiteral("Current Heart: ") + QString::number(heart));
-                } else {
-                    emit debug(QStringLiteral("Error on parsing heart!"));
-                }
-                // index += 1; //NOTE: clang-analyzer-deadcode.DeadStores
+            if (d.has(ftmsparser::HEART_RATE)) {
+                heart = d[ftmsparser::HEART_RATE];
+                LOG_DEVICE(QStringLiteral("Current Heart: ") + QString::number(heart));
             }
         }
 
-        if (Flags.metabolic) {
-            // todo
-        }
-
-        if (Flags.elapsedTime) {
-            // todo
-        }
-
-        if (Flags.remainingTime) {
-            // todo
-        }
-
-        if (Flags.forceBelt) {
-            // todo
-        }
-
         lastRefreshCharacteristicChanged = QDateTime::currentDateTime();
     }
 
@@ -555,7 +470,7 @@ void solef80treadmill::stateChanged(QLowEnergyService::ServiceState state) {
     bool inclination = settings.value(QStringLiteral("sole_treadmill_inclination"), false).toBool();
 
     QMetaEnum metaEnum = QMetaEnum::fromType<QLowEnergyService::ServiceState>();
-    emit debug(QStringLiteral("BTLE stateChanged ") + QString::fromLocal8Bit(metaEnum.valueToKey(state)));
+    LOG_DEVICE(QStringLiteral("BTLE stateChanged ") + QString::fromLocal8Bit(metaEnum.valueToKey(state)));
 
     for (QLowEnergyService *s : qAsConst(gattCommunicationChannelService)) {
         qDebug() << QStringLiteral("stateChanged") << s->serviceUuid() << s->state();
@@ -644,7 +559,7 @@ void solef80treadmill::stateChanged(QLowEnergyService::ServiceState state) {
         QSettings settings;
         bool virtual_device_enabled = settings.value(QStringLiteral("virtual_device_enabled"), true).toBool();
         if (virtual_device_enabled) {
-            emit debug(QStringLiteral("creating virtual treadmill interface..."));
+            LOG_DEVICE(QStringLiteral("creating virtual treadmill interface..."));
 
             virtualTreadmill = new virtualtreadmill(this, noHeartService);
             connect(virtualTreadmill, &virtualtreadmill::debug, this, &solef80treadmill::debug);
@@ -663,7 +578,7 @@ void solef80treadmill::changeInclinationRequested(double grade, double percentag
 }
 
 void solef80treadmill::descriptorWritten(const QLowEnergyDescriptor &descriptor, const QByteArray &newValue) {
-    emit debug(QStringLiteral("descriptorWritten ") + descriptor.name() + QStringLiteral(" ") + newValue.toHex(' '));
+    LOG_PACKET(QStringLiteral("descriptorWritten ") + descriptor.name() + QStringLiteral(" ") + newValue.toHex(' '));
 
     initRequest = true;
     emit connectedAndDiscovered();
@@ -676,7 +591,7 @@ void solef80treadmill::descriptorRead(const QLowEnergyDescriptor &descriptor, co
 void solef80treadmill::characteristicWritten(const QLowEnergyCharacteristic &characteristic,
                                              const QByteArray &newValue) {
     Q_UNUSED(characteristic);
-    emit debug(QStringLiteral("characteristicWritten ") + newValue.toHex(' '));
+    LOG_PACKET(QStringLiteral("characteristicWritten ") + newValue.toHex(' '));
 }
 
 void solef80treadmill::characteristicRead(const QLowEnergyCharacteristic &characteristic, const QByteArray &newValue) {
@@ -684,7 +599,7 @@ void solef80treadmill::characteristicRead(const QLowEnergyCharacteristic &charac
 }
 
 void solef80treadmill::serviceScanDone(void) {
-    emit debug(QStringLiteral("serviceScanDone"));
+    LOG_DEVICE(QStringLiteral("serviceScanDone"));
 
     initRequest = false;
     firstStateChanged = 0;
@@ -700,20 +615,20 @@ void solef80treadmill::serviceScanDone(void) {
 void solef80treadmill::errorService(QLowEnergyService::ServiceError err) {
 
     QMetaEnum metaEnum = QMetaEnum::fromType<QLowEnergyService::ServiceError>();
-    emit debug(QStringLiteral("solef80treadmill::errorService") + QString::fromLocal8Bit(metaEnum.valueToKey(err)) +
+    LOG_DEVICE(QStringLiteral("solef80treadmill::errorService") + QString::fromLocal8Bit(metaEnum.valueToKey(err)) +
                m_control->errorString());
 }
 
 void solef80treadmill::error(QLowEnergyController::Error err) {
 
     QMetaEnum metaEnum = QMetaEnum::fromType<QLowEnergyController::Error>();
-    emit debug(QStringLiteral("solef80treadmill::error") + QString::fromLocal8Bit(metaEnum.valueToKey(err)) +
+    LOG_DEVICE(QStringLiteral("solef80treadmill::error") + QString::fromLocal8Bit(metaEnum.valueToKey(err)) +
                m_control->errorString());
 }
 
 void solef80treadmill::deviceDiscovered(const QBluetoothDeviceInfo &device) {
 
-    emit debug(QStringLiteral("Found new device: ") + device.name() + QStringLiteral(" (") +
+    LOG_DEVICE(QStringLiteral("Found new device: ") + device.name() + QStringLiteral(" (") +
                device.address().toString() + ')');
     {
         bluetoothDevice = device;
@@ -734,17 +649,17 @@ void solef80treadmill::deviceDiscovered(const QBluetoothDeviceInfo &device) {
                 this, [this](QLowEnergyController::Error error) {
                     Q_UNUSED(error);
                     Q_UNUSED(this);
-                    emit debug(QStringLiteral("Cannot connect to remote device."));
+                    LOG_DEVICE(QStringLiteral("Cannot connect to remote device."));
                     emit disconnected();
                 });
         connect(m_control, &QLowEnergyController::connected, this, [this]() {
             Q_UNUSED(this);
-            emit debug(QStringLiteral("Controller connected. Search services..."));
+            LOG_DEVICE(QStringLiteral("Controller connected. Search services..."));
             m_control->discoverServices();
         });
         connect(m_control, &QLowEnergyController::disconnected, this, [this]() {
             Q_UNUSED(this);
-            emit debug(QStringLiteral("LowEnergy controller disconnected"));
+            LOG_DEVICE(QStringLiteral("LowEnergy controller disconnected"));
             emit disconnected();
         });
 
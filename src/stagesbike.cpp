@@ -1,4 +1,5 @@
 #include "stagesbike.h"
+#include "logging.h"
 #include "ios/lockscreen.h"
 #include "virtualbike.h"
 #include <QBluetoothLocalDevice>
@@ -46,6 +47,7 @@ wait_for_response)
         timeout.singleShot(300, &loop, SLOT(quit()));
     }
 
+    writeRequested(QByteArray((const char *)data, data_len));
     gattCommunicationChannelService->writeCharacteristic(gattWriteCharacteristic, QByteArray((const char*)data,
 data_len));
 
@@ -69,6 +71,11 @@ void stagesbike::update() {
                                                                            // gattWriteCharacteristic.isValid() &&
                                                                            // gattNotify1Characteristic.isValid() &&
                /*initDone*/) {
+        // the cadence has to decay to 0 also when the power meter stops notifying
+        if ((crankDecoder.active() || wheelDecoder.active()) &&
+            lastRefreshCharacteristicChanged.msecsTo(QDateTime::currentDateTime()) > 1000) {
+            updateRates();
+        }
         update_metrics(false, watts());
 
         // updating the treadmill console every second
@@ -85,13 +92,13 @@ void stagesbike::update() {
             }
 
             if (requestResistance != currentResistance().value()) {
-                emit debug(QStringLiteral("writing resistance ") + QString::number(requestResistance));
+                LOG_DEVICE(QStringLiteral("writing resistance ") + QString::number(requestResistance));
                 // forceResistance(requestResistance);
             }
             requestResistance = -1;
         }
         if (requestStart != -1) {
-            emit debug(QStringLiteral("starting..."));
+            LOG_DEVICE(QStringLiteral("starting..."));
 
             // btinit();
 
@@ -99,15 +106,47 @@ void stagesbike::update() {
             emit bikeStarted();
         }
         if (requestStop != -1) {
-            emit debug(QStringLiteral("stopping..."));
+            LOG_DEVICE(QStringLiteral("stopping..."));
             // writeCharacteristic(initDataF0C800B8, sizeof(initDataF0C800B8), "stop tape");
             requestStop = -1;
         }
     }
 }
 
+void stagesbike::updateRates() {
+    QSettings settings;
+    if (settings.value(QStringLiteral("cadence_sensor_name"), QStringLiteral("Disabled"))
+            .toString()
+            .startsWith(QStringLiteral("Disabled"))) {
+        // the real events are forwarded to the virtual device
+        if (crankDecoder.active()) {
+            Cadence = crankDecoder.rpm();
+            CrankRevs = crankDecoder.revolutions();
+            LastCrankEventTime = crankDecoder.lastEventTime();
+        } else {
+            // power meters with only the wheel data have always been used for the cadence
+            Cadence = wheelDecoder.rpm();
+            CrankRevs = wheelDecoder.revolutions();
+            LastCrankEventTime = wheelDecoder.lastEventTime();
+        }
+    }
+    LOG_DEVICE(QStringLiteral("Current Cadence: ") + QString::number(Cadence.value()));
+
+    if (!settings.value(QStringLiteral("speed_power_based"), false).toBool()) {
+        if (wheelDecoder.active()) {
+            Speed = wheelDecoder.rpm() *
+                    settings.value(QStringLiteral("csc_wheel_circumference"), 2000.0).toDouble() * 60.0 / 1000000.0;
+        } else {
+            Speed = Cadence.value() * settings.value(QStringLiteral("cadence_sensor_speed_ratio"), 0.33).toDouble();
+        }
+    } else {
+        Speed = metric::calculateSpeedFromPower(m_watt.value());
+    }
+    LOG_DEVICE(QStringLiteral("Current Speed: ") + QString::number(Speed.value()));
+}
+
 void stagesbike::serviceDiscovered(const QBluetoothUuid &gatt) {
-    emit debug(QStringLiteral("serviceDiscovered ") + gatt.toString());
+    LOG_DEVICE(QStringLiteral("serviceDiscovered ") + gatt.toString());
 }
 
 void stagesbike::characteristicChanged(const QLowEnergyCharacteristic &characteristic, const QByteArray &newValue) {
@@ -117,15 +156,12 @@ void stagesbike::characteristicChanged(const QLowEnergyCharacteristic &character
     QString heartRateBeltName =
         settings.value(QStringLiteral("heart_rate_belt_name"), QStringLiteral("Disabled")).toString();
 
-    emit debug(QStringLiteral(" << ") + newValue.toHex(' '));
+    LOG_PACKET(QStringLiteral(" << ") + newValue.toHex(' '));
 
     if (characteristic.uuid() == QBluetoothUuid::CyclingPowerMeasurement) {
         lastPacket = newValue;
 
         uint16_t flags = (((uint16_t)((uint8_t)newValue.at(1)) << 8) | (uint16_t)((uint8_t)newValue.at(0)));
-        bool cadence_present = false;
-        bool wheel_revs = false;
-        uint16_t time_division = 1024;
         uint8_t index = 4;
 
         if (newValue.length() > 3) {
@@ -133,7 +169,7 @@ void stagesbike::characteristicChanged(const QLowEnergyCharacteristic &character
         }
 
         emit powerChanged(m_watt.value());
-        emit debug(QStringLiteral("Current watt: ") + QString::number(m_watt.value()));
+        LOG_DEVICE(QStringLiteral("Current watt: ") + QString::number(m_watt.value()));
 
         if ((flags & 0x1) == 0x01) // Pedal Power Balance Present
         {
@@ -150,65 +186,32 @@ void stagesbike::characteristicChanged(const QLowEnergyCharacteristic &character
         {
         }
 
-        if ((flags & 0x10) == 0x10) // Wheel Revolution Data Present
-        {
-            cadence_present = true;
-            wheel_revs = true;
-            time_division = 2048;
-        } else if ((flags & 0x20) == 0x20) // Crank Revolution Data Present
+        if ((flags & 0x10) == 0x10 && newValue.length() >= index + 6) // Wheel Revolution Data Present
         {
-            cadence_present = true;
+            uint32_t wheelRevs =
+                (((uint32_t)((uint8_t)newValue.at(index + 3)) << 24) |
+                 ((uint32_t)((uint8_t)newValue.at(index + 2)) << 16) |
+                 ((uint32_t)((uint8_t)newValue.at(index + 1)) << 8) | (uint32_t)((uint8_t)newValue.at(index)));
+            uint16_t wheelTime =
+                (((uint16_t)((uint8_t)newValue.at(index + 5)) << 8) | (uint16_t)((uint8_t)newValue.at(index + 4)));
+            wheelDecoder.push(wheelRevs, wheelTime);
+            index += 6;
         }
-
-        if (cadence_present) {
-            if (!wheel_revs) {
-                CrankRevs =
-                    (((uint16_t)((uint8_t)newValue.at(index + 1)) << 8) | (uint16_t)((uint8_t)newValue.at(index)));
-                index += 2;
-            } else {
-                CrankRevs =
-                    (((uint32_t)((uint8_t)newValue.at(index + 3)) << 24) |
-                     ((uint32_t)((uint8_t)newValue.at(index + 2)) << 16) |
-                     ((uint32_t)((uint8_t)newValue.at(index + 1)) << 8) | (uint32_t)((uint8_t)newValue.at(index)));
-                index += 4;
-            }
-            LastCrankEventTime =
+        if ((flags & 0x20) == 0x20 && newValue.length() >= index + 4) // Crank Revolution Data Present
+        {
+            uint16_t crankRevs =
                 (((uint16_t)((uint8_t)newValue.at(index + 1)) << 8) | (uint16_t)((uint8_t)newValue.at(index)));
+            uint16_t crankTime =
+                (((uint16_t)((uint8_t)newValue.at(index + 3)) << 8) | (uint16_t)((uint8_t)newValue.at(index + 2)));
+            crankDecoder.push(crankRevs, crankTime);
+        }
 
-            int16_t deltaT = LastCrankEventTime - oldLastCrankEventTime;
-            if (deltaT < 0) {
-                deltaT = LastCrankEventTime + time_division - oldLastCrankEventTime;
-            }
-
-            if (settings.value(QStringLiteral("cadence_sensor_name"), QStringLiteral("Disabled"))
-                    .toString()
-                    .startsWith(QStringLiteral("Disabled"))) {
-                if (CrankRevs != oldCrankRevs && deltaT) {
-                    double cadence = ((CrankRevs - oldCrankRevs) / deltaT) * time_division * 60;
-                    if (cadence >= 0) {
-                        Cadence = cadence;
-                    }
-                    lastGoodCadence = QDateTime::currentDateTime();
-                } else if (lastGoodCadence.msecsTo(QDateTime::currentDateTime()) > 2000) {
-                    Cadence = 0;
-                }
-            }
-
-            emit debug(QStringLiteral("Current Cadence: ") + QString::number(Cadence.value()));
-
-            oldLastCrankEventTime = LastCrankEventTime;
-            oldCrankRevs = CrankRevs;
-
-            if (!settings.value(QStringLiteral("speed_power_based"), false).toBool()) {
-                Speed = Cadence.value() * settings.value(QStringLiteral("cadence_sensor_speed_ratio"), 0.33).toDouble();
-            } else {
-                Speed = metric::calculateSpeedFromPower(m_watt.value());
-            }
-            emit debug(QStringLiteral("Current Speed: ") + QString::number(Speed.value()));
+        if (crankDecoder.active() || wheelDecoder.active()) {
+            updateRates();
 
             Distance += ((Speed.value() / 3600000.0) *
                          ((double)lastRefreshCharacteristicChanged.msecsTo(QDateTime::currentDateTime())));
-            emit debug(QStringLiteral("Current Distance: ") + QString::number(Distance.value()));
+            LOG_DEVICE(QStringLiteral("Current Distance: ") + QString::number(Distance.value()));
 
             // Resistance = ((double)(((uint16_t)((uint8_t)newValue.at(index + 1)) << 8) |
             // (uint16_t)((uint8_t)newValue.at(index)))); debug("Current Resistance: " +
@@ -223,7 +226,7 @@ void stagesbike::characteristicChanged(const QLowEnergyCharacteristic &character
                      (60000.0 / ((double)lastRefreshCharacteristicChanged.msecsTo(
                                     QDateTime::currentDateTime())))); //(( (0.048* Output in watts +1.19) * body weight
                                                                       // in kg * 3.5) / 200 ) / 60
-            emit debug(QStringLiteral("Current KCal: ") + QString::number(KCal.value()));
+            LOG_DEVICE(QStringLiteral("Current KCal: ") + QString::number(KCal.value()));
         }
     }
 
@@ -248,11 +251,6 @@ void stagesbike::characteristicChanged(const QLowEnergyCharacteristic &character
         }
     }
 
-    if (Cadence.value() > 0) {
-        CrankRevs++;
-        LastCrankEventTime += (uint16_t)(1024.0 / (((double)(Cadence.value())) / 60.0));
-    }
-
     lastRefreshCharacteristicChanged = QDateTime::currentDateTime();
 
     if (!noVirtualDevice) {
@@ -268,8 +266,8 @@ void stagesbike::characteristicChanged(const QLowEnergyCharacteristic &character
 #endif
     }
 
-    emit debug(QStringLiteral("Current CrankRevs: ") + QString::number(CrankRevs));
-    emit debug(QStringLiteral("Last CrankEventTime: ") + QString::number(LastCrankEventTime));
+    LOG_DEVICE(QStringLiteral("Current CrankRevs: ") + QString::number(CrankRevs));
+    LOG_DEVICE(QStringLiteral("Last CrankEventTime: ") + QString::number(LastCrankEventTime));
 
     if (m_control->error() != QLowEnergyController::NoError) {
         qDebug() << QStringLiteral("QLowEnergyController ERROR!!") << m_control->errorString();
@@ -278,7 +276,7 @@ void stagesbike::characteristicChanged(const QLowEnergyCharacteristic &character
 
 void stagesbike::stateChanged(QLowEnergyService::ServiceState state) {
     QMetaEnum metaEnum = QMetaEnum::fromType<QLowEnergyService::ServiceState>();
-    emit debug(QStringLiteral("BTLE stateChanged ") + QString::fromLocal8Bit(metaEnum.valueToKey(state)));
+    LOG_DEVICE(QStringLiteral("BTLE stateChanged ") + QString::fromLocal8Bit(metaEnum.valueToKey(state)));
 
     for (QLowEnergyService *s : qAsConst(gattCommunicationChannelService)) {
         qDebug() << QStringLiteral("stateChanged") << s->serviceUuid() << s->state();
@@ -371,7 +369,7 @@ void stagesbike::stateChanged(QLowEnergyService::ServiceState state) {
 #endif
 #endif
             if (virtual_device_enabled) {
-            emit debug(QStringLiteral("creating virtual bike interface..."));
+            LOG_DEVICE(QStringLiteral("creating virtual bike interface..."));
             virtualBike = new virtualbike(this, noWriteResistance, noHeartService);
             // connect(virtualBike,&virtualbike::debug ,this,&stagesbike::debug);
             connect(virtualBike, &virtualbike::changeInclination, this, &stagesbike::inclinationChanged);
@@ -382,7 +380,7 @@ void stagesbike::stateChanged(QLowEnergyService::ServiceState state) {
 }
 
 void stagesbike::descriptorWritten(const QLowEnergyDescriptor &descriptor, const QByteArray &newValue) {
-    emit debug(QStringLiteral("descriptorWritten ") + descriptor.name() + QStringLiteral(" ") + newValue.toHex(' '));
+    LOG_PACKET(QStringLiteral("descriptorWritten ") + descriptor.name() + QStringLiteral(" ") + newValue.toHex(' '));
 
     initRequest = true;
     emit connectedAndDiscovered();
@@ -394,7 +392,7 @@ void stagesbike::descriptorRead(const QLowEnergyDescriptor &descriptor, const QB
 
 void stagesbike::characteristicWritten(const QLowEnergyCharacteristic &characteristic, const QByteArray &newValue) {
     Q_UNUSED(characteristic);
-    emit debug(QStringLiteral("characteristicWritten ") + newValue.toHex(' '));
+    LOG_PACKET(QStringLiteral("characteristicWritten ") + newValue.toHex(' '));
 }
 
 void stagesbike::characteristicRead(const QLowEnergyCharacteristic &characteristic, const QByteArray &newValue) {
@@ -402,7 +400,7 @@ void stagesbike::characteristicRead(const QLowEnergyCharacteristic &characterist
 }
 
 void stagesbike::serviceScanDone(void) {
-    emit debug(QStringLiteral("serviceScanDone"));
+    LOG_DEVICE(QStringLiteral("serviceScanDone"));
 
 #ifdef Q_OS_ANDROID
     QLowEnergyConnectionParameters c;
@@ -423,18 +421,18 @@ void stagesbike::serviceScanDone(void) {
 
 void stagesbike::errorService(QLowEnergyService::ServiceError err) {
     QMetaEnum metaEnum = QMetaEnum::fromType<QLowEnergyService::ServiceError>();
-    emit debug(QStringLiteral("stagesbike::errorService") + QString::fromLocal8Bit(metaEnum.valueToKey(err)) +
+    LOG_DEVICE(QStringLiteral("stagesbike::errorService") + QString::fromLocal8Bit(metaEnum.valueToKey(err)) +
                m_control->errorString());
 }
 
 void stagesbike::error(QLowEnergyController::Error err) {
     QMetaEnum metaEnum = QMetaEnum::fromType<QLowEnergyController::Error>();
-    emit debug(QStringLiteral("stagesbike::error") + QString::fromLocal8Bit(metaEnum.valueToKey(err)) +
+    LOG_DEVICE(QStringLiteral("stagesbike::error") + QString::fromLocal8Bit(metaEnum.valueToKey(err)) +
                m_control->errorString());
 }
 
 void stagesbike::deviceDiscovered(const QBluetoothDeviceInfo &device) {
-    emit debug(QStringLiteral("Found new device: ") + device.name() + QStringLiteral(" (") +
+    LOG_DEVICE(QStringLiteral("Found new device: ") + device.name() + QStringLiteral(" (") +
                device.address().toString() + ')');
     {
         bluetoothDevice = device;
@@ -452,17 +450,17 @@ void stagesbike::deviceDiscovered(const QBluetoothDeviceInfo &device) {
                 this, [this](QLowEnergyController::Error error) {
                     Q_UNUSED(error);
                     Q_UNUSED(this);
-                    emit debug(QStringLiteral("Cannot connect to remote device."));
+                    LOG_DEVICE(QStringLiteral("Cannot connect to remote device."));
                     emit disconnected();
                 });
         connect(m_control, &QLowEnergyController::connected, this, [this]() {
             Q_UNUSED(this);
-            emit debug(QStringLiteral("Controller connected. Search services..."));
+            LOG_DEVICE(QStringLiteral("Controller connected. Search services..."));
             m_control->discoverServices();
         });
         connect(m_control, &QLowEnergyController::disconnected, this, [this]() {
             Q_UNUSED(this);
-            emit debug(QStringLiteral("LowEnergy controller disconnected"));
+            LOG_DEVICE(QStringLiteral("LowEnergy controller disconnected"));
             emit disconnected();
         });
 
@@ -0,0 +1,200 @@
+#include "statepublisher.h"
+#include "qdebugfixup.h"
+#include <QDateTime>
+#include <QFile>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QSaveFile>
+#include <QSettings>
+#include <atomic>
+#include <cstring>
+
+statepublisher::statepublisher(QObject *parent) : QObject(parent) {
+    QSettings settings;
+    rate = qMax(100, settings.value(QStringLiteral("status_file_rate"), 1000).toInt());
+    xml = settings.value(QStringLiteral("status_file_xml"), true).toBool();
+    json = settings.value(QStringLiteral("status_file_json"), false).toBool();
+
+    if (settings.value(QStringLiteral("status_shared_memory"), false).toBool()) {
+        shm = new QSharedMemory(STATEPUBLISHER_SHM_KEY, this);
+        // a segment left by a crashed instance is reused
+        if (!shm->create(sizeof(statepublisher_record)) &&
+            !(shm->error() == QSharedMemory::AlreadyExists && shm->attach())) {
+            qDebug() << QStringLiteral("statepublisher: unable to create the shared memory") << shm->errorString();
+            delete shm;
+            shm = nullptr;
+        } else {
+            memset(shm->data(), 0, sizeof(statepublisher_record));
+        }
+    }
+
+    connect(&timer, &QTimer::timeout, this, &statepublisher::onTimeout);
+    timer.setSingleShot(false);
+}
+
+statepublisher::~statepublisher() { removeFiles(); }
+
+void statepublisher::setDevice(bluetoothdevice *device) {
+    this->device = device;
+    published = false;
+    if (device) {
+        timer.start(rate);
+    } else {
+        timer.stop();
+    }
+}
+
+void statepublisher::removeFiles() {
+    if (xml) {
+        QFile::remove(STATEPUBLISHER_XML_FILE);
+    }
+    if (json) {
+        QFile::remove(STATEPUBLISHER_JSON_FILE);
+    }
+}
+
+bool statepublisher::snapshot::operator==(const snapshot &o) const {
+    return deviceType == o.deviceType && speed == o.speed && inclination == o.inclination && watts == o.watts &&
+           heart == o.heart && cadence == o.cadence && resistance == o.resistance && distance == o.distance &&
+           calories == o.calories && elapsed == o.elapsed;
+}
+
+statepublisher::snapshot statepublisher::take() const {
+    snapshot s;
+    s.deviceType = device->deviceType();
+    s.speed = device->currentSpeed().value();
+    s.inclination = device->currentInclination().value();
+    s.watts = device->wattsMetric().value();
+    s.heart = device->currentHeart().value();
+    s.cadence = device->currentCadence().value();
+    s.resistance = device->currentResistance().value();
+    s.distance = device->odometer();
+    s.calories = device->calories().value();
+    s.elapsed = QTime(0, 0, 0).secsTo(device->elapsedTime());
+    return s;
+}
+
+void statepublisher::requestUpdate() {
+    if (!device) {
+        return;
+    }
+    // the signals from the device can arrive much faster than the configured rate: the timer will catch them up
+    if (!lastPublish.isValid() || lastPublish.elapsed() >= rate) {
+        publish();
+    }
+}
+
+void statepublisher::onTimeout() {
+    if (!device) {
+        return;
+    }
+    publish();
+}
+
+void statepublisher::publish() {
+    snapshot s = take();
+    if (published && s == lastSnapshot) {
+        return;
+    }
+
+    QDateTime now = QDateTime::currentDateTime();
+    QString updated = now.toString();
+    if (xml) {
+        writeXml(s, updated);
+    }
+    if (json) {
+        writeJson(s, updated);
+    }
+    if (shm) {
+        writeSharedMemory(s, now.toMSecsSinceEpoch());
+    }
+
+    lastSnapshot = s;
+    published = true;
+    lastPublish.start();
+}
+
+QString statepublisher::elementName(bluetoothdevice::BLUETOOTH_TYPE type) {
+    switch (type) {
+    case bluetoothdevice::TREADMILL:
+        return QStringLiteral("Treadmill");
+    case bluetoothdevice::BIKE:
+        return QStringLiteral("Bike");
+    case bluetoothdevice::ROWING:
+        return QStringLiteral("Rower");
+    case bluetoothdevice::ELLIPTICAL:
+        return QStringLiteral("Elliptical");
+    default:
+        return QStringLiteral("Device");
+    }
+}
+
+void statepublisher::writeXml(const snapshot &s, const QString &updated) {
+    // same document that QDomDocument was producing, with the new attributes appended
+    QString doc = QStringLiteral("<Gym Updated=\"%1\">\n <%2 Speed=\"%3\" Incline=\"%4\" Watt=\"%5\" Heart=\"%6\" "
+                                 "Cadence=\"%7\" Resistance=\"%8\" Distance=\"%9\"")
+                      .arg(updated.toHtmlEscaped(), elementName(s.deviceType), QString::number(s.speed, 'f', 1),
+                           QString::number(s.inclination, 'f', 1), QString::number(s.watts, 'f', 0),
+                           QString::number(s.heart, 'f', 0), QString::number(s.cadence, 'f', 0),
+                           QString::number(s.resistance, 'f', 0), QString::number(s.distance, 'f', 3)) +
+                  QStringLiteral(" Calories=\"%1\" Elapsed=\"%2\"/>\n</Gym>\n")
+                      .arg(QString::number(s.calories, 'f', 1), QString::number(s.elapsed, 'f', 0));
+
+    QSaveFile f(STATEPUBLISHER_XML_FILE);
+    if (!f.open(QIODevice::WriteOnly | QIODevice::Text)) {
+        qDebug() << QStringLiteral("Open status.xml for writing failed");
+        return;
+    }
+    f.write(doc.toUtf8());
+    if (!f.commit()) {
+        qDebug() << QStringLiteral("status.xml commit failed") << f.errorString();
+    }
+}
+
+void statepublisher::writeJson(const snapshot &s, const QString &updated) {
+    QJsonObject obj;
+    obj[QStringLiteral("updated")] = updated;
+    obj[QStringLiteral("device")] = elementName(s.deviceType);
+    obj[QStringLiteral("speed")] = s.speed;
+    obj[QStringLiteral("inclination")] = s.inclination;
+    obj[QStringLiteral("watts")] = s.watts;
+    obj[QStringLiteral("heart")] = s.heart;
+    obj[QStringLiteral("cadence")] = s.cadence;
+    obj[QStringLiteral("resistance")] = s.resistance;
+    obj[QStringLiteral("distance")] = s.distance;
+    obj[QStringLiteral("calories")] = s.calories;
+    obj[QStringLiteral("elapsed")] = s.elapsed;
+
+    QSaveFile f(STATEPUBLISHER_JSON_FILE);
+    if (!f.open(QIODevice::WriteOnly)) {
+        qDebug() << QStringLiteral("Open status.json for writing failed");
+        return;
+    }
+    f.write(QJsonDocument(obj).toJson(QJsonDocument::Compact));
+    if (!f.commit()) {
+        qDebug() << QStringLiteral("status.json commit failed") << f.errorString();
+    }
+}
+
+void statepublisher::writeSharedMemory(const snapshot &s, int64_t updated) {
+    statepublisher_record *r = static_cast<statepublisher_record *>(shm->data());
+    uint32_t sequence = r->sequence + 1;
+
+    r->sequence = sequence; // odd: update in progress
+    std::atomic_thread_fence(std::memory_order_release);
+    r->magic = STATEPUBLISHER_SHM_MAGIC;
+    r->version = 1;
+    r->deviceType = (uint32_t)s.deviceType;
+    r->updated = updated;
+    r->speed = s.speed;
+    r->inclination = s.inclination;
+    r->watts = s.watts;
+    r->heart = s.heart;
+    r->cadence = s.cadence;
+    r->resistance = s.resistance;
+    r->distance = s.distance;
+    r->calories = s.calories;
+    r->elapsed = s.elapsed;
+    std::atomic_thread_fence(std::memory_order_release);
+    r->sequence = sequence + 1; // even: record consistent
+}
@@ -0,0 +1,84 @@
+#ifndef STATEPUBLISHER_H
+#define STATEPUBLISHER_H
+
+#include <QElapsedTimer>
+#include <QObject>
+#include <QSharedMemory>
+#include <QTimer>
+
+#include "bluetoothdevice.h"
+
+#define STATEPUBLISHER_XML_FILE QStringLiteral("status.xml")
+#define STATEPUBLISHER_JSON_FILE QStringLiteral("status.json")
+#define STATEPUBLISHER_SHM_KEY QStringLiteral("qdomyos-zwift-status")
+#define STATEPUBLISHER_SHM_MAGIC 0x54535A51 // "QZST"
+
+// Layout of the optional shared memory segment. There is a single writer: the sequence is odd while the record is
+// being updated, so a reader copies the record and retries if the sequence was odd or changed during the copy.
+struct statepublisher_record {
+    uint32_t magic;
+    uint32_t version;
+    uint32_t sequence;
+    uint32_t deviceType;
+    int64_t updated; // ms since epoch
+    double speed;
+    double inclination;
+    double watts;
+    double heart;
+    double cadence;
+    double resistance;
+    double distance;
+    double calories;
+    double elapsed;
+};
+
+// Publishes the current state of the device for external tools. Updates are coalesced to the configured rate and
+// the files are replaced atomically (temp file + rename), so a reader never sees a partial file.
+class statepublisher : public QObject {
+    Q_OBJECT
+  public:
+    explicit statepublisher(QObject *parent = nullptr);
+    ~statepublisher();
+    void setDevice(bluetoothdevice *device);
+    void removeFiles();
+
+  public slots:
+    void requestUpdate();
+
+  private:
+    struct snapshot {
+        bluetoothdevice::BLUETOOTH_TYPE deviceType = bluetoothdevice::UNKNOWN;
+        double speed = 0;
+        double inclination = 0;
+        double watts = 0;
+        double heart = 0;
+        double cadence = 0;
+        double resistance = 0;
+        double distance = 0;
+        double calories = 0;
+        double elapsed = 0;
+        bool operator==(const snapshot &o) const;
+    };
+
+    snapshot take() const;
+    void publish();
+    void writeXml(const snapshot &s, const QString &updated);
+    void writeJson(const snapshot &s, const QString &updated);
+    void writeSharedMemory(const snapshot &s, int64_t updated);
+    static QString elementName(bluetoothdevice::BLUETOOTH_TYPE type);
+
+    bluetoothdevice *device = nullptr;
+    QTimer timer;
+    QElapsedTimer lastPublish;
+    snapshot lastSnapshot;
+    bool published = false;
+    int rate = 1000;
+    bool xml = true;
+    bool json = false;
+    QSharedMemory *shm = nullptr;
+
+  private slots:
+    void onTimeout();
+};
+
+#endif // STATEPUBLISHER_H
@@ -1,4 +1,5 @@
 #include "strydrunpowersensor.h"
+#include "logging.h"
 #include "ios/lockscreen.h"
 #include "virtualbike.h"
 #include <QBluetoothLocalDevice>
@@ -80,7 +81,7 @@ void strydrunpowersensor::update() {
 }
 
 void strydrunpowersensor::serviceDiscovered(const QBluetoothUuid &gatt) {
-    emit debug(QStringLiteral("serviceDiscovered ") + gatt.toString());
+    LOG_DEVICE(QStringLiteral("serviceDiscovered ") + gatt.toString());
 }
 
 void strydrunpowersensor::characteristicChanged(const QLowEnergyCharacteristic &characteristic,
@@ -92,15 +93,12 @@ void strydrunpowersensor::characteristicChanged(const QLowEnergyCharacteristic &
     QString heartRateBeltName =
         settings.value(QStringLiteral("heart_rate_belt_name"), QStringLiteral("Disabled")).toString();
 
-    emit debug(QStringLiteral(" << ") + newValue.toHex(' '));
+    LOG_PACKET(QStringLiteral(" << ") + newValue.toHex(' '));
 
     if (characteristic.uuid() == QBluetoothUuid::CyclingPowerMeasurement) {
         lastPacket = newValue;
 
         uint16_t flags = (((uint16_t)((uint8_t)newValue.at(1)) << 8) | (uint16_t)((uint8_t)newValue.at(0)));
-        bool cadence_present = false;
-        bool wheel_revs = false;
-        uint16_t time_division = 1024;
         uint8_t index = 4;
 
         if (newValue.length() > 3) {
@@ -108,7 +106,7 @@ void strydrunpowersensor::characteristicChanged(const QLowEnergyCharacteristic &
         }
 
         emit powerChanged(m_watt.value());
-        emit debug(QStringLiteral("Current watt: ") + QString::number(m_watt.value()));
+        LOG_DEVICE(QStringLiteral("Current watt: ") + QString::number(m_watt.value()));
 
         if ((flags & 0x1) == 0x01) // Pedal Power Balance Present
         {
@@ -127,12 +125,21 @@ void strydrunpowersensor::characteristicChanged(const QLowEnergyCharacteristic &
 
         if ((flags & 0x10) == 0x10) // Wheel Revolution Data Present
         {
-            cadence_present = true;
-            wheel_revs = true;
-            time_division = 2048;
-        } else if ((flags & 0x20) == 0x20) // Crank Revolution Data Present
+            index += 6;
+        }
+        if ((flags & 0x20) == 0x20 && newValue.length() >= index + 4) // Crank Revolution Data Present
         {
-            cadence_present = true;
+            uint16_t crankRevs =
+                (((uint16_t)((uint8_t)newValue.at(index + 1)) << 8) | (uint16_t)((uint8_t)newValue.at(index)));
+            uint16_t crankTime =
+                (((uint16_t)((uint8_t)newValue.at(index + 3)) << 8) | (uint16_t)((uint8_t)newValue.at(index + 2)));
+            crankDecoder.push(crankRevs, crankTime);
+        }
+        // the running cadence of the RSC measurement wins if both are notified
+        if (crankDecoder.active() && !rscCadence) {
+            Cadence = crankDecoder.rpm();
+            emit cadenceChanged(Cadence.value());
+            LOG_DEVICE(QStringLiteral("Current Cadence: ") + QString::number(Cadence.value()));
         }
 
         if (watts())
@@ -140,7 +147,7 @@ void strydrunpowersensor::characteristicChanged(const QLowEnergyCharacteristic &
                        3.5) /
                       200.0) /
                      (60000.0 / ((double)lastRefreshPowerChanged.msecsTo(QDateTime::currentDateTime()))));
-        emit debug(QStringLiteral("Current KCal: ") + QString::number(KCal.value()));
+        LOG_DEVICE(QStringLiteral("Current KCal: ") + QString::number(KCal.value()));
         lastRefreshPowerChanged = QDateTime::currentDateTime();
 
     } else if (characteristic.uuid() == QBluetoothUuid::RSCMeasurement) {
@@ -158,6 +165,7 @@ void strydrunpowersensor::characteristicChanged(const QLowEnergyCharacteristic &
         double speed = (((double)speedMs) / 256.0) * 3.6; // km/h
         double cadence = (uint8_t)newValue.at(3)  * cadence_multiplier;
 
+        rscCadence = true;
         Cadence = cadence;
         emit cadenceChanged(cadence);
         if(power_as_treadmill) {
@@ -166,10 +174,10 @@ void strydrunpowersensor::characteristicChanged(const QLowEnergyCharacteristic &
             emit speedChanged(speed);
             Distance +=
                 ((Speed.value() / 3600000.0) * ((double)lastRefreshCadenceChanged.msecsTo(QDateTime::currentDateTime())));
-            emit debug(QStringLiteral("Current Distance: ") + QString::number(Distance.value()));
-            emit debug(QStringLiteral("Current Speed: ") + QString::number(speed));
+            LOG_DEVICE(QStringLiteral("Current Distance: ") + QString::number(Distance.value()));
+            LOG_DEVICE(QStringLiteral("Current Speed: ") + QString::number(speed));
         }
-        emit debug(QStringLiteral("Current Cadence: ") + QString::number(cadence));
+        LOG_DEVICE(QStringLiteral("Current Cadence: ") + QString::number(cadence));
         lastRefreshCadenceChanged = QDateTime::currentDateTime();
     }
 
@@ -214,7 +222,7 @@ void strydrunpowersensor::characteristicChanged(const QLowEnergyCharacteristic &
 
 void strydrunpowersensor::stateChanged(QLowEnergyService::ServiceState state) {
     QMetaEnum metaEnum = QMetaEnum::fromType<QLowEnergyService::ServiceState>();
-    emit debug(QStringLiteral("BTLE stateChanged ") + QString::fromLocal8Bit(metaEnum.valueToKey(state)));
+    LOG_DEVICE(QStringLiteral("BTLE stateChanged ") + QString::fromLocal8Bit(metaEnum.valueToKey(state)));
 
     for (QLowEnergyService *s : qAsConst(gattCommunicationChannelService)) {
         qDebug() << QStringLiteral("stateChanged") << s->serviceUuid() << s->state();
@@ -296,7 +304,7 @@ void strydrunpowersensor::stateChanged(QLowEnergyService::ServiceState state) {
         QSettings settings;
         bool virtual_device_enabled = settings.value(QStringLiteral("virtual_device_enabled"), true).toBool();
         if (virtual_device_enabled) {
-            emit debug(QStringLiteral("creating virtual treadmill interface..."));
+            LOG_DEVICE(QStringLiteral("creating virtual treadmill interface..."));
             virtualTreadmill = new virtualtreadmill(this, noHeartService);
             // connect(virtualBike,&virtualbike::debug ,this,&strydrunpowersensor::debug);
             connect(virtualTreadmill, &virtualtreadmill::changeInclination, this,
@@ -308,7 +316,7 @@ void strydrunpowersensor::stateChanged(QLowEnergyService::ServiceState state) {
 }
 
 void strydrunpowersensor::descriptorWritten(const QLowEnergyDescriptor &descriptor, const QByteArray &newValue) {
-    emit debug(QStringLiteral("descriptorWritten ") + descriptor.name() + QStringLiteral(" ") + newValue.toHex(' '));
+    LOG_PACKET(QStringLiteral("descriptorWritten ") + descriptor.name() + QStringLiteral(" ") + newValue.toHex(' '));
 
     initRequest = true;
     emit connectedAndDiscovered();
@@ -321,7 +329,7 @@ void strydrunpowersensor::descriptorRead(const QLowEnergyDescriptor &descriptor,
 void strydrunpowersensor::characteristicWritten(const QLowEnergyCharacteristic &characteristic,
                                                 const QByteArray &newValue) {
     Q_UNUSED(characteristic);
-    emit debug(QStringLiteral("characteristicWritten ") + newValue.toHex(' '));
+    LOG_PACKET(QStringLiteral("characteristicWritten ") + newValue.toHex(' '));
 }
 
 void strydrunpowersensor::characteristicRead(const QLowEnergyCharacteristic &characteristic,
@@ -330,7 +338,7 @@ void strydrunpowersensor::characteristicRead(const QLowEnergyCharacteristic &cha
 }
 
 void strydrunpowersensor::serviceScanDone(void) {
-    emit debug(QStringLiteral("serviceScanDone"));
+    LOG_DEVICE(QStringLiteral("serviceScanDone"));
 
     auto services_list = m_control->services();
     for (const QBluetoothUuid &s : qAsConst(services_list)) {
@@ -343,18 +351,18 @@ void strydrunpowersensor::serviceScanDone(void) {
 
 void strydrunpowersensor::errorService(QLowEnergyService::ServiceError err) {
     QMetaEnum metaEnum = QMetaEnum::fromType<QLowEnergyService::ServiceError>();
-    emit debug(QStringLiteral("strydrunpowersensor::errorService") + QString::fromLocal8Bit(metaEnum.valueToKey(err)) +
+    LOG_DEVICE(QStringLiteral("strydrunpowersensor::errorService") + QString::fromLocal8Bit(metaEnum.valueToKey(err)) +
                m_control->errorString());
 }
 
 void strydrunpowersensor::error(QLowEnergyController::Error err) {
     QMetaEnum metaEnum = QMetaEnum::fromType<QLowEnergyController::Error>();
-    emit debug(QStringLiteral("strydrunpowersensor::error") + QString::fromLocal8Bit(metaEnum.valueToKey(err)) +
+    LOG_DEVICE(QStringLiteral("strydrunpowersensor::error") + QString::fromLocal8Bit(metaEnum.valueToKey(err)) +
                m_control->errorString());
 }
 
 void strydrunpowersensor::deviceDiscovered(const QBluetoothDeviceInfo &device) {
-    emit debug(QStringLiteral("Found new device: ") + device.name() + QStringLiteral(" (") +
+    LOG_DEVICE(QStringLiteral("Found new device: ") + device.name() + QStringLiteral(" (") +
                device.address().toString() + ')');
     {
         bluetoothDevice = device;
@@ -372,17 +380,17 @@ void strydrunpowersensor::deviceDiscovered(const QBluetoothDeviceInfo &device) {
                 this, [this](QLowEnergyController::Error error) {
                     Q_UNUSED(error);
                     Q_UNUSED(this);
-                    emit debug(QStringLiteral("Cannot connect to remote device."));
+                    LOG_DEVICE(QStringLiteral("Cannot connect to remote device."));
                     emit disconnected();
                 });
         connect(m_control, &QLowEnergyController::connected, this, [this]() {
             Q_UNUSED(this);
-            emit debug(QStringLiteral("Controller connected. Search services..."));
+            LOG_DEVICE(QStringLiteral("Controller connected. Search services..."));
             m_control->discoverServices();
         });
         connect(m_control, &QLowEnergyController::disconnected, this, [this]() {
             Q_UNUSED(this);
-            emit debug(QStringLiteral("LowEnergy controller disconnected"));
+            LOG_DEVICE(QStringLiteral("LowEnergy controller disconnected"));
             emit disconnected();
         });
 
@@ -26,6 +26,7 @@
 #include <QObject>
 #include <QString>
 
+#include "cscdecoder.h"
 #include "treadmill.h"
 #include "virtualtreadmill.h"
 
@@ -68,8 +69,8 @@ class strydrunpowersensor : public treadmill {
     bool noHeartService = false;
     bool noVirtualDevice = false;
 
-    uint16_t oldLastCrankEventTime = 0;
-    uint16_t oldCrankRevs = 0;
+    cscdecoder crankDecoder = cscdecoder(16, 1024);
+    bool rscCadence = false;
 
 #ifdef Q_OS_IOS
     lockscreen *h = 0;
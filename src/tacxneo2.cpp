@@ -1,4 +1,6 @@
 #include "tacxneo2.h"
+#include "logging.h"
+#include "framing.h"
 #include "ios/lockscreen.h"
 #include "virtualbike.h"
 #include <QBluetoothLocalDevice>
@@ -41,7 +43,7 @@ void tacxneo2::writeCharacteristic(uint8_t *data, uint8_t data_len, const QStrin
     gattCustomService->writeCharacteristic(gattWriteCharCustomId, QByteArray((const char *)data, data_len));
 
     if (!disable_log) {
-        emit debug(QStringLiteral(" >> ") + QByteArray((const char *)data, data_len).toHex(' ') +
+        LOG_PACKET(QStringLiteral(" >> ") + QByteArray((const char *)data, data_len).toHex(' ') +
                    QStringLiteral(" // ") + info);
     }
 
@@ -56,10 +58,7 @@ void tacxneo2::changePower(int32_t power) {
     uint8_t p[] = {0xa4, 0x09, 0x4e, 0x05, 0x31, 0xff, 0xff, 0xff, 0xff, 0xd3, 0x4f, 0xff, 0x00};
     p[9] = (uint8_t)(power & 0xFF);
     p[10] = (uint8_t)(power >> 8);
-    for (uint8_t i = 1; i < sizeof(p) - 1; i++) {
-        p[12] += p[i]; // the last byte is a sort of a checksum
-    }
-    p[12]++;
+    sum8checksum<1, 1>::seal(p, sizeof(p));
 
     writeCharacteristic(p, sizeof(p), QStringLiteral("changePower"), false, false);
 }
@@ -73,10 +72,7 @@ void tacxneo2::changeInclination(double inclination) {
     uint8_t inc[] = {0xa4, 0x09, 0x4e, 0x05, 0x33, 0xff, 0xff, 0xff, 0xff, 0xd3, 0x4f, 0xff, 0x00};
     inc[9] = (uint8_t)(((uint16_t)inclination) & 0xFF);
     inc[10] = (uint8_t)(((uint16_t)inclination) >> 8);
-    for (uint8_t i = 1; i < sizeof(inc) - 1; i++) {
-        inc[12] += inc[i]; // the last byte is a sort of a checksum
-    }
-    inc[12]++;
+    sum8checksum<1, 1>::seal(inc, sizeof(inc));
 
     writeCharacteristic(inc, sizeof(inc), QStringLiteral("changeInclination"), false, false);
 }
@@ -110,13 +106,13 @@ void tacxneo2::update() {
                 requestResistance = 1;
 
             if (requestResistance != currentResistance().value()) {
-                emit debug(QStringLiteral("writing resistance ") + QString::number(requestResistance));
+                LOG_DEVICE(QStringLiteral("writing resistance ") + QString::number(requestResistance));
                 // forceResistance(requestResistance);
             }
             requestResistance = -1;
         }
         if (requestStart != -1) {
-            emit debug(QStringLiteral("starting..."));
+            LOG_DEVICE(QStringLiteral("starting..."));
 
             // btinit();
 
@@ -124,7 +120,7 @@ void tacxneo2::update() {
             emit bikeStarted();
         }
         if (requestStop != -1) {
-            emit debug(QStringLiteral("stopping..."));
+            LOG_DEVICE(QStringLiteral("stopping..."));
             // writeCharacteristic(initDataF0C800B8, sizeof(initDataF0C800B8), "stop tape");
             requestStop = -1;
         }
@@ -142,7 +138,7 @@ void tacxneo2::powerPacketReceived(const QByteArray &b) {
 }
 
 void tacxneo2::serviceDiscovered(const QBluetoothUuid &gatt) {
-    emit debug(QStringLiteral("serviceDiscovered ") + gatt.toString());
+    LOG_DEVICE(QStringLiteral("serviceDiscovered ") + gatt.toString());
 }
 
 void tacxneo2::characteristicChanged(const QLowEnergyCharacteristic &characteristic, const QByteArray &newValue) {
@@ -153,7 +149,7 @@ void tacxneo2::characteristicChanged(const QLowEnergyCharacteristic &characteris
         settings.value(QStringLiteral("heart_rate_belt_name"), QStringLiteral("Disabled")).toString();
 
     qDebug() << QStringLiteral(" << char ") << characteristic.uuid();
-    emit debug(QStringLiteral(" << ") + newValue.toHex(' '));
+    LOG_PACKET(QStringLiteral(" << ") + newValue.toHex(' '));
 
     if (characteristic.uuid() == QBluetoothUuid((quint16)0x2A5B)) {
         lastPacket = newValue;
@@ -161,15 +157,15 @@ void tacxneo2::characteristicChanged(const QLowEnergyCharacteristic &characteris
         uint8_t index = 1;
 
         if (newValue.at(0) == 0x02 && newValue.length() < 4) {
-            emit debug(QStringLiteral("Crank revolution data present with wrong bytes ") +
+            LOG_DEVICE(QStringLiteral("Crank revolution data present with wrong bytes ") +
                        QString::number(newValue.length()));
             return;
         } else if (newValue.at(0) == 0x01 && newValue.length() < 6) {
-            emit debug(QStringLiteral("Wheel revolution data present with wrong bytes ") +
+            LOG_DEVICE(QStringLiteral("Wheel revolution data present with wrong bytes ") +
                        QString::number(newValue.length()));
             return;
         } else if (newValue.at(0) == 0x00) {
-            emit debug(QStringLiteral("Cadence sensor notification without datas ") +
+            LOG_DEVICE(QStringLiteral("Cadence sensor notification without datas ") +
                        QString::number(newValue.length()));
             return;
         }
@@ -232,24 +228,24 @@ void tacxneo2::characteristicChanged(const QLowEnergyCharacteristic &characteris
                                                                   // kg * 3.5) / 200 ) / 60
         lastRefreshCharacteristicChanged = QDateTime::currentDateTime();
 
-        emit debug(QStringLiteral("Current CrankRevsRead: ") + QString::number(CrankRevsRead));
-        emit debug(QStringLiteral("Last CrankEventTime: ") + QString::number(LastCrankEventTime));
-        emit debug(QStringLiteral("Current Cadence: ") + QString::number(Cadence.value()));
-        emit debug(QStringLiteral("Current Speed: ") + QString::number(Speed.value()));
-        emit debug(QStringLiteral("Current Distance: ") + QString::number(Distance.value()));
-        emit debug(QStringLiteral("Current KCal: ") + QString::number(KCal.value()));
+        LOG_DEVICE(QStringLiteral("Current CrankRevsRead: ") + QString::number(CrankRevsRead));
+        LOG_DEVICE(QStringLiteral("Last CrankEventTime: ") + QString::number(LastCrankEventTime));
+        LOG_DEVICE(QStringLiteral("Current Cadence: ") + QString::number(Cadence.value()));
+        LOG_DEVICE(QStringLiteral("Current Speed: ") + QString::number(Speed.value()));
+        LOG_DEVICE(QStringLiteral("Current Distance: ") + QString::number(Distance.value()));
+        LOG_DEVICE(QStringLiteral("Current KCal: ") + QString::number(KCal.value()));
     } else if (characteristic.uuid() == QBluetoothUuid::HeartRateMeasurement) {
         if (newValue.length() > 1) {
             Heart = newValue[1];
         }
 
-        emit debug(QStringLiteral("Current heart: ") + QString::number(Heart.value()));
+        LOG_DEVICE(QStringLiteral("Current heart: ") + QString::number(Heart.value()));
     } else if (characteristic.uuid() == QBluetoothUuid::CyclingPowerMeasurement) {
         if (newValue.length() > 3) {
             m_watt = (((uint16_t)((uint8_t)newValue.at(3)) << 8) | (uint16_t)((uint8_t)newValue.at(2)));
         }
 
-        emit debug(QStringLiteral("Current watt: ") + QString::number(m_watt.value()));
+        LOG_DEVICE(QStringLiteral("Current watt: ") + QString::number(m_watt.value()));
     }
 
 #ifdef Q_OS_ANDROID
@@ -285,8 +281,8 @@ void tacxneo2::characteristicChanged(const QLowEnergyCharacteristic &characteris
 #endif
 #endif
 
-    emit debug(QStringLiteral("Current CrankRevs: ") + QString::number(CrankRevs));
-    emit debug(QStringLiteral("Last CrankEventTime: ") + QString::number(LastCrankEventTime));
+    LOG_DEVICE(QStringLiteral("Current CrankRevs: ") + QString::number(CrankRevs));
+    LOG_DEVICE(QStringLiteral("Last CrankEventTime: ") + QString::number(LastCrankEventTime));
 
     if (m_control->error() != QLowEnergyController::NoError)
         qDebug() << QStringLiteral("QLowEnergyController ERROR!!") << m_control->errorString();
@@ -294,7 +290,7 @@ void tacxneo2::characteristicChanged(const QLowEnergyCharacteristic &characteris
 
 void tacxneo2::stateChanged(QLowEnergyService::ServiceState state) {
     QMetaEnum metaEnum = QMetaEnum::fromType<QLowEnergyService::ServiceState>();
-    emit debug(QStringLiteral("BTLE stateChanged ") + QString::fromLocal8Bit(metaEnum.valueToKey(state)));
+    LOG_DEVICE(QStringLiteral("BTLE stateChanged ") + QString::fromLocal8Bit(metaEnum.valueToKey(state)));
 
     for (QLowEnergyService *s : qAsConst(gattCommunicationChannelService)) {
         qDebug() << QStringLiteral("stateChanged") << s->serviceUuid() << s->state();
@@ -398,7 +394,7 @@ void tacxneo2::stateChanged(QLowEnergyService::ServiceState state) {
 #endif
 #endif
             if (virtual_device_enabled) {
-            emit debug(QStringLiteral("creating virtual bike interface..."));
+            LOG_DEVICE(QStringLiteral("creating virtual bike interface..."));
             virtualBike = new virtualbike(this, noWriteResistance, noHeartService, 4, 1);
             // connect(virtualBike, &virtualbike::powerPacketReceived, this, &tacxneo2::powerPacketReceived);
             // connect(virtualBike,&virtualbike::debug ,this,&tacxneo2::debug);
@@ -409,7 +405,7 @@ void tacxneo2::stateChanged(QLowEnergyService::ServiceState state) {
 }
 
 void tacxneo2::descriptorWritten(const QLowEnergyDescriptor &descriptor, const QByteArray &newValue) {
-    emit debug(QStringLiteral("descriptorWritten ") + descriptor.name() + " " + newValue.toHex(' '));
+    LOG_PACKET(QStringLiteral("descriptorWritten ") + descriptor.name() + " " + newValue.toHex(' '));
 
     initRequest = true;
     emit connectedAndDiscovered();
@@ -421,7 +417,7 @@ void tacxneo2::descriptorRead(const QLowEnergyDescriptor &descriptor, const QByt
 
 void tacxneo2::characteristicWritten(const QLowEnergyCharacteristic &characteristic, const QByteArray &newValue) {
     Q_UNUSED(characteristic);
-    emit debug(QStringLiteral("characteristicWritten ") + newValue.toHex(' '));
+    LOG_PACKET(QStringLiteral("characteristicWritten ") + newValue.toHex(' '));
 }
 
 void tacxneo2::characteristicRead(const QLowEnergyCharacteristic &characteristic, const QByteArray &newValue) {
@@ -429,7 +425,7 @@ void tacxneo2::characteristicRead(const QLowEnergyCharacteristic &characteristic
 }
 
 void tacxneo2::serviceScanDone(void) {
-    emit debug(QStringLiteral("serviceScanDone"));
+    LOG_DEVICE(QStringLiteral("serviceScanDone"));
 
 #ifdef Q_OS_ANDROID
     QLowEnergyConnectionParameters c;
@@ -450,18 +446,18 @@ void tacxneo2::serviceScanDone(void) {
 
 void tacxneo2::errorService(QLowEnergyService::ServiceError err) {
     QMetaEnum metaEnum = QMetaEnum::fromType<QLowEnergyService::ServiceError>();
-    emit debug(QStringLiteral("tacxneo2::errorService") + QString::fromLocal8Bit(metaEnum.valueToKey(err)) +
+    LOG_DEVICE(QStringLiteral("tacxneo2::errorService") + QString::fromLocal8Bit(metaEnum.valueToKey(err)) +
                m_control->errorString());
 }
 
 void tacxneo2::error(QLowEnergyController::Error err) {
     QMetaEnum metaEnum = QMetaEnum::fromType<QLowEnergyController::Error>();
-    emit debug(QStringLiteral("tacxneo2::error") + QString::fromLocal8Bit(metaEnum.valueToKey(err)) +
+    LOG_DEVICE(QStringLiteral("tacxneo2::error") + QString::fromLocal8Bit(metaEnum.valueToKey(err)) +
                m_control->errorString());
 }
 
 void tacxneo2::deviceDiscovered(const QBluetoothDeviceInfo &device) {
-    emit debug(QStringLiteral("Found new device: ") + device.name() + QStringLiteral(" (") +
+    LOG_DEVICE(QStringLiteral("Found new device: ") + device.name() + QStringLiteral(" (") +
                device.address().toString() + ')');
     {
         bluetoothDevice = device;
@@ -477,17 +473,17 @@ void tacxneo2::deviceDiscovered(const QBluetoothDeviceInfo &device) {
                 this, [this](QLowEnergyController::Error error) {
                     Q_UNUSED(error);
                     Q_UNUSED(this);
-                    emit debug(QStringLiteral("Cannot connect to remote device."));
+                    LOG_DEVICE(QStringLiteral("Cannot connect to remote device."));
                     emit disconnected();
                 });
         connect(m_control, &QLowEnergyController::connected, this, [this]() {
             Q_UNUSED(this);
-            emit debug(QStringLiteral("Controller connected. Search services..."));
+            LOG_DEVICE(QStringLiteral("Controller connected. Search services..."));
             m_control->discoverServices();
         });
         connect(m_control, &QLowEnergyController::disconnected, this, [this]() {
             Q_UNUSED(this);
-            emit debug(QStringLiteral("LowEnergy controller disconnected"));
+            LOG_DEVICE(QStringLiteral("LowEnergy controller disconnected"));
             emit disconnected();
         });
 
@@ -1,6 +1,22 @@
 #include "tcpclientinfosender.h"
+#include "qdebugfixup.h"
+#include <QDateTime>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QtEndian>
+#include <cstring>
 
-TcpClientInfoSender::TcpClientInfoSender(const QString &id, QObject *parent) : TemplateInfoSender(id, parent) {}
+// what is handed to the socket at a time, the rest stays in the buffer that survives the reconnections
+static const qint64 socketChunk = 16 * 1024;
+
+TcpClientInfoSender::TcpClientInfoSender(const QString &id, QObject *parent) : TemplateInfoSender(id, parent) {
+    reconnectTimer.setSingleShot(true);
+    connect(&reconnectTimer, &QTimer::timeout, this, [this]() {
+        if (tcpSocket && tcpSocket->state() == QAbstractSocket::UnconnectedState) {
+            tcpSocket->connectToHost(ip, (uint16_t)port);
+        }
+    });
+}
 TcpClientInfoSender::~TcpClientInfoSender() {
     TcpClientInfoSender::innerStop(); // NOTE: clang-analyzer-optin-cplusplus-virtualcall
 }
@@ -8,28 +24,96 @@ TcpClientInfoSender::~TcpClientInfoSender() {
 bool TcpClientInfoSender::isRunning() const { return tcpSocket && tcpSocket->state() == QTcpSocket::ConnectedState; }
 
 bool TcpClientInfoSender::send(const QString &data) {
-    if (isRunning()) {
-        return tcpSocket->write(data.toLatin1()) > 0;
-    } else if (tcpSocket) {
-        qDebug() << QStringLiteral("TcpSocket state is ") << tcpSocket->state();
+    if (!tcpSocket || data.isEmpty()) {
+        return false;
     }
-    return false;
+    enqueue(data.toLatin1());
+    return true;
+}
+
+QByteArray TcpClientInfoSender::record(RECORD type, quint32 sequence, quint16 fields, const QByteArray &payload) {
+    QByteArray r(recordHeaderSize, 0);
+    char *d = r.data();
+    qToLittleEndian<quint32>(recordHeaderSize - 4 + payload.size(), d);
+    d[4] = (char)type;
+    d[5] = (char)recordVersion;
+    qToLittleEndian<quint16>(fields, d + 6);
+    qToLittleEndian<quint32>(sequence, d + 8);
+    qToLittleEndian<qint64>(QDateTime::currentMSecsSinceEpoch(), d + 12);
+    r.append(payload);
+    return r;
+}
+
+bool TcpClientInfoSender::sendRecord(const QStringList &names, const QVector<double> &values) {
+    if (!tcpSocket) {
+        return false;
+    }
+    if (schema != names) {
+        schema = names;
+        if (isRunning()) {
+            enqueue(record(RECORD_SCHEMA, 0, schema.count(),
+                           QJsonDocument(QJsonArray::fromStringList(schema)).toJson(QJsonDocument::Compact)));
+        }
+    }
+    QByteArray payload(values.count() * (int)sizeof(double), 0);
+    for (int i = 0; i < values.count(); i++) {
+        quint64 bits;
+        double v = values.at(i);
+        memcpy(&bits, &v, sizeof(bits));
+        qToLittleEndian<quint64>(bits, payload.data() + i * sizeof(double));
+    }
+    enqueue(record(RECORD_SAMPLE, sequence++, values.count(), payload));
+    return true;
+}
+
+void TcpClientInfoSender::enqueue(const QByteArray &data) {
+    pending.append(data);
+    pendingBytes += data.size();
+    while (pendingBytes > bufferSize && pending.count() > 1) {
+        pendingBytes -= pending.takeFirst().size();
+        dropped++;
+        if (!dropping) {
+            dropping = true;
+            qDebug() << QStringLiteral("TcpClient") << templateId
+                     << QStringLiteral("buffer full, the oldest updates are dropped");
+        }
+    }
+    flush();
+}
+
+void TcpClientInfoSender::flush() {
+    if (!isRunning()) {
+        return;
+    }
+    while (!pending.isEmpty() && tcpSocket->bytesToWrite() < socketChunk) {
+        QByteArray data = pending.takeFirst();
+        pendingBytes -= data.size();
+        tcpSocket->write(data);
+    }
+    if (pending.isEmpty() && dropping) {
+        dropping = false;
+        qDebug() << QStringLiteral("TcpClient") << templateId << QStringLiteral("buffer flushed, dropped so far")
+                 << dropped;
+    }
+}
+
+void TcpClientInfoSender::scheduleReconnect() {
+    if (!tcpSocket || reconnectTimer.isActive()) {
+        return;
+    }
+    qDebug() << QStringLiteral("TcpClient") << templateId << QStringLiteral("reconnecting in") << reconnectDelay
+             << QStringLiteral("ms, buffered") << pendingBytes;
+    reconnectTimer.start(reconnectDelay);
+    reconnectDelay = qMin(reconnectDelay * 2, maxReconnectDelay);
 }
 
 void TcpClientInfoSender::innerStop() {
+    reconnectTimer.stop();
     if (tcpSocket) {
-        if (TcpClientInfoSender::isRunning()) {
-            tcpSocket->close();
-            disconnect(tcpSocket, SIGNAL(connectionClosed()));
-            disconnect(tcpSocket, SIGNAL(readyRead()));
-            disconnect(tcpSocket, SIGNAL(socketError(int)));
-            disconnect(tcpSocket, SIGNAL(stateChanged(QAbstractSocket::SocketState)));
-            connect(tcpSocket, SIGNAL(connectionClosed()), tcpSocket, SLOT(deleteLater()));
-            tcpSocket = 0;
-        } else {
-            tcpSocket->deleteLater();
-            tcpSocket = 0;
-        }
+        tcpSocket->disconnect(this);
+        tcpSocket->close();
+        tcpSocket->deleteLater();
+        tcpSocket = nullptr;
     }
 }
 
@@ -51,26 +135,47 @@ bool TcpClientInfoSender::init() {
     if (ip.isEmpty()) {
         ip = QStringLiteral("127.0.0.1");
     }
+    binary =
+        settings.value(QStringLiteral("template_") + templateId + QStringLiteral("_format"), QStringLiteral("text"))
+            .toString() == QStringLiteral("binary");
+    qint64 buffer =
+        settings.value(QStringLiteral("template_") + templateId + QStringLiteral("_buffer"), defaultBufferSize)
+            .toLongLong();
+    bufferSize = qMax(socketChunk, buffer);
+    // the buffer outlives the socket, what it has goes to the new one
+    innerStop();
+    reconnectDelay = minReconnectDelay;
     tcpSocket = new QTcpSocket(this);
     connect(tcpSocket, &QAbstractSocket::connected, this, &TcpClientInfoSender::debugConnected);
-    connect(tcpSocket, SIGNAL(connectionClosed()), this, SLOT(reinit()));
     connect(tcpSocket, &QIODevice::readyRead, this, &TcpClientInfoSender::readyRead);
-    connect(tcpSocket, SIGNAL(error(int)), this, SLOT(socketError(int)));
+    connect(tcpSocket, &QIODevice::bytesWritten, this, &TcpClientInfoSender::flush);
+    connect(tcpSocket, QOverload<QAbstractSocket::SocketError>::of(&QAbstractSocket::error), this,
+            &TcpClientInfoSender::socketError);
     connect(tcpSocket, &QAbstractSocket::stateChanged, this, &TcpClientInfoSender::stateChanged);
     tcpSocket->connectToHost(ip, (uint16_t)port);
     return true;
 }
 
-void TcpClientInfoSender::debugConnected() { qDebug() << "Connected" << tcpSocket->state(); }
+void TcpClientInfoSender::debugConnected() {
+    qDebug() << "Connected" << tcpSocket->state();
+    reconnectDelay = minReconnectDelay;
+    if (binary && !schema.isEmpty()) {
+        tcpSocket->write(record(RECORD_SCHEMA, 0, schema.count(),
+                                QJsonDocument(QJsonArray::fromStringList(schema)).toJson(QJsonDocument::Compact)));
+    }
+    flush();
+}
 
-void TcpClientInfoSender::socketError(int err) {
-    qDebug() << QStringLiteral("SocketError") << err;
-    reinit();
+void TcpClientInfoSender::socketError(QAbstractSocket::SocketError err) {
+    qDebug() << QStringLiteral("SocketError") << err << tcpSocket->errorString();
+    if (tcpSocket->state() == QAbstractSocket::UnconnectedState) {
+        scheduleReconnect();
+    }
 }
 
 void TcpClientInfoSender::stateChanged(QAbstractSocket::SocketState socketState) {
     qDebug() << QStringLiteral("Socket State Changed to") << socketState;
     if (socketState == QAbstractSocket::SocketState::UnconnectedState) {
-        reinit();
+        scheduleReconnect();
     }
 }
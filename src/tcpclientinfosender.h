@@ -2,15 +2,41 @@
 #define TCPCLIENTINFOSENDER_H
 
 #include "templateinfosender.h"
+#include <QList>
 #include <QTcpSocket>
+#include <QTimer>
 
+// Sends to template_<id>_ip:template_<id>_port the result of the script at every update or, when template_<id>_format
+// is "binary", a record of the workout without evaluating the script. What can't be written while the connection is
+// down waits in a buffer of at most template_<id>_buffer bytes, the oldest updates dropped first, and goes out when
+// it's back. The connection is retried after minReconnectDelay, doubling up to maxReconnectDelay.
+//
+// The binary records are little endian:
+//
+//   length (4, the bytes after it) | type (1) | version (1) | fields (2) | sequence (4) | time (8) | payload
+//
+// the time in ms since the epoch. RECORD_SCHEMA is the first record of every connection: the names of the fields, a
+// JSON array, sequence 0. RECORD_SAMPLE has the fields as doubles, NaN where the device doesn't have the field or it
+// isn't a number; its sequence grows by one at every sample, a gap is a sample lost.
 class TcpClientInfoSender : public TemplateInfoSender {
     Q_OBJECT
   public:
+    enum RECORD { RECORD_SCHEMA = 1, RECORD_SAMPLE = 2 };
+    static const int recordVersion = 1;
+    static const int recordHeaderSize = 20;
+    static const int defaultBufferSize = 256 * 1024;
+    static const int minReconnectDelay = 1000;
+    static const int maxReconnectDelay = 60000;
+
     TcpClientInfoSender(const QString &id, QObject *parent = nullptr);
     virtual ~TcpClientInfoSender();
     virtual bool isRunning() const;
     virtual bool send(const QString &data);
+    // the updates are buffered while the connection is down
+    virtual bool hasClients() const { return tcpSocket != nullptr; }
+    virtual bool binaryRecords() const { return binary; }
+    virtual bool sendRecord(const QStringList &names, const QVector<double> &values);
+    static QByteArray record(RECORD type, quint32 sequence, quint16 fields, const QByteArray &payload);
 
   protected:
     QTcpSocket *tcpSocket = nullptr;
@@ -18,10 +44,25 @@ class TcpClientInfoSender : public TemplateInfoSender {
     int port;
     virtual bool init();
     virtual void innerStop();
+
+  private:
+    void enqueue(const QByteArray &data);
+    void flush();
+    void scheduleReconnect();
+    bool binary = false;
+    qint64 bufferSize = defaultBufferSize;
+    QList<QByteArray> pending;
+    qint64 pendingBytes = 0;
+    quint64 dropped = 0;
+    bool dropping = false;
+    quint32 sequence = 0;
+    QStringList schema;
+    QTimer reconnectTimer;
+    int reconnectDelay = minReconnectDelay;
   private slots:
     void readyRead();
     void debugConnected();
-    void socketError(int err);
+    void socketError(QAbstractSocket::SocketError err);
     void stateChanged(QAbstractSocket::SocketState socketState);
 };
 
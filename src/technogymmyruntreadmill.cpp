@@ -1,4 +1,6 @@
 #include "technogymmyruntreadmill.h"
+#include "logging.h"
+#include "ftmsparser.h"
 
 #include "ftmsbike.h"
 #include "ios/lockscreen.h"
@@ -157,7 +159,7 @@ void technogymmyruntreadmill::update() {
 
         if (requestSpeed != -1) {
             if (requestSpeed != currentSpeed().value() && requestSpeed >= 0 && requestSpeed <= 22) {
-                emit debug(QStringLiteral("writing speed ") + QString::number(requestSpeed));
+                LOG_DEVICE(QStringLiteral("writing speed ") + QString::number(requestSpeed));
                 forceSpeed(requestSpeed);
             }
             requestSpeed = -1;
@@ -165,13 +167,13 @@ void technogymmyruntreadmill::update() {
         if (requestInclination != -1) {
             if (requestInclination != currentInclination().value() && requestInclination >= 0 &&
                 requestInclination <= 15) {
-                emit debug(QStringLiteral("writing incline ") + QString::number(requestInclination));
+                LOG_DEVICE(QStringLiteral("writing incline ") + QString::number(requestInclination));
                 forceIncline(requestInclination);
             }
             requestInclination = -1;
         }
         if (requestStart != -1) {
-            emit debug(QStringLiteral("starting..."));
+            LOG_DEVICE(QStringLiteral("starting..."));
             if (lastSpeed == 0.0) {
 
                 lastSpeed = 0.5;
@@ -180,7 +182,7 @@ void technogymmyruntreadmill::update() {
             emit tapeStarted();
         }
         if (requestStop != -1) {
-            emit debug(QStringLiteral("stopping..."));
+            LOG_DEVICE(QStringLiteral("stopping..."));
 
             if (gattFTMSService) {
                 uint8_t writeS[] = {FTMS_STOP_PAUSE, 0x01};
@@ -192,12 +194,12 @@ void technogymmyruntreadmill::update() {
             requestStop = -1;
         }
         if (requestIncreaseFan != -1) {
-            emit debug(QStringLiteral("increasing fan speed..."));
+            LOG_DEVICE(QStringLiteral("increasing fan speed..."));
 
             // sendChangeFanSpeed(FanSpeed + 1);
             requestIncreaseFan = -1;
         } else if (requestDecreaseFan != -1) {
-            emit debug(QStringLiteral("decreasing fan speed..."));
+            LOG_DEVICE(QStringLiteral("decreasing fan speed..."));
 
             // sendChangeFanSpeed(FanSpeed - 1);
             requestDecreaseFan = -1;
@@ -228,7 +230,7 @@ void technogymmyruntreadmill::forceIncline(double requestIncline) {
 }
 
 void technogymmyruntreadmill::serviceDiscovered(const QBluetoothUuid &gatt) {
-    emit debug(QStringLiteral("serviceDiscovered ") + gatt.toString());
+    LOG_DEVICE(QStringLiteral("serviceDiscovered ") + gatt.toString());
 }
 
 void technogymmyruntreadmill::characteristicChanged(const QLowEnergyCharacteristic &characteristic,
@@ -244,102 +246,37 @@ void technogymmyruntreadmill::characteristicChanged(const QLowEnergyCharacterist
     if (characteristic.uuid() == QBluetoothUuid((quint16)0x2AD9))
         emit packetReceived();
 
-    emit debug(QStringLiteral(" << ") + characteristic.uuid().toString() + " " + QString::number(newValue.length()) +
+    LOG_PACKET(QStringLiteral(" << ") + characteristic.uuid().toString() + " " + QString::number(newValue.length()) +
                " " + newValue.toHex(' ') + newValue);
 
-    if (characteristic.uuid() == QBluetoothUuid((quint16)0x2ACD)) {
+    if (characteristic.uuid() == QBluetoothUuid((quint16)ftmsparser::TREADMILL_DATA)) {
         lastPacket = newValue;
 
         // default flags for this treadmill is 84 04
-
-        union flags {
-            struct {
-
-                uint16_t moreData : 1;
-                uint16_t avgSpeed : 1;
-                uint16_t totalDistance : 1;
-                uint16_t inclination : 1;
-                uint16_t elevation : 1;
-                uint16_t instantPace : 1;
-                uint16_t averagePace : 1;
-                uint16_t expEnergy : 1;
-                uint16_t heartRate : 1;
-                uint16_t metabolic : 1;
-                uint16_t elapsedTime : 1;
-                uint16_t remainingTime : 1;
-                uint16_t forceBelt : 1;
-                uint16_t spare : 3;
-            };
-
-            uint16_t word_flags;
-        };
-
-        flags Flags;
-        int index = 0;
-        Flags.word_flags = (newValue.at(1) << 8) | newValue.at(0);
-        index += 2;
-
-        if (!Flags.moreData) {
-            Speed = ((double)(((uint16_t)((uint8_t)newValue.at(index + 1)) << 8) |
-                              (uint16_t)((uint8_t)newValue.at(index)))) /
-                    100.0;
-            index += 2;
-            emit debug(QStringLiteral("Current Speed: ") + QString::number(Speed.value()));
-        }
-
-        if (Flags.avgSpeed) {
-            double avgSpeed;
-            avgSpeed = ((double)(((uint16_t)((uint8_t)newValue.at(index + 1)) << 8) |
-                                 (uint16_t)((uint8_t)newValue.at(index)))) /
-                       100.0;
-            index += 2;
-            emit debug(QStringLiteral("Current Average Speed: ") + QString::number(avgSpeed));
+        ftmsparser::data d;
+        if (!ftmsparser::parse(ftmsparser::TREADMILL_DATA, newValue.constData(), newValue.length(), d)) {
+            LOG_DEVICE(QStringLiteral("truncated treadmill data"));
         }
 
-        if (Flags.totalDistance) {
-            // ignoring the distance, because it's a total life odometer
-            // Distance = ((double)((((uint32_t)((uint8_t)newValue.at(index + 2)) << 16) |
-            // (uint32_t)((uint8_t)newValue.at(index + 1)) << 8) | (uint32_t)((uint8_t)newValue.at(index)))) / 1000.0;
-            index += 3;
-        }
-        // else
-        {
-            Distance += ((Speed.value() / 3600000.0) *
-                         ((double)lastRefreshCharacteristicChanged.msecsTo(QDateTime::currentDateTime())));
+        if (d.has(ftmsparser::INSTANT_SPEED)) {
+            Speed = d[ftmsparser::INSTANT_SPEED];
+            LOG_DEVICE(QStringLiteral("Current Speed: ") + QString::number(Speed.value()));
         }
 
-        emit debug(QStringLiteral("Current Distance: ") + QString::number(Distance.value()));
+        // ignoring the total distance, because it's a total life odometer
+        Distance += ((Speed.value() / 3600000.0) *
+                     ((double)lastRefreshCharacteristicChanged.msecsTo(QDateTime::currentDateTime())));
 
-        if (Flags.inclination) {
-            Inclination = ((double)(((uint16_t)((uint8_t)newValue.at(index + 1)) << 8) |
-                                    (uint16_t)((uint8_t)newValue.at(index)))) /
-                          10.0;
-            index += 4; // the ramo value is useless
-            emit debug(QStringLiteral("Current Inclination: ") + QString::number(Inclination.value()));
-        }
+        LOG_DEVICE(QStringLiteral("Current Distance: ") + QString::number(Distance.value()));
 
-        if (Flags.elevation) {
-            index += 4; // TODO
+        if (d.has(ftmsparser::INCLINATION)) {
+            // the ramp value is useless
+            Inclination = d[ftmsparser::INCLINATION];
+            LOG_DEVICE(QStringLiteral("Current Inclination: ") + QString::number(Inclination.value()));
         }
 
-        if (Flags.instantPace) {
-            index += 1; // TODO
-        }
-
-        if (Flags.averagePace) {
-            index += 1; // TODO
-        }
-
-        if (Flags.expEnergy) {
-            KCal = ((double)(((uint16_t)((uint8_t)newValue.at(index + 1)) << 8) |
-                             (uint16_t)((uint8_t)newValue.at(index))));
-            index += 2;
-
-            // energy per hour
-            index += 2;
-
-            // energy per minute
-            index += 1;
+        if (d.has(ftmsparser::TOTAL_ENERGY)) {
+            KCal = d[ftmsparser::TOTAL_ENERGY];
         } else {
             if (watts(settings.value(QStringLiteral("weight"), 75.0).toFloat()))
                 KCal += ((((0.048 * ((double)watts(settings.value(QStringLiteral("weight"), 75.0).toFloat())) + 1.19) *
@@ -351,7 +288,7 @@ void technogymmyruntreadmill::characteristicChanged(const QLowEnergyCharacterist
                                                                 // kg * 3.5) / 200 ) / 60
         }
 
-        emit debug(QStringLiteral("Current KCal: ") + QString::number(KCal.value()));
+        LOG_DEVICE(QStringLiteral("Current KCal: ") + QString::number(KCal.value()));
 
 #ifdef Q_OS_ANDROID
         if (settings.value("ant_heart", false).toBool())
@@ -359,34 +296,12 @@ void technogymmyruntreadmill::characteristicChanged(const QLowEnergyCharacterist
         else
 #endif
         {
-            if (Flags.heartRate) {
-                if (index < newValue.length()) {
-
-                    heart = ((double)((newValue.at(index))));
-                    emit debug(QStringLiteral("Current Heart: ") + QString::number(heart));
-                } else {
-                    emit debug(QStringLiteral("Error on parsing heart!"));
-                }
-                // index += 1; //NOTE: clang-analyzer-deadcode.DeadStores
+            if (d.has(ftmsparser::HEART_RATE)) {
+                heart = d[ftmsparser::HEART_RATE];
+                LOG_DEVICE(QStringLiteral("Current Heart: ") + QString::number(heart));
             }
         }
 
-        if (Flags.metabolic) {
-            // todo
-        }
-
-        if (Flags.elapsedTime) {
-            // todo
-        }
-
-        if (Flags.remainingTime) {
-            // todo
-        }
-
-        if (Flags.forceBelt) {
-            // todo
-        }
-
         lastRefreshCharacteristicChanged = QDateTime::currentDateTime();
 
     } else if (characteristic.uuid() == QBluetoothUuid::RSCMeasurement) {
@@ -406,7 +321,7 @@ void technogymmyruntreadmill::characteristicChanged(const QLowEnergyCharacterist
 
         Cadence = cadence;
         emit cadenceChanged(cadence);
-        emit debug(QStringLiteral("Current Cadence: ") + QString::number(cadence));
+        LOG_DEVICE(QStringLiteral("Current Cadence: ") + QString::number(cadence));
     }
 
     if (heartRateBeltName.startsWith(QStringLiteral("Disabled"))) {
@@ -435,7 +350,7 @@ void technogymmyruntreadmill::characteristicChanged(const QLowEnergyCharacterist
 
 void technogymmyruntreadmill::stateChanged(QLowEnergyService::ServiceState state) {
     QMetaEnum metaEnum = QMetaEnum::fromType<QLowEnergyService::ServiceState>();
-    emit debug(QStringLiteral("BTLE stateChanged ") + QString::fromLocal8Bit(metaEnum.valueToKey(state)));
+    LOG_DEVICE(QStringLiteral("BTLE stateChanged ") + QString::fromLocal8Bit(metaEnum.valueToKey(state)));
 
     for (QLowEnergyService *s : qAsConst(gattCommunicationChannelService)) {
         qDebug() << QStringLiteral("stateChanged") << s->serviceUuid() << s->state();
@@ -570,7 +485,7 @@ void technogymmyruntreadmill::changeInclinationRequested(double grade, double pe
 }
 
 void technogymmyruntreadmill::descriptorWritten(const QLowEnergyDescriptor &descriptor, const QByteArray &newValue) {
-    emit debug(QStringLiteral("descriptorWritten ") + descriptor.name() + QStringLiteral(" ") + newValue.toHex(' '));
+    LOG_PACKET(QStringLiteral("descriptorWritten ") + descriptor.name() + QStringLiteral(" ") + newValue.toHex(' '));
 
     initRequest = true;
     emit connectedAndDiscovered();
@@ -583,7 +498,7 @@ void technogymmyruntreadmill::descriptorRead(const QLowEnergyDescriptor &descrip
 void technogymmyruntreadmill::characteristicWritten(const QLowEnergyCharacteristic &characteristic,
                                                     const QByteArray &newValue) {
     Q_UNUSED(characteristic);
-    emit debug(QStringLiteral("characteristicWritten ") + newValue.toHex(' '));
+    LOG_PACKET(QStringLiteral("characteristicWritten ") + newValue.toHex(' '));
 }
 
 void technogymmyruntreadmill::characteristicRead(const QLowEnergyCharacteristic &characteristic,
@@ -592,7 +507,7 @@ void technogymmyruntreadmill::characteristicRead(const QLowEnergyCharacteristic
 }
 
 void technogymmyruntreadmill::serviceScanDone(void) {
-    emit debug(QStringLiteral("serviceScanDone"));
+    LOG_DEVICE(QStringLiteral("serviceScanDone"));
 
     auto services_list = m_control->services();
     for (const QBluetoothUuid &s : qAsConst(services_list)) {
@@ -606,14 +521,14 @@ void technogymmyruntreadmill::serviceScanDone(void) {
 void technogymmyruntreadmill::errorService(QLowEnergyService::ServiceError err) {
 
     QMetaEnum metaEnum = QMetaEnum::fromType<QLowEnergyService::ServiceError>();
-    emit debug(QStringLiteral("technogymmyruntreadmill::errorService") +
+    LOG_DEVICE(QStringLiteral("technogymmyruntreadmill::errorService") +
                QString::fromLocal8Bit(metaEnum.valueToKey(err)) + m_control->errorString());
 }
 
 void technogymmyruntreadmill::error(QLowEnergyController::Error err) {
 
     QMetaEnum metaEnum = QMetaEnum::fromType<QLowEnergyController::Error>();
-    emit debug(QStringLiteral("technogymmyruntreadmill::error") + QString::fromLocal8Bit(metaEnum.valueToKey(err)) +
+    LOG_DEVICE(QStringLiteral("technogymmyruntreadmill::error") + QString::fromLocal8Bit(metaEnum.valueToKey(err)) +
                m_control->errorString());
 }
 
@@ -623,7 +538,7 @@ void technogymmyruntreadmill::deviceDiscovered(const QBluetoothDeviceInfo &devic
     // horizon treadmill and F80 treadmill, so if we want to add inclination support we have to separate the 2
     // devices
     // ***************************************************************************************************************
-    emit debug(QStringLiteral("Found new device: ") + device.name() + QStringLiteral(" (") +
+    LOG_DEVICE(QStringLiteral("Found new device: ") + device.name() + QStringLiteral(" (") +
                device.address().toString() + ')');
     {
         bluetoothDevice = device;
@@ -641,17 +556,17 @@ void technogymmyruntreadmill::deviceDiscovered(const QBluetoothDeviceInfo &devic
                 this, [this](QLowEnergyController::Error error) {
                     Q_UNUSED(error);
                     Q_UNUSED(this);
-                    emit debug(QStringLiteral("Cannot connect to remote device."));
+                    LOG_DEVICE(QStringLiteral("Cannot connect to remote device."));
                     emit disconnected();
                 });
         connect(m_control, &QLowEnergyController::connected, this, [this]() {
             Q_UNUSED(this);
-            emit debug(QStringLiteral("Controller connected. Search services..."));
+            LOG_DEVICE(QStringLiteral("Controller connected. Search services..."));
             m_control->discoverServices();
         });
         connect(m_control, &QLowEnergyController::disconnected, this, [this]() {
             Q_UNUSED(this);
-            emit debug(QStringLiteral("LowEnergy controller disconnected"));
+            LOG_DEVICE(QStringLiteral("LowEnergy controller disconnected"));
             emit disconnected();
         });
 
@@ -1,4 +1,5 @@
 #include "technogymmyruntreadmillrfcomm.h"
+#include "logging.h"
 #include <QBluetoothLocalDevice>
 #include <QDateTime>
 #include <QMetaEnum>
@@ -17,7 +18,7 @@ technogymmyruntreadmillrfcomm::technogymmyruntreadmillrfcomm() {
 }
 
 void technogymmyruntreadmillrfcomm::deviceDiscovered(const QBluetoothDeviceInfo &device) {
-    emit debug(QStringLiteral("Found new device: ") + device.name() + QStringLiteral(" (") +
+    LOG_DEVICE(QStringLiteral("Found new device: ") + device.name() + QStringLiteral(" (") +
                device.address().toString() + ')');
     // if (device.name().startsWith(QStringLiteral("TRX ROUTE KEY")))
     {
@@ -59,9 +60,9 @@ void technogymmyruntreadmillrfcomm::serviceFinished(void) {
         socket->setPreferredSecurityFlags(QBluetooth::NoSecurity);
 #endif
 
-        emit debug(QStringLiteral("Create socket"));
+        LOG_DEVICE(QStringLiteral("Create socket"));
         socket->connectToService(serialPortService);
-        emit debug(QStringLiteral("ConnectToService done"));
+        LOG_DEVICE(QStringLiteral("ConnectToService done"));
     }
 }
 
@@ -79,14 +80,14 @@ void technogymmyruntreadmillrfcomm::serviceDiscovered(const QBluetoothServiceInf
 
     qDebug() << QStringLiteral("technogymmyruntreadmillrfcomm::serviceDiscovered") << service;
     if (service.device().address() == bluetoothDevice.address()) {
-        emit debug(QStringLiteral("Found new service: ") + service.serviceName() + '(' +
+        LOG_DEVICE(QStringLiteral("Found new service: ") + service.serviceName() + '(' +
                    service.serviceUuid().toString() + ')');
 
         if (service.serviceName().startsWith(QStringLiteral("SerialPort")) ||
             service.serviceName().startsWith(QStringLiteral("Serial Port"))) {
             serialPortService = service;
             found = true;
-            emit debug(QStringLiteral("Serial port service found"));
+            LOG_DEVICE(QStringLiteral("Serial port service found"));
             //discoveryAgent->stop();
         }
     }
@@ -107,7 +108,7 @@ void technogymmyruntreadmillrfcomm::update() {
             QSettings settings;
             bool virtual_device_enabled = settings.value(QStringLiteral("virtual_device_enabled"), true).toBool();
             if (virtual_device_enabled) {
-                emit debug(QStringLiteral("creating virtual treadmill interface..."));
+                LOG_DEVICE(QStringLiteral("creating virtual treadmill interface..."));
                 virtualTreadMill = new virtualtreadmill(this, true);
                 connect(virtualTreadMill, &virtualtreadmill::debug, this, &technogymmyruntreadmillrfcomm::debug);
                 connect(virtualTreadMill, &virtualtreadmill::changeInclination, this,
@@ -120,7 +121,7 @@ void technogymmyruntreadmillrfcomm::update() {
             if (requestSpeed != currentSpeed().value() && requestSpeed >= 0 && requestSpeed <= 20) {
                 QString force =
                     QStringLiteral("!DEV,024,") + QString::number(requestSpeed) + QStringLiteral(",1.8#").toLocal8Bit();
-                emit debug(QStringLiteral("writing speed ") + QString::number(requestSpeed) + " " + force);
+                LOG_DEVICE(QStringLiteral("writing speed ") + QString::number(requestSpeed) + " " + force);
                 socket->write(force.toLocal8Bit());
             }
             requestSpeed = -1;
@@ -129,12 +130,12 @@ void technogymmyruntreadmillrfcomm::update() {
                 requestInclination <= 12) {
                 QString force = QStringLiteral("!DEV,025,") + QString::number(requestInclination) +
                                 QStringLiteral("#").toLocal8Bit();
-                emit debug(QStringLiteral("writing incline ") + QString::number(requestInclination) + " " + force);
+                LOG_DEVICE(QStringLiteral("writing incline ") + QString::number(requestInclination) + " " + force);
                 socket->write(force.toLocal8Bit());
             }
             requestInclination = -1;
         } else if (requestStart != -1) {
-            emit debug(QStringLiteral("starting..."));
+            LOG_DEVICE(QStringLiteral("starting..."));
             /*
             const uint8_t start[] = {0x55, 0x17, 0x01, 0x01, 0x55, 0xb5, 0x01, 0xff};
             socket->write((char *)start, sizeof(start));
@@ -145,7 +146,7 @@ void technogymmyruntreadmillrfcomm::update() {
             /*
             const char poll[] = {0x55, 0x17, 0x01, 0x01};
             socket->write(poll, sizeof(poll));
-            emit debug(QStringLiteral("write poll"));
+            LOG_DEVICE(QStringLiteral("write poll"));
             */
         }
 
@@ -154,7 +155,7 @@ void technogymmyruntreadmillrfcomm::update() {
 }
 
 void technogymmyruntreadmillrfcomm::rfCommConnected() {
-    emit debug(QStringLiteral("connected ") + socket->peerName());
+    LOG_DEVICE(QStringLiteral("connected ") + socket->peerName());
 
     socket->write(QStringLiteral("@FWVER#").toLocal8Bit());
     qDebug() << QStringLiteral(" init1 write");
@@ -215,12 +216,12 @@ void technogymmyruntreadmillrfcomm::readSocket() {
             Inclination = values.at(3).toDouble();
 
             qDebug() << values;
-            emit debug(QStringLiteral("Current speed: ") + QString::number(Speed.value()));
-            emit debug(QStringLiteral("Current incline: ") + QString::number(Inclination.value()));
+            LOG_DEVICE(QStringLiteral("Current speed: ") + QString::number(Speed.value()));
+            LOG_DEVICE(QStringLiteral("Current incline: ") + QString::number(Inclination.value()));
         }
     }
 }
 
 void technogymmyruntreadmillrfcomm::onSocketErrorOccurred(QBluetoothSocket::SocketError error) {
-    emit debug(QStringLiteral("onSocketErrorOccurred ") + QString::number(error));
+    LOG_DEVICE(QStringLiteral("onSocketErrorOccurred ") + QString::number(error));
 }
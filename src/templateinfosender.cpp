@@ -1,5 +1,6 @@
 #include "templateinfosender.h"
 #include "qdebugfixup.h"
+#include <QRegExp>
 #include <chrono>
 
 using namespace std::chrono_literals;
@@ -16,17 +17,135 @@ TemplateInfoSender::~TemplateInfoSender() { stop(); }
 
 bool TemplateInfoSender::init(const QString &script) {
     jscript = script;
+    compiled = QJSValue();
+    compiledEngine = nullptr;
+    updateInterval =
+        qBound(minInterval,
+               settings.value(QStringLiteral("template_") + templateId + QStringLiteral("_interval"), defaultInterval)
+                   .toInt(),
+               maxInterval);
+    nextUpdate = 0;
     stop();
     return init();
 }
 
+bool TemplateInfoSender::schedule(qint64 &next, qint64 now, int interval, int tolerance) {
+    if (now + tolerance < next) {
+        return false;
+    }
+    // late by more than an interval (i.e. the app was suspended): start again from now instead of catching up
+    next = now - next > interval ? now + interval : next + interval;
+    return true;
+}
+
+// The script as the body of a function: the statements up to the last ";" at the top level, and the value of the last
+// statement, an expression, returned. It's a scanner of strings, comments and brackets, not a parser of JavaScript:
+//
+// - accepted: expressions and statements ending with ";", let and const (local to the function, evaluate would
+//   declare them again at every update), function expressions (let pad = function(n) {...};), strings, template
+//   literals and comments containing ; or brackets, members named var or function (this.var)
+// - rejected: a top level var or function declaration, which in a function would be local and lose what the script
+//   keeps in them between the updates, while evaluate keeps them in the global object; a last statement that isn't an
+//   expression (let, if, for, a block...); unbalanced brackets, unterminated strings or comments
+// - not recognized: statements separated by a newline without ";" and regular expression literals with quotes or
+//   brackets. The body doesn't compile then, as a rule, and compile falls back to evaluate
+QString TemplateInfoSender::functionBody(const QString &script) {
+    QString s = script.trimmed();
+    while (s.endsWith(QLatin1Char(';'))) {
+        s.chop(1);
+        s = s.trimmed();
+    }
+    int depth = 0;
+    int last = -1;
+    QChar quote;
+    // the last character outside of the strings and of the comments, a declaration follows nothing, ";" or "}"
+    QChar previous;
+    for (int i = 0; i < s.length(); i++) {
+        QChar c = s.at(i);
+        if (!quote.isNull()) {
+            if (c == QLatin1Char('\\')) {
+                i++;
+            } else if (c == quote) {
+                quote = QChar();
+                previous = c;
+            }
+            continue;
+        }
+        if (c.isSpace()) {
+            continue;
+        }
+        if (c == QLatin1Char('"') || c == QLatin1Char('\'') || c == QLatin1Char('`')) {
+            quote = c;
+        } else if (c == QLatin1Char('/') && i + 1 < s.length() && s.at(i + 1) == QLatin1Char('/')) {
+            while (i < s.length() && s.at(i) != QLatin1Char('\n')) {
+                i++;
+            }
+            continue;
+        } else if (c == QLatin1Char('/') && i + 1 < s.length() && s.at(i + 1) == QLatin1Char('*')) {
+            i = s.indexOf(QStringLiteral("*/"), i + 2);
+            if (i < 0) {
+                return QString();
+            }
+            i++;
+            continue;
+        } else if (!depth && (c.isLetter() || c == QLatin1Char('_') || c == QLatin1Char('$'))) {
+            int end = i + 1;
+            while (end < s.length() && (s.at(end).isLetterOrNumber() || s.at(end) == QLatin1Char('_') ||
+                                        s.at(end) == QLatin1Char('$'))) {
+                end++;
+            }
+            QStringRef word = s.midRef(i, end - i);
+            bool member = previous == QLatin1Char('.');
+            bool declaration = previous.isNull() || previous == QLatin1Char(';') || previous == QLatin1Char('}');
+            if (!member && (word == QLatin1String("var") || (declaration && word == QLatin1String("function")))) {
+                return QString();
+            }
+            i = end - 1;
+            c = s.at(i);
+        } else if (c == QLatin1Char('(') || c == QLatin1Char('[') || c == QLatin1Char('{')) {
+            depth++;
+        } else if (c == QLatin1Char(')') || c == QLatin1Char(']') || c == QLatin1Char('}')) {
+            depth--;
+        } else if (c == QLatin1Char(';') && !depth) {
+            last = i;
+        }
+        previous = c;
+    }
+    if (depth || !quote.isNull()) {
+        return QString();
+    }
+    QString expression = s.mid(last + 1).trimmed();
+    static const QRegExp statement(QStringLiteral("^(var|let|const|function|class|if|for|while|do|switch|try|return|"
+                                                  "throw)\\b|^\\}"));
+    if (expression.isEmpty() || statement.indexIn(expression) >= 0) {
+        return QString();
+    }
+    return s.left(last + 1) + QStringLiteral("\nreturn (\n") + expression + QStringLiteral("\n);");
+}
+
+void TemplateInfoSender::compile(QJSEngine *eng) {
+    compiledEngine = eng;
+    compiled = QJSValue();
+    QString body = functionBody(jscript);
+    if (!body.isEmpty()) {
+        QJSValue f = eng->evaluate(QStringLiteral("(function() {\n") + body + QStringLiteral("\n})"));
+        if (f.isCallable()) {
+            compiled = f;
+            return;
+        }
+    }
+    qDebug() << QStringLiteral("Template") << templateId
+             << QStringLiteral("can't be precompiled: the script is evaluated at every update");
+}
+
 bool TemplateInfoSender::update(QJSEngine *eng) {
     if (!jscript.isEmpty()) {
-        QJSValue jsv = eng->evaluate(jscript);
+        if (compiledEngine != eng) {
+            compile(eng);
+        }
+        QJSValue jsv = compiled.isCallable() ? compiled.callWithInstance(eng->globalObject()) : eng->evaluate(jscript);
         if (!jsv.isError()) {
-            QString evalres = jsv.toString();
-            qDebug() << QStringLiteral("eval res ") << evalres;
-            return send(evalres);
+            return sendUpdate(jsv.toString());
         } else {
 #if (QT_VERSION < QT_VERSION_CHECK(5, 12, 0))
             int errorType = 255;
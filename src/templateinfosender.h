@@ -3,7 +3,9 @@
 #include <QJSEngine>
 #include <QObject>
 #include <QSettings>
+#include <QStringList>
 #include <QTimer>
+#include <QVector>
 
 class TemplateInfoSender : public QObject {
     Q_OBJECT
@@ -12,11 +14,38 @@ class TemplateInfoSender : public QObject {
     virtual ~TemplateInfoSender();
     virtual bool isRunning() const = 0;
     virtual bool send(const QString &data) = 0;
+    // the result of the script: a sender can drop it for a newer one, unlike the replies of send
+    virtual bool sendUpdate(const QString &data) { return send(data); }
     bool init(const QString &script);
     void stop();
     bool update(QJSEngine *eng);
     QString js() const;
     QString getId() const;
+
+    // the script is evaluated at most every template_<id>_interval ms
+    static const int defaultInterval = 1000;
+    static const int minInterval = 100;
+    static const int maxInterval = 60000;
+    int interval() const { return updateInterval; }
+    // whether the update at now (ms) is due, the tolerance absorbs the jitter of the timer that drives it
+    bool due(qint64 now, int tolerance) { return schedule(nextUpdate, now, updateInterval, tolerance); }
+    static bool schedule(qint64 &next, qint64 now, int interval, int tolerance);
+    // the script as the body of a function returning its value, empty when it has to be evaluated at every update
+    static QString functionBody(const QString &script);
+    // someone gets what send sends, when nobody does the script isn't evaluated at all
+    virtual bool hasClients() const { return isRunning(); }
+    // the workout as numbers instead of the result of the script, for the senders with a binary format
+    virtual bool binaryRecords() const { return false; }
+    virtual bool sendRecord(const QStringList &names, const QVector<double> &values) {
+        Q_UNUSED(names)
+        Q_UNUSED(values)
+        return false;
+    }
+    // the state of the app in JSON and in the Prometheus text format, refreshed every second by the builder
+    virtual void setSnapshot(const QByteArray &json, const QByteArray &metrics) {
+        Q_UNUSED(json)
+        Q_UNUSED(metrics)
+    }
   signals:
     void onDataReceived(QByteArray data);
 
@@ -30,7 +59,13 @@ class TemplateInfoSender : public QObject {
     void reinit();
 
   private:
+    void compile(QJSEngine *eng);
     QTimer retryTimer;
+    // the script as a function of the engine, called at every update instead of parsing the script again
+    QJSValue compiled;
+    QJSEngine *compiledEngine = nullptr;
+    int updateInterval = defaultInterval;
+    qint64 nextUpdate = 0;
 };
 
 #endif // TEMPLATEINFOSENDER_H
@@ -1,6 +1,10 @@
 #include "templateinfosenderbuilder.h"
 #include "bike.h"
+#include "bluetoothwatchdog.h"
+#include "controllatency.h"
+#include "logwriter.h"
 #include "treadmill.h"
+#include <QDateTime>
 #include <QDirIterator>
 #include <QJsonArray>
 #include <QJsonDocument>
@@ -8,15 +12,19 @@
 #include <QNetworkInterface>
 #include <QStandardPaths>
 #include <QTime>
+#include <QVector>
+#include <QtNumeric>
 #ifdef Q_HTTPSERVER
 #include "webserverinfosender.h"
 #endif
 #include "homeform.h"
 #include "tcpclientinfosender.h"
 #include "trainprogram.h"
-#include <chrono>
-
-using namespace std::chrono_literals;
+#if defined(Q_OS_LINUX)
+#include <unistd.h>
+#elif defined(Q_OS_DARWIN)
+#include <mach/mach.h>
+#endif
 
 QHash<QString, TemplateInfoSenderBuilder *> TemplateInfoSenderBuilder::instanceMap;
 TemplateInfoSenderBuilder::TemplateInfoSenderBuilder(QObject *parent) : QObject(parent) {
@@ -24,18 +32,52 @@ TemplateInfoSenderBuilder::TemplateInfoSenderBuilder(QObject *parent) : QObject(
     engine->installExtensions(QJSEngine::AllExtensions);
     connect(&updateTimer, &QTimer::timeout, this, &TemplateInfoSenderBuilder::onUpdateTimeout);
     updateTimer.setSingleShot(false);
+    connect(&controlTimer, &QTimer::timeout, this, &TemplateInfoSenderBuilder::onControlTimeout);
+    controlTimer.setInterval(250);
 }
 
 TemplateInfoSenderBuilder::~TemplateInfoSenderBuilder() { stop(); }
 
-void TemplateInfoSenderBuilder::onUpdateTimeout() {
-    buildContext();
+int TemplateInfoSenderBuilder::tickInterval() const {
+    int tick = sessionInterval;
+    for (TemplateInfoSender *t : templateInfoMap) {
+        tick = qMin(tick, t->interval());
+    }
+    return tick;
+}
+
+void TemplateInfoSenderBuilder::onUpdateTimeout() { onUpdate(updateClock.elapsed()); }
+
+void TemplateInfoSenderBuilder::onUpdate(qint64 now) {
+    int tolerance = updateTimer.interval() / 2;
+    bool sessionSample = TemplateInfoSender::schedule(nextSessionSample, now, sessionInterval, tolerance);
+    QList<TemplateInfoSender *> due;
     QHash<QString, TemplateInfoSender *>::Iterator it;
-    bool rv;
     for (it = templateInfoMap.begin(); it != templateInfoMap.end(); it++) {
-        rv = it.value()->update(engine);
+        if (it.value()->due(now, tolerance) && it.value()->hasClients()) {
+            due.append(it.value());
+        }
+    }
+    if (!sessionSample && due.isEmpty()) {
+        return;
+    }
+    buildContext(false, sessionSample);
+    if (sessionSample) {
+        publishSnapshot();
+    }
+    bool rv;
+    QVector<double> values;
+    for (TemplateInfoSender *t : qAsConst(due)) {
+        if (t->binaryRecords()) {
+            if (values.isEmpty()) {
+                values = workoutValues(workoutPushed);
+            }
+            rv = t->sendRecord(workoutFieldNames(), values);
+        } else {
+            rv = t->update(engine);
+        }
         if (!rv) {
-            qDebug() << QStringLiteral("Error updating") << it.key() << QStringLiteral("template");
+            qDebug() << QStringLiteral("Error updating") << t->getId() << QStringLiteral("template");
         }
     }
 }
@@ -193,177 +235,336 @@ TemplateInfoSender *TemplateInfoSenderBuilder::newTemplate(const QString &id, co
 void TemplateInfoSenderBuilder::reinit() { load(masterId, foldersToLook); }
 
 void TemplateInfoSenderBuilder::clearSessionArray() {
-    int len = sessionArray.count();
-    for (int i = 0; i < len; i++) {
-        sessionArray.removeAt(0);
-    }
+    sessionArray = QJsonArray();
+    sessionId++;
 }
 
 void TemplateInfoSenderBuilder::start(bluetoothdevice *dev) {
+    if (dev != device) {
+        lastWrite = 0;
+        writesReported = false;
+    }
     device = nullptr;
     clearSessionArray();
     buildContext(true);
     device = dev;
+    for (const controlbatch &batch : qAsConst(pendingControls)) {
+        sendControlReply(batch, QStringLiteral("timeout"));
+    }
+    pendingControls.clear();
+    if (device) {
+        connect(device, &bluetoothdevice::writeQueued, this, &TemplateInfoSenderBuilder::onWriteQueued,
+                Qt::UniqueConnection);
+        connect(device, &bluetoothdevice::writeCompleted, this, &TemplateInfoSenderBuilder::onWriteCompleted,
+                Qt::UniqueConnection);
+    }
     activityDescription = QLatin1String("");
-    updateTimer.start(1s);
+    if (!updateClock.isValid()) {
+        updateClock.start();
+    }
+    updateTimer.start(tickInterval());
 }
 
 QStringList TemplateInfoSenderBuilder::templateIdList() const { return templateFilesList.keys(); }
 
+// {keys: [...]} the settings asked, "$regex" for the keys matching it; {since: version, epoch: epoch} the settings
+// changed after the version, null the removed ones; nothing, all of them. The reply has the version and the epoch of
+// the settings: a version of another epoch, or ahead of this one, is from another run and gets all of them.
 void TemplateInfoSenderBuilder::onGetSettings(const QJsonValue &val, TemplateInfoSender *tempSender) {
+    settingsMirror.refresh();
+    qint64 version = (qint64)settingsMirror.version();
+    QJsonObject req = val.toObject();
+    QJsonArray keys_arr = req[QStringLiteral("keys")].toArray();
+    QJsonValue since = req[QStringLiteral("since")];
+    QJsonValue epoch = req[QStringLiteral("epoch")];
+    bool restarted = (epoch.isString() && epoch.toString() != settingsMirror.epoch()) ||
+                     (since.isDouble() && since.toDouble() > version);
+    if (keys_arr.isEmpty() && (!since.isDouble() || restarted)) {
+        if (settingsReply.isEmpty() || settingsReplyVersion != settingsMirror.version()) {
+            QJsonObject main;
+            main[QStringLiteral("msg")] = QStringLiteral("R_getsettings");
+            main[QStringLiteral("content")] = settingsMirror.toJson();
+            main[QStringLiteral("version")] = version;
+            main[QStringLiteral("epoch")] = settingsMirror.epoch();
+            settingsReply = QString::fromUtf8(QJsonDocument(main).toJson(QJsonDocument::Compact));
+            settingsReplyVersion = settingsMirror.version();
+        }
+        tempSender->send(settingsReply);
+        return;
+    }
     QJsonObject outObj;
-    QStringList keys = settings.allKeys();
-    QJsonValue keys_req;
-    QJsonArray keys_arr;
-    QVariantList keys_to_retrieve;
-    if (val.isObject() && (keys_req = val.toObject()[QStringLiteral("keys")]).isArray() &&
-        !(keys_arr = keys_req.toArray()).isEmpty()) {
-        keys_to_retrieve = keys_arr.toVariantList();
+    if (!keys_arr.isEmpty()) {
+        const QHash<QString, settingsmirror::entry> &entries = settingsMirror.entries();
         QString key;
-        for (auto &kk : keys_to_retrieve) {
+        for (const auto &kk : qAsConst(keys_arr)) {
             key = kk.toString();
             if (key.startsWith(QStringLiteral("$"))) {
                 outObj.insert(key, 1);
                 QRegExp regex(key.mid(1));
-                for (auto &keypresent : settings.allKeys()) {
-                    if (regex.indexIn(keypresent) >= 0) {
-                        outObj.insert(keypresent, QJsonValue::fromVariant(settings.value(keypresent)));
+                for (auto e = entries.constBegin(); e != entries.constEnd(); ++e) {
+                    if (!e->removed && regex.indexIn(e.key()) >= 0) {
+                        outObj.insert(e.key(), e->json);
                     }
                 }
-            } else if (settings.contains(key)) {
-                outObj.insert(key, QJsonValue::fromVariant(settings.value(key)));
+            } else if (settingsMirror.contains(key)) {
+                outObj.insert(key, entries[key].json);
             } else {
                 outObj.insert(key, QJsonValue());
             }
         }
     } else {
-        for (auto &key : settings.allKeys()) {
-            outObj.insert(key, QJsonValue::fromVariant(settings.value(key)));
-        }
+        outObj = settingsMirror.changes((quint64)since.toDouble());
     }
     QJsonObject main;
     main[QStringLiteral("msg")] = QStringLiteral("R_getsettings");
     main[QStringLiteral("content")] = outObj;
+    main[QStringLiteral("version")] = version;
+    main[QStringLiteral("epoch")] = settingsMirror.epoch();
     QJsonDocument out(main);
     tempSender->send(out.toJson());
 }
 
-void TemplateInfoSenderBuilder::onSetResistance(const QJsonValue &msgContent, TemplateInfoSender *tempSender) {
-    QJsonObject obj, outObj;
-    QJsonValue resVal;
-    outObj[QStringLiteral("value")] = QJsonValue(QJsonValue::Null);
-    if (device && msgContent.isObject() && (obj = msgContent.toObject()).contains(QStringLiteral("value")) &&
-        (resVal = msgContent[QStringLiteral("value")]).isDouble()) {
-        bluetoothdevice::BLUETOOTH_TYPE tp = device->deviceType();
-        if (tp == bluetoothdevice::BIKE || tp == bluetoothdevice::ROWING) {
-            int res;
-            if ((res = resVal.toInt()) >= 0 && res < 255) {
-                ((bike *)device)->changeResistance((uint8_t)res);
-                outObj[QStringLiteral("value")] = res;
-            }
-        } else {
-            double resd;
-            ((treadmill *)device)->changeInclination(resVal.toDouble(), resd = resVal.toDouble());
-            outObj[QStringLiteral("value")] = resd;
+// The targets of the set* messages and of the commands of control: the value applied, null when it's rejected.
+QJsonValue TemplateInfoSenderBuilder::targetResistance(const QJsonValue &value) {
+    if (!device || !value.isDouble()) {
+        return QJsonValue(QJsonValue::Null);
+    }
+    bluetoothdevice::BLUETOOTH_TYPE tp = device->deviceType();
+    if (tp == bluetoothdevice::BIKE || tp == bluetoothdevice::ROWING) {
+        int res;
+        if ((res = value.toInt()) >= 0 && res < 255) {
+            ((bike *)device)->changeResistance((uint8_t)res);
+            return res;
         }
+        return QJsonValue(QJsonValue::Null);
     }
-    QJsonObject main;
-    main[QStringLiteral("msg")] = QStringLiteral("R_setresistance");
-    main[QStringLiteral("content")] = outObj;
-    QJsonDocument out(main);
-    tempSender->send(out.toJson());
+    double resd = value.toDouble();
+    ((treadmill *)device)->changeInclination(resd, resd);
+    return resd;
 }
 
-void TemplateInfoSenderBuilder::onSetFanSpeed(const QJsonValue &msgContent, TemplateInfoSender *tempSender) {
-    QJsonObject obj, outObj;
-    QJsonValue resVal;
+QJsonValue TemplateInfoSenderBuilder::targetFanSpeed(const QJsonValue &value) {
     int res;
-    outObj[QStringLiteral("value")] = QJsonValue(QJsonValue::Null);
-    if (device && msgContent.isObject() && (obj = msgContent.toObject()).contains(QStringLiteral("value")) &&
-        (resVal = msgContent[QStringLiteral("value")]).isDouble() && (res = resVal.toInt()) >= 0 && res < 255) {
-        outObj[QStringLiteral("value")] = res;
-        ((bike *)device)->changeFanSpeed((uint8_t)res);
+    if (!device || !value.isDouble() || (res = value.toInt()) < 0 || res >= 255) {
+        return QJsonValue(QJsonValue::Null);
+    }
+    ((bike *)device)->changeFanSpeed((uint8_t)res);
+    return res;
+}
+
+QJsonValue TemplateInfoSenderBuilder::targetPower(const QJsonValue &value) {
+    int val;
+    if (!device || !value.isDouble() ||
+        (device->deviceType() != bluetoothdevice::BIKE && device->deviceType() != bluetoothdevice::ROWING) ||
+        (val = value.toInt()) <= 0) {
+        return QJsonValue(QJsonValue::Null);
+    }
+    ((bike *)device)->changePower((uint32_t)val);
+    return val;
+}
+
+QJsonValue TemplateInfoSenderBuilder::targetCadence(const QJsonValue &value) {
+    int val;
+    if (!device || !value.isDouble() ||
+        (device->deviceType() != bluetoothdevice::BIKE && device->deviceType() != bluetoothdevice::ROWING) ||
+        (val = value.toInt()) <= 0) {
+        return QJsonValue(QJsonValue::Null);
+    }
+    ((bike *)device)->changeCadence((uint16_t)val);
+    return val;
+}
+
+QJsonValue TemplateInfoSenderBuilder::targetSpeed(const QJsonValue &value) {
+    double vald;
+    if (!device || !value.isDouble() || device->deviceType() != bluetoothdevice::TREADMILL ||
+        (vald = value.toDouble()) < 0) {
+        return QJsonValue(QJsonValue::Null);
     }
+    ((treadmill *)device)->changeSpeed(vald);
+    return vald;
+}
+
+QJsonValue TemplateInfoSenderBuilder::targetInclination(const QJsonValue &value) {
+    if (!device || !value.isDouble()) {
+        return QJsonValue(QJsonValue::Null);
+    }
+    double vald = value.toDouble();
+    device->changeInclination(vald, vald);
+    return vald;
+}
+
+QJsonValue TemplateInfoSenderBuilder::targetDifficult(const QJsonValue &value) {
+    double vald;
+    if (!device || !value.isDouble() || (vald = value.toDouble()) < 0) {
+        return QJsonValue(QJsonValue::Null);
+    }
+    device->setDifficult(vald);
+    return vald;
+}
+
+void TemplateInfoSenderBuilder::onSetTarget(const QString &reply, targethandler target, const QJsonValue &msgContent,
+                                            TemplateInfoSender *tempSender) {
+    QJsonObject outObj;
+    outObj[QStringLiteral("value")] =
+        msgContent.isObject() ? (this->*target)(msgContent[QStringLiteral("value")]) : QJsonValue(QJsonValue::Null);
     QJsonObject main;
-    main[QStringLiteral("msg")] = QStringLiteral("R_setfanspeed");
+    main[QStringLiteral("msg")] = reply;
     main[QStringLiteral("content")] = outObj;
     QJsonDocument out(main);
     tempSender->send(out.toJson());
 }
 
+void TemplateInfoSenderBuilder::onSetResistance(const QJsonValue &msgContent, TemplateInfoSender *tempSender) {
+    onSetTarget(QStringLiteral("R_setresistance"), &TemplateInfoSenderBuilder::targetResistance, msgContent,
+                tempSender);
+}
+
+void TemplateInfoSenderBuilder::onSetFanSpeed(const QJsonValue &msgContent, TemplateInfoSender *tempSender) {
+    onSetTarget(QStringLiteral("R_setfanspeed"), &TemplateInfoSenderBuilder::targetFanSpeed, msgContent, tempSender);
+}
+
 void TemplateInfoSenderBuilder::onSetPower(const QJsonValue &msgContent, TemplateInfoSender *tempSender) {
-    QJsonObject obj, outObj;
-    QJsonValue resVal;
-    outObj[QStringLiteral("value")] = QJsonValue(QJsonValue::Null);
-    if (device && msgContent.isObject() && (obj = msgContent.toObject()).contains(QStringLiteral("value")) &&
-        (resVal = msgContent[QStringLiteral("value")]).isDouble() &&
-        (device->deviceType() == bluetoothdevice::BIKE || device->deviceType() == bluetoothdevice::ROWING)) {
-        int val;
-        if ((val = resVal.toInt()) > 0) {
-            ((bike *)device)->changePower((uint32_t)val);
-            outObj[QStringLiteral("value")] = val;
+    onSetTarget(QStringLiteral("R_setpower"), &TemplateInfoSenderBuilder::targetPower, msgContent, tempSender);
+}
+
+void TemplateInfoSenderBuilder::onSetCadence(const QJsonValue &msgContent, TemplateInfoSender *tempSender) {
+    onSetTarget(QStringLiteral("R_setcadence"), &TemplateInfoSenderBuilder::targetCadence, msgContent, tempSender);
+}
+
+void TemplateInfoSenderBuilder::onSetSpeed(const QJsonValue &msgContent, TemplateInfoSender *tempSender) {
+    onSetTarget(QStringLiteral("R_setspeed"), &TemplateInfoSenderBuilder::targetSpeed, msgContent, tempSender);
+}
+
+void TemplateInfoSenderBuilder::onSetDifficult(const QJsonValue &msgContent, TemplateInfoSender *tempSender) {
+    onSetTarget(QStringLiteral("R_setdifficult"), &TemplateInfoSenderBuilder::targetDifficult, msgContent, tempSender);
+}
+
+void TemplateInfoSenderBuilder::onControl(const QJsonValue &msgContent, TemplateInfoSender *tempSender) {
+    static const QHash<QString, targethandler> targets = {
+        {QStringLiteral("resistance"), &TemplateInfoSenderBuilder::targetResistance},
+        {QStringLiteral("fanspeed"), &TemplateInfoSenderBuilder::targetFanSpeed},
+        {QStringLiteral("power"), &TemplateInfoSenderBuilder::targetPower},
+        {QStringLiteral("cadence"), &TemplateInfoSenderBuilder::targetCadence},
+        {QStringLiteral("speed"), &TemplateInfoSenderBuilder::targetSpeed},
+        {QStringLiteral("inclination"), &TemplateInfoSenderBuilder::targetInclination},
+        {QStringLiteral("difficult"), &TemplateInfoSenderBuilder::targetDifficult},
+    };
+    QJsonObject content = msgContent.toObject();
+    controlbatch batch;
+    batch.id = content.value(QStringLiteral("id"));
+    batch.sender = tempSender;
+    batch.clock.start();
+    // only the writes the driver reports can be matched with their completion
+    batch.watched = device && device->watchdog() && writesReported;
+    const QJsonArray commands = content.value(QStringLiteral("commands")).toArray();
+    // a driver can write the request right away, in the change* call
+    quint64 writes = lastWrite;
+    for (const QJsonValue &c : commands) {
+        QJsonObject command = c.toObject();
+        controlcommand cc;
+        cc.target = command.value(QStringLiteral("target")).toString();
+        targethandler target = targets.value(cc.target, nullptr);
+        cc.value = target ? (this->*target)(command.value(QStringLiteral("value"))) : QJsonValue(QJsonValue::Null);
+        cc.applied = !cc.value.isNull();
+        cc.requested = batch.clock.nsecsElapsed();
+        batch.commands.append(cc);
+        batch.pending |= cc.applied;
+    }
+    if (!batch.pending) {
+        sendControlReply(batch, QStringLiteral("rejected"));
+        return;
+    }
+    if (writes != lastWrite) {
+        if (!batch.watched) {
+            sendControlReply(batch, QStringLiteral("queued"));
+            return;
         }
+        batch.write = lastWrite;
+    }
+    pendingControls.append(batch);
+    if (!controlTimer.isActive()) {
+        controlTimer.start();
     }
-    QJsonObject main;
-    main[QStringLiteral("msg")] = QStringLiteral("R_setpower");
-    main[QStringLiteral("content")] = outObj;
-    QJsonDocument out(main);
-    tempSender->send(out.toJson());
 }
 
-void TemplateInfoSenderBuilder::onSetCadence(const QJsonValue &msgContent, TemplateInfoSender *tempSender) {
-    QJsonObject obj, outObj;
-    QJsonValue resVal;
-    outObj[QStringLiteral("value")] = QJsonValue(QJsonValue::Null);
-    if (device && msgContent.isObject() && (obj = msgContent.toObject()).contains(QStringLiteral("value")) &&
-        (resVal = msgContent[QStringLiteral("value")]).isDouble() &&
-        (device->deviceType() == bluetoothdevice::BIKE || device->deviceType() == bluetoothdevice::ROWING)) {
-        int val;
-        if ((val = resVal.toInt()) > 0) {
-            ((bike *)device)->changeCadence((uint16_t)val);
-            outObj[QStringLiteral("value")] = val;
+void TemplateInfoSenderBuilder::sendControlReply(const controlbatch &batch, const QString &status) {
+    if (!batch.sender) {
+        return;
+    }
+    qint64 confirmed = batch.clock.nsecsElapsed();
+    QJsonArray commands;
+    for (const controlcommand &c : batch.commands) {
+        QJsonObject o;
+        o[QStringLiteral("target")] = c.target;
+        o[QStringLiteral("value")] = c.value;
+        if (c.applied) {
+            o[QStringLiteral("status")] = status;
+            o[QStringLiteral("latency")] = (confirmed - c.requested) / 1000000.0;
+        } else {
+            o[QStringLiteral("status")] = QStringLiteral("rejected");
         }
+        commands.append(o);
     }
+    QJsonObject outObj;
+    outObj[QStringLiteral("id")] = batch.id;
+    outObj[QStringLiteral("status")] = status;
+    outObj[QStringLiteral("commands")] = commands;
     QJsonObject main;
-    main[QStringLiteral("msg")] = QStringLiteral("R_setcadence");
+    main[QStringLiteral("msg")] = QStringLiteral("R_control");
     main[QStringLiteral("content")] = outObj;
-    QJsonDocument out(main);
-    tempSender->send(out.toJson());
+    batch.sender->send(QJsonDocument(main).toJson(QJsonDocument::Compact));
 }
 
-void TemplateInfoSenderBuilder::onSetSpeed(const QJsonValue &msgContent, TemplateInfoSender *tempSender) {
-    QJsonObject obj, outObj;
-    QJsonValue resVal;
-    double vald;
-    outObj[QStringLiteral("value")] = QJsonValue(QJsonValue::Null);
-    if (device && msgContent.isObject() && (obj = msgContent.toObject()).contains(QStringLiteral("value")) &&
-        (resVal = msgContent[QStringLiteral("value")]).isDouble() &&
-        device->deviceType() == bluetoothdevice::TREADMILL && (vald = resVal.toDouble()) >= 0) {
-        ((treadmill *)device)->changeSpeed(vald);
-        outObj[QStringLiteral("value")] = vald;
+void TemplateInfoSenderBuilder::onWriteQueued(quint64 write) {
+    if (sender() != device) {
+        return;
+    }
+    lastWrite = write;
+    writesReported = true;
+    for (int i = 0; i < pendingControls.count();) {
+        controlbatch &batch = pendingControls[i];
+        if (!batch.watched) {
+            // nothing tells when the machine got it: the driver writing the request is all there is
+            sendControlReply(batch, QStringLiteral("queued"));
+            pendingControls.removeAt(i);
+            continue;
+        }
+        if (!batch.write) {
+            batch.write = write;
+        }
+        i++;
     }
-    QJsonObject main;
-    main[QStringLiteral("msg")] = QStringLiteral("R_setspeed");
-    main[QStringLiteral("content")] = outObj;
-    QJsonDocument out(main);
-    tempSender->send(out.toJson());
 }
 
-void TemplateInfoSenderBuilder::onSetDifficult(const QJsonValue &msgContent, TemplateInfoSender *tempSender) {
-    QJsonObject obj, outObj;
-    QJsonValue resVal;
-    outObj[QStringLiteral("value")] = QJsonValue(QJsonValue::Null);
-    double vald;
-    if (device && msgContent.isObject() && (obj = msgContent.toObject()).contains(QStringLiteral("value")) &&
-        (resVal = msgContent[QStringLiteral("value")]).isDouble() && (vald = resVal.toDouble()) >= 0) {
-        device->setDifficult(vald);
-        outObj[QStringLiteral("value")] = vald;
+void TemplateInfoSenderBuilder::onWriteCompleted(quint64 write) {
+    if (sender() != device || !write) {
+        return;
+    }
+    // the first request the driver writes after the commands were applied carries them, the drivers write what's
+    // pending at once: the polls and the other writes completing in between have a different token
+    for (int i = 0; i < pendingControls.count();) {
+        const controlbatch &batch = pendingControls.at(i);
+        if (batch.write == write) {
+            sendControlReply(batch, QStringLiteral("written"));
+            pendingControls.removeAt(i);
+        } else {
+            i++;
+        }
+    }
+}
+
+void TemplateInfoSenderBuilder::onControlTimeout() {
+    for (int i = 0; i < pendingControls.count();) {
+        if (pendingControls.at(i).clock.elapsed() > controlTimeout) {
+            sendControlReply(pendingControls.at(i), QStringLiteral("timeout"));
+            pendingControls.removeAt(i);
+        } else {
+            i++;
+        }
+    }
+    if (pendingControls.isEmpty()) {
+        controlTimer.stop();
     }
-    QJsonObject main;
-    main[QStringLiteral("msg")] = QStringLiteral("R_setdifficult");
-    main[QStringLiteral("content")] = outObj;
-    QJsonDocument out(main);
-    tempSender->send(out.toJson());
 }
 
 void TemplateInfoSenderBuilder::onSetSettings(const QJsonValue &msgContent, TemplateInfoSender *tempSender) {
@@ -374,29 +575,30 @@ void TemplateInfoSenderBuilder::onSetSettings(const QJsonValue &msgContent, Temp
     QStringList keys = obj.keys();
     QJsonValue val;
     QVariant valConv;
-    QVariant settingVal;
     QJsonObject outObj;
+    // written at once, a single version for all of them
+    QVariantHash batch;
+    settingsMirror.refresh();
     for (auto &key : keys) {
-        if (settings.contains(key)) {
-            val = obj[key];
-            valConv = val.toVariant();
-            settingVal = settings.value(key);
-            if (valConv.type() == settingVal.type()) {
-                settings.setValue(key, valConv);
-                outObj.insert(key, val);
-            } else {
-                outObj.insert(key, QJsonValue::fromVariant(settingVal));
-            }
+        val = obj[key];
+        valConv = val.toVariant();
+        if (settingsMirror.contains(key) && valConv.type() != settingsMirror.value(key).type()) {
+            outObj.insert(key, settingsMirror.entries()[key].json);
         } else {
-            val = obj[key];
-            settings.setValue(key, val.toVariant());
+            batch.insert(key, valConv);
             outObj.insert(key, val);
         }
     }
-    settings.sync();
+    settingsMirror.set(batch);
+    QJSValue sett = engine->globalObject().property(QStringLiteral("settings"));
+    if (sett.isObject()) {
+        reflectSettings(sett);
+    }
     QJsonObject main;
     main[QStringLiteral("msg")] = QStringLiteral("R_setsettings");
     main[QStringLiteral("content")] = outObj;
+    main[QStringLiteral("version")] = (qint64)settingsMirror.version();
+    main[QStringLiteral("epoch")] = settingsMirror.epoch();
     QJsonDocument out(main);
     tempSender->send(out.toJson());
 }
@@ -468,11 +670,81 @@ void TemplateInfoSenderBuilder::onAppendActivityDescription(const QJsonValue &ms
     tempSender->send(out.toJson());
 }
 
-void TemplateInfoSenderBuilder::onGetSessionArray(TemplateInfoSender *tempSender) {
+void TemplateInfoSenderBuilder::onGetSessionArray(const QJsonValue &msgContent, TemplateInfoSender *tempSender) {
+    Q_UNUSED(msgContent)
     QJsonObject main;
     main[QStringLiteral("content")] = sessionArray;
     main[QStringLiteral("msg")] = QStringLiteral("R_getsessionarray");
     QJsonDocument out(main);
+    tempSender->send(out.toJson(QJsonDocument::Compact));
+}
+
+// The session from a cursor: content {from, count, session, format}, all optional. The reply has the samples
+// [from, next) out of total, so a client fetches the backfill a chunk at a time and then only the samples added since
+// its last request. A cursor of another session (the samples were cleared meanwhile) starts again from 0.
+// The samples are column arrays by default, {keys: [...], columns: [[...], ...]} with columns[k][i] the key k of the
+// sample from + i (null if the sample doesn't have it), or the objects of getsessionarray with format "rows".
+void TemplateInfoSenderBuilder::onGetSession(const QJsonValue &msgContent, TemplateInfoSender *tempSender) {
+    QJsonObject content = msgContent.toObject();
+    int total = sessionArray.count();
+    int from = qBound(0, content.value(QStringLiteral("from")).toInt(0), total);
+    if (content.contains(QStringLiteral("session")) && content.value(QStringLiteral("session")).toInt() != sessionId) {
+        from = 0;
+    }
+    int count = qBound(1, content.value(QStringLiteral("count")).toInt(sessionChunk), sessionChunkMax);
+    int next = qMin(total, from + count);
+
+    QJsonObject outObj;
+    outObj[QStringLiteral("session")] = sessionId;
+    outObj[QStringLiteral("from")] = from;
+    outObj[QStringLiteral("next")] = next;
+    outObj[QStringLiteral("total")] = total;
+    if (content.value(QStringLiteral("format")).toString() == QStringLiteral("rows")) {
+        QJsonArray rows;
+        for (int i = from; i < next; i++) {
+            rows.append(sessionArray.at(i));
+        }
+        outObj[QStringLiteral("rows")] = rows;
+    } else {
+        QStringList keys;
+        QHash<QString, int> index;
+        QVector<QJsonObject> samples;
+        samples.reserve(next - from);
+        for (int i = from; i < next; i++) {
+            samples.append(sessionArray.at(i).toObject());
+            for (auto it = samples.last().constBegin(); it != samples.last().constEnd(); ++it) {
+                if (!index.contains(it.key())) {
+                    index.insert(it.key(), keys.count());
+                    keys.append(it.key());
+                }
+            }
+        }
+        QJsonArray columns;
+        for (const QString &key : qAsConst(keys)) {
+            QJsonArray column;
+            for (const QJsonObject &sample : qAsConst(samples)) {
+                QJsonValue v = sample.value(key);
+                column.append(v.isUndefined() ? QJsonValue() : v);
+            }
+            columns.append(column);
+        }
+        outObj[QStringLiteral("keys")] = QJsonArray::fromStringList(keys);
+        outObj[QStringLiteral("columns")] = columns;
+    }
+
+    QJsonObject main;
+    main[QStringLiteral("content")] = outObj;
+    main[QStringLiteral("msg")] = QStringLiteral("R_getsession");
+    QJsonDocument out(main);
+    tempSender->send(out.toJson(QJsonDocument::Compact));
+}
+
+void TemplateInfoSenderBuilder::onGetControlLatency(const QJsonValue &msgContent, TemplateInfoSender *tempSender) {
+    Q_UNUSED(msgContent)
+    QJsonObject main;
+    main[QStringLiteral("content")] = device ? device->controlLatency()->toJson() : QJsonObject();
+    main[QStringLiteral("msg")] = QStringLiteral("R_getcontrollatency");
+    QJsonDocument out(main);
     tempSender->send(out.toJson());
 }
 
@@ -577,6 +849,25 @@ void TemplateInfoSenderBuilder::onSaveChart(const QJsonValue &msgContent, Templa
     tempSender->send(out.toJson());
 }
 
+const QHash<QString, TemplateInfoSenderBuilder::messagehandler> TemplateInfoSenderBuilder::messageHandlers = {
+    {QStringLiteral("getsettings"), &TemplateInfoSenderBuilder::onGetSettings},
+    {QStringLiteral("setresistance"), &TemplateInfoSenderBuilder::onSetResistance},
+    {QStringLiteral("setpower"), &TemplateInfoSenderBuilder::onSetPower},
+    {QStringLiteral("setcadence"), &TemplateInfoSenderBuilder::onSetCadence},
+    {QStringLiteral("setdifficult"), &TemplateInfoSenderBuilder::onSetDifficult},
+    {QStringLiteral("setspeed"), &TemplateInfoSenderBuilder::onSetSpeed},
+    {QStringLiteral("setfanspeed"), &TemplateInfoSenderBuilder::onSetFanSpeed},
+    {QStringLiteral("setsettings"), &TemplateInfoSenderBuilder::onSetSettings},
+    {QStringLiteral("loadtrainingprograms"), &TemplateInfoSenderBuilder::onLoadTrainingPrograms},
+    {QStringLiteral("appendactivitydescription"), &TemplateInfoSenderBuilder::onAppendActivityDescription},
+    {QStringLiteral("savetrainingprogram"), &TemplateInfoSenderBuilder::onSaveTrainingProgram},
+    {QStringLiteral("savechart"), &TemplateInfoSenderBuilder::onSaveChart},
+    {QStringLiteral("getsessionarray"), &TemplateInfoSenderBuilder::onGetSessionArray},
+    {QStringLiteral("getsession"), &TemplateInfoSenderBuilder::onGetSession},
+    {QStringLiteral("getcontrollatency"), &TemplateInfoSenderBuilder::onGetControlLatency},
+    {QStringLiteral("control"), &TemplateInfoSenderBuilder::onControl},
+};
+
 void TemplateInfoSenderBuilder::onDataReceived(const QByteArray &data) {
     TemplateInfoSender *sender = qobject_cast<TemplateInfoSender *>(this->sender());
     if (!sender) {
@@ -588,45 +879,9 @@ void TemplateInfoSenderBuilder::onDataReceived(const QByteArray &data) {
         if (jsonObject.contains(QStringLiteral("msg"))) {
             QJsonValue msgType = jsonObject[QStringLiteral("msg")];
             if (msgType.isString()) {
-                QString msg = msgType.toString();
-                if (msg == QStringLiteral("getsettings")) {
-                    onGetSettings(jsonObject[QStringLiteral("content")], sender);
-                    return;
-                } else if (msg == QStringLiteral("setresistance")) {
-                    onSetResistance(jsonObject[QStringLiteral("content")], sender);
-                    return;
-                } else if (msg == QStringLiteral("setpower")) {
-                    onSetPower(jsonObject[QStringLiteral("content")], sender);
-                    return;
-                } else if (msg == QStringLiteral("setcadence")) {
-                    onSetCadence(jsonObject[QStringLiteral("content")], sender);
-                    return;
-                } else if (msg == QStringLiteral("setdifficult")) {
-                    onSetDifficult(jsonObject[QStringLiteral("content")], sender);
-                    return;
-                } else if (msg == QStringLiteral("setspeed")) {
-                    onSetSpeed(jsonObject[QStringLiteral("content")], sender);
-                    return;
-                } else if (msg == QStringLiteral("setfanspeed")) {
-                    onSetFanSpeed(jsonObject[QStringLiteral("content")], sender);
-                    return;
-                } else if (msg == QStringLiteral("setsettings")) {
-                    onSetSettings(jsonObject[QStringLiteral("content")], sender);
-                    return;
-                } else if (msg == QStringLiteral("loadtrainingprograms")) {
-                    onLoadTrainingPrograms(jsonObject[QStringLiteral("content")], sender);
-                    return;
-                } else if (msg == QStringLiteral("appendactivitydescription")) {
-                    onAppendActivityDescription(jsonObject[QStringLiteral("content")], sender);
-                    return;
-                } else if (msg == QStringLiteral("savetrainingprogram")) {
-                    onSaveTrainingProgram(jsonObject[QStringLiteral("content")], sender);
-                    return;
-                } else if (msg == QStringLiteral("savechart")) {
-                    onSaveChart(jsonObject[QStringLiteral("content")], sender);
-                    return;
-                } else if (msg == QStringLiteral("getsessionarray")) {
-                    onGetSessionArray(sender);
+                messagehandler handler = messageHandlers.value(msgType.toString(), nullptr);
+                if (handler) {
+                    (this->*handler)(jsonObject[QStringLiteral("content")], sender);
                     return;
                 }
             }
@@ -635,142 +890,388 @@ void TemplateInfoSenderBuilder::onDataReceived(const QByteArray &data) {
     qDebug() << QStringLiteral("Unrecognized message") << data;
 }
 
-void TemplateInfoSenderBuilder::buildContext(bool forceReinit) {
+const QString &TemplateInfoSenderBuilder::workoutFieldName(int field) {
+    static const QString names[W_FIELDS] = {QStringLiteral("deviceId"), QStringLiteral("deviceName"),
+                                            QStringLiteral("deviceRSSI"), QStringLiteral("deviceNotifyInterval"),
+                                            QStringLiteral("deviceNotifyIntervalMax"),
+                                            QStringLiteral("deviceNotifyRate"), QStringLiteral("deviceWriteLatency"),
+                                            QStringLiteral("deviceStalls"), QStringLiteral("deviceReconnections"),
+                                            QStringLiteral("deviceRecovering"), QStringLiteral("controlLatency"),
+                                            QStringLiteral("controlLatencyP95"), QStringLiteral("deviceType"),
+                                            QStringLiteral("deviceConnected"), QStringLiteral("devicePaused"),
+                                            QStringLiteral("elapsed_s"), QStringLiteral("elapsed_m"),
+                                            QStringLiteral("elapsed_h"), QStringLiteral("pace_s"),
+                                            QStringLiteral("pace_m"), QStringLiteral("pace_h"),
+                                            QStringLiteral("moving_s"), QStringLiteral("moving_m"),
+                                            QStringLiteral("moving_h"), QStringLiteral("speed"),
+                                            QStringLiteral("speed_avg"), QStringLiteral("calories"),
+                                            QStringLiteral("distance"), QStringLiteral("heart"),
+                                            QStringLiteral("heart_avg"), QStringLiteral("heart_max"),
+                                            QStringLiteral("jouls"), QStringLiteral("elevation"),
+                                            QStringLiteral("difficult"), QStringLiteral("watts"),
+                                            QStringLiteral("watts_avg"), QStringLiteral("watts_max"),
+                                            QStringLiteral("kgwatts"), QStringLiteral("kgwatts_avg"),
+                                            QStringLiteral("kgwatts_max"), QStringLiteral("workoutName"),
+                                            QStringLiteral("workoutStartDate"), QStringLiteral("instructorName"),
+                                            QStringLiteral("latitude"), QStringLiteral("longitude"),
+                                            QStringLiteral("nickName"), QStringLiteral("peloton_resistance"),
+                                            QStringLiteral("peloton_resistance_avg"), QStringLiteral("cadence"),
+                                            QStringLiteral("cadence_avg"), QStringLiteral("resistance"),
+                                            QStringLiteral("resistance_avg"), QStringLiteral("cranks"),
+                                            QStringLiteral("cranktime"), QStringLiteral("req_power"),
+                                            QStringLiteral("req_cadence"), QStringLiteral("req_resistance"),
+                                            QStringLiteral("strokescount"), QStringLiteral("strokeslength"),
+                                            QStringLiteral("inclination"), QStringLiteral("inclination_avg")};
+    return names[field];
+}
+
+const QStringList &TemplateInfoSenderBuilder::workoutFieldNames() {
+    static QStringList names;
+    if (names.isEmpty()) {
+        for (int i = 0; i < W_FIELDS; i++) {
+            names.append(workoutFieldName(i));
+        }
+    }
+    return names;
+}
+
+QVector<double> TemplateInfoSenderBuilder::workoutValues(const workoutsnapshot &s) {
+    QVector<double> values(W_FIELDS, qQNaN());
+    for (int i = 0; i < W_FIELDS; i++) {
+        if (s.fields[i].isDouble()) {
+            values[i] = s.fields[i].toDouble();
+        } else if (s.fields[i].isBool()) {
+            values[i] = s.fields[i].toBool() ? 1 : 0;
+        }
+    }
+    return values;
+}
+
+QJsonObject TemplateInfoSenderBuilder::workoutsnapshot::toJson() const {
+    QJsonObject o;
+    for (int i = 0; i < W_FIELDS; i++) {
+        if (!fields[i].isUndefined()) {
+            o.insert(workoutFieldName(i), fields[i]);
+        }
+    }
+    return o;
+}
+
+static QJSValue toScriptValue(const QJsonValue &v) {
+    switch (v.type()) {
+    case QJsonValue::Bool:
+        return QJSValue(v.toBool());
+    case QJsonValue::Double:
+        return QJSValue(v.toDouble());
+    case QJsonValue::String:
+        return QJSValue(v.toString());
+    case QJsonValue::Null:
+        return QJSValue(QJSValue::NullValue);
+    default:
+        return QJSValue();
+    }
+}
+
+void TemplateInfoSenderBuilder::readWorkout(workoutsnapshot &s) const {
+    QTime el = device->elapsedTime();
+    QString name;
+    QString nickName;
+    bluetoothdevice::BLUETOOTH_TYPE tp = device->deviceType();
+    QJsonValue *f = s.fields;
+
+    metric dep;
+#ifdef Q_OS_IOS
+    f[W_DEVICE_ID] = device->bluetoothDevice.deviceUuid().toString();
+#else
+    f[W_DEVICE_ID] = device->bluetoothDevice.address().toString();
+#endif
+    f[W_DEVICE_NAME] = (name = device->bluetoothDevice.name()).isEmpty() ? QString(QStringLiteral("N/A")) : name;
+    f[W_DEVICE_RSSI] = device->bluetoothDevice.rssi();
+    bluetoothwatchdog *watchdog = device->watchdog();
+    if (watchdog) {
+        f[W_DEVICE_NOTIFY_INTERVAL] = watchdog->notificationInterval();
+        f[W_DEVICE_NOTIFY_INTERVAL_MAX] = watchdog->notificationIntervalMax();
+        f[W_DEVICE_NOTIFY_RATE] = watchdog->notificationRate();
+        f[W_DEVICE_WRITE_LATENCY] = watchdog->writeLatency();
+        f[W_DEVICE_STALLS] = (int)watchdog->stalls();
+        f[W_DEVICE_RECONNECTIONS] = (int)watchdog->reconnections();
+        f[W_DEVICE_RECOVERING] = watchdog->recovering();
+    }
+    const controllatency::histogram &latency = device->controlLatency()->interval(controllatency::TOTAL);
+    f[W_CONTROL_LATENCY] = latency.average();
+    f[W_CONTROL_LATENCY_P95] = latency.percentile(0.95);
+    f[W_DEVICE_TYPE] = (int)tp;
+    f[W_DEVICE_CONNECTED] = (bool)device->connected();
+    f[W_DEVICE_PAUSED] = (bool)device->isPaused();
+    f[W_ELAPSED_S] = el.second();
+    f[W_ELAPSED_M] = el.minute();
+    f[W_ELAPSED_H] = el.hour();
+    el = device->currentPace();
+    f[W_PACE_S] = el.second();
+    f[W_PACE_M] = el.minute();
+    f[W_PACE_H] = el.hour();
+    el = device->movingTime();
+    f[W_MOVING_S] = el.second();
+    f[W_MOVING_M] = el.minute();
+    f[W_MOVING_H] = el.hour();
+    f[W_SPEED] = (dep = device->currentSpeed()).value();
+    f[W_SPEED_AVG] = dep.average();
+    f[W_CALORIES] = device->calories().value();
+    f[W_DISTANCE] = device->odometer();
+    f[W_HEART] = (dep = device->currentHeart()).value();
+    f[W_HEART_AVG] = dep.average();
+    f[W_HEART_MAX] = dep.max();
+    f[W_JOULS] = device->jouls().value();
+    f[W_ELEVATION] = device->elevationGain().value();
+    f[W_DIFFICULT] = device->difficult();
+    f[W_WATTS] = (dep = device->wattsMetric()).value();
+    f[W_WATTS_AVG] = dep.average();
+    f[W_WATTS_MAX] = dep.max();
+    f[W_KGWATTS] = (dep = device->wattKg()).value();
+    f[W_KGWATTS_AVG] = dep.average();
+    f[W_KGWATTS_MAX] = dep.max();
+    f[W_WORKOUT_NAME] = workoutName;
+    f[W_WORKOUT_START_DATE] = workoutStartDate;
+    f[W_INSTRUCTOR_NAME] = instructorName;
+    f[W_LATITUDE] = device->currentCordinate().latitude();
+    f[W_LONGITUDE] = device->currentCordinate().longitude();
+    nickName = settings.value(QStringLiteral("user_nickname"), QStringLiteral("")).toString();
+    f[W_NICKNAME] = nickName.isEmpty() ? QString(QStringLiteral("N/A")) : nickName;
+    if (tp == bluetoothdevice::BIKE) {
+        f[W_PELOTON_RESISTANCE] = (dep = ((bike *)device)->pelotonResistance()).value();
+        f[W_PELOTON_RESISTANCE_AVG] = dep.average();
+        f[W_CADENCE] = (dep = ((bike *)device)->currentCadence()).value();
+        f[W_CADENCE_AVG] = dep.average();
+        f[W_RESISTANCE] = (dep = ((bike *)device)->currentResistance()).value();
+        f[W_RESISTANCE_AVG] = dep.average();
+        f[W_CRANKS] = ((bike *)device)->currentCrankRevolutions();
+        f[W_CRANKTIME] = ((bike *)device)->lastCrankEventTime();
+        f[W_REQ_POWER] = ((bike *)device)->lastRequestedPower().value();
+        f[W_REQ_CADENCE] = ((bike *)device)->lastRequestedCadence().value();
+        f[W_REQ_RESISTANCE] = ((bike *)device)->lastRequestedResistance().value();
+    } else if (tp == bluetoothdevice::ROWING) {
+        f[W_PELOTON_RESISTANCE] = (dep = ((rower *)device)->pelotonResistance()).value();
+        f[W_PELOTON_RESISTANCE_AVG] = dep.average();
+        f[W_CADENCE] = (dep = ((rower *)device)->currentCadence()).value();
+        f[W_CADENCE_AVG] = dep.average();
+        f[W_RESISTANCE] = (dep = ((rower *)device)->currentResistance()).value();
+        f[W_RESISTANCE_AVG] = dep.average();
+        f[W_CRANKS] = ((rower *)device)->currentCrankRevolutions();
+        f[W_CRANKTIME] = ((rower *)device)->lastCrankEventTime();
+        f[W_STROKESCOUNT] = ((rower *)device)->currentStrokesCount().value();
+        f[W_STROKESLENGTH] = ((rower *)device)->currentStrokesLength().value();
+    } else {
+        f[W_INCLINATION] = (dep = ((treadmill *)device)->currentInclination()).value();
+        f[W_INCLINATION_AVG] = dep.average();
+    }
+}
+
+void TemplateInfoSenderBuilder::reflectSetting(QJSValue &sett, const QString &key, const QVariant &value) {
+    QVariant::Type typesett = value.type();
+    if (typesett == QVariant::Int) {
+        sett.setProperty(key, value.toInt());
+    } else if (typesett == QVariant::Double) {
+        sett.setProperty(key, value.toDouble());
+    } else if (typesett == QVariant::String) {
+        sett.setProperty(key, value.toString());
+    } else if (typesett == QVariant::Bool) {
+        sett.setProperty(key, value.toBool());
+    } else if (typesett == QVariant::UInt) {
+        sett.setProperty(key, value.toUInt());
+    } else if (typesett == QVariant::StringList) {
+        QStringList settL = value.toStringList();
+        QJSValue settLJ = engine->newArray(settL.size());
+        int i = 0;
+        for (const auto &settLK : qAsConst(settL)) {
+            settLJ.setProperty(i++, settLK);
+        }
+        sett.setProperty(key, settLJ);
+    }
+}
+
+void TemplateInfoSenderBuilder::reflectSettings(QJSValue &sett) {
+    const QHash<QString, settingsmirror::entry> &entries = settingsMirror.entries();
+    for (auto e = entries.constBegin(); e != entries.constEnd(); ++e) {
+        if (e->version <= settingsReflected) {
+            continue;
+        }
+        if (e->removed) {
+            sett.deleteProperty(e.key());
+        } else {
+            reflectSetting(sett, e.key(), e->value);
+        }
+    }
+    settingsReflected = settingsMirror.version();
+}
+
+void TemplateInfoSenderBuilder::buildContext(bool forceReinit, bool sessionSample) {
     QJSValue glob = engine->globalObject();
     QJSValue obj;
     if (!glob.hasOwnProperty(QStringLiteral("workout")) || forceReinit) {
         obj = engine->newObject();
         glob.setProperty(QStringLiteral("workout"), obj);
-    } else
-        obj = glob.property(QStringLiteral("workout"));
-
-    if (!glob.hasOwnProperty(QStringLiteral("settings")) || forceReinit) {
-        QJSValue sett = engine->newObject();
-        glob.setProperty(QStringLiteral("settings"), sett);
-        QVariant::Type typesett;
-        QVariant valsett;
-        int i = 0;
-        auto allKeys_list = settings.allKeys();
-        for (const auto &key : allKeys_list) {
-            valsett.setValue(settings.value(key));
-            typesett = valsett.type();
-            if (typesett == QVariant::Int) {
-                sett.setProperty(key, valsett.toInt());
-            } else if (typesett == QVariant::Double) {
-                sett.setProperty(key, valsett.toDouble());
-            } else if (typesett == QVariant::String) {
-                sett.setProperty(key, valsett.toString());
-            } else if (typesett == QVariant::Bool) {
-                sett.setProperty(key, valsett.toBool());
-            } else if (typesett == QVariant::UInt) {
-                sett.setProperty(key, valsett.toUInt());
-            } else if (typesett == QVariant::StringList) {
-                QStringList settL = valsett.toStringList();
-                QJSValue settLJ = engine->newArray(settL.size());
-                i = 0;
-                for (const auto &settLK : qAsConst(settL)) {
-                    settLJ.setProperty(i++, settLK);
-                }
-                sett.setProperty(key, settLJ);
-            }
-        }
         obj.setProperty(QStringLiteral("BIKE_TYPE"), (int)bluetoothdevice::BIKE);
         obj.setProperty(QStringLiteral("ELLIPTICAL_TYPE"), (int)bluetoothdevice::ELLIPTICAL);
         obj.setProperty(QStringLiteral("ROWING_TYPE"), (int)bluetoothdevice::ROWING);
         obj.setProperty(QStringLiteral("TREADMILL_TYPE"), (int)bluetoothdevice::TREADMILL);
         obj.setProperty(QStringLiteral("UNKNOWN_TYPE"), (int)bluetoothdevice::UNKNOWN);
+        workoutPushed = workoutsnapshot();
+    } else
+        obj = glob.property(QStringLiteral("workout"));
+
+    if (!glob.hasOwnProperty(QStringLiteral("settings")) || forceReinit) {
+        QJSValue sett = glob.property(QStringLiteral("settings"));
+        if (!sett.isObject()) {
+            sett = engine->newObject();
+            glob.setProperty(QStringLiteral("settings"), sett);
+            settingsReflected = 0;
+        }
+        settingsMirror.refresh(true);
+    }
+    // only the keys added, changed or removed since the previous time
+    if (settingsMirror.version() != settingsReflected) {
+        QJSValue sett = glob.property(QStringLiteral("settings"));
+        reflectSettings(sett);
     }
-    if (!device) {
-        obj.setProperty(QStringLiteral("deviceId"), QJSValue());
-    } else {
-        QTime el = device->elapsedTime();
-        QString name;
-        QString nickName;
-        bluetoothdevice::BLUETOOTH_TYPE tp = device->deviceType();
 
-        metric dep;
-#ifdef Q_OS_IOS
-        obj.setProperty("deviceId", device->bluetoothDevice.deviceUuid().toString());
-#else
-        obj.setProperty(QStringLiteral("deviceId"), device->bluetoothDevice.address().toString());
-#endif
-        obj.setProperty(QStringLiteral("deviceName"),
-                        (name = device->bluetoothDevice.name()).isEmpty() ? QString(QStringLiteral("N/A")) : name);
-        obj.setProperty(QStringLiteral("deviceRSSI"), device->bluetoothDevice.rssi());
-        obj.setProperty(QStringLiteral("deviceType"), (int)device->deviceType());
-        obj.setProperty(QStringLiteral("deviceConnected"), (bool)device->connected());
-        obj.setProperty(QStringLiteral("devicePaused"), (bool)device->isPaused());
-        obj.setProperty(QStringLiteral("elapsed_s"), el.second());
-        obj.setProperty(QStringLiteral("elapsed_m"), el.minute());
-        obj.setProperty(QStringLiteral("elapsed_h"), el.hour());
-        el = device->currentPace();
-        obj.setProperty(QStringLiteral("pace_s"), el.second());
-        obj.setProperty(QStringLiteral("pace_m"), el.minute());
-        obj.setProperty(QStringLiteral("pace_h"), el.hour());
-        el = device->movingTime();
-        obj.setProperty(QStringLiteral("moving_s"), el.second());
-        obj.setProperty(QStringLiteral("moving_m"), el.minute());
-        obj.setProperty(QStringLiteral("moving_h"), el.hour());
-        obj.setProperty(QStringLiteral("speed"), (dep = device->currentSpeed()).value());
-        obj.setProperty(QStringLiteral("speed_avg"), dep.average());
-        obj.setProperty(QStringLiteral("calories"), device->calories().value());
-        obj.setProperty(QStringLiteral("distance"), device->odometer());
-        obj.setProperty(QStringLiteral("heart"), (dep = device->currentHeart()).value());
-        obj.setProperty(QStringLiteral("heart_avg"), dep.average());
-        obj.setProperty(QStringLiteral("heart_max"), dep.max());
-        obj.setProperty(QStringLiteral("jouls"), device->jouls().value());
-        obj.setProperty(QStringLiteral("elevation"), device->elevationGain().value());
-        obj.setProperty(QStringLiteral("difficult"), device->difficult());
-        obj.setProperty(QStringLiteral("watts"), (dep = device->wattsMetric()).value());
-        obj.setProperty(QStringLiteral("watts_avg"), dep.average());
-        obj.setProperty(QStringLiteral("watts_max"), dep.max());
-        obj.setProperty(QStringLiteral("kgwatts"), (dep = device->wattKg()).value());
-        obj.setProperty(QStringLiteral("kgwatts_avg"), dep.average());
-        obj.setProperty(QStringLiteral("kgwatts_max"), dep.max());
-        obj.setProperty(QStringLiteral("workoutName"), workoutName);
-        obj.setProperty(QStringLiteral("workoutStartDate"), workoutStartDate);
-        obj.setProperty(QStringLiteral("instructorName"), instructorName);
-        obj.setProperty(QStringLiteral("latitude"), device->currentCordinate().latitude());
-        obj.setProperty(QStringLiteral("longitude"), device->currentCordinate().longitude());
-        obj.setProperty(
-            QStringLiteral("nickName"),
-            (nickName = settings.value(QStringLiteral("user_nickname"), QStringLiteral("")).toString()).isEmpty()
-                ? QString(QStringLiteral("N/A"))
-                : nickName);
-        if (tp == bluetoothdevice::BIKE) {
-            obj.setProperty(QStringLiteral("peloton_resistance"),
-                            (dep = ((bike *)device)->pelotonResistance()).value());
-            obj.setProperty(QStringLiteral("peloton_resistance_avg"), dep.average());
-            obj.setProperty(QStringLiteral("cadence"), (dep = ((bike *)device)->currentCadence()).value());
-            obj.setProperty(QStringLiteral("cadence_avg"), dep.average());
-            obj.setProperty(QStringLiteral("resistance"), (dep = ((bike *)device)->currentResistance()).value());
-            obj.setProperty(QStringLiteral("resistance_avg"), dep.average());
-            obj.setProperty(QStringLiteral("cranks"), ((bike *)device)->currentCrankRevolutions());
-            obj.setProperty(QStringLiteral("cranktime"), ((bike *)device)->lastCrankEventTime());
-            obj.setProperty(QStringLiteral("req_power"), (dep = ((bike *)device)->lastRequestedPower()).value());
-            obj.setProperty(QStringLiteral("req_cadence"), (dep = ((bike *)device)->lastRequestedCadence()).value());
-            obj.setProperty(QStringLiteral("req_resistance"),
-                            (dep = ((bike *)device)->lastRequestedResistance()).value());
-        } else if (tp == bluetoothdevice::ROWING) {
-            obj.setProperty(QStringLiteral("peloton_resistance"),
-                            (dep = ((rower *)device)->pelotonResistance()).value());
-            obj.setProperty(QStringLiteral("peloton_resistance_avg"), dep.average());
-            obj.setProperty(QStringLiteral("cadence"), (dep = ((rower *)device)->currentCadence()).value());
-            obj.setProperty(QStringLiteral("cadence_avg"), dep.average());
-            obj.setProperty(QStringLiteral("resistance"), (dep = ((rower *)device)->currentResistance()).value());
-            obj.setProperty(QStringLiteral("resistance_avg"), dep.average());
-            obj.setProperty(QStringLiteral("cranks"), ((rower *)device)->currentCrankRevolutions());
-            obj.setProperty(QStringLiteral("cranktime"), ((rower *)device)->lastCrankEventTime());
-            obj.setProperty(QStringLiteral("strokescount"), ((rower *)device)->currentStrokesCount().value());
-            obj.setProperty(QStringLiteral("strokeslength"), ((rower *)device)->currentStrokesLength().value());
+    workoutsnapshot current;
+    if (device) {
+        readWorkout(current);
+    }
+    for (int i = 0; i < W_FIELDS; i++) {
+        const QJsonValue &v = current.fields[i];
+        if (v == workoutPushed.fields[i]) {
+            continue;
+        }
+        if (v.isUndefined()) {
+            obj.deleteProperty(workoutFieldName(i));
         } else {
-            obj.setProperty(QStringLiteral("inclination"), (dep = ((treadmill *)device)->currentInclination()).value());
-            obj.setProperty(QStringLiteral("inclination_avg"), dep.average());
+            obj.setProperty(workoutFieldName(i), toScriptValue(v));
         }
-        if (!device->isPaused()) {
-            sessionArray.append(QJsonObject::fromVariantMap(obj.toVariant().toMap()));
+    }
+    workoutPushed = current;
+    if (sessionSample && device && !device->isPaused()) {
+        sessionArray.append(current.toJson());
+    }
+}
+
+// resident set size of the process in bytes, -1 where it isn't known
+static qint64 processResidentMemory() {
+#if defined(Q_OS_LINUX)
+    QFile f(QStringLiteral("/proc/self/statm"));
+    if (f.open(QIODevice::ReadOnly)) {
+        QList<QByteArray> pages = f.readAll().split(' ');
+        if (pages.count() > 1) {
+            return pages.at(1).toLongLong() * sysconf(_SC_PAGESIZE);
         }
     }
+#elif defined(Q_OS_DARWIN)
+    mach_task_basic_info info;
+    mach_msg_type_number_t count = MACH_TASK_BASIC_INFO_COUNT;
+    if (task_info(mach_task_self(), MACH_TASK_BASIC_INFO, (task_info_t)&info, &count) == KERN_SUCCESS) {
+        return info.resident_size;
+    }
+#endif
+    return -1;
+}
+
+static void appendMetric(QByteArray &out, const char *name, const char *type, const char *help, double value) {
+    out += QByteArrayLiteral("# HELP ") + name + ' ' + help + '\n';
+    out += QByteArrayLiteral("# TYPE ") + name + ' ' + type + '\n';
+    out += name + (' ' + QByteArray::number(value, 'g', 10)) + '\n';
+}
+
+static QByteArray metricLabel(QString value) {
+    return value.replace(QLatin1Char('\\'), QStringLiteral("\\\\"))
+        .replace(QLatin1Char('"'), QStringLiteral("\\\""))
+        .replace(QLatin1Char('\n'), QStringLiteral("\\n"))
+        .toUtf8();
+}
+
+void TemplateInfoSenderBuilder::publishSnapshot() {
+    static const struct {
+        WORKOUT_FIELD field;
+        const char *name;
+        const char *help;
+    } gauges[] = {
+        {W_SPEED, "qz_speed_kmh", "Current speed."},
+        {W_WATTS, "qz_power_watts", "Current power."},
+        {W_HEART, "qz_heart_bpm", "Current heart rate."},
+        {W_CADENCE, "qz_cadence_rpm", "Current cadence."},
+        {W_RESISTANCE, "qz_resistance", "Current resistance level."},
+        {W_INCLINATION, "qz_inclination_percent", "Current inclination."},
+        {W_DISTANCE, "qz_distance_km", "Distance of the workout."},
+        {W_CALORIES, "qz_calories_kcal", "Calories of the workout."},
+        {W_DEVICE_RSSI, "qz_device_rssi_dbm", "RSSI of the device."},
+        {W_DEVICE_NOTIFY_RATE, "qz_device_notification_rate_hz", "Notifications per second of the device."},
+        {W_DEVICE_NOTIFY_INTERVAL_MAX, "qz_device_notification_interval_max_ms",
+         "Longest time between two notifications of the device."},
+        {W_DEVICE_WRITE_LATENCY, "qz_device_write_latency_ms", "Average round trip of the writes to the device."},
+        {W_CONTROL_LATENCY, "qz_control_latency_ms", "Average latency of the control requests."},
+    };
+    static const struct {
+        WORKOUT_FIELD field;
+        const char *name;
+        const char *help;
+    } counters[] = {
+        {W_DEVICE_STALLS, "qz_device_stalls_total", "Notification streams of the device that stopped."},
+        {W_DEVICE_RECONNECTIONS, "qz_device_reconnections_total", "Reconnections to the device."},
+    };
+
+    const QJsonValue *f = workoutPushed.fields;
+    bluetoothwatchdog *watchdog = device ? device->watchdog() : nullptr;
+    int writeQueue = watchdog ? watchdog->pendingWriteCount() : 0;
+    quint64 logDropped = logwriter::totalDropped();
+    qint64 rss = processResidentMemory();
+
+    QByteArray metrics;
+    metrics.reserve(4096);
+    if (device) {
+        metrics += QByteArrayLiteral("# HELP qz_device_info The device of the workout.\n# TYPE qz_device_info gauge\n"
+                                     "qz_device_info{id=\"") +
+                   metricLabel(f[W_DEVICE_ID].toString()) + QByteArrayLiteral("\",name=\"") +
+                   metricLabel(f[W_DEVICE_NAME].toString()) + QByteArrayLiteral("\",type=\"") +
+                   QByteArray::number(f[W_DEVICE_TYPE].toInt()) + QByteArrayLiteral("\"} 1\n");
+    }
+    appendMetric(metrics, "qz_device_connected", "gauge", "1 when the device is connected.",
+                 f[W_DEVICE_CONNECTED].toBool() ? 1 : 0);
+    appendMetric(metrics, "qz_device_paused", "gauge", "1 when the workout is paused.",
+                 f[W_DEVICE_PAUSED].toBool() ? 1 : 0);
+    for (const auto &g : gauges) {
+        if (f[g.field].isDouble()) {
+            appendMetric(metrics, g.name, "gauge", g.help, f[g.field].toDouble());
+        }
+    }
+    for (const auto &c : counters) {
+        if (f[c.field].isDouble()) {
+            appendMetric(metrics, c.name, "counter", c.help, f[c.field].toDouble());
+        }
+    }
+    if (watchdog) {
+        appendMetric(metrics, "qz_device_write_queue", "gauge", "Writes to the device waiting for completion.",
+                     writeQueue);
+    }
+    appendMetric(metrics, "qz_log_dropped_total", "counter", "Log lines dropped because the log writer was behind.",
+                 logDropped);
+    if (rss >= 0) {
+        appendMetric(metrics, "process_resident_memory_bytes", "gauge", "Resident memory size in bytes.", rss);
+    }
+
+    QJsonObject snapshot;
+    snapshot[QStringLiteral("timestamp")] = QDateTime::currentMSecsSinceEpoch();
+    snapshot[QStringLiteral("workout")] = workoutPushed.toJson();
+    if (watchdog) {
+        snapshot[QStringLiteral("writeQueue")] = writeQueue;
+    }
+    snapshot[QStringLiteral("logDropped")] = (qint64)logDropped;
+    if (rss >= 0) {
+        snapshot[QStringLiteral("rss")] = rss;
+    }
+    QByteArray json = QJsonDocument(snapshot).toJson(QJsonDocument::Compact);
+
+    for (TemplateInfoSender *t : qAsConst(templateInfoMap)) {
+        t->setSnapshot(json, metrics);
+    }
 }
 
 void TemplateInfoSenderBuilder::workoutEventStateChanged(bluetoothdevice::WORKOUT_EVENT_STATE state) {
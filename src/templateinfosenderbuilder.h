@@ -1,10 +1,14 @@
 #ifndef TEMPLATEINFOSENDERBUILDER_H
 #define TEMPLATEINFOSENDERBUILDER_H
 #include "bluetoothdevice.h"
+#include "settingsmirror.h"
 #include "templateinfosender.h"
+#include <QElapsedTimer>
 #include <QHash>
 #include <QJSEngine>
 #include <QJsonArray>
+#include <QJsonObject>
+#include <QPointer>
 #include <QSettings>
 
 #define TEMPLATE_TYPE_TCPCLIENT QStringLiteral("TcpClient")
@@ -26,17 +30,115 @@ class TemplateInfoSenderBuilder : public QObject {
     void chartSaved(QString filename);
 
   private:
+    // the properties of the workout object of the templates
+    enum WORKOUT_FIELD {
+        W_DEVICE_ID = 0,
+        W_DEVICE_NAME,
+        W_DEVICE_RSSI,
+        W_DEVICE_NOTIFY_INTERVAL,
+        W_DEVICE_NOTIFY_INTERVAL_MAX,
+        W_DEVICE_NOTIFY_RATE,
+        W_DEVICE_WRITE_LATENCY,
+        W_DEVICE_STALLS,
+        W_DEVICE_RECONNECTIONS,
+        W_DEVICE_RECOVERING,
+        W_CONTROL_LATENCY,
+        W_CONTROL_LATENCY_P95,
+        W_DEVICE_TYPE,
+        W_DEVICE_CONNECTED,
+        W_DEVICE_PAUSED,
+        W_ELAPSED_S,
+        W_ELAPSED_M,
+        W_ELAPSED_H,
+        W_PACE_S,
+        W_PACE_M,
+        W_PACE_H,
+        W_MOVING_S,
+        W_MOVING_M,
+        W_MOVING_H,
+        W_SPEED,
+        W_SPEED_AVG,
+        W_CALORIES,
+        W_DISTANCE,
+        W_HEART,
+        W_HEART_AVG,
+        W_HEART_MAX,
+        W_JOULS,
+        W_ELEVATION,
+        W_DIFFICULT,
+        W_WATTS,
+        W_WATTS_AVG,
+        W_WATTS_MAX,
+        W_KGWATTS,
+        W_KGWATTS_AVG,
+        W_KGWATTS_MAX,
+        W_WORKOUT_NAME,
+        W_WORKOUT_START_DATE,
+        W_INSTRUCTOR_NAME,
+        W_LATITUDE,
+        W_LONGITUDE,
+        W_NICKNAME,
+        W_PELOTON_RESISTANCE,
+        W_PELOTON_RESISTANCE_AVG,
+        W_CADENCE,
+        W_CADENCE_AVG,
+        W_RESISTANCE,
+        W_RESISTANCE_AVG,
+        W_CRANKS,
+        W_CRANKTIME,
+        W_REQ_POWER,
+        W_REQ_CADENCE,
+        W_REQ_RESISTANCE,
+        W_STROKESCOUNT,
+        W_STROKESLENGTH,
+        W_INCLINATION,
+        W_INCLINATION_AVG,
+        W_FIELDS
+    };
+    // the workout of a tick, undefined where the device doesn't have the field
+    struct workoutsnapshot {
+        QJsonValue fields[W_FIELDS];
+        QJsonObject toJson() const;
+    };
+    static const QString &workoutFieldName(int field);
+    static const QStringList &workoutFieldNames();
+    // the fields as the binary records have them, NaN where they aren't numbers
+    static QVector<double> workoutValues(const workoutsnapshot &s);
     bool validFileTemplateType(const QString &tp) const;
-    void buildContext(bool forceReinit = false);
+    void buildContext(bool forceReinit = false, bool sessionSample = true);
+    void readWorkout(workoutsnapshot &s) const;
+    void reflectSetting(QJSValue &sett, const QString &key, const QVariant &value);
+    // the settings changed in settingsMirror since they were reflected the last time
+    void reflectSettings(QJSValue &sett);
+    // the snapshot of the web servers' /api/snapshot and /metrics, from the workout of the last tick
+    void publishSnapshot();
     QString activityDescription;
     void createTemplatesFromFolder(const QString &idInfo, const QString &folder, QStringList &dirTemplates);
     void clearSessionArray();
     bluetoothdevice *device = nullptr;
     QTimer updateTimer;
+    // ticks at the shortest interval of the templates, they are updated when they're due
+    QElapsedTimer updateClock;
+    int tickInterval() const;
+    // the session gets a sample every second whatever the intervals of the templates
+    static const int sessionInterval = 1000;
+    qint64 nextSessionSample = 0;
     QString masterId;
     QStringList foldersToLook;
     QJsonArray sessionArray;
+    // changes when sessionArray is cleared, the cursors of getsession are valid within a session only
+    int sessionId = 0;
+    // samples per getsession response: the default, and the most a client can ask
+    static const int sessionChunk = 600;
+    static const int sessionChunkMax = 3600;
     QHash<QString, QVariant> context;
+    // what the engine has: buildContext pushes only the fields of the workout and the settings that changed
+    workoutsnapshot workoutPushed;
+    settingsmirror settingsMirror;
+    quint64 settingsReflected = 0;
+    // the reply of getsettings without keys, for the version of the settings it has
+    QString settingsReply;
+    quint64 settingsReplyVersion = 0;
     QJSEngine *engine = nullptr;
     TemplateInfoSenderBuilder(QObject *parent);
     void load(const QString &idInfo, const QStringList &folders);
@@ -57,13 +159,61 @@ class TemplateInfoSenderBuilder : public QObject {
     void onSaveTrainingProgram(const QJsonValue &msgContent, TemplateInfoSender *tempSender);
     void onLoadTrainingPrograms(const QJsonValue &msgContent, TemplateInfoSender *tempSender);
     void onAppendActivityDescription(const QJsonValue &msgContent, TemplateInfoSender *tempSender);
-    void onGetSessionArray(TemplateInfoSender *tempSender);
+    void onGetSessionArray(const QJsonValue &msgContent, TemplateInfoSender *tempSender);
+    void onGetSession(const QJsonValue &msgContent, TemplateInfoSender *tempSender);
+    void onGetControlLatency(const QJsonValue &msgContent, TemplateInfoSender *tempSender);
+    void onControl(const QJsonValue &msgContent, TemplateInfoSender *tempSender);
+    // the messages of the templates by msg
+    typedef void (TemplateInfoSenderBuilder::*messagehandler)(const QJsonValue &msgContent,
+                                                               TemplateInfoSender *tempSender);
+    static const QHash<QString, messagehandler> messageHandlers;
+
+    typedef QJsonValue (TemplateInfoSenderBuilder::*targethandler)(const QJsonValue &value);
+    QJsonValue targetResistance(const QJsonValue &value);
+    QJsonValue targetFanSpeed(const QJsonValue &value);
+    QJsonValue targetPower(const QJsonValue &value);
+    QJsonValue targetCadence(const QJsonValue &value);
+    QJsonValue targetSpeed(const QJsonValue &value);
+    QJsonValue targetInclination(const QJsonValue &value);
+    QJsonValue targetDifficult(const QJsonValue &value);
+    void onSetTarget(const QString &reply, targethandler target, const QJsonValue &msgContent,
+                     TemplateInfoSender *tempSender);
+
+    // The commands of a control message. They're acknowledged together (R_control) when the write of the first
+    // request the driver takes after them completes, when it's queued if nothing reports the completions, or on
+    // timeout. The write is recognized by its token (bluetoothdevice::writeQueued/writeCompleted).
+    struct controlcommand {
+        QString target;
+        QJsonValue value;
+        bool applied = false;
+        qint64 requested = 0;
+    };
+    struct controlbatch {
+        QJsonValue id;
+        QPointer<TemplateInfoSender> sender;
+        QElapsedTimer clock;
+        QList<controlcommand> commands;
+        bool pending = false;
+        bool watched = false;
+        quint64 write = 0; // the token of the write carrying the commands, 0 until it's queued
+    };
+    static const int controlTimeout = 5000;
+    QList<controlbatch> pendingControls;
+    QTimer controlTimer;
+    quint64 lastWrite = 0;       // the token of the last write carrying a request
+    bool writesReported = false; // the driver of the device reports the writes of its requests
+    void sendControlReply(const controlbatch &batch, const QString &status);
     QString workoutName = QStringLiteral("");
     QString workoutStartDate = QStringLiteral("");
     QString instructorName = QStringLiteral("");
   private slots:
     void onUpdateTimeout();
+    // the update at now, in ms of updateClock: the timer ticks with the clock, the benchmarks with a simulated one
+    void onUpdate(qint64 now);
     void onDataReceived(const QByteArray &data);
+    void onWriteQueued(quint64 write);
+    void onWriteCompleted(quint64 write);
+    void onControlTimeout();
   public slots:
     void onWorkoutNameChanged(QString name) { workoutName = name; }
     void onWorkoutStartDate(QString name) { workoutStartDate = name; }
@@ -0,0 +1,337 @@
+#include "bluetooth.h"
+#include "domyosbike.h"
+#include "framing.h"
+#include "ftmsparser.h"
+#include "gpx.h"
+#include "logging.h"
+#include "metric.h"
+#include "qfit.h"
+#include "sessionline.h"
+#include "simulatedbike.h"
+#include "templateinfosenderbuilder.h"
+#include "trainprogram.h"
+#include "zwiftworkout.h"
+#include <QDir>
+#include <QFile>
+#include <QSettings>
+#include <QWebSocket>
+#include <QtMath>
+#include <QtTest>
+
+// Micro benchmarks of the data path: the packets of the devices, the metrics, the train programs, the files of the
+// workouts and the templates. The inputs are synthetic sessions of 1 min to 10 h.
+//
+//   ./benchmarks -o results.xml,xml
+//   compare.py base.xml results.xml
+//
+// see compare.py to track them commit by commit.
+class benchmarks : public QObject {
+    Q_OBJECT
+
+  private:
+    static void scales(int maxSeconds = 36000);
+    static QList<SessionLine> syntheticSession(int seconds);
+    static double syntheticWatts(int second) { return 180.0 + (60.0 * qSin(second / 30.0)); }
+
+    bluetooth *manager = nullptr;
+    simulatedbike *device = nullptr;
+    // a client of the inner web server: the templates without clients aren't updated
+    QWebSocket *client = nullptr;
+    QString fileName(const QString &suffix) const { return QDir::tempPath() + QStringLiteral("/benchmarks") + suffix; }
+
+  private slots:
+    void initTestCase();
+    void cleanupTestCase();
+
+    void metricSetValue_data() { scales(); }
+    void metricSetValue();
+    void ftmsParser_data() { scales(); }
+    void ftmsParser();
+    void domyosParser_data() { scales(); }
+    void domyosParser();
+    void logPacket_data();
+    void logPacket();
+    void updateMetrics_data() { scales(); }
+    void updateMetrics();
+    void trainprogramScheduler_data() { scales(); }
+    void trainprogramScheduler();
+    void zwiftworkoutLoad_data() { scales(); }
+    void zwiftworkoutLoad();
+    void gpxOpen_data() { scales(); }
+    void gpxOpen();
+    void qfitSave_data() { scales(); }
+    void qfitSave();
+    // a JS context per second: 10 h would take minutes for each iteration
+    void templateUpdate_data() { scales(3600); }
+    void templateUpdate();
+};
+
+namespace {
+
+// the output of the app is formatted but it doesn't reach the console, as it'd be the slowest part of each benchmark
+void messageHandler(QtMsgType type, const QMessageLogContext &context, const QString &msg) {
+    Q_UNUSED(context);
+    if (type != QtDebugMsg && type != QtInfoMsg) {
+        fprintf(stderr, "%s\n", qPrintable(msg));
+    }
+}
+
+// exposes the per second accounting of the devices
+class metricsbike : public bike {
+  public:
+    void tick(double watts) {
+        Speed = 30;
+        update_metrics(true, watts);
+    }
+};
+
+} // namespace
+
+void benchmarks::scales(int maxSeconds) {
+    static const struct {
+        const char *name;
+        int seconds;
+    } sessions[] = {{"1 min", 60}, {"10 min", 600}, {"1 h", 3600}, {"10 h", 36000}};
+
+    QTest::addColumn<int>("seconds");
+    for (const auto &s : sessions) {
+        if (s.seconds <= maxSeconds) {
+            QTest::newRow(s.name) << s.seconds;
+        }
+    }
+}
+
+QList<SessionLine> benchmarks::syntheticSession(int seconds) {
+    QList<SessionLine> session;
+    session.reserve(seconds);
+    QDateTime start = QDateTime::currentDateTime();
+    double distance = 0;
+    double calories = 0;
+    for (int i = 0; i < seconds; i++) {
+        double watts = syntheticWatts(i);
+        double speed = metric::calculateSpeedFromPower(watts);
+        distance += speed / 3600.0;
+        calories += watts / 4184.0 * 4.0;
+        session.append(SessionLine(speed, 0, distance, watts, 10, 30, 120 + (i % 40), 0, 85 + (i % 10), calories, 0, i,
+                                   false, 0, 0, 0, 0, QGeoCoordinate(), start.addSecs(i)));
+    }
+    return session;
+}
+
+void benchmarks::initTestCase() {
+    QCoreApplication::setOrganizationName(QStringLiteral("Roberto Viola"));
+    QCoreApplication::setOrganizationDomain(QStringLiteral("robertoviola.cloud"));
+    QCoreApplication::setApplicationName(QStringLiteral("qDomyos-Zwift-benchmarks"));
+    qInstallMessageHandler(messageHandler);
+    logging::setEnabled(false);
+
+    QSettings settings;
+    settings.clear();
+    settings.setValue(QStringLiteral("virtual_device_enabled"), false);
+
+    manager = new bluetooth(false, QLatin1String(""), false, false, 200, true);
+    device = qobject_cast<simulatedbike *>(manager->device());
+    QVERIFY(device);
+    // moving, as trainprogram and the templates skip the stopped devices
+    device->advance(1.0);
+
+#ifdef Q_HTTPSERVER
+    // the web server template of the inner manager, enabled by bluetooth, on the port it has chosen
+    int port = settings.value(QStringLiteral("template_inner_" TEMPLATE_PRIVATE_WEBSERVER_ID "_port"), 0).toInt();
+    QVERIFY(settings.value(QStringLiteral("template_inner_" TEMPLATE_PRIVATE_WEBSERVER_ID "_enabled")).toBool());
+    QVERIFY(port > 0);
+    client = new QWebSocket();
+    client->open(QUrl(QStringLiteral("ws://127.0.0.1:%1/").arg(port)));
+    QTRY_VERIFY_WITH_TIMEOUT(client->state() == QAbstractSocket::ConnectedState, 5000);
+#endif
+}
+
+void benchmarks::cleanupTestCase() {
+    delete client;
+    delete manager;
+    QSettings settings;
+    settings.clear();
+}
+
+void benchmarks::metricSetValue() {
+    QFETCH(int, seconds);
+    metric m;
+    m.setType(metric::METRIC_WATT);
+    QBENCHMARK {
+        for (int i = 0; i < seconds; i++) {
+            m.setValue(syntheticWatts(i));
+        }
+    }
+}
+
+void benchmarks::ftmsParser() {
+    QFETCH(int, seconds);
+    // Indoor Bike Data with speed, cadence, power and heart rate, as most of the bikes send it
+    QList<QByteArray> packets;
+    for (int i = 0; i < seconds; i++) {
+        uint16_t speed = (uint16_t)(metric::calculateSpeedFromPower(syntheticWatts(i)) * 100);
+        uint16_t cadence = (85 + (i % 10)) * 2;
+        int16_t power = (int16_t)syntheticWatts(i);
+        const char packet[] = {0x44,
+                               0x02,
+                               (char)(speed & 0xFF),
+                               (char)(speed >> 8),
+                               (char)(cadence & 0xFF),
+                               (char)(cadence >> 8),
+                               (char)(power & 0xFF),
+                               (char)(power >> 8),
+                               (char)(120 + (i % 40))};
+        packets.append(QByteArray(packet, sizeof(packet)));
+    }
+    QBENCHMARK {
+        ftmsparser::data d;
+        for (const QByteArray &packet : qAsConst(packets)) {
+            ftmsparser::parse(0x2AD2, packet.constData(), packet.length(), d);
+        }
+    }
+}
+
+void benchmarks::domyosParser() {
+    QFETCH(int, seconds);
+    // the 26 bytes status of the bikes, split in 20 + 6 bytes as the T900 does
+    QList<QByteArray> fragments;
+    for (int i = 0; i < seconds; i++) {
+        uint8_t packet[26] = {0xf0, 0xbc};
+        uint16_t speed = (uint16_t)(metric::calculateSpeedFromPower(syntheticWatts(i)) * 10);
+        packet[6] = speed >> 8;
+        packet[7] = speed & 0xFF;
+        packet[9] = 85 + (i % 10);
+        packet[11] = (i / 60) & 0xFF;
+        packet[13] = (i / 10) & 0xFF;
+        packet[14] = 5 + (i % 5);
+        packet[18] = 120 + (i % 40);
+        sum8checksum<>::seal(packet, sizeof(packet));
+        fragments.append(QByteArray((const char *)packet, 20));
+        fragments.append(QByteArray((const char *)packet + 20, sizeof(packet) - 20));
+    }
+    domyosbike domyos;
+    QLowEnergyCharacteristic characteristic;
+    QBENCHMARK {
+        for (const QByteArray &fragment : qAsConst(fragments)) {
+            QMetaObject::invokeMethod(&domyos, "characteristicChanged", Qt::DirectConnection,
+                                      Q_ARG(QLowEnergyCharacteristic, characteristic), Q_ARG(QByteArray, fragment));
+        }
+    }
+}
+
+void benchmarks::logPacket_data() {
+    QTest::addColumn<bool>("enabled");
+    QTest::newRow("disabled") << false;
+    QTest::newRow("enabled") << true;
+}
+
+void benchmarks::logPacket() {
+    QFETCH(bool, enabled);
+    // the lines of a packet of a driver: the hex dump and the metrics decoded
+    const QByteArray packet = QByteArray::fromHex("f0bc00000000012c0055000a0014070000007800000000000042");
+    logging::setEnabled(enabled);
+    QBENCHMARK {
+        for (int i = 0; i < 1000; i++) {
+            LOG_PACKET(QStringLiteral(" << ") + packet.toHex(' '));
+            LOG_DEVICE(QStringLiteral("Current Watt: ") + QString::number(syntheticWatts(i)));
+        }
+    }
+    logging::setEnabled(false);
+}
+
+void benchmarks::updateMetrics() {
+    QFETCH(int, seconds);
+    metricsbike metrics;
+    QBENCHMARK {
+        for (int i = 0; i < seconds; i++) {
+            metrics.tick(syntheticWatts(i));
+        }
+    }
+}
+
+void benchmarks::trainprogramScheduler() {
+    QFETCH(int, seconds);
+    // a row per minute
+    QList<trainrow> rows;
+    for (int i = 0; i < qMax(1, seconds / 60); i++) {
+        trainrow row;
+        row.duration = QTime(0, 1, 0);
+        row.power = syntheticWatts(i * 60);
+        rows.append(row);
+    }
+    trainprogram program(rows, manager);
+    program.stopTimer();
+    QBENCHMARK {
+        program.restart();
+        for (int i = 0; i < seconds; i++) {
+            program.scheduler();
+        }
+    }
+}
+
+void benchmarks::zwiftworkoutLoad() {
+    QFETCH(int, seconds);
+    QByteArray zwo("<workout_file>\n<name>benchmark</name>\n<sportType>bike</sportType>\n<workout>\n");
+    for (int i = 0; i < qMax(1, seconds / 60); i++) {
+        zwo += QStringLiteral("<SteadyState Duration=\"60\" Power=\"%1\"/>\n")
+                   .arg(syntheticWatts(i * 60) / 200.0)
+                   .toUtf8();
+    }
+    zwo += "</workout>\n</workout_file>\n";
+    QBENCHMARK { zwiftworkout::load(zwo); }
+}
+
+void benchmarks::gpxOpen() {
+    QFETCH(int, seconds);
+    QString name = fileName(QStringLiteral(".gpx"));
+    QFile file(name);
+    QVERIFY(file.open(QIODevice::WriteOnly));
+    QDateTime start = QDateTime::currentDateTimeUtc();
+    file.write("<?xml version=\"1.0\" encoding=\"UTF-8\"?>\n<gpx version=\"1.1\">\n<trk><trkseg>\n");
+    for (int i = 0; i < seconds; i++) {
+        file.write(QStringLiteral("<trkpt lat=\"%1\" lon=\"%2\"><ele>%3</ele><time>%4</time></trkpt>\n")
+                       .arg(45.0 + (i * 0.00005), 0, 'f', 7)
+                       .arg(9.0 + (i * 0.00005), 0, 'f', 7)
+                       .arg(100.0 + (20.0 * qSin(i / 600.0)), 0, 'f', 1)
+                       .arg(start.addSecs(i).toString(Qt::ISODate))
+                       .toUtf8());
+    }
+    file.write("</trkseg></trk>\n</gpx>\n");
+    file.close();
+    QBENCHMARK {
+        gpx g;
+        g.open(name);
+    }
+    QFile::remove(name);
+}
+
+void benchmarks::qfitSave() {
+    QFETCH(int, seconds);
+    QList<SessionLine> session = syntheticSession(seconds);
+    QString name = fileName(QStringLiteral(".fit"));
+    QBENCHMARK { qfit::save(name, session, bluetoothdevice::BIKE); }
+    QFile::remove(name);
+}
+
+void benchmarks::templateUpdate() {
+    QFETCH(int, seconds);
+    // the update of each second: buildContext and the evaluation of the web server template for its client
+    if (!client) {
+        QSKIP("the web server template needs Qt HttpServer");
+    }
+    TemplateInfoSenderBuilder *templates = manager->getInnerTemplateManager();
+    // a simulated clock a second ahead at every update, so all the templates are due: the timer isn't running here.
+    // It starts far from the real one, the schedules restart from it
+    qint64 now = 1000000000;
+    QBENCHMARK {
+        templates->start(device);
+        for (int i = 0; i < seconds; i++) {
+            now += 1000;
+            QMetaObject::invokeMethod(templates, "onUpdate", Qt::DirectConnection, Q_ARG(qint64, now));
+        }
+    }
+    templates->stop();
+}
+
+QTEST_GUILESS_MAIN(benchmarks)
+#include "benchmarks.moc"
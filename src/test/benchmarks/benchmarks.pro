@@ -0,0 +1,24 @@
+# Micro benchmarks of the data path (see benchmarks.cpp): the sources of the app are built with the TEST define and
+# the simulated bike of test-bike.
+#
+#   qmake && make && ./benchmarks -o results.xml,xml
+
+APP_DIR = $$PWD/../..
+include($$APP_DIR/qdomyos-zwift.pro)
+
+TARGET = benchmarks
+QT += testlib
+CONFIG -= app_bundle
+DEFINES += TEST
+
+VPATH += $$APP_DIR $$PWD/../test-bike
+INCLUDEPATH += $$APP_DIR $$APP_DIR/fit-sdk $$PWD/../test-bike
+
+# the main of the app is replaced by the one of QTest
+SOURCES -= main.cpp
+SOURCES += \
+        benchmarks.cpp \
+        simulatedbike.cpp
+
+HEADERS += \
+        simulatedbike.h
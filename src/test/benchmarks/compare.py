@@ -0,0 +1,62 @@
+#!/usr/bin/env python3
+"""Compares two runs of the benchmarks and fails when one of them got slower.
+
+The runs are the XML output of QTest, i.e. one per commit:
+
+    ./benchmarks -o $(git rev-parse --short HEAD).xml,xml
+    ./compare.py <base>.xml <new>.xml [--threshold 10]
+
+The exit code is 1 when a benchmark is slower than the threshold (percent) in the new run.
+"""
+
+import argparse
+import sys
+import xml.etree.ElementTree as ElementTree
+
+
+def load(file_name):
+    """(function, tag) -> (value, metric) of the BenchmarkResult elements of a QTest XML output."""
+    results = {}
+    root = ElementTree.parse(file_name).getroot()
+    for function in root.iter("TestFunction"):
+        for result in function.iter("BenchmarkResult"):
+            key = (function.get("name"), result.get("tag", ""))
+            results[key] = (float(result.get("value")), result.get("metric"))
+    return results
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__, formatter_class=argparse.RawDescriptionHelpFormatter)
+    parser.add_argument("base", help="QTest XML output of the reference run")
+    parser.add_argument("new", help="QTest XML output of the run to check")
+    parser.add_argument("--threshold", type=float, default=10.0, help="slowdown tolerated, percent (default 10)")
+    args = parser.parse_args()
+
+    base = load(args.base)
+    new = load(args.new)
+
+    regressions = 0
+    print("%-24s %-10s %14s %14s %9s" % ("benchmark", "scale", "base", "new", "change"))
+    # in the order of the new run
+    for key in list(new) + [k for k in base if k not in new]:
+        function, tag = key
+        if key not in base or key not in new:
+            print("%-24s %-10s %s" % (function, tag, "only in " + (args.base if key in base else args.new)))
+            continue
+        (before, metric), (after, _) = base[key], new[key]
+        change = ((after - before) * 100.0 / before) if before > 0 else 0.0
+        flag = ""
+        if change > args.threshold:
+            regressions += 1
+            flag = "  REGRESSION"
+        print("%-24s %-10s %14.4f %14.4f %+8.1f%%%s" % (function, tag, before, after, change, flag))
+    print("metric: %s" % next(iter(new.values()))[1] if new else "no results")
+
+    if regressions:
+        print("%d benchmarks slower than %.1f%%" % (regressions, args.threshold))
+        return 1
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
@@ -0,0 +1,221 @@
+#!/usr/bin/env python3
+"""Local client of the virtual bike on the network (DIRCON), to check it without Zwift.
+
+Enable "Virtual Bike on the Network (DIRCON)" in the settings, start a workout and run:
+
+    ./dirconclient.py 127.0.0.1 [--port 36866] [--power 200] [--grade 4] [--duration 30]
+
+It discovers the services, enables all the notifications, takes the control of the machine and sends a target power
+(ERG) and then a grade (SIM). Each control point write is timed up to its write response and up to its indication,
+the power request also up to the first Indoor Bike Data within 10% of the target. The intervals between the
+notifications of each characteristic are reported at the end. The exit code is 1 when a write isn't acknowledged.
+"""
+
+import argparse
+import socket
+import struct
+import sys
+import time
+import uuid
+
+DISCOVER_SERVICES = 0x01
+DISCOVER_CHARACTERISTICS = 0x02
+READ_CHARACTERISTIC = 0x03
+WRITE_CHARACTERISTIC = 0x04
+ENABLE_NOTIFICATIONS = 0x05
+NOTIFICATION = 0x06
+
+NOTIFY = 0x04
+
+CONTROL_POINT = 0x2AD9
+INDOOR_BIKE_DATA = 0x2AD2
+
+
+def short_uuid(value):
+    return uuid.UUID("0000%04x-0000-1000-8000-00805f9b34fb" % value)
+
+
+def name(characteristic):
+    if characteristic.hex[8:] == "00001000800000805f9b34fb":
+        return "0x%04X" % int(characteristic.hex[4:8], 16)
+    return str(characteristic)
+
+
+class client:
+    def __init__(self, host, port):
+        self.socket = socket.create_connection((host, port), timeout=5)
+        self.socket.setsockopt(socket.IPPROTO_TCP, socket.TCP_NODELAY, 1)
+        self.buffer = b""
+        self.sequence = 0
+        # characteristic -> list of (time, value)
+        self.notifications = {}
+
+    def send(self, message_id, payload=b""):
+        self.sequence = (self.sequence + 1) & 0xFF
+        self.socket.sendall(struct.pack(">BBBBH", 1, message_id, self.sequence, 0, len(payload)) + payload)
+        return self.sequence
+
+    def receive(self, timeout):
+        """The next message, None after the timeout. The notifications are recorded as they arrive."""
+        deadline = time.monotonic() + timeout
+        while True:
+            if len(self.buffer) >= 6:
+                _, message_id, sequence, response, length = struct.unpack(">BBBBH", self.buffer[:6])
+                if len(self.buffer) >= 6 + length:
+                    payload = self.buffer[6 : 6 + length]
+                    self.buffer = self.buffer[6 + length :]
+                    if message_id == NOTIFICATION:
+                        characteristic = uuid.UUID(bytes=payload[:16])
+                        self.notifications.setdefault(characteristic, []).append((time.monotonic(), payload[16:]))
+                    return message_id, sequence, response, payload
+            left = deadline - time.monotonic()
+            if left <= 0:
+                return None
+            self.socket.settimeout(left)
+            try:
+                data = self.socket.recv(4096)
+            except socket.timeout:
+                return None
+            if not data:
+                raise ConnectionError("connection closed by the server")
+            self.buffer += data
+
+    def request(self, message_id, payload=b"", timeout=2.0):
+        """Sends a request and waits for its response: (response code, payload, seconds) or None."""
+        start = time.monotonic()
+        sequence = self.send(message_id, payload)
+        while True:
+            m = self.receive(timeout - (time.monotonic() - start))
+            if m is None:
+                return None
+            if m[0] == message_id and m[1] == sequence:
+                return m[2], m[3], time.monotonic() - start
+
+    def wait_notification(self, characteristic, since, condition, timeout):
+        """Seconds from since to the first notification of the characteristic after it satisfying the condition."""
+        deadline = since + timeout
+        while True:
+            for t, value in self.notifications.get(characteristic, []):
+                if t >= since and condition(value):
+                    return t - since
+            left = deadline - time.monotonic()
+            if left <= 0:
+                return None
+            self.receive(left)
+
+
+def instant_power(value):
+    """Instant power of an Indoor Bike Data notification, None when it's not there."""
+    if len(value) < 2:
+        return None
+    flags = struct.unpack_from("<H", value)[0]
+    offset = 2
+    # more data, average speed, instant cadence, average cadence, total distance, resistance level
+    for bit, size in ((0, 2), (1, 2), (2, 2), (3, 2), (4, 3), (5, 2)):
+        present = not (flags & 1) if bit == 0 else flags & (1 << bit)
+        if present:
+            offset += size
+    if not flags & (1 << 6) or len(value) < offset + 2:
+        return None
+    return struct.unpack_from("<h", value, offset)[0]
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__, formatter_class=argparse.RawDescriptionHelpFormatter)
+    parser.add_argument("host", help="address of the machine running the app")
+    parser.add_argument("--port", type=int, default=36866)
+    parser.add_argument("--power", type=int, default=200, help="target power of the ERG request, W")
+    parser.add_argument("--grade", type=float, default=4.0, help="grade of the simulation request, %%")
+    parser.add_argument("--duration", type=float, default=30.0, help="seconds of notifications to collect")
+    args = parser.parse_args()
+
+    c = client(args.host, args.port)
+    failures = 0
+
+    r = c.request(DISCOVER_SERVICES)
+    if r is None or r[0] != 0:
+        print("discover services failed")
+        return 1
+    services = [uuid.UUID(bytes=r[1][i : i + 16]) for i in range(0, len(r[1]), 16)]
+    print("services: %s" % ", ".join(name(s) for s in services))
+
+    notifiable = []
+    for s in services:
+        r = c.request(DISCOVER_CHARACTERISTICS, s.bytes)
+        if r is None or r[0] != 0:
+            print("discover characteristics of %s failed" % name(s))
+            failures += 1
+            continue
+        for i in range(16, len(r[1]), 17):
+            characteristic = uuid.UUID(bytes=r[1][i : i + 16])
+            properties = r[1][i + 16]
+            print("  %s properties 0x%02x" % (name(characteristic), properties))
+            if properties & NOTIFY:
+                notifiable.append(characteristic)
+
+    for characteristic in notifiable:
+        r = c.request(ENABLE_NOTIFICATIONS, characteristic.bytes + b"\x01")
+        if r is None or r[0] != 0:
+            print("enable notifications of %s failed" % name(characteristic))
+            failures += 1
+
+    control_point = short_uuid(CONTROL_POINT)
+    bike_data = short_uuid(INDOOR_BIKE_DATA)
+    if control_point in notifiable:
+        grade = int(round(args.grade * 100))
+        writes = [
+            ("request control", b"\x00", None),
+            ("start", b"\x07", None),
+            ("target power %dW" % args.power, struct.pack("<BH", 0x05, args.power), args.power),
+            ("grade %.1f%%" % args.grade, struct.pack("<BhhBB", 0x11, 0, grade, 40, 51), None),
+        ]
+        for label, request, power in writes:
+            start = time.monotonic()
+            r = c.request(WRITE_CHARACTERISTIC, control_point.bytes + request)
+            if r is None or r[0] != 0:
+                print("%-20s write failed" % label)
+                failures += 1
+                continue
+            indication = c.wait_notification(
+                control_point, start, lambda v, op=request[0]: len(v) >= 3 and v[0] == 0x80 and v[1] == op, 2.0
+            )
+            line = "%-20s write %7.1fms" % (label, r[2] * 1000)
+            if indication is None:
+                line += "  no indication"
+                failures += 1
+            else:
+                line += "  indication %7.1fms" % (indication * 1000)
+            if power is not None:
+                tolerance = max(10, power * 0.1)
+                reached = c.wait_notification(
+                    bike_data,
+                    start,
+                    lambda v: instant_power(v) is not None and abs(instant_power(v) - power) <= tolerance,
+                    args.duration,
+                )
+                line += "  power reached %s" % ("never" if reached is None else "%.1fs" % reached)
+            print(line)
+    else:
+        print("no control point: CSC/CPS or heart rate only")
+
+    end = time.monotonic() + args.duration
+    while time.monotonic() < end:
+        c.receive(end - time.monotonic())
+
+    print("%-40s %6s %10s %10s %10s" % ("notifications", "count", "avg ms", "min ms", "max ms"))
+    for characteristic, samples in c.notifications.items():
+        times = [t for t, _ in samples]
+        intervals = [(b - a) * 1000 for a, b in zip(times, times[1:])]
+        if intervals:
+            print(
+                "%-40s %6d %10.1f %10.1f %10.1f"
+                % (name(characteristic), len(samples), sum(intervals) / len(intervals), min(intervals), max(intervals))
+            )
+        else:
+            print("%-40s %6d" % (name(characteristic), len(samples)))
+
+    return 1 if failures else 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
@@ -0,0 +1,75 @@
+#include "simulatedbike.h"
+#include <QSettings>
+#include <math.h>
+
+simulatedbike::simulatedbike(bool noWriteResistance, bool noHeartService)
+    : fakebike(noWriteResistance, noHeartService, false) {
+    Resistance = 1;
+    Heart = 60;
+}
+
+uint8_t simulatedbike::resistanceFromPowerRequest(uint16_t power) {
+    double cadence = Cadence.value() > 0 ? Cadence.value() : riderCadence;
+    if (cadence <= 0) {
+        return Resistance.value();
+    }
+    double resistance = (power * 9.5488 / cadence) - (Inclination.value() * 2.0);
+    return qBound(1, (int)round(resistance), (int)maxResistance());
+}
+
+void simulatedbike::advance(double seconds) {
+    QSettings settings;
+
+    // the requests are applied at once, as a trainer answering in the same packet round trip: one write, reported as
+    // the drivers do, acknowledged right away
+    quint64 write = 0;
+    if (requestResistance != -1 || requestInclination != -1) {
+        requestQueued();
+        write = writeRequested(QByteArray::number(requestResistance) + ' ' + QByteArray::number(requestInclination));
+    }
+    if (requestResistance != -1) {
+        Resistance = qBound(1, (int)requestResistance, (int)maxResistance());
+        emit resistanceRead(Resistance.value());
+        requestResistance = -1;
+    }
+    if (requestInclination != -1) {
+        Inclination = requestInclination;
+        requestInclination = -1;
+    }
+    if (write) {
+        emit writeCompleted(write);
+    }
+
+    if (paused) {
+        Cadence = 0;
+        m_watt = 0;
+        Speed = 0;
+        return;
+    }
+
+    Cadence = riderCadence;
+    double effectiveResistance = qMax(0.0, Resistance.value() + (Inclination.value() * 2.0));
+    m_watt = effectiveResistance * Cadence.value() / 9.5488;
+    Speed = m_watt.value() > 0 ? metric::calculateSpeedFromPower(m_watt.value()) : 0;
+
+    elapsed += seconds;
+    if (Speed.value() > 0) {
+        moving += seconds;
+    }
+    Distance += Speed.value() * seconds / 3600.0;
+    m_jouls += m_watt.value() * seconds;
+    KCal += (((0.048 * m_watt.value() + 1.19) * settings.value(QStringLiteral("weight"), 75.0).toFloat() * 3.5) /
+             200.0) *
+            (seconds / 60.0); //(( (0.048* Output in watts +1.19) * body weight in kg * 3.5) / 200 ) / 60
+    WattKg = m_watt.value() / settings.value(QStringLiteral("weight"), 75.0).toFloat();
+
+    // the heart rate follows the effort with a 30s time constant
+    double targetHeart = 60.0 + (m_watt.value() * 0.4);
+    Heart = Heart.value() + ((targetHeart - Heart.value()) * (1.0 - exp(-seconds / 30.0)));
+
+    if (Cadence.value() > 0) {
+        CrankRevs += Cadence.value() * seconds / 60.0;
+        crankEventTime += seconds;
+        LastCrankEventTime = (uint16_t)((uint32_t)(crankEventTime * 1024.0) & 0xFFFF);
+    }
+}
@@ -0,0 +1,26 @@
+#ifndef SIMULATEDBIKE_H
+#define SIMULATEDBIKE_H
+
+#include "fakebike.h"
+
+// A fakebike with a rider on it: the metrics come from a simple trainer model (P = resistance * cadence / 9.5488,
+// the formula of bike::powerFromResistanceRequest, with the grade added to the resistance) and they are integrated
+// on the time given to advance(), so that a session can run on a virtual clock much faster than the real one.
+class simulatedbike : public fakebike {
+    Q_OBJECT
+  public:
+    simulatedbike(bool noWriteResistance, bool noHeartService);
+
+    // moves the simulation forward of the seconds given
+    void advance(double seconds);
+
+    void setRiderCadence(double cadence) { riderCadence = cadence; }
+    uint8_t maxResistance() override { return 100; }
+    uint8_t resistanceFromPowerRequest(uint16_t power) override;
+
+  private:
+    double riderCadence = 90;
+    double crankEventTime = 0; // s
+};
+
+#endif // SIMULATEDBIKE_H
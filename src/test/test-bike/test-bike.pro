@@ -1,23 +1,23 @@
-QT -= gui
+# Headless simulation of the app on a simulated bike (see testbike.cpp): the sources of the app are built with the
+# TEST define, that makes bluetooth use the simulated bike instead of scanning.
+#
+#   qmake && make && ./test-bike
 
-CONFIG += c++11 console
-CONFIG -= app_bundle
+APP_DIR = $$PWD/../..
+include($$APP_DIR/qdomyos-zwift.pro)
 
-# The following define makes your compiler emit warnings if you use
-# any Qt feature that has been marked deprecated (the exact warnings
-# depend on your compiler). Please consult the documentation of the
-# deprecated API in order to know how to port your code away from it.
-DEFINES += QT_DEPRECATED_WARNINGS
+TARGET = test-bike
+CONFIG -= app_bundle
+DEFINES += TEST
 
-# You can also make your code fail to compile if it uses deprecated APIs.
-# In order to do so, uncomment the following line.
-# You can also select to disable deprecated APIs only up to a certain version of Qt.
-#DEFINES += QT_DISABLE_DEPRECATED_BEFORE=0x060000    # disables all the APIs deprecated before Qt 6.0.0
+VPATH += $$APP_DIR
+INCLUDEPATH += $$PWD $$APP_DIR $$APP_DIR/fit-sdk
 
+# the main of the app is replaced by the one of the simulation
+SOURCES -= main.cpp
 SOURCES += \
-        main.cpp
+        simulatedbike.cpp \
+        testbike.cpp
 
-# Default rules for deployment.
-qnx: target.path = /tmp/$${TARGET}/bin
-else: unix:!android: target.path = /opt/$${TARGET}/bin
-!isEmpty(target.path): INSTALLS += target
+HEADERS += \
+        simulatedbike.h
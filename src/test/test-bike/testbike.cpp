@@ -0,0 +1,323 @@
+#include "bluetooth.h"
+#include "logging.h"
+#include "qfit.h"
+#include "sessionline.h"
+#include "simulatedbike.h"
+#include "trainprogram.h"
+#include <QCoreApplication>
+#include <QDir>
+#include <QElapsedTimer>
+#include <QFile>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QSettings>
+#include <QThread>
+#include <QtMath>
+#ifdef Q_HTTPSERVER
+#include <QNetworkAccessManager>
+#include <QNetworkReply>
+#include <QWebSocket>
+#endif
+#include <functional>
+#include <stdio.h>
+
+// Headless end to end run of the app on a simulated bike: bluetooth, a train program, the control requests that Zwift
+// sends through the virtual bike and the template web server, all driven by a virtual clock. The process exits with
+// the number of failed checks.
+//
+//   test-bike [--speed <virtual seconds per real second>] [--budget <ms>] [--verbose]
+
+namespace {
+
+int failures = 0;
+bool verbose = false;
+
+void check(bool condition, const QString &what) {
+    if (!condition) {
+        failures++;
+    }
+    fprintf(stdout, "%s %s\n", condition ? "PASS" : "FAIL", qPrintable(what));
+    fflush(stdout);
+}
+
+bool near(double value, double expected, double tolerance) { return qAbs(value - expected) <= tolerance; }
+
+void messageHandler(QtMsgType type, const QMessageLogContext &context, const QString &msg) {
+    Q_UNUSED(context);
+    if (type != QtDebugMsg || verbose) {
+        fprintf(stderr, "%s\n", qPrintable(msg));
+    }
+    if (type == QtFatalMsg) {
+        abort();
+    }
+}
+
+// processes the events of the app until the condition is true, in real time
+bool waitFor(const std::function<bool()> &condition, int timeout) {
+    QElapsedTimer timer;
+    timer.start();
+    while (!condition() && timer.elapsed() < timeout) {
+        QCoreApplication::processEvents(QEventLoop::AllEvents, 5);
+        QThread::msleep(1);
+    }
+    return condition();
+}
+
+// Moves the simulation one second at a time and samples the session as homeform does. The real time is paced on the
+// virtual one divided by the speed, so the timers of the app (templates, web server) keep running meanwhile.
+class virtualclock {
+  public:
+    virtualclock(simulatedbike *device, double speed) : device(device), speed(speed) {
+        start = QDateTime::currentDateTime();
+        real.start();
+    }
+
+    void run(int seconds, trainprogram *program = nullptr) {
+        for (int i = 0; i < seconds; i++) {
+            device->advance(1.0);
+            if (program) {
+                program->scheduler();
+            }
+            now++;
+            sample();
+
+            qint64 due = (qint64)(now * 1000.0 / speed);
+            do {
+                QCoreApplication::processEvents(QEventLoop::AllEvents, 1);
+                if (real.elapsed() < due) {
+                    QThread::msleep(1);
+                }
+            } while (real.elapsed() < due);
+        }
+    }
+
+    int seconds() const { return now; }
+    qint64 realElapsed() const { return real.elapsed(); }
+    QList<SessionLine> session;
+
+  private:
+    void sample() {
+        QTime pace = device->currentPace();
+        QTime elapsed = device->elapsedTime();
+        uint32_t elapsedSeconds = elapsed.second() + (elapsed.minute() * 60) + (elapsed.hour() * 3600);
+        session.append(SessionLine(
+            device->currentSpeed().value(), device->currentInclination().value(), device->odometer(), device->watts(),
+            device->currentResistance().value(), device->pelotonResistance().value(), device->currentHeart().value(),
+            pace.second() + (pace.minute() * 60), device->currentCadence().value(), device->calories().value(),
+            device->elevationGain().value(), elapsedSeconds, false, 0, 0, 0, 0, device->currentCordinate(),
+            start.addSecs(now)));
+    }
+
+    simulatedbike *device;
+    double speed;
+    int now = 0;
+    QDateTime start;
+    QElapsedTimer real;
+};
+
+} // namespace
+
+int main(int argc, char *argv[]) {
+    QCoreApplication app(argc, argv);
+    // a settings file of its own: the ones of the app are never touched
+    app.setOrganizationName(QStringLiteral("Roberto Viola"));
+    app.setOrganizationDomain(QStringLiteral("robertoviola.cloud"));
+    app.setApplicationName(QStringLiteral("qDomyos-Zwift-test-bike"));
+
+    double speed = 200;
+    qint64 budget = 30000;
+    QStringList args = app.arguments();
+    for (int i = 1; i < args.length(); i++) {
+        if (args.at(i) == QStringLiteral("--speed") && i + 1 < args.length()) {
+            speed = qMax(1.0, args.at(++i).toDouble());
+        } else if (args.at(i) == QStringLiteral("--budget") && i + 1 < args.length()) {
+            budget = args.at(++i).toLongLong();
+        } else if (args.at(i) == QStringLiteral("--verbose")) {
+            verbose = true;
+        }
+    }
+    qInstallMessageHandler(messageHandler);
+    logging::setEnabled(verbose);
+
+    QSettings settings;
+    settings.clear();
+    settings.setValue(QStringLiteral("virtual_device_enabled"), false);
+    settings.setValue(QStringLiteral("weight"), 75.0);
+
+    bluetooth manager(false, QLatin1String(""), false, false, 200, true);
+    simulatedbike *device = qobject_cast<simulatedbike *>(manager.device());
+    check(device != nullptr, QStringLiteral("the simulated bike is the device"));
+    if (!device) {
+        return failures;
+    }
+    bool discovered = false;
+    QObject::connect(device, &bluetoothdevice::connectedAndDiscovered, [&discovered]() { discovered = true; });
+    check(waitFor([&discovered]() { return discovered; }, 5000), QStringLiteral("connected and discovered"));
+
+    virtualclock clock(device, speed);
+
+    // train program: the rows of a resistance and of a power workout
+    QList<trainrow> rows;
+    trainrow row;
+    row.duration = QTime(0, 2, 0);
+    row.resistance = 10;
+    rows.append(row);
+    row.resistance = 20;
+    rows.append(row);
+    row.resistance = -1;
+    row.power = 200;
+    rows.append(row);
+    trainprogram program(rows, &manager);
+    program.stopTimer();
+    QObject::connect(&program, &trainprogram::changeResistance, device, &bike::changeResistance);
+    QObject::connect(&program, &trainprogram::changePower, device, &bike::changePower);
+    program.onTapeStarted();
+
+    clock.run(119, &program);
+    check(device->currentResistance().value() == 10 && near(device->wattsMetric().value(), 94.25, 1),
+          QStringLiteral("program row 1: resistance 10, %1W").arg(device->wattsMetric().value()));
+    clock.run(120, &program);
+    check(device->currentResistance().value() == 20 && near(device->wattsMetric().value(), 188.5, 1),
+          QStringLiteral("program row 2: resistance 20, %1W").arg(device->wattsMetric().value()));
+    clock.run(121, &program);
+    check(near(device->wattsMetric().value(), 200, 10),
+          QStringLiteral("program row 3: 200W requested, %1W").arg(device->wattsMetric().value()));
+    check(program.totalElapsedTime() == QTime(0, 6, 0),
+          QStringLiteral("program elapsed %1").arg(program.totalElapsedTime().toString()));
+
+    // Zwift, what virtualbike does with the FTMS control point: Set Target Power (ERG) and then the Indoor Bike
+    // Simulation Parameters (grade 4%)
+    device->changePower(250);
+    clock.run(120);
+    check(near(device->wattsMetric().value(), 250, 10),
+          QStringLiteral("ftms target power 250W, %1W").arg(device->wattsMetric().value()));
+    double ergWatts = device->wattsMetric().value();
+    device->changeInclination(4.0, qTan(qDegreesToRadians(4.0)) * 100.0);
+    clock.run(120);
+    check(device->currentInclination().value() == 4.0 && device->wattsMetric().value() > ergWatts,
+          QStringLiteral("ftms simulation grade 4%, %1W").arg(device->wattsMetric().value()));
+
+#ifdef Q_HTTPSERVER
+    // the template web server: the workout pushed every second, a control request and the session
+    int port = settings.value(QStringLiteral("template_inner_" TEMPLATE_PRIVATE_WEBSERVER_ID "_port"), 0).toInt();
+    QWebSocket socket;
+    QHash<QString, QJsonObject> replies;
+    QObject::connect(&socket, &QWebSocket::textMessageReceived, [&replies](const QString &message) {
+        QJsonObject o = QJsonDocument::fromJson(message.toUtf8()).object();
+        replies.insert(o.value(QStringLiteral("msg")).toString(), o);
+    });
+    socket.open(QUrl(QStringLiteral("ws://127.0.0.1:%1/").arg(port)));
+    check(waitFor([&socket]() { return socket.state() == QAbstractSocket::ConnectedState; }, 5000),
+          QStringLiteral("web server on port %1").arg(port));
+    socket.sendTextMessage(QStringLiteral("{\"msg\":\"setpower\",\"content\":{\"value\":150}}"));
+    socket.sendTextMessage(QStringLiteral("{\"msg\":\"control\",\"content\":{\"id\":\"t1\",\"commands\":["
+                                          "{\"target\":\"power\",\"value\":150},{\"target\":\"warp\",\"value\":9}]}}"));
+    socket.sendTextMessage(QStringLiteral("{\"msg\":\"getsessionarray\"}"));
+    socket.sendTextMessage(QStringLiteral("{\"msg\":\"getsession\",\"content\":{\"from\":0,\"count\":100}}"));
+    check(waitFor([&replies]() { return replies.contains(QStringLiteral("workout")); }, 5000),
+          QStringLiteral("web server workout"));
+    check(waitFor([&replies]() { return replies.contains(QStringLiteral("R_setpower")); }, 5000) &&
+              replies.value(QStringLiteral("R_setpower"))
+                      .value(QStringLiteral("content"))
+                      .toObject()
+                      .value(QStringLiteral("value"))
+                      .toInt() == 150,
+          QStringLiteral("web server setpower"));
+    check(waitFor([&replies]() { return replies.contains(QStringLiteral("R_getsessionarray")); }, 5000) &&
+              !replies.value(QStringLiteral("R_getsessionarray")).value(QStringLiteral("content")).toArray().isEmpty(),
+          QStringLiteral("web server session array"));
+    bool chunk = waitFor([&replies]() { return replies.contains(QStringLiteral("R_getsession")); }, 5000);
+    QJsonObject session = replies.value(QStringLiteral("R_getsession")).value(QStringLiteral("content")).toObject();
+    QJsonArray keys = session.value(QStringLiteral("keys")).toArray();
+    QJsonArray columns = session.value(QStringLiteral("columns")).toArray();
+    int samples = session.value(QStringLiteral("next")).toInt() - session.value(QStringLiteral("from")).toInt();
+    check(chunk && session.value(QStringLiteral("from")).toInt() == 0 && samples > 0 && samples <= 100 &&
+              keys.contains(QStringLiteral("watts")) && columns.count() == keys.count() &&
+              columns.at(0).toArray().count() == samples,
+          QStringLiteral("web server session chunk of %1 samples").arg(samples));
+    // the simulated bike writes the request in the next second and the write completes at once
+    clock.run(1);
+    bool acknowledged = waitFor([&replies]() { return replies.contains(QStringLiteral("R_control")); }, 5000);
+    QJsonObject control = replies.value(QStringLiteral("R_control")).value(QStringLiteral("content")).toObject();
+    QJsonArray commands = control.value(QStringLiteral("commands")).toArray();
+    check(acknowledged && control.value(QStringLiteral("id")).toString() == QStringLiteral("t1") &&
+              control.value(QStringLiteral("status")).toString() == QStringLiteral("written") &&
+              commands.count() == 2 && commands.at(0).toObject().value(QStringLiteral("value")).toInt() == 150 &&
+              commands.at(0).toObject().value(QStringLiteral("status")).toString() == QStringLiteral("written") &&
+              commands.at(1).toObject().value(QStringLiteral("status")).toString() == QStringLiteral("rejected"),
+          QStringLiteral("web server control batch %1").arg(control.value(QStringLiteral("status")).toString()));
+    // a setting written and read back as a change since the version before it
+    socket.sendTextMessage(QStringLiteral("{\"msg\":\"setsettings\",\"content\":{\"testbike_probe\":7}}"));
+    bool written = waitFor([&replies]() { return replies.contains(QStringLiteral("R_setsettings")); }, 5000);
+    qint64 version = (qint64)replies.value(QStringLiteral("R_setsettings")).value(QStringLiteral("version")).toDouble();
+    socket.sendTextMessage(
+        QStringLiteral("{\"msg\":\"getsettings\",\"content\":{\"since\":%1}}").arg(version - 1));
+    bool read = waitFor([&replies]() { return replies.contains(QStringLiteral("R_getsettings")); }, 5000);
+    QJsonObject changed = replies.value(QStringLiteral("R_getsettings")).value(QStringLiteral("content")).toObject();
+    check(written && read && version > 0 && changed.value(QStringLiteral("testbike_probe")).toInt() == 7,
+          QStringLiteral("web server settings changed since version %1").arg(version - 1));
+    // a version from another run of the app gets all the settings
+    QString epoch = replies.value(QStringLiteral("R_setsettings")).value(QStringLiteral("epoch")).toString();
+    replies.remove(QStringLiteral("R_getsettings"));
+    socket.sendTextMessage(
+        QStringLiteral("{\"msg\":\"getsettings\",\"content\":{\"since\":%1,\"epoch\":\"0\"}}").arg(version));
+    read = waitFor([&replies]() { return replies.contains(QStringLiteral("R_getsettings")); }, 5000);
+    QJsonObject all = replies.value(QStringLiteral("R_getsettings")).value(QStringLiteral("content")).toObject();
+    check(read && !epoch.isEmpty() &&
+              replies.value(QStringLiteral("R_getsettings")).value(QStringLiteral("epoch")).toString() == epoch &&
+              all.contains(QStringLiteral("weight")) && all.contains(QStringLiteral("testbike_probe")),
+          QStringLiteral("web server settings of another epoch"));
+    QNetworkAccessManager http;
+    QNetworkReply *metrics = http.get(QNetworkRequest(QUrl(QStringLiteral("http://127.0.0.1:%1/metrics").arg(port))));
+    check(waitFor([metrics]() { return metrics->isFinished(); }, 5000) && metrics->error() == QNetworkReply::NoError &&
+              metrics->readAll().contains("qz_power_watts"),
+          QStringLiteral("web server metrics"));
+    metrics->deleteLater();
+    clock.run(60);
+    check(near(device->wattsMetric().value(), 150, 10),
+          QStringLiteral("web server power 150W, %1W").arg(device->wattsMetric().value()));
+    socket.close();
+#else
+    clock.run(60);
+#endif
+
+    // the session
+    int total = clock.seconds();
+    check(clock.session.length() == total, QStringLiteral("session of %1 lines").arg(clock.session.length()));
+    check(device->elapsedTime() == QTime(0, 0, 0).addSecs(total),
+          QStringLiteral("elapsed %1").arg(device->elapsedTime().toString()));
+    double distance = 0;
+    for (const SessionLine &s : qAsConst(clock.session)) {
+        distance += s.speed / 3600.0;
+    }
+    check(device->odometer() > 0 && near(device->odometer(), distance, 0.001),
+          QStringLiteral("distance %1km").arg(device->odometer()));
+    check(near(clock.session.last().distance, device->odometer(), 0.0001), QStringLiteral("session distance"));
+    check(device->calories().value() > 0, QStringLiteral("calories %1").arg(device->calories().value()));
+    check(device->currentHeart().value() > 60, QStringLiteral("heart %1").arg(device->currentHeart().value()));
+
+    // the FIT file
+    QString fitName = QDir::tempPath() + QStringLiteral("/test-bike.fit");
+    QFile::remove(fitName);
+    qfit::save(fitName, clock.session, bluetoothdevice::BIKE);
+    QFile fit(fitName);
+    QByteArray header;
+    if (fit.open(QIODevice::ReadOnly)) {
+        header = fit.read(14);
+    }
+    check(header.length() == 14 && header.mid(8, 4) == QByteArray(".FIT") && fit.size() > 14 + 2 + (total * 10),
+          QStringLiteral("fit file of %1 bytes").arg(fit.size()));
+    fit.close();
+    QFile::remove(fitName);
+
+    // timing, the base of the performance regression tests
+    qint64 realTime = clock.realElapsed();
+    fprintf(stdout, "timing: virtual %ds real %lldms speed %.1fx\n", total, realTime,
+            realTime > 0 ? (total * 1000.0) / realTime : 0.0);
+    check(realTime <= budget, QStringLiteral("real time within %1ms").arg(budget));
+
+    settings.clear();
+    fprintf(stdout, "%d failures\n", failures);
+    return failures;
+}
@@ -0,0 +1,25 @@
+# Unit tests of the decoders and of the accessories (see unittests.cpp): the sources of the app are built with the TEST
+# define and the simulated bike of test-bike.
+#
+#   qmake && make && ./unit-tests
+
+APP_DIR = $$PWD/../..
+include($$APP_DIR/qdomyos-zwift.pro)
+
+TARGET = unit-tests
+QT += testlib
+CONFIG -= app_bundle
+DEFINES += TEST
+DEFINES += BTLOGS_DIR=\\\"$$PWD/../../../btlogs\\\"
+
+VPATH += $$APP_DIR $$PWD/../test-bike
+INCLUDEPATH += $$APP_DIR $$APP_DIR/fit-sdk $$PWD/../test-bike
+
+# the main of the app is replaced by the one of QTest
+SOURCES -= main.cpp
+SOURCES += \
+        unittests.cpp \
+        simulatedbike.cpp
+
+HEADERS += \
+        simulatedbike.h
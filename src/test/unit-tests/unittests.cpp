@@ -0,0 +1,711 @@
+#include "capturefile.h"
+#include "cscdecoder.h"
+#include "domyosbike.h"
+#include "domyostreadmill.h"
+#include "fakebike.h"
+#include "fitshowtreadmill.h"
+#include "flywheelbike.h"
+#include "framing.h"
+#include "ftmsparser.h"
+#include "gzip.h"
+#include "kingsmithr2treadmill.h"
+#include "logging.h"
+#include "logwriter.h"
+#include "sensorfusion.h"
+#include "templateinfosender.h"
+#include <QBuffer>
+#include <QSettings>
+#include <QTemporaryDir>
+#include <QtEndian>
+#include <QtTest>
+#include <random>
+#include <vector>
+
+// Unit tests of the decoders of the data path, of the samples of the accessories and of the log writer, on recorded
+// or synthetic inputs.
+//
+//   ./unit-tests
+class unittests : public QObject {
+    Q_OBJECT
+
+  private slots:
+    void initTestCase();
+    void cleanupTestCase();
+
+    void sensorFusionStale();
+    void sensorFusionFakebike();
+    void cscRollover();
+    void cscStale();
+    void cscResync();
+    void cscWheelRollover();
+    void ftmsSpecification();
+    void ftmsRandom();
+    void ftmsTruncated();
+    void framingFragments_data();
+    void framingFragments();
+    void framingKingsmith();
+    void framingFlywheel();
+    void framingChecksums();
+    void gzipCompress();
+    void logwriterDropped();
+    void logwriterRotation();
+    void templateFunctionBody_data();
+    void templateFunctionBody();
+};
+
+namespace {
+
+void messageHandler(QtMsgType type, const QMessageLogContext &context, const QString &msg) {
+    Q_UNUSED(context);
+    if (type != QtDebugMsg && type != QtInfoMsg) {
+        fprintf(stderr, "%s\n", qPrintable(msg));
+    }
+}
+
+// synthetic notifications of a crank sensor at 90 rpm, one a second, the counters started close to their 16 bit wrap:
+// the event time rolls over at the third notification, the revolutions at the sixth
+struct cscnotification {
+    int64_t now;
+    uint32_t revs;
+    uint16_t eventTime;
+};
+const cscnotification crank90rpm[] = {{100000, 65530, 63536}, {101000, 65531, 64218}, {102000, 65533, 48},
+                                      {103000, 65534, 730},    {104000, 65535, 1413},  {105000, 1, 2778},
+                                      {106000, 2, 3461},       {107000, 4, 4826},      {108000, 5, 5509}};
+
+void pushAll(cscdecoder &decoder) {
+    for (const cscnotification &n : crank90rpm) {
+        decoder.push(n.revs, n.eventTime, n.now);
+    }
+}
+
+const uint16_t ftmsCharacteristics[] = {ftmsparser::TREADMILL_DATA,    ftmsparser::CROSS_TRAINER_DATA,
+                                        ftmsparser::STEP_CLIMBER_DATA, ftmsparser::STAIR_CLIMBER_DATA,
+                                        ftmsparser::ROWER_DATA,        ftmsparser::INDOOR_BIKE_DATA};
+
+// a frame of a FTMS data characteristic built by hand from the specification, and the values it carries: with every
+// flag set every field is at a known offset, with "more data" set the fields of the bit 0 are missing
+struct ftmsframe {
+    const char *name;
+    uint16_t characteristic;
+    const char *hex;
+    QList<QPair<ftmsparser::FIELD, double>> fields;
+};
+const ftmsframe ftmsFrames[] = {
+    {"treadmill, every field", ftmsparser::TREADMILL_DATA,
+     "fe1fd204e80340e201e7ff0f007b002d000506410158020a8e558b0e58029cfffa00",
+     {{ftmsparser::INSTANT_SPEED, 12.34}, {ftmsparser::AVERAGE_SPEED, 10}, {ftmsparser::TOTAL_DISTANCE, 123456},
+      {ftmsparser::INCLINATION, -2.5}, {ftmsparser::RAMP_ANGLE, 1.5}, {ftmsparser::POSITIVE_ELEVATION, 12.3},
+      {ftmsparser::NEGATIVE_ELEVATION, 4.5}, {ftmsparser::INSTANT_PACE, 0.5}, {ftmsparser::AVERAGE_PACE, 0.6},
+      {ftmsparser::TOTAL_ENERGY, 321}, {ftmsparser::ENERGY_PER_HOUR, 600}, {ftmsparser::ENERGY_PER_MINUTE, 10},
+      {ftmsparser::HEART_RATE, 142}, {ftmsparser::METABOLIC_EQUIVALENT, 8.5}, {ftmsparser::ELAPSED_TIME, 3723},
+      {ftmsparser::REMAINING_TIME, 600}, {ftmsparser::FORCE_ON_BELT, -100}, {ftmsparser::INSTANT_POWER, 250}}},
+    {"treadmill, more data, heart only", ftmsparser::TREADMILL_DATA, "01018e", {{ftmsparser::HEART_RATE, 142}}},
+    {"cross trainer, every field", ftmsparser::CROSS_TRAINER_DATA,
+     "fe7f006c03ee02e1100078006e00c90923001400f6ff14005000b400a000d200bc020c824808078403",
+     {{ftmsparser::INSTANT_SPEED, 8.76}, {ftmsparser::AVERAGE_SPEED, 7.5}, {ftmsparser::TOTAL_DISTANCE, 4321},
+      {ftmsparser::STEP_PER_MINUTE, 120}, {ftmsparser::AVERAGE_STEP_RATE, 110}, {ftmsparser::STRIDE_COUNT, 250.5},
+      {ftmsparser::POSITIVE_ELEVATION, 35}, {ftmsparser::NEGATIVE_ELEVATION, 20}, {ftmsparser::INCLINATION, -1},
+      {ftmsparser::RAMP_ANGLE, 2}, {ftmsparser::RESISTANCE, 8}, {ftmsparser::INSTANT_POWER, 180},
+      {ftmsparser::AVERAGE_POWER, 160}, {ftmsparser::TOTAL_ENERGY, 210}, {ftmsparser::ENERGY_PER_HOUR, 700},
+      {ftmsparser::ENERGY_PER_MINUTE, 12}, {ftmsparser::HEART_RATE, 130}, {ftmsparser::METABOLIC_EQUIVALENT, 7.2},
+      {ftmsparser::ELAPSED_TIME, 1800}, {ftmsparser::REMAINING_TIME, 900}}},
+    {"cross trainer, more data, heart only", ftmsparser::CROSS_TRAINER_DATA, "01080082",
+     {{ftmsparser::HEART_RATE, 130}}},
+    {"step climber, every field", ftmsparser::STEP_CLIMBER_DATA, "fe012a0039054b0046007e009600f401099b5bb0042c01",
+     {{ftmsparser::FLOORS, 42}, {ftmsparser::STEP_COUNT, 1337}, {ftmsparser::STEP_PER_MINUTE, 75},
+      {ftmsparser::AVERAGE_STEP_RATE, 70}, {ftmsparser::POSITIVE_ELEVATION, 126}, {ftmsparser::TOTAL_ENERGY, 150},
+      {ftmsparser::ENERGY_PER_HOUR, 500}, {ftmsparser::ENERGY_PER_MINUTE, 9}, {ftmsparser::HEART_RATE, 155},
+      {ftmsparser::METABOLIC_EQUIVALENT, 9.1}, {ftmsparser::ELAPSED_TIME, 1200}, {ftmsparser::REMAINING_TIME, 300}}},
+    {"step climber, more data, heart only", ftmsparser::STEP_CLIMBER_DATA, "21009b", {{ftmsparser::HEART_RATE, 155}}},
+    {"stair climber, every field", ftmsparser::STAIR_CLIMBER_DATA, "fe0311003c003a003300bc025a00c20108945884033c00",
+     {{ftmsparser::FLOORS, 17}, {ftmsparser::STEP_PER_MINUTE, 60}, {ftmsparser::AVERAGE_STEP_RATE, 58},
+      {ftmsparser::POSITIVE_ELEVATION, 51}, {ftmsparser::STRIDE_COUNT, 700}, {ftmsparser::TOTAL_ENERGY, 90},
+      {ftmsparser::ENERGY_PER_HOUR, 450}, {ftmsparser::ENERGY_PER_MINUTE, 8}, {ftmsparser::HEART_RATE, 148},
+      {ftmsparser::METABOLIC_EQUIVALENT, 8.8}, {ftmsparser::ELAPSED_TIME, 900}, {ftmsparser::REMAINING_TIME, 60}}},
+    {"stair climber, more data, heart only", ftmsparser::STAIR_CLIMBER_DATA, "410094", {{ftmsparser::HEART_RATE, 148}}},
+    {"rower, every field", ftmsparser::ROWER_DATA, "fe1f3100022cd0070073007800e600d20006006e0020030da069e0017800",
+     {{ftmsparser::STROKE_RATE, 24.5}, {ftmsparser::STROKE_COUNT, 512}, {ftmsparser::AVERAGE_STROKE_RATE, 22},
+      {ftmsparser::TOTAL_DISTANCE, 2000}, {ftmsparser::INSTANT_PACE, 115}, {ftmsparser::AVERAGE_PACE, 120},
+      {ftmsparser::INSTANT_POWER, 230}, {ftmsparser::AVERAGE_POWER, 210}, {ftmsparser::RESISTANCE, 6},
+      {ftmsparser::TOTAL_ENERGY, 110}, {ftmsparser::ENERGY_PER_HOUR, 800}, {ftmsparser::ENERGY_PER_MINUTE, 13},
+      {ftmsparser::HEART_RATE, 160}, {ftmsparser::METABOLIC_EQUIVALENT, 10.5}, {ftmsparser::ELAPSED_TIME, 480},
+      {ftmsparser::REMAINING_TIME, 120}}},
+    {"rower, more data, heart only", ftmsparser::ROWER_DATA, "0102a0", {{ftmsparser::HEART_RATE, 160}}},
+    {"indoor bike, every field", ftmsparser::INDOOR_BIKE_DATA,
+     "fe1f8a0c860bb500aa00983a00fdff1301f000900184030f966e8c0a0000",
+     {{ftmsparser::INSTANT_SPEED, 32.1}, {ftmsparser::AVERAGE_SPEED, 29.5}, {ftmsparser::INSTANT_CADENCE, 90.5},
+      {ftmsparser::AVERAGE_CADENCE, 85}, {ftmsparser::TOTAL_DISTANCE, 15000}, {ftmsparser::RESISTANCE, -3},
+      {ftmsparser::INSTANT_POWER, 275}, {ftmsparser::AVERAGE_POWER, 240}, {ftmsparser::TOTAL_ENERGY, 400},
+      {ftmsparser::ENERGY_PER_HOUR, 900}, {ftmsparser::ENERGY_PER_MINUTE, 15}, {ftmsparser::HEART_RATE, 150},
+      {ftmsparser::METABOLIC_EQUIVALENT, 11}, {ftmsparser::ELAPSED_TIME, 2700}, {ftmsparser::REMAINING_TIME, 0}}},
+    {"indoor bike, more data, heart only", ftmsparser::INDOOR_BIKE_DATA, "010296", {{ftmsparser::HEART_RATE, 150}}},
+};
+
+// the payload is followed by guard bytes: if the parser reads past the length, the result changes with the guard
+bool parseGuarded(uint16_t characteristic, const std::vector<uint8_t> &payload, int length, uint8_t guard,
+                  ftmsparser::data &out) {
+    std::vector<uint8_t> buffer(payload.begin(), payload.begin() + length);
+    buffer.resize(length + 16, guard);
+    return ftmsparser::parse(characteristic, buffer.data(), length, out);
+}
+
+bool sameData(const ftmsparser::data &a, const ftmsparser::data &b) {
+    if (a.flags != b.flags || a.present != b.present || a.truncated != b.truncated) {
+        return false;
+    }
+    for (int f = 0; f < ftmsparser::FIELDS; f++) {
+        if (a.value[f] != b.value[f]) {
+            return false;
+        }
+    }
+    return true;
+}
+
+// parses every prefix of the payload: the shorter ones fail as truncated with a subset of the fields of the full
+// payload, from the first one that is long enough (needed) the result doesn't change. Returns what's wrong, if any
+QString checkPrefixes(uint16_t characteristic, const std::vector<uint8_t> &payload, int &needed) {
+    QString name = QStringLiteral("0x") + QString::number(characteristic, 16);
+    ftmsparser::data full;
+    bool ok = parseGuarded(characteristic, payload, (int)payload.size(), 0x00, full);
+    needed = -1;
+    for (int length = 0; length <= (int)payload.size(); length++) {
+        QString at = name + QStringLiteral(" at %1 bytes: ").arg(length);
+        ftmsparser::data low, high;
+        bool okLow = parseGuarded(characteristic, payload, length, 0x00, low);
+        bool okHigh = parseGuarded(characteristic, payload, length, 0xFF, high);
+        if (okLow != okHigh || !sameData(low, high)) {
+            return at + QStringLiteral("read past the end");
+        }
+        if (okLow) {
+            if (needed < 0) {
+                needed = length;
+            }
+            if (!ok || !sameData(low, full)) {
+                return at + QStringLiteral("different from the full payload");
+            }
+            continue;
+        }
+        if (needed >= 0 || !low.truncated) {
+            return at + QStringLiteral("failed but not truncated");
+        }
+        if (low.present & ~full.present) {
+            return at + QStringLiteral("fields that the full payload doesn't have");
+        }
+        for (int f = 0; f < ftmsparser::FIELDS; f++) {
+            if (low.has((ftmsparser::FIELD)f) && low.value[f] != full.value[f]) {
+                return at + QStringLiteral("%1 differs").arg(ftmsparser::fieldName((ftmsparser::FIELD)f));
+            }
+        }
+    }
+    return QString();
+}
+
+// the long commands of domyostreadmill, written as a 20 bytes piece and the rest: updateDisplay (0xF0 0xCB) and
+// forceSpeedOrIncline (0xF0 0xAD). Every message ends with the sum of its bytes
+const QList<fragmentassembler::message> domyosWrites = {{QByteArray("\xf0\xcb", 2), 27},
+                                                         {QByteArray("\xf0\xad", 2), 23}};
+
+// the btlogs captures of a Domyos treadmill, the messages reassembled by the drivers and the status messages among
+// them (0xF0 0xBC, 26 bytes), the only ones the drivers decode
+void captureData() {
+    QTest::addColumn<QString>("file");
+    QTest::addColumn<int>("notifications");
+    QTest::addColumn<int>("writes");
+    QTest::addColumn<int>("messages");
+    QTest::addColumn<int>("status");
+    QTest::addColumn<int>("commands");
+    QTest::newRow("btsnoop_hci") << QStringLiteral("btsnoop_hci.log") << 1030 << 637 << 535 << 393 << 522;
+    QTest::newRow("heart200andstop") << QStringLiteral("heart200andstop.log") << 1614 << 945 << 814 << 669 << 811;
+    QTest::newRow("write inclination") << QStringLiteral("write inclination 3.5 and 0.log") << 1780 << 1055 << 903
+                                       << 726 << 895;
+}
+
+// the notifications and the writes of a capture, in their order
+bool loadCapture(const QString &file, QList<QByteArray> &notifications, QList<QByteArray> &writes) {
+    QList<capturefile::record> records;
+    if (!capturefile::importBtsnoop(QStringLiteral(BTLOGS_DIR "/") + file, records)) {
+        return false;
+    }
+    for (const capturefile::record &r : qAsConst(records)) {
+        if (r.type == 'N') {
+            notifications.append(r.value);
+        } else if (r.type == 'W') {
+            writes.append(r.value);
+        }
+    }
+    return true;
+}
+
+// the messages of a capture, reassembled as the drivers do
+QList<QByteArray> reassemble(const QList<QByteArray> &values, const QList<fragmentassembler::message> &messages) {
+    fragmentassembler fragments(20, messages);
+    QList<QByteArray> list;
+    for (const QByteArray &value : values) {
+        QByteArray out;
+        if (fragments.feed(value, out)) {
+            list.append(out);
+        }
+    }
+    return list;
+}
+
+// true when the gzip member gives back the data: its deflate stream goes to qUncompress in the zlib format, with the
+// adler32 of the data, so a wrong stream fails there
+bool gunzip(const QByteArray &member, const QByteArray &data) {
+    if (member.size() < 18 || !member.startsWith(QByteArray("\x1f\x8b\x08", 3)) ||
+        qFromLittleEndian<quint32>(member.constData() + member.size() - 8) != gzip::crc32(data) ||
+        qFromLittleEndian<quint32>(member.constData() + member.size() - 4) != (quint32)data.size()) {
+        return false;
+    }
+    quint32 a = 1;
+    quint32 b = 0;
+    for (char c : data) {
+        a = (a + (quint8)c) % 65521;
+        b = (b + a) % 65521;
+    }
+    char length[4];
+    char adler[4];
+    qToBigEndian<quint32>(data.size(), length);
+    qToBigEndian<quint32>((b << 16) | a, adler);
+    QByteArray z = QByteArray(length, 4) + QByteArray("\x78\x9c", 2) + member.mid(10, member.size() - 18) +
+                   QByteArray(adler, 4);
+    return qUncompress(z) == data;
+}
+
+QByteArray readFile(const QString &fileName) {
+    QFile file(fileName);
+    return file.open(QIODevice::ReadOnly) ? file.readAll() : QByteArray();
+}
+
+} // namespace
+
+void unittests::initTestCase() {
+    QCoreApplication::setOrganizationName(QStringLiteral("Roberto Viola"));
+    QCoreApplication::setOrganizationDomain(QStringLiteral("robertoviola.cloud"));
+    QCoreApplication::setApplicationName(QStringLiteral("qDomyos-Zwift-unit-tests"));
+    qInstallMessageHandler(messageHandler);
+    logging::setEnabled(false);
+
+    QSettings settings;
+    settings.clear();
+    settings.setValue(QStringLiteral("virtual_device_enabled"), false);
+}
+
+void unittests::cleanupTestCase() {
+    QSettings settings;
+    settings.clear();
+}
+
+void unittests::sensorFusionStale() {
+    sensorfusion fusion;
+    fusion.configure(5000, false);
+    QVERIFY(!fusion.active(sensorfusion::HEART));
+    fusion.push(sensorfusion::HEART, 120, 1000);
+    fusion.push(sensorfusion::HEART, 130, 2000);
+    QVERIFY(fusion.active(sensorfusion::HEART));
+    QCOMPARE(fusion.sample(sensorfusion::HEART, 2500), 130.0);
+    QVERIFY(!fusion.stale(sensorfusion::HEART, 6900));
+    QVERIFY(fusion.stale(sensorfusion::HEART, 7100));
+    QCOMPARE(fusion.sample(sensorfusion::HEART, 7100), 0.0);
+}
+
+void unittests::sensorFusionFakebike() {
+    // fakebike doesn't go through update_metrics: the samples of the accessories still have to reach the metrics
+    fakebike bike(false, false, true);
+    bike.heartRate(142);
+    bike.cadenceSensor(88);
+    bike.powerSensor(215);
+    QVERIFY(QMetaObject::invokeMethod(&bike, "update", Qt::DirectConnection));
+    QCOMPARE(bike.currentHeart().value(), 142.0);
+    QCOMPARE(bike.currentCadence().value(), 88.0);
+    QCOMPARE(bike.wattsMetric().value(), 215.0);
+}
+
+void unittests::cscRollover() {
+    cscdecoder decoder;
+    QVERIFY(!decoder.push(crank90rpm[0].revs, crank90rpm[0].eventTime, crank90rpm[0].now));
+    QVERIFY(decoder.active());
+    QCOMPARE(decoder.rpm(crank90rpm[0].now), 0.0);
+    for (size_t i = 1; i < sizeof(crank90rpm) / sizeof(crank90rpm[0]); i++) {
+        const cscnotification &n = crank90rpm[i];
+        QVERIFY(decoder.push(n.revs, n.eventTime, n.now));
+        QVERIFY2(qAbs(decoder.rpm(n.now) - 90) < 0.5, qPrintable(QString::number(decoder.rpm(n.now))));
+    }
+    // both counters unwrapped: 11 revolutions since the first notification
+    QCOMPARE(decoder.revolutions(), 11.0);
+    QCOMPARE(decoder.lastEventTime(), (uint16_t)5509);
+}
+
+void unittests::cscStale() {
+    cscdecoder decoder;
+    pushAll(decoder);
+    // the sensor keeps notifying the last event: the rate is bounded by the time since it, then it drops to 0
+    const struct {
+        int64_t now;
+        double rpm;
+    } expected[] = {{109000, 90}, {110000, 60}, {111000, 30}, {112000, 20}, {113000, 0}};
+    for (const auto &e : expected) {
+        QVERIFY(!decoder.push(5, 5509, e.now));
+        QVERIFY2(qAbs(decoder.rpm(e.now) - e.rpm) < 0.5,
+                 qPrintable(QStringLiteral("%1 at %2").arg(decoder.rpm(e.now)).arg(e.now)));
+    }
+}
+
+void unittests::cscResync() {
+    cscdecoder decoder;
+    pushAll(decoder);
+    // 75 s without notifications: the rollovers of the event time can't be counted, the timeline restarts
+    QVERIFY(!decoder.push(40, 20000, 183000));
+    QCOMPARE(decoder.rpm(183000), 0.0);
+    QCOMPARE(decoder.revolutions(), 11.0);
+    QVERIFY(decoder.push(41, 20683, 184000));
+    QVERIFY(qAbs(decoder.rpm(184000) - 90) < 0.5);
+    QVERIFY(decoder.push(43, 22048, 185000));
+    QVERIFY(qAbs(decoder.rpm(185000) - 90) < 0.5);
+    QCOMPARE(decoder.revolutions(), 14.0);
+    // the same event again isn't a new one
+    QVERIFY(!decoder.push(43, 22048, 185500));
+}
+
+void unittests::cscWheelRollover() {
+    // wheel data of the cycling power measurement: 32 bits revolutions, 1/2048 s
+    cscdecoder decoder(32, 2048);
+    decoder.push(0xFFFFFFFE, 65000, 0);
+    QVERIFY(decoder.push(0xFFFFFFFE + 2, (uint16_t)(65000 + 2048), 1000));
+    QCOMPARE(decoder.revolutions(), 2.0);
+    QVERIFY(qAbs(decoder.rpm(1000) - 120) < 0.5);
+}
+
+void unittests::ftmsSpecification() {
+    for (const ftmsframe &frame : ftmsFrames) {
+        QByteArray hex = QByteArray::fromHex(frame.hex);
+        std::vector<uint8_t> payload(hex.begin(), hex.end());
+        ftmsparser::data out;
+        QVERIFY2(ftmsparser::parse(frame.characteristic, payload.data(), (int)payload.size(), out), frame.name);
+        uint32_t present = 0;
+        for (const auto &f : frame.fields) {
+            present |= 1u << f.first;
+            QVERIFY2(out.has(f.first) && qAbs(out[f.first] - f.second) < 1e-9,
+                     qPrintable(QStringLiteral("%1: %2 is %3")
+                                    .arg(QLatin1String(frame.name), QLatin1String(ftmsparser::fieldName(f.first)))
+                                    .arg(out[f.first])));
+        }
+        QVERIFY2(out.present == present, frame.name);
+        // the frame ends with the last field
+        int needed;
+        QString error = checkPrefixes(frame.characteristic, payload, needed);
+        QVERIFY2(error.isEmpty(), qPrintable(error));
+        QVERIFY2(needed == (int)payload.size(), frame.name);
+    }
+}
+
+void unittests::ftmsRandom() {
+    // fixed seed, so a failure can be reproduced
+    std::mt19937 random(20221019);
+    std::uniform_int_distribution<int> byte(0, 255);
+    std::uniform_int_distribution<int> size(0, 48);
+    for (uint16_t characteristic : ftmsCharacteristics) {
+        QVERIFY(ftmsparser::supported(characteristic));
+        for (int i = 0; i < 2000; i++) {
+            std::vector<uint8_t> payload(size(random));
+            for (uint8_t &b : payload) {
+                b = (uint8_t)byte(random);
+            }
+            int needed;
+            QString error = checkPrefixes(characteristic, payload, needed);
+            QVERIFY2(error.isEmpty(), qPrintable(error));
+        }
+    }
+
+    ftmsparser::data out;
+    const char payload[] = {0x00, 0x00, 0x10, 0x27};
+    QVERIFY(!ftmsparser::parse(0x2A37, payload, sizeof(payload), out));
+    QVERIFY(!ftmsparser::parse(ftmsparser::INDOOR_BIKE_DATA, (const char *)nullptr, 4, out));
+    QVERIFY(!ftmsparser::parse(ftmsparser::INDOOR_BIKE_DATA, payload, -1, out));
+}
+
+void unittests::ftmsTruncated() {
+    // every field enabled (the "more data" bit clear, all the other flags set): every table is walked to its end
+    for (uint16_t characteristic : ftmsCharacteristics) {
+        std::vector<uint8_t> payload(64);
+        for (size_t i = 0; i < payload.size(); i++) {
+            payload[i] = (uint8_t)(0x11 * (i + 1));
+        }
+        payload[0] = 0xFE;
+        payload[1] = 0xFF;
+        payload[2] = 0xFF;
+        ftmsparser::data full;
+        QVERIFY(ftmsparser::parse(characteristic, payload.data(), (int)payload.size(), full));
+        QVERIFY(full.present);
+        int needed;
+        QString error = checkPrefixes(characteristic, payload, needed);
+        QVERIFY2(error.isEmpty(), qPrintable(error));
+        QVERIFY(needed > 3);
+
+        // exactly as long as the flags need: nothing is missing
+        payload.resize(needed);
+        ftmsparser::data exact;
+        QVERIFY(parseGuarded(characteristic, payload, needed, 0xA5, exact));
+        QVERIFY(!exact.truncated);
+        QCOMPARE(exact.present, full.present);
+    }
+}
+
+void unittests::framingFragments_data() { captureData(); }
+
+void unittests::framingFragments() {
+    QFETCH(QString, file);
+    QFETCH(int, notifications);
+    QFETCH(int, writes);
+    QFETCH(int, messages);
+    QFETCH(int, status);
+    QFETCH(int, commands);
+    QList<QByteArray> n, w;
+    QVERIFY(loadCapture(file, n, w));
+    QCOMPARE(n.length(), notifications);
+    QCOMPARE(w.length(), writes);
+
+    // the bike knows one more status message, the treadmill doesn't send it
+    for (const QList<fragmentassembler::message> &known :
+         {domyostreadmill::fragmentMessages, domyosbike::fragmentMessages}) {
+        QList<QByteArray> received = reassemble(n, known);
+        QCOMPARE(received.length(), messages);
+        int decoded = 0;
+        for (const QByteArray &m : qAsConst(received)) {
+            for (const fragmentassembler::message &k : known) {
+                if (!m.startsWith(k.start)) {
+                    continue;
+                }
+                // nothing of the known messages is left in pieces
+                QCOMPARE(m.length(), k.length);
+                QVERIFY2(sum8checksum<>::verify((const uint8_t *)m.constData(), m.length()), m.toHex().constData());
+            }
+            if (m.length() == 26 && m.startsWith("\xf0\xbc")) {
+                decoded++;
+            }
+        }
+        QCOMPARE(decoded, status);
+    }
+
+    // the commands cut by the driver are the same chunks found in the capture
+    QList<QByteArray> sent = reassemble(w, domyosWrites);
+    QCOMPARE(sent.length(), commands);
+    QList<QByteArray> chunks;
+    for (const QByteArray &m : qAsConst(sent)) {
+        QVERIFY2(sum8checksum<>::verify((const uint8_t *)m.constData(), m.length()), m.toHex().constData());
+
+        QByteArray sealed = m;
+        sealed[sealed.length() - 1] = 0;
+        sum8checksum<>::seal((uint8_t *)sealed.data(), sealed.length());
+        QCOMPARE(sealed, m);
+        chunks.append(framing::chunks(m, 20));
+    }
+    QCOMPARE(chunks, w);
+}
+
+void unittests::framingKingsmith() {
+    // the props of the treadmill, with the keys the driver reads and the string ones it skips, ciphered and streamed
+    // in 20 bytes notifications: no capture of it in btlogs
+    const QList<QByteArray> props = {
+        QByteArrayLiteral("props CurrentSpeed 3.5 RunningDistance 120 RunningSteps 230 BurnCalories 15000 "
+                          "RunningTotalTime 95 spm 110"),
+        QByteArrayLiteral("props runState 1 mcu_version 1.3.2 goal 0"), QByteArrayLiteral("props CurrentSpeed 0")};
+    QByteArray stream;
+    for (const QByteArray &p : props) {
+        QByteArray message = kingsmithr2treadmill::encrypt(p);
+        // the cipher never makes the terminator
+        QVERIFY(!message.contains(kingsmithr2treadmill::terminator));
+        stream += message + kingsmithr2treadmill::terminator;
+    }
+
+    terminatorframer frames(kingsmithr2treadmill::terminator);
+    QList<QByteArray> received;
+    for (const QByteArray &value : framing::chunks(stream, 20)) {
+        for (const QByteArray &message : frames.feed(value)) {
+            received.append(kingsmithr2treadmill::decrypt(message));
+        }
+    }
+    QVERIFY(!frames.pending());
+    QCOMPARE(received, props);
+}
+
+void unittests::framingFlywheel() {
+    // a live stream frame (message id 12) as the driver decodes it: power and speed big endian, the cadence at 9, the
+    // brake level at 12. The data is one byte longer than the length byte, the checksum isn't verified and the 0x55
+    // after it is skipped as garbage. No capture of the bike in btlogs: the frames follow the layout of the decoder
+    QByteArray live(32, '\0');
+    live[0] = 0x00;
+    live[1] = (char)0xc8; // 200W
+    live[9] = 85;         // rpm
+    live[10] = 0x01;
+    live[11] = 0x2c; // 30.0 km/h
+    live[12] = 22;   // brake level
+    QByteArray frame = QByteArray("\xff", 1) + (char)(live.length() - 1) + '\x0c' + live + '\x5a' + '\x55';
+    QByteArray reset = QByteArray::fromHex("ff011d01025855");
+    QByteArray stream = QByteArray::fromHex("005512") + frame + reset + frame;
+
+    lengthframer<nochecksum> frames(flywheelbike::frameSpec);
+    QList<QByteArray> received;
+    for (const QByteArray &value : framing::chunks(stream, 20)) {
+        received.append(frames.feed(value));
+    }
+    QCOMPARE(received.length(), 3);
+    QCOMPARE(received.at(0), frame.left(frame.length() - 1));
+    QCOMPARE(received.at(1), reset.left(reset.length() - 1));
+    QCOMPARE((int)received.at(1).at(2), 29);
+    QByteArray payload = frames.payload(received.at(2));
+    QCOMPARE(payload, live);
+    QCOMPARE(((uint8_t)payload.at(0) << 8) | (uint8_t)payload.at(1), 200);
+    QCOMPARE((int)payload.at(9), 85);
+    QCOMPARE(((uint8_t)payload.at(10) << 8) | (uint8_t)payload.at(11), 300);
+    QCOMPARE((int)payload.at(12), 22);
+}
+
+void unittests::framingChecksums() {
+    // trxappgateusbbike: init and poll frames of the driver, as they were recorded from the bikes, the sum of the bytes
+    for (const char *hex : {"f0a0010192", "f0a1010193", "f0a301010196", "f0a501010299", "f0a60101069e", "f0a2010194",
+                            "f0a223d388", "f0a003c95c", "f0a105c85e", "f0a039c992"}) {
+        QByteArray frame = QByteArray::fromHex(hex);
+        QVERIFY2(sum8checksum<>::verify((const uint8_t *)frame.constData(), frame.length()), hex);
+        QByteArray sealed = frame;
+        sealed[sealed.length() - 1] = 0;
+        sum8checksum<>::seal((uint8_t *)sealed.data(), sealed.length());
+        QCOMPARE(sealed, frame);
+    }
+
+    // tacxneo2: the target power page changePower writes for 200W, the sum of the bytes after the sync plus one
+    uint8_t power[] = {0xa4, 0x09, 0x4e, 0x05, 0x31, 0xff, 0xff, 0xff, 0xff, 0xc8, 0x00, 0xff, 0x00};
+    sum8checksum<1, 1>::seal(power, sizeof(power));
+    QCOMPARE((int)power[12], 0x51);
+
+    // fitshowtreadmill: header | payload | xor of the payload | footer. The status poll the driver writes and the
+    // speed range (1.0-18.0 km/h) the treadmill answers to the info request
+    const uint8_t poll[] = {FITSHOW_PKT_HEADER, FITSHOW_SYS_STATUS, 0x51, FITSHOW_PKT_FOOTER};
+    QVERIFY(fitshowtreadmill::checkIncomingPacket(poll, sizeof(poll)));
+    uint8_t speed[] = {FITSHOW_PKT_HEADER, FITSHOW_SYS_INFO, FITSHOW_INFO_SPEED, 0xb4, 0x0a, 0x00, 0xec,
+                       FITSHOW_PKT_FOOTER};
+    QVERIFY(fitshowtreadmill::checkIncomingPacket(speed, sizeof(speed)));
+    speed[3] = 0xb5;
+    QVERIFY(!fitshowtreadmill::checkIncomingPacket(speed, sizeof(speed)));
+    QVERIFY(!fitshowtreadmill::checkIncomingPacket(poll, 3));
+}
+
+QTEST_GUILESS_MAIN(unittests)
+void unittests::gzipCompress() {
+    // the check value of the crc of gzip, at once and continued
+    QCOMPARE(gzip::crc32(QByteArray("123456789")), 0xCBF43926u);
+    QCOMPARE(gzip::crc32(QByteArray("56789"), gzip::crc32(QByteArray("1234"))), 0xCBF43926u);
+
+    QByteArray text;
+    for (int i = 0; i < 1000; i++) {
+        text += "line " + QByteArray::number(i) + " of the log\n";
+    }
+    QByteArray member = gzip::compress(text);
+    QVERIFY(member.size() < text.size());
+    QVERIFY(gunzip(member, text));
+    QVERIFY(!gunzip(member, text + 'x'));
+    QVERIFY(gunzip(gzip::compress(QByteArray("x")), QByteArray("x")));
+
+    // a member per chunk
+    QBuffer in(&text);
+    QBuffer out;
+    QVERIFY(in.open(QIODevice::ReadOnly) && out.open(QIODevice::WriteOnly));
+    QVERIFY(gzip::compress(in, out, 8192));
+    QByteArray first = gzip::compress(text.left(8192));
+    QByteArray second = gzip::compress(text.mid(8192, 8192));
+    QByteArray third = gzip::compress(text.mid(16384));
+    QCOMPARE(out.data(), first + second + third);
+    QVERIFY(gunzip(first, text.left(8192)) && gunzip(second, text.mid(8192, 8192)) &&
+            gunzip(third, text.mid(16384)));
+}
+
+void unittests::logwriterDropped() {
+    QTemporaryDir dir;
+    QVERIFY(dir.isValid());
+    QString fileName = dir.filePath(QStringLiteral("debug.log"));
+    quint64 total = logwriter::totalDropped();
+    logwriter writer(fileName, 0, 3, false, false, 64);
+    QByteArray expected;
+    {
+        // the writer can't drain: the ring takes 64 lines, the next ones are dropped
+        std::lock_guard<std::mutex> lock(writer.drainMutex);
+        for (int i = 0; i < 64; i++) {
+            QByteArray line = "line " + QByteArray::number(i) + "\n";
+            QVERIFY(writer.push(line));
+            expected += line;
+        }
+        QVERIFY(!writer.push(QByteArray("dropped\n")));
+        QVERIFY(!writer.push(QByteArray("dropped\n")));
+    }
+    QCOMPARE(writer.dropped(), (quint64)2);
+    QCOMPARE(logwriter::totalDropped(), total + 2);
+
+    writer.flush();
+    QCOMPARE(readFile(fileName), expected + "logwriter: 2 messages dropped, the log is writing too slowly\n");
+}
+
+void unittests::logwriterRotation() {
+    QTemporaryDir dir;
+    QVERIFY(dir.isValid());
+    QString fileName = dir.filePath(QStringLiteral("debug.log"));
+    logwriter writer(fileName, 100, 2, true, false);
+
+    // every line is over the rotation size, the drain writing it rotates the file
+    QList<QByteArray> lines = {QByteArray(120, 'a') + '\n', QByteArray(120, 'b') + '\n', QByteArray(120, 'c') + '\n'};
+    for (const QByteArray &line : qAsConst(lines)) {
+        QVERIFY(writer.push(line));
+        writer.flush();
+        QCOMPARE(QFileInfo(fileName).size(), (qint64)0);
+        QVERIFY(!QFile::exists(fileName + QStringLiteral(".1")));
+        QVERIFY(gunzip(readFile(fileName + QStringLiteral(".1.gz")), line));
+    }
+    // the most recent is .1, only 2 are kept
+    QVERIFY(gunzip(readFile(fileName + QStringLiteral(".2.gz")), lines.at(1)));
+    QVERIFY(!QFile::exists(fileName + QStringLiteral(".3.gz")));
+}
+
+void unittests::templateFunctionBody_data() {
+    QTest::addColumn<QString>("script");
+    QTest::addColumn<bool>("compiled");
+    QTest::newRow("expression") << QStringLiteral("\"a\" + 1") << true;
+    QTest::newRow("statements") << QStringLiteral("let x = 2; const y = 3;\n x * y;") << true;
+    QTest::newRow("function expressions")
+        << QStringLiteral("let pad = function(n) {\n    var s = n.toString();\n    return s;\n};\n"
+                          "let g = function(w) { return pad(w) + \"!\"; };\ng(7)")
+        << true;
+    QTest::newRow("strings") << QStringLiteral("let s = \"a;b}\" + 'c{(;'; s + ';'") << true;
+    QTest::newRow("comments") << QStringLiteral("// a; comment }\n1 + /* ; { */ 2") << true;
+    QTest::newRow("members") << QStringLiteral("this.var = 4; this.function = 5; this.var + this.function") << true;
+    QTest::newRow("var") << QStringLiteral("var n = 0; n++") << false;
+    QTest::newRow("function declaration") << QStringLiteral("function f() { return 1; }\nf()") << false;
+    QTest::newRow("function after a block")
+        << QStringLiteral("let o = {a: 1};\nfunction f() { return o.a; };\nf()") << false;
+    QTest::newRow("if") << QStringLiteral("if (1) { 1 } else { 2 }") << false;
+    QTest::newRow("declaration last") << QStringLiteral("let x = 1; let y = 2;") << false;
+    QTest::newRow("unterminated string") << QStringLiteral("\"abc") << false;
+    QTest::newRow("unterminated comment") << QStringLiteral("1 + 2 /* open") << false;
+    QTest::newRow("unbalanced") << QStringLiteral("(1 + 2") << false;
+    // taken as one expression, the function doesn't compile
+    QTest::newRow("newlines") << QStringLiteral("this.a = 1\nthis.a + 1") << false;
+}
+
+void unittests::templateFunctionBody() {
+    QFETCH(QString, script);
+    QFETCH(bool, compiled);
+
+    // as TemplateInfoSender::compile does, the function must give what evaluate gives
+    QString body = TemplateInfoSender::functionBody(script);
+    QJSEngine engine;
+    QJSValue f;
+    if (!body.isEmpty()) {
+        f = engine.evaluate(QStringLiteral("(function() {\n") + body + QStringLiteral("\n})"));
+    }
+    QCOMPARE(f.isCallable(), compiled);
+    if (compiled) {
+        QJSEngine reference;
+        QCOMPARE(f.callWithInstance(engine.globalObject()).toString(), reference.evaluate(script).toString());
+    }
+}
+
+#include "unittests.moc"
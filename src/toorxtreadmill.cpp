@@ -1,4 +1,5 @@
 #include "toorxtreadmill.h"
+#include "logging.h"
 #include <QBluetoothLocalDevice>
 #include <QDateTime>
 #include <QMetaEnum>
@@ -17,7 +18,7 @@ toorxtreadmill::toorxtreadmill() {
 }
 
 void toorxtreadmill::deviceDiscovered(const QBluetoothDeviceInfo &device) {
-    emit debug(QStringLiteral("Found new device: ") + device.name() + QStringLiteral(" (") +
+    LOG_DEVICE(QStringLiteral("Found new device: ") + device.name() + QStringLiteral(" (") +
                device.address().toString() + ')');
     if (device.name().startsWith(QStringLiteral("TRX ROUTE KEY"))) {
         bluetoothDevice = device;
@@ -44,12 +45,12 @@ void toorxtreadmill::serviceDiscovered(const QBluetoothServiceInfo &service) {
 
     qDebug() << QStringLiteral("toorxtreadmill::serviceDiscovered") << service;
     if (service.device().address() == bluetoothDevice.address()) {
-        emit debug(QStringLiteral("Found new service: ") + service.serviceName() + '(' +
+        LOG_DEVICE(QStringLiteral("Found new service: ") + service.serviceName() + '(' +
                    service.serviceUuid().toString() + ')');
 
         if (service.serviceName().startsWith(QStringLiteral("SerialPort")) ||
             service.serviceName().startsWith(QStringLiteral("Serial Port"))) {
-            emit debug(QStringLiteral("Serial port service found"));
+            LOG_DEVICE(QStringLiteral("Serial port service found"));
             discoveryAgent->stop();
 
             serialPortService = service;
@@ -65,9 +66,9 @@ void toorxtreadmill::serviceDiscovered(const QBluetoothServiceInfo &service) {
             socket->setPreferredSecurityFlags(QBluetooth::NoSecurity);
 #endif
 
-            emit debug(QStringLiteral("Create socket"));
+            LOG_DEVICE(QStringLiteral("Create socket"));
             socket->connectToService(serialPortService);
-            emit debug(QStringLiteral("ConnectToService done"));
+            LOG_DEVICE(QStringLiteral("ConnectToService done"));
         }
     }
 }
@@ -83,7 +84,7 @@ void toorxtreadmill::update() {
             QSettings settings;
             bool virtual_device_enabled = settings.value(QStringLiteral("virtual_device_enabled"), true).toBool();
             if (virtual_device_enabled) {
-                emit debug(QStringLiteral("creating virtual treadmill interface..."));
+                LOG_DEVICE(QStringLiteral("creating virtual treadmill interface..."));
                 virtualTreadMill = new virtualtreadmill(this, true);
                 connect(virtualTreadMill, &virtualtreadmill::debug, this, &toorxtreadmill::debug);
             }
@@ -92,7 +93,7 @@ void toorxtreadmill::update() {
 
         if (requestSpeed != -1) {
             if (requestSpeed != currentSpeed().value() && requestSpeed >= 0 && requestSpeed <= 22) {
-                emit debug(QStringLiteral("writing speed ") + QString::number(requestSpeed));
+                LOG_DEVICE(QStringLiteral("writing speed ") + QString::number(requestSpeed));
                 char speed[] = {0x55, 0x0f, 0x02, 0x01, 0x00};
                 speed[3] = (uint8_t)(requestSpeed);
                 speed[4] = (uint8_t)((requestSpeed - (double)((uint8_t)(requestSpeed))) * 100.0);
@@ -102,14 +103,14 @@ void toorxtreadmill::update() {
         } else if (requestInclination != -1) {
             if (requestInclination != currentInclination().value() && requestInclination >= 0 &&
                 requestInclination <= 15) {
-                emit debug(QStringLiteral("writing incline ") + QString::number(requestInclination));
+                LOG_DEVICE(QStringLiteral("writing incline ") + QString::number(requestInclination));
                 uint8_t incline[] = {0x55, 0x0a, 0x01, 0x01};
                 incline[3] = requestInclination;
                 socket->write((char *)incline, sizeof(incline));
             }
             requestInclination = -1;
         } else if (requestStart != -1 && start_phase == -1) {
-            emit debug(QStringLiteral("starting..."));
+            LOG_DEVICE(QStringLiteral("starting..."));
             const uint8_t start[] = {0x55, 0x17, 0x01, 0x01, 0x55, 0xb5, 0x01, 0xff};
             socket->write((char *)start, sizeof(start));
             start_phase = 0;
@@ -253,7 +254,7 @@ void toorxtreadmill::update() {
         } else {
             const char poll[] = {0x55, 0x17, 0x01, 0x01};
             socket->write(poll, sizeof(poll));
-            emit debug(QStringLiteral("write poll"));
+            LOG_DEVICE(QStringLiteral("write poll"));
         }
 
         update_metrics(true, watts(settings.value(QStringLiteral("weight"), 75.0).toFloat()));
@@ -261,7 +262,7 @@ void toorxtreadmill::update() {
 }
 
 void toorxtreadmill::rfCommConnected() {
-    emit debug(QStringLiteral("connected ") + socket->peerName());
+    LOG_DEVICE(QStringLiteral("connected ") + socket->peerName());
 
     const uint8_t init1[] = {0x55, 0x0c, 0x01, 0xff, 0x55, 0xbb, 0x01, 0xff, 0x55, 0x24, 0x01, 0xff};
     const uint8_t init2[] = {0x55, 0x25, 0x01, 0xff, 0x55, 0x26, 0x01, 0xff, 0x55, 0x27, 0x01, 0xff, 0x55, 0x02,
@@ -297,11 +298,11 @@ void toorxtreadmill::readSocket() {
             Inclination = GetInclinationFromPacket(line);
             Heart = GetHeartRateFromPacket(line);
 
-            emit debug(QStringLiteral("Current speed: ") + QString::number(Speed.value()));
-            emit debug(QStringLiteral("Current incline: ") + QString::number(Inclination.value()));
-            emit debug(QStringLiteral("Current heart: ") + QString::number(Heart.value()));
-            emit debug(QStringLiteral("Current KCal: ") + QString::number(KCal.value()));
-            emit debug(QStringLiteral("Current Distance: ") + QString::number(Distance.value()));
+            LOG_DEVICE(QStringLiteral("Current speed: ") + QString::number(Speed.value()));
+            LOG_DEVICE(QStringLiteral("Current incline: ") + QString::number(Inclination.value()));
+            LOG_DEVICE(QStringLiteral("Current heart: ") + QString::number(Heart.value()));
+            LOG_DEVICE(QStringLiteral("Current KCal: ") + QString::number(KCal.value()));
+            LOG_DEVICE(QStringLiteral("Current Distance: ") + QString::number(Distance.value()));
         }
     }
 }
@@ -331,5 +332,5 @@ uint16_t toorxtreadmill::GetElapsedTimeFromPacket(const QByteArray &packet) {
 }
 
 void toorxtreadmill::onSocketErrorOccurred(QBluetoothSocket::SocketError error) {
-    emit debug(QStringLiteral("onSocketErrorOccurred ") + QString::number(error));
+    LOG_DEVICE(QStringLiteral("onSocketErrorOccurred ") + QString::number(error));
 }
@@ -58,6 +58,8 @@ class trainprogram : public QObject {
 
     void restart();
     void scheduler(int tick);
+    // scheduler() is called by the owner from now on, i.e. a virtual clock of a simulation
+    void stopTimer() { timer.stop(); }
 
   public slots:
     void onTapeStarted();
@@ -147,6 +147,6 @@ double treadmill::requestedSpeed() { return requestSpeed; }
 double treadmill::requestedInclination() { return requestInclination; }
 double treadmill::currentTargetSpeed() { return targetSpeed; }
 
-void treadmill::cadenceSensor(uint8_t cadence) { Cadence.setValue(cadence); }
-void treadmill::powerSensor(uint16_t power) { m_watt.setValue(power); }
-void treadmill::speedSensor(double speed) { Speed.setValue(speed); }
+void treadmill::cadenceSensor(uint8_t cadence) { fusion.push(sensorfusion::CADENCE, cadence); }
+void treadmill::powerSensor(uint16_t power) { fusion.push(sensorfusion::POWER, power); }
+void treadmill::speedSensor(double speed) { fusion.push(sensorfusion::SPEED, speed); }
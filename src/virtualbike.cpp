@@ -1,9 +1,14 @@
 #include "virtualbike.h"
+#include "controllatency.h"
+#include "cscdecoder.h"
+#include "dirconserver.h"
 #include "ftmsbike.h"
+#include "logging.h"
 
 #include <QDataStream>
 #include <QMetaEnum>
 #include <QSettings>
+#include <QtEndian>
 #include <QtMath>
 #include <chrono>
 
@@ -415,11 +420,31 @@ virtualbike::virtualbike(bluetoothdevice *t, bool noWriteResistance, bool noHear
         leController->startAdvertising(pars, advertisingData, advertisingData);
 
         //! [Start Advertising]
+
+        // the same services on the network, the proprietary ones are BLE only
+        if (settings.value(QStringLiteral("virtual_device_dircon"), false).toBool() && !echelon && !ifit) {
+            QList<QLowEnergyServiceData> dirconServices;
+            if (!heart_only) {
+                dirconServices.append((!cadence && !power) ? serviceDataFIT : serviceData);
+            }
+            if (battery) {
+                dirconServices.append(serviceDataBattery);
+            }
+            if (!this->noHeartService || heart_only) {
+                dirconServices.append(serviceDataHR);
+            }
+            dircon = new dirconserver(
+                dirconServices,
+                settings.value(QStringLiteral("virtual_device_dircon_port"), dirconserver::defaultPort).toUInt(), this);
+            QObject::connect(dircon, &dirconserver::characteristicWritten, this,
+                             &virtualbike::dirconCharacteristicWritten);
+        }
     }
 
     //! [Provide Heartbeat]
     QObject::connect(&bikeTimer, &QTimer::timeout, this, &virtualbike::bikeProvider);
-    bikeTimer.start(1s);
+    bikeTimer.setTimerType(Qt::PreciseTimer);
+    loadProviderSettings();
     //! [Provide Heartbeat]
     QObject::connect(leController, &QLowEnergyController::disconnected, this, &virtualbike::reconnect);
     QObject::connect(
@@ -459,8 +484,6 @@ void virtualbike::powerChanged(uint16_t power) { Bike->changePower(power); }
 void virtualbike::characteristicChanged(const QLowEnergyCharacteristic &characteristic, const QByteArray &newValue) {
     QByteArray reply;
     QSettings settings;
-    bool force_resistance = settings.value(QStringLiteral("virtualbike_forceresistance"), true).toBool();
-    bool erg_mode = settings.value(QStringLiteral("zwift_erg"), false).toBool();
     bool echelon = settings.value(QStringLiteral("virtual_device_echelon"), false).toBool();
     bool ifit = settings.value(QStringLiteral("virtual_device_ifit"), false).toBool();
     //    double erg_filter_upper =
@@ -479,60 +502,7 @@ void virtualbike::characteristicChanged(const QLowEnergyCharacteristic &characte
     switch (characteristic.uuid().toUInt16()) {
 
     case 0x2AD9: // Fitness Machine Control Point
-
-        if ((char)newValue.at(0) == FTMS_SET_TARGET_RESISTANCE_LEVEL) {
-
-            // Set Target Resistance
-            uint8_t uresistance = newValue.at(1);
-            uresistance = uresistance / 10;
-            if (force_resistance && !erg_mode) {
-                Bike->changeResistance(uresistance);
-            }
-            qDebug() << QStringLiteral("new requested resistance ") + QString::number(uresistance) +
-                            QStringLiteral(" enabled ") + force_resistance;
-            reply.append((quint8)FTMS_RESPONSE_CODE);
-            reply.append((quint8)FTMS_SET_TARGET_RESISTANCE_LEVEL);
-            reply.append((quint8)FTMS_SUCCESS);
-        } else if ((char)newValue.at(0) == FTMS_SET_INDOOR_BIKE_SIMULATION_PARAMS) // simulation parameter
-
-        {
-            qDebug() << QStringLiteral("indoor bike simulation parameters");
-            reply.append((quint8)FTMS_RESPONSE_CODE);
-            reply.append((quint8)FTMS_SET_INDOOR_BIKE_SIMULATION_PARAMS);
-            reply.append((quint8)FTMS_SUCCESS);
-
-            int16_t iresistance = (((uint8_t)newValue.at(3)) + (newValue.at(4) << 8));
-            slopeChanged(iresistance);
-        } else if ((char)newValue.at(0) == FTMS_SET_TARGET_POWER) // erg mode
-
-        {
-            qDebug() << QStringLiteral("erg mode");
-            reply.append((quint8)FTMS_RESPONSE_CODE);
-            reply.append((quint8)FTMS_SET_TARGET_POWER);
-            reply.append((quint8)FTMS_SUCCESS);
-
-            uint16_t power = (((uint8_t)newValue.at(1)) + (newValue.at(2) << 8));
-            powerChanged(power);
-        } else if ((char)newValue.at(0) == FTMS_START_RESUME) {
-            qDebug() << QStringLiteral("start simulation!");
-
-            reply.append((quint8)FTMS_RESPONSE_CODE);
-            reply.append((quint8)FTMS_START_RESUME);
-            reply.append((quint8)FTMS_SUCCESS);
-        } else if ((char)newValue.at(0) == FTMS_REQUEST_CONTROL) {
-            qDebug() << QStringLiteral("control requested");
-
-            reply.append((quint8)FTMS_RESPONSE_CODE);
-            reply.append((char)FTMS_REQUEST_CONTROL);
-            reply.append((quint8)FTMS_SUCCESS);
-        } else {
-            qDebug() << QStringLiteral("not supported");
-
-            reply.append((quint8)FTMS_RESPONSE_CODE);
-            reply.append((quint8)newValue.at(0));
-            reply.append((quint8)FTMS_NOT_SUPPORTED);
-        }
-
+        reply = ftmsControlPoint(newValue);
         QLowEnergyCharacteristic characteristic =
             serviceFIT->characteristic((QBluetoothUuid::CharacteristicType)0x2AD9);
         Q_ASSERT(characteristic.isValid());
@@ -733,11 +703,96 @@ void virtualbike::characteristicChanged(const QLowEnergyCharacteristic &characte
     }
 }
 
+QByteArray virtualbike::ftmsControlPoint(const QByteArray &newValue) {
+    QByteArray reply;
+    QSettings settings;
+    bool force_resistance = settings.value(QStringLiteral("virtualbike_forceresistance"), true).toBool();
+    bool erg_mode = settings.value(QStringLiteral("zwift_erg"), false).toBool();
+
+    if (newValue.isEmpty()) {
+        return reply;
+    }
+
+    // the short requests get the not supported response, the clients on the network can send anything
+    if ((char)newValue.at(0) == FTMS_SET_TARGET_RESISTANCE_LEVEL && newValue.length() >= 2) {
+
+        // Set Target Resistance
+        uint8_t uresistance = newValue.at(1);
+        uresistance = uresistance / 10;
+        Bike->controlLatency()->received(controllatency::RESISTANCE, uresistance);
+        if (force_resistance && !erg_mode) {
+            Bike->changeResistance(uresistance);
+        }
+        qDebug() << QStringLiteral("new requested resistance ") + QString::number(uresistance) +
+                        QStringLiteral(" enabled ") + force_resistance;
+        reply.append((quint8)FTMS_RESPONSE_CODE);
+        reply.append((quint8)FTMS_SET_TARGET_RESISTANCE_LEVEL);
+        reply.append((quint8)FTMS_SUCCESS);
+    } else if ((char)newValue.at(0) == FTMS_SET_INDOOR_BIKE_SIMULATION_PARAMS &&
+               newValue.length() >= 5) // simulation parameter
+
+    {
+        qDebug() << QStringLiteral("indoor bike simulation parameters");
+        reply.append((quint8)FTMS_RESPONSE_CODE);
+        reply.append((quint8)FTMS_SET_INDOOR_BIKE_SIMULATION_PARAMS);
+        reply.append((quint8)FTMS_SUCCESS);
+
+        int16_t iresistance = (((uint8_t)newValue.at(3)) + (newValue.at(4) << 8));
+        Bike->controlLatency()->received(controllatency::INCLINATION, iresistance / 100.0);
+        slopeChanged(iresistance);
+    } else if ((char)newValue.at(0) == FTMS_SET_TARGET_POWER && newValue.length() >= 3) // erg mode
+
+    {
+        qDebug() << QStringLiteral("erg mode");
+        reply.append((quint8)FTMS_RESPONSE_CODE);
+        reply.append((quint8)FTMS_SET_TARGET_POWER);
+        reply.append((quint8)FTMS_SUCCESS);
+
+        uint16_t power = (((uint8_t)newValue.at(1)) + (newValue.at(2) << 8));
+        Bike->controlLatency()->received(controllatency::POWER, power);
+        powerChanged(power);
+    } else if ((char)newValue.at(0) == FTMS_START_RESUME) {
+        qDebug() << QStringLiteral("start simulation!");
+
+        reply.append((quint8)FTMS_RESPONSE_CODE);
+        reply.append((quint8)FTMS_START_RESUME);
+        reply.append((quint8)FTMS_SUCCESS);
+    } else if ((char)newValue.at(0) == FTMS_REQUEST_CONTROL) {
+        qDebug() << QStringLiteral("control requested");
+
+        reply.append((quint8)FTMS_RESPONSE_CODE);
+        reply.append((char)FTMS_REQUEST_CONTROL);
+        reply.append((quint8)FTMS_SUCCESS);
+    } else {
+        qDebug() << QStringLiteral("not supported");
+
+        reply.append((quint8)FTMS_RESPONSE_CODE);
+        reply.append((quint8)newValue.at(0));
+        reply.append((quint8)FTMS_NOT_SUPPORTED);
+    }
+    return reply;
+}
+
+void virtualbike::dirconCharacteristicWritten(const QBluetoothUuid &characteristic, const QByteArray &newValue) {
+    qDebug() << QStringLiteral("dirconCharacteristicWritten ") + QString::number(characteristic.toUInt16()) +
+                    QStringLiteral(" ") + newValue.toHex(' ');
+
+    lastFTMSFrameReceived = QDateTime::currentMSecsSinceEpoch();
+    emit ftmsCharacteristicChanged(QLowEnergyCharacteristic(), newValue);
+
+    if (characteristic.toUInt16() == 0x2AD9) {
+        QByteArray reply = ftmsControlPoint(newValue);
+        if (!reply.isEmpty()) {
+            dircon->notify(characteristic, reply);
+        }
+    }
+}
+
 void virtualbike::writeCharacteristic(QLowEnergyService *service, const QLowEnergyCharacteristic &characteristic,
                                       const QByteArray &value) {
     try {
-        qDebug() << QStringLiteral("virtualbike::writeCharacteristic ") + service->serviceName() + QStringLiteral(" ") +
-                        characteristic.name() + QStringLiteral(" ") + value.toHex(' ');
+        LOG_PACKET(QStringLiteral("virtualbike::writeCharacteristic ") + service->serviceName() + QStringLiteral(" ") +
+                   characteristic.name() + QStringLiteral(" ") + value.toHex(' '));
         service->writeCharacteristic(characteristic, value); // Potentially causes notification.
     } catch (...) {
         qDebug() << QStringLiteral("virtual bike error!");
@@ -798,23 +853,105 @@ void virtualbike::reconnect() {
     leController->startAdvertising(pars, advertisingData, advertisingData);
 }
 
-void virtualbike::bikeProvider() {
+// notifications per second of the settings, the provider ticks at least once a second
+static int notificationPeriod(double rate) { return qRound(1000.0 / qBound(1.0, rate, 10.0)); }
 
+void virtualbike::loadProviderSettings() {
     QSettings settings;
-    bool cadence = settings.value(QStringLiteral("bike_cadence_sensor"), false).toBool();
-    bool battery = settings.value(QStringLiteral("battery_service"), false).toBool();
-    bool power = settings.value(QStringLiteral("bike_power_sensor"), false).toBool();
-    bool bike_wheel_revs = settings.value(QStringLiteral("bike_wheel_revs"), false).toBool();
-    bool heart_only = settings.value(QStringLiteral("virtual_device_onlyheart"), false).toBool();
-    bool echelon = settings.value(QStringLiteral("virtual_device_echelon"), false).toBool();
-    bool ifit = settings.value(QStringLiteral("virtual_device_ifit"), false).toBool();
-    bool erg_mode = settings.value(QStringLiteral("zwift_erg"), false).toBool();
+    providersettings &s = providerSettings;
+    s.cadence = settings.value(QStringLiteral("bike_cadence_sensor"), false).toBool();
+    s.battery = settings.value(QStringLiteral("battery_service"), false).toBool();
+    s.power = settings.value(QStringLiteral("bike_power_sensor"), false).toBool();
+    s.bike_wheel_revs = settings.value(QStringLiteral("bike_wheel_revs"), false).toBool();
+    s.heart_only = settings.value(QStringLiteral("virtual_device_onlyheart"), false).toBool();
+    s.echelon = settings.value(QStringLiteral("virtual_device_echelon"), false).toBool();
+    s.ifit = settings.value(QStringLiteral("virtual_device_ifit"), false).toBool();
+    s.erg_mode = settings.value(QStringLiteral("zwift_erg"), false).toBool();
+    s.bluetooth_relaxed = settings.value(QStringLiteral("bluetooth_relaxed"), false).toBool();
+    s.bluetooth_30m_hangs = settings.value(QStringLiteral("bluetooth_30m_hangs"), false).toBool();
+    s.wheelCircumference = settings.value(QStringLiteral("csc_wheel_circumference"), 2000.0).toDouble(); // millimeters
+
+    bikeData.period =
+        notificationPeriod(settings.value(QStringLiteral("virtual_device_rate_bike_data"), 1.0).toDouble());
+    powerData.period = notificationPeriod(settings.value(QStringLiteral("virtual_device_rate_power"), 1.0).toDouble());
+    cscData.period = notificationPeriod(settings.value(QStringLiteral("virtual_device_rate_csc"), 1.0).toDouble());
+    heartData.period = notificationPeriod(settings.value(QStringLiteral("virtual_device_rate_heart"), 1.0).toDouble());
+    batteryData.period = 1000;
+
+    // the fixed bytes of the frames, bikeProvider patches the values only
+    bikeData.frame[0] = 0x64; // speed, inst. cadence, resistance lvl, instant power
+    bikeData.frame[1] = 0x02; // heart rate
+    bikeData.frame[7] = 0;    // resistance
+    bikeData.frame[11] = 0;   // Bkool FTMS protocol HRM offset 1280 fix
+    bikeData.length = 12;
+    powerData.frame[0] = 0x20; // crank data present
+    powerData.frame[1] = 0x00;
+    powerData.length = 8;
+    cscData.frame[0] = s.bike_wheel_revs ? 0x03 : 0x02; // crank (and wheel) data present
+    cscData.length = s.bike_wheel_revs ? 11 : 5;
+    heartData.frame[0] = 0; // Flags that specify the format of the value.
+    heartData.length = 2;
+    batteryData.frame[0] = 100; // Actual value.
+    batteryData.length = 1;
+
+    // the timer ticks at the fastest notification of the services in use
+    int tick = 1000;
+    if (!s.echelon && !s.ifit && !s.heart_only) {
+        tick = qMin(tick, (!s.cadence && !s.power) ? bikeData.period : (s.power ? powerData.period : cscData.period));
+    }
+    if (!noHeartService || s.heart_only) {
+        tick = qMin(tick, heartData.period);
+    }
+    if (!bikeTimer.isActive() || bikeTimer.interval() != tick) {
+        bikeTimer.start(tick);
+    }
+}
+
+bool virtualbike::frameDue(notification &n, qint64 now) {
+    // half a tick of slack, the timer is never exactly on time
+    if (now - n.built < n.period - (bikeTimer.interval() / 2)) {
+        return false;
+    }
+    n.built = now;
+    return true;
+}
+
+void virtualbike::notifyFrame(notification &n, QLowEnergyService *service, const QBluetoothUuid &characteristic,
+                              qint64 now) {
+    // an unchanged frame is held back, but not longer than the keep alive: the apps take the silence for a dead sensor
+    if (n.sentLength == n.length && memcmp(n.frame, n.sent, n.length) == 0 &&
+        now - n.lastSent < notificationKeepAlive - (bikeTimer.interval() / 2)) {
+        return;
+    }
+    memcpy(n.sent, n.frame, n.length);
+    n.sentLength = n.length;
+    n.lastSent = now;
+    notifyCharacteristic(service, characteristic, QByteArray((const char *)n.frame, n.length));
+}
+
+void virtualbike::bikeProvider() {
+
+    qint64 now = QDateTime::currentMSecsSinceEpoch();
+    // the settings, the checks of the link and the ERG keep alive stay once a second, whatever the notification rates
+    bool second = now - lastSecond >= 1000 - (bikeTimer.interval() / 2);
+    if (second) {
+        lastSecond = now;
+        if (now - lastProviderSettings >= providerSettingsRefresh) {
+            lastProviderSettings = now;
+            loadProviderSettings();
+        }
+    }
+    const providersettings &s = providerSettings;
+    bool erg_mode = s.erg_mode;
 
     uint16_t normalizeSpeed = (uint16_t)qRound(Bike->currentSpeed().value() * 100);
 
 #ifdef Q_OS_IOS
 #ifndef IO_UNDER_QT
     if (h) {
+        if (!second) {
+            return;
+        }
         // really connected to a device
         if (h->virtualbike_updateFTMS(normalizeSpeed, (char)Bike->currentResistance().value(),
                                       (uint16_t)Bike->currentCadence().value() * 2,
@@ -841,151 +978,85 @@ void virtualbike::bikeProvider() {
 #endif
 
     if (leController->state() != QLowEnergyController::ConnectedState) {
-        qDebug() << QStringLiteral("virtual bike not connected");
-
-        return;
-    } else {
-        bool bluetooth_relaxed = settings.value(QStringLiteral("bluetooth_relaxed"), false).toBool();
-        bool bluetooth_30m_hangs = settings.value(QStringLiteral("bluetooth_30m_hangs"), false).toBool();
-        if (bluetooth_relaxed) {
+        if (!dircon || !dircon->clients()) {
+            if (second) {
+                LOG_DEVICE(QStringLiteral("virtual bike not connected"));
+            }
+            return;
+        }
+    } else if (second) {
+        if (s.bluetooth_relaxed) {
 
             leController->stopAdvertising();
         }
 
         if (lastFTMSFrameReceived > 0 && QDateTime::currentMSecsSinceEpoch() > (lastFTMSFrameReceived + 5000) &&
-            bluetooth_30m_hangs) {
+            s.bluetooth_30m_hangs) {
             lastFTMSFrameReceived = 0;
             qDebug() << QStringLiteral("virtual bike timeout, reconnecting...");
 
             reconnect();
             return;
         }
-
-        qDebug() << QStringLiteral("virtual bike connected");
     }
 
-    QByteArray value;
-
-    qDebug() << QStringLiteral("bikeProvider") << lastFTMSFrameReceived << (qint64)(lastFTMSFrameReceived + ((qint64)2000)) << erg_mode;
-    // zwift with the last update, seems to sending power request only when it actually wants to change it
-    // so i need to keep this on to the bike
-    if(lastFTMSFrameReceived > 0 && (QDateTime::currentMSecsSinceEpoch() > (qint64)(lastFTMSFrameReceived + ((qint64)2000))) && erg_mode) {
-        qDebug() << QStringLiteral("zwift is not sending the power anymore, let's continue with the last value");
-        powerChanged(((bike*)Bike)->lastRequestedPower().value());
+    if (second) {
+        LOG_DEVICE(QStringLiteral("bikeProvider ") + QString::number(lastFTMSFrameReceived) + QStringLiteral(" ") +
+                   QString::number(erg_mode));
+        // zwift with the last update, seems to sending power request only when it actually wants to change it
+        // so i need to keep this on to the bike
+        if (lastFTMSFrameReceived > 0 &&
+            (QDateTime::currentMSecsSinceEpoch() > (qint64)(lastFTMSFrameReceived + ((qint64)2000))) && erg_mode) {
+            qDebug() << QStringLiteral("zwift is not sending the power anymore, let's continue with the last value");
+            powerChanged(((bike *)Bike)->lastRequestedPower().value());
+        }
     }
 
-    if (!echelon && !ifit) {
-        if (!heart_only) {
-            if (!cadence && !power) {
-
-                value.append((char)0x64); // speed, inst. cadence, resistance lvl, instant power
-                value.append((char)0x02); // heart rate
-
-                value.append((char)(normalizeSpeed & 0xFF));      // speed
-                value.append((char)(normalizeSpeed >> 8) & 0xFF); // speed
-
-                value.append((char)((uint16_t)(Bike->currentCadence().value() * 2) & 0xFF));        // cadence
-                value.append((char)(((uint16_t)(Bike->currentCadence().value() * 2) >> 8) & 0xFF)); // cadence
-
-                value.append((char)Bike->currentResistance().value()); // resistance
-                value.append((char)(0));                               // resistance
-
-                value.append((char)(((uint16_t)Bike->wattsMetric().value()) & 0xFF));      // watts
-                value.append((char)(((uint16_t)Bike->wattsMetric().value()) >> 8) & 0xFF); // watts
-
-                value.append(char(Bike->currentHeart().value())); // Actual value.
-                value.append((char)0);                            // Bkool FTMS protocol HRM offset 1280 fix
-
-                if (!serviceFIT) {
-                    qDebug() << QStringLiteral("serviceFIT not available");
-
-                    return;
-                }
-
-                QLowEnergyCharacteristic characteristic =
-                    serviceFIT->characteristic((QBluetoothUuid::CharacteristicType)0x2AD2);
-                Q_ASSERT(characteristic.isValid());
-                if (leController->state() != QLowEnergyController::ConnectedState) {
-                    qDebug() << QStringLiteral("virtual bike not connected");
-
-                    return;
+    if (!s.echelon && !s.ifit) {
+        if (!s.heart_only) {
+            if (!s.cadence && !s.power) {
+                if (frameDue(bikeData, now)) {
+                    uint8_t *f = bikeData.frame;
+                    qToLittleEndian<quint16>(normalizeSpeed, f + 2);                                 // speed
+                    qToLittleEndian<quint16>((uint16_t)(Bike->currentCadence().value() * 2), f + 4); // cadence
+                    f[6] = (uint8_t)Bike->currentResistance().value();                               // resistance
+                    qToLittleEndian<quint16>((uint16_t)Bike->wattsMetric().value(), f + 8);          // watts
+                    f[10] = (uint8_t)Bike->currentHeart().value();                                   // Actual value.
+                    notifyFrame(bikeData, serviceFIT, (QBluetoothUuid::CharacteristicType)0x2AD2, now);
                 }
-                writeCharacteristic(serviceFIT, characteristic, value);
-            } else if (power) {
-
-                value.append((char)0x20); // crank data present
-                value.append((char)0x00);
-                value.append((char)(((uint16_t)Bike->wattsMetric().value()) & 0xFF));          // watt
-                value.append((char)(((uint16_t)Bike->wattsMetric().value()) >> 8) & 0xFF);     // watt
-                value.append((char)(((uint16_t)Bike->currentCrankRevolutions()) & 0xFF));      // revs count
-                value.append((char)(((uint16_t)Bike->currentCrankRevolutions()) >> 8) & 0xFF); // revs count
-                value.append((char)(Bike->lastCrankEventTime() & 0xff));                       // eventtime
-                value.append((char)(Bike->lastCrankEventTime() >> 8) & 0xFF);                  // eventtime
-
-                if (!service) {
-                    qDebug() << QStringLiteral("service not available");
-
-                    return;
+            } else if (s.power) {
+                if (frameDue(powerData, now)) {
+                    uint8_t *f = powerData.frame;
+                    qToLittleEndian<quint16>((uint16_t)Bike->wattsMetric().value(), f + 2);     // watt
+                    qToLittleEndian<quint16>((uint16_t)Bike->currentCrankRevolutions(), f + 4); // revs count
+                    qToLittleEndian<quint16>((uint16_t)Bike->lastCrankEventTime(), f + 6);      // eventtime
+                    notifyFrame(powerData, service, QBluetoothUuid::CharacteristicType::CyclingPowerMeasurement, now);
                 }
-
-                QLowEnergyCharacteristic characteristic =
-                    service->characteristic(QBluetoothUuid::CharacteristicType::CyclingPowerMeasurement);
-                Q_ASSERT(characteristic.isValid());
-                if (leController->state() != QLowEnergyController::ConnectedState) {
-                    qDebug() << QStringLiteral("virtual bike not connected");
-
-                    return;
-                }
-                writeCharacteristic(service, characteristic, value);
             } else {
-                if (!bike_wheel_revs) {
-
-                    value.append((char)0x02); // crank data present
-                } else {
-
-                    value.append((char)0x03); // crank and wheel data present
-
-                    if (Bike->currentSpeed().value()) {
-
-                        const double wheelCircumference = 2000.0; // millimeters
-                        wheelRevs++;
-                        lastWheelTime +=
-                            (uint16_t)(1024.0 / ((Bike->currentSpeed().value() / 3.6) / (wheelCircumference / 1000.0)));
+                if (frameDue(cscData, now)) {
+                    uint8_t *f = cscData.frame + 1;
+                    if (s.bike_wheel_revs) {
+                        if (Bike->currentSpeed().value()) {
+                            wheelRevs++;
+                            lastWheelTime += cscdecoder::eventPeriod(Bike->currentSpeed().value() * 1000000.0 /
+                                                                     (s.wheelCircumference * 60.0));
+                        }
+                        qToLittleEndian<quint32>(wheelRevs, f);         // wheel count
+                        qToLittleEndian<quint16>(lastWheelTime, f + 4); // eventtime
+                        f += 6;
                     }
-                    value.append((char)((wheelRevs & 0xFF)));        // wheel count
-                    value.append((char)((wheelRevs >> 8) & 0xFF));   // wheel count
-                    value.append((char)((wheelRevs >> 16) & 0xFF));  // wheel count
-                    value.append((char)((wheelRevs >> 24) & 0xFF));  // wheel count
-                    value.append((char)(lastWheelTime & 0xff));      // eventtime
-                    value.append((char)(lastWheelTime >> 8) & 0xFF); // eventtime
+                    qToLittleEndian<quint16>((uint16_t)Bike->currentCrankRevolutions(), f); // revs count
+                    qToLittleEndian<quint16>((uint16_t)Bike->lastCrankEventTime(), f + 2);  // eventtime
+                    notifyFrame(cscData, service, QBluetoothUuid::CharacteristicType::CSCMeasurement, now);
                 }
-                value.append((char)(((uint16_t)Bike->currentCrankRevolutions()) & 0xFF));      // revs count
-                value.append((char)(((uint16_t)Bike->currentCrankRevolutions()) >> 8) & 0xFF); // revs count
-                value.append((char)(Bike->lastCrankEventTime() & 0xff));                       // eventtime
-                value.append((char)(Bike->lastCrankEventTime() >> 8) & 0xFF);                  // eventtime
-
-                if (!service) {
-                    qDebug() << QStringLiteral("service not available");
-
-                    return;
-                }
-
-                QLowEnergyCharacteristic characteristic =
-                    service->characteristic(QBluetoothUuid::CharacteristicType::CSCMeasurement);
-                Q_ASSERT(characteristic.isValid());
-                if (leController->state() != QLowEnergyController::ConnectedState) {
-                    qDebug() << QStringLiteral("virtual bike not connected");
-
-                    return;
-                }
-                writeCharacteristic(service, characteristic, value);
             }
         }
-    } else if (ifit) {
+    } else if (s.ifit) {
 
-    } else {
+    } else if (second) {
 
         if (echelonInitDone) {
+            QByteArray value;
             // TODO: set it do dynamic
             // f0 d1 09 00 00 00 00 00 01 00 5f 00 2a
             value.append(0xf0);
@@ -1027,51 +1098,33 @@ void virtualbike::bikeProvider() {
             echelonWriteResistance();
         }
     }
-    // characteristic
-    //        = service->characteristic((QBluetoothUuid::CharacteristicType)0x2AD9); // Fitness Machine Control Point
-    // Q_ASSERT(characteristic.isValid());
-    // service->readCharacteristic(characteristic);
-
-    if (battery) {
-        if (!serviceBattery) {
-            qDebug() << QStringLiteral("serviceBattery not available");
 
-            return;
-        }
-
-        QByteArray valueBattery;
-        valueBattery.append(100); // Actual value.
-        QLowEnergyCharacteristic characteristicBattery = serviceBattery->characteristic(QBluetoothUuid::BatteryLevel);
-
-        Q_ASSERT(characteristicBattery.isValid());
-        if (leController->state() != QLowEnergyController::ConnectedState) {
-            qDebug() << QStringLiteral("virtual bike not connected");
-
-            return;
-        }
-        writeCharacteristic(serviceBattery, characteristicBattery, valueBattery);
+    if (s.battery && frameDue(batteryData, now)) {
+        notifyFrame(batteryData, serviceBattery, QBluetoothUuid::BatteryLevel, now);
     }
 
-    if (!this->noHeartService || heart_only) {
-        if (!serviceHR) {
-            qDebug() << QStringLiteral("serviceHR not available");
-
-            return;
-        }
-
-        QByteArray valueHR;
-        valueHR.append(char(0));                                  // Flags that specify the format of the value.
-        valueHR.append(char(Bike->metrics_override_heartrate())); // Actual value.
-        QLowEnergyCharacteristic characteristicHR = serviceHR->characteristic(QBluetoothUuid::HeartRateMeasurement);
+    if ((!this->noHeartService || s.heart_only) && frameDue(heartData, now)) {
+        heartData.frame[1] = (uint8_t)Bike->metrics_override_heartrate(); // Actual value.
+        notifyFrame(heartData, serviceHR, QBluetoothUuid::HeartRateMeasurement, now);
+    }
+}
 
-        Q_ASSERT(characteristicHR.isValid());
-        if (leController->state() != QLowEnergyController::ConnectedState) {
-            qDebug() << QStringLiteral("virtual bike not connected");
+void virtualbike::notifyCharacteristic(QLowEnergyService *service, const QBluetoothUuid &characteristic,
+                                       const QByteArray &value) {
+    if (dircon) {
+        dircon->notify(characteristic, value);
+    }
+    if (!service) {
+        qDebug() << QStringLiteral("service not available");
 
-            return;
-        }
-        writeCharacteristic(serviceHR, characteristicHR, valueHR);
+        return;
     }
+    if (leController->state() != QLowEnergyController::ConnectedState) {
+        return;
+    }
+    QLowEnergyCharacteristic c = service->characteristic(characteristic);
+    Q_ASSERT(c.isValid());
+    writeCharacteristic(service, c, value);
 }
 
 void virtualbike::echelonWriteResistance() {
@@ -1112,6 +1165,9 @@ void virtualbike::echelonWriteResistance() {
 }
 
 bool virtualbike::connected() {
+    if (dircon && dircon->clients()) {
+        return true;
+    }
     if (!leController) {
 
         return false;
@@ -27,6 +27,8 @@
 #endif
 #include "bike.h"
 
+class dirconserver;
+
 class virtualbike : public QObject {
 
     Q_OBJECT
@@ -52,11 +54,51 @@ class virtualbike : public QObject {
     QLowEnergyServiceData serviceEchelon;
     QTimer bikeTimer;
     bluetoothdevice *Bike;
+    dirconserver *dircon = nullptr;
 
     uint16_t lastWheelTime = 0;
     uint32_t wheelRevs = 0;
     qint64 lastFTMSFrameReceived = 0;
 
+    // a characteristic notified by bikeProvider: the frame is allocated once and its values are patched in place, it's
+    // sent when it's due and it changed, or when it's been unchanged for notificationKeepAlive
+    struct notification {
+        int period = 1000; // ms
+        int length = 0;
+        int sentLength = 0;
+        qint64 built = 0;
+        qint64 lastSent = 0;
+        uint8_t frame[20] = {};
+        uint8_t sent[20] = {};
+    };
+    notification bikeData;
+    notification powerData;
+    notification cscData;
+    notification heartData;
+    notification batteryData;
+    static const int notificationKeepAlive = 1000;
+    bool frameDue(notification &n, qint64 now);
+    void notifyFrame(notification &n, QLowEnergyService *service, const QBluetoothUuid &characteristic, qint64 now);
+
+    // the settings of bikeProvider, read again every providerSettingsRefresh ms instead of on every frame
+    struct providersettings {
+        bool cadence = false;
+        bool battery = false;
+        bool power = false;
+        bool bike_wheel_revs = false;
+        bool heart_only = false;
+        bool echelon = false;
+        bool ifit = false;
+        bool erg_mode = false;
+        bool bluetooth_relaxed = false;
+        bool bluetooth_30m_hangs = false;
+        double wheelCircumference = 2000.0;
+    } providerSettings;
+    static const int providerSettingsRefresh = 5000;
+    qint64 lastProviderSettings = 0;
+    qint64 lastSecond = 0;
+    void loadProviderSettings();
+
     bool noHeartService = false;
     uint8_t bikeResistanceOffset = 4;
     double bikeResistanceGain = 1.0;
@@ -66,6 +108,11 @@ class virtualbike : public QObject {
 
     void writeCharacteristic(QLowEnergyService *service, const QLowEnergyCharacteristic &characteristic,
                              const QByteArray &value);
+    // to the BLE central and to the DIRCON clients
+    void notifyCharacteristic(QLowEnergyService *service, const QBluetoothUuid &characteristic,
+                              const QByteArray &value);
+    // decodes a request on the Fitness Machine Control Point and returns the response to indicate
+    QByteArray ftmsControlPoint(const QByteArray &newValue);
 
     void slopeChanged(int16_t slope);
     void powerChanged(uint16_t power);
@@ -82,6 +129,7 @@ class virtualbike : public QObject {
 
   private slots:
     void characteristicChanged(const QLowEnergyCharacteristic &characteristic, const QByteArray &newValue);
+    void dirconCharacteristicWritten(const QBluetoothUuid &characteristic, const QByteArray &newValue);
     void bikeProvider();
     void reconnect();
     void error(QLowEnergyController::Error newError);
@@ -1,4 +1,5 @@
 #include "virtualtreadmill.h"
+#include "logging.h"
 #include "elliptical.h"
 #include "ftmsbike.h"
 #include <QSettings>
@@ -239,7 +240,7 @@ virtualtreadmill::virtualtreadmill(bluetoothdevice *t, bool noHeartService) {
 
 void virtualtreadmill::characteristicChanged(const QLowEnergyCharacteristic &characteristic,
                                              const QByteArray &newValue) {
-    emit debug(QStringLiteral("characteristicChanged ") + QString::number(characteristic.uuid().toUInt16()) +
+    LOG_DEVICE(QStringLiteral("characteristicChanged ") + QString::number(characteristic.uuid().toUInt16()) +
                QStringLiteral(" ") + newValue);
 
     char a;
@@ -258,7 +259,7 @@ void virtualtreadmill::characteristicChanged(const QLowEnergyCharacteristic &cha
             if (treadMill->deviceType() == bluetoothdevice::TREADMILL) {
                 ((treadmill *)treadMill)->changeSpeed(requestSpeed);
             }
-            emit debug(QStringLiteral("new requested speed ") + QString::number(requestSpeed));
+            LOG_DEVICE(QStringLiteral("new requested speed ") + QString::number(requestSpeed));
         } else if ((char)newValue.at(0) == 0x03) // Set Target Inclination
         {
             a = newValue.at(1);
@@ -274,15 +275,15 @@ void virtualtreadmill::characteristicChanged(const QLowEnergyCharacteristic &cha
             // Resistance as incline on Sole E95s Elliptical #419
             else if (treadMill->deviceType() == bluetoothdevice::ELLIPTICAL)
                 ((elliptical *)treadMill)->changeInclination(requestIncline, requestIncline);
-            emit debug("new requested incline " + QString::number(requestIncline));
+            LOG_DEVICE("new requested incline " + QString::number(requestIncline));
         } else if ((char)newValue.at(0) == 0x07) // Start request
         {
             // treadMill->start();
-            emit debug(QStringLiteral("request to start"));
+            LOG_DEVICE(QStringLiteral("request to start"));
         } else if ((char)newValue.at(0) == 0x08) // Stop request
         {
             // treadMill->stop();
-            emit debug(QStringLiteral("request to stop"));
+            LOG_DEVICE(QStringLiteral("request to stop"));
         } else if ((char)newValue.at(0) == FTMS_SET_INDOOR_BIKE_SIMULATION_PARAMS) // simulation parameter
         {
             lastSlopeChanged = QDateTime::currentSecsSinceEpoch();
@@ -389,7 +390,7 @@ void virtualtreadmill::treadmillProvider() {
 #endif
 
     if (leController->state() != QLowEnergyController::ConnectedState) {
-        emit debug(QStringLiteral("virtualtreadmill connection error"));
+        LOG_DEVICE(QStringLiteral("virtualtreadmill connection error"));
         return;
     } else {
         QSettings settings;
@@ -446,13 +447,13 @@ void virtualtreadmill::treadmillProvider() {
                 (QBluetoothUuid::CharacteristicType)0x2ACD); // TreadmillDataCharacteristicUuid
             Q_ASSERT(characteristic.isValid());
             if (leController->state() != QLowEnergyController::ConnectedState) {
-                emit debug(QStringLiteral("virtualtreadmill connection error"));
+                LOG_DEVICE(QStringLiteral("virtualtreadmill connection error"));
                 return;
             }
             try {
                 serviceFTMS->writeCharacteristic(characteristic, value); // Potentially causes notification.
             } catch (...) {
-                emit debug(QStringLiteral("virtualtreadmill error!"));
+                LOG_DEVICE(QStringLiteral("virtualtreadmill error!"));
             }
         }
 
@@ -495,13 +496,13 @@ void virtualtreadmill::treadmillProvider() {
             return;
         }
         if (leController->state() != QLowEnergyController::ConnectedState) {
-            emit debug(QStringLiteral("virtualtreadmill connection error"));
+            LOG_DEVICE(QStringLiteral("virtualtreadmill connection error"));
             return;
         }
         try {
             serviceFTMS->writeCharacteristic(characteristicBike, valueBike); // Potentially causes notification.
         } catch (...) {
-            emit debug(QStringLiteral("virtualtreadmill error!"));
+            LOG_DEVICE(QStringLiteral("virtualtreadmill error!"));
         }
     }
     if (RSCEnable()) {
@@ -525,7 +526,7 @@ void virtualtreadmill::treadmillProvider() {
             serviceRSC->characteristic(QBluetoothUuid::CharacteristicType::RSCMeasurement);
         Q_ASSERT(characteristic.isValid());
         if (leController->state() != QLowEnergyController::ConnectedState) {
-            emit debug(QStringLiteral("virtual bike not connected"));
+            LOG_DEVICE(QStringLiteral("virtual bike not connected"));
             return;
         }
         serviceRSC->writeCharacteristic(characteristic, value); // Potentially causes notification.
@@ -548,13 +549,13 @@ void virtualtreadmill::treadmillProvider() {
         QLowEnergyCharacteristic characteristicHR = serviceHR->characteristic(QBluetoothUuid::HeartRateMeasurement);
         Q_ASSERT(characteristicHR.isValid());
         if (leController->state() != QLowEnergyController::ConnectedState) {
-            emit debug(QStringLiteral("virtualtreadmill connection error"));
+            LOG_DEVICE(QStringLiteral("virtualtreadmill connection error"));
             return;
         }
         try {
             serviceHR->writeCharacteristic(characteristicHR, valueHR); // Potentially causes notification.
         } catch (...) {
-            emit debug(QStringLiteral("virtualtreadmill error!"));
+            LOG_DEVICE(QStringLiteral("virtualtreadmill error!"));
         }
     }
 }
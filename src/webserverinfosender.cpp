@@ -1,13 +1,30 @@
 #include "webserverinfosender.h"
+#include "gzip.h"
+#include <QCryptographicHash>
+#include <QFileInfo>
 #include <QJsonArray>
 #include <QJsonDocument>
 #include <QJsonObject>
+#include <QMimeDatabase>
+#include <QNetworkDiskCache>
 #include <QNetworkReply>
+#include <QRegExp>
+#include <QStandardPaths>
+#include <QUrlQuery>
+#include <QtEndian>
 #include <QtWebSockets/QWebSocket>
+#include <algorithm>
 
 WebServerInfoSender::WebServerInfoSender(const QString &id, QObject *parent) : TemplateInfoSender(id, parent) {
     fetcher = new QNetworkAccessManager(this);
     fetcher->setCookieJar(new QNoCookieJar());
+    QString cacheLocation = QStandardPaths::writableLocation(QStandardPaths::CacheLocation);
+    if (!cacheLocation.isEmpty()) {
+        QNetworkDiskCache *cache = new QNetworkDiskCache(fetcher);
+        cache->setCacheDirectory(cacheLocation + QStringLiteral("/fetcher/") + id);
+        cache->setMaximumCacheSize(fetchCacheSize);
+        fetcher->setCache(cache);
+    }
     connect(fetcher, SIGNAL(finished(QNetworkReply *)), this, SLOT(handleFetcherRequest(QNetworkReply *)));
     connect(fetcher, SIGNAL(sslErrors(QNetworkReply *, const QList<QSslError> &)), this,
             SLOT(ignoreSSLErrors(QNetworkReply *, const QList<QSslError> &)));
@@ -36,19 +53,88 @@ bool WebServerInfoSender::listen() {
 }
 
 bool WebServerInfoSender::isRunning() const { return innerTcpServer && innerTcpServer->isListening(); }
+
+bool WebServerInfoSender::sendFrame(QWebSocket *client, clientstate &state, const frame &f) {
+    qint64 sent = state.binary ? client->sendBinaryMessage(f.utf8) : client->sendTextMessage(f.text);
+    state.outstanding += f.utf8.size();
+    state.maxOutstanding = qMax(state.maxOutstanding, state.outstanding);
+    state.frames++;
+    return sent > 0;
+}
+
 bool WebServerInfoSender::send(const QString &data) {
     if (isRunning() && !data.isEmpty()) {
-        bool rv = true, oldrv = false;
-        for (QWebSocket *client : sendToClients) {
-            rv = client->sendTextMessage(data) > 0;
-            if (!oldrv)
-                oldrv = rv;
+        bool rv = true;
+        frame f{data, data.toUtf8()};
+        for (QWebSocket *client : qAsConst(sendToClients)) {
+            rv = sendFrame(client, clientStates[client], f);
         }
         return rv;
     } else
         return false;
 }
 
+bool WebServerInfoSender::sendUpdate(const QString &data) {
+    if (isRunning() && !data.isEmpty()) {
+        bool rv = true;
+        frame f{data, data.toUtf8()};
+        for (QWebSocket *client : qAsConst(sendToClients)) {
+            clientstate &state = clientStates[client];
+            if (state.outstanding > maxOutstandingBytes) {
+                if (!state.lagging) {
+                    state.lagging = true;
+                    qDebug() << QStringLiteral("WebSocket client lagging, updates coalesced") << client->peerAddress()
+                             << state.outstanding;
+                }
+                if (!state.pending.utf8.isEmpty()) {
+                    state.coalesced++;
+                }
+                state.pending = f;
+                continue;
+            }
+            rv = sendFrame(client, state, f);
+        }
+        return rv;
+    } else
+        return false;
+}
+
+void WebServerInfoSender::socketBytesWritten(qint64 bytes) {
+    QWebSocket *client = qobject_cast<QWebSocket *>(sender());
+    auto state = clientStates.find(client);
+    if (state == clientStates.end()) {
+        return;
+    }
+    state->outstanding = qMax<qint64>(0, state->outstanding - bytes);
+    if (state->outstanding < maxOutstandingBytes / 2) {
+        if (!state->pending.utf8.isEmpty()) {
+            frame f = state->pending;
+            state->pending = frame();
+            sendFrame(client, *state, f);
+        }
+        if (state->lagging) {
+            state->lagging = false;
+            qDebug() << QStringLiteral("WebSocket client caught up, updates coalesced") << state->coalesced;
+        }
+    }
+}
+
+QJsonArray WebServerInfoSender::clientStats() const {
+    QJsonArray out;
+    for (auto it = clientStates.constBegin(); it != clientStates.constEnd(); ++it) {
+        QJsonObject o;
+        o[QStringLiteral("address")] = it.key()->peerAddress().toString();
+        o[QStringLiteral("binary")] = it->binary;
+        o[QStringLiteral("outstanding")] = it->outstanding;
+        o[QStringLiteral("maxOutstanding")] = it->maxOutstanding;
+        o[QStringLiteral("frames")] = (qint64)it->frames;
+        o[QStringLiteral("coalesced")] = (qint64)it->coalesced;
+        o[QStringLiteral("lagging")] = it->lagging;
+        out.append(o);
+    }
+    return out;
+}
+
 void WebServerInfoSender::innerStop() {
     if (innerTcpServer) {
         if (isRunning())
@@ -56,7 +142,11 @@ void WebServerInfoSender::innerStop() {
         httpServer->deleteLater();
         clients.clear();
         sendToClients.clear();
+        clientStates.clear();
         reply2Req.clear();
+        fetchesInFlight.clear();
+        fetchQueue.clear();
+        binaryFetchers.clear();
         innerTcpServer = 0;
         httpServer = 0;
     }
@@ -71,8 +161,18 @@ bool WebServerInfoSender::init() {
         port = settings.value(QStringLiteral("template_") + templateId + QStringLiteral("_port"), 6666).toInt(&ok);
         if (!ok)
             port = 6666;
-        if (!httpServer)
+        if (!httpServer) {
             httpServer = new QHttpServer(this);
+            httpServer->route(QStringLiteral("/metrics"), [this]() {
+                return serveSnapshot(QByteArrayLiteral("text/plain; version=0.0.4; charset=utf-8"), snapshotMetrics);
+            });
+            httpServer->route(QStringLiteral("/api/snapshot"),
+                              [this]() { return serveSnapshot(QByteArrayLiteral("application/json"), snapshotJson); });
+            httpServer->route(QStringLiteral("/api/clients"), [this]() {
+                return serveSnapshot(QByteArrayLiteral("application/json"),
+                                     QJsonDocument(clientStats()).toJson(QJsonDocument::Compact));
+            });
+        }
         relative2Absolute.clear();
         for (auto fld : folders) {
             idx = fld.lastIndexOf('/');
@@ -95,7 +195,7 @@ bool WebServerInfoSender::init() {
                                       else {
                                           path += QStringLiteral("/%1").arg(url.path());
                                           qDebug() << "File to look at:" << path;
-                                          return QHttpServerResponse::fromFile(path);
+                                          return serveFile(path, request);
                                       }
                                   });
             }
@@ -112,16 +212,145 @@ bool WebServerInfoSender::init() {
     return false;
 }
 
+static bool acceptsGzip(const QByteArray &acceptEncoding) {
+    for (const QByteArray &coding : acceptEncoding.split(',')) {
+        QList<QByteArray> params = coding.split(';');
+        if (params.first().trimmed().toLower() != "gzip") {
+            continue;
+        }
+        for (int i = 1; i < params.count(); i++) {
+            QByteArray q = params.at(i).trimmed();
+            if (q.startsWith("q=") && q.mid(2).toDouble() <= 0) {
+                return false;
+            }
+        }
+        return true;
+    }
+    return false;
+}
+
+QHttpServerResponse WebServerInfoSender::serveSnapshot(const QByteArray &mimeType, const QByteArray &data) const {
+    if (data.isEmpty()) {
+        return QHttpServerResponse(QHttpServerResponder::StatusCode::ServiceUnavailable);
+    }
+    QHttpServerResponse response(mimeType, data);
+    response.addHeader("Cache-Control", "no-store");
+    return response;
+}
+
+QHttpServerResponse WebServerInfoSender::serveFile(const QString &path, const QHttpServerRequest &request) {
+    QFileInfo info(path);
+    if (!info.isFile()) {
+        return QHttpServerResponse(QHttpServerResponder::StatusCode::NotFound);
+    }
+    auto a = assets.find(path);
+    if (a != assets.end() && (a->size != info.size() || a->modified != info.lastModified())) {
+        assetsSize -= a->data.size() + a->gzip.size();
+        assets.erase(a);
+        a = assets.end();
+    }
+    if (a == assets.end()) {
+        if (info.size() > maxAssetSize || assetsSize + info.size() > maxAssetsSize) {
+            return QHttpServerResponse::fromFile(path);
+        }
+        QFile f(path);
+        if (!f.open(QIODevice::ReadOnly)) {
+            return QHttpServerResponse(QHttpServerResponder::StatusCode::NotFound);
+        }
+        asset n;
+        n.data = f.readAll();
+        n.size = info.size();
+        n.modified = info.lastModified();
+        n.mimeType = QMimeDatabase().mimeTypeForFileNameAndData(path, n.data).name().toLatin1();
+        n.etag = '"' + QCryptographicHash::hash(n.data, QCryptographicHash::Md5).toHex().left(16) + '"';
+        n.immutable = QRegExp(QStringLiteral("\\d+\\.\\d+\\.\\d+")).indexIn(info.fileName()) >= 0;
+        if (n.data.size() > 512 &&
+            (n.mimeType.startsWith("text/") || n.mimeType.contains("javascript") || n.mimeType.contains("json") ||
+             n.mimeType.contains("xml"))) {
+            n.gzip = gzip::compress(n.data, 9);
+            if (n.gzip.size() > n.data.size() * 9 / 10) {
+                n.gzip.clear();
+            }
+        }
+        assetsSize += n.data.size() + n.gzip.size();
+        a = assets.insert(path, n);
+        qDebug() << QStringLiteral("Asset cached") << path << n.mimeType << n.data.size() << QStringLiteral("gzip")
+                 << n.gzip.size();
+    }
+
+    bool gzipped = !a->gzip.isEmpty() && acceptsGzip(request.value("Accept-Encoding"));
+    // the variants are different representations, with different tags
+    QByteArray etag = gzipped ? a->etag.left(a->etag.size() - 1) + "-gz\"" : a->etag;
+    QByteArray cacheControl = a->immutable ? QByteArrayLiteral("public, max-age=31536000, immutable")
+                                           : QByteArrayLiteral("no-cache");
+    QByteArray ifNoneMatch = request.value("If-None-Match");
+    if (!ifNoneMatch.isEmpty()) {
+        for (const QByteArray &tag : ifNoneMatch.split(',')) {
+            QByteArray t = tag.trimmed();
+            if (t.startsWith("W/")) {
+                t = t.mid(2);
+            }
+            if (t == etag || t == "*") {
+                QHttpServerResponse notModified(QHttpServerResponder::StatusCode::NotModified);
+                notModified.addHeader("ETag", etag);
+                notModified.addHeader("Cache-Control", cacheControl);
+                return notModified;
+            }
+        }
+    }
+
+    QHttpServerResponse response(a->mimeType, gzipped ? a->gzip : a->data);
+    response.addHeader("ETag", etag);
+    response.addHeader("Cache-Control", cacheControl);
+    if (!a->gzip.isEmpty()) {
+        response.addHeader("Vary", "Accept-Encoding");
+    }
+    if (gzipped) {
+        response.addHeader("Content-Encoding", "gzip");
+    }
+    return response;
+}
+
+void WebServerInfoSender::sendFetchResponse(const fetchrequester &requester, QJsonObject init, const QByteArray &body,
+                                            int error, bool cached) {
+    QString respType = requester.request[QStringLiteral("responseType")].toString();
+    bool binaryBody = respType == QStringLiteral("arraybuffer") || respType == QStringLiteral("blob");
+    QJsonObject out;
+    out[QStringLiteral("init")] = init;
+    out[QStringLiteral("req")] = requester.request[QStringLiteral("req")];
+    out[QStringLiteral("DBG")] = error;
+    out[QStringLiteral("cached")] = cached;
+    if (binaryBody && binaryFetchers.contains(requester.socket)) {
+        QByteArray header = QJsonDocument(out).toJson(QJsonDocument::Compact);
+        QByteArray frame(4, 0);
+        qToBigEndian<quint32>(header.size(), frame.data());
+        frame.reserve(4 + header.size() + body.size());
+        frame.append(header);
+        frame.append(body);
+        requester.socket->sendBinaryMessage(frame);
+        return;
+    }
+    if (binaryBody)
+        out[QStringLiteral("body")] = QJsonValue(body.toBase64().constData());
+    else
+        out[QStringLiteral("body")] = QJsonValue(QString::fromUtf8(body));
+    requester.socket->sendTextMessage(QJsonDocument(out).toJson());
+}
+
 void WebServerInfoSender::handleFetcherRequest(QNetworkReply *reply) {
-    QPair<QJsonObject, QWebSocket *> reqIdRequester = reply2Req.value(reply);
-    QString req = reqIdRequester.first.operator[](QStringLiteral("req")).toString();
-    QWebSocket *requester = reqIdRequester.second;
-    if (!req.isEmpty() && requester) {
+    auto it = reply2Req.find(reply);
+    if (it != reply2Req.end()) {
+        fetch f = it.value();
+        reply2Req.erase(it);
+        if (!f.key.isEmpty() && fetchesInFlight.value(f.key) == reply) {
+            fetchesInFlight.remove(f.key);
+        }
         QNetworkReply::NetworkError error = reply->error();
         QString statusText = reply->attribute(QNetworkRequest::HttpReasonPhraseAttribute).toString();
         int statusCode = reply->attribute(QNetworkRequest::HttpStatusCodeAttribute).toInt();
+        bool cached = reply->attribute(QNetworkRequest::SourceIsFromCacheAttribute).toBool();
         QByteArray body = reply->readAll();
-        QJsonObject out, init;
+        QJsonObject init;
         QList<QNetworkReply::RawHeaderPair> rHeaders = reply->rawHeaderPairs();
         QJsonArray headers;
         for (auto p : rHeaders) {
@@ -132,23 +361,18 @@ void WebServerInfoSender::handleFetcherRequest(QNetworkReply *reply) {
                 headers.append(arrv);
             }
         }
-        QString respType = reqIdRequester.first.operator[](QStringLiteral("responseType")).toString();
         init[QStringLiteral("headers")] = headers;
         init[QStringLiteral("status")] = statusCode;
         init[QStringLiteral("statusText")] = statusText;
         init[QStringLiteral("responseURL")] = reply->url().toString();
-        if (respType == QStringLiteral("arraybuffer") || respType == QStringLiteral("blob"))
-            out[QStringLiteral("body")] = QJsonValue(body.toBase64().constData());
-        else
-            out[QStringLiteral("body")] = QJsonValue(body.constData());
-        out[QStringLiteral("init")] = init;
-        out[QStringLiteral("req")] = req;
-        out[QStringLiteral("DBG")] = error;
-        QJsonDocument toSend(out);
-        requester->sendTextMessage(toSend.toJson());
-        reply2Req.remove(reply);
+        for (const fetchrequester &requester : qAsConst(f.requesters)) {
+            sendFetchResponse(requester, init, body, error, cached);
+        }
     }
     reply->deleteLater();
+    while (reply2Req.count() < maxFetches && !fetchQueue.isEmpty()) {
+        startFetch(fetchQueue.takeFirst());
+    }
 }
 
 void WebServerInfoSender::processTextMessage(QString message) {
@@ -168,38 +392,76 @@ void WebServerInfoSender::processFetcherRawRequest(QByteArray data) {
     processFetcher(qobject_cast<QWebSocket *>(sender()), data);
 }
 
+void WebServerInfoSender::startFetch(const fetch &f) {
+    QNetworkReply *repl = f.post ? fetcher->post(f.request, f.body) : fetcher->get(f.request);
+    reply2Req[repl] = f;
+    if (!f.key.isEmpty()) {
+        fetchesInFlight[f.key] = repl;
+    }
+}
+
 void WebServerInfoSender::processFetcher(QWebSocket *sender, const QByteArray &data) {
     qDebug() << QStringLiteral("Fetch Request Received") << data;
     QJsonDocument jsonResponse = QJsonDocument::fromJson(data);
     if (jsonResponse.isObject()) {
         QJsonObject jsonObject = jsonResponse.object();
         if (jsonObject.contains(QStringLiteral("req")) && jsonObject.contains(QStringLiteral("url"))) {
-            QString req = jsonObject[QStringLiteral("req")].toString();
             QString url = jsonObject[QStringLiteral("url")].toString();
-            QNetworkRequest request(url);
+            fetchrequester requester;
+            requester.request = jsonObject;
+            requester.socket = sender;
+            fetch f;
+            f.request = QNetworkRequest(url);
             QString method = QStringLiteral("GET");
             QJsonValue tmpv;
-            request.setAttribute(QNetworkRequest::RedirectPolicyAttribute, QNetworkRequest::NoLessSafeRedirectPolicy);
+            f.request.setAttribute(QNetworkRequest::RedirectPolicyAttribute,
+                                   QNetworkRequest::NoLessSafeRedirectPolicy);
             if ((tmpv = jsonObject.value(QStringLiteral("method"))).isString())
                 method = tmpv.toString();
+            QJsonObject headersObject;
             if ((tmpv = jsonObject.value(QStringLiteral("headers"))).isObject()) {
-                QVariantHash headers = tmpv.toObject().toVariantHash();
+                headersObject = tmpv.toObject();
+                QVariantHash headers = headersObject.toVariantHash();
                 QVariantHash::const_iterator i = headers.constBegin();
                 while (i != headers.constEnd()) {
-                    request.setRawHeader(i.key().toUtf8(), i.value().toString().toUtf8());
+                    f.request.setRawHeader(i.key().toUtf8(), i.value().toString().toUtf8());
                     ++i;
                 }
             }
-            QNetworkReply *repl;
             if (method.toLower() == QStringLiteral("post")) {
-                QByteArray body;
+                f.post = true;
                 if ((tmpv = jsonObject.value(QStringLiteral("body"))).isString())
-                    body = tmpv.toString().toUtf8();
-                repl = fetcher->post(request, body);
+                    f.body = tmpv.toString().toUtf8();
             } else {
-                repl = fetcher->get(request);
+                // the object keys are sorted, the same headers give the same key
+                f.key = url + QStringLiteral("\n") +
+                        QString::fromUtf8(QJsonDocument(headersObject).toJson(QJsonDocument::Compact));
+                QNetworkReply *inFlight = fetchesInFlight.value(f.key);
+                if (inFlight) {
+                    reply2Req[inFlight].requesters.append(requester);
+                    return;
+                }
+                for (fetch &queued : fetchQueue) {
+                    if (queued.key == f.key) {
+                        queued.requesters.append(requester);
+                        return;
+                    }
+                }
+            }
+            f.requesters.append(requester);
+            if (reply2Req.count() < maxFetches) {
+                startFetch(f);
+            } else if (fetchQueue.count() < maxQueuedFetches) {
+                fetchQueue.append(f);
+            } else {
+                qDebug() << QStringLiteral("Fetch queue full, request refused") << url;
+                QJsonObject init;
+                init[QStringLiteral("headers")] = QJsonArray();
+                init[QStringLiteral("status")] = 503;
+                init[QStringLiteral("statusText")] = QStringLiteral("Too many requests queued");
+                init[QStringLiteral("responseURL")] = url;
+                sendFetchResponse(requester, init, QByteArray(), QNetworkReply::UnknownServerError, false);
             }
-            reply2Req[repl] = QPair<QJsonObject, QWebSocket *>(jsonObject, sender);
         }
     }
 }
@@ -209,11 +471,17 @@ void WebServerInfoSender::onNewConnection() {
     QUrl requestUrl = pSocket->requestUrl();
     qDebug() << QStringLiteral("WebSocket connection") << requestUrl;
     if (requestUrl.path() == QStringLiteral("/fetcher")) {
+        if (QUrlQuery(requestUrl).queryItemValue(QStringLiteral("format")) == QStringLiteral("binary")) {
+            binaryFetchers.insert(pSocket);
+        }
         connect(pSocket, SIGNAL(textMessageReceived(QString)), this, SLOT(processFetcherRequest(QString)));
         connect(pSocket, SIGNAL(binaryMessageReceived(QByteArray)), this, SLOT(processFetcherRawRequest(QByteArray)));
     } else {
         connect(pSocket, SIGNAL(textMessageReceived(QString)), this, SLOT(processTextMessage(QString)));
         connect(pSocket, SIGNAL(binaryMessageReceived(QByteArray)), this, SLOT(processBinaryMessage(QByteArray)));
+        connect(pSocket, SIGNAL(bytesWritten(qint64)), this, SLOT(socketBytesWritten(qint64)));
+        clientStates[pSocket].binary =
+            QUrlQuery(requestUrl).queryItemValue(QStringLiteral("format")) == QStringLiteral("binary");
         sendToClients << pSocket;
     }
     connect(pSocket, SIGNAL(disconnected()), this, SLOT(socketDisconnected()));
@@ -226,15 +494,29 @@ void WebServerInfoSender::socketDisconnected() {
     qDebug() << QStringLiteral("socketDisconnected:") << pClient;
     if (pClient) {
         clients.removeAll(pClient);
+        clientStates.remove(pClient);
         if (!sendToClients.removeAll(pClient)) {
-            QMutableHashIterator<QNetworkReply *, QPair<QJsonObject, QWebSocket *>> i(reply2Req);
-            while (i.hasNext()) {
-                i.next();
-                if (i.value().second == pClient) {
-                    i.remove();
-                    break;
+            binaryFetchers.remove(pClient);
+            auto ofClient = [pClient](const fetchrequester &r) { return r.socket == pClient; };
+            QList<QNetworkReply *> unwanted;
+            for (auto i = reply2Req.begin(); i != reply2Req.end(); ++i) {
+                i->requesters.erase(std::remove_if(i->requesters.begin(), i->requesters.end(), ofClient),
+                                    i->requesters.end());
+                if (i->requesters.isEmpty()) {
+                    unwanted.append(i.key());
+                }
+            }
+            for (int i = fetchQueue.count() - 1; i >= 0; i--) {
+                QList<fetchrequester> &requesters = fetchQueue[i].requesters;
+                requesters.erase(std::remove_if(requesters.begin(), requesters.end(), ofClient), requesters.end());
+                if (requesters.isEmpty()) {
+                    fetchQueue.removeAt(i);
                 }
             }
+            // abort finishes the reply right away, handleFetcherRequest drops it and starts the queued ones
+            for (QNetworkReply *reply : qAsConst(unwanted)) {
+                reply->abort();
+            }
         }
         pClient->deleteLater();
     }
@@ -1,7 +1,11 @@
 #ifndef WEBSERVERINFOSENDER_H
 #define WEBSERVERINFOSENDER_H
 #include "templateinfosender.h"
+#include <QDateTime>
 #include <QHttpServer>
+#include <QJsonArray>
+#include <QNetworkRequest>
+#include <QSet>
 #include <QNetworkAccessManager>
 #include <QNetworkCookie>
 #include <QNetworkCookieJar>
@@ -23,13 +27,64 @@ class WebServerInfoSender : public TemplateInfoSender {
     virtual ~WebServerInfoSender();
     virtual bool isRunning() const;
     virtual bool send(const QString &data);
+    virtual bool sendUpdate(const QString &data);
+    virtual bool hasClients() const { return !sendToClients.isEmpty(); }
+    virtual void setSnapshot(const QByteArray &json, const QByteArray &metrics) {
+        snapshotJson = json;
+        snapshotMetrics = metrics;
+    }
 
   private:
     QHttpServer *httpServer = 0;
     QStringList folders;
     bool listen();
+    // The files of the template folders in memory, read once and served with an ETag. The compressible ones also
+    // have a gzip variant, compressed once. A file that changes on disk is read again.
+    struct asset {
+        QByteArray mimeType;
+        QByteArray data;
+        QByteArray gzip;
+        QByteArray etag;
+        QDateTime modified;
+        qint64 size = -1;
+        // versioned name (jquery-3.6.0.min.js): a new version is a new url, the browsers keep it
+        bool immutable = false;
+    };
+    // bigger files aren't kept, they're served from the file every time
+    static const qint64 maxAssetSize = 2 * 1024 * 1024;
+    static const qint64 maxAssetsSize = 32 * 1024 * 1024;
+    QHash<QString, asset> assets;
+    qint64 assetsSize = 0;
+    QHttpServerResponse serveFile(const QString &path, const QHttpServerRequest &request);
+    // /api/snapshot and /metrics: what the builder published last, nothing is computed by the requests
+    QByteArray snapshotJson;
+    QByteArray snapshotMetrics;
+    QHttpServerResponse serveSnapshot(const QByteArray &mimeType, const QByteArray &data) const;
     void processFetcher(QWebSocket *sender, const QByteArray &data);
 
+    // The messages are encoded once for all the clients. A client that asks ws://...?format=binary gets them as binary
+    // frames of UTF-8, sharing the encoded buffer. Qt buffers whatever a client doesn't read: over maxOutstandingBytes
+    // the updates aren't sent anymore, only the latest one is held and it goes out when the client catches up. The
+    // replies are always sent.
+    struct frame {
+        QString text;
+        QByteArray utf8;
+    };
+    struct clientstate {
+        bool binary = false;
+        // sent and not written to the socket yet, the frame headers aren't counted
+        qint64 outstanding = 0;
+        qint64 maxOutstanding = 0;
+        quint64 frames = 0;
+        quint64 coalesced = 0;
+        frame pending;
+        bool lagging = false;
+    };
+    static const qint64 maxOutstandingBytes = 256 * 1024;
+    QHash<QWebSocket *, clientstate> clientStates;
+    bool sendFrame(QWebSocket *client, clientstate &state, const frame &f);
+    QJsonArray clientStats() const;
+
   protected:
     virtual void innerStop();
     int port;
@@ -39,7 +94,37 @@ class WebServerInfoSender : public TemplateInfoSender {
     QNetworkAccessManager *fetcher = 0;
     QList<QWebSocket *> sendToClients;
     QHash<QString, QString> relative2Absolute;
-    QHash<QNetworkReply *, QPair<QJsonObject, QWebSocket *>> reply2Req;
+    // The /fetcher requests share the connections of the fetcher and its disk cache, which honors Cache-Control,
+    // Expires and the validators of the responses (GET only). Identical GETs in flight are fetched once for all the
+    // requesters and at most maxFetches run at a time, the others wait in fetchQueue. A client connecting to
+    // /fetcher?format=binary gets the arraybuffer and blob bodies as a binary frame, without base64:
+    //
+    //   header length (4, big endian) | header (UTF-8 JSON) | body
+    //
+    // the header is the text reply without its body: {"init", "req", "DBG", "cached"}. The other responses, and
+    // all of them for the other clients, are text frames with the body in the JSON, base64 for the binary ones.
+    struct fetchrequester {
+        QJsonObject request;
+        QWebSocket *socket = nullptr;
+    };
+    struct fetch {
+        // GETs with the same url and headers, empty when not shared
+        QString key;
+        QNetworkRequest request;
+        bool post = false;
+        QByteArray body;
+        QList<fetchrequester> requesters;
+    };
+    static const int maxFetches = 6;
+    static const int maxQueuedFetches = 64;
+    static const qint64 fetchCacheSize = 32 * 1024 * 1024;
+    QHash<QNetworkReply *, fetch> reply2Req;
+    QHash<QString, QNetworkReply *> fetchesInFlight;
+    QList<fetch> fetchQueue;
+    QSet<QWebSocket *> binaryFetchers;
+    void startFetch(const fetch &f);
+    void sendFetchResponse(const fetchrequester &requester, QJsonObject init, const QByteArray &body, int error,
+                           bool cached);
 private slots:
     void onNewConnection();
     void handleFetcherRequest(QNetworkReply *reply);
@@ -48,6 +133,7 @@ private slots:
     void processFetcherRequest(QString message);
     void processBinaryMessage(QByteArray message);
     void socketDisconnected();
+    void socketBytesWritten(qint64 bytes);
     void ignoreSSLErrors(QNetworkReply *, const QList<QSslError> &);
 };
 
@@ -181,8 +181,17 @@ function base64toBlob(base64Data, contentType) {
     return new Blob(byteArrays, { type: contentType });
 }
 
+// binary frame of the fetcher: length of the JSON header (4 bytes, big endian), the header and the body
+function fetcher_parse_binary(data) {
+    let len = new DataView(data).getUint32(0);
+    let msg = JSON.parse(new TextDecoder().decode(new Uint8Array(data, 4, len)));
+    msg.body = data.slice(4 + len);
+    return msg;
+}
+
 function fetcher_connect() {
-    let mysocket = new WebSocket((location.protocol == 'https:'?'wss://' : 'ws://') + host_url + '/fetcher');
+    let mysocket = new WebSocket((location.protocol == 'https:'?'wss://' : 'ws://') + host_url + '/fetcher?format=binary');
+    mysocket.binaryType = 'arraybuffer';
     mysocket.onopen = function (event) {
         console.log('Fetcher Upgrade HTTP connection OK');
         fetcher_socket = mysocket;
@@ -206,8 +215,10 @@ function fetcher_connect() {
         mysocket.close();
     };
     mysocket.onmessage = function (event) {
-        console.log(event.data);
-        let msg = JSON.parse(event.data);
+        let binary = event.data instanceof ArrayBuffer;
+        let msg = binary ? fetcher_parse_binary(event.data) : JSON.parse(event.data);
+        if (!binary)
+            console.log(event.data);
         let objreq;
         if (msg.req && (objreq = fetcher_queue[msg.req])) {
             if (objreq.timer)
@@ -251,10 +262,10 @@ function fetcher_connect() {
                     xhr.response = msg.body;
                 }
                 else if (rt == 'arraybuffer') {
-                    xhr.response = _base64ToArrayBuffer(msg.body);
+                    xhr.response = binary ? msg.body : _base64ToArrayBuffer(msg.body);
                 }
                 else if (rt == 'blob') {
-                    xhr.response = base64toBlob(msg.body);
+                    xhr.response = binary ? new Blob([msg.body], { type: head.get('content-type') || '' }) : base64toBlob(msg.body);
                 }
                 else if (rt == 'document') {
                     xhr.response = msg.body; //change!!!